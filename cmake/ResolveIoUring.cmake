@@ -0,0 +1,45 @@
+# Determines whether socket I/O can use io_uring, based on the RDMNET_ENABLE_IO_URING option and
+# the availability of liburing. When it can't, the epoll-based socket I/O is used as before.
+#
+# Sets the following variables:
+#   RDMNET_IO_URING_FOUND: Whether the io_uring socket I/O backend will be built.
+#   RDMNET_IO_URING_INCLUDE_DIRS: Include directories necessary to bring in the liburing headers.
+#   RDMNET_IO_URING_LIBS: Libraries to link RDMnet and the RDMnet Broker to for io_uring.
+#
+# Provided buffer rings and multishot receives need liburing 2.4 or later at build time. Linux 6.0 or
+# later is needed at run time; on older kernels, the epoll backend is selected when RDMnet starts.
+
+set(RDMNET_IO_URING_FOUND FALSE)
+set(RDMNET_IO_URING_INCLUDE_DIRS "")
+set(RDMNET_IO_URING_LIBS "")
+
+if(RDMNET_ENABLE_IO_URING)
+  if(UNIX AND NOT APPLE)
+    find_path(LIBURING_INCLUDE_DIR liburing.h)
+    find_library(LIBURING_LIBRARY uring)
+
+    if(LIBURING_INCLUDE_DIR AND LIBURING_LIBRARY)
+      include(CheckSymbolExists)
+      include(CMakePushCheckState)
+
+      cmake_push_check_state(RESET)
+      set(CMAKE_REQUIRED_INCLUDES ${LIBURING_INCLUDE_DIR})
+      set(CMAKE_REQUIRED_LIBRARIES ${LIBURING_LIBRARY})
+      check_symbol_exists(io_uring_setup_buf_ring liburing.h RDMNET_LIBURING_HAS_BUF_RING)
+      cmake_pop_check_state()
+
+      if(RDMNET_LIBURING_HAS_BUF_RING)
+        set(RDMNET_IO_URING_FOUND TRUE)
+        set(RDMNET_IO_URING_INCLUDE_DIRS ${LIBURING_INCLUDE_DIR})
+        set(RDMNET_IO_URING_LIBS ${LIBURING_LIBRARY})
+        message(STATUS "RDMnet: Using io_uring for socket I/O (${LIBURING_LIBRARY})")
+      else()
+        message(WARNING "RDMNET_ENABLE_IO_URING is ON, but liburing is older than 2.4. Using epoll for socket I/O.")
+      endif()
+    else()
+      message(WARNING "RDMNET_ENABLE_IO_URING is ON, but liburing was not found. Using epoll for socket I/O.")
+    endif()
+  else()
+    message(WARNING "RDMNET_ENABLE_IO_URING is only supported on Linux. Ignoring.")
+  endif()
+endif()
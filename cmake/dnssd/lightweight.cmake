@@ -1,11 +1,15 @@
-# Use the lightweight mDNS querier built into the RDMnet library. This discovery provider only
-# supports broker discovery, not broker registration.
+# Use the lightweight mDNS querier and responder built into the RDMnet library. This discovery
+# provider supports both broker discovery and broker registration.
 
 set(RDMNET_DISC_PLATFORM_SOURCES
   ${RDMNET_SRC}/rdmnet/disc/lightweight/rdmnet_disc_platform_defs.h
   ${RDMNET_SRC}/rdmnet/disc/lightweight/rdmnet_disc_lightweight.c
+  ${RDMNET_SRC}/rdmnet/disc/lightweight/lwmdns_cache.h
+  ${RDMNET_SRC}/rdmnet/disc/lightweight/lwmdns_cache.c
   ${RDMNET_SRC}/rdmnet/disc/lightweight/lwmdns_common.h
   ${RDMNET_SRC}/rdmnet/disc/lightweight/lwmdns_common.c
+  ${RDMNET_SRC}/rdmnet/disc/lightweight/lwmdns_index.h
+  ${RDMNET_SRC}/rdmnet/disc/lightweight/lwmdns_index.c
   ${RDMNET_SRC}/rdmnet/disc/lightweight/lwmdns_recv.h
   ${RDMNET_SRC}/rdmnet/disc/lightweight/lwmdns_recv.c
   ${RDMNET_SRC}/rdmnet/disc/lightweight/lwmdns_send.h
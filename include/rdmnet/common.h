@@ -407,6 +407,7 @@ typedef struct RdmnetNetintConfig
 
 etcpal_error_t rdmnet_init(const EtcPalLogParams* log_params, const RdmnetNetintConfig* netint_config);
 void           rdmnet_deinit(void);
+size_t         rdmnet_dispatch_callbacks(int timeout_ms);
 
 const char* rdmnet_rpt_status_code_to_string(rpt_status_code_t code);
 const char* rdmnet_ept_status_code_to_string(ept_status_code_t code);
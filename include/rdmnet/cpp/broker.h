@@ -111,11 +111,12 @@ inline DnsTxtRecordItem::DnsTxtRecordItem(const std::string& new_key, const std:
 ///
 /// Starts some threads to handle messages and connections. The current breakdown (pending
 /// concurrency optimization) is:
-///   * Either:
+///   * A platform-dependent number of threads to receive messages from clients, depending on the
+///     most efficient way to read large number of sockets on a given platform. On Linux, these
+///     threads also accept new connections.
+///   * On other platforms, either:
 ///     + One thread per explicitly-specified network interface being listened on, or
 ///     + One thread, if listening on all interfaces
-///   * A platform-dependent number of threads to receive messages from clients, depending on the
-///     most efficient way to read large number of sockets on a given platform
 ///   * One thread to handle message routing between clients
 ///   * One thread to handle periodic cleanup and housekeeping.
 ///
@@ -144,8 +145,24 @@ public:
     std::vector<DnsTxtRecordItem> additional_txt_record_items;
   };
 
+  /// @ingroup rdmnet_broker
+  /// @brief What a broker does with an RPT notification for a controller whose queue is full.
+  enum class OverflowPolicy
+  {
+    /// Refuse the new notification. The sender's message is held and retried once the queue drains.
+    kDropNewest,
+    /// Discard the controller's oldest queued notifications to make room for the new one.
+    kDropOldestNotification,
+    /// Replace a queued unsolicited notification for the same responder, sub-device and parameter
+    /// with the new one. If there is none, refuse the new notification as with kDropNewest.
+    kCoalesceNotifications
+  };
+
   /// @ingroup rdmnet_broker
   /// @brief A set of limits for broker operation.
+  ///
+  /// Queue byte limits are checked before each message is queued, so a queue can exceed its byte
+  /// limit by at most one message.
   struct Limits
   {
     /// The maximum number of client connections supported. 0 means infinite.
@@ -158,9 +175,33 @@ public:
     unsigned int devices{0};
     /// The maximum number of queued messages per device. 0 means infinite.
     unsigned int device_messages{500};
+    /// The maximum number of EPT clients allowed. 0 means infinite.
+    unsigned int ept_clients{0};
+    /// The maximum number of queued messages per EPT client. 0 means infinite.
+    unsigned int ept_client_messages{500};
+    /// The maximum number of bytes queued per controller. 0 means infinite.
+    size_t controller_queue_bytes{0};
+    /// The maximum number of bytes queued per device. 0 means infinite.
+    size_t device_queue_bytes{0};
+    /// The maximum number of bytes queued per EPT client. 0 means infinite.
+    size_t ept_client_queue_bytes{0};
+    /// The maximum number of bytes queued across all clients. 0 means infinite.
+    size_t total_queue_bytes{0};
+    /// How notifications to a controller with a full queue are handled.
+    OverflowPolicy overflow_policy{OverflowPolicy::kDropNewest};
     /// If you reach the number of max connections, this number of tcp-level connections are still
     /// supported to reject the connection request.
     unsigned int reject_connections{1000};
+    /// @brief The maximum number of client connect handshakes processed per second. 0 means infinite.
+    ///
+    /// Each connect request beyond this rate is given a time slot at the rate. A connect whose slot
+    /// is less than half a second away is held on its connection until then. Otherwise, the client
+    /// is rejected as over capacity, with a hint to reconnect at its slot that this library's
+    /// clients honor. This spreads out the work of a reconnect storm after a network outage.
+    unsigned int connect_rate{0};
+    /// The number of connect handshakes that can be processed back-to-back before connect_rate
+    /// applies. 0 means the same as connect_rate.
+    unsigned int connect_burst{0};
   };
 
   /// @ingroup rdmnet_broker
@@ -179,6 +220,14 @@ public:
     /// Whether the broker should allow being disabled and enabled via the BROKER_STATUS RDM command.
     // bool allow_rdm_disable{false};  // (TODO: Not yet implemented)
 
+    /// @brief Whether to coalesce unsolicited RDM notifications queued to each controller.
+    ///
+    /// When enabled, a controller's queued notification that hasn't started sending is replaced in
+    /// place by a newer unsolicited notification with the same source UID, endpoint, sub-device and
+    /// parameter. This bounds how far a slow controller can fall behind a device sending rapid
+    /// updates, and gets it the newest values sooner.
+    bool coalesce_notifications{false};
+
     /// The port on which this broker should listen for incoming connections (and advertise via DNS).
     /// 0 means use an ephemeral port.
     uint16_t listen_port{0};
@@ -199,6 +248,24 @@ public:
     bool IsValid() const;
   };
 
+  /// @ingroup rdmnet_broker
+  /// @brief The state of a connected client's outgoing message queue.
+  struct ClientQueueStats
+  {
+    etcpal::Uuid cid;  ///< The client's CID.
+    rdm::Uid     uid;  ///< The client's UID, or a null UID for EPT clients.
+
+    size_t queued_messages{0};  ///< The number of messages waiting to be sent.
+    size_t queued_bytes{0};     ///< The size in bytes of the messages waiting to be sent.
+
+    /// The number of times a message for this client was refused because its queue was full.
+    uint64_t queue_full{0};
+    /// The number of queued notifications discarded by OverflowPolicy::kDropOldestNotification.
+    uint64_t notifications_dropped{0};
+    /// The number of queued notifications replaced by OverflowPolicy::kCoalesceNotifications.
+    uint64_t notifications_coalesced{0};
+  };
+
   /// @ingroup rdmnet_broker
   /// @brief A callback interface for notifications from the broker.
   class NotifyHandler
@@ -230,7 +297,8 @@ public:
   void          Shutdown(rdmnet_disconnect_reason_t disconnect_reason = kRdmnetDisconnectShutdown);
   etcpal::Error ChangeScope(const std::string& new_scope, rdmnet_disconnect_reason_t disconnect_reason);
 
-  const Settings& settings() const;
+  const Settings&               settings() const;
+  std::vector<ClientQueueStats> GetClientQueueStats() const;
 
 private:
   std::unique_ptr<BrokerCore> core_;
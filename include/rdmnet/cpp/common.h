@@ -140,6 +140,19 @@ inline void Deinit()
   return rdmnet_deinit();
 }
 
+/// @ingroup rdmnet_cpp_common
+/// @brief Deliver callbacks that are waiting in the callback queue.
+///
+/// Wraps rdmnet_dispatch_callbacks(). Only needed when the library is built to queue callbacks for
+/// the application to deliver from threads of its own.
+///
+/// @param timeout_ms How long to wait for a callback to be queued if none are waiting, in milliseconds.
+/// @return The number of callbacks delivered.
+inline size_t DispatchCallbacks(int timeout_ms = 0)
+{
+  return rdmnet_dispatch_callbacks(timeout_ms);
+}
+
 /// @ingroup rdmnet_cpp_common
 /// @brief A class representing a synchronous action to take in response to a received RDM command.
 class RdmResponseAction
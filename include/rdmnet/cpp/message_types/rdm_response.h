@@ -25,6 +25,7 @@
 
 #include <cstddef>
 #include <cstdint>
+#include <iterator>
 #include <vector>
 #include "etcpal/common.h"
 #include "etcpal/cpp/error.h"
@@ -38,6 +39,61 @@ namespace rdmnet
 {
 class SavedRdmResponse;
 
+/// @ingroup rdmnet_cpp_common
+/// @brief One contiguous piece of the parameter data of an RdmResponse.
+struct RdmDataFragment
+{
+  const uint8_t* data{nullptr};  ///< The fragment's data, pointing into the received message.
+  size_t         size{0};        ///< The size of the fragment's data.
+};
+
+/// @ingroup rdmnet_cpp_common
+/// @brief An input iterator over the parameter data fragments of an RdmResponse.
+///
+/// A default-constructed iterator is the end iterator.
+class RdmDataFragmentIterator
+{
+public:
+  using iterator_category = std::input_iterator_tag;
+  using value_type = RdmDataFragment;
+  using difference_type = std::ptrdiff_t;
+  using pointer = const RdmDataFragment*;
+  using reference = const RdmDataFragment&;
+
+  RdmDataFragmentIterator() noexcept = default;
+  explicit RdmDataFragmentIterator(const RdmnetRdmResponse& resp) noexcept;
+
+  reference operator*() const noexcept;
+  pointer   operator->() const noexcept;
+
+  RdmDataFragmentIterator& operator++() noexcept;
+  RdmDataFragmentIterator  operator++(int) noexcept;
+
+  bool operator==(const RdmDataFragmentIterator& other) const noexcept;
+  bool operator!=(const RdmDataFragmentIterator& other) const noexcept;
+
+private:
+  void Advance() noexcept;
+
+  RdmnetRdmFragmentIter iter_{};
+  RdmDataFragment       fragment_;
+  bool                  at_end_{true};
+};
+
+/// @ingroup rdmnet_cpp_common
+/// @brief The parameter data fragments of an RdmResponse, for use in a range-based for loop.
+class RdmDataFragments
+{
+public:
+  constexpr explicit RdmDataFragments(const RdmnetRdmResponse& resp) noexcept;
+
+  RdmDataFragmentIterator begin() const noexcept;
+  RdmDataFragmentIterator end() const noexcept;
+
+private:
+  const RdmnetRdmResponse& resp_;
+};
+
 /// @ingroup rdmnet_cpp_common
 /// @brief An RDM response received over RDMnet and delivered to an RDMnet callback function.
 ///
@@ -75,6 +131,7 @@ public:
   constexpr const uint8_t*      data() const noexcept;
   constexpr size_t              data_len() const noexcept;
   constexpr bool                more_coming() const noexcept;
+  constexpr RdmDataFragments    fragments() const noexcept;
 
   constexpr bool OriginalCommandIncluded() const noexcept;
   constexpr bool HasData() const noexcept;
@@ -90,6 +147,7 @@ public:
   etcpal::Expected<rdm::NackReason> GetNackReason() const noexcept;
   std::vector<uint8_t>              GetData() const;
   std::vector<uint8_t>              GetOriginalCmdData() const;
+  size_t                            CopyData(uint8_t* buf, size_t buf_len) const noexcept;
 
   constexpr const RdmnetRdmResponse& get() const noexcept;
 
@@ -166,6 +224,84 @@ private:
   rdm::Response rdm_;
 };
 
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// RdmDataFragmentIterator and RdmDataFragments function definitions
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+/// Construct an iterator pointing at the first parameter data fragment of a response.
+inline RdmDataFragmentIterator::RdmDataFragmentIterator(const RdmnetRdmResponse& resp) noexcept : at_end_(false)
+{
+  rdmnet_rdm_response_fragments_begin(&resp, &iter_);
+  Advance();
+}
+
+/// Get the current fragment.
+inline RdmDataFragmentIterator::reference RdmDataFragmentIterator::operator*() const noexcept
+{
+  return fragment_;
+}
+
+/// Access a member of the current fragment.
+inline RdmDataFragmentIterator::pointer RdmDataFragmentIterator::operator->() const noexcept
+{
+  return &fragment_;
+}
+
+/// Move to the next fragment (prefix).
+inline RdmDataFragmentIterator& RdmDataFragmentIterator::operator++() noexcept
+{
+  Advance();
+  return *this;
+}
+
+/// Move to the next fragment (postfix).
+inline RdmDataFragmentIterator RdmDataFragmentIterator::operator++(int) noexcept
+{
+  RdmDataFragmentIterator old = *this;
+  Advance();
+  return old;
+}
+
+/// Whether two iterators point at the same fragment, or are both at the end.
+inline bool RdmDataFragmentIterator::operator==(const RdmDataFragmentIterator& other) const noexcept
+{
+  if (at_end_ || other.at_end_)
+    return (at_end_ == other.at_end_);
+  return (iter_.response == other.iter_.response && iter_.next_index == other.iter_.next_index);
+}
+
+/// Whether two iterators point at different fragments.
+inline bool RdmDataFragmentIterator::operator!=(const RdmDataFragmentIterator& other) const noexcept
+{
+  return !(*this == other);
+}
+
+inline void RdmDataFragmentIterator::Advance() noexcept
+{
+  if (!at_end_ && !rdmnet_rdm_response_next_fragment(&iter_, &fragment_.data, &fragment_.size))
+  {
+    fragment_ = RdmDataFragment{};
+    at_end_ = true;
+  }
+}
+
+/// Construct a fragment range referencing a C RdmnetRdmResponse.
+constexpr RdmDataFragments::RdmDataFragments(const RdmnetRdmResponse& resp) noexcept : resp_(resp)
+{
+}
+
+/// Get an iterator to the first fragment.
+inline RdmDataFragmentIterator RdmDataFragments::begin() const noexcept
+{
+  return RdmDataFragmentIterator(resp_);
+}
+
+/// Get the end iterator.
+inline RdmDataFragmentIterator RdmDataFragments::end() const noexcept
+{
+  return RdmDataFragmentIterator();
+}
+
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 // RdmResponse function definitions
 ///////////////////////////////////////////////////////////////////////////////////////////////////
@@ -275,7 +411,10 @@ constexpr rdm::ResponseHeader RdmResponse::rdm_header() const noexcept
   return resp_.rdm_header;
 }
 
-/// Get a pointer to the RDM parameter data buffer contained within this response.
+/// @brief Get a pointer to the RDM parameter data buffer contained within this response.
+///
+/// This is nullptr if the library was built with RDMNET_RECOMBINE_RDM_RESPONSE_DATA set to 0 and
+/// the data was received in more than one ACK_OVERFLOW response; use fragments() to read it.
 constexpr const uint8_t* RdmResponse::data() const noexcept
 {
   return resp_.rdm_data;
@@ -298,6 +437,18 @@ constexpr bool RdmResponse::more_coming() const noexcept
   return resp_.more_coming;
 }
 
+/// @brief Get the RDM parameter data of this response as the series of fragments it was received in.
+///
+/// Iterating over the fragments reads the data in place, without copying it:
+/// @code
+/// for (const auto& fragment : resp.fragments())
+///   ProcessData(fragment.data, fragment.size);
+/// @endcode
+constexpr RdmDataFragments RdmResponse::fragments() const noexcept
+{
+  return RdmDataFragments(resp_);
+}
+
 /// @brief Whether the original RDM command is included.
 ///
 /// In RDMnet, a response to an RDM command includes the original command data. An exception to
@@ -373,7 +524,12 @@ inline etcpal::Expected<rdm::NackReason> RdmResponse::GetNackReason() const noex
 /// @return A copied vector containing any parameter data associated with this response.
 inline std::vector<uint8_t> RdmResponse::GetData() const
 {
-  return std::vector<uint8_t>(resp_.rdm_data, resp_.rdm_data + resp_.rdm_data_len);
+  if (resp_.rdm_data)
+    return std::vector<uint8_t>(resp_.rdm_data, resp_.rdm_data + resp_.rdm_data_len);
+
+  std::vector<uint8_t> data(resp_.rdm_data_len);
+  data.resize(rdmnet_rdm_response_copy_data(&resp_, data.data(), data.size()));
+  return data;
 }
 
 /// @brief Copy out the original RDM command data in a RdmResponse.
@@ -384,6 +540,15 @@ inline std::vector<uint8_t> RdmResponse::GetOriginalCmdData() const
   return std::vector<uint8_t>(resp_.original_cmd_data, resp_.original_cmd_data + resp_.original_cmd_data_len);
 }
 
+/// @brief Copy the parameter data in a RdmResponse into a contiguous buffer.
+/// @param buf Buffer to copy the data into.
+/// @param buf_len Size of buf. At most this many bytes are copied.
+/// @return The number of bytes copied.
+inline size_t RdmResponse::CopyData(uint8_t* buf, size_t buf_len) const noexcept
+{
+  return rdmnet_rdm_response_copy_data(&resp_, buf, buf_len);
+}
+
 /// Get a const reference to the underlying C type.
 constexpr const RdmnetRdmResponse& RdmResponse::get() const noexcept
 {
@@ -403,7 +568,11 @@ inline rdm::Command RdmResponse::OriginalCommandToRdm() const
 /// Convert the RDM data in this response to an RDM response type.
 inline rdm::Response RdmResponse::ToRdm() const
 {
-  return rdm::Response(resp_.rdm_header, resp_.rdm_data, resp_.rdm_data_len);
+  if (resp_.rdm_data || resp_.rdm_data_len == 0)
+    return rdm::Response(resp_.rdm_header, resp_.rdm_data, resp_.rdm_data_len);
+
+  auto data = GetData();
+  return rdm::Response(resp_.rdm_header, data.data(), data.size());
 }
 
 /// @brief Save the data in this response for later use from a different context.
@@ -671,7 +840,8 @@ inline std::vector<uint8_t> SavedRdmResponse::GetData() const
 /// @param new_resp An RdmResponse delivered to an RDMnet callback function as a continuation of a previous response.
 inline void SavedRdmResponse::AppendData(const RdmResponse& new_resp)
 {
-  rdm_.AppendData(new_resp.data(), new_resp.data_len());
+  for (const auto& fragment : new_resp.fragments())
+    rdm_.AppendData(fragment.data, fragment.size);
 }
 
 /// @brief Append more data to this response's parameter data.
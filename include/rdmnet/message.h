@@ -113,7 +113,12 @@ typedef struct RdmnetRdmResponse
 
   /** The header information from the encapsulated RDM response. */
   RdmResponseHeader rdm_header;
-  /** Any parameter data associated with the RDM response. */
+  /**
+   * Any parameter data associated with the RDM response, as one contiguous buffer. May be NULL
+   * while rdm_data_len is nonzero if the library was compiled with
+   * RDMNET_RECOMBINE_RDM_RESPONSE_DATA set to 0 and the data arrived in more than one ACK_OVERFLOW
+   * response; use rdmnet_rdm_response_next_fragment() to read it in that case.
+   */
   const uint8_t* rdm_data;
   /** The length of the parameter data associated with the RDM response. */
   size_t rdm_data_len;
@@ -126,8 +131,33 @@ typedef struct RdmnetRdmResponse
    * is received with more_coming set to false.
    */
   bool more_coming;
+
+  /**
+   * The received RDM response PDUs that carry the parameter data, in order. Each PDU's parameter
+   * data is one fragment of the response data. NULL if the response was not built from received
+   * PDUs, in which case rdm_data is the only fragment. Read these using
+   * rdmnet_rdm_response_next_fragment() rather than directly.
+   */
+  const RdmBuffer* rdm_fragments;
+  /** The number of RDM response PDUs in rdm_fragments. */
+  size_t num_rdm_fragments;
 } RdmnetRdmResponse;
 
+/**
+ * @brief An iterator over the parameter data fragments of an RdmnetRdmResponse.
+ *
+ * Large RDM responses arrive as a series of ACK_OVERFLOW responses, each carrying a fragment of
+ * the parameter data. Iterating over the fragments lets an application consume the data where it
+ * was received, without a contiguous copy. Initialize with rdmnet_rdm_response_fragments_begin().
+ */
+typedef struct RdmnetRdmFragmentIter
+{
+  /** The response being iterated. */
+  const RdmnetRdmResponse* response;
+  /** The index of the next fragment to examine. */
+  size_t next_index;
+} RdmnetRdmFragmentIter;
+
 /**
  * @brief An RDM response received over RDMnet and saved for later processing.
  *
@@ -517,6 +547,10 @@ etcpal_error_t rdmnet_append_to_saved_rdm_response(const RdmnetRdmResponse* new_
                                                    RdmnetSavedRdmResponse*  previously_saved_response);
 etcpal_error_t rdmnet_save_rpt_status(const RdmnetRptStatus* status, RdmnetSavedRptStatus* saved_status);
 
+void   rdmnet_rdm_response_fragments_begin(const RdmnetRdmResponse* response, RdmnetRdmFragmentIter* iter);
+bool   rdmnet_rdm_response_next_fragment(RdmnetRdmFragmentIter* iter, const uint8_t** data, size_t* data_len);
+size_t rdmnet_rdm_response_copy_data(const RdmnetRdmResponse* response, uint8_t* buf, size_t buf_len);
+
 etcpal_error_t rdmnet_copy_saved_rdm_response(const RdmnetSavedRdmResponse* saved_resp_old,
                                               RdmnetSavedRdmResponse*       saved_resp_new);
 etcpal_error_t rdmnet_copy_saved_rpt_status(const RdmnetSavedRptStatus* saved_status_old,
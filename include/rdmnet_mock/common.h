@@ -34,6 +34,7 @@ extern "C" {
 
 DECLARE_FAKE_VALUE_FUNC(etcpal_error_t, rdmnet_init, const EtcPalLogParams*, const RdmnetNetintConfig*);
 DECLARE_FAKE_VOID_FUNC(rdmnet_deinit);
+DECLARE_FAKE_VALUE_FUNC(size_t, rdmnet_dispatch_callbacks, int);
 
 void rdmnet_mock_common_reset(void);
 // void rdmnet_mock_common_reset_and_init(void);
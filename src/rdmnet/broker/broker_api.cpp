@@ -105,3 +105,15 @@ const rdmnet::Broker::Settings& rdmnet::Broker::settings() const
 
   return core_->settings();
 }
+
+/// @brief Get the state of each connected client's outgoing message queue.
+///
+/// Includes the overflow counters maintained according to Limits::overflow_policy. Clients that
+/// have not yet completed the RDMnet connection handshake are not included.
+std::vector<rdmnet::Broker::ClientQueueStats> rdmnet::Broker::GetClientQueueStats() const
+{
+  if (!RDMNET_ASSERT_VERIFY(core_))
+    return {};
+
+  return core_->GetClientQueueStats();
+}
@@ -19,15 +19,45 @@
 
 #include "broker_client.h"
 
+#include "etcpal/pack.h"
+#include "rdm/defs.h"
 #include "rdmnet/cpp/broker.h"
 #include "rdmnet/core/broker_prot.h"
 #include "rdmnet/core/common.h"
 #include "rdmnet/core/connection.h"
 #include "rdmnet/core/opts.h"
+#include "broker_socket_manager.h"
+
+namespace
+{
+// An unsolicited notification (sequence number 0) carrying a single complete RDM response reports
+// the current value of one parameter, so it supersedes any earlier one for the same parameter.
+bool GetNotificationKey(const RptMessage& msg, NotificationKey& key)
+{
+  if (msg.vector != VECTOR_RPT_NOTIFICATION || msg.header.seqnum != 0)
+    return false;
+
+  const RptRdmBufList* buf_list = RPT_GET_RDM_BUF_LIST(&msg);
+  if (!buf_list || buf_list->num_rdm_buffers != 1 || buf_list->more_coming)
+    return false;
+
+  const RdmBuffer& buf = buf_list->rdm_buffers[0];
+  if (buf.data_len < RDM_OFFSET_PARAM_DATA || !RDM_CC_IS_NON_DISC_RESPONSE(buf.data[RDM_OFFSET_COMMAND_CLASS]))
+    return false;
+
+  key.source_uid.manu = etcpal_unpack_u16b(&buf.data[RDM_OFFSET_SRC_MANUFACTURER]);
+  key.source_uid.id = etcpal_unpack_u32b(&buf.data[RDM_OFFSET_SRC_DEVICE]);
+  key.endpoint = msg.header.source_endpoint_id;
+  key.subdevice = etcpal_unpack_u16b(&buf.data[RDM_OFFSET_SUBDEVICE]);
+  key.command_class = buf.data[RDM_OFFSET_COMMAND_CLASS];
+  key.param_id = etcpal_unpack_u16b(&buf.data[RDM_OFFSET_PARAM_ID]);
+  return true;
+}
+}  // namespace
 
 bool BrokerClient::HasRoomToPush()
 {
-  return (max_q_size_ == kLimitlessQueueSize) || (broker_msgs_.size() < max_q_size_);
+  return HasRoomForBytes() && ((max_q_size_ == kLimitlessQueueSize) || (broker_msgs_.size() < max_q_size_));
 }
 
 ClientPushResult BrokerClient::Push(const etcpal::Uuid& sender_cid, const BrokerMessage& msg)
@@ -35,7 +65,7 @@ ClientPushResult BrokerClient::Push(const etcpal::Uuid& sender_cid, const Broker
   if (marked_for_destruction_)
     return ClientPushResult::Error;
   if (!HasRoomToPush())
-    return ClientPushResult::QueueFull;
+    return RecordQueueFull();
 
   return PushPostSizeCheck(sender_cid, msg);
 }
@@ -50,13 +80,14 @@ bool BrokerClient::Send(const etcpal::Uuid& broker_cid)
     if (!RDMNET_ASSERT_VERIFY(msg_data))
       return false;
 
-    int res = rc_send(socket_, &msg_data[msg.size_sent], msg.size - msg.size_sent, 0);
+    int res = SendData(&msg_data[msg.size_sent], msg.size - msg.size_sent);
     if (res >= 0)
     {
       msg.size_sent += res;
       if (msg.size_sent >= msg.size)
       {
         // We are done with this message.
+        MessageDequeued(msg);
         broker_msgs_.pop_front();
       }
       return true;
@@ -73,6 +104,22 @@ bool BrokerClient::Send(const etcpal::Uuid& broker_cid)
   return false;
 }
 
+ClientPushResult BrokerClient::RecordQueueFull()
+{
+  ++queue_full_count_;
+  return ClientPushResult::QueueFull;
+}
+
+void BrokerClient::GetQueueStats(rdmnet::Broker::ClientQueueStats& stats) const
+{
+  stats.cid = cid_;
+  stats.queued_messages = q_msgs_;
+  stats.queued_bytes = q_bytes_;
+  stats.queue_full = queue_full_count_;
+  stats.notifications_dropped = notifications_dropped_;
+  stats.notifications_coalesced = notifications_coalesced_;
+}
+
 void BrokerClient::MarkForDestruction(const etcpal::Uuid&        broker_cid,
                                       const rdm::Uid&            broker_uid,
                                       const ClientDestroyAction& destroy_action)
@@ -100,6 +147,7 @@ ClientPushResult BrokerClient::PushPostSizeCheck(const etcpal::Uuid& sender_cid,
                                                     &sender_cid.get(), BROKER_GET_CONNECT_REPLY_MSG(&msg));
         if (to_push.size)
         {
+          MessageQueued(to_push);
           broker_msgs_.push_back(std::move(to_push));
           res = ClientPushResult::Ok;
         }
@@ -128,12 +176,33 @@ ClientPushResult BrokerClient::PushPostSizeCheck(const etcpal::Uuid& sender_cid,
                                                         rpt_list->client_entries, rpt_list->num_client_entries);
           if (to_push.size)
           {
+            MessageQueued(to_push);
+            broker_msgs_.push_back(std::move(to_push));
+            res = ClientPushResult::Ok;
+          }
+        }
+      }
+      else if (client_list->client_protocol == kClientProtocolEPT)
+      {
+        const RdmnetEptClientList* ept_list = BROKER_GET_EPT_CLIENT_LIST(client_list);
+        if (!RDMNET_ASSERT_VERIFY(ept_list))
+          return ClientPushResult::Error;
+
+        size_t bufsize =
+            rc_broker_get_ept_client_list_buffer_size(ept_list->client_entries, ept_list->num_client_entries);
+        MessageRef to_push(bufsize);
+        if (to_push.data)
+        {
+          to_push.size = rc_broker_pack_ept_client_list(to_push.data.get(), bufsize, &sender_cid.get(), msg.vector,
+                                                        ept_list->client_entries, ept_list->num_client_entries);
+          if (to_push.size)
+          {
+            MessageQueued(to_push);
             broker_msgs_.push_back(std::move(to_push));
             res = ClientPushResult::Ok;
           }
         }
       }
-      // else TODO EPT
       break;
     }
     case VECTOR_BROKER_DISCONNECT: {
@@ -144,6 +213,7 @@ ClientPushResult BrokerClient::PushPostSizeCheck(const etcpal::Uuid& sender_cid,
                                                  BROKER_GET_DISCONNECT_MSG(&msg));
         if (to_push.size)
         {
+          MessageQueued(to_push);
           broker_msgs_.push_back(std::move(to_push));
           res = ClientPushResult::Ok;
         }
@@ -156,11 +226,50 @@ ClientPushResult BrokerClient::PushPostSizeCheck(const etcpal::Uuid& sender_cid,
   return res;
 }
 
+// Sends through the socket manager, which may batch the send with those to other clients.
+int BrokerClient::SendData(const uint8_t* data, size_t size)
+{
+  if (socket_mgr_)
+    return socket_mgr_->SendOnSocket(handle_, socket_, data, size);
+  return rc_send(socket_, data, size, 0);
+}
+
 bool BrokerClient::SendNull(const etcpal::Uuid& broker_cid)
 {
   auto   send_buf = std::unique_ptr<uint8_t[]>(new uint8_t[BROKER_NULL_FULL_MSG_SIZE]);
   size_t send_size = rc_broker_pack_null(send_buf.get(), BROKER_NULL_FULL_MSG_SIZE, &broker_cid.get());
-  return (rc_send(socket_, send_buf.get(), send_size, 0) >= 0);
+  return (SendData(send_buf.get(), send_size) >= 0);
+}
+
+// A message is accepted while the queued bytes are under the limit, so the limits can be exceeded by
+// at most one message; the size of a message isn't known until it has been packed.
+bool BrokerClient::HasRoomForBytes() const
+{
+  return ((max_q_bytes_ == kLimitlessQueueSize) || (q_bytes_ < max_q_bytes_)) && (!q_budget_ || q_budget_->HasRoom());
+}
+
+void BrokerClient::MessageQueued(const MessageRef& msg)
+{
+  ++q_msgs_;
+  q_bytes_ += msg.size;
+  if (q_budget_)
+    q_budget_->Add(msg.size);
+}
+
+void BrokerClient::MessageDequeued(const MessageRef& msg)
+{
+  --q_msgs_;
+  q_bytes_ -= msg.size;
+  if (q_budget_)
+    q_budget_->Remove(msg.size);
+}
+
+void BrokerClient::ReleaseQueuedMessages()
+{
+  if (q_budget_)
+    q_budget_->Remove(q_bytes_);
+  q_msgs_ = 0;
+  q_bytes_ = 0;
 }
 
 void BrokerClient::ApplyDestroyAction(const etcpal::Uuid&        broker_cid,
@@ -180,6 +289,8 @@ void BrokerClient::ApplyDestroyAction(const etcpal::Uuid&        broker_cid,
       connect_reply_msg->broker_uid = broker_uid.get();
       connect_reply_msg->connect_status = destroy_action.connect_status();
       connect_reply_msg->e133_version = E133_VERSION;
+      if (destroy_action.retry_after_ms() != 0)
+        BROKER_CONNECT_REPLY_SET_RETRY_AFTER(connect_reply_msg, destroy_action.retry_after_ms());
 
       Push(broker_cid, msg);
     }
@@ -207,7 +318,7 @@ void BrokerClient::ApplyDestroyAction(const etcpal::Uuid&        broker_cid,
 
 bool RPTClient::HasRoomToPush()
 {
-  return (broker_msgs_.size() + status_msgs_.size()) < max_q_size_;
+  return HasRoomForBytes() && ((broker_msgs_.size() + status_msgs_.size()) < max_q_size_);
 }
 
 ClientPushResult RPTClient::Push(const etcpal::Uuid& sender_cid, const BrokerMessage& msg)
@@ -215,7 +326,7 @@ ClientPushResult RPTClient::Push(const etcpal::Uuid& sender_cid, const BrokerMes
   if (marked_for_destruction_)
     return ClientPushResult::Error;
   if (!HasRoomToPush())
-    return ClientPushResult::QueueFull;
+    return RecordQueueFull();
 
   return BrokerClient::PushPostSizeCheck(sender_cid, msg);
 }
@@ -233,6 +344,7 @@ ClientPushResult RPTClient::PushPostSizeCheck(const etcpal::Uuid& sender_cid,
     to_push.size = rc_rpt_pack_status(to_push.data.get(), bufsize, &sender_cid.get(), &header, &msg);
     if (to_push.size)
     {
+      MessageQueued(to_push);
       status_msgs_.push_back(std::move(to_push));
       res = ClientPushResult::Ok;
     }
@@ -244,12 +356,38 @@ void RPTClient::ClearAllQueues()
 {
   broker_msgs_.clear();
   status_msgs_.clear();
+  ReleaseQueuedMessages();
+}
+
+void RPTClient::GetQueueStats(rdmnet::Broker::ClientQueueStats& stats) const
+{
+  BrokerClient::GetQueueStats(stats);
+  stats.uid = uid_;
 }
 
 bool RPTController::HasRoomToPush()
 {
-  return ((max_q_size_ == kLimitlessQueueSize) ||
-          (status_msgs_.size() + broker_msgs_.size() + rpt_msgs_.size()) < max_q_size_);
+  return HasRoomForBytes() && ((max_q_size_ == kLimitlessQueueSize) ||
+                               (status_msgs_.size() + broker_msgs_.size() + rpt_msgs_.size()) < max_q_size_);
+}
+
+// A notification can still be taken by a full controller if it replaces a queued one or the
+// overflow policy can make room for it. The broker-wide limit is never relieved by discarding a
+// single controller's notifications.
+bool RPTController::HasRoomForRptMessage(const RptMessage& msg)
+{
+  if (HasRoomToPush())
+    return true;
+  if (msg.vector != VECTOR_RPT_NOTIFICATION || (q_budget_ && !q_budget_->HasRoom()))
+    return false;
+
+  NotificationKey key;
+  if (CoalescesNotifications() && GetNotificationKey(msg, key) && FindCoalescibleNotification(key))
+    return true;
+
+  if (overflow_policy_ == rdmnet::Broker::OverflowPolicy::kDropOldestNotification)
+    return DropOldestNotifications(false);
+  return false;
 }
 
 ClientPushResult RPTController::Push(BrokerClient::Handle /*from_client*/,
@@ -258,8 +396,8 @@ ClientPushResult RPTController::Push(BrokerClient::Handle /*from_client*/,
 {
   if (marked_for_destruction_)
     return ClientPushResult::Error;
-  if (!HasRoomToPush())
-    return ClientPushResult::QueueFull;
+  if (!HasRoomForRptMessage(msg))
+    return RecordQueueFull();
 
   ClientPushResult res = ClientPushResult::Error;
 
@@ -278,6 +416,7 @@ ClientPushResult RPTController::Push(BrokerClient::Handle /*from_client*/,
             rc_rpt_pack_request(to_push.data.get(), bufsize, &sender_cid.get(), &msg.header, rdm_buf_list->rdm_buffers);
         if (to_push.size)
         {
+          MessageQueued(to_push);
           rpt_msgs_.push_back(std::move(to_push));
           res = ClientPushResult::Ok;
         }
@@ -310,8 +449,9 @@ ClientPushResult RPTController::Push(BrokerClient::Handle /*from_client*/,
             rc_rpt_pack_notification(to_push.data.get(), bufsize, &sender_cid.get(), &msg.header, buffers, num_buffers);
         if (to_push.size)
         {
-          rpt_msgs_.push_back(std::move(to_push));
-          res = ClientPushResult::Ok;
+          to_push.notification = true;
+          to_push.coalescible = GetNotificationKey(msg, to_push.notification_key);
+          res = PushNotification(std::move(to_push));
         }
       }
     }
@@ -328,7 +468,7 @@ ClientPushResult RPTController::Push(const etcpal::Uuid& sender_cid, const Broke
   if (marked_for_destruction_)
     return ClientPushResult::Error;
   if (!HasRoomToPush())
-    return ClientPushResult::QueueFull;
+    return RecordQueueFull();
 
   return BrokerClient::PushPostSizeCheck(sender_cid, msg);
 }
@@ -338,7 +478,7 @@ ClientPushResult RPTController::Push(const etcpal::Uuid& sender_cid, const RptHe
   if (marked_for_destruction_)
     return ClientPushResult::Error;
   if (!HasRoomToPush())
-    return ClientPushResult::QueueFull;
+    return RecordQueueFull();
 
   return PushPostSizeCheck(sender_cid, header, msg);
 }
@@ -363,18 +503,23 @@ bool RPTController::Send(const etcpal::Uuid& broker_cid)
   {
     q = &rpt_msgs_;
     msg = &rpt_msgs_.front();
+
+    // Once a notification starts going out, it can no longer be replaced.
+    if (msg->size_sent == 0)
+      ForgetCoalescibleNotification(*msg);
   }
 
   // Try to send the message.
   if (msg && q)
   {
-    int res = rc_send(socket_, &msg->data.get()[msg->size_sent], msg->size - msg->size_sent, 0);
+    int res = SendData(&msg->data.get()[msg->size_sent], msg->size - msg->size_sent);
     if (res >= 0)
     {
       msg->size_sent += res;
       if (msg->size_sent >= msg->size)
       {
         // We are done with this message.
+        MessageDequeued(*msg);
         q->pop_front();
         send_timer_.Reset();
       }
@@ -397,12 +542,133 @@ void RPTController::ClearAllQueues()
   rpt_msgs_.clear();
   status_msgs_.clear();
   broker_msgs_.clear();
+  coalescible_notifications_.clear();
+  ReleaseQueuedMessages();
+}
+
+// Queues a packed notification, coalescing it or applying the overflow policy as configured.
+// HasRoomToPush() and HasRoomForRptMessage() can disagree only when one of those can make room.
+ClientPushResult RPTController::PushNotification(MessageRef&& to_push)
+{
+  if (CoalescesNotifications() && to_push.coalescible)
+  {
+    // When coalescing is only the overflow policy, a queue with room takes the notification as usual.
+    MessageRef* queued = FindCoalescibleNotification(to_push.notification_key);
+    if (queued && (coalesce_notifications_ || !HasRoomToPush()))
+    {
+      // Replace the queued notification in place, so the new value goes out when the old one would have.
+      MessageDequeued(*queued);
+      MessageQueued(to_push);
+      *queued = std::move(to_push);
+      ++notifications_coalesced_;
+      return ClientPushResult::Ok;
+    }
+  }
+
+  if (!HasRoomToPush())
+  {
+    if (overflow_policy_ == rdmnet::Broker::OverflowPolicy::kDropOldestNotification &&
+        DropOldestNotifications(false))
+    {
+      DropOldestNotifications(true);
+    }
+
+    if (!HasRoomToPush())
+      return RecordQueueFull();
+  }
+
+  MessageQueued(to_push);
+  rpt_msgs_.push_back(std::move(to_push));
+  if (CoalescesNotifications() && rpt_msgs_.back().coalescible)
+    coalescible_notifications_[rpt_msgs_.back().notification_key] = &rpt_msgs_.back();
+  return ClientPushResult::Ok;
+}
+
+// Discards the oldest queued notifications until the per-client limits have room for one more
+// message. If apply is false, only determines whether that is possible. A message that has been
+// partially sent is never discarded.
+bool RPTController::DropOldestNotifications(bool apply)
+{
+  size_t num_msgs = q_msgs_;
+  size_t num_bytes = q_bytes_;
+  auto   has_room = [&]() {
+    return ((max_q_size_ == kLimitlessQueueSize) || (num_msgs < max_q_size_)) &&
+           ((max_q_bytes_ == kLimitlessQueueSize) || (num_bytes < max_q_bytes_));
+  };
+
+  bool dropped = false;
+  auto msg = rpt_msgs_.begin();
+  while (!has_room() && msg != rpt_msgs_.end())
+  {
+    if (msg->notification && msg->size_sent == 0)
+    {
+      --num_msgs;
+      num_bytes -= msg->size;
+      if (apply)
+      {
+        MessageDequeued(*msg);
+        msg = rpt_msgs_.erase(msg);
+        ++notifications_dropped_;
+        dropped = true;
+        continue;
+      }
+    }
+    ++msg;
+  }
+
+  if (dropped)
+    IndexCoalescibleNotifications();
+  return has_room();
+}
+
+bool RPTController::CoalescesNotifications() const
+{
+  return coalesce_notifications_ || (overflow_policy_ == rdmnet::Broker::OverflowPolicy::kCoalesceNotifications);
+}
+
+// Finds the unsent notification that a new notification with the given key would replace, as long
+// as the replacement leaves the byte limit with room like any other push.
+MessageRef* RPTController::FindCoalescibleNotification(const NotificationKey& key)
+{
+  auto queued = coalescible_notifications_.find(key);
+  if (queued == coalescible_notifications_.end())
+    return nullptr;
+
+  MessageRef* msg = queued->second;
+  if ((max_q_bytes_ != kLimitlessQueueSize) && (q_bytes_ - msg->size >= max_q_bytes_))
+    return nullptr;
+  return msg;
+}
+
+void RPTController::ForgetCoalescibleNotification(const MessageRef& msg)
+{
+  if (!msg.coalescible)
+    return;
+
+  auto queued = coalescible_notifications_.find(msg.notification_key);
+  if (queued != coalescible_notifications_.end() && queued->second == &msg)
+    coalescible_notifications_.erase(queued);
+}
+
+// Rebuilds the index from the queue. Where there are several candidates for a key, the newest is
+// indexed, as it would have been when pushed.
+void RPTController::IndexCoalescibleNotifications()
+{
+  coalescible_notifications_.clear();
+  if (!CoalescesNotifications())
+    return;
+
+  for (auto& msg : rpt_msgs_)
+  {
+    if (msg.coalescible && msg.size_sent == 0)
+      coalescible_notifications_[msg.notification_key] = &msg;
+  }
 }
 
 bool RPTDevice::HasRoomToPush()
 {
-  return ((max_q_size_ == kLimitlessQueueSize) ||
-          (status_msgs_.size() + broker_msgs_.size() + rpt_msgs_.size()) < max_q_size_);
+  return HasRoomForBytes() && ((max_q_size_ == kLimitlessQueueSize) ||
+                               (status_msgs_.size() + broker_msgs_.size() + rpt_msgs_.size()) < max_q_size_);
 }
 
 ClientPushResult RPTDevice::Push(BrokerClient::Handle from_client,
@@ -412,7 +678,7 @@ ClientPushResult RPTDevice::Push(BrokerClient::Handle from_client,
   if (marked_for_destruction_)
     return ClientPushResult::Error;
   if (!HasRoomToPush())
-    return ClientPushResult::QueueFull;
+    return RecordQueueFull();
 
   ClientPushResult res = ClientPushResult::Error;
 
@@ -440,6 +706,7 @@ ClientPushResult RPTDevice::Push(BrokerClient::Handle from_client,
             rc_rpt_pack_request(to_push.data.get(), bufsize, &sender_cid.get(), &msg.header, rdm_buf_list->rdm_buffers);
         if (to_push.size)
         {
+          MessageQueued(to_push);
           rpt_msgs_.push_back(from_client, std::move(to_push));
           res = ClientPushResult::Ok;
         }
@@ -458,7 +725,7 @@ ClientPushResult RPTDevice::Push(const etcpal::Uuid& sender_cid, const BrokerMes
   if (marked_for_destruction_)
     return ClientPushResult::Error;
   if (!HasRoomToPush())
-    return ClientPushResult::QueueFull;
+    return RecordQueueFull();
 
   return BrokerClient::PushPostSizeCheck(sender_cid, msg);
 }
@@ -489,7 +756,7 @@ bool RPTDevice::Send(const etcpal::Uuid& broker_cid)
     if (!RDMNET_ASSERT_VERIFY(msg_data))
       return false;
 
-    int res = rc_send(socket_, &msg_data[msg->size_sent], msg->size - msg->size_sent, 0);
+    int res = SendData(&msg_data[msg->size_sent], msg->size - msg->size_sent);
     if (res >= 0)
     {
       msg->size_sent += res;
@@ -497,6 +764,7 @@ bool RPTDevice::Send(const etcpal::Uuid& broker_cid)
       {
         // We are done with this message.
         send_timer_.Reset();
+        MessageDequeued(*msg);
         if (is_rpt)
           rpt_msgs_.pop_front();
         else
@@ -509,7 +777,10 @@ bool RPTDevice::Send(const etcpal::Uuid& broker_cid)
       // Error in sending. If this is an RPT message, delete the reference to this controller (and
       // clear out the queue)
       if (is_rpt)
-        rpt_msgs_.RemoveCurrentController();
+      {
+        for (const auto& removed : rpt_msgs_.RemoveCurrentController())
+          MessageDequeued(removed);
+      }
     }
   }
   else if (send_timer_.IsExpired())
@@ -528,6 +799,7 @@ void RPTDevice::ClearAllQueues()
   rpt_msgs_.clear();
   status_msgs_.clear();
   broker_msgs_.clear();
+  ReleaseQueuedMessages();
 }
 
 bool RPTDevice::RptMsgQ::empty() const
@@ -585,14 +857,18 @@ size_t RPTDevice::RptMsgQ::size() const
   return total_msg_count_;
 }
 
-void RPTDevice::RptMsgQ::RemoveCurrentController()
+std::deque<MessageRef> RPTDevice::RptMsgQ::RemoveCurrentController()
 {
+  std::deque<MessageRef> removed;
+
   auto controller_pair = rpt_msgs_.find(current_controller_);
   if (controller_pair != rpt_msgs_.end())
   {
     total_msg_count_ -= controller_pair->second.size();
+    removed = std::move(controller_pair->second);
     rpt_msgs_.erase(controller_pair);
   }
+  return removed;
 }
 
 void RPTDevice::RptMsgQ::clear()
@@ -601,3 +877,151 @@ void RPTDevice::RptMsgQ::clear()
   total_msg_count_ = 0;
   current_controller_ = kInvalidHandle;
 }
+
+bool EPTClient::HasRoomToPush()
+{
+  return HasRoomForBytes() &&
+         ((max_q_size_ == kLimitlessQueueSize) || (broker_msgs_.size() + ept_msgs_.size()) < max_q_size_);
+}
+
+ClientPushResult EPTClient::Push(const etcpal::Uuid& sender_cid, const BrokerMessage& msg)
+{
+  if (marked_for_destruction_)
+    return ClientPushResult::Error;
+  if (!HasRoomToPush())
+    return RecordQueueFull();
+
+  return BrokerClient::PushPostSizeCheck(sender_cid, msg);
+}
+
+// The EPT message is packed directly into the outgoing buffer; for data messages the payload still
+// points into the sender's receive buffer, so this is the only copy made of it in the broker.
+ClientPushResult EPTClient::Push(const etcpal::Uuid& sender_cid, const EptMessage& msg)
+{
+  if (marked_for_destruction_)
+    return ClientPushResult::Error;
+  if (!HasRoomToPush())
+    return RecordQueueFull();
+
+  ClientPushResult res = ClientPushResult::Error;
+
+  switch (msg.vector)
+  {
+    case VECTOR_EPT_DATA: {
+      auto data_msg = EPT_GET_DATA_MSG(&msg);
+      if (!RDMNET_ASSERT_VERIFY(data_msg))
+        return ClientPushResult::Error;
+
+      size_t     bufsize = rc_ept_get_data_buffer_size(data_msg->data_len);
+      MessageRef to_push(bufsize);
+      if (to_push.data)
+      {
+        to_push.size =
+            rc_ept_pack_data(to_push.data.get(), bufsize, &sender_cid.get(), &msg.dest_cid, data_msg->manufacturer_id,
+                             data_msg->protocol_id, data_msg->data, data_msg->data_len);
+        if (to_push.size)
+        {
+          MessageQueued(to_push);
+          ept_msgs_.push_back(std::move(to_push));
+          res = ClientPushResult::Ok;
+        }
+      }
+    }
+    break;
+
+    case VECTOR_EPT_STATUS: {
+      auto status_msg = EPT_GET_STATUS_MSG(&msg);
+      if (!RDMNET_ASSERT_VERIFY(status_msg))
+        return ClientPushResult::Error;
+
+      size_t     bufsize = rc_ept_get_status_buffer_size(status_msg->status_string);
+      MessageRef to_push(bufsize);
+      if (to_push.data)
+      {
+        to_push.size = rc_ept_pack_status(to_push.data.get(), bufsize, &sender_cid.get(), &msg.dest_cid,
+                                          status_msg->status_code, status_msg->status_string);
+        if (to_push.size)
+        {
+          MessageQueued(to_push);
+          ept_msgs_.push_back(std::move(to_push));
+          res = ClientPushResult::Ok;
+        }
+      }
+    }
+    break;
+
+    default:
+      break;
+  }
+  return res;
+}
+
+bool EPTClient::Send(const etcpal::Uuid& broker_cid)
+{
+  MessageRef*             msg = nullptr;
+  std::deque<MessageRef>* q = nullptr;
+
+  // Broker messages are first priority, then EPT messages.
+  if (!broker_msgs_.empty())
+  {
+    q = &broker_msgs_;
+    msg = &broker_msgs_.front();
+  }
+  else if (!ept_msgs_.empty())
+  {
+    q = &ept_msgs_;
+    msg = &ept_msgs_.front();
+  }
+
+  // Try to send the message.
+  if (msg && q)
+  {
+    auto msg_data = msg->data.get();
+    if (!RDMNET_ASSERT_VERIFY(msg_data))
+      return false;
+
+    int res = SendData(&msg_data[msg->size_sent], msg->size - msg->size_sent);
+    if (res >= 0)
+    {
+      msg->size_sent += res;
+      if (msg->size_sent >= msg->size)
+      {
+        // We are done with this message.
+        MessageDequeued(*msg);
+        q->pop_front();
+        send_timer_.Reset();
+      }
+      return true;
+    }
+  }
+  else if (send_timer_.IsExpired())
+  {
+    if (SendNull(broker_cid))
+    {
+      send_timer_.Reset();
+      return true;
+    }
+  }
+  return false;
+}
+
+// Fill in a client entry for this client. The entry references the data in protocols, which must
+// outlive it.
+void EPTClient::GetClientEntry(RdmnetEptClientEntry& entry, std::vector<RdmnetEptSubProtocol>& protocols) const
+{
+  protocols.clear();
+  protocols.reserve(protocols_.size());
+  for (const auto& prot : protocols_)
+    protocols.push_back(RdmnetEptSubProtocol{prot.manufacturer_id, prot.protocol_id, prot.protocol_string.c_str()});
+
+  entry.cid = cid_.get();
+  entry.protocols = protocols.data();
+  entry.num_protocols = protocols.size();
+}
+
+void EPTClient::ClearAllQueues()
+{
+  ept_msgs_.clear();
+  broker_msgs_.clear();
+  ReleaseQueuedMessages();
+}
@@ -22,11 +22,16 @@
 #ifndef BROKER_CLIENT_H_
 #define BROKER_CLIENT_H_
 
+#include <atomic>
 #include <chrono>
 #include <memory>
 #include <map>
 #include <deque>
+#include <functional>
 #include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <vector>
 #include "etcpal/cpp/error.h"
 #include "etcpal/cpp/inet.h"
 #include "etcpal/cpp/rwlock.h"
@@ -35,10 +40,41 @@
 #include "etcpal/socket.h"
 #include "rdm/cpp/uid.h"
 #include "rdm/message.h"
+#include "rdmnet/core/ept_prot.h"
 #include "rdmnet/core/message.h"
 #include "rdmnet/core/rpt_prot.h"
+#include "rdmnet/cpp/broker.h"
 #include "rdmnet/defs.h"
 
+// Identifies the parameter value carried by an unsolicited RPT notification, so that a newer
+// notification can replace an older one that hasn't been sent yet.
+struct NotificationKey
+{
+  RdmUid   source_uid{};
+  uint16_t endpoint{0};
+  uint16_t subdevice{0};
+  uint8_t  command_class{0};
+  uint16_t param_id{0};
+};
+
+inline bool operator==(const NotificationKey& a, const NotificationKey& b)
+{
+  return RDM_UID_EQUAL(&a.source_uid, &b.source_uid) && a.endpoint == b.endpoint && a.subdevice == b.subdevice &&
+         a.command_class == b.command_class && a.param_id == b.param_id;
+}
+
+struct NotificationKeyHash
+{
+  size_t operator()(const NotificationKey& key) const noexcept
+  {
+    uint64_t value = (static_cast<uint64_t>(key.source_uid.manu) << 48) ^
+                     (static_cast<uint64_t>(key.source_uid.id) << 16) ^ (static_cast<uint64_t>(key.endpoint) << 32) ^
+                     (static_cast<uint64_t>(key.subdevice) << 8) ^ key.command_class ^
+                     (static_cast<uint64_t>(key.param_id) << 24);
+    return std::hash<uint64_t>()(value);
+  }
+};
+
 struct MessageRef
 {
   MessageRef() = default;
@@ -47,6 +83,11 @@ struct MessageRef
   std::unique_ptr<uint8_t[]> data;
   size_t                     size{0};
   size_t                     size_sent{0};
+
+  // Only set on notifications queued to a controller, for its overflow policy.
+  bool            notification{false};
+  bool            coalescible{false};
+  NotificationKey notification_key{};
 };
 
 // RPT RDM messages are two sets of data, the RPT header and the RDM message.
@@ -75,13 +116,14 @@ public:
   ClientDestroyAction() = default;
 
   static ClientDestroyAction DoNothing();
-  static ClientDestroyAction SendConnectReply(rdmnet_connect_status_t connect_status);
+  static ClientDestroyAction SendConnectReply(rdmnet_connect_status_t connect_status, uint32_t retry_after_ms = 0);
   static ClientDestroyAction SendDisconnect(rdmnet_disconnect_reason_t reason);
   static ClientDestroyAction MarkSocketInvalid();
 
   Action                     action() const noexcept { return action_; }
   rdmnet_disconnect_reason_t disconnect_reason() const noexcept { return data_.disconnect_reason_; }
   rdmnet_connect_status_t    connect_status() const noexcept { return data_.connect_status_; }
+  uint32_t                   retry_after_ms() const noexcept { return retry_after_ms_; }
 
 private:
   Action action_{Action::DoNothing};
@@ -90,6 +132,8 @@ private:
     rdmnet_disconnect_reason_t disconnect_reason_;
     rdmnet_connect_status_t    connect_status_;
   } data_{};
+  // For SendConnectReply, a suggested delay before the client reconnects. 0 for none.
+  uint32_t retry_after_ms_{0};
 };
 
 inline ClientDestroyAction ClientDestroyAction::DoNothing()
@@ -97,11 +141,13 @@ inline ClientDestroyAction ClientDestroyAction::DoNothing()
   return ClientDestroyAction{};
 }
 
-inline ClientDestroyAction ClientDestroyAction::SendConnectReply(rdmnet_connect_status_t connect_status)
+inline ClientDestroyAction ClientDestroyAction::SendConnectReply(rdmnet_connect_status_t connect_status,
+                                                                uint32_t                retry_after_ms)
 {
   ClientDestroyAction to_return;
   to_return.action_ = Action::SendConnectReply;
   to_return.data_.connect_status_ = connect_status;
+  to_return.retry_after_ms_ = retry_after_ms;
   return to_return;
 }
 
@@ -128,6 +174,26 @@ enum class ClientPushResult
   Error       // Other classes of error, e.g. could not allocate memory
 };
 
+// The number of bytes queued to all of a broker's clients, checked against the broker-wide queue
+// byte limit. Shared by every client of a broker; updated with each client's lock held, but
+// different clients update it concurrently.
+class QueueByteBudget
+{
+public:
+  explicit QueueByteBudget(size_t max_bytes = 0) : max_bytes_(max_bytes) {}
+
+  bool   HasRoom() const { return (max_bytes_ == 0) || (used_.load(std::memory_order_relaxed) < max_bytes_); }
+  void   Add(size_t bytes) { used_.fetch_add(bytes, std::memory_order_relaxed); }
+  void   Remove(size_t bytes) { used_.fetch_sub(bytes, std::memory_order_relaxed); }
+  size_t used() const { return used_.load(std::memory_order_relaxed); }
+
+private:
+  const size_t        max_bytes_;
+  std::atomic<size_t> used_{0};
+};
+
+class BrokerSocketManager;
+
 // A generic client.
 // Each component that connects to a broker is a client. The broker uses the common functionality
 // defined in this class to handle each client to which it is connected.
@@ -154,9 +220,12 @@ public:
       , handle_(other.handle_)
       , socket_(other.socket_)
       , max_q_size_(other.max_q_size_)
+      , max_q_bytes_(other.max_q_bytes_)
+      , q_budget_(other.q_budget_)
+      , socket_mgr_(other.socket_mgr_)
   {
   }
-  virtual ~BrokerClient() = default;
+  virtual ~BrokerClient() { ReleaseQueuedMessages(); }
 
   virtual bool             HasRoomToPush();
   virtual ClientPushResult Push(const etcpal::Uuid& sender_cid, const BrokerMessage& msg);
@@ -165,6 +234,10 @@ public:
                                               const rdm::Uid&            broker_uid,
                                               const ClientDestroyAction& destroy_action);
 
+  // Counts a message refused because this client's queue is full.
+  ClientPushResult RecordQueueFull();
+  virtual void     GetQueueStats(rdmnet::Broker::ClientQueueStats& stats) const;
+
   bool TcpConnExpired() const { return heartbeat_timer_.IsExpired(); }
   void MessageReceived() { heartbeat_timer_.Reset(); }
 
@@ -175,20 +248,44 @@ public:
   mutable etcpal::RwLock lock_;
   etcpal_socket_t        socket_{ETCPAL_SOCKET_INVALID};
   size_t                 max_q_size_{kLimitlessQueueSize};
+  size_t                 max_q_bytes_{kLimitlessQueueSize};
   bool                   marked_for_destruction_{false};
 
+  // The broker-wide queue byte limit, if any.
+  std::shared_ptr<QueueByteBudget> q_budget_;
+  // The socket manager to send through, if any; otherwise data is sent directly on the socket.
+  BrokerSocketManager* socket_mgr_{nullptr};
+
 protected:
   ClientPushResult PushPostSizeCheck(const etcpal::Uuid& sender_cid, const BrokerMessage& msg);
+  int              SendData(const uint8_t* data, size_t size);
   bool             SendNull(const etcpal::Uuid& broker_cid);
   void             ApplyDestroyAction(const etcpal::Uuid&        broker_cid,
                                       const rdm::Uid&            broker_uid,
                                       const ClientDestroyAction& destroy_action);
 
-  virtual void ClearAllQueues() { broker_msgs_.clear(); }
+  // Byte accounting for the queues. Every message added to or removed from a queue must be passed
+  // to MessageQueued() or MessageDequeued(); ReleaseQueuedMessages() follows clearing all queues.
+  bool HasRoomForBytes() const;
+  void MessageQueued(const MessageRef& msg);
+  void MessageDequeued(const MessageRef& msg);
+  void ReleaseQueuedMessages();
+
+  virtual void ClearAllQueues()
+  {
+    broker_msgs_.clear();
+    ReleaseQueuedMessages();
+  }
 
   std::deque<MessageRef> broker_msgs_;
   etcpal::Timer          send_timer_{std::chrono::seconds(E133_TCP_HEARTBEAT_INTERVAL_SEC)};
   etcpal::Timer          heartbeat_timer_{std::chrono::seconds(E133_HEARTBEAT_TIMEOUT_SEC)};
+
+  size_t   q_msgs_{0};
+  size_t   q_bytes_{0};
+  uint64_t queue_full_count_{0};
+  uint64_t notifications_dropped_{0};
+  uint64_t notifications_coalesced_{0};
 };
 
 class ClientReadGuard
@@ -230,6 +327,10 @@ public:
 
   virtual bool             HasRoomToPush() override;
   virtual ClientPushResult Push(const etcpal::Uuid& sender_cid, const BrokerMessage& msg) override;
+  virtual void             GetQueueStats(rdmnet::Broker::ClientQueueStats& stats) const override;
+
+  // Whether msg can be pushed, after anything the client would discard to make room for it.
+  virtual bool HasRoomForRptMessage(const RptMessage& /*msg*/) { return HasRoomToPush(); }
 
   RdmUid            uid_{};
   rpt_client_type_t client_type_{kRPTClientTypeUnknown};
@@ -242,8 +343,55 @@ protected:
   std::deque<MessageRef> status_msgs_;
 };
 
-struct EPTClient : public BrokerClient
+// An EPT sub-protocol supported by an EPT client. Owns a copy of the protocol string, since the
+// strings in a parsed client entry only live as long as the message.
+struct EptSubProtocol
 {
+  EptSubProtocol(const RdmnetEptSubProtocol& prot)
+      : manufacturer_id(prot.manufacturer_id)
+      , protocol_id(prot.protocol_id)
+      , protocol_string(prot.protocol_string ? prot.protocol_string : "")
+  {
+  }
+
+  uint16_t    manufacturer_id;
+  uint16_t    protocol_id;
+  std::string protocol_string;
+};
+
+// The key under which an EPT sub-protocol is indexed by the broker.
+inline uint32_t EptSubProtocolKey(uint16_t manufacturer_id, uint16_t protocol_id)
+{
+  return (static_cast<uint32_t>(manufacturer_id) << 16) | protocol_id;
+}
+
+class EPTClient : public BrokerClient
+{
+public:
+  EPTClient(size_t new_max_q_size, const RdmnetEptClientEntry& client_entry, const BrokerClient& prev_client)
+      : BrokerClient(prev_client)
+  {
+    client_protocol_ = kClientProtocolEPT;
+    cid_ = client_entry.cid;
+    max_q_size_ = new_max_q_size;
+    if (client_entry.protocols)
+      protocols_.assign(client_entry.protocols, client_entry.protocols + client_entry.num_protocols);
+  }
+  virtual ~EPTClient() {}
+
+  virtual bool             HasRoomToPush() override;
+  virtual ClientPushResult Push(const etcpal::Uuid& sender_cid, const BrokerMessage& msg) override;
+  virtual ClientPushResult Push(const etcpal::Uuid& sender_cid, const EptMessage& msg);
+  virtual bool             Send(const etcpal::Uuid& broker_cid) override;
+
+  void GetClientEntry(RdmnetEptClientEntry& entry, std::vector<RdmnetEptSubProtocol>& protocols) const;
+
+  std::vector<EptSubProtocol> protocols_;
+
+protected:
+  virtual void ClearAllQueues() override;
+
+  std::deque<MessageRef> ept_msgs_;
 };
 
 // State data about each controller
@@ -258,15 +406,32 @@ public:
   virtual ~RPTController() {}
 
   virtual bool             HasRoomToPush() override;
+  virtual bool             HasRoomForRptMessage(const RptMessage& msg) override;
   virtual ClientPushResult Push(Handle from_conn, const etcpal::Uuid& sender_cid, const RptMessage& msg) override;
   virtual ClientPushResult Push(const etcpal::Uuid& sender_cid, const BrokerMessage& msg) override;
   virtual ClientPushResult Push(const etcpal::Uuid& sender_cid, const RptHeader& header, const RptStatusMsg& msg);
   virtual bool             Send(const etcpal::Uuid& broker_cid) override;
 
+  rdmnet::Broker::OverflowPolicy overflow_policy_{rdmnet::Broker::OverflowPolicy::kDropNewest};
+  // Whether newer unsolicited notifications always replace queued ones, not just on overflow.
+  bool coalesce_notifications_{false};
+
 protected:
   virtual void ClearAllQueues();
 
+  ClientPushResult PushNotification(MessageRef&& to_push);
+  bool             DropOldestNotifications(bool apply);
+  bool             CoalescesNotifications() const;
+  MessageRef*      FindCoalescibleNotification(const NotificationKey& key);
+  void             ForgetCoalescibleNotification(const MessageRef& msg);
+  void             IndexCoalescibleNotifications();
+
   std::deque<MessageRef> rpt_msgs_;
+
+  // The unsent coalescible notifications in rpt_msgs_, by key. Elements of a deque stay put when
+  // messages are added or removed at the ends, but not when one is erased from the middle, so the
+  // index is rebuilt after notifications are dropped.
+  std::unordered_map<NotificationKey, MessageRef*, NotificationKeyHash> coalescible_notifications_;
 };
 
 // State data about each device
@@ -299,7 +464,8 @@ protected:
     size_t      size() const;
     void        clear();
 
-    void RemoveCurrentController();
+    // Returns the messages removed.
+    std::deque<MessageRef> RemoveCurrentController();
 
   private:
     size_t                                   total_msg_count_{0};
@@ -22,12 +22,14 @@
 #include "broker_core.h"
 
 #include <algorithm>
+#include <atomic>
 #include <cstring>
 #include <cstddef>
 #include <iterator>
 #include "etcpal/cpp/error.h"
 #include "etcpal/netint.h"
 #include "etcpal/pack.h"
+#include "etcpal/timer.h"
 #include "rdmnet/version.h"
 #include "rdmnet/core/common.h"
 #include "rdmnet/core/connection.h"
@@ -81,12 +83,14 @@ etcpal::Error BrokerCore::Startup(const rdmnet::Broker::Settings& settings,
 
     // Save members
     settings_ = settings;
+    queue_budget_ = std::make_shared<QueueByteBudget>(settings.limits.total_queue_bytes);
+    ReserveClientShards(settings.limits);
     notify_ = notify;
     log_ = logger;
     components_ = std::move(components);
     components_.SetNotify(this);
     components_.handle_generator.SetValueInUseFunc(
-        [&](BrokerClient::Handle handle) { return clients_.find(handle) != clients_.end(); });
+        [&](BrokerClient::Handle handle) { return FindClient(handle) != nullptr; });
 
     // Generate IDs if necessary
     my_uid_ = settings.uid;
@@ -188,10 +192,62 @@ bool BrokerCore::IsValidDeviceDestinationUID(const RdmUid& uid) const
   return components_.uids.UidToHandle(uid, tmp);
 }
 
+// Clients that haven't completed the connection handshake have no queue traffic of their own and
+// are left out.
+std::vector<rdmnet::Broker::ClientQueueStats> BrokerCore::GetClientQueueStats() const
+{
+  std::vector<rdmnet::Broker::ClientQueueStats> stats;
+  for (const auto& shard : client_shards_)
+  {
+    etcpal::ReadGuard shard_read(shard.lock);
+    for (const auto& client : shard.clients)
+    {
+      if (client.second->client_protocol_ == kClientProtocolUnknown)
+        continue;
+
+      ClientReadGuard client_read(*client.second);
+      stats.emplace_back();
+      client.second->GetQueueStats(stats.back());
+    }
+  }
+  return stats;
+}
+
 size_t BrokerCore::GetNumClients() const
 {
-  etcpal::ReadGuard client_read(client_lock_);
-  return clients_.size();
+  return num_clients_;
+}
+
+// Looks up a client by handle. The shard lock is only held for the lookup; the returned reference
+// keeps the client alive after it has been destroyed.
+std::shared_ptr<BrokerClient> BrokerCore::FindClient(BrokerClient::Handle handle) const
+{
+  const ClientShard& shard = ShardFor(handle);
+  etcpal::ReadGuard  shard_read(shard.lock);
+
+  auto client = shard.clients.find(handle);
+  return (client != shard.clients.end()) ? client->second : nullptr;
+}
+
+std::shared_ptr<RPTClient> BrokerCore::FindRptClient(const RdmUid& uid) const
+{
+  BrokerClient::Handle handle;
+  if (!components_.uids.UidToHandle(uid, handle))
+    return nullptr;
+
+  const ClientShard& shard = ShardFor(handle);
+  etcpal::ReadGuard  shard_read(shard.lock);
+
+  auto client = shard.rpt_clients.find(handle);
+  return (client != shard.rpt_clients.end()) ? client->second : nullptr;
+}
+
+std::shared_ptr<EPTClient> BrokerCore::FindEptClient(BrokerClient::Handle handle) const
+{
+  etcpal::ReadGuard ept_read(ept_lock_);
+
+  auto client = ept_clients_.find(handle);
+  return (client != ept_clients_.end()) ? client->second : nullptr;
 }
 
 // Convert a set of strings representing network interface names to a set of all IP addresses
@@ -336,9 +392,11 @@ etcpal::Expected<etcpal_socket_t> BrokerCore::StartListening(const etcpal::IpAdd
 
 etcpal::Error BrokerCore::StartBrokerServices()
 {
-  if (!RDMNET_ASSERT_VERIFY(components_.threads))
+  if (!RDMNET_ASSERT_VERIFY(components_.threads) || !RDMNET_ASSERT_VERIFY(components_.socket_mgr))
     return kEtcPalErrSys;
 
+  connect_admission_.SetRate(settings_.limits.connect_rate, settings_.limits.connect_burst, etcpal_getms());
+
   etcpal::Error res = components_.threads->AddClientServiceThread();
   if (!res)
     return res;
@@ -352,7 +410,8 @@ etcpal::Error BrokerCore::StartBrokerServices()
     auto listen_sock = StartListening(*addr_iter, settings_.listen_port);
     if (listen_sock)
     {
-      if (components_.threads->AddListenThread(*listen_sock))
+      // Prefer accepting from the socket manager's own threads, which can accept connections in batches.
+      if (components_.socket_mgr->AddListenSocket(*listen_sock) || components_.threads->AddListenThread(*listen_sock))
       {
         ++addr_iter;
       }
@@ -386,10 +445,10 @@ void BrokerCore::StopBrokerServices(rdmnet_disconnect_reason_t disconnect_reason
   components_.threads->StopThreads();
 
   // No new connections coming in, manually shut down the existing ones.
-  std::vector<BrokerClient::Handle> clients_for_socket_removal;
+  for (auto& shard : client_shards_)
   {
-    etcpal::WriteGuard clients_write(client_lock_);
-    for (auto& client_pair : clients_)
+    etcpal::ReadGuard shard_read(shard.lock);
+    for (auto& client_pair : shard.clients)
     {
       if (!RDMNET_ASSERT_VERIFY(client_pair.second))
         return;
@@ -398,13 +457,29 @@ void BrokerCore::StopBrokerServices(rdmnet_disconnect_reason_t disconnect_reason
       MarkLockedClientForDestruction(*client_pair.second, ClientDestroyAction::SendDisconnect(disconnect_reason));
       client_pair.second->Send(settings_.cid);
     }
-
-    DestroyMarkedClientsLocked(clients_for_socket_removal);
   }
 
+  std::vector<BrokerClient::Handle> clients_for_socket_removal;
+  DestroyMarkedClients(clients_for_socket_removal);
   RemoveClientSockets(clients_for_socket_removal);
 }
 
+// Size the client maps for the connection limit up front, so that connects don't rehash them.
+void BrokerCore::ReserveClientShards(const rdmnet::Broker::Limits& limits)
+{
+  if (limits.connections == 0)
+    return;
+
+  size_t max_connections = static_cast<size_t>(limits.connections) + limits.reject_connections;
+  size_t per_shard = (max_connections + kNumClientShards - 1) / kNumClientShards;
+  for (auto& shard : client_shards_)
+  {
+    etcpal::WriteGuard shard_write(shard.lock);
+    shard.clients.reserve(per_shard);
+    shard.rpt_clients.reserve(per_shard);
+  }
+}
+
 bool BrokerCore::HandleNewConnection(etcpal_socket_t new_sock, const etcpal::SockAddr& addr)
 {
   if (!RDMNET_ASSERT_VERIFY(components_.socket_mgr))
@@ -428,21 +503,27 @@ bool BrokerCore::HandleNewConnection(etcpal_socket_t new_sock, const etcpal::Soc
   BrokerClient::Handle new_handle = BrokerClient::kInvalidHandle;
   bool                 result = false;
 
-  {  // Client write lock scope
-    etcpal::WriteGuard client_write(client_lock_);
+  {  // Registry lock scope
+    etcpal::MutexGuard registry_guard(registry_lock_);
 
     new_handle = components_.handle_generator.GetClientHandle();
 
     if (settings_.limits.connections == 0 ||
-        (clients_.size() <= settings_.limits.connections + settings_.limits.reject_connections))
+        (num_clients_ <= settings_.limits.connections + settings_.limits.reject_connections))
     {
-      std::unique_ptr<BrokerClient> client(new BrokerClient(new_handle, new_sock));
+      auto client = MakePooledClient<BrokerClient>(client_pool_, new_handle, new_sock);
 
       // Before inserting the connection, make sure we can attach the socket.
       if (client)
       {
         client->addr_ = addr;
-        clients_.insert(std::make_pair(new_handle, std::move(client)));
+        client->q_budget_ = queue_budget_;
+        client->socket_mgr_ = components_.socket_mgr.get();
+
+        ClientShard&       shard = ShardFor(new_handle);
+        etcpal::WriteGuard shard_write(shard.lock);
+        shard.clients.insert(std::make_pair(new_handle, std::move(client)));
+        ++num_clients_;
         result = true;
       }
     }
@@ -450,7 +531,7 @@ bool BrokerCore::HandleNewConnection(etcpal_socket_t new_sock, const etcpal::Soc
 
   if (result)
   {
-    // Calling this outside of the client_lock_ to avoid deadlocking.
+    // Calling this outside of the client locks to avoid deadlocking.
     components_.socket_mgr->AddSocket(new_handle, new_sock);
     BROKER_LOG_DEBUG("New connection created with handle %d", new_handle);
   }
@@ -469,10 +550,11 @@ bool BrokerCore::ServiceClients()
 {
   bool result = false;
 
+  for (auto& shard : client_shards_)
   {
-    etcpal::ReadGuard clients_read(client_lock_);
+    etcpal::ReadGuard shard_read(shard.lock);
 
-    for (auto& client : clients_)
+    for (auto& client : shard.clients)
     {
       if (!RDMNET_ASSERT_VERIFY(client.second))
         return false;
@@ -485,6 +567,12 @@ bool BrokerCore::ServiceClients()
     }
   }
 
+  // Sends to all of the clients go out together, if the socket manager batches them.
+  if (RDMNET_ASSERT_VERIFY(components_.socket_mgr))
+    result |= components_.socket_mgr->FlushSends();
+
+  UnlinkMarkedClients();
+
   if (client_destroy_timer_.IsExpired())
   {
     std::vector<BrokerClient::Handle> clients_for_socket_removal;
@@ -635,17 +723,17 @@ std::vector<BrokerClient::Handle> BrokerCore::GetClientSnapshot(bool     include
 {
   std::vector<BrokerClient::Handle> client_handles;
 
-  etcpal::ReadGuard client_read(client_lock_);
+  // We'll just do a bulk reserve.  The actual vector may take up less.
+  client_handles.reserve(num_clients_);
 
-  if (!clients_.empty())
+  for (const auto& shard : client_shards_)
   {
-    // We'll just do a bulk reserve.  The actual vector may take up less.
-    client_handles.reserve(clients_.size());
+    etcpal::ReadGuard shard_read(shard.lock);
 
-    for (const auto& client : clients_)
+    for (const auto& client : shard.clients)
     {
-      // TODO EPT
-      if (client.second)
+      // Only RPT clients have a client type and UID to filter on.
+      if (client.second && (client.second->client_protocol_ == E133_CLIENT_PROTOCOL_RPT))
       {
         RPTClient* rpt = static_cast<RPTClient*>(client.second.get());
         if (!RDMNET_ASSERT_VERIFY(rpt))
@@ -665,18 +753,21 @@ std::vector<BrokerClient::Handle> BrokerCore::GetClientSnapshot(bool     include
   return client_handles;
 }
 
-// This function grabs a read lock on client_lock_.
+// This function grabs a read lock on the client's shard.
 // Optionally sends a RDMnet-level message to the client before destroying it.
-// Also removes the client's UID from the BrokerUidManager and sends a client removed message, if it's an RPT client.
+// Also removes the client's UID from the BrokerUidManager, if it's an RPT client.
 void BrokerCore::MarkClientForDestruction(BrokerClient::Handle client_handle, const ClientDestroyAction& destroy_action)
 {
   bool log_message = false;
 
-  {  // Client read lock and destroy lock scope
-    etcpal::ReadGuard clients_read(client_lock_);
+  {  // Shard read lock scope
+    // The shard lock is held while marking so that the client can't be replaced by a connect
+    // request in the meantime.
+    const ClientShard& shard = ShardFor(client_handle);
+    etcpal::ReadGuard  shard_read(shard.lock);
 
-    auto client = clients_.find(client_handle);
-    if ((client != clients_.end()) && client->second)
+    auto client = shard.clients.find(client_handle);
+    if ((client != shard.clients.end()) && client->second)
     {
       ClientWriteGuard client_write(*client->second);
       log_message = MarkLockedClientForDestruction(*client->second, destroy_action);
@@ -686,82 +777,217 @@ void BrokerCore::MarkClientForDestruction(BrokerClient::Handle client_handle, co
   if (log_message)
   {
     BROKER_LOG_DEBUG("Client %d marked for destruction", client_handle);
+    UnlinkMarkedClients();
   }
 }
 
 // This function marks a client for destruction when it is already write-locked.
 // Optionally sends a RDMnet-level message to the client before destroying it.
-// Also removes the client's UID from the BrokerUidManager and sends a client removed message, if it's an RPT client.
+// Also removes the client's UID from the BrokerUidManager, if it's an RPT client. The other clients are told that it
+// was removed when it is unlinked, since their locks can't be taken while this client's lock is held.
 bool BrokerCore::MarkLockedClientForDestruction(BrokerClient& client, const ClientDestroyAction& destroy_action)
 {
   client.MarkForDestruction(settings_.cid, my_uid_, destroy_action);
 
   if (client.client_protocol_ == E133_CLIENT_PROTOCOL_RPT)
+    components_.uids.RemoveUid(static_cast<RPTClient&>(client).uid_);
+
+  etcpal::MutexGuard destroy_guard(destroy_lock_);
+  clients_to_unlink_.insert(client.handle_);
+  return clients_to_destroy_.insert(client.handle_).second;
+}
+
+// Removes clients marked for destruction from everything the message routing path reads: the RPT
+// client index, the EPT routing maps and the broadcast snapshot, then tells the remaining clients
+// that they were removed. Their queues were already freed when they were marked. Each client
+// object itself is freed by its last owner, which may be a routing thread still holding an earlier
+// broadcast snapshot, or the shard until the client is destroyed.
+//
+// This function takes the registry lock, so it must be called outside of the shard and client
+// locks.
+void BrokerCore::UnlinkMarkedClients()
+{
+  std::unordered_set<BrokerClient::Handle> to_unlink;
   {
-    RPTClient* rptcli = static_cast<RPTClient*>(&client);
-    components_.uids.RemoveUid(rptcli->uid_);
+    etcpal::MutexGuard destroy_guard(destroy_lock_);
+    if (clients_to_unlink_.empty())
+      return;
+    to_unlink.swap(clients_to_unlink_);
+  }
 
-    std::vector<RdmnetRptClientEntry> rpt_entries;
-    rpt_entries.emplace_back();
-    RdmnetRptClientEntry& entry = rpt_entries.back();
-    entry.cid = rptcli->cid_.get();
-    entry.uid = rptcli->uid_;
-    entry.type = rptcli->client_type_;
-    entry.binding_cid = rptcli->binding_cid_.get();
+  etcpal::MutexGuard registry_guard(registry_lock_);
 
-    SendClientsRemoved(rpt_entries);
+  std::vector<RdmnetRptClientEntry>       rpt_entries;
+  std::vector<std::shared_ptr<EPTClient>> ept_clients;
+  for (auto handle : to_unlink)
+  {
+    std::shared_ptr<BrokerClient> client;
+    {
+      ClientShard&       shard = ShardFor(handle);
+      etcpal::WriteGuard shard_write(shard.lock);
+
+      auto client_entry = shard.clients.find(handle);
+      if (client_entry == shard.clients.end())
+        continue;
+
+      client = client_entry->second;
+      shard.rpt_clients.erase(handle);
+    }
+
+    if (!client)
+      continue;
+
+    if (client->client_protocol_ == E133_CLIENT_PROTOCOL_RPT)
+    {
+      const RPTClient& rptcli = static_cast<const RPTClient&>(*client);
+
+      rpt_entries.emplace_back();
+      RdmnetRptClientEntry& entry = rpt_entries.back();
+      entry.cid = rptcli.cid_.get();
+      entry.uid = rptcli.uid_;
+      entry.type = rptcli.client_type_;
+      entry.binding_cid = rptcli.binding_cid_.get();
+    }
+    else if (client->client_protocol_ == E133_CLIENT_PROTOCOL_EPT)
+    {
+      auto ept_client = std::static_pointer_cast<EPTClient>(client);
+      UnlinkEptClient(*ept_client);
+      ept_clients.push_back(std::move(ept_client));
+    }
   }
 
-  return clients_to_destroy_.insert(client.handle_).second;
+  RemoveBroadcastDestinations(to_unlink);
+
+  if (!rpt_entries.empty())
+    SendClientsRemoved(rpt_entries);
+  for (const auto& ept_client : ept_clients)
+    SendEptClientListChange(VECTOR_BROKER_CLIENT_REMOVE, *ept_client);
 }
 
-// These functions will take a write lock on client_lock_.
-// RemoveClientSockets should immediately be called afterwards (outside client_lock_ to avoid deadlocking).
-void BrokerCore::DestroyMarkedClients(std::vector<BrokerClient::Handle>& clients_for_socket_removal)
+void BrokerCore::UnlinkEptClient(const EPTClient& client)
 {
-  etcpal::WriteGuard clients_write(client_lock_);
-  DestroyMarkedClientsLocked(clients_for_socket_removal);
+  etcpal::WriteGuard ept_write(ept_lock_);
+
+  ept_clients_.erase(client.handle_);
+  auto cid_entry = ept_clients_by_cid_.find(client.cid_);
+  if ((cid_entry != ept_clients_by_cid_.end()) && (cid_entry->second == client.handle_))
+    ept_clients_by_cid_.erase(cid_entry);
+
+  for (const auto& prot : client.protocols_)
+  {
+    auto prot_clients = ept_subprotocols_.find(EptSubProtocolKey(prot.manufacturer_id, prot.protocol_id));
+    if (prot_clients != ept_subprotocols_.end())
+    {
+      prot_clients->second.erase(client.handle_);
+      if (prot_clients->second.empty())
+        ept_subprotocols_.erase(prot_clients);
+    }
+  }
 }
 
-void BrokerCore::DestroyMarkedClientsLocked(std::vector<BrokerClient::Handle>& clients_for_socket_removal)
+// This function takes the registry lock and a write lock on each affected shard.
+// RemoveClientSockets should immediately be called afterwards (outside the client locks to avoid deadlocking).
+void BrokerCore::DestroyMarkedClients(std::vector<BrokerClient::Handle>& clients_for_socket_removal)
 {
-  if (!clients_to_destroy_.empty())
+  // Normally already done, unless the clients were marked since the last pass of ServiceClients().
+  UnlinkMarkedClients();
+
+  std::unordered_set<BrokerClient::Handle> to_destroy;
+  {
+    etcpal::MutexGuard destroy_guard(destroy_lock_);
+    to_destroy.swap(clients_to_destroy_);
+  }
+  if (to_destroy.empty())
+    return;
+
+  etcpal::MutexGuard registry_guard(registry_lock_);
+
+  for (auto handle : to_destroy)
   {
-    for (auto to_destroy : clients_to_destroy_)
+    std::shared_ptr<BrokerClient> client;
     {
-      auto client = clients_.find(to_destroy);
-      if (client != clients_.end())
-      {
-        if (!RDMNET_ASSERT_VERIFY(client->second))
-          return;
+      ClientShard&       shard = ShardFor(handle);
+      etcpal::WriteGuard shard_write(shard.lock);
 
-        auto client_ip = client->second->addr_;
+      auto client_entry = shard.clients.find(handle);
+      if (client_entry == shard.clients.end())
+        continue;
 
-        if (client->second->socket_ != ETCPAL_SOCKET_INVALID)
-          clients_for_socket_removal.push_back(client->second->handle_);
+      client = std::move(client_entry->second);
+      shard.clients.erase(client_entry);
+      --num_clients_;
+    }
 
-        if (client->second->client_protocol_ == E133_CLIENT_PROTOCOL_RPT)
-        {
-          RPTClient* rptcli = static_cast<RPTClient*>(client->second.get());
-          rpt_clients_.erase(to_destroy);
-          if (rptcli->client_type_ == kRPTClientTypeController)
-            controllers_.erase(to_destroy);
-          else if (rptcli->client_type_ == kRPTClientTypeDevice)
-            devices_.erase(to_destroy);
-        }
-        clients_.erase(client);
+    if (!RDMNET_ASSERT_VERIFY(client))
+      return;
 
-        BROKER_LOG_INFO("Removing client %d at IP %s marked for destruction.", to_destroy,
-                        client_ip.ToString().c_str());
-        BROKER_LOG_DEBUG("Clients: %zu Controllers: %zu Devices: %zu", clients_.size(), controllers_.size(),
-                         devices_.size());
-      }
+    if (client->socket_ != ETCPAL_SOCKET_INVALID)
+      clients_for_socket_removal.push_back(client->handle_);
+
+    BROKER_LOG_INFO("Removing client %d at IP %s marked for destruction.", handle, client->addr_.ToString().c_str());
+  }
+
+  if (BROKER_CAN_LOG(ETCPAL_LOG_DEBUG))
+  {
+    size_t num_ept_clients = 0;
+    {
+      etcpal::ReadGuard ept_read(ept_lock_);
+      num_ept_clients = ept_clients_.size();
     }
-    clients_to_destroy_.clear();
+    auto broadcast_sets = std::atomic_load(&broadcast_sets_);
+    BROKER_LOG_DEBUG("Clients: %zu Controllers: %zu Devices: %zu EPT Clients: %zu", num_clients_.load(),
+                     broadcast_sets->controllers.size(), broadcast_sets->devices.size(), num_ept_clients);
   }
 }
 
-// This must be called outside of client_lock_.
+// The broadcast sets are copied and republished only when controller or device membership
+// changes, which is rare relative to broadcasts. These must be called with registry_lock_ held,
+// which serializes all writers.
+void BrokerCore::AddBroadcastDestination(const std::shared_ptr<RPTController>& controller)
+{
+  auto new_sets = std::make_shared<RptBroadcastSets>(*std::atomic_load(&broadcast_sets_));
+  new_sets->controllers.push_back(controller);
+  std::atomic_store(&broadcast_sets_, std::shared_ptr<const RptBroadcastSets>(std::move(new_sets)));
+}
+
+void BrokerCore::AddBroadcastDestination(const std::shared_ptr<RPTDevice>& device)
+{
+  auto new_sets = std::make_shared<RptBroadcastSets>(*std::atomic_load(&broadcast_sets_));
+  new_sets->devices.push_back(device);
+  new_sets->devices_by_manu[static_cast<uint16_t>(device->uid_.manu & 0x7fffu)].push_back(device);
+  std::atomic_store(&broadcast_sets_, std::shared_ptr<const RptBroadcastSets>(std::move(new_sets)));
+}
+
+void BrokerCore::RemoveBroadcastDestinations(const std::unordered_set<BrokerClient::Handle>& handles)
+{
+  auto is_removed = [&](const auto& client) { return handles.count(client->handle_) != 0; };
+
+  auto old_sets = std::atomic_load(&broadcast_sets_);
+  if (std::none_of(old_sets->controllers.begin(), old_sets->controllers.end(), is_removed) &&
+      std::none_of(old_sets->devices.begin(), old_sets->devices.end(), is_removed))
+  {
+    return;
+  }
+
+  auto new_sets = std::make_shared<RptBroadcastSets>(*old_sets);
+
+  auto& controllers = new_sets->controllers;
+  controllers.erase(std::remove_if(controllers.begin(), controllers.end(), is_removed), controllers.end());
+  auto& devices = new_sets->devices;
+  devices.erase(std::remove_if(devices.begin(), devices.end(), is_removed), devices.end());
+  for (auto manu_devices = new_sets->devices_by_manu.begin(); manu_devices != new_sets->devices_by_manu.end();)
+  {
+    auto& list = manu_devices->second;
+    list.erase(std::remove_if(list.begin(), list.end(), is_removed), list.end());
+    if (list.empty())
+      manu_devices = new_sets->devices_by_manu.erase(manu_devices);
+    else
+      ++manu_devices;
+  }
+  std::atomic_store(&broadcast_sets_, std::shared_ptr<const RptBroadcastSets>(std::move(new_sets)));
+}
+
+// This must be called outside of the client locks.
 void BrokerCore::RemoveClientSockets(const std::vector<BrokerClient::Handle>& clients)
 {
   if (!RDMNET_ASSERT_VERIFY(components_.socket_mgr))
@@ -795,7 +1021,7 @@ HandleMessageResult BrokerCore::HandleSocketMessageReceived(BrokerClient::Handle
       switch (bmsg->vector)
       {
         case VECTOR_BROKER_CONNECT:
-          ProcessConnectRequest(client_handle, BROKER_GET_CLIENT_CONNECT_MSG(bmsg));
+          result = AdmitConnectRequest(client_handle, message);
           break;
         case VECTOR_BROKER_FETCH_CLIENT_LIST:
           SendClientList(client_handle);
@@ -825,6 +1051,10 @@ HandleMessageResult BrokerCore::HandleSocketMessageReceived(BrokerClient::Handle
       result = ProcessRPTMessage(client_handle, &message);
       break;
 
+    case ACN_VECTOR_ROOT_EPT:
+      result = ProcessEPTMessage(client_handle, &message);
+      break;
+
     default:
       BROKER_LOG_DEBUG("Received Root Layer PDU with unknown or unhandled vector %d", message.vector);
       break;
@@ -833,6 +1063,29 @@ HandleMessageResult BrokerCore::HandleSocketMessageReceived(BrokerClient::Handle
   return result;
 }
 
+// Pace connect handshakes to Limits::connect_rate. A connect that will be admitted shortly is held
+// by the socket manager and retried; a client that would wait longer is turned away with a hint of
+// when to reconnect.
+HandleMessageResult BrokerCore::AdmitConnectRequest(BrokerClient::Handle client_handle, const RdmnetMessage& message)
+{
+  auto admission = connect_admission_.Admit(message.sender_cid, etcpal_getms());
+  switch (admission.decision)
+  {
+    case ConnectAdmission::Decision::kAdmit:
+      ProcessConnectRequest(client_handle, BROKER_GET_CLIENT_CONNECT_MSG(RDMNET_GET_BROKER_MSG(&message)));
+      break;
+    case ConnectAdmission::Decision::kHold:
+      return HandleMessageResult::kRetryLater;
+    case ConnectAdmission::Decision::kRetryAfter:
+      BROKER_LOG_DEBUG("Broker busy; asking client %d to reconnect in %u ms.", client_handle,
+                       admission.retry_after_ms);
+      MarkClientForDestruction(client_handle, ClientDestroyAction::SendConnectReply(kRdmnetConnectCapacityExceeded,
+                                                                                    admission.retry_after_ms));
+      break;
+  }
+  return HandleMessageResult::kGetNextMessage;
+}
+
 void BrokerCore::ProcessConnectRequest(BrokerClient::Handle client_handle, const BrokerClientConnectMsg* cmsg)
 {
   if (!RDMNET_ASSERT_VERIFY(cmsg))
@@ -853,7 +1106,14 @@ void BrokerCore::ProcessConnectRequest(BrokerClient::Handle client_handle, const
         deny_connection = !ProcessRPTConnectRequest(client_handle, *rpt_client_entry, connect_status);
       }
       break;
-      // TODO EPT
+      case E133_CLIENT_PROTOCOL_EPT: {
+        auto ept_client_entry = GET_EPT_CLIENT_ENTRY(&cmsg->client_entry);
+        if (!RDMNET_ASSERT_VERIFY(ept_client_entry))
+          return;
+
+        deny_connection = !ProcessEPTConnectRequest(client_handle, *ept_client_entry, connect_status);
+      }
+      break;
       default:
         connect_status = kRdmnetConnectInvalidClientEntry;
         break;
@@ -877,10 +1137,14 @@ bool BrokerCore::ProcessRPTConnectRequest(BrokerClient::Handle        client_han
   // We need to make a copy of the data because we might be changing the UID value
   RdmnetRptClientEntry updated_client_entry = client_entry;
 
-  etcpal::WriteGuard clients_write(client_lock_);
-  RPTClient*         new_client = nullptr;
+  etcpal::MutexGuard         registry_guard(registry_lock_);
+  std::shared_ptr<RPTClient> new_client;
 
-  if ((settings_.limits.connections > 0) && (clients_.size() >= settings_.limits.connections))
+  auto pending_client = FindClient(client_handle);
+  if (!RDMNET_ASSERT_VERIFY(pending_client))
+    return false;
+
+  if ((settings_.limits.connections > 0) && (num_clients_ >= settings_.limits.connections))
   {
     connect_status = kRdmnetConnectCapacityExceeded;
     continue_adding = false;
@@ -894,7 +1158,8 @@ bool BrokerCore::ProcessRPTConnectRequest(BrokerClient::Handle        client_han
     // we've hit our maximum number of controllers
     if (updated_client_entry.type == kRPTClientTypeController)
     {
-      if ((settings_.limits.controllers > 0) && (controllers_.size() >= settings_.limits.controllers))
+      if ((settings_.limits.controllers > 0) &&
+          (std::atomic_load(&broadcast_sets_)->controllers.size() >= settings_.limits.controllers))
       {
         connect_status = kRdmnetConnectCapacityExceeded;
         continue_adding = false;
@@ -902,25 +1167,24 @@ bool BrokerCore::ProcessRPTConnectRequest(BrokerClient::Handle        client_han
       }
       else
       {
-        if (!RDMNET_ASSERT_VERIFY(clients_[client_handle]))
+        auto controller = MakePooledClient<RPTController>(client_pool_, settings_.limits.controller_messages,
+                                                          updated_client_entry, *pending_client);
+        controller->max_q_bytes_ = settings_.limits.controller_queue_bytes;
+        controller->overflow_policy_ = settings_.limits.overflow_policy;
+        controller->coalesce_notifications_ = settings_.coalesce_notifications;
+        if (!PromotePendingClient(pending_client, controller))
           return false;
 
-        std::unique_ptr<RPTController> controller(
-            new RPTController(settings_.limits.controller_messages, updated_client_entry, *clients_[client_handle]));
-        if (controller)
-        {
-          new_client = controller.get();
-          controllers_.insert(std::make_pair(client_handle, controller.get()));
-          rpt_clients_.insert(std::make_pair(client_handle, controller.get()));
-          clients_[client_handle] = std::move(controller);
-        }
+        new_client = controller;
+        AddBroadcastDestination(controller);
       }
     }
     // If it's a device, add it to the device states -- unless we've hit our maximum number of
     // devices
     else if (updated_client_entry.type == kRPTClientTypeDevice)
     {
-      if ((settings_.limits.devices > 0) && (devices_.size() >= settings_.limits.devices))
+      if ((settings_.limits.devices > 0) &&
+          (std::atomic_load(&broadcast_sets_)->devices.size() >= settings_.limits.devices))
       {
         connect_status = kRdmnetConnectCapacityExceeded;
         continue_adding = false;
@@ -928,18 +1192,14 @@ bool BrokerCore::ProcessRPTConnectRequest(BrokerClient::Handle        client_han
       }
       else
       {
-        if (!RDMNET_ASSERT_VERIFY(clients_[client_handle]))
+        auto device = MakePooledClient<RPTDevice>(client_pool_, settings_.limits.device_messages,
+                                                  updated_client_entry, *pending_client);
+        device->max_q_bytes_ = settings_.limits.device_queue_bytes;
+        if (!PromotePendingClient(pending_client, device))
           return false;
 
-        std::unique_ptr<RPTDevice> device(
-            new RPTDevice(settings_.limits.device_messages, updated_client_entry, *clients_[client_handle]));
-        if (device)
-        {
-          new_client = device.get();
-          devices_.insert(std::make_pair(client_handle, device.get()));
-          rpt_clients_.insert(std::make_pair(client_handle, device.get()));
-          clients_[client_handle] = std::move(device);
-        }
+        new_client = device;
+        AddBroadcastDestination(device);
       }
     }
   }
@@ -958,7 +1218,10 @@ bool BrokerCore::ProcessRPTConnectRequest(BrokerClient::Handle        client_han
     creply->e133_version = E133_VERSION;
     creply->broker_uid = my_uid_.get();
     creply->client_uid = updated_client_entry.uid;
-    new_client->Push(settings_.cid, msg);
+    {
+      ClientWriteGuard client_write(*new_client);
+      new_client->Push(settings_.cid, msg);
+    }
 
     if (BROKER_CAN_LOG(ETCPAL_LOG_INFO))
     {
@@ -975,6 +1238,98 @@ bool BrokerCore::ProcessRPTConnectRequest(BrokerClient::Handle        client_han
   return continue_adding;
 }
 
+bool BrokerCore::ProcessEPTConnectRequest(BrokerClient::Handle        client_handle,
+                                          const RdmnetEptClientEntry& client_entry,
+                                          rdmnet_connect_status_t&    connect_status)
+{
+  etcpal::MutexGuard registry_guard(registry_lock_);
+
+  size_t num_ept_clients = 0;
+  {
+    etcpal::ReadGuard ept_read(ept_lock_);
+    num_ept_clients = ept_clients_.size();
+  }
+
+  if ((settings_.limits.connections > 0) && (num_clients_ >= settings_.limits.connections))
+  {
+    connect_status = kRdmnetConnectCapacityExceeded;
+    return false;
+  }
+  if ((settings_.limits.ept_clients > 0) && (num_ept_clients >= settings_.limits.ept_clients))
+  {
+    connect_status = kRdmnetConnectCapacityExceeded;
+    return false;
+  }
+  if (client_entry.num_protocols == 0 || !client_entry.protocols)
+  {
+    connect_status = kRdmnetConnectInvalidClientEntry;
+    return false;
+  }
+
+  auto pending_client = FindClient(client_handle);
+  if (!RDMNET_ASSERT_VERIFY(pending_client))
+    return false;
+
+  auto new_client =
+      MakePooledClient<EPTClient>(client_pool_, settings_.limits.ept_client_messages, client_entry, *pending_client);
+  new_client->max_q_bytes_ = settings_.limits.ept_client_queue_bytes;
+  if (!PromotePendingClient(pending_client, new_client))
+    return false;
+
+  {
+    etcpal::WriteGuard ept_write(ept_lock_);
+    ept_clients_.insert(std::make_pair(client_handle, new_client));
+    // If a stale connection from the same CID is still around, the new connection takes over routing.
+    ept_clients_by_cid_[new_client->cid_] = client_handle;
+    for (const auto& prot : new_client->protocols_)
+      ept_subprotocols_[EptSubProtocolKey(prot.manufacturer_id, prot.protocol_id)].insert(client_handle);
+  }
+
+  // Send the connect reply
+  BrokerMessage msg;
+  msg.vector = VECTOR_BROKER_CONNECT_REPLY;
+
+  BrokerConnectReplyMsg* creply = BROKER_GET_CONNECT_REPLY_MSG(&msg);
+  if (!RDMNET_ASSERT_VERIFY(creply))
+    return false;
+
+  creply->connect_status = kRdmnetConnectOk;
+  creply->e133_version = E133_VERSION;
+  creply->broker_uid = my_uid_.get();
+  creply->client_uid = RdmUid{};
+  {
+    ClientWriteGuard client_write(*new_client);
+    new_client->Push(settings_.cid, msg);
+  }
+
+  BROKER_LOG_INFO("Successfully processed EPT Connect request from %s at IP %s (connection %d) with %zu sub-protocols",
+                  new_client->cid_.ToString().c_str(), new_client->addr_.ToString().c_str(), client_handle,
+                  new_client->protocols_.size());
+
+  // Update the other EPT clients
+  SendEptClientListChange(VECTOR_BROKER_CLIENT_ADD, *new_client);
+  return true;
+}
+
+// Put a client in place of the pending client it was built from, once its connect request has been
+// accepted. The new client is built before this is called, so the shard lock is held only to swap
+// the map entries. The caller's reference keeps the pending client from being destroyed under it.
+bool BrokerCore::PromotePendingClient(const std::shared_ptr<BrokerClient>& pending_client,
+                                      const std::shared_ptr<BrokerClient>& new_client)
+{
+  ClientShard&       shard = ShardFor(new_client->handle_);
+  etcpal::WriteGuard shard_write(shard.lock);
+
+  auto prev_client = shard.clients.find(new_client->handle_);
+  if (!RDMNET_ASSERT_VERIFY(prev_client != shard.clients.end() && prev_client->second == pending_client))
+    return false;
+
+  prev_client->second = new_client;
+  if (new_client->client_protocol_ == kClientProtocolRPT)
+    shard.rpt_clients[new_client->handle_] = std::static_pointer_cast<RPTClient>(new_client);
+  return true;
+}
+
 bool BrokerCore::ResolveNewClientUid(BrokerClient::Handle     client_handle,
                                      RdmnetRptClientEntry&    client_entry,
                                      rdmnet_connect_status_t& connect_status)
@@ -1022,8 +1377,6 @@ bool BrokerCore::ResolveNewClientUid(BrokerClient::Handle     client_handle,
 
 HandleMessageResult BrokerCore::ProcessRPTMessage(BrokerClient::Handle client_handle, const RdmnetMessage* msg)
 {
-  etcpal::ReadGuard clients_read(client_lock_);
-
   HandleMessageResult result = HandleMessageResult::kGetNextMessage;
   if (!RDMNET_ASSERT_VERIFY(msg))
     return result;
@@ -1033,17 +1386,19 @@ HandleMessageResult BrokerCore::ProcessRPTMessage(BrokerClient::Handle client_ha
     return result;
 
   bool route_msg = false;
-  auto client = clients_.find(client_handle);
+  // The shard lock isn't held while processing. The client can only be replaced by its own connect
+  // request, which is handled on this same socket's thread.
+  auto client = FindClient(client_handle);
 
-  if ((client != clients_.end()) && client->second)
+  if (client)
   {
-    ClientWriteGuard client_write(*client->second);
+    ClientWriteGuard client_write(*client);
 
-    client->second->MessageReceived();
+    client->MessageReceived();
 
-    if (client->second->client_protocol_ == E133_CLIENT_PROTOCOL_RPT)
+    if (client->client_protocol_ == E133_CLIENT_PROTOCOL_RPT)
     {
-      RPTClient* rptcli = static_cast<RPTClient*>(client->second.get());
+      RPTClient* rptcli = static_cast<RPTClient*>(client.get());
 
       switch (rptmsg->vector)
       {
@@ -1144,7 +1499,6 @@ HandleMessageResult BrokerCore::ProcessRPTMessage(BrokerClient::Handle client_ha
   return result;
 }
 
-// Needs read lock on client_lock_
 HandleMessageResult BrokerCore::RouteRPTMessage(BrokerClient::Handle client_handle, const RdmnetMessage* msg)
 {
   if (!RDMNET_ASSERT_VERIFY(msg))
@@ -1195,115 +1549,118 @@ HandleMessageResult BrokerCore::RouteRPTMessage(BrokerClient::Handle client_hand
   return HandleRPTClientBadPushResult(rptmsg->header, push_result);
 }
 
-template <class ClientMap, class FilterFunction>
-ClientPushResult PushToRptClients(BrokerClient::Handle sender_handle,
-                                  const RdmnetMessage* msg,
-                                  ClientMap&           dest_clients,
-                                  FilterFunction       dest_filter)
+HandleMessageResult BrokerCore::ProcessEPTMessage(BrokerClient::Handle client_handle, const RdmnetMessage* msg)
 {
+  HandleMessageResult result = HandleMessageResult::kGetNextMessage;
   if (!RDMNET_ASSERT_VERIFY(msg))
-    return ClientPushResult::Error;
+    return result;
 
-  ClientPushResult result = ClientPushResult::Ok;
+  const EptMessage* eptmsg = RDMNET_GET_EPT_MSG(msg);
+  if (!RDMNET_ASSERT_VERIFY(eptmsg))
+    return result;
 
-  const RptMessage* rptmsg = RDMNET_GET_RPT_MSG(msg);
-  if (!RDMNET_ASSERT_VERIFY(rptmsg))
-    return ClientPushResult::Error;
+  auto sender = FindEptClient(client_handle);
+  if (!sender)
+  {
+    BROKER_LOG_DEBUG("Received EPT PDU from Client %d, which is not an EPT Client", client_handle);
+    return result;
+  }
 
-  // Lock all destination clients
-  int num_successful_locks = 0;
-  for (auto dest = dest_clients.begin(); dest != dest_clients.end(); ++dest)
+  if ((eptmsg->vector != VECTOR_EPT_DATA) && (eptmsg->vector != VECTOR_EPT_STATUS))
   {
-    if (dest_filter(dest))
-    {
-      if (!RDMNET_ASSERT_VERIFY(dest->second))
-        return ClientPushResult::Error;
+    BROKER_LOG_WARNING("Received EPT PDU with unknown vector %u from Client %d", eptmsg->vector, client_handle);
+    return result;
+  }
 
-      if (dest->second->lock_.WriteLock())
-      {
-        ++num_successful_locks;
-      }
-      else
-      {
-        result = ClientPushResult::Error;
-        break;
-      }
-    }
+  const RdmnetEptData* data_msg = nullptr;
+  if (EPT_IS_DATA_MSG(eptmsg))
+  {
+    data_msg = EPT_GET_DATA_MSG(eptmsg);
+    if (!RDMNET_ASSERT_VERIFY(data_msg))
+      return result;
   }
 
-  // If all locks succeeded, check if any destination client queues are full
-  if (result == ClientPushResult::Ok)
+  // Resolve the destination with ept_lock_ held, but release it before locking any client.
+  etcpal::Uuid               dest_cid(eptmsg->dest_cid);
+  std::shared_ptr<EPTClient> dest;
+  bool                       dest_supports_protocol = true;
   {
-    for (auto dest = dest_clients.begin(); dest != dest_clients.end(); ++dest)
+    etcpal::ReadGuard ept_read(ept_lock_);
+
+    auto dest_handle = ept_clients_by_cid_.find(dest_cid);
+    if (dest_handle != ept_clients_by_cid_.end())
     {
-      if (!RDMNET_ASSERT_VERIFY(dest->second))
-        return ClientPushResult::Error;
+      auto dest_entry = ept_clients_.find(dest_handle->second);
+      if (dest_entry != ept_clients_.end())
+        dest = dest_entry->second;
+    }
 
-      if (dest_filter(dest) && !dest->second->HasRoomToPush())
-        result = ClientPushResult::QueueFull;
+    if (dest && data_msg)
+    {
+      auto prot_clients = ept_subprotocols_.find(EptSubProtocolKey(data_msg->manufacturer_id, data_msg->protocol_id));
+      dest_supports_protocol =
+          (prot_clients != ept_subprotocols_.end()) && (prot_clients->second.count(dest->handle_) != 0);
     }
   }
 
-  // If no queues are full, push to all queues
-  if (result == ClientPushResult::Ok)
+  if (!dest)
   {
-    for (auto dest = dest_clients.begin(); dest != dest_clients.end(); ++dest)
-    {
-      if (dest_filter(dest))
-      {
-        if (!RDMNET_ASSERT_VERIFY(dest->second))
-          return ClientPushResult::Error;
-
-        auto push_res = dest->second->Push(sender_handle, msg->sender_cid, *rptmsg);
-
-        if (result == ClientPushResult::Ok)
-          result = push_res;
-      }
-    }
+    BROKER_LOG_DEBUG("Received EPT PDU addressed to unknown CID %s from Client %d", dest_cid.ToString().c_str(),
+                     client_handle);
+    // Status messages are never answered with another status message, to avoid status loops.
+    if (data_msg)
+      result = SendEptStatus(*sender, dest_cid, kEptStatusUnknownCid);
+    return result;
   }
 
-  // Unlock all destination clients that locked successfully
-  for (auto dest = dest_clients.begin(); dest != dest_clients.end(); ++dest)
+  if (!dest_supports_protocol)
   {
-    if (num_successful_locks == 0)
-      break;
+    BROKER_LOG_DEBUG("EPT Client %d sent data for sub-protocol %04x:%04x not supported by destination %s",
+                     client_handle, data_msg->manufacturer_id, data_msg->protocol_id, dest_cid.ToString().c_str());
+    return SendEptStatus(*sender, dest_cid, kEptStatusUnknownVector);
+  }
 
-    if (dest_filter(dest))
-    {
-      if (!RDMNET_ASSERT_VERIFY(dest->second))
-        return ClientPushResult::Error;
+  ClientPushResult push_res;
+  {
+    ClientWriteGuard dest_write(*dest);
+    push_res = dest->Push(msg->sender_cid, *eptmsg);
+  }
 
-      dest->second->lock_.WriteUnlock();
-      --num_successful_locks;
-    }
+  if (push_res == ClientPushResult::QueueFull)
+  {
+    // This path is hit repeatedly while a bulk transfer is throttled, so avoid formatting the CID unless needed.
+    if (BROKER_CAN_LOG(ETCPAL_LOG_DEBUG))
+      BROKER_LOG_DEBUG("Couldn't send EPT message to %s: queue is full. Retrying later.", dest_cid.ToString().c_str());
+    result = HandleMessageResult::kRetryLater;
+  }
+  else if (push_res == ClientPushResult::Error)
+  {
+    BROKER_LOG_ERR("Error sending EPT message from Client %d to %s.", client_handle, dest_cid.ToString().c_str());
   }
 
   return result;
 }
 
-// Needs read lock on client_lock_
 ClientPushResult BrokerCore::PushToAllControllers(BrokerClient::Handle sender_handle, const RdmnetMessage* msg)
 {
   if (!RDMNET_ASSERT_VERIFY(msg))
     return ClientPushResult::Error;
 
-  // Push to every controller in controllers_
-  auto dest_filter = [](const RptControllerMap::iterator& /*dest*/) { return true; };
-  return PushToRptClients(sender_handle, msg, controllers_, dest_filter);
+  // Push to every controller in the current snapshot
+  auto broadcast_sets = std::atomic_load(&broadcast_sets_);
+  return PushToRptClients(sender_handle, msg, broadcast_sets->controllers);
 }
 
-// Needs read lock on client_lock_
 ClientPushResult BrokerCore::PushToAllDevices(BrokerClient::Handle sender_handle, const RdmnetMessage* msg)
 {
   if (!RDMNET_ASSERT_VERIFY(msg))
     return ClientPushResult::Error;
 
-  // Push to every device in devices_
-  auto dest_filter = [](const RptDeviceMap::iterator& /*dest*/) { return true; };
-  return PushToRptClients(sender_handle, msg, devices_, dest_filter);
+  // Push to every device in the current snapshot
+  auto broadcast_sets = std::atomic_load(&broadcast_sets_);
+  return PushToRptClients(sender_handle, msg, broadcast_sets->devices);
 }
 
-// Needs read lock on client_lock_
 ClientPushResult BrokerCore::PushToManuSpecificDevices(BrokerClient::Handle sender_handle,
                                                        const RdmnetMessage* msg,
                                                        uint16_t             manu)
@@ -1311,17 +1668,15 @@ ClientPushResult BrokerCore::PushToManuSpecificDevices(BrokerClient::Handle send
   if (!RDMNET_ASSERT_VERIFY(msg))
     return ClientPushResult::Error;
 
-  // Push to each device in devices_ that matches manu
-  auto dest_filter = [&](const RptDeviceMap::iterator& dest) {
-    if (!RDMNET_ASSERT_VERIFY(dest->second))
-      return false;
+  // Push to each device in the current snapshot that matches manu
+  auto broadcast_sets = std::atomic_load(&broadcast_sets_);
+  auto manu_devices = broadcast_sets->devices_by_manu.find(manu);
+  if (manu_devices == broadcast_sets->devices_by_manu.end())
+    return ClientPushResult::Ok;
 
-    return ((dest->second->uid_.manu & 0x7fffu) == manu);
-  };
-  return PushToRptClients(sender_handle, msg, devices_, dest_filter);
+  return PushToRptClients(sender_handle, msg, manu_devices->second);
 }
 
-// Needs read lock on client_lock_
 ClientPushResult BrokerCore::PushToSpecificRptClient(BrokerClient::Handle sender_handle, const RdmnetMessage* msg)
 {
   if (!RDMNET_ASSERT_VERIFY(msg))
@@ -1332,30 +1687,16 @@ ClientPushResult BrokerCore::PushToSpecificRptClient(BrokerClient::Handle sender
     return ClientPushResult::Error;
 
   auto dest_client = FindRptClient(rptmsg->header.dest_uid);
-  if (dest_client != rpt_clients_.end())
+  if (dest_client)
   {
-    if (!RDMNET_ASSERT_VERIFY(dest_client->second))
-      return ClientPushResult::Error;
-
     // For performance, since this is a single client, lock and call Push directly instead of calling PushToRptClients.
-    ClientWriteGuard client_write(*dest_client->second);
-    return dest_client->second->Push(sender_handle, msg->sender_cid, *rptmsg);
+    ClientWriteGuard client_write(*dest_client);
+    return dest_client->Push(sender_handle, msg->sender_cid, *rptmsg);
   }
 
   return ClientPushResult::Error;
 }
 
-// Needs read lock on client_lock_
-BrokerCore::RptClientMap::iterator BrokerCore::FindRptClient(const RdmUid& uid)
-{
-  BrokerClient::Handle handle;
-  if (components_.uids.UidToHandle(uid, handle))
-    return rpt_clients_.find(handle);
-
-  return rpt_clients_.end();
-}
-
-// Needs read lock on client_lock_
 HandleMessageResult BrokerCore::HandleRPTClientBadPushResult(const RptHeader& header, ClientPushResult result)
 {
   std::string dest_type("Unknown");
@@ -1376,18 +1717,15 @@ HandleMessageResult BrokerCore::HandleRPTClientBadPushResult(const RptHeader& he
   else
   {
     auto dest_client = FindRptClient(header.dest_uid);
-    if (dest_client == rpt_clients_.end())
+    if (!dest_client)
     {
       not_found = true;
     }
     else
     {
-      if (!RDMNET_ASSERT_VERIFY(dest_client->second))
-        return HandleMessageResult::kGetNextMessage;
-
-      if (dest_client->second->client_type_ == kRPTClientTypeDevice)
+      if (dest_client->client_type_ == kRPTClientTypeDevice)
         dest_type = "Device";
-      else if (dest_client->second->client_type_ == kRPTClientTypeController)
+      else if (dest_client->client_type_ == kRPTClientTypeController)
         dest_type = "Controller";
     }
   }
@@ -1417,9 +1755,10 @@ HandleMessageResult BrokerCore::HandleRPTClientBadPushResult(const RptHeader& he
 
 void BrokerCore::ResetClientHeartbeatTimer(BrokerClient::Handle client_handle)
 {
-  etcpal::ReadGuard clients_read(client_lock_);
-  auto              client = clients_.find(client_handle);
-  if (client != clients_.end())
+  const ClientShard& shard = ShardFor(client_handle);
+  etcpal::ReadGuard  shard_read(shard.lock);
+  auto               client = shard.clients.find(client_handle);
+  if (client != shard.clients.end())
   {
     if (!RDMNET_ASSERT_VERIFY(client->second))
       return;
@@ -1434,38 +1773,36 @@ void BrokerCore::SendClientList(BrokerClient::Handle client_handle)
   BrokerMessage bmsg;
   bmsg.vector = VECTOR_BROKER_CONNECTED_CLIENT_LIST;
 
-  etcpal::ReadGuard clients_read(client_lock_);
-  auto              to_client = clients_.find(client_handle);
-  if (to_client != clients_.end())
+  auto to_client = FindClient(client_handle);
+  if (to_client)
   {
-    if (!RDMNET_ASSERT_VERIFY(to_client->second))
-      return;
-
-    if (to_client->second->client_protocol_ == E133_CLIENT_PROTOCOL_RPT)
-      SendRptClientList(bmsg, static_cast<RPTClient&>(*to_client->second));
+    if (to_client->client_protocol_ == E133_CLIENT_PROTOCOL_RPT)
+      SendRptClientList(bmsg, static_cast<RPTClient&>(*to_client));
     else
-      SendEptClientList(bmsg, static_cast<EPTClient&>(*to_client->second));
+      SendEptClientList(bmsg, static_cast<EPTClient&>(*to_client));
   }
 }
 
 void BrokerCore::SendRptClientList(BrokerMessage& bmsg, RPTClient& to_cli)
 {
-  std::vector<RdmnetRptClientEntry> entries;
-  entries.reserve(rpt_clients_.size());
-  for (auto& client : rpt_clients_)
-  {
-    if (!RDMNET_ASSERT_VERIFY(client.second))
-      return;
+  // Every RPT client is either a controller or a device, so the broadcast snapshots cover them all.
+  auto broadcast_sets = std::atomic_load(&broadcast_sets_);
 
+  std::vector<RdmnetRptClientEntry> entries;
+  entries.reserve(broadcast_sets->controllers.size() + broadcast_sets->devices.size());
+  auto add_entry = [&](const RPTClient& rpt_cli) {
     entries.emplace_back();
     RdmnetRptClientEntry& rpt_entry = entries.back();
-    RPTClient&            rpt_cli = static_cast<RPTClient&>(*client.second);
 
     rpt_entry.cid = rpt_cli.cid_.get();
     rpt_entry.uid = rpt_cli.uid_;
     rpt_entry.type = rpt_cli.client_type_;
     rpt_entry.binding_cid = rpt_cli.binding_cid_.get();
-  }
+  };
+  for (const auto& controller : broadcast_sets->controllers)
+    add_entry(*controller);
+  for (const auto& device : broadcast_sets->devices)
+    add_entry(*device);
   if (!entries.empty())
   {
     auto client_list = BROKER_GET_CLIENT_LIST(&bmsg);
@@ -1479,13 +1816,49 @@ void BrokerCore::SendRptClientList(BrokerMessage& bmsg, RPTClient& to_cli)
     client_list->client_protocol = kClientProtocolRPT;
     rpt_client_list->client_entries = entries.data();
     rpt_client_list->num_client_entries = entries.size();
+
+    ClientWriteGuard client_write(to_cli);
     to_cli.Push(settings_.cid, bmsg);
   }
 }
 
-void BrokerCore::SendEptClientList(BrokerMessage& /*bmsg*/, EPTClient& /*to_cli*/)
+void BrokerCore::SendEptClientList(BrokerMessage& bmsg, EPTClient& to_cli)
 {
-  // TODO
+  std::vector<RdmnetEptClientEntry>              entries;
+  std::vector<std::vector<RdmnetEptSubProtocol>> protocols;
+
+  {  // Client locks can't be taken with ept_lock_ held, so build the list first.
+    etcpal::ReadGuard ept_read(ept_lock_);
+    entries.reserve(ept_clients_.size());
+    protocols.reserve(ept_clients_.size());
+    for (auto& client : ept_clients_)
+    {
+      if (!RDMNET_ASSERT_VERIFY(client.second))
+        return;
+
+      entries.emplace_back();
+      protocols.emplace_back();
+      client.second->GetClientEntry(entries.back(), protocols.back());
+    }
+  }
+
+  if (!entries.empty())
+  {
+    auto client_list = BROKER_GET_CLIENT_LIST(&bmsg);
+    if (!RDMNET_ASSERT_VERIFY(client_list))
+      return;
+
+    auto ept_client_list = BROKER_GET_EPT_CLIENT_LIST(client_list);
+    if (!RDMNET_ASSERT_VERIFY(ept_client_list))
+      return;
+
+    client_list->client_protocol = kClientProtocolEPT;
+    ept_client_list->client_entries = entries.data();
+    ept_client_list->num_client_entries = entries.size();
+
+    ClientWriteGuard client_write(to_cli);
+    to_cli.Push(settings_.cid, bmsg);
+  }
 }
 
 void BrokerCore::SendClientsAdded(BrokerClient::Handle handle_to_ignore, std::vector<RdmnetRptClientEntry>& entries)
@@ -1505,14 +1878,13 @@ void BrokerCore::SendClientsAdded(BrokerClient::Handle handle_to_ignore, std::ve
   rpt_client_list->client_entries = entries.data();
   rpt_client_list->num_client_entries = entries.size();
 
-  for (const auto controller : controllers_)
+  auto broadcast_sets = std::atomic_load(&broadcast_sets_);
+  for (const auto& controller : broadcast_sets->controllers)
   {
-    if (controller.first != handle_to_ignore)
+    if (controller->handle_ != handle_to_ignore)
     {
-      if (!RDMNET_ASSERT_VERIFY(controller.second))
-        return;
-
-      controller.second->Push(settings_.cid, bmsg);
+      ClientWriteGuard client_write(*controller);
+      controller->Push(settings_.cid, bmsg);
     }
   }
 }
@@ -1534,16 +1906,59 @@ void BrokerCore::SendClientsRemoved(std::vector<RdmnetRptClientEntry>& entries)
   rpt_client_list->client_entries = entries.data();
   rpt_client_list->num_client_entries = entries.size();
 
-  for (const auto controller : controllers_)
+  auto broadcast_sets = std::atomic_load(&broadcast_sets_);
+  for (const auto& controller : broadcast_sets->controllers)
   {
-    if (!RDMNET_ASSERT_VERIFY(controller.second))
-      return;
+    ClientWriteGuard client_write(*controller);
+    controller->Push(settings_.cid, bmsg);
+  }
+}
+
+// Notifies every other EPT client that an EPT client has connected or disconnected.
+void BrokerCore::SendEptClientListChange(uint16_t vector, const EPTClient& changed_client)
+{
+  BrokerMessage bmsg;
+  bmsg.vector = vector;
+
+  auto client_list = BROKER_GET_CLIENT_LIST(&bmsg);
+  if (!RDMNET_ASSERT_VERIFY(client_list))
+    return;
+
+  auto ept_client_list = BROKER_GET_EPT_CLIENT_LIST(client_list);
+  if (!RDMNET_ASSERT_VERIFY(ept_client_list))
+    return;
+
+  RdmnetEptClientEntry              entry;
+  std::vector<RdmnetEptSubProtocol> protocols;
+  changed_client.GetClientEntry(entry, protocols);
+
+  client_list->client_protocol = kClientProtocolEPT;
+  ept_client_list->client_entries = &entry;
+  ept_client_list->num_client_entries = 1;
+
+  std::vector<std::shared_ptr<EPTClient>> dest_clients;
+  {  // Client locks can't be taken with ept_lock_ held, so collect the destinations first.
+    etcpal::ReadGuard ept_read(ept_lock_);
+    dest_clients.reserve(ept_clients_.size());
+    for (const auto& ept_client : ept_clients_)
+    {
+      if (ept_client.first != changed_client.handle_)
+      {
+        if (!RDMNET_ASSERT_VERIFY(ept_client.second))
+          return;
+
+        dest_clients.push_back(ept_client.second);
+      }
+    }
+  }
 
-    controller.second->Push(settings_.cid, bmsg);
+  for (const auto& dest : dest_clients)
+  {
+    ClientWriteGuard client_write(*dest);
+    dest->Push(settings_.cid, bmsg);
   }
 }
 
-// Needs read lock on client_lock_
 HandleMessageResult BrokerCore::SendStatus(RPTController*     controller,
                                            const RptHeader&   header,
                                            rpt_status_code_t  status_code,
@@ -1575,3 +1990,40 @@ HandleMessageResult BrokerCore::SendStatus(RPTController*     controller,
 
   return HandleRPTClientBadPushResult(new_header, push_res);
 }
+
+// The status is sent on behalf of the CID that could not be reached, so that the receiving client
+// can tell which of its destinations the status refers to.
+HandleMessageResult BrokerCore::SendEptStatus(EPTClient&          to_cli,
+                                              const etcpal::Uuid& unreachable_cid,
+                                              ept_status_code_t   status_code,
+                                              const std::string&  status_str)
+{
+  EptMessage status_msg;
+  status_msg.dest_cid = to_cli.cid_.get();
+  status_msg.vector = VECTOR_EPT_STATUS;
+
+  RdmnetEptStatus* status = EPT_GET_STATUS_MSG(&status_msg);
+  if (!RDMNET_ASSERT_VERIFY(status))
+    return HandleMessageResult::kGetNextMessage;
+
+  status->source_cid = unreachable_cid.get();
+  status->status_code = status_code;
+  status->status_string = status_str.empty() ? nullptr : status_str.c_str();
+
+  ClientPushResult push_res;
+  {
+    ClientWriteGuard client_write(to_cli);
+    push_res = to_cli.Push(unreachable_cid, status_msg);
+  }
+
+  if (push_res == ClientPushResult::Ok)
+  {
+    BROKER_LOG_DEBUG("Sending EPT Status code %d to EPT Client %s", status_code, to_cli.cid_.ToString().c_str());
+  }
+  else if (push_res == ClientPushResult::QueueFull)
+  {
+    // The sender's own queue is full; hold off on its message until it drains.
+    return HandleMessageResult::kRetryLater;
+  }
+  return HandleMessageResult::kGetNextMessage;
+}
@@ -20,6 +20,8 @@
 #ifndef BROKER_CORE_H_
 #define BROKER_CORE_H_
 
+#include <array>
+#include <atomic>
 #include <cstdint>
 #include <memory>
 #include <string>
@@ -28,6 +30,7 @@
 #include <vector>
 #include "etcpal/cpp/error.h"
 #include "etcpal/cpp/inet.h"
+#include "etcpal/cpp/mutex.h"
 #include "etcpal/cpp/rwlock.h"
 #include "etcpal/cpp/timer.h"
 #include "etcpal/socket.h"
@@ -43,6 +46,9 @@
 
 class BrokerComponentNotify : public BrokerSocketNotify, public BrokerThreadNotify, public BrokerDiscoveryNotify
 {
+public:
+  // New connections come from either the socket manager or a listen thread, depending on the platform.
+  bool HandleNewConnection(etcpal_socket_t new_sock, const etcpal::SockAddr& remote_addr) override = 0;
 };
 
 // A set of components of broker functionality, separated to facilitate testing and dependency
@@ -103,14 +109,45 @@ public:
   bool        IsValidControllerDestinationUID(const RdmUid& uid) const;
   bool        IsValidDeviceDestinationUID(const RdmUid& uid) const;
 
+  std::vector<rdmnet::Broker::ClientQueueStats> GetClientQueueStats() const;
+
   // Test/debug
   size_t GetNumClients() const;
 
 private:
-  using BrokerClientMap = std::unordered_map<BrokerClient::Handle, std::unique_ptr<BrokerClient>>;
-  using RptClientMap = std::unordered_map<BrokerClient::Handle, RPTClient*>;
-  using RptControllerMap = std::unordered_map<BrokerClient::Handle, RPTController*>;
-  using RptDeviceMap = std::unordered_map<BrokerClient::Handle, RPTDevice*>;
+  using BrokerClientMap = std::unordered_map<BrokerClient::Handle, std::shared_ptr<BrokerClient>>;
+  using RptClientMap = std::unordered_map<BrokerClient::Handle, std::shared_ptr<RPTClient>>;
+  using RptControllerList = std::vector<std::shared_ptr<RPTController>>;
+  using RptDeviceList = std::vector<std::shared_ptr<RPTDevice>>;
+  using EptClientMap = std::unordered_map<BrokerClient::Handle, std::shared_ptr<EPTClient>>;
+  using EptCidMap = std::unordered_map<etcpal::Uuid, BrokerClient::Handle, UuidHash>;
+  using EptSubProtocolMap = std::unordered_map<uint32_t, std::unordered_set<BrokerClient::Handle>>;
+
+  // A slice of the connected clients, selected by connection handle. Each shard has its own lock so
+  // that lookups and servicing in one shard don't contend with connects and disconnects in another.
+  struct ClientShard
+  {
+    // Protects the maps in this shard, but not the data in the clients themselves.
+    mutable etcpal::RwLock lock;
+    // The clients in this shard, indexed by the connection handle
+    BrokerClientMap clients;
+    // The subset of clients that are RPT clients
+    RptClientMap rpt_clients;
+  };
+
+  static constexpr size_t kNumClientShards = 16;
+
+  // The destinations of RPT broadcasts: every controller, every device, and the devices of each
+  // manufacturer. These are contiguous arrays so that a broadcast walks exactly its destinations,
+  // with no map iteration or per-message filtering.
+  struct RptBroadcastSets
+  {
+    RptControllerList controllers;
+    RptDeviceList     devices;
+    // Indexed by the device's manufacturer ID with the top bit masked off, to match the
+    // manufacturer ID carried in a manufacturer-specific broadcast UID.
+    std::unordered_map<uint16_t, RptDeviceList> devices_by_manu;
+  };
 
   // These are never modified between startup and shutdown, so they don't need to be locked.
   bool started_{false};
@@ -135,24 +172,58 @@ private:
   static constexpr uint32_t kClientDestroyIntervalMs = 200;
   etcpal::Timer             client_destroy_timer_{kClientDestroyIntervalMs};
 
-  // The list of connected clients, indexed by the connection handle
-  BrokerClientMap clients_;
-  // Protects the list of clients and uid lookup, but not the data in the clients themselves.
-  mutable etcpal::RwLock client_lock_;
+  // Serializes changes to the set of clients: handle allocation, connect handling and destruction.
+  // It is never taken on the message routing path. Client locks may be taken while holding it, but
+  // it must not be taken while holding a client lock.
+  etcpal::Mutex registry_lock_;
+  // The number of entries across all shards. Only modified with registry_lock_ held.
+  std::atomic<size_t> num_clients_{0};
+  // The bytes queued to all clients, against Limits::total_queue_bytes. Shared with each client.
+  std::shared_ptr<QueueByteBudget> queue_budget_;
+  // Paces connect handshakes to Limits::connect_rate.
+  ConnectAdmission connect_admission_;
+  // Backs every client object, so that connects reuse the memory of disconnected clients.
+  std::shared_ptr<ClientPool> client_pool_{std::make_shared<ClientPool>()};
+
+  // The list of connected clients, sharded by connection handle (see ShardFor()).
+  std::array<ClientShard, kNumClientShards> client_shards_;
+
+  // The RPT broadcast destinations. This is an immutable snapshot which is rebuilt (with
+  // registry_lock_ held) only when a controller or device is added or unlinked, and read with
+  // std::atomic_load(), so broadcasts never wait on connection changes. A broadcast that loaded a
+  // snapshot before a client was unlinked keeps that client alive until it completes.
+  std::shared_ptr<const RptBroadcastSets> broadcast_sets_{std::make_shared<RptBroadcastSets>()};
 
-  // We also divide the clients into subgroups by client protocol and by RPT role.
-  RptClientMap     rpt_clients_;
-  RptControllerMap controllers_;
-  RptDeviceMap     devices_;
+  // EPT messages are addressed by CID, so EPT clients are also indexed by CID for routing, and by
+  // the sub-protocols they support (see EptSubProtocolKey()). Client locks must not be taken while
+  // holding ept_lock_.
+  mutable etcpal::RwLock ept_lock_;
+  EptClientMap           ept_clients_;
+  EptCidMap              ept_clients_by_cid_;
+  EptSubProtocolMap      ept_subprotocols_;
 
+  // Clients marked for destruction are unlinked from routing as soon as the locks allow (see
+  // UnlinkMarkedClients()), but stay in their shard until DestroyMarkedClients() runs on
+  // client_destroy_timer_, so that a final disconnect or connect reply message can be sent.
+  etcpal::Mutex                            destroy_lock_;
+  std::unordered_set<BrokerClient::Handle> clients_to_unlink_;
   std::unordered_set<BrokerClient::Handle> clients_to_destroy_;
 
+  ClientShard&       ShardFor(BrokerClient::Handle handle) { return client_shards_[ShardIndex(handle)]; }
+  const ClientShard& ShardFor(BrokerClient::Handle handle) const { return client_shards_[ShardIndex(handle)]; }
+  static size_t      ShardIndex(BrokerClient::Handle handle) { return static_cast<size_t>(handle) % kNumClientShards; }
+
+  std::shared_ptr<BrokerClient> FindClient(BrokerClient::Handle handle) const;
+  std::shared_ptr<RPTClient>    FindRptClient(const RdmUid& uid) const;
+  std::shared_ptr<EPTClient>    FindEptClient(BrokerClient::Handle handle) const;
+
   std::set<etcpal::IpAddr>          GetInterfaceAddrs(const std::vector<std::string>& interfaces);
   etcpal::Expected<etcpal_socket_t> StartListening(const etcpal::IpAddr& ip, uint16_t& port);
   etcpal::Error                     StartBrokerServices();
   void                              StopBrokerServices(rdmnet_disconnect_reason_t disconnect_reason);
+  void                              ReserveClientShards(const rdmnet::Broker::Limits& limits);
 
-  // BrokerThreadNotify messages
+  // BrokerThreadNotify messages (HandleNewConnection() is also a BrokerSocketNotify message)
   virtual bool HandleNewConnection(etcpal_socket_t new_sock, const etcpal::SockAddr& addr) override;
   virtual bool ServiceClients() override;
 
@@ -171,8 +242,12 @@ private:
                                 const ClientDestroyAction& destroy_action = ClientDestroyAction::DoNothing());
   bool MarkLockedClientForDestruction(BrokerClient&              client,
                                       const ClientDestroyAction& destroy_action = ClientDestroyAction::DoNothing());
+  void UnlinkMarkedClients();
+  void UnlinkEptClient(const EPTClient& client);
   void DestroyMarkedClients(std::vector<BrokerClient::Handle>& clients_for_socket_removal);
-  void DestroyMarkedClientsLocked(std::vector<BrokerClient::Handle>& clients_for_socket_removal);
+  void AddBroadcastDestination(const std::shared_ptr<RPTController>& controller);
+  void AddBroadcastDestination(const std::shared_ptr<RPTDevice>& device);
+  void RemoveBroadcastDestinations(const std::unordered_set<BrokerClient::Handle>& handles);
   void RemoveClientSockets(const std::vector<BrokerClient::Handle>& clients);
 
   // BrokerSocketNotify messages
@@ -181,22 +256,28 @@ private:
                                                           const RdmnetMessage& message) override;
 
   // Message processing and sending functions
+  HandleMessageResult    AdmitConnectRequest(BrokerClient::Handle client_handle, const RdmnetMessage& message);
   void                   ProcessConnectRequest(BrokerClient::Handle client_handle, const BrokerClientConnectMsg* cmsg);
   bool                   ProcessRPTConnectRequest(BrokerClient::Handle        client_handle,
                                                   const RdmnetRptClientEntry& client_entry,
                                                   rdmnet_connect_status_t&    connect_status);
+  bool                   ProcessEPTConnectRequest(BrokerClient::Handle        client_handle,
+                                                  const RdmnetEptClientEntry& client_entry,
+                                                  rdmnet_connect_status_t&    connect_status);
+  bool                   PromotePendingClient(const std::shared_ptr<BrokerClient>& pending_client,
+                                              const std::shared_ptr<BrokerClient>& new_client);
   bool                   ResolveNewClientUid(BrokerClient::Handle     client_handle,
                                              RdmnetRptClientEntry&    client_entry,
                                              rdmnet_connect_status_t& connect_status);
   HandleMessageResult    ProcessRPTMessage(BrokerClient::Handle client_handle, const RdmnetMessage* msg);
   HandleMessageResult    RouteRPTMessage(BrokerClient::Handle client_handle, const RdmnetMessage* msg);
+  HandleMessageResult    ProcessEPTMessage(BrokerClient::Handle client_handle, const RdmnetMessage* msg);
   ClientPushResult       PushToAllControllers(BrokerClient::Handle sender_handle, const RdmnetMessage* msg);
   ClientPushResult       PushToAllDevices(BrokerClient::Handle sender_handle, const RdmnetMessage* msg);
   ClientPushResult       PushToManuSpecificDevices(BrokerClient::Handle sender_handle,
                                                    const RdmnetMessage* msg,
                                                    uint16_t             manu);
   ClientPushResult       PushToSpecificRptClient(BrokerClient::Handle sender_handle, const RdmnetMessage* msg);
-  RptClientMap::iterator FindRptClient(const RdmUid& uid);
   HandleMessageResult    HandleRPTClientBadPushResult(const RptHeader& header, ClientPushResult result);
   void                   ResetClientHeartbeatTimer(BrokerClient::Handle client_handle);
 
@@ -207,15 +288,21 @@ private:
                              uint16_t             param_id,
                              uint8_t              packedlen,
                              uint8_t*             pdata);
+  // The client list messages lock each destination client in turn, so no client lock may be held when they're called.
   void SendClientList(BrokerClient::Handle client_handle);
   void SendRptClientList(BrokerMessage& bmsg, RPTClient& to_cli);
   void SendEptClientList(BrokerMessage& bmsg, EPTClient& to_cli);
   void SendClientsAdded(BrokerClient::Handle handle_to_ignore, std::vector<RdmnetRptClientEntry>& entries);
   void SendClientsRemoved(std::vector<RdmnetRptClientEntry>& entries);
+  void SendEptClientListChange(uint16_t vector, const EPTClient& changed_client);
   HandleMessageResult SendStatus(RPTController*     controller,
                                  const RptHeader&   header,
                                  rpt_status_code_t  status_code,
                                  const std::string& status_str = std::string());
+  HandleMessageResult SendEptStatus(EPTClient&          to_cli,
+                                    const etcpal::Uuid& unreachable_cid,
+                                    ept_status_code_t   status_code,
+                                    const std::string&  status_str = std::string());
 };
 
 #endif  // BROKER_CORE_H_
@@ -21,7 +21,9 @@
 #define BROKER_SOCKET_MANAGER_H_
 
 #include <memory>
+#include "etcpal/cpp/inet.h"
 #include "etcpal/socket.h"
+#include "rdmnet/core/common.h"
 #include "rdmnet/core/message.h"
 #include "broker_client.h"
 
@@ -63,6 +65,15 @@ public:
   /// @param[in] handle The client handle for which the socket was closed.
   /// @param[in] graceful Whether the TCP connection was closed gracefully.
   virtual void HandleSocketClosed(BrokerClient::Handle handle, bool graceful) = 0;
+
+  /// @brief A new connection was accepted on a listen socket added with BrokerSocketManager::AddListenSocket().
+  ///
+  /// The implementation takes ownership of the socket, normally by calling BrokerSocketManager::AddSocket().
+  ///
+  /// @param[in] new_sock The newly-accepted socket.
+  /// @param[in] remote_addr The address of the remote end of the connection.
+  /// @return false to close the connection immediately.
+  virtual bool HandleNewConnection(etcpal_socket_t new_sock, const etcpal::SockAddr& remote_addr) = 0;
 };
 
 class BrokerSocketManager
@@ -77,6 +88,31 @@ public:
 
   virtual bool AddSocket(BrokerClient::Handle handle, etcpal_socket_t sock) = 0;
   virtual void RemoveSocket(BrokerClient::Handle handle) = 0;
+
+  // Accept connections on a listening socket from the socket manager's own threads. Returns false
+  // if this platform's socket manager doesn't accept connections, in which case the caller should
+  // start a listen thread for the socket instead. On success, the socket manager owns the socket
+  // and closes it on Shutdown().
+  virtual bool AddListenSocket(etcpal_socket_t listen_sock)
+  {
+    ETCPAL_UNUSED_ARG(listen_sock);
+    return false;
+  }
+
+  // Send data to a client on its socket, returning the number of bytes taken or a negative
+  // etcpal_error_t. A socket manager that batches sends may copy the data to send on the next
+  // FlushSends(), and returns kEtcPalErrWouldBlock when it has no room to take any of it. Data taken
+  // for a socket is sent in order, and all of it is sent before the socket is closed by
+  // RemoveSocket() or Shutdown(). By default, the data is sent directly.
+  virtual int SendOnSocket(BrokerClient::Handle handle, etcpal_socket_t sock, const uint8_t* data, size_t size)
+  {
+    ETCPAL_UNUSED_ARG(handle);
+    return rc_send(sock, data, size, 0);
+  }
+
+  // Start sending the data taken by SendOnSocket() since the last call. Called after each pass over
+  // the clients; returns true if any sends were started or finished.
+  virtual bool FlushSends() { return false; }
 };
 
 std::unique_ptr<BrokerSocketManager> CreateBrokerSocketManager();
@@ -69,3 +69,196 @@ RptHeader SwapHeaderData(const RptHeader& source)
   swapped_header.source_uid = source.dest_uid;
   return swapped_header;
 }
+
+size_t UuidHash::operator()(const etcpal::Uuid& uuid) const noexcept
+{
+  // FNV-1a over the 16 bytes of the UUID
+  uint32_t hash = 2166136261u;
+  for (uint8_t byte : uuid.get().data)
+  {
+    hash ^= byte;
+    hash *= 16777619u;
+  }
+  return hash;
+}
+
+// Set the rate at which tokens accrue and the most that can be held. A depth of 0 is treated as
+// one second's worth of tokens. The bucket starts full.
+void TokenBucket::SetRate(unsigned int tokens_per_s, unsigned int depth, uint32_t now_ms)
+{
+  rate_ = tokens_per_s;
+  depth_ = static_cast<int64_t>(depth == 0 ? tokens_per_s : depth) * kMilliTokensPerToken;
+  milli_tokens_ = depth_;
+  last_refill_ms_ = now_ms;
+}
+
+// Take a token, borrowing it if none is available. Returns how many ms from now the token would
+// have been available, or 0 if it was available now.
+uint32_t TokenBucket::Borrow(uint32_t now_ms)
+{
+  if (rate_ == 0)
+    return 0;
+
+  Refill(now_ms);
+  milli_tokens_ -= kMilliTokensPerToken;
+  if (milli_tokens_ >= 0)
+    return 0;
+
+  // Tokens accrue at rate_ thousandths of a token per ms.
+  return static_cast<uint32_t>((-milli_tokens_ + rate_ - 1) / rate_);
+}
+
+void TokenBucket::Refill(uint32_t now_ms)
+{
+  // Unsigned subtraction handles the wraparound of the ms clock.
+  uint32_t elapsed_ms = now_ms - last_refill_ms_;
+  last_refill_ms_ = now_ms;
+
+  milli_tokens_ += static_cast<int64_t>(elapsed_ms) * rate_;
+  if (milli_tokens_ > depth_)
+    milli_tokens_ = depth_;
+}
+
+// Set the sustained connect rate and the number of connects that can be admitted back-to-back. A
+// rate of 0 admits every connect; a burst of 0 is the same as the rate.
+void ConnectAdmission::SetRate(unsigned int connects_per_s, unsigned int burst, uint32_t now_ms)
+{
+  etcpal::MutexGuard guard(lock_);
+
+  tokens_.SetRate(connects_per_s, burst, now_ms);
+  reservations_.clear();
+  last_prune_ms_ = now_ms;
+}
+
+// Decide what to do with a connect request from the client with the given CID.
+ConnectAdmission::Result ConnectAdmission::Admit(const etcpal::Uuid& cid, uint32_t now_ms)
+{
+  etcpal::MutexGuard guard(lock_);
+
+  PruneReservations(now_ms);
+
+  uint32_t wait_ms = 0;
+  auto     reservation = reservations_.find(cid);
+  if (reservation != reservations_.end())
+  {
+    // A returning client uses the slot it was given rather than taking another.
+    auto until_slot = static_cast<int32_t>(reservation->second - now_ms);
+    if (until_slot <= 0)
+    {
+      reservations_.erase(reservation);
+      return Result{};
+    }
+    wait_ms = static_cast<uint32_t>(until_slot);
+  }
+  else
+  {
+    wait_ms = tokens_.Borrow(now_ms);
+    if (wait_ms == 0)
+      return Result{};
+    reservations_[cid] = now_ms + wait_ms;
+  }
+
+  if (wait_ms <= kMaxHoldMs)
+    return Result{Decision::kHold, 0};
+  return Result{Decision::kRetryAfter, wait_ms};
+}
+
+size_t ConnectAdmission::num_reservations() const
+{
+  etcpal::MutexGuard guard(lock_);
+  return reservations_.size();
+}
+
+// Forget the reservations of clients that haven't come back for their slot. Walks the
+// reservations at most once per grace period.
+void ConnectAdmission::PruneReservations(uint32_t now_ms)
+{
+  if (reservations_.empty() || static_cast<uint32_t>(now_ms - last_prune_ms_) < kReservationGraceMs)
+    return;
+
+  last_prune_ms_ = now_ms;
+  for (auto reservation = reservations_.begin(); reservation != reservations_.end();)
+  {
+    if (static_cast<int32_t>(now_ms - reservation->second) > static_cast<int32_t>(kReservationGraceMs))
+      reservation = reservations_.erase(reservation);
+    else
+      ++reservation;
+  }
+}
+
+ClientPool::~ClientPool()
+{
+  for (auto& list : free_lists_)
+  {
+    while (list.head)
+    {
+      FreeBlock* block = list.head;
+      list.head = block->next;
+      ::operator delete(block);
+    }
+  }
+}
+
+// Get a block of at least size bytes, suitably aligned for any client type.
+void* ClientPool::Allocate(size_t size)
+{
+  {
+    etcpal::MutexGuard guard(lock_);
+
+    FreeList* list = FindFreeList(size);
+    if (list && list->head)
+    {
+      FreeBlock* block = list->head;
+      list->head = block->next;
+      --list->count;
+      return block;
+    }
+    if (!list)
+      free_lists_.push_back(FreeList{size, nullptr, 0});
+  }
+
+  return ::operator new(size < sizeof(FreeBlock) ? sizeof(FreeBlock) : size);
+}
+
+// Return a block obtained from Allocate() with the same size.
+void ClientPool::Deallocate(void* block, size_t size) noexcept
+{
+  if (!block)
+    return;
+
+  {
+    etcpal::MutexGuard guard(lock_);
+
+    FreeList* list = FindFreeList(size);
+    if (list && list->count < kMaxFreeBlocksPerSize)
+    {
+      auto free_block = static_cast<FreeBlock*>(block);
+      free_block->next = list->head;
+      list->head = free_block;
+      ++list->count;
+      return;
+    }
+  }
+
+  ::operator delete(block);
+}
+
+size_t ClientPool::num_free_blocks() const
+{
+  etcpal::MutexGuard guard(lock_);
+
+  size_t count = 0;
+  for (const auto& list : free_lists_)
+    count += list.count;
+  return count;
+}
+
+ClientPool::FreeList* ClientPool::FindFreeList(size_t size) noexcept
+{
+  for (auto& list : free_lists_)
+  {
+    if (list.block_size == size)
+      return &list;
+  }
+  return nullptr;
+}
@@ -22,9 +22,18 @@
 #ifndef BROKER_UTIL_H_
 #define BROKER_UTIL_H_
 
+#include <cstddef>
+#include <cstdint>
 #include <functional>
+#include <memory>
+#include <unordered_map>
+#include <utility>
+#include <vector>
 #include "etcpal/common.h"
+#include "etcpal/cpp/mutex.h"
+#include "etcpal/cpp/uuid.h"
 #include "etcpal/handle_manager.h"
+#include "rdmnet/core/message.h"
 #include "rdmnet/core/rpt_prot.h"
 #include "rdmnet/core/util.h"
 #include "broker_client.h"
@@ -49,7 +58,230 @@ private:
   IntHandleManager handle_mgr_;
 };
 
+// A token bucket, used to pace work that arrives in bursts. Tokens accrue at a fixed rate per
+// second up to the bucket's depth; each unit of work takes one, borrowing against tokens yet to
+// accrue if none is available, and is scheduled for when its token would have accrued. A rate of 0
+// never runs out of tokens.
+//
+// Times are passed in by the caller as etcpal_getms() values. Not thread-safe.
+class TokenBucket
+{
+public:
+  void     SetRate(unsigned int tokens_per_s, unsigned int depth, uint32_t now_ms);
+  uint32_t Borrow(uint32_t now_ms);
+
+private:
+  // Token counts are kept in thousandths of a token so that refills are exact at millisecond
+  // granularity. The count goes negative while tokens are borrowed.
+  static constexpr int64_t kMilliTokensPerToken{1000};
+
+  void Refill(uint32_t now_ms);
+
+  unsigned int rate_{0};
+  int64_t      depth_{0};
+  int64_t      milli_tokens_{0};
+  uint32_t     last_refill_ms_{0};
+};
+
+// Hash functor allowing a CID to be used as the key of an unordered container.
+struct UuidHash
+{
+  size_t operator()(const etcpal::Uuid& uuid) const noexcept;
+};
+
+// Paces client connect handshakes to a fixed rate, as a broker recovering from a reconnect storm.
+//
+// A connect that can't be admitted right away is given a reservation: a time slot, one token's
+// accrual after the last one given out, at which it will be admitted. A short wait is absorbed by
+// holding the connect message until its slot. For a longer one, the client is turned away with a
+// hint of how long to wait, and its CID keeps the reservation for when it reconnects. Turned-away
+// clients thus come back on an even schedule rather than all at once.
+class ConnectAdmission
+{
+public:
+  enum class Decision
+  {
+    kAdmit,      // Process the connect now.
+    kHold,       // Hold the connect message and try to admit it again shortly.
+    kRetryAfter  // Reject the connect, asking the client to reconnect after retry_after_ms.
+  };
+
+  struct Result
+  {
+    Decision decision{Decision::kAdmit};
+    uint32_t retry_after_ms{0};
+  };
+
+  // The longest a connect message is held before its client is turned away instead.
+  static constexpr uint32_t kMaxHoldMs{500};
+  // How long past its slot a reservation is kept for a client that is slow to return.
+  static constexpr uint32_t kReservationGraceMs{5000};
+
+  void   SetRate(unsigned int connects_per_s, unsigned int burst, uint32_t now_ms);
+  Result Admit(const etcpal::Uuid& cid, uint32_t now_ms);
+
+  size_t num_reservations() const;
+
+private:
+  void PruneReservations(uint32_t now_ms);
+
+  mutable etcpal::Mutex                                lock_;
+  TokenBucket                                          tokens_;
+  std::unordered_map<etcpal::Uuid, uint32_t, UuidHash> reservations_;
+  uint32_t                                             last_prune_ms_{0};
+};
+
+// Recycles the memory of client objects. A pooled client is allocated together with its
+// shared_ptr control block (see MakePooledClient()), and the blocks left by destroyed clients are
+// kept for new clients of the same type rather than returned to the heap, so a burst of connects
+// after a burst of disconnects allocates nothing. Thread-safe; a client may be destroyed on any
+// thread.
+class ClientPool
+{
+public:
+  // The most free blocks of each size kept for reuse.
+  static constexpr size_t kMaxFreeBlocksPerSize{1024};
+
+  ClientPool() = default;
+  ~ClientPool();
+  ClientPool(const ClientPool&) = delete;
+  ClientPool& operator=(const ClientPool&) = delete;
+
+  void* Allocate(size_t size);
+  void  Deallocate(void* block, size_t size) noexcept;
+
+  size_t num_free_blocks() const;
+
+private:
+  // Free blocks are chained through their first bytes.
+  struct FreeBlock
+  {
+    FreeBlock* next;
+  };
+
+  struct FreeList
+  {
+    size_t     block_size;
+    FreeBlock* head;
+    size_t     count;
+  };
+
+  FreeList* FindFreeList(size_t size) noexcept;
+
+  mutable etcpal::Mutex lock_;
+  // One list per client type; there are only a handful.
+  std::vector<FreeList> free_lists_;
+};
+
+// A standard allocator drawing from a ClientPool, which it keeps alive until the last client
+// allocated from it is destroyed.
+template <class T>
+class ClientPoolAllocator
+{
+public:
+  using value_type = T;
+
+  explicit ClientPoolAllocator(std::shared_ptr<ClientPool> pool) noexcept : pool_(std::move(pool)) {}
+  template <class U>
+  ClientPoolAllocator(const ClientPoolAllocator<U>& other) noexcept : pool_(other.pool_)
+  {
+  }
+
+  T*   allocate(size_t n) { return static_cast<T*>(pool_->Allocate(n * sizeof(T))); }
+  void deallocate(T* p, size_t n) noexcept { pool_->Deallocate(p, n * sizeof(T)); }
+
+  template <class U>
+  bool operator==(const ClientPoolAllocator<U>& other) const noexcept
+  {
+    return pool_ == other.pool_;
+  }
+  template <class U>
+  bool operator!=(const ClientPoolAllocator<U>& other) const noexcept
+  {
+    return pool_ != other.pool_;
+  }
+
+private:
+  template <class U>
+  friend class ClientPoolAllocator;
+
+  std::shared_ptr<ClientPool> pool_;
+};
+
+// Create a client of type ClientType from pool, or from the heap if pool is null.
+template <class ClientType, class... Args>
+std::shared_ptr<ClientType> MakePooledClient(const std::shared_ptr<ClientPool>& pool, Args&&... args)
+{
+  if (!pool)
+    return std::make_shared<ClientType>(std::forward<Args>(args)...);
+  return std::allocate_shared<ClientType>(ClientPoolAllocator<ClientType>(pool), std::forward<Args>(args)...);
+}
+
 // Utility functions for manipulating messages
 RptHeader SwapHeaderData(const RptHeader& source);
 
+// Push an RPT message to every client in a contiguous list of destinations (a vector of pointers
+// to RPTClient or a subclass). The message is pushed to all of them or to none: every destination
+// is locked first, and if any of their queues is full (after any room their overflow policy can
+// make), nothing is pushed and QueueFull is returned. Destinations that have been marked for
+// destruction are skipped.
+template <class ClientList>
+ClientPushResult PushToRptClients(BrokerClient::Handle sender_handle,
+                                  const RdmnetMessage* msg,
+                                  const ClientList&    dest_clients)
+{
+  if (!RDMNET_ASSERT_VERIFY(msg))
+    return ClientPushResult::Error;
+
+  const RptMessage* rptmsg = RDMNET_GET_RPT_MSG(msg);
+  if (!RDMNET_ASSERT_VERIFY(rptmsg))
+    return ClientPushResult::Error;
+
+  ClientPushResult result = ClientPushResult::Ok;
+
+  // Lock all destination clients
+  size_t num_locked = 0;
+  for (; num_locked < dest_clients.size(); ++num_locked)
+  {
+    if (!dest_clients[num_locked]->lock_.WriteLock())
+    {
+      result = ClientPushResult::Error;
+      break;
+    }
+  }
+
+  // If all locks succeeded, check if any destination client queues are full
+  if (result == ClientPushResult::Ok)
+  {
+    for (const auto& dest : dest_clients)
+    {
+      if (!dest->marked_for_destruction_ && !dest->HasRoomForRptMessage(*rptmsg))
+      {
+        result = dest->RecordQueueFull();
+        break;
+      }
+    }
+  }
+
+  // If no queues are full, push to all queues
+  if (result == ClientPushResult::Ok)
+  {
+    for (const auto& dest : dest_clients)
+    {
+      if (dest->marked_for_destruction_)
+        continue;
+
+      auto push_res = dest->Push(sender_handle, msg->sender_cid, *rptmsg);
+      if (result == ClientPushResult::Ok)
+        result = push_res;
+    }
+  }
+
+  // Unlock all destination clients that locked successfully
+  for (size_t i = 0; i < num_locked; ++i)
+    dest_clients[i]->lock_.WriteUnlock();
+
+  return result;
+}
+
 #endif  // BROKER_UTIL_H_
@@ -18,7 +18,8 @@
  *****************************************************************************/
 
 // epoll() is a scalabile mechanism for watching many file descriptors (including sockets) in the
-// Linux kernel. For this app, we use a single thread polling all of the currently-open sockets.
+// Linux kernel. For this app, we use a single thread polling all of the currently-open sockets,
+// including the listening sockets on which new connections are accepted.
 //
 // Further reading:
 // "man epoll" from a Linux distribution command line
@@ -27,15 +28,32 @@
 #include "linux_socket_manager.h"
 
 #include <algorithm>
+#include <cerrno>
 #include <sys/epoll.h>
 #include <sys/types.h>
 #include <sys/socket.h>
 #include <unistd.h>
+#include "etcpal/inet.h"
 #include "rdmnet/core/message.h"
 
+#if RDMNET_HAVE_IO_URING
+#include "linux_uring_socket_manager.h"
+#endif
+
 constexpr int kMaxEvents = 100;
 constexpr int kEpollTimeout = 200;
 
+// How often messages deferred by the notify handler are retried.
+constexpr int kDeferredRetryInterval = 10;
+
+// The most connections accepted from one listening socket per wakeup. Bounds how long client
+// sockets wait on the worker thread during a connection storm.
+constexpr int kMaxAcceptBatch = 64;
+
+// The epoll data for a listening socket is the socket tagged with this bit. The data for client
+// sockets is the client handle.
+constexpr uint64_t kListenSocketTag = (static_cast<uint64_t>(1) << 32);
+
 // Function for the worker thread which does all the socket reading.
 void* SocketWorkerThread(void* arg)
 {
@@ -47,20 +65,34 @@ void* SocketWorkerThread(void* arg)
 
   while (sock_mgr->keep_running())
   {
-    int epoll_result = epoll_wait(sock_mgr->epoll_fd(), events.get(), kMaxEvents, kEpollTimeout);
+    int timeout = (sock_mgr->has_deferred_messages() ? kDeferredRetryInterval : kEpollTimeout);
+    int epoll_result = epoll_wait(sock_mgr->epoll_fd(), events.get(), kMaxEvents, timeout);
     for (int i = 0; i < epoll_result && sock_mgr->keep_running(); ++i)
     {
-      if (events[i].events & EPOLLERR)
+      uint64_t data = events[i].data.u64;
+      if (data & kListenSocketTag)
       {
-        // Notify that this socket is bad
-        sock_mgr->WorkerNotifySocketBad(events[i].data.fd);
+        // Accept new connections
+        sock_mgr->WorkerNotifyListenSocketReadEvent(static_cast<int>(data & ~kListenSocketTag));
+        continue;
+      }
+
+      auto client_handle = static_cast<BrokerClient::Handle>(static_cast<uint32_t>(data));
+      if ((events[i].events & EPOLLERR) || (events[i].events & (EPOLLHUP | EPOLLIN)) == EPOLLHUP)
+      {
+        // Notify that this socket is bad. A hangup is reported here only if reading is suspended
+        // for a deferred message; otherwise it is found by the read.
+        sock_mgr->WorkerNotifySocketBad(client_handle);
       }
       else if (events[i].events & EPOLLIN)
       {
         // Do the read on the socket
-        sock_mgr->WorkerNotifySocketReadEvent(events[i].data.fd);
+        sock_mgr->WorkerNotifySocketReadEvent(client_handle);
       }
     }
+
+    if (sock_mgr->has_deferred_messages() && sock_mgr->keep_running())
+      sock_mgr->WorkerRetryDeferredMessages();
   }
   return reinterpret_cast<void*>(0);
 }
@@ -94,6 +126,12 @@ bool LinuxBrokerSocketManager::Shutdown()
   pthread_join(thread_handle_, NULL);
 
   etcpal::MutexGuard socket_guard(socket_lock_);
+  for (int listen_sock : listen_sockets_)
+    close(listen_sock);
+  listen_sockets_.clear();
+  deferred_.clear();
+  has_deferred_ = false;
+
   for (auto& sock_data : sockets_)
   {
     if (!RDMNET_ASSERT_VERIFY(sock_data.second))
@@ -122,7 +160,7 @@ bool LinuxBrokerSocketManager::AddSocket(BrokerClient::Handle client_handle, etc
       // Add the socket to our epoll fd
       struct epoll_event new_event;
       new_event.events = EPOLLIN;
-      new_event.data.fd = client_handle;
+      new_event.data.u64 = static_cast<uint32_t>(client_handle);
       if (0 == epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, socket, &new_event))
       {
         return true;
@@ -153,6 +191,28 @@ void LinuxBrokerSocketManager::RemoveSocket(BrokerClient::Handle client_handle)
   }
 }
 
+bool LinuxBrokerSocketManager::AddListenSocket(etcpal_socket_t listen_sock)
+{
+  // The worker thread accepts until the backlog is empty, so the socket must not block.
+  if (etcpal_setblocking(listen_sock, false) != kEtcPalErrOk)
+    return false;
+
+  etcpal::MutexGuard socket_guard(socket_lock_);
+
+  struct epoll_event new_event;
+  new_event.events = EPOLLIN;
+  new_event.data.u64 = kListenSocketTag | static_cast<uint32_t>(listen_sock);
+  if (0 != epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, listen_sock, &new_event))
+  {
+    // Leave the socket as we found it for the caller's fallback.
+    etcpal_setblocking(listen_sock, true);
+    return false;
+  }
+
+  listen_sockets_.push_back(listen_sock);
+  return true;
+}
+
 void LinuxBrokerSocketManager::WorkerNotifySocketBad(BrokerClient::Handle client_handle)
 {
   {  // Lock scope
@@ -185,6 +245,10 @@ void LinuxBrokerSocketManager::WorkerNotifySocketReadEvent(BrokerClient::Handle
   if (!RDMNET_ASSERT_VERIFY(sock_data) || !RDMNET_ASSERT_VERIFY(sock_data->recv_buf.cur_data_size <= RC_MSG_BUF_SIZE))
     return;
 
+  // Reading resumes once the deferred message has been handled.
+  if (sock_data->deferred)
+    return;
+
   void*  recv_buf = &sock_data->recv_buf.buf[sock_data->recv_buf.cur_data_size];
   size_t recv_buf_size =
       std::min<size_t>(RDMNET_RECV_DATA_MAX_SIZE, RC_MSG_BUF_SIZE - sock_data->recv_buf.cur_data_size);
@@ -201,26 +265,113 @@ void LinuxBrokerSocketManager::WorkerNotifySocketReadEvent(BrokerClient::Handle
   else
   {
     sock_data->recv_buf.cur_data_size += recv_result;
-    etcpal_error_t res = rc_msg_buf_parse_data(&sock_data->recv_buf);
-    while (res == kEtcPalErrOk)
+    if (rc_msg_buf_parse_data(&sock_data->recv_buf) == kEtcPalErrOk && !DeliverMessages(*sock_data))
+      DeferSocket(*sock_data);
+  }
+}
+
+void LinuxBrokerSocketManager::WorkerNotifyListenSocketReadEvent(int listen_sock)
+{
+  // Drain the accept backlog in batches, rather than taking one wakeup per connection.
+  for (int i = 0; i < kMaxAcceptBatch && keep_running(); ++i)
+  {
+    struct sockaddr_storage remote_addr;
+    socklen_t               remote_addr_len = sizeof remote_addr;
+
+    int new_sock = accept4(listen_sock, reinterpret_cast<struct sockaddr*>(&remote_addr), &remote_addr_len,
+                           SOCK_NONBLOCK | SOCK_CLOEXEC);
+    if (new_sock < 0)
     {
-      if (notify_)
-      {
-        while (notify_->HandleSocketMessageReceived(client_handle, sock_data->recv_buf.msg) ==
-               HandleMessageResult::kRetryLater)
-        {
-          sleep(10);  // Sleep to avoid busy loop.
-        }
-      }
+      // A connection that was reset while in the backlog doesn't affect the others. Anything else,
+      // including an empty backlog, ends this batch.
+      if (errno == ECONNABORTED || errno == EINTR)
+        continue;
+      return;
+    }
+
+    EtcPalSockAddr addr{};
+    sockaddr_os_to_etcpal(reinterpret_cast<const etcpal_os_sockaddr_t*>(&remote_addr), &addr);
+
+    // Called without socket_lock_, as the handler adds the new socket.
+    if (!notify_ || !notify_->HandleNewConnection(new_sock, etcpal::SockAddr(addr)))
+      close(new_sock);
+  }
+}
 
-      rc_free_message_resources(&sock_data->recv_buf.msg);
-      res = rc_msg_buf_parse_data(&sock_data->recv_buf);
+void LinuxBrokerSocketManager::WorkerRetryDeferredMessages()
+{
+  etcpal::MutexGuard socket_guard(socket_lock_);
+
+  std::vector<BrokerClient::Handle> to_retry;
+  to_retry.swap(deferred_);
+  has_deferred_ = false;
+
+  for (auto client_handle : to_retry)
+  {
+    // The socket may have been closed, and its handle reused, since its message was deferred.
+    auto sock_data_iter = sockets_.find(client_handle);
+    if (sock_data_iter == sockets_.end() || !sock_data_iter->second->deferred)
+      continue;
+
+    SocketData& sock_data = *sock_data_iter->second;
+    sock_data.deferred = false;
+    if (DeliverMessages(sock_data))
+    {
+      // Resume reading from the socket
+      struct epoll_event mod_event;
+      mod_event.events = EPOLLIN;
+      mod_event.data.u64 = static_cast<uint32_t>(client_handle);
+      epoll_ctl(epoll_fd_, EPOLL_CTL_MOD, sock_data.socket, &mod_event);
     }
+    else
+    {
+      DeferSocket(sock_data);
+    }
+  }
+}
+
+// Pass the parsed messages in a socket's receive buffer to the notify handler, starting with the
+// one already parsed. Returns false if the handler asked to retry a message later; that message is
+// left in the buffer. Must be called with socket_lock_ held.
+bool LinuxBrokerSocketManager::DeliverMessages(SocketData& sock_data)
+{
+  etcpal_error_t res = kEtcPalErrOk;
+  while (res == kEtcPalErrOk)
+  {
+    if (notify_ && notify_->HandleSocketMessageReceived(sock_data.client_handle, sock_data.recv_buf.msg) ==
+                       HandleMessageResult::kRetryLater)
+    {
+      return false;
+    }
+
+    rc_free_message_resources(&sock_data.recv_buf.msg);
+    res = rc_msg_buf_parse_data(&sock_data.recv_buf);
   }
+  return true;
+}
+
+// Hold a socket's current message for WorkerRetryDeferredMessages(). Reading from the socket stops
+// until the message is handled, which throttles that TCP connection without holding up the worker
+// thread's other sockets. Must be called with socket_lock_ held.
+void LinuxBrokerSocketManager::DeferSocket(SocketData& sock_data)
+{
+  struct epoll_event mod_event;
+  mod_event.events = 0;
+  mod_event.data.u64 = static_cast<uint32_t>(sock_data.client_handle);
+  epoll_ctl(epoll_fd_, EPOLL_CTL_MOD, sock_data.socket, &mod_event);
+
+  sock_data.deferred = true;
+  deferred_.push_back(sock_data.client_handle);
+  has_deferred_ = true;
 }
 
-// Instantiate a LinuxBrokerSocketManager
+// Instantiate a LinuxUringBrokerSocketManager if RDMnet was built with io_uring and the running
+// kernel supports it, otherwise a LinuxBrokerSocketManager
 std::unique_ptr<BrokerSocketManager> CreateBrokerSocketManager()
 {
+#if RDMNET_HAVE_IO_URING
+  if (LinuxUringBrokerSocketManager::KernelSupported())
+    return std::unique_ptr<BrokerSocketManager>(new LinuxUringBrokerSocketManager);
+#endif
   return std::unique_ptr<BrokerSocketManager>(new LinuxBrokerSocketManager);
 }
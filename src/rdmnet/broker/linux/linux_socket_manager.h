@@ -24,6 +24,7 @@
 #ifndef LINUX_SOCKET_MANAGER_H_
 #define LINUX_SOCKET_MANAGER_H_
 
+#include <atomic>
 #include <map>
 #include <vector>
 #include <memory>
@@ -67,18 +68,27 @@ struct SocketData
     rc_msg_buf_init(&recv_buf);
   }
 
+  ~SocketData()
+  {
+    if (deferred)
+      rc_free_message_resources(&recv_buf.msg);
+  }
+
   BrokerClient::Handle client_handle{BrokerClient::kInvalidHandle};
   int                  socket{-1};
 
   // Receive buffer for socket recv operations
   RCMsgBuf recv_buf;
+  // Whether recv_buf.msg holds a message the notify handler asked to retry later. Reading from the
+  // socket is suspended until it has been handled.
+  bool deferred{false};
 };
 
 // A class to manage RDMnet Broker sockets on Linux.
-// This handles receiving data on all RDMnet client connections, using epoll for maximum
-// performance. Sending on connections is done in the core Broker library through the EtcPal
-// interface. Other miscellaneous Broker socket operations like LLRP are also handled in the core
-// library.
+// This handles accepting new connections and receiving data on all RDMnet client connections,
+// using epoll for maximum performance. Sending on connections is done in the core Broker library
+// through the EtcPal interface. Other miscellaneous Broker socket operations like LLRP are also
+// handled in the core library.
 class LinuxBrokerSocketManager : public BrokerSocketManager
 {
 public:
@@ -94,16 +104,23 @@ public:
   void SetNotify(BrokerSocketNotify* notify) override { notify_ = notify; }
   bool AddSocket(BrokerClient::Handle client_handle, etcpal_socket_t socket) override;
   void RemoveSocket(BrokerClient::Handle client_handle) override;
+  bool AddListenSocket(etcpal_socket_t listen_sock) override;
 
   // Callback functions called from worker threads
   void WorkerNotifySocketReadEvent(BrokerClient::Handle client_handle);
   void WorkerNotifySocketBad(BrokerClient::Handle client_handle);
+  void WorkerNotifyListenSocketReadEvent(int listen_sock);
+  void WorkerRetryDeferredMessages();
 
   // Accessors
   bool keep_running() const { return !shutting_down_; }
   int  epoll_fd() const { return epoll_fd_; }
+  bool has_deferred_messages() const { return has_deferred_; }
 
 private:
+  bool DeliverMessages(SocketData& sock_data);
+  void DeferSocket(SocketData& sock_data);
+
   bool      shutting_down_{false};
   pthread_t thread_handle_;
   int       epoll_fd_{-1};
@@ -113,6 +130,12 @@ private:
   std::map<BrokerClient::Handle, std::unique_ptr<SocketData>> sockets_;
   etcpal::Mutex                                               socket_lock_;
 
+  // Listening sockets on which the worker thread accepts new connections. Protected by socket_lock_.
+  std::vector<int> listen_sockets_;
+  // Sockets with a deferred message, to be retried by the worker thread. Protected by socket_lock_.
+  std::vector<BrokerClient::Handle> deferred_;
+  std::atomic<bool>                 has_deferred_{false};
+
   // The callback instance
   BrokerSocketNotify* notify_{nullptr};
 };
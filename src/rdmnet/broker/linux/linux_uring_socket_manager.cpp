@@ -0,0 +1,1120 @@
+/******************************************************************************
+ * Copyright 2020 ETC Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ ******************************************************************************
+ * This file is a part of RDMnet. For more information, go to:
+ * https://github.com/ETCLabs/RDMnet
+ *****************************************************************************/
+
+// io_uring is a pair of rings shared with the kernel: I/O requests are queued on one and their
+// completions are read from the other, so many operations on many sockets can be started and
+// collected with a single system call. With multishot receives, one request keeps receiving on a
+// socket until it is cancelled, taking a buffer from a ring of buffers registered with the kernel
+// for each completion.
+//
+// Further reading:
+// "man io_uring" from a Linux distribution command line
+// https://kernel.dk/io_uring.pdf
+
+#include "linux_uring_socket_manager.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <sys/types.h>
+#include <unistd.h>
+#include "etcpal/inet.h"
+#include "etcpal/timer.h"
+#include "rdmnet/core/message.h"
+
+// Size of the submission queues; the completion queues are kCompletionQueueSize.
+constexpr unsigned int kRingEntries = 256;
+constexpr unsigned int kCompletionQueueSize = 4096;
+
+constexpr int kWaitTimeout = 200;
+
+// How often messages deferred by the notify handler are retried.
+constexpr int kDeferredRetryInterval = 10;
+
+// How long to wait before accepting again on a listening socket that reported an error, e.g. when
+// out of file descriptors.
+constexpr uint32_t kAcceptRetryInterval = 200;
+
+// The registered receive buffers, shared by all sockets. The count must be a power of 2.
+constexpr uint16_t     kRecvBufGroup = 0;
+constexpr unsigned int kRecvBufCount = 1024;
+constexpr size_t       kRecvBufSize = 4096;
+
+// The send arena, allocated once and divided into slots which are queued per socket. A socket can
+// have at most kMaxSendSlotsPerSocket slots queued; beyond that, SendOnSocket() would block.
+constexpr unsigned int kSendSlotCount = 1024;
+constexpr size_t       kSendSlotSize = 4096;
+constexpr size_t       kMaxSendSlotsPerSocket = 16;
+
+// How long a socket removed with data still queued is kept open for the data to be sent.
+constexpr uint32_t kSendDrainTimeout = 1000;
+
+// The user data of each request identifies its operation in the top byte. Receives carry the
+// client handle and socket generation; accepts carry the listening socket; sends carry the slot.
+enum class Op : uint8_t
+{
+  kWake = 1,
+  kRecv,
+  kAccept,
+  kCancel,
+  kSend
+};
+
+constexpr uint32_t kGenerationMask = 0xffffffu;
+
+uint64_t MakeUserData(Op op, uint32_t id, uint32_t generation = 0)
+{
+  return (static_cast<uint64_t>(op) << 56) | (static_cast<uint64_t>(generation & kGenerationMask) << 32) | id;
+}
+
+Op UserDataOp(uint64_t user_data)
+{
+  return static_cast<Op>(user_data >> 56);
+}
+
+uint32_t UserDataId(uint64_t user_data)
+{
+  return static_cast<uint32_t>(user_data);
+}
+
+uint32_t UserDataGeneration(uint64_t user_data)
+{
+  return static_cast<uint32_t>(user_data >> 32) & kGenerationMask;
+}
+
+// Get a free submission queue entry, submitting the queue to make room if it is full.
+struct io_uring_sqe* GetSqe(struct io_uring* ring)
+{
+  struct io_uring_sqe* sqe = io_uring_get_sqe(ring);
+  if (!sqe)
+  {
+    io_uring_submit(ring);
+    sqe = io_uring_get_sqe(ring);
+  }
+  return sqe;
+}
+
+struct __kernel_timespec MsToTimespec(int ms)
+{
+  struct __kernel_timespec ts;
+  ts.tv_sec = ms / 1000;
+  ts.tv_nsec = static_cast<long long>(ms % 1000) * 1000000;
+  return ts;
+}
+
+etcpal_error_t SendErrorToEtcPal(int error)
+{
+  return ((error == EPIPE || error == ECONNRESET) ? kEtcPalErrConnReset : kEtcPalErrSys);
+}
+
+// Function for the worker thread which does all the socket reading.
+void* UringSocketWorkerThread(void* arg)
+{
+  LinuxUringBrokerSocketManager* sock_mgr = reinterpret_cast<LinuxUringBrokerSocketManager*>(arg);
+  if (!sock_mgr)
+    return reinterpret_cast<void*>(1);
+
+  sock_mgr->WorkerRun();
+  return reinterpret_cast<void*>(0);
+}
+
+LinuxUringBrokerSocketManager::~LinuxUringBrokerSocketManager()
+{
+  if (started_)
+    Shutdown();
+}
+
+// Probe for io_uring with provided buffer rings and multishot receives (Linux 6.0), by receiving a
+// byte on a socket pair.
+bool LinuxUringBrokerSocketManager::KernelSupported()
+{
+  struct io_uring        ring;
+  struct io_uring_params params;
+  memset(&params, 0, sizeof params);
+  if (io_uring_queue_init_params(8, &ring, &params) < 0)
+    return false;
+
+  bool supported = false;
+  int  buf_ring_res = 0;
+  auto buf_ring = ((params.features & IORING_FEAT_EXT_ARG) && (params.features & IORING_FEAT_NODROP))
+                      ? io_uring_setup_buf_ring(&ring, 2, kRecvBufGroup, 0, &buf_ring_res)
+                      : nullptr;
+
+  int sv[2];
+  if (buf_ring && socketpair(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0, sv) == 0)
+  {
+    uint8_t probe_bufs[2][16];
+    for (uint16_t i = 0; i < 2; ++i)
+      io_uring_buf_ring_add(buf_ring, probe_bufs[i], sizeof probe_bufs[i], i, io_uring_buf_ring_mask(2), i);
+    io_uring_buf_ring_advance(buf_ring, 2);
+
+    struct io_uring_sqe* sqe = io_uring_get_sqe(&ring);
+    io_uring_prep_recv_multishot(sqe, sv[0], nullptr, 0, 0);
+    sqe->flags |= IOSQE_BUFFER_SELECT;
+    sqe->buf_group = kRecvBufGroup;
+
+    struct io_uring_cqe*     cqe = nullptr;
+    struct __kernel_timespec ts = MsToTimespec(1000);
+    if (io_uring_submit(&ring) == 1 && write(sv[1], "x", 1) == 1 &&
+        io_uring_wait_cqe_timeout(&ring, &cqe, &ts) == 0)
+    {
+      supported = (cqe->res == 1 && (cqe->flags & IORING_CQE_F_MORE) && (cqe->flags & IORING_CQE_F_BUFFER));
+      io_uring_cqe_seen(&ring, cqe);
+    }
+
+    // Ending the receive before the buffers go out of scope
+    shutdown(sv[0], SHUT_RDWR);
+    if (io_uring_wait_cqe_timeout(&ring, &cqe, &ts) == 0)
+      io_uring_cqe_seen(&ring, cqe);
+    close(sv[0]);
+    close(sv[1]);
+  }
+
+  if (buf_ring)
+    io_uring_free_buf_ring(&ring, buf_ring, 2, kRecvBufGroup);
+  io_uring_queue_exit(&ring);
+  return supported;
+}
+
+bool LinuxUringBrokerSocketManager::Startup()
+{
+  struct io_uring_params params;
+  memset(&params, 0, sizeof params);
+  params.flags = IORING_SETUP_CQSIZE;
+  params.cq_entries = kCompletionQueueSize;
+
+  wake_fd_ = eventfd(0, EFD_CLOEXEC);
+  if (wake_fd_ < 0)
+    return false;
+
+  // The receive ring and its buffers
+  if (io_uring_queue_init_params(kRingEntries, &recv_ring_, &params) < 0)
+  {
+    ReleaseResources();
+    return false;
+  }
+  recv_ring_initted_ = true;
+
+  int buf_ring_res = 0;
+  recv_buf_ring_ = io_uring_setup_buf_ring(&recv_ring_, kRecvBufCount, kRecvBufGroup, 0, &buf_ring_res);
+  if (!recv_buf_ring_)
+  {
+    ReleaseResources();
+    return false;
+  }
+  recv_buf_mem_.reset(new uint8_t[kRecvBufCount * kRecvBufSize]);
+  for (unsigned int i = 0; i < kRecvBufCount; ++i)
+  {
+    io_uring_buf_ring_add(recv_buf_ring_, &recv_buf_mem_[i * kRecvBufSize], kRecvBufSize, static_cast<uint16_t>(i),
+                          io_uring_buf_ring_mask(kRecvBufCount), static_cast<int>(i));
+  }
+  io_uring_buf_ring_advance(recv_buf_ring_, kRecvBufCount);
+
+  // The send ring and its arena. The arena isn't registered with the kernel: fixed buffers can only
+  // be used by zero-copy sends, which cost more than a copy for messages the size of RDMnet's.
+  memset(&params, 0, sizeof params);
+  params.flags = IORING_SETUP_CQSIZE;
+  params.cq_entries = kCompletionQueueSize;
+  if (io_uring_queue_init_params(kRingEntries, &send_ring_, &params) < 0)
+  {
+    ReleaseResources();
+    return false;
+  }
+  send_ring_initted_ = true;
+
+  send_arena_.reset(new uint8_t[kSendSlotCount * kSendSlotSize]);
+
+  send_slots_.assign(kSendSlotCount, SendSlot{});
+  free_send_slots_.clear();
+  for (unsigned int i = kSendSlotCount; i > 0; --i)
+    free_send_slots_.push_back(static_cast<uint16_t>(i - 1));
+
+  // Wake() interrupts the worker thread's wait by completing a read on the eventfd, which the
+  // worker thread then re-arms.
+  struct io_uring_sqe* sqe = io_uring_get_sqe(&recv_ring_);
+  io_uring_prep_read(sqe, wake_fd_, &wake_value_, sizeof wake_value_, 0);
+  io_uring_sqe_set_data64(sqe, MakeUserData(Op::kWake, 0));
+
+  shutting_down_ = false;
+  if (0 != pthread_create(&thread_handle_, NULL, UringSocketWorkerThread, this))
+  {
+    ReleaseResources();
+    return false;
+  }
+
+  started_ = true;
+  return true;
+}
+
+bool LinuxUringBrokerSocketManager::Shutdown()
+{
+  if (!started_)
+    return true;
+
+  shutting_down_ = true;
+  Wake();
+
+  // Shutdown the worker thread
+  pthread_join(thread_handle_, NULL);
+  started_ = false;
+
+  {
+    etcpal::MutexGuard socket_guard(socket_lock_);
+    for (int listen_sock : listen_sockets_)
+      close(listen_sock);
+    listen_sockets_.clear();
+    listen_to_arm_.clear();
+    accept_retry_.clear();
+    to_arm_.clear();
+    starved_.clear();
+    deferred_.clear();
+    has_deferred_ = false;
+
+    // Send what has been queued, so that e.g. disconnect messages aren't lost. Every socket's data
+    // is sent at once, within one kSendDrainTimeout.
+    etcpal::MutexGuard send_guard(send_lock_);
+    uint32_t           deadline_ms = etcpal_getms() + kSendDrainTimeout;
+    for (auto& sock_data : sockets_)
+    {
+      if (!RDMNET_ASSERT_VERIFY(sock_data.second))
+        return false;
+
+      if (!CloseWhenSent(sock_data.first, deadline_ms))
+      {
+        shutdown(sock_data.second->socket, SHUT_RDWR);
+        close(sock_data.second->socket);
+      }
+    }
+    sockets_.clear();
+  }
+
+  WaitForClosingSends();
+  ReleaseResources();
+  return true;
+}
+
+bool LinuxUringBrokerSocketManager::AddSocket(BrokerClient::Handle client_handle, etcpal_socket_t socket)
+{
+  {  // Send lock scope
+    etcpal::MutexGuard send_guard(send_lock_);
+    ResetSendQueue(client_handle, socket);
+  }
+
+  {  // Lock scope
+    etcpal::MutexGuard socket_guard(socket_lock_);
+
+    // Create the data structure for the new socket
+    next_generation_ = (next_generation_ + 1) & kGenerationMask;
+    std::unique_ptr<UringSocketData> new_sock_data(new UringSocketData(client_handle, socket, next_generation_));
+    if (!new_sock_data || !sockets_.insert(std::make_pair(client_handle, std::move(new_sock_data))).second)
+      return false;
+
+    to_arm_.push_back(client_handle);
+  }
+
+  // New sockets are added on the worker thread, when it accepts them, but may also be added from
+  // other threads.
+  if (!pthread_equal(pthread_self(), thread_handle_))
+    Wake();
+  return true;
+}
+
+void LinuxUringBrokerSocketManager::RemoveSocket(BrokerClient::Handle client_handle)
+{
+  etcpal::MutexGuard socket_guard(socket_lock_);
+
+  auto sock_data = sockets_.find(client_handle);
+  if (sock_data != sockets_.end())
+  {
+    if (!RDMNET_ASSERT_VERIFY(sock_data->second))
+      return;
+
+    // The shutdown ends the socket's multishot receive; its completions are dropped, as they no
+    // longer match any socket.
+    int socket = sock_data->second->socket;
+    shutdown(socket, SHUT_RD);
+    for (const auto& chunk : sock_data->second->chunks)
+      RecycleRecvBuffer(chunk.buf_id);
+    sockets_.erase(sock_data);
+
+    // Data still queued for the socket is sent by FlushSends(), which then closes it; nothing waits
+    // for it here.
+    etcpal::MutexGuard send_guard(send_lock_);
+    if (!CloseWhenSent(client_handle, etcpal_getms() + kSendDrainTimeout))
+    {
+      shutdown(socket, SHUT_RDWR);
+      close(socket);
+    }
+  }
+}
+
+bool LinuxUringBrokerSocketManager::AddListenSocket(etcpal_socket_t listen_sock)
+{
+  {  // Lock scope
+    etcpal::MutexGuard socket_guard(socket_lock_);
+    listen_sockets_.push_back(listen_sock);
+    listen_to_arm_.push_back(listen_sock);
+  }
+
+  Wake();
+  return true;
+}
+
+void LinuxUringBrokerSocketManager::WorkerRun()
+{
+  std::vector<Completion>   completions;
+  std::vector<ClosedSocket> closed;
+
+  while (!shutting_down_)
+  {
+    uint32_t now_ms = etcpal_getms();
+    int      timeout = (has_deferred_ ? kDeferredRetryInterval : kWaitTimeout);
+    {  // Lock scope
+      etcpal::MutexGuard socket_guard(socket_lock_);
+      ArmPending(now_ms);
+      if (!accept_retry_.empty())
+      {
+        int32_t until_retry = static_cast<int32_t>(accept_retry_ms_ - now_ms);
+        timeout = std::max(std::min<int32_t>(timeout, until_retry), 1);
+      }
+    }
+
+    // Submits everything queued since the last pass and waits for completions in one call.
+    struct io_uring_cqe*     cqe = nullptr;
+    struct __kernel_timespec ts = MsToTimespec(timeout);
+    io_uring_submit_and_wait_timeout(&recv_ring_, &cqe, 1, &ts, nullptr);
+
+    // Copy the completions out so that the queue can be advanced before handling them; handling
+    // queues new requests.
+    completions.clear();
+    unsigned int head;
+    unsigned int num_seen = 0;
+    io_uring_for_each_cqe(&recv_ring_, head, cqe)
+    {
+      completions.push_back(Completion{cqe->user_data, cqe->res, cqe->flags});
+      ++num_seen;
+    }
+    io_uring_cq_advance(&recv_ring_, num_seen);
+
+    now_ms = etcpal_getms();
+    for (const auto& completion : completions)
+    {
+      switch (UserDataOp(completion.user_data))
+      {
+        case Op::kRecv: {
+          etcpal::MutexGuard socket_guard(socket_lock_);
+          HandleRecvCompletion(completion, closed);
+          break;
+        }
+        case Op::kAccept:
+          HandleAcceptCompletion(completion, now_ms);
+          break;
+        case Op::kWake: {
+          struct io_uring_sqe* sqe = GetSqe(&recv_ring_);
+          io_uring_prep_read(sqe, wake_fd_, &wake_value_, sizeof wake_value_, 0);
+          io_uring_sqe_set_data64(sqe, MakeUserData(Op::kWake, 0));
+          break;
+        }
+        case Op::kCancel:
+        default:
+          break;
+      }
+    }
+
+    if (has_deferred_ && !shutting_down_)
+    {
+      etcpal::MutexGuard socket_guard(socket_lock_);
+      RetryDeferredMessages(closed);
+    }
+
+    // Called without socket_lock_, like HandleNewConnection().
+    for (const auto& closed_socket : closed)
+    {
+      if (notify_)
+        notify_->HandleSocketClosed(closed_socket.client_handle, closed_socket.graceful);
+    }
+    closed.clear();
+  }
+}
+
+// Queue the requests for new sockets and listening sockets, and re-arm those that were stopped.
+// The lists are swapped out before they're walked, because ArmRecv() and ArmAccept() put back those
+// that couldn't be armed for want of a submission queue entry. Must be called with socket_lock_ held.
+void LinuxUringBrokerSocketManager::ArmPending(uint32_t now_ms)
+{
+  std::vector<BrokerClient::Handle> to_arm;
+  to_arm.swap(to_arm_);
+  for (auto client_handle : to_arm)
+  {
+    auto sock_data = sockets_.find(client_handle);
+    if (sock_data != sockets_.end() && !sock_data->second->deferred && !sock_data->second->recv_armed)
+      ArmRecv(*sock_data->second);
+  }
+
+  std::vector<int> listen_to_arm;
+  listen_to_arm.swap(listen_to_arm_);
+  for (int listen_sock : listen_to_arm)
+    ArmAccept(listen_sock);
+
+  if (!accept_retry_.empty() && static_cast<int32_t>(now_ms - accept_retry_ms_) >= 0)
+  {
+    std::vector<int> to_retry;
+    to_retry.swap(accept_retry_);
+    for (int listen_sock : to_retry)
+    {
+      if (std::find(listen_sockets_.begin(), listen_sockets_.end(), listen_sock) != listen_sockets_.end())
+        ArmAccept(listen_sock);
+    }
+  }
+}
+
+void LinuxUringBrokerSocketManager::ArmRecv(UringSocketData& sock_data)
+{
+  struct io_uring_sqe* sqe = GetSqe(&recv_ring_);
+  if (!sqe)
+  {
+    to_arm_.push_back(sock_data.client_handle);
+    return;
+  }
+
+  io_uring_prep_recv_multishot(sqe, sock_data.socket, nullptr, 0, 0);
+  sqe->flags |= IOSQE_BUFFER_SELECT;
+  sqe->buf_group = kRecvBufGroup;
+  io_uring_sqe_set_data64(sqe, MakeUserData(Op::kRecv, static_cast<uint32_t>(sock_data.client_handle),
+                                            sock_data.generation));
+  sock_data.recv_armed = true;
+}
+
+void LinuxUringBrokerSocketManager::ArmAccept(int listen_sock)
+{
+  struct io_uring_sqe* sqe = GetSqe(&recv_ring_);
+  if (!sqe)
+  {
+    listen_to_arm_.push_back(listen_sock);
+    return;
+  }
+
+  io_uring_prep_multishot_accept(sqe, listen_sock, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+  io_uring_sqe_set_data64(sqe, MakeUserData(Op::kAccept, static_cast<uint32_t>(listen_sock)));
+}
+
+// Must be called with socket_lock_ held.
+void LinuxUringBrokerSocketManager::HandleRecvCompletion(const Completion& completion,
+                                                         std::vector<ClosedSocket>& closed)
+{
+  bool     has_buffer = (completion.flags & IORING_CQE_F_BUFFER);
+  uint16_t buf_id = static_cast<uint16_t>(completion.flags >> IORING_CQE_BUFFER_SHIFT);
+
+  // The socket may have been removed, and its handle reused, since the receive was armed.
+  auto client_handle = static_cast<BrokerClient::Handle>(UserDataId(completion.user_data));
+  auto sock_data_iter = sockets_.find(client_handle);
+  if (sock_data_iter == sockets_.end() ||
+      sock_data_iter->second->generation != UserDataGeneration(completion.user_data))
+  {
+    if (has_buffer)
+      RecycleRecvBuffer(buf_id);
+    return;
+  }
+
+  UringSocketData& sock_data = *sock_data_iter->second;
+  if (!(completion.flags & IORING_CQE_F_MORE))
+    sock_data.recv_armed = false;
+
+  if (completion.res > 0 && has_buffer)
+  {
+    sock_data.chunks.push_back(UringRecvChunk{buf_id, static_cast<uint32_t>(completion.res), 0});
+    ConsumeChunks(sock_data, closed);
+
+    // The receive can end on its own, e.g. if the kernel runs short of memory.
+    auto still_open = sockets_.find(client_handle);
+    if (still_open != sockets_.end() && !sock_data.recv_armed && !sock_data.deferred)
+      to_arm_.push_back(client_handle);
+  }
+  else if (completion.res == -ENOBUFS)
+  {
+    // Every receive buffer is in use; re-armed once one is returned to the ring.
+    starved_.push_back(client_handle);
+  }
+  else if (completion.res == -ECANCELED)
+  {
+    // Cancelled by DeferSocket(); the retry may have already succeeded.
+    if (!sock_data.deferred)
+      to_arm_.push_back(client_handle);
+  }
+  else if (completion.res <= 0)
+  {
+    // The socket was closed, either gracefully or ungracefully.
+    if (has_buffer)
+      RecycleRecvBuffer(buf_id);
+    CloseSocket(client_handle, (completion.res == 0), closed);
+  }
+}
+
+void LinuxUringBrokerSocketManager::HandleAcceptCompletion(const Completion& completion, uint32_t now_ms)
+{
+  int listen_sock = static_cast<int>(UserDataId(completion.user_data));
+
+  if (!(completion.flags & IORING_CQE_F_MORE) && !shutting_down_)
+  {
+    etcpal::MutexGuard socket_guard(socket_lock_);
+    if (std::find(listen_sockets_.begin(), listen_sockets_.end(), listen_sock) != listen_sockets_.end())
+    {
+      // A connection that was reset while in the backlog doesn't affect the others. Anything else
+      // waits a while before accepting again.
+      if (completion.res >= 0 || completion.res == -ECONNABORTED || completion.res == -EINTR)
+      {
+        listen_to_arm_.push_back(listen_sock);
+      }
+      else
+      {
+        if (accept_retry_.empty())
+          accept_retry_ms_ = now_ms + kAcceptRetryInterval;
+        accept_retry_.push_back(listen_sock);
+      }
+    }
+  }
+
+  if (completion.res < 0)
+    return;
+
+  int new_sock = completion.res;
+
+  struct sockaddr_storage remote_addr;
+  socklen_t               remote_addr_len = sizeof remote_addr;
+  EtcPalSockAddr          addr{};
+  if (getpeername(new_sock, reinterpret_cast<struct sockaddr*>(&remote_addr), &remote_addr_len) == 0)
+    sockaddr_os_to_etcpal(reinterpret_cast<const etcpal_os_sockaddr_t*>(&remote_addr), &addr);
+
+  // Called without socket_lock_, as the handler adds the new socket.
+  if (!notify_ || !notify_->HandleNewConnection(new_sock, etcpal::SockAddr(addr)))
+    close(new_sock);
+}
+
+// Copy received data into a socket's message buffer and pass the messages parsed from it to the
+// notify handler, until the data runs out or the handler asks to retry a message later. Must be
+// called with socket_lock_ held.
+void LinuxUringBrokerSocketManager::ConsumeChunks(UringSocketData& sock_data, std::vector<ClosedSocket>& closed)
+{
+  while (!sock_data.deferred && !sock_data.chunks.empty())
+  {
+    if (!RDMNET_ASSERT_VERIFY(sock_data.recv_buf.cur_data_size <= RC_MSG_BUF_SIZE))
+      return;
+
+    // Taken in pieces no larger than the epoll socket manager receives, so that parsing can keep up.
+    UringRecvChunk& chunk = sock_data.chunks.front();
+    size_t          room = std::min<size_t>(RDMNET_RECV_DATA_MAX_SIZE,
+                                            RC_MSG_BUF_SIZE - sock_data.recv_buf.cur_data_size);
+    size_t          to_copy = std::min<size_t>(room, chunk.size - chunk.offset);
+    if (to_copy == 0)
+    {
+      // Nothing can be parsed from a full buffer.
+      CloseSocket(sock_data.client_handle, false, closed);
+      return;
+    }
+
+    memcpy(&sock_data.recv_buf.buf[sock_data.recv_buf.cur_data_size],
+           &recv_buf_mem_[chunk.buf_id * kRecvBufSize + chunk.offset], to_copy);
+    sock_data.recv_buf.cur_data_size += to_copy;
+    chunk.offset += static_cast<uint32_t>(to_copy);
+    if (chunk.offset == chunk.size)
+    {
+      RecycleRecvBuffer(chunk.buf_id);
+      sock_data.chunks.pop_front();
+    }
+
+    if (rc_msg_buf_parse_data(&sock_data.recv_buf) == kEtcPalErrOk && !DeliverMessages(sock_data))
+      DeferSocket(sock_data);
+  }
+}
+
+// Pass the parsed messages in a socket's receive buffer to the notify handler, starting with the
+// one already parsed. Returns false if the handler asked to retry a message later; that message is
+// left in the buffer. Must be called with socket_lock_ held.
+bool LinuxUringBrokerSocketManager::DeliverMessages(UringSocketData& sock_data)
+{
+  etcpal_error_t res = kEtcPalErrOk;
+  while (res == kEtcPalErrOk)
+  {
+    if (notify_ && notify_->HandleSocketMessageReceived(sock_data.client_handle, sock_data.recv_buf.msg) ==
+                       HandleMessageResult::kRetryLater)
+    {
+      return false;
+    }
+
+    rc_free_message_resources(&sock_data.recv_buf.msg);
+    res = rc_msg_buf_parse_data(&sock_data.recv_buf);
+  }
+  return true;
+}
+
+// Hold a socket's current message for RetryDeferredMessages(). The socket's receive is cancelled
+// until the message is handled, which throttles that TCP connection without holding up the worker
+// thread's other sockets, or tying up the shared receive buffers. Must be called with socket_lock_
+// held.
+void LinuxUringBrokerSocketManager::DeferSocket(UringSocketData& sock_data)
+{
+  if (sock_data.recv_armed)
+  {
+    struct io_uring_sqe* sqe = GetSqe(&recv_ring_);
+    if (sqe)
+    {
+      io_uring_prep_cancel64(sqe,
+                             MakeUserData(Op::kRecv, static_cast<uint32_t>(sock_data.client_handle),
+                                          sock_data.generation),
+                             0);
+      io_uring_sqe_set_data64(sqe, MakeUserData(Op::kCancel, 0));
+    }
+  }
+
+  sock_data.deferred = true;
+  deferred_.push_back(sock_data.client_handle);
+  has_deferred_ = true;
+}
+
+// Must be called with socket_lock_ held.
+void LinuxUringBrokerSocketManager::RetryDeferredMessages(std::vector<ClosedSocket>& closed)
+{
+  std::vector<BrokerClient::Handle> to_retry;
+  to_retry.swap(deferred_);
+  has_deferred_ = false;
+
+  for (auto client_handle : to_retry)
+  {
+    // The socket may have been closed, and its handle reused, since its message was deferred.
+    auto sock_data_iter = sockets_.find(client_handle);
+    if (sock_data_iter == sockets_.end() || !sock_data_iter->second->deferred)
+      continue;
+
+    UringSocketData& sock_data = *sock_data_iter->second;
+    sock_data.deferred = false;
+    if (!DeliverMessages(sock_data))
+    {
+      DeferSocket(sock_data);
+      continue;
+    }
+
+    // Then the data received before the receive was cancelled
+    ConsumeChunks(sock_data, closed);
+
+    // Resume receiving on the socket
+    auto still_open = sockets_.find(client_handle);
+    if (still_open != sockets_.end() && !sock_data.deferred && !sock_data.recv_armed)
+      ArmRecv(sock_data);
+  }
+}
+
+// Close a socket that was closed remotely or failed, to be reported to the notify handler once
+// socket_lock_ is released. Must be called with socket_lock_ held.
+void LinuxUringBrokerSocketManager::CloseSocket(BrokerClient::Handle       client_handle,
+                                                bool                       graceful,
+                                                std::vector<ClosedSocket>& closed)
+{
+  auto sock_data = sockets_.find(client_handle);
+  if (sock_data == sockets_.end())
+    return;
+
+  {  // Send lock scope
+    // Nothing more is sent on the socket from here, so the descriptor can be closed.
+    etcpal::MutexGuard send_guard(send_lock_);
+    auto               queue = send_queues_.find(client_handle);
+    if (queue != send_queues_.end())
+    {
+      DropSends(queue->second);
+      send_queues_.erase(queue);
+    }
+  }
+
+  shutdown(sock_data->second->socket, SHUT_RDWR);
+  close(sock_data->second->socket);
+  for (const auto& chunk : sock_data->second->chunks)
+    RecycleRecvBuffer(chunk.buf_id);
+  sockets_.erase(sock_data);
+
+  closed.push_back(ClosedSocket{client_handle, graceful});
+}
+
+// Return a receive buffer to the ring. Must be called with socket_lock_ held.
+void LinuxUringBrokerSocketManager::RecycleRecvBuffer(uint16_t buf_id)
+{
+  io_uring_buf_ring_add(recv_buf_ring_, &recv_buf_mem_[buf_id * kRecvBufSize], kRecvBufSize, buf_id,
+                        io_uring_buf_ring_mask(kRecvBufCount), 0);
+  io_uring_buf_ring_advance(recv_buf_ring_, 1);
+
+  if (!starved_.empty())
+  {
+    to_arm_.insert(to_arm_.end(), starved_.begin(), starved_.end());
+    starved_.clear();
+  }
+}
+
+int LinuxUringBrokerSocketManager::SendOnSocket(BrokerClient::Handle client_handle,
+                                                etcpal_socket_t      sock,
+                                                const uint8_t*       data,
+                                                size_t               size)
+{
+  etcpal::MutexGuard send_guard(send_lock_);
+
+  if (!send_ring_initted_)
+    return rc_send(sock, data, size, 0);
+  if (size == 0)
+    return 0;
+
+  auto queue_iter = send_queues_.find(client_handle);
+  if (queue_iter == send_queues_.end() || queue_iter->second.closing)
+    return kEtcPalErrConnClosed;
+
+  UringSendQueue& queue = queue_iter->second;
+  if (queue.error != 0)
+    return SendErrorToEtcPal(queue.error);
+
+  // Append to the last slot while it has room, then take new ones.
+  size_t taken = 0;
+  while (taken < size)
+  {
+    if (queue.slots.empty() || send_slots_[queue.slots.back()].size == kSendSlotSize)
+    {
+      if (queue.slots.size() >= kMaxSendSlotsPerSocket || free_send_slots_.empty())
+        break;
+
+      uint16_t slot_index = free_send_slots_.back();
+      free_send_slots_.pop_back();
+      send_slots_[slot_index] = SendSlot{};
+      send_slots_[slot_index].owner = client_handle;
+      queue.slots.push_back(slot_index);
+    }
+
+    SendSlot& slot = send_slots_[queue.slots.back()];
+    size_t    to_copy = std::min<size_t>(kSendSlotSize - slot.size, size - taken);
+    memcpy(&send_arena_[queue.slots.back() * kSendSlotSize + slot.size], &data[taken], to_copy);
+    slot.size += static_cast<uint32_t>(to_copy);
+    taken += to_copy;
+  }
+
+  if (taken == 0)
+    return kEtcPalErrWouldBlock;
+
+  if (!queue.ready && !send_slots_[queue.slots.front()].in_flight)
+  {
+    queue.ready = true;
+    ready_sends_.push_back(client_handle);
+  }
+  return static_cast<int>(taken);
+}
+
+bool LinuxUringBrokerSocketManager::FlushSends()
+{
+  etcpal::MutexGuard send_guard(send_lock_);
+
+  if (!send_ring_initted_)
+    return false;
+
+  bool progress = ReapSendCompletions();
+  progress |= SubmitReadySends();
+  FinishClosingSends(etcpal_getms());
+  return progress;
+}
+
+// Handle the sends that have finished, without waiting. Must be called with send_lock_ held.
+bool LinuxUringBrokerSocketManager::ReapSendCompletions()
+{
+  bool                 reaped = false;
+  struct io_uring_cqe* cqe = nullptr;
+  while (io_uring_peek_cqe(&send_ring_, &cqe) == 0 && cqe)
+  {
+    uint64_t user_data = cqe->user_data;
+    int      res = cqe->res;
+    io_uring_cqe_seen(&send_ring_, cqe);
+
+    if (UserDataOp(user_data) == Op::kSend)
+      HandleSendCompletion(static_cast<uint16_t>(UserDataId(user_data)), res);
+    reaped = true;
+  }
+  return reaped;
+}
+
+// Must be called with send_lock_ held.
+void LinuxUringBrokerSocketManager::HandleSendCompletion(uint16_t slot_index, int res)
+{
+  if (!RDMNET_ASSERT_VERIFY(slot_index < send_slots_.size()))
+    return;
+
+  SendSlot& slot = send_slots_[slot_index];
+  slot.in_flight = false;
+
+  // The queue was dropped while this was being sent.
+  auto queue_iter = send_queues_.find(slot.owner);
+  if (slot.owner == BrokerClient::kInvalidHandle || queue_iter == send_queues_.end() ||
+      queue_iter->second.slots.empty() || queue_iter->second.slots.front() != slot_index)
+  {
+    FreeSendSlot(slot_index);
+    return;
+  }
+
+  // Sends that didn't go through are submitted again. That includes a send waiting for room which
+  // was cancelled because the thread that submitted it exited, as the client service threads do
+  // before Shutdown().
+  UringSendQueue& queue = queue_iter->second;
+  if (res > 0)
+  {
+    slot.sent += static_cast<uint32_t>(res);
+    if (slot.sent == slot.size)
+    {
+      queue.slots.pop_front();
+      FreeSendSlot(slot_index);
+    }
+  }
+  else if (res != 0 && res != -EAGAIN && res != -EINTR && res != -ECANCELED)
+  {
+    FailSends(queue_iter->first, -res);
+    return;
+  }
+
+  if (!queue.slots.empty() && !queue.ready)
+  {
+    queue.ready = true;
+    ready_sends_.push_back(queue_iter->first);
+  }
+}
+
+// Submit the next send for each socket with data to send and no send in progress, all with one
+// system call. Must be called with send_lock_ held.
+bool LinuxUringBrokerSocketManager::SubmitReadySends()
+{
+  if (ready_sends_.empty())
+    return false;
+
+  for (auto client_handle : ready_sends_)
+  {
+    auto queue_iter = send_queues_.find(client_handle);
+    if (queue_iter == send_queues_.end())
+      continue;
+
+    queue_iter->second.ready = false;
+    PrepareSend(client_handle, queue_iter->second);
+  }
+  ready_sends_.clear();
+
+  io_uring_submit(&send_ring_);
+  return true;
+}
+
+// Must be called with send_lock_ held.
+void LinuxUringBrokerSocketManager::PrepareSend(BrokerClient::Handle client_handle, UringSendQueue& queue)
+{
+  if (queue.slots.empty() || queue.error != 0)
+    return;
+
+  uint16_t  slot_index = queue.slots.front();
+  SendSlot& slot = send_slots_[slot_index];
+  if (slot.in_flight)
+    return;
+
+  struct io_uring_sqe* sqe = GetSqe(&send_ring_);
+  if (!sqe)
+  {
+    // Tried again on the next flush
+    queue.ready = true;
+    ready_sends_.push_back(client_handle);
+    return;
+  }
+
+  io_uring_prep_send(sqe, queue.socket, &send_arena_[slot_index * kSendSlotSize + slot.sent], slot.size - slot.sent,
+                     MSG_NOSIGNAL);
+  io_uring_sqe_set_data64(sqe, MakeUserData(Op::kSend, slot_index));
+
+  slot.in_flight = true;
+}
+
+// Have a removed socket closed once the data queued for it has been sent, or at deadline_ms. Returns
+// false, having forgotten the queue, if there is nothing left to send; the caller then closes the
+// socket. Must be called with send_lock_ held.
+bool LinuxUringBrokerSocketManager::CloseWhenSent(BrokerClient::Handle client_handle, uint32_t deadline_ms)
+{
+  auto queue_iter = send_queues_.find(client_handle);
+  if (queue_iter == send_queues_.end())
+    return false;
+
+  UringSendQueue& queue = queue_iter->second;
+  if (queue.closing)
+    return true;
+  if (queue.slots.empty() || queue.error != 0)
+  {
+    DropSends(queue);
+    send_queues_.erase(queue_iter);
+    return false;
+  }
+
+  // The queue is already waiting to be submitted, or has a send in progress.
+  queue.closing = true;
+  queue.close_deadline_ms = deadline_ms;
+  ++num_closing_sends_;
+  return true;
+}
+
+// Close the removed sockets whose queued data has been sent, has failed to send, or has run out of
+// time. Returns whether any are still waiting. Must be called with send_lock_ held.
+bool LinuxUringBrokerSocketManager::FinishClosingSends(uint32_t now_ms)
+{
+  if (num_closing_sends_ == 0)
+    return false;
+
+  for (auto queue_iter = send_queues_.begin(); queue_iter != send_queues_.end();)
+  {
+    UringSendQueue& queue = queue_iter->second;
+    if (queue.closing && (queue.slots.empty() || queue.error != 0 ||
+                          static_cast<int32_t>(now_ms - queue.close_deadline_ms) >= 0))
+    {
+      DropSends(queue);
+      CloseQueueSocket(queue);
+      queue_iter = send_queues_.erase(queue_iter);
+    }
+    else
+    {
+      ++queue_iter;
+    }
+  }
+  return (num_closing_sends_ != 0);
+}
+
+// Must be called with send_lock_ held.
+void LinuxUringBrokerSocketManager::CloseQueueSocket(UringSendQueue& queue)
+{
+  if (!queue.closing)
+    return;
+
+  shutdown(queue.socket, SHUT_RDWR);
+  close(queue.socket);
+  queue.closing = false;
+  --num_closing_sends_;
+}
+
+// Free a queue's slots, leaving one that is being sent to be freed when the send completes. Must be
+// called with send_lock_ held.
+void LinuxUringBrokerSocketManager::DropSends(UringSendQueue& queue)
+{
+  for (auto slot_index : queue.slots)
+  {
+    if (send_slots_[slot_index].in_flight)
+      send_slots_[slot_index].owner = BrokerClient::kInvalidHandle;
+    else
+      FreeSendSlot(slot_index);
+  }
+  queue.slots.clear();
+}
+
+// Must be called with send_lock_ held.
+void LinuxUringBrokerSocketManager::FailSends(BrokerClient::Handle client_handle, int error)
+{
+  auto queue_iter = send_queues_.find(client_handle);
+  if (queue_iter != send_queues_.end())
+  {
+    DropSends(queue_iter->second);
+    queue_iter->second.error = error;
+  }
+}
+
+// Must be called with send_lock_ held.
+void LinuxUringBrokerSocketManager::FreeSendSlot(uint16_t slot_index)
+{
+  send_slots_[slot_index] = SendSlot{};
+  free_send_slots_.push_back(slot_index);
+}
+
+// Start a new queue for a socket, dropping what is left of any earlier one with the same handle.
+// Must be called with send_lock_ held.
+void LinuxUringBrokerSocketManager::ResetSendQueue(BrokerClient::Handle client_handle, int socket)
+{
+  if (!send_ring_initted_)
+    return;
+
+  UringSendQueue& queue = send_queues_[client_handle];
+  DropSends(queue);
+  CloseQueueSocket(queue);
+  queue.socket = socket;
+  queue.error = 0;
+}
+
+// Send the data queued for the sockets being closed, until it has all been sent or their deadlines
+// have passed. send_lock_ is only held to reap and submit, not while waiting for completions.
+void LinuxUringBrokerSocketManager::WaitForClosingSends()
+{
+  while (true)
+  {
+    {  // Send lock scope
+      etcpal::MutexGuard send_guard(send_lock_);
+      if (!send_ring_initted_)
+        return;
+
+      ReapSendCompletions();
+      SubmitReadySends();
+      if (!FinishClosingSends(etcpal_getms()))
+        return;
+    }
+
+    // The ring's descriptor is readable when it has completions, which this doesn't consume.
+    struct pollfd pfd;
+    pfd.fd = send_ring_.ring_fd;
+    pfd.events = POLLIN;
+    pfd.revents = 0;
+    poll(&pfd, 1, kDeferredRetryInterval);
+  }
+}
+
+void LinuxUringBrokerSocketManager::Wake()
+{
+  if (wake_fd_ >= 0)
+  {
+    uint64_t value = 1;
+    ssize_t  res = write(wake_fd_, &value, sizeof value);
+    ETCPAL_UNUSED_ARG(res);
+  }
+}
+
+void LinuxUringBrokerSocketManager::ReleaseResources()
+{
+  etcpal::MutexGuard send_guard(send_lock_);
+
+  if (recv_buf_ring_)
+  {
+    io_uring_free_buf_ring(&recv_ring_, recv_buf_ring_, kRecvBufCount, kRecvBufGroup);
+    recv_buf_ring_ = nullptr;
+  }
+  if (recv_ring_initted_)
+  {
+    io_uring_queue_exit(&recv_ring_);
+    recv_ring_initted_ = false;
+  }
+  if (send_ring_initted_)
+  {
+    io_uring_queue_exit(&send_ring_);
+    send_ring_initted_ = false;
+  }
+  send_queues_.clear();
+  ready_sends_.clear();
+  num_closing_sends_ = 0;
+
+  if (wake_fd_ >= 0)
+  {
+    close(wake_fd_);
+    wake_fd_ = -1;
+  }
+}
@@ -0,0 +1,231 @@
+/******************************************************************************
+ * Copyright 2020 ETC Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ ******************************************************************************
+ * This file is a part of RDMnet. For more information, go to:
+ * https://github.com/ETCLabs/RDMnet
+ *****************************************************************************/
+
+// Linux io_uring override of BrokerSocketManager.
+// Used in place of LinuxBrokerSocketManager when RDMnet is built with RDMNET_ENABLE_IO_URING and the
+// running kernel supports the io_uring features it needs; see CreateBrokerSocketManager().
+
+#ifndef LINUX_URING_SOCKET_MANAGER_H_
+#define LINUX_URING_SOCKET_MANAGER_H_
+
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <memory>
+#include <vector>
+#include <liburing.h>
+#include <pthread.h>
+
+#include "etcpal/cpp/mutex.h"
+#include "rdmnet/core/msg_buf.h"
+#include "broker_socket_manager.h"
+
+// Received data in one of the registered receive buffers, waiting to be copied into a socket's
+// message buffer.
+struct UringRecvChunk
+{
+  uint16_t buf_id;
+  uint32_t size;
+  uint32_t offset;
+};
+
+// The set of data allocated per-socket for receiving.
+struct UringSocketData
+{
+  UringSocketData(BrokerClient::Handle client_handle_in, etcpal_socket_t socket_in, uint32_t generation_in)
+      : client_handle(client_handle_in), socket(socket_in), generation(generation_in)
+  {
+    rc_msg_buf_init(&recv_buf);
+  }
+
+  ~UringSocketData()
+  {
+    if (deferred)
+      rc_free_message_resources(&recv_buf.msg);
+  }
+
+  BrokerClient::Handle client_handle{BrokerClient::kInvalidHandle};
+  int                  socket{-1};
+  // Tells completions for this socket apart from those for an earlier socket with the same handle.
+  uint32_t generation{0};
+
+  // Receive buffer for parsing messages
+  RCMsgBuf recv_buf;
+  // Whether recv_buf.msg holds a message the notify handler asked to retry later. No more data is
+  // taken from chunks until it has been handled.
+  bool deferred{false};
+  // Whether a multishot receive is armed on the socket.
+  bool recv_armed{false};
+  // Received data not yet copied to recv_buf, oldest first.
+  std::deque<UringRecvChunk> chunks;
+};
+
+// The data waiting to be sent on one socket, as a list of send slots. Only the first slot is ever
+// being sent.
+struct UringSendQueue
+{
+  int                  socket{-1};
+  std::deque<uint16_t> slots;
+  // Whether the queue is on the list of queues with data to submit.
+  bool ready{false};
+  // Set when sending has failed or the socket was closed remotely; nothing more is taken.
+  int error{0};
+  // Set when the socket has been removed with data still queued. The socket is closed once the data
+  // has been sent, or at close_deadline_ms.
+  bool     closing{false};
+  uint32_t close_deadline_ms{0};
+};
+
+// A class to manage RDMnet Broker sockets on Linux using io_uring.
+//
+// A single worker thread accepts new connections and receives on all RDMnet client connections.
+// Each connection has one multishot receive armed, which fills buffers from a ring of receive
+// buffers registered with the kernel, and one io_uring_enter() call collects the data received on
+// any number of connections. Listening sockets use multishot accepts in the same way.
+//
+// Sends are copied into a preallocated send arena by SendOnSocket() and submitted for all clients at
+// once by FlushSends(), which the client service threads call after each pass over the clients.
+// A socket removed with data still queued is left open until FlushSends() has sent the data.
+class LinuxUringBrokerSocketManager : public BrokerSocketManager
+{
+public:
+  LinuxUringBrokerSocketManager() = default;
+  virtual ~LinuxUringBrokerSocketManager();
+
+  // Whether the running kernel supports everything this socket manager uses.
+  static bool KernelSupported();
+
+  // BrokerSocketManager interface
+  bool Startup() override;
+  bool Shutdown() override;
+  void SetNotify(BrokerSocketNotify* notify) override { notify_ = notify; }
+  bool AddSocket(BrokerClient::Handle client_handle, etcpal_socket_t socket) override;
+  void RemoveSocket(BrokerClient::Handle client_handle) override;
+  bool AddListenSocket(etcpal_socket_t listen_sock) override;
+  int  SendOnSocket(BrokerClient::Handle client_handle,
+                    etcpal_socket_t      sock,
+                    const uint8_t*       data,
+                    size_t               size) override;
+  bool FlushSends() override;
+
+  // The worker thread's loop
+  void WorkerRun();
+
+private:
+  struct Completion
+  {
+    uint64_t user_data;
+    int32_t  res;
+    uint32_t flags;
+  };
+
+  struct ClosedSocket
+  {
+    BrokerClient::Handle client_handle;
+    bool                 graceful;
+  };
+
+  struct SendSlot
+  {
+    uint32_t             size{0};
+    uint32_t             sent{0};
+    BrokerClient::Handle owner{BrokerClient::kInvalidHandle};
+    bool                 in_flight{false};
+  };
+
+  // Receiving, on the worker thread
+  void ArmPending(uint32_t now_ms);
+  void ArmRecv(UringSocketData& sock_data);
+  void ArmAccept(int listen_sock);
+  void HandleRecvCompletion(const Completion& completion, std::vector<ClosedSocket>& closed);
+  void HandleAcceptCompletion(const Completion& completion, uint32_t now_ms);
+  void ConsumeChunks(UringSocketData& sock_data, std::vector<ClosedSocket>& closed);
+  bool DeliverMessages(UringSocketData& sock_data);
+  void DeferSocket(UringSocketData& sock_data);
+  void RetryDeferredMessages(std::vector<ClosedSocket>& closed);
+  void CloseSocket(BrokerClient::Handle client_handle, bool graceful, std::vector<ClosedSocket>& closed);
+  void RecycleRecvBuffer(uint16_t buf_id);
+
+  // Sending, with send_lock_ held
+  bool ReapSendCompletions();
+  void HandleSendCompletion(uint16_t slot_index, int res);
+  bool SubmitReadySends();
+  void PrepareSend(BrokerClient::Handle client_handle, UringSendQueue& queue);
+  bool CloseWhenSent(BrokerClient::Handle client_handle, uint32_t deadline_ms);
+  bool FinishClosingSends(uint32_t now_ms);
+  void CloseQueueSocket(UringSendQueue& queue);
+  void DropSends(UringSendQueue& queue);
+  void FailSends(BrokerClient::Handle client_handle, int error);
+  void FreeSendSlot(uint16_t slot_index);
+  void ResetSendQueue(BrokerClient::Handle client_handle, int socket);
+
+  void WaitForClosingSends();
+  void Wake();
+  void ReleaseResources();
+
+  std::atomic<bool> shutting_down_{false};
+  bool              started_{false};
+  pthread_t         thread_handle_;
+  int               wake_fd_{-1};
+  uint64_t          wake_value_{0};
+
+  // The receive ring, only used by the worker thread once it is started.
+  struct io_uring            recv_ring_;
+  bool                       recv_ring_initted_{false};
+  struct io_uring_buf_ring*  recv_buf_ring_{nullptr};
+  std::unique_ptr<uint8_t[]> recv_buf_mem_;
+
+  // The set of sockets being managed.
+  std::map<BrokerClient::Handle, std::unique_ptr<UringSocketData>> sockets_;
+  etcpal::Mutex                                                    socket_lock_;
+  uint32_t                                                         next_generation_{0};
+
+  // Handles of sockets whose multishot receive should be armed by the worker thread, and of those
+  // waiting for receive buffers to be returned to the ring. Protected by socket_lock_.
+  std::vector<BrokerClient::Handle> to_arm_;
+  std::vector<BrokerClient::Handle> starved_;
+  // Listening sockets on which the worker thread accepts new connections; those whose multishot
+  // accept should be armed; and those to re-arm after an error, at accept_retry_ms_. Protected by
+  // socket_lock_.
+  std::vector<int> listen_sockets_;
+  std::vector<int> listen_to_arm_;
+  std::vector<int> accept_retry_;
+  uint32_t         accept_retry_ms_{0};
+  // Sockets with a deferred message, to be retried by the worker thread. Protected by socket_lock_.
+  std::vector<BrokerClient::Handle> deferred_;
+  std::atomic<bool>                 has_deferred_{false};
+
+  // The send ring and everything to do with sending, protected by send_lock_. Taken after
+  // socket_lock_ where both are held.
+  etcpal::Mutex                                  send_lock_;
+  struct io_uring                                send_ring_;
+  bool                                           send_ring_initted_{false};
+  std::unique_ptr<uint8_t[]>                     send_arena_;
+  std::vector<SendSlot>                          send_slots_;
+  std::vector<uint16_t>                          free_send_slots_;
+  std::map<BrokerClient::Handle, UringSendQueue> send_queues_;
+  std::vector<BrokerClient::Handle>              ready_sends_;
+  size_t                                         num_closing_sends_{0};
+
+  // The callback instance
+  BrokerSocketNotify* notify_{nullptr};
+};
+
+#endif  // LINUX_URING_SOCKET_MANAGER_H_
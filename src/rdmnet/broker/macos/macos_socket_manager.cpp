@@ -218,7 +218,7 @@ void MacBrokerSocketManager::WorkerNotifySocketReadEvent(BrokerClient::Handle cl
         while (notify_->HandleSocketMessageReceived(client_handle, sock_data->recv_buf.msg) ==
                HandleMessageResult::kRetryLater)
         {
-          sleep(10);  // Sleep to avoid busy loop.
+          usleep(10000);  // Sleep 10 ms to avoid busy loop.
         }
       }
 
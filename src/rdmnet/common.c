@@ -22,6 +22,7 @@
 #include "etcpal/common.h"
 #include "etcpal/handle_manager.h"
 #include "rdmnet/common_priv.h"
+#include "rdmnet/core/callback_queue.h"
 #include "rdmnet/core/common.h"
 #include "rdmnet/core/opts.h"
 
@@ -149,6 +150,12 @@
 static bool            tick_thread_running;
 static etcpal_thread_t tick_thread;
 
+#if RC_QUEUE_CALLBACKS && RDMNET_CALLBACK_THREADS > 0
+static bool            callback_threads_running;
+static etcpal_thread_t callback_threads[RDMNET_CALLBACK_THREADS];
+static size_t          num_callback_threads;
+#endif
+
 #if !RDMNET_DYNAMIC_MEM
 #if RDMNET_MAX_CONTROLLERS
 ETCPAL_MEMPOOL_DEFINE(rdmnet_controllers, RdmnetController, RDMNET_MAX_CONTROLLERS);
@@ -174,6 +181,11 @@ static IntHandleManager handle_manager;
 /*********************** Private function prototypes *************************/
 
 static void rdmnet_tick_thread(void* arg);
+#if RC_QUEUE_CALLBACKS && RDMNET_CALLBACK_THREADS > 0
+static etcpal_error_t start_callback_threads(void);
+static void           stop_callback_threads(void);
+static void           rdmnet_callback_thread(void* arg);
+#endif
 
 static int           handle_compare(const EtcPalRbTree* self, const void* value_a, const void* value_b);
 static int           responder_compare(const EtcPalRbTree* self, const void* value_a, const void* value_b);
@@ -254,6 +266,18 @@ etcpal_error_t rdmnet_init(const EtcPalLogParams* log_params, const RdmnetNetint
   tick_thread_running = true;
   res = etcpal_thread_create(&tick_thread, &thread_params, rdmnet_tick_thread, NULL);
 
+#if RC_QUEUE_CALLBACKS && RDMNET_CALLBACK_THREADS > 0
+  if (res == kEtcPalErrOk)
+  {
+    res = start_callback_threads();
+    if (res != kEtcPalErrOk)
+    {
+      tick_thread_running = false;
+      etcpal_thread_join(&tick_thread);
+    }
+  }
+#endif
+
   if (res == kEtcPalErrOk)
   {
     etcpal_rbtree_init(&handles, handle_compare, node_alloc, node_dealloc);
@@ -274,14 +298,49 @@ etcpal_error_t rdmnet_init(const EtcPalLogParams* log_params, const RdmnetNetint
  */
 void rdmnet_deinit(void)
 {
+#if RC_QUEUE_CALLBACKS
+  // The tick thread could be waiting for room in a callback queue that is no longer being drained.
+  rc_callback_queue_close();
+#endif
+
   tick_thread_running = false;
   etcpal_thread_join(&tick_thread);
+#if RC_QUEUE_CALLBACKS && RDMNET_CALLBACK_THREADS > 0
+  stop_callback_threads();
+#endif
 
   rc_deinit();
 
   etcpal_rbtree_clear_with_cb(&handles, tree_clear_cb);
 }
 
+/**
+ * @brief Deliver callbacks that are waiting in the callback queue.
+ *
+ * Only needed when the library is built with #RDMNET_CALLBACK_QUEUE_SIZE nonzero and
+ * #RDMNET_CALLBACK_THREADS set to 0. Callbacks for broker connections and LLRP components are then
+ * queued by the library's thread, and the application must call this function from threads of its
+ * own to deliver them. Callbacks for any one client or LLRP component are delivered in order, and
+ * never from two threads at once; if another thread is already delivering callbacks, this function
+ * waits out the timeout and returns 0.
+ *
+ * @param[in] timeout_ms How long to wait for a callback to be queued if none are waiting, in
+ *                       milliseconds. 0 returns right away.
+ * @return The number of callbacks delivered. Always 0 if the library's callbacks aren't queued for
+ *         the application to deliver.
+ */
+size_t rdmnet_dispatch_callbacks(int timeout_ms)
+{
+#if RC_QUEUE_CALLBACKS && RDMNET_CALLBACK_THREADS == 0
+  if (!rc_initialized())
+    return 0;
+  return rc_callback_queue_dispatch(0, timeout_ms);
+#else
+  ETCPAL_UNUSED_ARG(timeout_ms);
+  return 0;
+#endif
+}
+
 // clang-format off
 static const char* kRptStatusCodeStrings[] =
 {
@@ -853,6 +912,51 @@ void rdmnet_tick_thread(void* arg)
   }
 }
 
+#if RC_QUEUE_CALLBACKS && RDMNET_CALLBACK_THREADS > 0
+etcpal_error_t start_callback_threads(void)
+{
+  EtcPalThreadParams thread_params;
+  thread_params.priority = RDMNET_TICK_THREAD_PRIORITY;
+  thread_params.stack_size = RDMNET_TICK_THREAD_STACK;
+  thread_params.thread_name = "RDMnet callback thread";
+  thread_params.platform_data = NULL;
+
+  callback_threads_running = true;
+  num_callback_threads = 0;
+
+  etcpal_error_t res = kEtcPalErrOk;
+  for (; num_callback_threads < RDMNET_CALLBACK_THREADS; ++num_callback_threads)
+  {
+    // Each thread drains the callback queue with its own index.
+    res = etcpal_thread_create(&callback_threads[num_callback_threads], &thread_params, rdmnet_callback_thread,
+                               (void*)(uintptr_t)num_callback_threads);
+    if (res != kEtcPalErrOk)
+      break;
+  }
+
+  if (res != kEtcPalErrOk)
+    stop_callback_threads();
+  return res;
+}
+
+void stop_callback_threads(void)
+{
+  callback_threads_running = false;
+  for (size_t i = 0; i < num_callback_threads; ++i)
+    etcpal_thread_join(&callback_threads[i]);
+  num_callback_threads = 0;
+}
+
+void rdmnet_callback_thread(void* arg)
+{
+  size_t shard = (size_t)(uintptr_t)arg;
+  while (callback_threads_running)
+  {
+    rc_callback_queue_dispatch(shard, 100);
+  }
+}
+#endif
+
 int handle_compare(const EtcPalRbTree* self, const void* value_a, const void* value_b)
 {
   ETCPAL_UNUSED_ARG(self);
@@ -87,7 +87,8 @@ static void handle_supported_parameters(RdmnetController*       controller,
 static void handle_device_info(RdmnetController*       controller,
                                const RdmCommandHeader* rdm_header,
                                RdmnetSyncRdmResponse*  response);
-static void handle_generic_label_query(char*                   label,
+static void handle_generic_label_query(RdmnetController*       controller,
+                                       char*                   label,
                                        const RdmCommandHeader* rdm_header,
                                        const uint8_t*          data,
                                        uint8_t                 data_len,
@@ -1281,16 +1282,17 @@ void handle_rdm_command_internally(RdmnetController*       controller,
         handle_device_info(controller, rdm_header, response);
         break;
       case E120_DEVICE_MODEL_DESCRIPTION:
-        handle_generic_label_query(rdm_data->device_model_description, rdm_header, data, data_len, response);
+        handle_generic_label_query(controller, rdm_data->device_model_description, rdm_header, data, data_len,
+                                   response);
         break;
       case E120_MANUFACTURER_LABEL:
-        handle_generic_label_query(rdm_data->manufacturer_label, rdm_header, data, data_len, response);
+        handle_generic_label_query(controller, rdm_data->manufacturer_label, rdm_header, data, data_len, response);
         break;
       case E120_DEVICE_LABEL:
-        handle_generic_label_query(rdm_data->device_label, rdm_header, data, data_len, response);
+        handle_generic_label_query(controller, rdm_data->device_label, rdm_header, data, data_len, response);
         break;
       case E120_SOFTWARE_VERSION_LABEL:
-        handle_generic_label_query(rdm_data->software_version_label, rdm_header, data, data_len, response);
+        handle_generic_label_query(controller, rdm_data->software_version_label, rdm_header, data, data_len, response);
         break;
       case E133_COMPONENT_SCOPE:
         handle_component_scope(controller, rdm_header, data, data_len, response);
@@ -1313,14 +1315,13 @@ void handle_supported_parameters(RdmnetController*       controller,
                                  const RdmCommandHeader* rdm_header,
                                  RdmnetSyncRdmResponse*  response)
 {
-  ETCPAL_UNUSED_ARG(controller);
   ETCPAL_UNUSED_ARG(rdm_header);
 
-  if (!RDMNET_ASSERT_VERIFY(response))
+  if (!RDMNET_ASSERT_VERIFY(controller) || !RDMNET_ASSERT_VERIFY(response))
     return;
 
   size_t   pd_len = NUM_INTERNAL_SUPPORTED_PARAMETERS * 2;
-  uint8_t* buf = rc_client_get_internal_response_buf(pd_len);
+  uint8_t* buf = rc_client_get_internal_response_buf(&controller->client, pd_len);
   if (!buf)
   {
     RDMNET_SYNC_SEND_RDM_NACK(response, kRdmNRHardwareFault);
@@ -1345,13 +1346,12 @@ void handle_device_info(RdmnetController*       controller,
                         const RdmCommandHeader* rdm_header,
                         RdmnetSyncRdmResponse*  response)
 {
-  ETCPAL_UNUSED_ARG(controller);
   ETCPAL_UNUSED_ARG(rdm_header);
 
-  if (!RDMNET_ASSERT_VERIFY(response))
+  if (!RDMNET_ASSERT_VERIFY(controller) || !RDMNET_ASSERT_VERIFY(response))
     return;
 
-  uint8_t* buf = rc_client_get_internal_response_buf(19);
+  uint8_t* buf = rc_client_get_internal_response_buf(&controller->client, 19);
   if (!buf)
   {
     RDMNET_SYNC_SEND_RDM_NACK(response, kRdmNRHardwareFault);
@@ -1381,19 +1381,23 @@ void handle_device_info(RdmnetController*       controller,
   RDMNET_SYNC_SEND_RDM_ACK(response, 19);
 }
 
-void handle_generic_label_query(char*                   label,
+void handle_generic_label_query(RdmnetController*       controller,
+                                char*                   label,
                                 const RdmCommandHeader* rdm_header,
                                 const uint8_t*          data,
                                 uint8_t                 data_len,
                                 RdmnetSyncRdmResponse*  response)
 {
-  if (!RDMNET_ASSERT_VERIFY(label) || !RDMNET_ASSERT_VERIFY(rdm_header) || !RDMNET_ASSERT_VERIFY(response))
+  if (!RDMNET_ASSERT_VERIFY(controller) || !RDMNET_ASSERT_VERIFY(label) || !RDMNET_ASSERT_VERIFY(rdm_header) ||
+      !RDMNET_ASSERT_VERIFY(response))
+  {
     return;
+  }
 
   if (rdm_header->command_class == kRdmCCGetCommand)
   {
     size_t   pd_len = strlen(label);
-    uint8_t* buf = rc_client_get_internal_response_buf(pd_len);
+    uint8_t* buf = rc_client_get_internal_response_buf(&controller->client, pd_len);
     if (!buf)
     {
       RDMNET_SYNC_SEND_RDM_NACK(response, kRdmNRHardwareFault);
@@ -1445,7 +1449,7 @@ void handle_component_scope(RdmnetController*       controller,
   if (!RDMNET_ASSERT_VERIFY(data))
     return;
 
-  uint8_t* buf = rc_client_get_internal_response_buf(COMPONENT_SCOPE_PD_SIZE);
+  uint8_t* buf = rc_client_get_internal_response_buf(&controller->client, COMPONENT_SCOPE_PD_SIZE);
   if (!buf)
   {
     RDMNET_SYNC_SEND_RDM_NACK(response, kRdmNRHardwareFault);
@@ -1553,7 +1557,7 @@ void handle_search_domain(RdmnetController*       controller,
   // This is a bit of a hack and relies on knowledge of how the client struct works.
   RCClient* client = &controller->client;
   size_t    pd_len = strlen(client->search_domain);
-  uint8_t*  buf = rc_client_get_internal_response_buf(pd_len);
+  uint8_t*  buf = rc_client_get_internal_response_buf(&controller->client, pd_len);
   if (!buf)
   {
     RDMNET_SYNC_SEND_RDM_NACK(response, kRdmNRHardwareFault);
@@ -1576,13 +1580,12 @@ void handle_identify_device(RdmnetController*       controller,
                             const RdmCommandHeader* rdm_header,
                             RdmnetSyncRdmResponse*  response)
 {
-  ETCPAL_UNUSED_ARG(controller);
   ETCPAL_UNUSED_ARG(rdm_header);
 
-  if (!RDMNET_ASSERT_VERIFY(response))
+  if (!RDMNET_ASSERT_VERIFY(controller) || !RDMNET_ASSERT_VERIFY(response))
     return;
 
-  uint8_t* buf = rc_client_get_internal_response_buf(1);
+  uint8_t* buf = rc_client_get_internal_response_buf(&controller->client, 1);
   if (!buf)
   {
     RDMNET_SYNC_SEND_RDM_NACK(response, kRdmNRHardwareFault);
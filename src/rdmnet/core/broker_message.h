@@ -106,6 +106,31 @@ typedef struct BrokerConnectReplyMsg
   RdmUid client_uid;
 } BrokerConnectReplyMsg;
 
+/**
+ * @brief Set a busy broker's hint of when a rejected client should reconnect.
+ *
+ * A broker that rejects a connect with kRdmnetConnectCapacityExceeded because it is temporarily
+ * busy, rather than full, can suggest how long the client should wait before reconnecting. The
+ * hint is carried in the Client UID field, which has no meaning in a rejected connect, as a UID with
+ * manufacturer ID 0 and the delay in milliseconds as its device ID. Clients unaware of the hint
+ * ignore the field.
+ *
+ * @param crmsgptr Pointer to BrokerConnectReplyMsg, with connect_status already set.
+ * @param retry_after_ms The suggested delay in milliseconds.
+ */
+#define BROKER_CONNECT_REPLY_SET_RETRY_AFTER(crmsgptr, retry_after_ms) \
+  ((crmsgptr)->client_uid.manu = 0, (crmsgptr)->client_uid.id = (uint32_t)(retry_after_ms))
+
+/**
+ * @brief Get a busy broker's hint of when a rejected client should reconnect.
+ * @param crmsgptr Pointer to BrokerConnectReplyMsg.
+ * @return (uint32_t) The suggested delay in milliseconds, or 0 if the reply has no hint.
+ */
+#define BROKER_CONNECT_REPLY_GET_RETRY_AFTER(crmsgptr)                                                   \
+  ((((crmsgptr)->connect_status == kRdmnetConnectCapacityExceeded) && ((crmsgptr)->client_uid.manu == 0)) \
+       ? (crmsgptr)->client_uid.id                                                                       \
+       : 0u)
+
 /** The Client Entry Update message in the broker protocol. */
 typedef struct BrokerClientEntryUpdateMsg
 {
@@ -329,6 +329,26 @@ size_t rc_broker_get_rpt_client_list_buffer_size(size_t num_client_entries)
   return (BROKER_PDU_FULL_HEADER_SIZE + RPT_CLIENT_LIST_SIZE(num_client_entries));
 }
 
+/**
+ * @brief Get the packed buffer size for a given EPT Client List.
+ * @param[in] client_entries Array of EPT Client Entries in the EPT Client List.
+ * @param[in] num_client_entries Size of client_entries array.
+ * @return Required buffer size, or 0 on error.
+ */
+size_t rc_broker_get_ept_client_list_buffer_size(const RdmnetEptClientEntry* client_entries, size_t num_client_entries)
+{
+  if (!client_entries)
+    return 0;
+
+  size_t res = BROKER_PDU_FULL_HEADER_SIZE;
+  for (const RdmnetEptClientEntry* cur_entry = client_entries; cur_entry < client_entries + num_client_entries;
+       ++cur_entry)
+  {
+    res += CLIENT_ENTRY_HEADER_SIZE + (cur_entry->num_protocols * EPT_PROTOCOL_ENTRY_SIZE);
+  }
+  return res;
+}
+
 /**
  * @brief Pack a Client List message containing RPT Client Entries into a buffer.
  *
@@ -422,14 +442,61 @@ size_t rc_broker_pack_ept_client_list(uint8_t*                    buf,
                                       const RdmnetEptClientEntry* client_entries,
                                       size_t                      num_client_entries)
 {
-  ETCPAL_UNUSED_ARG(buf);
-  ETCPAL_UNUSED_ARG(buflen);
-  ETCPAL_UNUSED_ARG(local_cid);
-  ETCPAL_UNUSED_ARG(vector);
-  ETCPAL_UNUSED_ARG(client_entries);
-  ETCPAL_UNUSED_ARG(num_client_entries);
-  // TODO
-  return 0;
+  if (!buf || buflen < BROKER_PDU_FULL_HEADER_SIZE || !local_cid || !client_entries || num_client_entries == 0 ||
+      (vector != VECTOR_BROKER_CONNECTED_CLIENT_LIST && vector != VECTOR_BROKER_CLIENT_ADD &&
+       vector != VECTOR_BROKER_CLIENT_REMOVE && vector != VECTOR_BROKER_CLIENT_ENTRY_CHANGE))
+  {
+    return 0;
+  }
+
+  AcnRootLayerPdu rlp;
+  rlp.sender_cid = *local_cid;
+  rlp.vector = ACN_VECTOR_ROOT_BROKER;
+  rlp.data_len = rc_broker_get_ept_client_list_buffer_size(client_entries, num_client_entries) -
+                 (ACN_RLP_HEADER_SIZE_EXT_LEN + ACN_TCP_PREAMBLE_SIZE);
+
+  uint8_t* cur_ptr = buf;
+  uint8_t* buf_end = buf + buflen;
+
+  // Try to pack all the header data
+  size_t data_size = pack_broker_header_with_rlp(&rlp, buf, buflen, vector);
+  if (data_size == 0)
+    return 0;
+  cur_ptr += data_size;
+
+  for (const RdmnetEptClientEntry* cur_entry = client_entries; cur_entry < client_entries + num_client_entries;
+       ++cur_entry)
+  {
+    size_t entry_size = CLIENT_ENTRY_HEADER_SIZE + (cur_entry->num_protocols * EPT_PROTOCOL_ENTRY_SIZE);
+
+    // Check bounds
+    if (cur_ptr + entry_size > buf_end || (!cur_entry->protocols && cur_entry->num_protocols != 0))
+      return 0;
+
+    // Pack the common client entry fields.
+    *cur_ptr = 0xf0;
+    ACN_PDU_PACK_EXT_LEN(cur_ptr, entry_size);
+    cur_ptr += 3;
+    etcpal_pack_u32b(cur_ptr, E133_CLIENT_PROTOCOL_EPT);
+    cur_ptr += 4;
+    memcpy(cur_ptr, cur_entry->cid.data, ETCPAL_UUID_BYTES);
+    cur_ptr += ETCPAL_UUID_BYTES;
+
+    // Pack the EPT Protocol Entries
+    const RdmnetEptSubProtocol* prot_end = cur_entry->protocols + cur_entry->num_protocols;
+    for (const RdmnetEptSubProtocol* prot = cur_entry->protocols; prot < prot_end; ++prot)
+    {
+      etcpal_pack_u16b(cur_ptr, prot->manufacturer_id);
+      cur_ptr += 2;
+      etcpal_pack_u16b(cur_ptr, prot->protocol_id);
+      cur_ptr += 2;
+      memset(cur_ptr, 0, EPT_PROTOCOL_STRING_PADDED_LENGTH);
+      if (prot->protocol_string)
+        rdmnet_safe_strncpy((char*)cur_ptr, prot->protocol_string, EPT_PROTOCOL_STRING_PADDED_LENGTH);
+      cur_ptr += EPT_PROTOCOL_STRING_PADDED_LENGTH;
+    }
+  }
+  return (size_t)(cur_ptr - buf);
 }
 
 /**************************** Request Dynamic UIDs ***************************/
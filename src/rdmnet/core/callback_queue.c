@@ -0,0 +1,421 @@
+/******************************************************************************
+ * Copyright 2020 ETC Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ ******************************************************************************
+ * This file is a part of RDMnet. For more information, go to:
+ * https://github.com/ETCLabs/RDMnet
+ *****************************************************************************/
+
+#include "rdmnet/core/callback_queue.h"
+
+#if RC_QUEUE_CALLBACKS
+
+#include <string.h>
+#include "etcpal/signal.h"
+#include "etcpal/thread.h"
+#include "rdmnet/core/opts.h"
+
+#if (RDMNET_CALLBACK_QUEUE_SIZE & (RDMNET_CALLBACK_QUEUE_SIZE - 1)) != 0
+#error "RDMNET_CALLBACK_QUEUE_SIZE must be a power of 2"
+#endif
+
+/*************************** Private constants *******************************/
+
+#define CELL_INDEX_MASK (RDMNET_CALLBACK_QUEUE_SIZE - 1)
+
+// How long a producer sleeps between attempts to find room in a full queue.
+#define PUSH_RETRY_INTERVAL_MS 1
+
+/***************************** Private macros ********************************/
+
+// Each cell of a queue has a sequence number which tells producers and the consumer whether it is
+// free or filled, so producers only contend on the enqueue position, with a compare-and-swap.
+#if defined(__GNUC__) || defined(__clang__)
+#define QUEUE_LOCK_FREE 1
+#define ATOMIC_LOAD(ptr) __atomic_load_n((ptr), __ATOMIC_SEQ_CST)
+#define ATOMIC_STORE(ptr, val) __atomic_store_n((ptr), (val), __ATOMIC_SEQ_CST)
+#define ATOMIC_EXCHANGE(ptr, val) __atomic_exchange_n((ptr), (val), __ATOMIC_SEQ_CST)
+#define ATOMIC_CAS(ptr, expected_ptr, desired) \
+  __atomic_compare_exchange_n((ptr), (expected_ptr), (desired), false, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST)
+#elif defined(_MSC_VER)
+#include <intrin.h>
+#define QUEUE_LOCK_FREE 1
+#define ATOMIC_LOAD(ptr) ((uint32_t)_InterlockedOr((volatile long*)(ptr), 0))
+#define ATOMIC_STORE(ptr, val) ((void)_InterlockedExchange((volatile long*)(ptr), (long)(val)))
+#define ATOMIC_EXCHANGE(ptr, val) ((uint32_t)_InterlockedExchange((volatile long*)(ptr), (long)(val)))
+#define ATOMIC_CAS(ptr, expected_ptr, desired) msvc_compare_exchange((ptr), (expected_ptr), (desired))
+#else
+// No atomics available; the same operations are done under the queue's mutex.
+#define QUEUE_LOCK_FREE 0
+#define ATOMIC_LOAD(ptr) (*(ptr))
+#define ATOMIC_STORE(ptr, val) (*(ptr) = (val))
+#define ATOMIC_EXCHANGE(ptr, val) plain_exchange((ptr), (val))
+#define ATOMIC_CAS(ptr, expected_ptr, desired) plain_compare_exchange((ptr), (expected_ptr), (desired))
+#endif
+
+#if QUEUE_LOCK_FREE
+#define QUEUE_LOCK(shard_ptr) true
+#define QUEUE_UNLOCK(shard_ptr)
+#else
+#include "etcpal/mutex.h"
+#define QUEUE_LOCK(shard_ptr) etcpal_mutex_lock(&(shard_ptr)->lock)
+#define QUEUE_UNLOCK(shard_ptr) etcpal_mutex_unlock(&(shard_ptr)->lock)
+#endif
+
+/***************************** Private types ********************************/
+
+typedef struct CallbackCell
+{
+  uint32_t         seq;
+  RCQueuedCallback callback;
+} CallbackCell;
+
+typedef struct CallbackShard
+{
+  CallbackCell cells[RDMNET_CALLBACK_QUEUE_SIZE];
+  uint32_t     enqueue_pos;
+  uint32_t     dequeue_pos;       // Only touched by the thread which has claimed the queue.
+  uint32_t     claimed;           // A thread is draining the queue.
+  uint32_t     consumer_waiting;  // The thread draining the queue is waiting on signal.
+
+  etcpal_signal_t signal;
+#if !QUEUE_LOCK_FREE
+  etcpal_mutex_t lock;
+#endif
+} CallbackShard;
+
+/**************************** Private variables ******************************/
+
+static CallbackShard shards[RC_CALLBACK_QUEUE_SHARDS];
+static uint32_t      closing;
+
+/*********************** Private function prototypes *************************/
+
+static bool           init_shard(CallbackShard* shard);
+static void           deinit_shard(CallbackShard* shard);
+static CallbackShard* get_shard(const void* obj);
+static bool           try_push(CallbackShard* shard, RCQueuedCallbackFn fn, void* obj, const void* data, size_t size);
+static bool           queue_empty(CallbackShard* shard);
+static uint32_t       exchange_flag(CallbackShard* shard, uint32_t* flag, uint32_t val);
+static size_t         dispatch_available(CallbackShard* shard, bool discard);
+
+#if defined(_MSC_VER) && !defined(__clang__)
+static bool msvc_compare_exchange(uint32_t* ptr, uint32_t* expected, uint32_t desired);
+#elif !QUEUE_LOCK_FREE
+static uint32_t plain_exchange(uint32_t* ptr, uint32_t val);
+static bool     plain_compare_exchange(uint32_t* ptr, uint32_t* expected, uint32_t desired);
+#endif
+
+/*************************** Function definitions ****************************/
+
+/*
+ * Initialize the RDMnet Core Callback Queue module. This function is called from rdmnet_init().
+ */
+etcpal_error_t rc_callback_queue_module_init(void)
+{
+  for (size_t i = 0; i < RC_CALLBACK_QUEUE_SHARDS; ++i)
+  {
+    if (!init_shard(&shards[i]))
+    {
+      while (i-- > 0)
+        deinit_shard(&shards[i]);
+      return kEtcPalErrSys;
+    }
+  }
+  ATOMIC_STORE(&closing, 0);
+  return kEtcPalErrOk;
+}
+
+/*
+ * Deinitialize the RDMnet Core Callback Queue module. Callbacks still queued are discarded. This
+ * function is called from rdmnet_deinit(), after any threads that drain the queues are joined and
+ * before the modules which push callbacks are deinitialized.
+ */
+void rc_callback_queue_module_deinit(void)
+{
+  for (CallbackShard* shard = shards; shard < shards + RC_CALLBACK_QUEUE_SHARDS; ++shard)
+  {
+    dispatch_available(shard, true);
+    deinit_shard(shard);
+  }
+}
+
+/*
+ * Queue a callback for obj, copying data_size bytes of event data into it. Returns false without
+ * waiting if the queue is full.
+ */
+bool rc_callback_queue_push(RCQueuedCallbackFn fn, void* obj, const void* data, size_t data_size)
+{
+  if (!RDMNET_ASSERT_VERIFY(fn) || !RDMNET_ASSERT_VERIFY(obj) || !RDMNET_ASSERT_VERIFY(data || data_size == 0) ||
+      !RDMNET_ASSERT_VERIFY(data_size <= RC_QUEUED_CALLBACK_DATA_SIZE))
+  {
+    return false;
+  }
+
+  return try_push(get_shard(obj), fn, obj, data, data_size);
+}
+
+/*
+ * Queue a callback for obj, waiting for room if the queue is full. Returns false if the queue was
+ * closed before there was room.
+ */
+bool rc_callback_queue_push_wait(RCQueuedCallbackFn fn, void* obj, const void* data, size_t data_size)
+{
+  if (!RDMNET_ASSERT_VERIFY(fn) || !RDMNET_ASSERT_VERIFY(obj) || !RDMNET_ASSERT_VERIFY(data || data_size == 0) ||
+      !RDMNET_ASSERT_VERIFY(data_size <= RC_QUEUED_CALLBACK_DATA_SIZE))
+  {
+    return false;
+  }
+
+  CallbackShard* shard = get_shard(obj);
+  while (!try_push(shard, fn, obj, data, data_size))
+  {
+    if (ATOMIC_LOAD(&closing))
+      return false;
+    etcpal_thread_sleep(PUSH_RETRY_INTERVAL_MS);
+  }
+  return true;
+}
+
+/*
+ * Stop any producers waiting for room in a queue, and keep any more from waiting. Called at the
+ * start of rdmnet_deinit(), in case the threads draining the queues have already stopped.
+ */
+void rc_callback_queue_close(void)
+{
+  ATOMIC_STORE(&closing, 1);
+}
+
+/*
+ * Deliver the callbacks waiting in one of the queues, waiting up to timeout_ms for one to be
+ * pushed if there are none. Returns the number of callbacks delivered. If another thread is
+ * already draining the queue, waits out the timeout and returns 0.
+ */
+size_t rc_callback_queue_dispatch(size_t shard_index, int timeout_ms)
+{
+  if (!RDMNET_ASSERT_VERIFY(shard_index < RC_CALLBACK_QUEUE_SHARDS))
+    return 0;
+
+  CallbackShard* shard = &shards[shard_index];
+
+  // Only one thread drains a queue at a time, which keeps each object's callbacks in order.
+  if (exchange_flag(shard, &shard->claimed, 1) != 0)
+  {
+    if (timeout_ms > 0)
+      etcpal_thread_sleep(timeout_ms);
+    return 0;
+  }
+
+  size_t num_dispatched = dispatch_available(shard, false);
+  if (num_dispatched == 0 && timeout_ms > 0)
+  {
+    // Producers only post the signal while the flag is set, so set it before the last check.
+    exchange_flag(shard, &shard->consumer_waiting, 1);
+    if (queue_empty(shard))
+    {
+#if ETCPAL_SIGNAL_HAS_TIMED_WAIT
+      etcpal_signal_timed_wait(&shard->signal, timeout_ms);
+#else
+      etcpal_thread_sleep(PUSH_RETRY_INTERVAL_MS);
+#endif
+    }
+    exchange_flag(shard, &shard->consumer_waiting, 0);
+    num_dispatched = dispatch_available(shard, false);
+  }
+
+  exchange_flag(shard, &shard->claimed, 0);
+  return num_dispatched;
+}
+
+bool init_shard(CallbackShard* shard)
+{
+  if (!RDMNET_ASSERT_VERIFY(shard))
+    return false;
+
+  memset(shard->cells, 0, sizeof(shard->cells));
+  for (uint32_t i = 0; i < RDMNET_CALLBACK_QUEUE_SIZE; ++i)
+    shard->cells[i].seq = i;
+  shard->enqueue_pos = 0;
+  shard->dequeue_pos = 0;
+  shard->claimed = 0;
+  shard->consumer_waiting = 0;
+
+  if (!etcpal_signal_create(&shard->signal))
+    return false;
+#if !QUEUE_LOCK_FREE
+  if (!etcpal_mutex_create(&shard->lock))
+  {
+    etcpal_signal_destroy(&shard->signal);
+    return false;
+  }
+#endif
+  return true;
+}
+
+void deinit_shard(CallbackShard* shard)
+{
+  if (!RDMNET_ASSERT_VERIFY(shard))
+    return;
+
+  etcpal_signal_destroy(&shard->signal);
+#if !QUEUE_LOCK_FREE
+  etcpal_mutex_destroy(&shard->lock);
+#endif
+}
+
+CallbackShard* get_shard(const void* obj)
+{
+  uintptr_t addr = (uintptr_t)obj;
+  return &shards[((addr >> 4) ^ (addr >> 16)) % RC_CALLBACK_QUEUE_SHARDS];
+}
+
+bool try_push(CallbackShard* shard, RCQueuedCallbackFn fn, void* obj, const void* data, size_t size)
+{
+  if (!RDMNET_ASSERT_VERIFY(shard))
+    return false;
+
+  if (!QUEUE_LOCK(shard))
+    return false;
+
+  // Claim the cell at the enqueue position. If its sequence number is behind the position, the
+  // consumer hasn't freed it yet and the queue is full; if it's ahead, another producer claimed it
+  // first.
+  CallbackCell* cell = NULL;
+  uint32_t      pos = ATOMIC_LOAD(&shard->enqueue_pos);
+  for (;;)
+  {
+    CallbackCell* candidate = &shard->cells[pos & CELL_INDEX_MASK];
+    int32_t       diff = (int32_t)(ATOMIC_LOAD(&candidate->seq) - pos);
+    if (diff == 0)
+    {
+      if (ATOMIC_CAS(&shard->enqueue_pos, &pos, pos + 1))
+      {
+        cell = candidate;
+        break;
+      }
+    }
+    else if (diff < 0)
+    {
+      break;
+    }
+    else
+    {
+      pos = ATOMIC_LOAD(&shard->enqueue_pos);
+    }
+  }
+
+  if (cell)
+  {
+    cell->callback.fn = fn;
+    cell->callback.obj = obj;
+    if (size > 0)
+      memcpy(cell->callback.data.bytes, data, size);
+
+    // Hand the cell to the consumer.
+    ATOMIC_STORE(&cell->seq, pos + 1);
+  }
+  bool wake_consumer = (cell && ATOMIC_EXCHANGE(&shard->consumer_waiting, 0) != 0);
+  QUEUE_UNLOCK(shard);
+
+  if (wake_consumer)
+    etcpal_signal_post(&shard->signal);
+  return (cell != NULL);
+}
+
+bool queue_empty(CallbackShard* shard)
+{
+  if (!RDMNET_ASSERT_VERIFY(shard))
+    return true;
+
+  bool empty = true;
+  if (QUEUE_LOCK(shard))
+  {
+    uint32_t pos = shard->dequeue_pos;
+    empty = (ATOMIC_LOAD(&shard->cells[pos & CELL_INDEX_MASK].seq) != pos + 1);
+    QUEUE_UNLOCK(shard);
+  }
+  return empty;
+}
+
+uint32_t exchange_flag(CallbackShard* shard, uint32_t* flag, uint32_t val)
+{
+  if (!RDMNET_ASSERT_VERIFY(shard) || !RDMNET_ASSERT_VERIFY(flag))
+    return val;
+
+  uint32_t prev = val;
+  if (QUEUE_LOCK(shard))
+  {
+    prev = ATOMIC_EXCHANGE(flag, val);
+    QUEUE_UNLOCK(shard);
+  }
+  return prev;
+}
+
+// Deliver (or discard) the callbacks in a queue, up to as many as it holds, so that a steady stream
+// of new ones can't keep the caller here indefinitely. Call with the queue claimed.
+size_t dispatch_available(CallbackShard* shard, bool discard)
+{
+  if (!RDMNET_ASSERT_VERIFY(shard))
+    return 0;
+
+  size_t num_dispatched = 0;
+  while (num_dispatched < RDMNET_CALLBACK_QUEUE_SIZE && !queue_empty(shard))
+  {
+    // The cell stays claimed while its callback runs; it's delivered in place rather than copied.
+    uint32_t      pos = shard->dequeue_pos;
+    CallbackCell* cell = &shard->cells[pos & CELL_INDEX_MASK];
+    if (RDMNET_ASSERT_VERIFY(cell->callback.fn))
+      cell->callback.fn(&cell->callback, discard);
+
+    if (QUEUE_LOCK(shard))
+    {
+      shard->dequeue_pos = pos + 1;
+      ATOMIC_STORE(&cell->seq, pos + RDMNET_CALLBACK_QUEUE_SIZE);
+      QUEUE_UNLOCK(shard);
+    }
+    ++num_dispatched;
+  }
+  return num_dispatched;
+}
+
+#if defined(_MSC_VER) && !defined(__clang__)
+bool msvc_compare_exchange(uint32_t* ptr, uint32_t* expected, uint32_t desired)
+{
+  long prev = _InterlockedCompareExchange((volatile long*)ptr, (long)desired, (long)*expected);
+  if ((uint32_t)prev == *expected)
+    return true;
+  *expected = (uint32_t)prev;
+  return false;
+}
+#elif !QUEUE_LOCK_FREE
+uint32_t plain_exchange(uint32_t* ptr, uint32_t val)
+{
+  uint32_t prev = *ptr;
+  *ptr = val;
+  return prev;
+}
+
+bool plain_compare_exchange(uint32_t* ptr, uint32_t* expected, uint32_t desired)
+{
+  if (*ptr == *expected)
+  {
+    *ptr = desired;
+    return true;
+  }
+  *expected = *ptr;
+  return false;
+}
+#endif
+
+#endif /* RC_QUEUE_CALLBACKS */
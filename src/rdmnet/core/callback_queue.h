@@ -0,0 +1,90 @@
+/******************************************************************************
+ * Copyright 2020 ETC Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ ******************************************************************************
+ * This file is a part of RDMnet. For more information, go to:
+ * https://github.com/ETCLabs/RDMnet
+ *****************************************************************************/
+
+/**
+ * @file rdmnet/core/callback_queue.h
+ * @brief Queues the callbacks for connections and LLRP components, to be delivered off the tick thread.
+ *
+ * Only compiled in if RDMNET_CALLBACK_QUEUE_SIZE is nonzero. There is one bounded multi-producer,
+ * single-consumer queue per callback thread (or just one, if the application delivers callbacks
+ * itself). The callbacks for any one object always go to the same queue, and only one thread
+ * drains a queue at a time, so they are delivered in the order they were pushed.
+ *
+ * Where the compiler provides atomic operations, pushing a callback takes no locks; otherwise each
+ * queue is guarded by a mutex.
+ */
+
+#ifndef RDMNET_CORE_CALLBACK_QUEUE_H_
+#define RDMNET_CORE_CALLBACK_QUEUE_H_
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "etcpal/error.h"
+#include "rdm/defs.h"
+#include "rdmnet/core/opts.h"
+
+#define RC_QUEUE_CALLBACKS (RDMNET_CALLBACK_QUEUE_SIZE > 0)
+
+#if RC_QUEUE_CALLBACKS
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define RC_CALLBACK_QUEUE_SHARDS (RDMNET_CALLBACK_THREADS > 0 ? RDMNET_CALLBACK_THREADS : 1)
+
+// Enough for any event, plus a copy of the RDM parameter data it refers to.
+#define RC_QUEUED_CALLBACK_DATA_SIZE (128 + RDM_MAX_PDL)
+
+typedef struct RCQueuedCallback RCQueuedCallback;
+
+// Delivers a queued callback, from the thread draining the queue. If discard is true, the callback
+// is not to be called; just release anything the queued event holds on to.
+typedef void (*RCQueuedCallbackFn)(RCQueuedCallback* callback, bool discard);
+
+struct RCQueuedCallback
+{
+  RCQueuedCallbackFn fn;
+  void*              obj;  // The object the callback is for. Callbacks for one object stay in order.
+  union
+  {
+    void*    align_ptr;
+    uint64_t align_u64;
+    double   align_double;
+    uint8_t  bytes[RC_QUEUED_CALLBACK_DATA_SIZE];
+  } data;  // A copy of the event data given when the callback was pushed.
+};
+
+etcpal_error_t rc_callback_queue_module_init(void);
+void           rc_callback_queue_module_deinit(void);
+
+bool rc_callback_queue_push(RCQueuedCallbackFn fn, void* obj, const void* data, size_t data_size);
+bool rc_callback_queue_push_wait(RCQueuedCallbackFn fn, void* obj, const void* data, size_t data_size);
+void rc_callback_queue_close(void);
+
+size_t rc_callback_queue_dispatch(size_t shard, int timeout_ms);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* RC_QUEUE_CALLBACKS */
+
+#endif /* RDMNET_CORE_CALLBACK_QUEUE_H_ */
@@ -31,6 +31,7 @@
 #include "rdmnet/core/broker_prot.h"
 #include "rdmnet/core/client_entry.h"
 #include "rdmnet/core/connection.h"
+#include "rdmnet/core/ept_prot.h"
 #include "rdmnet/core/rpt_prot.h"
 #include "rdmnet/core/util.h"
 #include "rdmnet/defs.h"
@@ -45,7 +46,6 @@ typedef struct SupportedParameter
 {
   uint16_t          pid;
   rpt_client_type_t client_type;
-  bool              found;
 } SupportedParameter;
 
 /*************************** Private constants *******************************/
@@ -54,30 +54,8 @@ typedef struct SupportedParameter
 
 #define RDM_RESP_BUF_STATIC_SIZE (RDMNET_PARSER_MAX_ACK_OVERFLOW_RESPONSES * RDM_MAX_PDL)
 
-// Calculation of the internal response buffer size
-
-// TODO change to defined value when it is available from the RDM library.
-#define TCP_COMMS_STATUS_PD_SIZE 87
-#define INTERNAL_PD_BUF_STATIC_SIZE (RDMNET_MAX_SCOPES_PER_CLIENT * TCP_COMMS_STATUS_PD_SIZE)
-
-#if E133_DOMAIN_STRING_PADDED_LENGTH > INTERNAL_PD_BUF_STATIC_SIZE
-#undef INTERNAL_PD_BUF_STATIC_SIZE
-#define INTERNAL_PD_BUF_STATIC_SIZE E133_DOMAIN_STRING_PADDED_LENGTH
-#endif
-
-#define ENDPOINT_RESPONDERS_BUF_SIZE ((RDMNET_MAX_RESPONDERS_PER_DEVICE * 6) + 6)
-#if ENDPOINT_RESPONDERS_BUF_SIZE > INTERNAL_PD_BUF_STATIC_SIZE
-#undef INTERNAL_PD_BUF_STATIC_SIZE
-#define INTERNAL_PD_BUF_STATIC_SIZE ENDPOINT_RESPONDERS_BUF_SIZE
-#endif
-
-#define ENDPOINT_LIST_BUF_SIZE ((RDMNET_MAX_ENDPOINTS_PER_DEVICE * 3) + 4)
-#if ENDPOINT_LIST_BUF_SIZE > INTERNAL_PD_BUF_STATIC_SIZE
-#undef INTERNAL_PD_BUF_STATIC_SIZE
-#define INTERNAL_PD_BUF_STATIC_SIZE ENDPOINT_LIST_BUF_SIZE
-#endif
-
 #define INTERNAL_PD_BUF_INITIAL_CAPACITY 32
+#define RESP_BUF_INITIAL_CAPACITY 4
 
 /***************************** Private macros ********************************/
 
@@ -123,11 +101,7 @@ typedef struct SupportedParameter
 /**************************** Private variables ******************************/
 
 #if !RDMNET_DYNAMIC_MEM
-static uint8_t internal_pd_buf[INTERNAL_PD_BUF_STATIC_SIZE];
 static uint8_t received_rdm_response_buf[RDM_RESP_BUF_STATIC_SIZE];
-#else
-static uint8_t* internal_pd_buf;
-size_t          internal_pd_buf_size;
 #endif
 
 static void monitorcb_broker_found(rdmnet_scope_monitor_t      handle,
@@ -183,20 +157,20 @@ static const RCLlrpTargetCallbacks kLlrpTargetCallbacks =
 
 // clang-format off
 // This list must be kept sorted by numeric value of PID.
-static SupportedParameter kSupportedParametersChecklist[] = {
-  {E120_SUPPORTED_PARAMETERS, kRPTClientTypeUnknown, false},
-  {E120_DEVICE_MODEL_DESCRIPTION, kRPTClientTypeUnknown, false},
-  {E120_MANUFACTURER_LABEL, kRPTClientTypeUnknown, false},
-  {E120_DEVICE_LABEL, kRPTClientTypeUnknown, false},
-  {E120_SOFTWARE_VERSION_LABEL, kRPTClientTypeUnknown, false},
-  {E133_COMPONENT_SCOPE, kRPTClientTypeUnknown, false},
-  {E133_SEARCH_DOMAIN, kRPTClientTypeUnknown, false},
-  {E133_TCP_COMMS_STATUS, kRPTClientTypeUnknown, false},
-  {E137_7_ENDPOINT_LIST, kRPTClientTypeDevice, false},
-  {E137_7_ENDPOINT_LIST_CHANGE, kRPTClientTypeDevice, false},
-  {E137_7_ENDPOINT_RESPONDERS, kRPTClientTypeDevice, false},
-  {E137_7_ENDPOINT_RESPONDER_LIST_CHANGE, kRPTClientTypeDevice, false},
-  {E120_IDENTIFY_DEVICE, kRPTClientTypeUnknown, false},
+static const SupportedParameter kSupportedParametersChecklist[] = {
+  {E120_SUPPORTED_PARAMETERS, kRPTClientTypeUnknown},
+  {E120_DEVICE_MODEL_DESCRIPTION, kRPTClientTypeUnknown},
+  {E120_MANUFACTURER_LABEL, kRPTClientTypeUnknown},
+  {E120_DEVICE_LABEL, kRPTClientTypeUnknown},
+  {E120_SOFTWARE_VERSION_LABEL, kRPTClientTypeUnknown},
+  {E133_COMPONENT_SCOPE, kRPTClientTypeUnknown},
+  {E133_SEARCH_DOMAIN, kRPTClientTypeUnknown},
+  {E133_TCP_COMMS_STATUS, kRPTClientTypeUnknown},
+  {E137_7_ENDPOINT_LIST, kRPTClientTypeDevice},
+  {E137_7_ENDPOINT_LIST_CHANGE, kRPTClientTypeDevice},
+  {E137_7_ENDPOINT_RESPONDERS, kRPTClientTypeDevice},
+  {E137_7_ENDPOINT_RESPONDER_LIST_CHANGE, kRPTClientTypeDevice},
+  {E120_IDENTIFY_DEVICE, kRPTClientTypeUnknown},
 };
 #define SUPPORTED_PARAMETERS_CHECKLIST_SIZE \
   (sizeof(kSupportedParametersChecklist) / sizeof(kSupportedParametersChecklist[0]))
@@ -217,12 +191,15 @@ static bool client_fully_destroyed(RCClient* client);
 
 static etcpal_error_t start_scope_discovery(RCClientScope* scope, const char* search_domain);
 static void           attempt_connection_on_listen_addrs(RCClientScope* scope);
+static size_t         num_parallel_listen_addrs(const RCClientScope* scope);
 static etcpal_error_t start_connection_for_scope(RCClientScope*              scope,
-                                                 const EtcPalSockAddr*       broker_addr,
+                                                 const EtcPalSockAddr*       broker_addrs,
+                                                 size_t                      num_broker_addrs,
                                                  rdmnet_disconnect_reason_t* disconnect_reason);
 static void           clear_discovered_broker_info(RCClientScope* scope);
 
 // Helpers for send functions
+static RdmBuffer*     get_resp_buf(RCClient* client, size_t num_buffers);
 static etcpal_error_t send_rdm_ack_internal(RCClient*               client,
                                             RCClientScope*          scope,
                                             const RptHeader*        rpt_header,
@@ -246,12 +223,13 @@ static etcpal_error_t client_send_update_internal(RCClient*               client
                                                   size_t                  data_len);
 
 // Some special functions for handling RDM responses from the application
-static void append_to_supported_parameters(RCClient*               client,
-                                           const RdmCommandHeader* received_cmd_header,
-                                           RdmBuffer*              param_resp_buf,
-                                           size_t                  param_num_buffers,
-                                           size_t*                 total_resp_size);
-static void change_destination_to_broadcast(RdmBuffer* resp_buf, size_t total_resp_size);
+static etcpal_error_t get_supported_parameters(RCClient*       client,
+                                               const uint8_t*  app_pids,
+                                               size_t          app_pids_len,
+                                               const uint8_t** pids,
+                                               size_t*         pids_len);
+static etcpal_error_t rebuild_supported_params_cache(RCClient* client, const uint8_t* app_pids, size_t app_pids_len);
+static void           change_destination_to_broadcast(RdmBuffer* resp_buf, size_t total_resp_size);
 
 // Manage callbacks
 static bool connect_failed_will_retry(rdmnet_connect_fail_event_t event, rdmnet_connect_status_t status);
@@ -266,10 +244,10 @@ static bool parse_rpt_message(const RCClientScope* scope, const RptMessage* rmsg
 static bool parse_rpt_request(const RptMessage* rmsg, RptClientMessage* msg_out);
 static bool parse_rpt_notification(const RCClientScope* scope, const RptMessage* rmsg, RptClientMessage* msg_out);
 static bool parse_rpt_status(const RptMessage* rmsg, RptClientMessage* msg_out);
-static bool unpack_notification_rdm_buffer(const RdmBuffer*   buffer,
-                                           RdmnetRdmResponse* resp,
-                                           uint8_t*           resp_data_buf,
-                                           bool*              is_first_resp);
+static bool unpack_notification_rdm_buffer(const RdmBuffer* buffer, RdmnetRdmResponse* resp, bool* is_first_resp);
+static bool fill_rdm_response_data(RdmnetRdmResponse* resp);
+static bool has_multiple_rdm_fragments(const RdmnetRdmResponse* resp);
+static bool rdm_response_data_is_recombined(const RdmnetRdmResponse* resp);
 static void send_rdm_response_if_requested(RCClient*               client,
                                            RCClientScope*          scope,
                                            const RptClientMessage* msg,
@@ -283,31 +261,18 @@ static bool handle_rdm_command_internally(RCClient*               client,
 static void handle_tcp_comms_status(RCClient* client, const RdmnetRdmCommand* cmd, RdmnetSyncRdmResponse* resp);
 
 // Memory for holding response data
-static bool get_rdm_response_data_buf(const RptRdmBufList* buf_list, uint8_t** buf_ptr);
+static bool get_rdm_response_data_buf(size_t size_needed, uint8_t** buf_ptr);
 static void free_rdm_response_data_buf(uint8_t* buf);
 
 /*************************** Function definitions ****************************/
 
 etcpal_error_t rc_client_module_init(void)
 {
-#if RDMNET_DYNAMIC_MEM
-  internal_pd_buf = (uint8_t*)malloc(INTERNAL_PD_BUF_INITIAL_CAPACITY);
-  if (internal_pd_buf)
-    internal_pd_buf_size = INTERNAL_PD_BUF_INITIAL_CAPACITY;
-  else
-    return kEtcPalErrNoMem;
-#endif
-
   return kEtcPalErrOk;
 }
 
 void rc_client_module_deinit(void)
 {
-#if RDMNET_DYNAMIC_MEM
-  if (internal_pd_buf)
-    free(internal_pd_buf);
-  internal_pd_buf_size = 0;
-#endif
 }
 
 /*
@@ -322,6 +287,16 @@ etcpal_error_t rc_rpt_client_register(RCClient* client, bool create_llrp_target)
     return kEtcPalErrSys;
 
   client->marked_for_destruction = false;
+  client->supported_params.valid = false;
+#if RDMNET_DYNAMIC_MEM
+  client->supported_params.pids = NULL;
+  client->resp_buf = NULL;
+  client->internal_pd_buf = NULL;
+#endif
+#if RC_QUEUE_CALLBACKS
+  if (!etcpal_mutex_create(&client->resp_lock))
+    return kEtcPalErrSys;
+#endif
 
   init_int_handle_manager(&client->scope_handle_manager, -1, scope_handle_in_use, client);
 #if RDMNET_DYNAMIC_MEM
@@ -343,6 +318,9 @@ etcpal_error_t rc_rpt_client_register(RCClient* client, bool create_llrp_target)
         (RC_RPT_CLIENT_DATA(client)->type == kRPTClientTypeController ? kLlrpCompRptController : kLlrpCompRptDevice);
     target->callbacks = kLlrpTargetCallbacks;
     target->lock = client->lock;
+#if RC_QUEUE_CALLBACKS
+    target->resp_lock = &client->resp_lock;
+#endif
 
     etcpal_error_t res = rc_llrp_target_register(&client->llrp_target);
     if (res == kEtcPalErrOk)
@@ -352,6 +330,9 @@ etcpal_error_t rc_rpt_client_register(RCClient* client, bool create_llrp_target)
     else
     {
       RC_CLIENT_DEINIT_SCOPES(client);
+#if RC_QUEUE_CALLBACKS
+      etcpal_mutex_destroy(&client->resp_lock);
+#endif
       return res;
     }
   }
@@ -421,7 +402,7 @@ etcpal_error_t rc_client_add_scope(RCClient*                client,
     if (ETCPAL_IP_IS_INVALID(&scope_config->static_broker_addr.ip))
       res = start_scope_discovery(new_entry, client->search_domain);
     else
-      res = start_connection_for_scope(new_entry, &new_entry->static_broker_addr, NULL);
+      res = start_connection_for_scope(new_entry, &new_entry->static_broker_addr, 1, NULL);
 
     if (res == kEtcPalErrOk)
     {
@@ -510,7 +491,7 @@ etcpal_error_t rc_client_change_scope(RCClient*                  client,
     else
     {
       // New scope is a static scope
-      res = start_connection_for_scope(scope, &new_scope_config->static_broker_addr, &disconnect_reason);
+      res = start_connection_for_scope(scope, &new_scope_config->static_broker_addr, 1, &disconnect_reason);
     }
   }
 
@@ -852,14 +833,18 @@ etcpal_error_t rc_client_send_ept_data(RCClient*             client,
                                        const uint8_t*        data,
                                        size_t                data_len)
 {
-  ETCPAL_UNUSED_ARG(client);
-  ETCPAL_UNUSED_ARG(scope_handle);
-  ETCPAL_UNUSED_ARG(dest_cid);
-  ETCPAL_UNUSED_ARG(manufacturer_id);
-  ETCPAL_UNUSED_ARG(protocol_id);
-  ETCPAL_UNUSED_ARG(data);
-  ETCPAL_UNUSED_ARG(data_len);
-  return kEtcPalErrNotImpl;
+  if (!RDMNET_ASSERT_VERIFY(client) || !RDMNET_ASSERT_VERIFY(dest_cid))
+    return kEtcPalErrSys;
+
+  if (client->type != kClientProtocolEPT || (!data && data_len != 0))
+    return kEtcPalErrInvalid;
+
+  CHECK_SCOPE_HANDLE(scope_handle);
+  RCClientScope* scope = get_scope(client, scope_handle);
+  if (!scope)
+    return kEtcPalErrNotFound;
+
+  return rc_ept_send_data(&scope->conn, &client->cid, dest_cid, manufacturer_id, protocol_id, data, data_len);
 }
 
 etcpal_error_t rc_client_send_ept_status(RCClient*             client,
@@ -868,43 +853,43 @@ etcpal_error_t rc_client_send_ept_status(RCClient*             client,
                                          ept_status_code_t     status_code,
                                          const char*           status_string)
 {
-  ETCPAL_UNUSED_ARG(client);
-  ETCPAL_UNUSED_ARG(scope_handle);
-  ETCPAL_UNUSED_ARG(dest_cid);
-  ETCPAL_UNUSED_ARG(status_code);
-  ETCPAL_UNUSED_ARG(status_string);
-  return kEtcPalErrNotImpl;
+  if (!RDMNET_ASSERT_VERIFY(client) || !RDMNET_ASSERT_VERIFY(dest_cid))
+    return kEtcPalErrSys;
+
+  if (client->type != kClientProtocolEPT)
+    return kEtcPalErrInvalid;
+
+  CHECK_SCOPE_HANDLE(scope_handle);
+  RCClientScope* scope = get_scope(client, scope_handle);
+  if (!scope)
+    return kEtcPalErrNotFound;
+
+  return rc_ept_send_status(&scope->conn, &client->cid, dest_cid, status_code, status_string);
 }
 
-uint8_t* rc_client_get_internal_response_buf(size_t size)
+/*
+ * Get the client's buffer for building response parameter data internally, making sure it can
+ * hold at least size bytes. The buffer is reused across responses; call this with the client lock
+ * held.
+ */
+uint8_t* rc_client_get_internal_response_buf(RCClient* client, size_t size)
 {
+  if (!RDMNET_ASSERT_VERIFY(client))
+    return NULL;
+
 #if RDMNET_DYNAMIC_MEM
-  if (size <= internal_pd_buf_size)
-  {
-    return internal_pd_buf;
-  }
-  else
+  if (!client->internal_pd_buf &&
+      !RC_INIT_BUF(client, uint8_t, internal_pd_buf, INTERNAL_PD_BUF_INITIAL_CAPACITY,
+                   RC_CLIENT_INTERNAL_PD_BUF_STATIC_SIZE))
   {
-    size_t new_size = internal_pd_buf_size;
-    while (new_size < size)
-      new_size *= 2;
-    uint8_t* new_buf = (uint8_t*)realloc(internal_pd_buf, new_size);
-    if (new_buf)
-    {
-      internal_pd_buf = new_buf;
-      return internal_pd_buf;
-    }
-    else
-    {
-      return NULL;
-    }
-  }
-#else
-  if (size <= INTERNAL_PD_BUF_STATIC_SIZE)
-    return internal_pd_buf;
-  else
     return NULL;
+  }
 #endif
+
+  client->num_internal_pd_buf = 0;
+  if (!RC_CHECK_BUF_CAPACITY(client, uint8_t, internal_pd_buf, RC_CLIENT_INTERNAL_PD_BUF_STATIC_SIZE, size))
+    return NULL;
+  return client->internal_pd_buf;
 }
 
 /******************************************************************************
@@ -1131,15 +1116,15 @@ void conncb_connect_failed(RCConnection* conn, const RCConnectFailedInfo* failed
       {
         if (scope->broker_found)
         {
-          // Attempt to connect on the next listen address.
-          if (++scope->current_listen_addr == scope->num_broker_listen_addrs)
-            scope->current_listen_addr = 0;
+          // Attempt to connect on the next listen address(es) after the one(s) that failed.
+          scope->current_listen_addr =
+              (scope->current_listen_addr + num_parallel_listen_addrs(scope)) % scope->num_broker_listen_addrs;
           attempt_connection_on_listen_addrs(scope);
         }
       }
       else
       {
-        if (kEtcPalErrOk != start_connection_for_scope(scope, &scope->static_broker_addr, false))
+        if (kEtcPalErrOk != start_connection_for_scope(scope, &scope->static_broker_addr, 1, NULL))
         {
           // Some fatal error while attempting to connect to the statically-configured address.
           cli_conn_failed_info.will_retry = false;
@@ -1205,7 +1190,7 @@ void conncb_disconnected(RCConnection* conn, const RCDisconnectedInfo* disconn_i
       }
       else
       {
-        if (kEtcPalErrOk != start_connection_for_scope(scope, &scope->static_broker_addr, false))
+        if (kEtcPalErrOk != start_connection_for_scope(scope, &scope->static_broker_addr, 1, NULL))
         {
           // Some fatal error while attempting to connect to the statically-configured address.
           cli_disconn_info.will_retry = false;
@@ -1274,16 +1259,19 @@ rc_message_action_t conncb_msg_received(RCConnection* conn, const RdmnetMessage*
           RdmnetSyncRdmResponse resp = RDMNET_SYNC_RDM_RESPONSE_INIT;
           bool                  use_internal_buf_for_response = false;
 
+          const RCRptClientData* rpt_client_data = RC_RPT_CLIENT_DATA(client);
+          if (!RDMNET_ASSERT_VERIFY(rpt_client_data))
+            return kRCMessageActionProcessNext;
+
+#if RC_QUEUE_CALLBACKS
+          etcpal_mutex_lock(&client->resp_lock);
+#endif
           if (handle_rdm_command_internally(client, scope, &client_msg, &resp))
           {
             use_internal_buf_for_response = true;
           }
           else
           {
-            const RCRptClientData* rpt_client_data = RC_RPT_CLIENT_DATA(client);
-            if (!RDMNET_ASSERT_VERIFY(rpt_client_data))
-              return kRCMessageActionProcessNext;
-
             rpt_client_data->callbacks.rpt_msg_received(client, scope->handle, &client_msg, &resp,
                                                         &use_internal_buf_for_response);
 
@@ -1291,6 +1279,9 @@ rc_message_action_t conncb_msg_received(RCConnection* conn, const RdmnetMessage*
               action = kRCMessageActionRetryLater;
           }
           send_rdm_response_if_requested(client, scope, &client_msg, &resp, use_internal_buf_for_response);
+#if RC_QUEUE_CALLBACKS
+          etcpal_mutex_unlock(&client->resp_lock);
+#endif
           free_rpt_client_message(&client_msg);
         }
       }
@@ -1302,7 +1293,48 @@ rc_message_action_t conncb_msg_received(RCConnection* conn, const RdmnetMessage*
       }
       break;
     case ACN_VECTOR_ROOT_EPT:
-      // TODO, for now fall through
+      if (client->type == kClientProtocolEPT)
+      {
+        const EptMessage* ept_msg = RDMNET_GET_EPT_MSG(message);
+        if (!RDMNET_ASSERT_VERIFY(ept_msg))
+          return kRCMessageActionProcessNext;
+
+        // The EPT Data payload still points into the connection's receive buffer, so it is passed
+        // through without copying.
+        EptClientMessage client_msg;
+        if (EPT_IS_DATA_MSG(ept_msg))
+        {
+          client_msg.type = kEptClientMsgData;
+          client_msg.payload.data = ept_msg->data.ept_data;
+        }
+        else if (EPT_IS_STATUS_MSG(ept_msg))
+        {
+          client_msg.type = kEptClientMsgStatus;
+          client_msg.payload.status = ept_msg->data.ept_status;
+        }
+        else
+        {
+          break;
+        }
+
+        const RCEptClientData* ept_client_data = RC_EPT_CLIENT_DATA(client);
+        if (!RDMNET_ASSERT_VERIFY(ept_client_data) || !ept_client_data->callbacks.msg_received)
+          return kRCMessageActionProcessNext;
+
+        RdmnetSyncRdmResponse resp = RDMNET_SYNC_RDM_RESPONSE_INIT;
+        bool                  use_internal_buf_for_response = false;
+        ept_client_data->callbacks.msg_received(client, scope->handle, &client_msg, &resp,
+                                                &use_internal_buf_for_response);
+        if (resp.response_action == kRdmnetRdmResponseActionRetryLater)
+          action = kRCMessageActionRetryLater;
+      }
+      else if (RDMNET_CAN_LOG(ETCPAL_LOG_WARNING))
+      {
+        char cid_str[ETCPAL_UUID_STRING_BYTES];
+        etcpal_uuid_to_string(&client->cid, cid_str);
+        RDMNET_LOG_WARNING("Incorrectly got EPT message for non-EPT client %s on scope %d", cid_str, scope->handle);
+      }
+      break;
     default:
       // RDMNET_LOG_WARNING("Got message with unhandled vector type %" PRIu32 " on scope %d", message->vector,
       // handle);
@@ -1400,7 +1432,10 @@ bool parse_rpt_notification(const RCClientScope* scope, const RptMessage* rmsg,
   memset(&resp->original_cmd_header, 0, sizeof(RdmCommandHeader));
   resp->original_cmd_data = NULL;
   resp->original_cmd_data_len = 0;
+  resp->rdm_data = NULL;
   resp->rdm_data_len = 0;
+  resp->rdm_fragments = NULL;
+  resp->num_rdm_fragments = 0;
 
   const RptRdmBufList* rdm_buf_list = RPT_GET_RDM_BUF_LIST(rmsg);
   if (!RDMNET_ASSERT_VERIFY(rdm_buf_list))
@@ -1412,20 +1447,24 @@ bool parse_rpt_notification(const RCClientScope* scope, const RptMessage* rmsg,
   if (!RDMNET_ASSERT_VERIFY(list) || !RDMNET_ASSERT_VERIFY(list->rdm_buffers))
     return false;
 
-  uint8_t* resp_data_buf = NULL;
-  if (!get_rdm_response_data_buf(list, &resp_data_buf))
-    return false;
-
-  // Initialize some values
-  resp->rdm_data = resp_data_buf;
-
-  bool good_parse = true;
-  bool first_msg = true;
+  bool   good_parse = true;
+  bool   first_msg = true;
+  size_t first_resp_index = 0;
   for (size_t i = 0; i < list->num_rdm_buffers; ++i)
   {
-    good_parse = unpack_notification_rdm_buffer(&list->rdm_buffers[i], resp, resp_data_buf, &first_msg);
+    good_parse = unpack_notification_rdm_buffer(&list->rdm_buffers[i], resp, &first_msg);
     if (!good_parse)
       break;
+    if (first_msg)
+      first_resp_index = i + 1;  // This buffer held the original command
+  }
+
+  if (good_parse)
+  {
+    // The data stays in the received buffers; the response references them as its fragments.
+    resp->rdm_fragments = &list->rdm_buffers[first_resp_index];
+    resp->num_rdm_fragments = list->num_rdm_buffers - first_resp_index;
+    good_parse = fill_rdm_response_data(resp);
   }
 
   if (good_parse)
@@ -1442,8 +1481,6 @@ bool parse_rpt_notification(const RCClientScope* scope, const RptMessage* rmsg,
   }
   else
   {
-    // Clean up
-    free_rpt_client_message(msg_out);
     return false;
   }
 }
@@ -1471,10 +1508,7 @@ bool parse_rpt_status(const RptMessage* rmsg, RptClientMessage* msg_out)
   return true;
 }
 
-bool unpack_notification_rdm_buffer(const RdmBuffer*   buffer,
-                                    RdmnetRdmResponse* resp,
-                                    uint8_t*           resp_data_buf,
-                                    bool*              is_first_resp)
+bool unpack_notification_rdm_buffer(const RdmBuffer* buffer, RdmnetRdmResponse* resp, bool* is_first_resp)
 {
   if (!RDMNET_ASSERT_VERIFY(buffer) || !RDMNET_ASSERT_VERIFY(resp) || !RDMNET_ASSERT_VERIFY(is_first_resp))
     return false;
@@ -1497,11 +1531,8 @@ bool unpack_notification_rdm_buffer(const RdmBuffer*   buffer,
         etcpal_error_t unpack_res = rdm_unpack_response(buffer, &resp->rdm_header, &this_data, &this_data_len);
         if (unpack_res == kEtcPalErrOk)
         {
-          if (this_data && this_data_len && RDMNET_ASSERT_VERIFY(resp_data_buf))
-          {
-            memcpy(&resp_data_buf[resp->rdm_data_len], this_data, this_data_len);
+          if (this_data)
             resp->rdm_data_len += this_data_len;
-          }
           *is_first_resp = false;
 
           if (resp->rdm_header.resp_type == kRdmResponseTypeAckOverflow)
@@ -1527,11 +1558,8 @@ bool unpack_notification_rdm_buffer(const RdmBuffer*   buffer,
         {
           return false;
         }
-        if (this_data && this_data_len && RDMNET_ASSERT_VERIFY(resp_data_buf))
-        {
-          memcpy(&resp_data_buf[resp->rdm_data_len], this_data, this_data_len);
+        if (this_data)
           resp->rdm_data_len += this_data_len;
-        }
         return true;
       }
     }
@@ -1539,6 +1567,57 @@ bool unpack_notification_rdm_buffer(const RdmBuffer*   buffer,
   return false;
 }
 
+// Points the response's contiguous data at its only non-empty fragment in place, or recombines
+// multiple fragments into a data buffer if RDMNET_RECOMBINE_RDM_RESPONSE_DATA is enabled.
+bool fill_rdm_response_data(RdmnetRdmResponse* resp)
+{
+  if (!RDMNET_ASSERT_VERIFY(resp))
+    return false;
+
+  if (!has_multiple_rdm_fragments(resp))
+  {
+    RdmnetRdmFragmentIter iter;
+    rdmnet_rdm_response_fragments_begin(resp, &iter);
+
+    const uint8_t* fragment;
+    size_t         fragment_len;
+    if (rdmnet_rdm_response_next_fragment(&iter, &fragment, &fragment_len))
+      resp->rdm_data = fragment;
+    return true;
+  }
+
+#if RDMNET_RECOMBINE_RDM_RESPONSE_DATA
+  uint8_t* resp_data_buf = NULL;
+  if (!get_rdm_response_data_buf(resp->rdm_data_len, &resp_data_buf))
+    return false;
+
+  rdmnet_rdm_response_copy_data(resp, resp_data_buf, resp->rdm_data_len);
+  resp->rdm_data = resp_data_buf;
+#endif
+  return true;
+}
+
+// Whether more than one of the response's fragments carries parameter data.
+bool has_multiple_rdm_fragments(const RdmnetRdmResponse* resp)
+{
+  if (!RDMNET_ASSERT_VERIFY(resp) || !resp->rdm_fragments)
+    return false;
+
+  size_t num_nonempty = 0;
+  for (size_t i = 0; i < resp->num_rdm_fragments; ++i)
+  {
+    if (resp->rdm_fragments[i].data[RDM_OFFSET_PARAM_DATA_LEN] != 0 && ++num_nonempty > 1)
+      return true;
+  }
+  return false;
+}
+
+// Whether the response data was gathered into a buffer obtained from get_rdm_response_data_buf().
+bool rdm_response_data_is_recombined(const RdmnetRdmResponse* resp)
+{
+  return (RDMNET_RECOMBINE_RDM_RESPONSE_DATA && has_multiple_rdm_fragments(resp));
+}
+
 void send_rdm_response_if_requested(RCClient*               client,
                                     RCClientScope*          scope,
                                     const RptClientMessage* msg,
@@ -1577,9 +1656,9 @@ void send_rdm_response_if_requested(RCClient*               client,
       header.dest_endpoint_id = E133_NULL_ENDPOINT;
       header.seqnum = received_cmd->seq_num;
 
+      const uint8_t* resp_data = (use_internal_buf ? client->internal_pd_buf : client->sync_resp_buf);
       res = send_rdm_ack_internal(client, scope, &header, &received_cmd->rdm_header, received_cmd->data,
-                                  received_cmd->data_len, use_internal_buf ? internal_pd_buf : client->sync_resp_buf,
-                                  resp->response_data.response_data_len);
+                                  received_cmd->data_len, resp_data, resp->response_data.response_data_len);
     }
     else if (resp->response_action == kRdmnetRdmResponseActionSendNack)
     {
@@ -1654,11 +1733,11 @@ void handle_tcp_comms_status(RCClient* client, const RdmnetRdmCommand* cmd, Rdmn
   if (cmd_header->command_class == kRdmCCGetCommand)
   {
 #if RDMNET_DYNAMIC_MEM
-    size_t pd_len = TCP_COMMS_STATUS_PD_SIZE * client->num_scopes;
+    size_t pd_len = RC_CLIENT_TCP_COMMS_STATUS_PD_SIZE * client->num_scopes;
 #else
-    size_t pd_len = TCP_COMMS_STATUS_PD_SIZE * RDMNET_MAX_SCOPES_PER_CLIENT;
+    size_t pd_len = RC_CLIENT_TCP_COMMS_STATUS_PD_SIZE * RDMNET_MAX_SCOPES_PER_CLIENT;
 #endif
-    uint8_t* buf = rc_client_get_internal_response_buf(pd_len);
+    uint8_t* buf = rc_client_get_internal_response_buf(client, pd_len);
     if (!buf)
     {
       RDMNET_SYNC_SEND_RDM_ACK(resp, kRdmNRHardwareFault);
@@ -1670,7 +1749,7 @@ void handle_tcp_comms_status(RCClient* client, const RdmnetRdmCommand* cmd, Rdmn
     {
       if (scope->handle == RDMNET_CLIENT_SCOPE_INVALID || scope->state == kRCScopeStateMarkedForDestruction)
       {
-        pd_len -= TCP_COMMS_STATUS_PD_SIZE;
+        pd_len -= RC_CLIENT_TCP_COMMS_STATUS_PD_SIZE;
         continue;
       }
 
@@ -1732,7 +1811,8 @@ void free_rpt_client_message(RptClientMessage* msg)
     if (!RDMNET_ASSERT_VERIFY(rdm_resp))
       return;
 
-    free_rdm_response_data_buf((uint8_t*)rdm_resp->rdm_data);
+    if (rdm_response_data_is_recombined(rdm_resp))
+      free_rdm_response_data_buf((uint8_t*)rdm_resp->rdm_data);
   }
 }
 
@@ -1762,7 +1842,7 @@ void llrpcb_rdm_cmd_received(RCLlrpTarget* target, const LlrpRdmCommand* cmd, RC
   rpt_client_data->callbacks.llrp_msg_received(client, cmd, &response->resp, &use_internal_buf_for_response);
 
   if (use_internal_buf_for_response)
-    response->response_buf = internal_pd_buf;
+    response->response_buf = client->internal_pd_buf;
   else
     response->response_buf = client->sync_resp_buf;
 }
@@ -2007,6 +2087,12 @@ bool client_fully_destroyed(RCClient* client)
   }
   END_FOR_EACH_CLIENT_SCOPE(client)
 
+#if RC_QUEUE_CALLBACKS
+  // All of the client's queued callbacks have been delivered by now.
+  if (fully_destroyed)
+    etcpal_mutex_destroy(&client->resp_lock);
+#endif
+
 #if RDMNET_DYNAMIC_MEM
   if (fully_destroyed)
   {
@@ -2020,6 +2106,24 @@ bool client_fully_destroyed(RCClient* client)
       free(client->scopes);
     }
     client->num_scopes = 0;
+
+    if (client->supported_params.pids)
+    {
+      free(client->supported_params.pids);
+      client->supported_params.pids = NULL;
+    }
+    client->supported_params.valid = false;
+
+    if (client->resp_buf)
+    {
+      free(client->resp_buf);
+      client->resp_buf = NULL;
+    }
+    if (client->internal_pd_buf)
+    {
+      free(client->internal_pd_buf);
+      client->internal_pd_buf = NULL;
+    }
   }
 #endif
   return fully_destroyed;
@@ -2067,14 +2171,19 @@ void attempt_connection_on_listen_addrs(RCClientScope* scope)
       etcpal_ip_to_string(&scope->broker_listen_addrs[listen_addr_index], addr_str);
     }
 
-    RDMNET_LOG_DEBUG("Attempting broker connection on scope '%s' at address %s:%d...", scope->id, addr_str,
-                     scope->port);
+    // With parallel connects, the addresses following this one are tried alongside it.
+    EtcPalSockAddr connect_addrs[RDMNET_CONN_PARALLEL_CONNECT_ADDRS];
+    size_t         num_connect_addrs = num_parallel_listen_addrs(scope);
+    for (size_t i = 0; i < num_connect_addrs; ++i)
+    {
+      connect_addrs[i].ip = scope->broker_listen_addrs[(listen_addr_index + i) % scope->num_broker_listen_addrs];
+      connect_addrs[i].port = scope->port;
+    }
 
-    EtcPalSockAddr connect_addr;
-    connect_addr.ip = scope->broker_listen_addrs[listen_addr_index];
-    connect_addr.port = scope->port;
+    RDMNET_LOG_DEBUG("Attempting broker connection on scope '%s' at address %s:%d%s...", scope->id, addr_str,
+                     scope->port, num_connect_addrs > 1 ? " (and others in parallel)" : "");
 
-    etcpal_error_t connect_res = start_connection_for_scope(scope, &connect_addr, false);
+    etcpal_error_t connect_res = start_connection_for_scope(scope, connect_addrs, num_connect_addrs, NULL);
     if (connect_res == kEtcPalErrOk)
     {
       scope->current_listen_addr = listen_addr_index;
@@ -2095,7 +2204,7 @@ void attempt_connection_on_listen_addrs(RCClientScope* scope)
         return;
 
       RDMNET_LOG_WARNING("Connection to broker for scope '%s' at address %s:%d failed with error: '%s'. %s", scope->id,
-                         addr_str, connect_addr.port, strerror,
+                         addr_str, scope->port, strerror,
                          scope->broker_found ? "Trying next address..." : "All addresses exhausted. Giving up.");
 
       if (!scope->broker_found)
@@ -2107,11 +2216,23 @@ void attempt_connection_on_listen_addrs(RCClientScope* scope)
   }
 }
 
+// How many of a discovered broker's listen addresses to connect to at once.
+size_t num_parallel_listen_addrs(const RCClientScope* scope)
+{
+  if (!RDMNET_ASSERT_VERIFY(scope))
+    return 1;
+
+  if (scope->num_broker_listen_addrs > RDMNET_CONN_PARALLEL_CONNECT_ADDRS)
+    return RDMNET_CONN_PARALLEL_CONNECT_ADDRS;
+  return (scope->num_broker_listen_addrs != 0 ? scope->num_broker_listen_addrs : 1);
+}
+
 etcpal_error_t start_connection_for_scope(RCClientScope*              scope,
-                                          const EtcPalSockAddr*       broker_addr,
+                                          const EtcPalSockAddr*       broker_addrs,
+                                          size_t                      num_broker_addrs,
                                           rdmnet_disconnect_reason_t* disconnect_reason)
 {
-  if (!RDMNET_ASSERT_VERIFY(scope) || !RDMNET_ASSERT_VERIFY(broker_addr))
+  if (!RDMNET_ASSERT_VERIFY(scope) || !RDMNET_ASSERT_VERIFY(broker_addrs) || !RDMNET_ASSERT_VERIFY(num_broker_addrs))
     return kEtcPalErrSys;
 
   BrokerClientConnectMsg connect_msg;
@@ -2149,8 +2270,20 @@ etcpal_error_t start_connection_for_scope(RCClientScope*              scope,
   }
   else
   {
-    // TODO EPT
-    return kEtcPalErrNotImpl;
+    RCEptClientData* ept_data = RC_EPT_CLIENT_DATA(client);
+    if (!RDMNET_ASSERT_VERIFY(ept_data))
+      return kEtcPalErrSys;
+
+    rdmnet_safe_strncpy(connect_msg.scope, scope->id, E133_SCOPE_STRING_PADDED_LENGTH);
+    connect_msg.e133_version = E133_VERSION;
+    rdmnet_safe_strncpy(connect_msg.search_domain, client->search_domain, E133_DOMAIN_STRING_PADDED_LENGTH);
+    connect_msg.connect_flags = 0;
+    connect_msg.client_entry.client_protocol = kClientProtocolEPT;
+    if (!rc_create_ept_client_entry(&client->cid, ept_data->protocols, ept_data->num_protocols,
+                                    GET_EPT_CLIENT_ENTRY(&connect_msg.client_entry)))
+    {
+      return kEtcPalErrInvalid;
+    }
   }
 
   etcpal_error_t res = kEtcPalErrOk;
@@ -2158,13 +2291,17 @@ etcpal_error_t start_connection_for_scope(RCClientScope*              scope,
   {
     // Scope was previously dynamic or inactive
     if (scope->state == kRCScopeStateDiscovery || scope->state == kRCScopeStateInactive)
-      res = rc_conn_connect(&scope->conn, broker_addr, &connect_msg);
+      res = rc_conn_connect(&scope->conn, broker_addrs, &connect_msg);
     else
-      res = rc_conn_reconnect(&scope->conn, broker_addr, &connect_msg, *disconnect_reason);
+      res = rc_conn_reconnect(&scope->conn, broker_addrs, &connect_msg, *disconnect_reason);
+  }
+  else if (num_broker_addrs > 1)
+  {
+    res = rc_conn_connect_parallel(&scope->conn, broker_addrs, num_broker_addrs, &connect_msg);
   }
   else
   {
-    res = rc_conn_connect(&scope->conn, broker_addr, &connect_msg);
+    res = rc_conn_connect(&scope->conn, broker_addrs, &connect_msg);
   }
   if (res == kEtcPalErrOk)
     scope->state = kRCScopeStateConnecting;
@@ -2190,6 +2327,29 @@ void clear_discovered_broker_info(RCClientScope* scope)
   scope->port = 0;
 }
 
+/*
+ * Get the client's RdmBuffer array for packing a response, making sure it can hold at least
+ * num_buffers buffers. The array is reused across sends; call this with the client lock held.
+ */
+RdmBuffer* get_resp_buf(RCClient* client, size_t num_buffers)
+{
+  if (!RDMNET_ASSERT_VERIFY(client))
+    return NULL;
+
+#if RDMNET_DYNAMIC_MEM
+  if (!client->resp_buf &&
+      !RC_INIT_BUF(client, RdmBuffer, resp_buf, RESP_BUF_INITIAL_CAPACITY, RC_CLIENT_STATIC_RESP_BUF_LEN))
+  {
+    return NULL;
+  }
+#endif
+
+  client->num_resp_buf = 0;
+  if (!RC_CHECK_BUF_CAPACITY(client, RdmBuffer, resp_buf, RC_CLIENT_STATIC_RESP_BUF_LEN, num_buffers))
+    return NULL;
+  return client->resp_buf;
+}
+
 etcpal_error_t send_rdm_ack_internal(RCClient*               client,
                                      RCClientScope*          scope,
                                      const RptHeader*        rpt_header,
@@ -2205,24 +2365,20 @@ etcpal_error_t send_rdm_ack_internal(RCClient*               client,
     return kEtcPalErrSys;
   }
 
+  if (received_cmd_header->param_id == E120_SUPPORTED_PARAMETERS)
+  {
+    etcpal_error_t sp_res = get_supported_parameters(client, resp_data, resp_data_len, &resp_data, &resp_data_len);
+    if (sp_res != kEtcPalErrOk)
+      return sp_res;
+  }
+
   // resp_size: The number of RDM command PDUs that make up the ACK or ACK_OVERFLOW response.
   // total_resp_size: resp_size + 1 more RDM command PDU for the original command.
-  // We allocate total_resp_size + 1, to account for potentially adding more parameter data right
-  // before sending.
   size_t     resp_size = rdm_get_num_responses_needed(received_cmd_header->param_id, resp_data_len);
   size_t     total_resp_size = resp_size + 1;
-  RdmBuffer* resp_buf = NULL;
-
-#if RDMNET_DYNAMIC_MEM
-  resp_buf = (RdmBuffer*)calloc(total_resp_size + 1, sizeof(RdmBuffer));
+  RdmBuffer* resp_buf = get_resp_buf(client, total_resp_size);
   if (!resp_buf)
-    return kEtcPalErrNoMem;
-#else
-  if (total_resp_size + 1 <= RC_CLIENT_STATIC_RESP_BUF_LEN)
-    resp_buf = client->resp_buf;
-  else
-    return kEtcPalErrMsgSize;
-#endif
+    return (RDMNET_DYNAMIC_MEM ? kEtcPalErrNoMem : kEtcPalErrMsgSize);
 
   etcpal_error_t res = rdm_pack_command(received_cmd_header, received_cmd_data, received_cmd_data_len, &resp_buf[0]);
 
@@ -2232,17 +2388,12 @@ etcpal_error_t send_rdm_ack_internal(RCClient*               client,
   }
   if (res == kEtcPalErrOk)
   {
-    if (received_cmd_header->param_id == E120_SUPPORTED_PARAMETERS)
-      append_to_supported_parameters(client, received_cmd_header, &resp_buf[1], resp_size, &total_resp_size);
     if (received_cmd_header->command_class == kRdmCCSetCommand)
       change_destination_to_broadcast(resp_buf, total_resp_size);
 
     res = rc_rpt_send_notification(&scope->conn, &client->cid, rpt_header, resp_buf, total_resp_size);
   }
 
-#if RDMNET_DYNAMIC_MEM
-  free(resp_buf);
-#endif
   return res;
 }
 
@@ -2260,14 +2411,9 @@ etcpal_error_t send_rdm_nack_internal(RCClient*               client,
     return kEtcPalErrSys;
   }
 
-  RdmBuffer* resp_buf = NULL;
-#if RDMNET_DYNAMIC_MEM
-  resp_buf = (RdmBuffer*)calloc(2, sizeof(RdmBuffer));
+  RdmBuffer* resp_buf = get_resp_buf(client, 2);
   if (!resp_buf)
-    return kEtcPalErrNoMem;
-#else
-  resp_buf = client->resp_buf;
-#endif
+    return (RDMNET_DYNAMIC_MEM ? kEtcPalErrNoMem : kEtcPalErrMsgSize);
 
   etcpal_error_t res = rdm_pack_command(received_cmd_header, received_cmd_data, received_cmd_data_len, &resp_buf[0]);
   if (res == kEtcPalErrOk)
@@ -2279,9 +2425,6 @@ etcpal_error_t send_rdm_nack_internal(RCClient*               client,
     res = rc_rpt_send_notification(&scope->conn, &client->cid, rpt_header, resp_buf, 2);
   }
 
-#if RDMNET_DYNAMIC_MEM
-  free(resp_buf);
-#endif
   return res;
 }
 
@@ -2295,22 +2438,18 @@ etcpal_error_t client_send_update_internal(RCClient*               client,
   if (!RDMNET_ASSERT_VERIFY(client) || !RDMNET_ASSERT_VERIFY(scope) || !RDMNET_ASSERT_VERIFY(source_addr))
     return kEtcPalErrSys;
 
+  if (param_id == E120_SUPPORTED_PARAMETERS)
+  {
+    etcpal_error_t sp_res = get_supported_parameters(client, data, data_len, &data, &data_len);
+    if (sp_res != kEtcPalErrOk)
+      return sp_res;
+  }
+
   // resp_size: The number of RDM command PDUs that make up the ACK or ACK_OVERFLOW response.
-  // We allocate resp_size + 1, to account for potentially adding more parameter data right
-  // before sending.
   size_t     resp_size = rdm_get_num_responses_needed(param_id, data_len);
-  RdmBuffer* resp_buf = NULL;
-
-#if RDMNET_DYNAMIC_MEM
-  resp_buf = (RdmBuffer*)calloc(resp_size + 1, sizeof(RdmBuffer));
+  RdmBuffer* resp_buf = get_resp_buf(client, resp_size);
   if (!resp_buf)
-    return kEtcPalErrNoMem;
-#else
-  if (resp_size <= RDMNET_MAX_SENT_ACK_OVERFLOW_RESPONSES)
-    resp_buf = client->resp_buf;
-  else
-    return kEtcPalErrMsgSize;
-#endif
+    return (RDMNET_DYNAMIC_MEM ? kEtcPalErrNoMem : kEtcPalErrMsgSize);
 
   RptHeader header;
   header.source_uid = scope->uid;
@@ -2332,9 +2471,6 @@ etcpal_error_t client_send_update_internal(RCClient*               client,
   etcpal_error_t res = rdm_pack_full_response(&fake_rdm_header, data, data_len, resp_buf, resp_size);
   if (res == kEtcPalErrOk)
   {
-    if (param_id == E120_SUPPORTED_PARAMETERS)
-      append_to_supported_parameters(client, &fake_rdm_header, resp_buf, resp_size, &resp_size);
-
     // Hack - need to add the destination broadcast UID in each response. This is needed here
     // because it's allowed in RDMnet but not RDM, so rdm_pack_full_response() will not work
     // otherwise.
@@ -2348,10 +2484,6 @@ etcpal_error_t client_send_update_internal(RCClient*               client,
     res = rc_rpt_send_notification(&scope->conn, &client->cid, &header, resp_buf, resp_size);
   }
 
-#if RDMNET_DYNAMIC_MEM
-  free(resp_buf);
-#endif
-
   return res;
 }
 
@@ -2365,89 +2497,92 @@ static int supported_param_compare(const void* a, const void* b)
   return (param_a->pid > param_b->pid) - (param_a->pid < param_b->pid);
 }
 
-void append_to_supported_parameters(RCClient*               client,
-                                    const RdmCommandHeader* received_cmd_header,
-                                    RdmBuffer*              param_resp_buf,
-                                    size_t                  param_num_buffers,
-                                    size_t*                 total_resp_size)
+/*
+ * Get the full PID list to send in a SUPPORTED_PARAMETERS response, given the PID list provided by
+ * the application. The result points into the client's cache and is valid while the client lock
+ * is held.
+ */
+etcpal_error_t get_supported_parameters(RCClient*       client,
+                                        const uint8_t*  app_pids,
+                                        size_t          app_pids_len,
+                                        const uint8_t** pids,
+                                        size_t*         pids_len)
 {
-  if (!RDMNET_ASSERT_VERIFY(client) || !RDMNET_ASSERT_VERIFY(received_cmd_header) ||
-      !RDMNET_ASSERT_VERIFY(param_resp_buf) || !RDMNET_ASSERT_VERIFY(param_num_buffers >= 1) ||
-      !RDMNET_ASSERT_VERIFY(total_resp_size) || !RDMNET_ASSERT_VERIFY(*total_resp_size >= 1))
-  {
-    return;
-  }
-
-  // Reset the checklist
-  for (SupportedParameter* param = kSupportedParametersChecklist;
-       param < kSupportedParametersChecklist + SUPPORTED_PARAMETERS_CHECKLIST_SIZE; ++param)
-  {
-    param->found = false;
-  }
+  if (!RDMNET_ASSERT_VERIFY(client) || !RDMNET_ASSERT_VERIFY(pids) || !RDMNET_ASSERT_VERIFY(pids_len))
+    return kEtcPalErrSys;
 
-  size_t num_params_found = 0;
+  const RCRptClientData* rpt_client_data = RC_RPT_CLIENT_DATA(client);
+  if (!RDMNET_ASSERT_VERIFY(rpt_client_data) || !RDMNET_ASSERT_VERIFY(app_pids || app_pids_len == 0))
+    return kEtcPalErrSys;
 
-  for (RdmBuffer* resp = param_resp_buf; resp < param_resp_buf + param_num_buffers; ++resp)
+  RCSupportedParamsCache* cache = &client->supported_params;
+  if (!cache->valid || cache->client_type != rpt_client_data->type || cache->app_pids_len != app_pids_len ||
+      (app_pids_len != 0 && memcmp(cache->pids, app_pids, app_pids_len) != 0))
   {
-    uint8_t* pd_ptr = &resp->data[RDM_OFFSET_PARAM_DATA];
-    while (pd_ptr < &resp->data[RDM_OFFSET_PARAM_DATA] + resp->data[RDM_OFFSET_PARAM_DATA_LEN])
-    {
-      uint16_t            pid = etcpal_unpack_u16b(pd_ptr);
-      SupportedParameter* param =
-          (SupportedParameter*)bsearch(&pid, kSupportedParametersChecklist, SUPPORTED_PARAMETERS_CHECKLIST_SIZE,
-                                       sizeof(SupportedParameter), supported_param_compare);
-      if (param)
-      {
-        ++num_params_found;
-        param->found = true;
-      }
-      pd_ptr += 2;
-    }
+    etcpal_error_t res = rebuild_supported_params_cache(client, app_pids, app_pids_len);
+    if (res != kEtcPalErrOk)
+      return res;
   }
 
-  RdmBuffer* last_resp = &param_resp_buf[param_num_buffers - 1];
-  uint8_t    last_resp_remaining_param_len = 230 - last_resp->data[RDM_OFFSET_PARAM_DATA_LEN];
+  *pids = cache->pids;
+  *pids_len = cache->num_pids;
+  return kEtcPalErrOk;
+}
 
-  uint8_t params_to_append_buf[SUPPORTED_PARAMETERS_CHECKLIST_SIZE * 2];
-  uint8_t params_to_append_size = 0;
+etcpal_error_t rebuild_supported_params_cache(RCClient* client, const uint8_t* app_pids, size_t app_pids_len)
+{
+  if (!RDMNET_ASSERT_VERIFY(client))
+    return kEtcPalErrSys;
 
   const RCRptClientData* rpt_client_data = RC_RPT_CLIENT_DATA(client);
   if (!RDMNET_ASSERT_VERIFY(rpt_client_data))
-    return;
+    return kEtcPalErrSys;
+
+  RCSupportedParamsCache* cache = &client->supported_params;
+  cache->valid = false;
+
+#if RDMNET_DYNAMIC_MEM
+  if (!cache->pids && !RC_INIT_BUF(cache, uint8_t, pids, RDM_MAX_PDL, RC_CLIENT_SUPPORTED_PARAMS_MAX_LEN))
+    return kEtcPalErrNoMem;
+#endif
 
-  for (SupportedParameter* current_param = kSupportedParametersChecklist;
-       current_param < kSupportedParametersChecklist + SUPPORTED_PARAMETERS_CHECKLIST_SIZE; ++current_param)
+  cache->num_pids = 0;
+  if (!RC_CHECK_BUF_CAPACITY(cache, uint8_t, pids, RC_CLIENT_SUPPORTED_PARAMS_MAX_LEN,
+                             app_pids_len + (SUPPORTED_PARAMETERS_CHECKLIST_SIZE * 2)))
   {
-    if (!current_param->found &&
-        (current_param->client_type == rpt_client_data->type || current_param->client_type == kRPTClientTypeUnknown))
-    {
-      etcpal_pack_u16b(&params_to_append_buf[params_to_append_size], current_param->pid);
-      params_to_append_size += 2;
-    }
+    return (RDMNET_DYNAMIC_MEM ? kEtcPalErrNoMem : kEtcPalErrMsgSize);
   }
 
-  if (params_to_append_size <= last_resp_remaining_param_len)
+  if (app_pids_len != 0)
+    memcpy(cache->pids, app_pids, app_pids_len);
+
+  bool found[SUPPORTED_PARAMETERS_CHECKLIST_SIZE] = {false};
+  for (const uint8_t* pd_ptr = app_pids; pd_ptr + 2 <= app_pids + app_pids_len; pd_ptr += 2)
   {
-    rdm_append_parameter_data(last_resp, params_to_append_buf, params_to_append_size);
+    uint16_t                  pid = etcpal_unpack_u16b(pd_ptr);
+    const SupportedParameter* param =
+        (const SupportedParameter*)bsearch(&pid, kSupportedParametersChecklist, SUPPORTED_PARAMETERS_CHECKLIST_SIZE,
+                                           sizeof(SupportedParameter), supported_param_compare);
+    if (param)
+      found[param - kSupportedParametersChecklist] = true;
   }
-  else
-  {
-    // We must split the additional parameters out into a new response.
-
-    // Append what we can
-    rdm_append_parameter_data(last_resp, params_to_append_buf, last_resp_remaining_param_len);
-    // Convert the last ACK to an ACK_OVERFLOW
-    last_resp->data[RDM_OFFSET_PORTID_RESPTYPE] = E120_RESPONSE_TYPE_ACK_OVERFLOW;
-    // Update checksum
-    uint8_t* checksum_offset = last_resp->data + RDM_OFFSET_PARAM_DATA + 230;
-    etcpal_pack_u16b(checksum_offset, etcpal_unpack_u16b(checksum_offset) + 3);
 
-    // Create a new response
-    RdmBuffer* new_resp = &param_resp_buf[param_num_buffers];
-    rdm_pack_response(received_cmd_header, 0, &params_to_append_buf[last_resp_remaining_param_len],
-                      params_to_append_size - last_resp_remaining_param_len, new_resp);
-    (*total_resp_size)++;
+  size_t pids_len = app_pids_len;
+  for (size_t i = 0; i < SUPPORTED_PARAMETERS_CHECKLIST_SIZE; ++i)
+  {
+    const SupportedParameter* param = &kSupportedParametersChecklist[i];
+    if (!found[i] && (param->client_type == rpt_client_data->type || param->client_type == kRPTClientTypeUnknown))
+    {
+      etcpal_pack_u16b(&cache->pids[pids_len], param->pid);
+      pids_len += 2;
+    }
   }
+
+  cache->num_pids = pids_len;
+  cache->app_pids_len = app_pids_len;
+  cache->client_type = rpt_client_data->type;
+  cache->valid = true;
+  return kEtcPalErrOk;
 }
 
 void change_destination_to_broadcast(RdmBuffer* resp_buf, size_t total_resp_size)
@@ -2468,19 +2603,11 @@ void change_destination_to_broadcast(RdmBuffer* resp_buf, size_t total_resp_size
   }
 }
 
-bool get_rdm_response_data_buf(const RptRdmBufList* buf_list, uint8_t** buf_ptr)
+bool get_rdm_response_data_buf(size_t size_needed, uint8_t** buf_ptr)
 {
-  if (!RDMNET_ASSERT_VERIFY(buf_list) || !RDMNET_ASSERT_VERIFY(buf_ptr))
+  if (!RDMNET_ASSERT_VERIFY(buf_ptr))
     return false;
 
-  size_t size_needed = 0;
-
-  for (const RdmBuffer* buf = buf_list->rdm_buffers; buf < buf_list->rdm_buffers + buf_list->num_rdm_buffers; ++buf)
-  {
-    if (RDM_CC_IS_NON_DISC_RESPONSE(buf->data[RDM_OFFSET_COMMAND_CLASS]))
-      size_needed += buf->data[RDM_OFFSET_PARAM_DATA_LEN];
-  }
-
   if (size_needed == 0)
   {
     *buf_ptr = NULL;
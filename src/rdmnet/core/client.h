@@ -255,6 +255,48 @@ typedef struct RCEptClientData
 #define RC_CLIENT_STATIC_RESP_BUF_LEN (RDMNET_MAX_SENT_ACK_OVERFLOW_RESPONSES + 2)
 #endif
 
+// Calculation of the internal response parameter data buffer size
+
+// TODO change to defined value when it is available from the RDM library.
+#define RC_CLIENT_TCP_COMMS_STATUS_PD_SIZE 87
+#define RC_CLIENT_INTERNAL_PD_BUF_STATIC_SIZE (RDMNET_MAX_SCOPES_PER_CLIENT * RC_CLIENT_TCP_COMMS_STATUS_PD_SIZE)
+
+#if E133_DOMAIN_STRING_PADDED_LENGTH > RC_CLIENT_INTERNAL_PD_BUF_STATIC_SIZE
+#undef RC_CLIENT_INTERNAL_PD_BUF_STATIC_SIZE
+#define RC_CLIENT_INTERNAL_PD_BUF_STATIC_SIZE E133_DOMAIN_STRING_PADDED_LENGTH
+#endif
+
+#define RC_CLIENT_ENDPOINT_RESPONDERS_PD_SIZE ((RDMNET_MAX_RESPONDERS_PER_DEVICE * 6) + 6)
+#if RC_CLIENT_ENDPOINT_RESPONDERS_PD_SIZE > RC_CLIENT_INTERNAL_PD_BUF_STATIC_SIZE
+#undef RC_CLIENT_INTERNAL_PD_BUF_STATIC_SIZE
+#define RC_CLIENT_INTERNAL_PD_BUF_STATIC_SIZE RC_CLIENT_ENDPOINT_RESPONDERS_PD_SIZE
+#endif
+
+#define RC_CLIENT_ENDPOINT_LIST_PD_SIZE ((RDMNET_MAX_ENDPOINTS_PER_DEVICE * 3) + 4)
+#if RC_CLIENT_ENDPOINT_LIST_PD_SIZE > RC_CLIENT_INTERNAL_PD_BUF_STATIC_SIZE
+#undef RC_CLIENT_INTERNAL_PD_BUF_STATIC_SIZE
+#define RC_CLIENT_INTERNAL_PD_BUF_STATIC_SIZE RC_CLIENT_ENDPOINT_LIST_PD_SIZE
+#endif
+
+// The longest merged SUPPORTED_PARAMETERS PID list a client caches in static memory mode: as much
+// as the application can send in an ACK/ACK_OVERFLOW, plus one more PDL for the PIDs the library
+// handles internally.
+#define RC_CLIENT_SUPPORTED_PARAMS_MAX_LEN ((RDMNET_MAX_SENT_ACK_OVERFLOW_RESPONSES + 1) * RDM_MAX_PDL)
+
+/*
+ * A cached SUPPORTED_PARAMETERS PID list for an RPT client. It contains the PID list most recently
+ * provided by the application, followed by the PIDs the library handles internally that the
+ * application did not list. It is rebuilt only when the application's PID list changes, and is
+ * protected by the client lock.
+ */
+typedef struct RCSupportedParamsCache
+{
+  bool              valid;
+  rpt_client_type_t client_type;
+  size_t            app_pids_len;
+  RC_DECLARE_BUF(uint8_t, pids, RC_CLIENT_SUPPORTED_PARAMS_MAX_LEN);
+} RCSupportedParamsCache;
+
 struct RCClient
 {
   /////////////////////////////////////////////////////////////////////////////
@@ -284,10 +326,21 @@ struct RCClient
   RCClientScope scopes[RDMNET_MAX_SCOPES_PER_CLIENT];
 #endif
 
-#if !RDMNET_DYNAMIC_MEM
-  RdmBuffer resp_buf[RC_CLIENT_STATIC_RESP_BUF_LEN];
+  // Scratch buffers for building responses, reused across sends. These are protected by the client
+  // lock; in dynamic memory mode they are allocated on first use and grown as needed.
+  RC_DECLARE_BUF(RdmBuffer, resp_buf, RC_CLIENT_STATIC_RESP_BUF_LEN);
+  RC_DECLARE_BUF(uint8_t, internal_pd_buf, RC_CLIENT_INTERNAL_PD_BUF_STATIC_SIZE);
+
+#if RC_QUEUE_CALLBACKS
+  // The callbacks for the client's connections and its LLRP target may be delivered on different
+  // threads, but they share internal_pd_buf and sync_resp_buf. This is held from the callback that
+  // fills in a synchronous RDM response until the response is sent. It is never taken with the
+  // client lock held.
+  etcpal_mutex_t resp_lock;
 #endif
 
+  RCSupportedParamsCache supported_params;
+
   RCLlrpTarget llrp_target;
   bool         target_valid;
 };
@@ -389,7 +442,7 @@ etcpal_error_t rc_client_send_ept_status(RCClient*             handle,
                                          ept_status_code_t     status_code,
                                          const char*           status_string);
 
-uint8_t* rc_client_get_internal_response_buf(size_t size);
+uint8_t* rc_client_get_internal_response_buf(RCClient* client, size_t size);
 
 #ifdef __cplusplus
 }
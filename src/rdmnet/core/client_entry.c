@@ -44,10 +44,12 @@ bool rc_create_ept_client_entry(const EtcPalUuid*           cid,
                                 size_t                      protocol_arr_size,
                                 RdmnetEptClientEntry*       entry)
 {
-  ETCPAL_UNUSED_ARG(cid);
-  ETCPAL_UNUSED_ARG(protocol_arr);
-  ETCPAL_UNUSED_ARG(protocol_arr_size);
-  ETCPAL_UNUSED_ARG(entry);
-  // TODO
-  return false;
+  if (!cid || (!protocol_arr && protocol_arr_size != 0) || !entry)
+    return false;
+
+  // The entry references the caller's protocol array; it is only used for packing.
+  entry->cid = *cid;
+  entry->protocols = (RdmnetEptSubProtocol*)protocol_arr;
+  entry->num_protocols = protocol_arr_size;
+  return true;
 }
@@ -24,6 +24,7 @@
 #include "etcpal/socket.h"
 #include "etcpal/timer.h"
 #include "rdmnet/discovery.h"
+#include "rdmnet/core/callback_queue.h"
 #include "rdmnet/core/message.h"
 #include "rdmnet/core/client.h"
 #include "rdmnet/core/connection.h"
@@ -34,10 +35,13 @@
 #include "rdmnet/core/opts.h"
 #include "rdmnet/disc/common.h"
 
+#if RDMNET_HAVE_IO_URING
+#include "rdmnet/core/uring_poll.h"
+#endif
+
 /*************************** Private constants *******************************/
 
-#define RDMNET_TICK_PERIODIC_INTERVAL 100 /* ms */
-#define RDMNET_POLL_TIMEOUT 120           /* ms */
+#define RDMNET_POLL_TIMEOUT 120 /* ms */
 
 #define RDMNET_ETCPAL_FEATURES \
   (ETCPAL_FEATURE_SOCKETS | ETCPAL_FEATURE_TIMERS | ETCPAL_FEATURE_NETINTS | ETCPAL_FEATURE_LOGGING)
@@ -86,6 +90,11 @@ static struct CoreState
   EtcPalLogParams   log_params;
   EtcPalTimer       tick_timer;
   EtcPalPollContext poll_context;
+#if RDMNET_HAVE_IO_URING
+  // Used in place of poll_context if the kernel supports io_uring.
+  RCUringPollContext uring_poll_context;
+  bool               use_uring_poll;
+#endif
 } core_state;
 
 static etcpal_rwlock_t rdmnet_lock;
@@ -108,7 +117,11 @@ static RdmnetCoreModule modules[] = {
 #if RDMNET_DYNAMIC_MEM
   RDMNET_CORE_MODULE(rc_llrp_manager_module_init, rc_llrp_manager_module_deinit, rc_llrp_manager_module_tick),
 #endif
-  RDMNET_CORE_MODULE(rc_client_module_init, rc_client_module_deinit, NULL)
+  RDMNET_CORE_MODULE(rc_client_module_init, rc_client_module_deinit, NULL),
+#if RC_QUEUE_CALLBACKS
+  // Last, so that callbacks still queued are discarded before the modules they refer to are deinitialized.
+  RDMNET_CORE_MODULE(rc_callback_queue_module_init, rc_callback_queue_module_deinit, NULL),
+#endif
 };
 #define NUM_RDMNET_CORE_MODULES (sizeof(modules) / sizeof(modules[0]))
 // clang-format on
@@ -221,6 +234,10 @@ etcpal_error_t rc_add_polled_socket(etcpal_socket_t socket, etcpal_poll_events_t
   if (!RDMNET_ASSERT_VERIFY(info))
     return kEtcPalErrSys;
 
+#if RDMNET_HAVE_IO_URING
+  if (core_state.use_uring_poll)
+    return rc_uring_poll_add_socket(&core_state.uring_poll_context, socket, events, info);
+#endif
   return etcpal_poll_add_socket(&core_state.poll_context, socket, events, info);
 }
 
@@ -229,11 +246,22 @@ etcpal_error_t rc_modify_polled_socket(etcpal_socket_t socket, etcpal_poll_event
   if (!RDMNET_ASSERT_VERIFY(info))
     return kEtcPalErrSys;
 
+#if RDMNET_HAVE_IO_URING
+  if (core_state.use_uring_poll)
+    return rc_uring_poll_modify_socket(&core_state.uring_poll_context, socket, events, info);
+#endif
   return etcpal_poll_modify_socket(&core_state.poll_context, socket, events, info);
 }
 
 void rc_remove_polled_socket(etcpal_socket_t socket)
 {
+#if RDMNET_HAVE_IO_URING
+  if (core_state.use_uring_poll)
+  {
+    rc_uring_poll_remove_socket(&core_state.uring_poll_context, socket);
+    return;
+  }
+#endif
   etcpal_poll_remove_socket(&core_state.poll_context, socket);
 }
 
@@ -265,7 +293,14 @@ int rc_send(etcpal_socket_t id, const void* message, size_t length, int flags)
 void rc_tick(void)
 {
   EtcPalPollEvent event;
-  etcpal_error_t  poll_res = etcpal_poll_wait(&core_state.poll_context, &event, RDMNET_POLL_TIMEOUT);
+#if RDMNET_HAVE_IO_URING
+  etcpal_error_t poll_res =
+      (core_state.use_uring_poll
+           ? rc_uring_poll_wait(&core_state.uring_poll_context, &event, RDMNET_POLL_TIMEOUT)
+           : etcpal_poll_wait(&core_state.poll_context, &event, RDMNET_POLL_TIMEOUT));
+#else
+  etcpal_error_t poll_res = etcpal_poll_wait(&core_state.poll_context, &event, RDMNET_POLL_TIMEOUT);
+#endif
   if (poll_res == kEtcPalErrOk)
   {
     RCPolledSocketInfo* info = (RCPolledSocketInfo*)event.user_data;
@@ -339,11 +374,21 @@ etcpal_error_t init_etcpal_dependencies(void)
     if (res != kEtcPalErrOk)
       etcpal_deinit(RDMNET_ETCPAL_FEATURES);
   }
+#if RDMNET_HAVE_IO_URING
+  // Falls back to etcpal_poll if the kernel doesn't support io_uring.
+  if (res == kEtcPalErrOk)
+    core_state.use_uring_poll = (rc_uring_poll_context_init(&core_state.uring_poll_context) == kEtcPalErrOk);
+#endif
   return res;
 }
 
 void deinit_etcpal_dependencies(void)
 {
+#if RDMNET_HAVE_IO_URING
+  if (core_state.use_uring_poll)
+    rc_uring_poll_context_deinit(&core_state.uring_poll_context);
+  core_state.use_uring_poll = false;
+#endif
   etcpal_poll_context_deinit(&core_state.poll_context);
   etcpal_deinit(RDMNET_ETCPAL_FEATURES);
 }
@@ -48,6 +48,9 @@ extern "C" {
  */
 #define RDMNET_RECV_DATA_MAX_SIZE 1200
 
+/* The interval at which the core modules' tick functions are called. */
+#define RDMNET_TICK_PERIODIC_INTERVAL 100 /* ms */
+
 /*
  * RDMnet Core Library: implementation of the core functions of RDMnet.
  *
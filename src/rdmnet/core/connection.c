@@ -19,7 +19,9 @@
 
 #include "rdmnet/core/connection.h"
 
+#include <stddef.h>
 #include <stdint.h>
+#include <string.h>
 #include "etcpal/common.h"
 #include "etcpal/mutex.h"
 #include "etcpal/rbtree.h"
@@ -28,6 +30,7 @@
 #include "rdmnet/core/broker_prot.h"
 #include "rdmnet/core/common.h"
 #include "rdmnet/core/message.h"
+#include "rdmnet/core/timer_wheel.h"
 #include "rdmnet/core/util.h"
 #include "rdmnet/defs.h"
 #include "rdmnet/core/opts.h"
@@ -84,23 +87,53 @@ typedef struct RCConnEvent
     etcpal_mutex_unlock((conn_ptr)->lock); \
   }
 
+#define GET_CONN_FROM_TIMER_ENTRY(entryptr) \
+  (RDMNET_ASSERT_VERIFY(entryptr) ? (RCConnection*)((char*)(entryptr)-offsetof(RCConnection, timer_entry)) : NULL)
+
 /**************************** Private variables ******************************/
 
 RC_DECLARE_REF_LISTS(connections, RDMNET_MAX_CONNECTIONS);
 
+// The tick only processes connections whose deadlines have come due on this wheel, rather than
+// scanning every connection. Guarded by conn_timers_lock, which is taken after connection locks.
+static RCTimerWheel   conn_timers;
+static etcpal_mutex_t conn_timers_lock;
+
+#if RC_QUEUE_CALLBACKS
+// A loopback socket in the poll set, used by callback threads to have the tick thread process the
+// connections they have woken right away instead of on its next periodic tick.
+static etcpal_socket_t    wake_sock = ETCPAL_SOCKET_INVALID;
+static EtcPalSockAddr     wake_addr;
+static RCPolledSocketInfo wake_poll_info;
+static bool               wake_sent;  // A wake is waiting to be read from wake_sock. Guarded by conn_timers_lock.
+#endif
+
 /*********************** Private function prototypes *************************/
 
 // Periodic state processing
 static void process_connection_state(RCConnection* conn, const void* context);
+static void process_due_connections(void);
+static void schedule_connection(RCConnection* conn);
+static void wake_connection(RCConnection* conn);
+static void unschedule_connection(RCConnection* conn);
 
 // Connection state machine
-static uint32_t update_backoff(uint32_t previous_backoff);
+static uint32_t update_backoff(uint32_t previous_backoff, uint32_t retry_after_hint);
 static void     start_tcp_connection(RCConnection* conn, RCConnEvent* event);
 static void     start_rdmnet_connection(RCConnection* conn);
 static void     reset_connection(RCConnection* conn);
 static void     retry_connection(RCConnection* conn);
+static void     reset_recv_buf(RCConnection* conn);
 static void     cleanup_connection_resources(RCConnection* conn);
 
+// Parallel connection attempts
+static void           start_next_attempt(RCConnection* conn, RCConnEvent* event);
+static etcpal_error_t start_attempt(RCConnection* conn, RCConnAttempt* attempt);
+static void           finish_attempts(RCConnection* conn, RCConnAttempt* winner);
+static void           close_attempt(RCConnAttempt* attempt);
+static bool           attempts_pending(const RCConnection* conn);
+static void           attempt_socket_activity_callback(const EtcPalPollEvent* event, RCPolledSocketOpaqueData data);
+
 static void destroy_connection(RCConnection* conn, const void* context);
 
 // Incoming message handling
@@ -113,6 +146,22 @@ static void                handle_message(RCConnection* conn, RdmnetMessage* msg
 static void                handle_rdmnet_message(RCConnection* conn, RdmnetMessage* msg, RCConnEvent* event);
 static void                handle_rdmnet_connect_result(RCConnection* conn, RdmnetMessage* msg, RCConnEvent* event);
 static void                deliver_event_callback(RCConnection* conn, RCConnEvent* event, rc_message_action_t* action);
+static void                call_event_callback(RCConnection* conn, RCConnEvent* event, rc_message_action_t* action);
+
+#if RC_QUEUE_CALLBACKS
+// Callback queue support
+static bool                receive_pending(RCConnection* conn);
+static bool                begin_receive(RCConnection* conn, bool* retry_message, bool* parse_buffered);
+static void                finish_receive(RCConnection* conn, rc_message_action_t message_action);
+static void                set_receive_paused(RCConnection* conn, bool paused);
+static rc_message_action_t queue_event_callback(RCConnection* conn, RCConnEvent* event);
+static void                deliver_queued_event(RCQueuedCallback* callback, bool discard);
+static bool                has_queued_callbacks(void* ref, const void* context);
+static etcpal_error_t      create_wake_socket(void);
+static void                destroy_wake_socket(void);
+static void                wake_tick_thread(void);
+static void                wake_socket_activity_callback(const EtcPalPollEvent* event, RCPolledSocketOpaqueData data);
+#endif
 
 /*************************** Function definitions ****************************/
 
@@ -122,8 +171,27 @@ static void                deliver_event_callback(RCConnection* conn, RCConnEven
  */
 etcpal_error_t rc_conn_module_init(void)
 {
+  if (!etcpal_mutex_create(&conn_timers_lock))
+    return kEtcPalErrSys;
+
   if (!rc_ref_lists_init(&connections))
+  {
+    etcpal_mutex_destroy(&conn_timers_lock);
     return kEtcPalErrNoMem;
+  }
+
+  rc_timer_wheel_init(&conn_timers, RDMNET_TICK_PERIODIC_INTERVAL);
+
+#if RC_QUEUE_CALLBACKS
+  etcpal_error_t res = create_wake_socket();
+  if (res != kEtcPalErrOk)
+  {
+    rc_ref_lists_cleanup(&connections);
+    etcpal_mutex_destroy(&conn_timers_lock);
+    return res;
+  }
+#endif
+
   return kEtcPalErrOk;
 }
 
@@ -136,6 +204,10 @@ void rc_conn_module_deinit()
 {
   rc_ref_lists_remove_all(&connections, (RCRefFunction)destroy_connection, NULL);
   rc_ref_lists_cleanup(&connections);
+#if RC_QUEUE_CALLBACKS
+  destroy_wake_socket();
+#endif
+  etcpal_mutex_destroy(&conn_timers_lock);
 }
 
 /*
@@ -161,11 +233,32 @@ etcpal_error_t rc_conn_register(RCConnection* conn)
 
   conn->state = kRCConnStateNotStarted;
   etcpal_timer_start(&conn->backoff_timer, 0);
+  conn->retry_after_hint = 0;
   conn->rdmnet_conn_failed = false;
   conn->sent_connected_notification = false;
+  memset(&conn->timer_entry, 0, sizeof(RCTimerWheelEntry));
+
+  for (size_t i = 0; i < RDMNET_CONN_PARALLEL_CONNECT_ADDRS; ++i)
+  {
+    RCConnAttempt* attempt = &conn->attempts[i];
+    attempt->conn = conn;
+    attempt->sock = ETCPAL_SOCKET_INVALID;
+    attempt->poll_info.callback = attempt_socket_activity_callback;
+    attempt->poll_info.data.ptr = attempt;
+  }
+  conn->num_attempts = 0;
+  conn->next_attempt = 0;
 
   rc_msg_buf_init(&conn->recv_buf);
   conn->retry_current_message = false;
+#if RC_QUEUE_CALLBACKS
+  conn->num_queued_callbacks = 0;
+  conn->message_in_flight = false;
+  conn->message_done = false;
+  conn->message_retry = false;
+  conn->recv_buf_reset_pending = false;
+  conn->recv_paused = false;
+#endif
 
   return kEtcPalErrOk;
 }
@@ -186,6 +279,7 @@ void rc_conn_unregister(RCConnection* conn, const rdmnet_disconnect_reason_t* di
     rc_broker_send_disconnect(conn, &dm);
   }
   conn->state = kRCConnStateMarkedForDestruction;
+  unschedule_connection(conn);
   rc_ref_list_add_ref(&connections.to_remove, conn);
 }
 
@@ -210,14 +304,46 @@ etcpal_error_t rc_conn_connect(RCConnection*                 conn,
   // Set the data - the connect will be initiated from the background thread.
   conn->remote_addr = *remote_addr;
   conn->conn_data = *connect_data;
+  conn->num_attempts = 0;
   if (conn->state == kRCConnStateNotStarted)
     conn->state = kRCConnStateConnectPending;
   else
     conn->state = kRCConnStateReconnectPending;
 
+  wake_connection(conn);
   return kEtcPalErrOk;
 }
 
+/*
+ * Connect to an RDMnet Broker which is reachable at more than one address. Like rc_conn_connect(),
+ * but TCP connections are started to up to RDMNET_CONN_PARALLEL_CONNECT_ADDRS of the addresses,
+ * each RDMNET_CONN_PARALLEL_CONNECT_DELAY_MS after the last (or right away if the last fails). The
+ * first one to connect is used for the RDMnet handshake and the rest are closed. A connect failure
+ * is reported only once all of the attempts have failed.
+ */
+etcpal_error_t rc_conn_connect_parallel(RCConnection*                 conn,
+                                        const EtcPalSockAddr*         remote_addrs,
+                                        size_t                        num_remote_addrs,
+                                        const BrokerClientConnectMsg* connect_data)
+{
+  if (!RDMNET_ASSERT_VERIFY(conn) || !RDMNET_ASSERT_VERIFY(remote_addrs) || !RDMNET_ASSERT_VERIFY(num_remote_addrs) ||
+      !RDMNET_ASSERT_VERIFY(connect_data))
+  {
+    return kEtcPalErrSys;
+  }
+
+  etcpal_error_t res = rc_conn_connect(conn, &remote_addrs[0], connect_data);
+  if (res == kEtcPalErrOk && num_remote_addrs > 1 && RDMNET_CONN_PARALLEL_CONNECT_ADDRS > 1)
+  {
+    conn->num_attempts = num_remote_addrs;
+    if (conn->num_attempts > RDMNET_CONN_PARALLEL_CONNECT_ADDRS)
+      conn->num_attempts = RDMNET_CONN_PARALLEL_CONNECT_ADDRS;
+    for (size_t i = 0; i < conn->num_attempts; ++i)
+      conn->attempts[i].addr = remote_addrs[i];
+  }
+  return res;
+}
+
 etcpal_error_t rc_conn_reconnect(RCConnection*                 conn,
                                  const EtcPalSockAddr*         new_remote_addr,
                                  const BrokerClientConnectMsg* new_connect_data,
@@ -239,11 +365,13 @@ etcpal_error_t rc_conn_reconnect(RCConnection*                 conn,
   }
   conn->remote_addr = *new_remote_addr;
   conn->conn_data = *new_connect_data;
+  conn->num_attempts = 0;
   if (conn->state == kRCConnStateBackoff)
     conn->state = kRCConnStateConnectPending;
   else
     conn->state = kRCConnStateReconnectPending;
 
+  wake_connection(conn);
   return kEtcPalErrOk;
 }
 
@@ -262,25 +390,62 @@ etcpal_error_t rc_conn_disconnect(RCConnection* conn, rdmnet_disconnect_reason_t
     rc_broker_send_disconnect(conn, &dm);
   }
   if (conn->state == kRCConnStateConnectPending || conn->state == kRCConnStateBackoff)
+  {
     conn->state = kRCConnStateNotStarted;
+    unschedule_connection(conn);
+  }
   else
+  {
     conn->state = kRCConnStateDisconnectPending;
+    wake_connection(conn);
+  }
   return kEtcPalErrOk;
 }
 
 /*
- * Handle periodic RDMnet connection functionality.
+ * Handle periodic RDMnet connection functionality. Only the connections with a deadline that has
+ * come due (or that have been poked by an API call or a message retry) are processed; idle
+ * connections are serviced through socket activity alone.
  */
 void rc_conn_module_tick()
 {
   if (rdmnet_writelock())
   {
-    rc_ref_lists_remove_marked(&connections, (RCRefFunction)destroy_connection, NULL);
+#if RC_QUEUE_CALLBACKS
+    // Connections are only destroyed once every callback queued for them has been delivered.
+    if (!rc_ref_list_find_ref(&connections.to_remove, has_queued_callbacks, NULL))
+#endif
+      rc_ref_lists_remove_marked(&connections, (RCRefFunction)destroy_connection, NULL);
     rc_ref_lists_add_pending(&connections);
     rdmnet_writeunlock();
   }
 
-  rc_ref_list_for_each(&connections.active, (RCRefFunction)process_connection_state, NULL);
+  process_due_connections();
+}
+
+// Process each connection whose deadline has come due.
+void process_due_connections(void)
+{
+  if (etcpal_mutex_lock(&conn_timers_lock))
+  {
+    rc_timer_wheel_advance(&conn_timers);
+    etcpal_mutex_unlock(&conn_timers_lock);
+  }
+
+  // Connections are only destroyed from this thread, so a popped entry stays valid while it is processed.
+  RCTimerWheelEntry* entry = NULL;
+  do
+  {
+    entry = NULL;
+    if (etcpal_mutex_lock(&conn_timers_lock))
+    {
+      entry = rc_timer_wheel_pop_expired(&conn_timers);
+      etcpal_mutex_unlock(&conn_timers_lock);
+    }
+
+    if (entry)
+      process_connection_state(GET_CONN_FROM_TIMER_ENTRY(entry), NULL);
+  } while (entry);
 }
 
 static void start_connection(RCConnection* conn, RCConnEvent* event)
@@ -291,7 +456,10 @@ static void start_connection(RCConnection* conn, RCConnEvent* event)
   if (conn->rdmnet_conn_failed || conn->backoff_timer.interval != 0)
   {
     if (conn->rdmnet_conn_failed)
-      etcpal_timer_start(&conn->backoff_timer, update_backoff(conn->backoff_timer.interval));
+    {
+      etcpal_timer_start(&conn->backoff_timer, update_backoff(conn->backoff_timer.interval, conn->retry_after_hint));
+      conn->retry_after_hint = 0;
+    }
     conn->state = kRCConnStateBackoff;
   }
   else
@@ -307,8 +475,14 @@ void process_connection_state(RCConnection* conn, const void* context)
   if (!RDMNET_ASSERT_VERIFY(conn))
     return;
 
-  // Some messages need to be retried on the next tick, which happens here.
-  receive_and_process_messages(conn);
+  // Some messages need to be retried on the next tick, which happens here. Otherwise, receives are
+  // driven by socket activity.
+#if RC_QUEUE_CALLBACKS
+  if (receive_pending(conn))
+#else
+  if (conn->retry_current_message)
+#endif
+    receive_and_process_messages(conn);
 
   if (RC_CONN_LOCK(conn))
   {
@@ -325,6 +499,10 @@ void process_connection_state(RCConnection* conn, const void* context)
           start_tcp_connection(conn, &event);
         }
         break;
+      case kRCConnStateTCPConnPending:
+        if (conn->next_attempt < conn->num_attempts && etcpal_timer_is_expired(&conn->attempt_timer))
+          start_next_attempt(conn, &event);
+        break;
       case kRCConnStateRDMnetConnPending:
         if (etcpal_timer_is_expired(&conn->hb_timer))
         {
@@ -350,8 +528,7 @@ void process_connection_state(RCConnection* conn, const void* context)
         break;
       case kRCConnStateReconnectPending:
         cleanup_connection_resources(conn);
-        rc_msg_buf_init(&conn->recv_buf);
-        conn->retry_current_message = false;
+        reset_recv_buf(conn);
         if (conn->sent_connected_notification)
         {
           event.which = kRCConnEventDisconnected;
@@ -373,6 +550,7 @@ void process_connection_state(RCConnection* conn, const void* context)
         break;
     }
 
+    schedule_connection(conn);
     RC_CONN_UNLOCK(conn);
 
     rc_message_action_t action = kRCMessageActionProcessNext;
@@ -380,9 +558,93 @@ void process_connection_state(RCConnection* conn, const void* context)
   }
 }
 
+// Schedule the next time the tick must process a connection, based on its state and timers. Call
+// with the connection lock held.
+void schedule_connection(RCConnection* conn)
+{
+  if (!RDMNET_ASSERT_VERIFY(conn))
+    return;
+
+  bool     wake = true;
+  uint32_t timeout_ms = 0;
+
+  if (!conn->retry_current_message)
+  {
+    switch (conn->state)
+    {
+      case kRCConnStateConnectPending:
+      case kRCConnStateReconnectPending:
+      case kRCConnStateDisconnectPending:
+        break;
+      case kRCConnStateBackoff:
+        timeout_ms = etcpal_timer_remaining(&conn->backoff_timer);
+        break;
+      case kRCConnStateTCPConnPending:
+        // Only needs a wakeup if there are more parallel attempts to start.
+        if (conn->next_attempt < conn->num_attempts)
+          timeout_ms = etcpal_timer_remaining(&conn->attempt_timer);
+        else
+          wake = false;
+        break;
+      case kRCConnStateRDMnetConnPending:
+        timeout_ms = etcpal_timer_remaining(&conn->hb_timer);
+        break;
+      case kRCConnStateHeartbeat: {
+        uint32_t hb_remaining = etcpal_timer_remaining(&conn->hb_timer);
+        uint32_t send_remaining = etcpal_timer_remaining(&conn->send_timer);
+        timeout_ms = (hb_remaining < send_remaining ? hb_remaining : send_remaining);
+        break;
+      }
+      default:
+        // Waiting on socket activity or the application; nothing to time out.
+        wake = false;
+        break;
+    }
+  }
+
+  if (etcpal_mutex_lock(&conn_timers_lock))
+  {
+    if (wake)
+      rc_timer_wheel_schedule(&conn_timers, &conn->timer_entry, timeout_ms);
+    else
+      rc_timer_wheel_cancel(&conn_timers, &conn->timer_entry);
+    etcpal_mutex_unlock(&conn_timers_lock);
+  }
+}
+
+// Have the connection processed on the next tick.
+void wake_connection(RCConnection* conn)
+{
+  if (!RDMNET_ASSERT_VERIFY(conn))
+    return;
+
+  if (etcpal_mutex_lock(&conn_timers_lock))
+  {
+    rc_timer_wheel_schedule(&conn_timers, &conn->timer_entry, 0);
+    etcpal_mutex_unlock(&conn_timers_lock);
+  }
+}
+
+void unschedule_connection(RCConnection* conn)
+{
+  if (!RDMNET_ASSERT_VERIFY(conn))
+    return;
+
+  if (etcpal_mutex_lock(&conn_timers_lock))
+  {
+    rc_timer_wheel_cancel(&conn_timers, &conn->timer_entry);
+    etcpal_mutex_unlock(&conn_timers_lock);
+  }
+}
+
 // Update a backoff timer value using the algorithm specified in E1.33. Returns the new value.
-uint32_t update_backoff(uint32_t previous_backoff)
+// A busy broker's retry-after hint is used in place of the random backoff, so that the broker can
+// spread the reconnects of a large number of clients evenly over time.
+uint32_t update_backoff(uint32_t previous_backoff, uint32_t retry_after_hint)
 {
+  if (retry_after_hint != 0)
+    return (retry_after_hint > 30000u ? 30000u : retry_after_hint);
+
   uint32_t result = (uint32_t)(((rand() % 4001) + 1000));
   result += previous_backoff;
   // 30 second interval is the max
@@ -396,6 +658,25 @@ void start_tcp_connection(RCConnection* conn, RCConnEvent* event)
   if (!RDMNET_ASSERT_VERIFY(conn) || !RDMNET_ASSERT_VERIFY(event))
     return;
 
+#if RC_QUEUE_CALLBACKS
+  // The new connection can't receive into recv_buf until the message in flight from the old one
+  // has been delivered. Wait in the (expired) backoff state; this is retried on the next tick.
+  if (conn->recv_buf_reset_pending)
+  {
+    conn->state = kRCConnStateBackoff;
+    return;
+  }
+#endif
+
+  if (conn->num_attempts != 0)
+  {
+    conn->rdmnet_conn_failed = false;
+    conn->next_attempt = 0;
+    conn->state = kRCConnStateTCPConnPending;
+    start_next_attempt(conn, event);
+    return;
+  }
+
   bool ok = true;
 
   etcpal_error_t res = etcpal_socket(ETCPAL_IP_IS_V6(&conn->remote_addr.ip) ? ETCPAL_AF_INET6 : ETCPAL_AF_INET,
@@ -478,8 +759,7 @@ void reset_connection(RCConnection* conn)
     return;
 
   cleanup_connection_resources(conn);
-  rc_msg_buf_init(&conn->recv_buf);
-  conn->retry_current_message = false;
+  reset_recv_buf(conn);
   conn->state = kRCConnStateNotStarted;
 }
 
@@ -489,9 +769,26 @@ void retry_connection(RCConnection* conn)
     return;
 
   cleanup_connection_resources(conn);
+  reset_recv_buf(conn);
+  conn->state = kRCConnStateConnectPending;
+}
+
+// Discard any received data. A message in flight in the callback queue still refers to recv_buf, so
+// in that case it's reset once the callback is done with the message.
+void reset_recv_buf(RCConnection* conn)
+{
+  if (!RDMNET_ASSERT_VERIFY(conn))
+    return;
+
+#if RC_QUEUE_CALLBACKS
+  if (conn->message_in_flight)
+    conn->recv_buf_reset_pending = true;
+  else
+    rc_msg_buf_init(&conn->recv_buf);
+#else
   rc_msg_buf_init(&conn->recv_buf);
+#endif
   conn->retry_current_message = false;
-  conn->state = kRCConnStateConnectPending;
 }
 
 void destroy_connection(RCConnection* conn, const void* context)
@@ -501,6 +798,7 @@ void destroy_connection(RCConnection* conn, const void* context)
   if (!RDMNET_ASSERT_VERIFY(conn))
     return;
 
+  unschedule_connection(conn);
   cleanup_connection_resources(conn);
   if (conn->callbacks.destroyed)
     conn->callbacks.destroyed(conn);
@@ -517,6 +815,13 @@ void cleanup_connection_resources(RCConnection* conn)
     etcpal_close(conn->sock);
     conn->sock = ETCPAL_SOCKET_INVALID;
   }
+#if RC_QUEUE_CALLBACKS
+  conn->recv_paused = false;
+#endif
+
+  // num_attempts may have been cleared by a new connect request since these were started.
+  for (size_t i = 0; i < RDMNET_CONN_PARALLEL_CONNECT_ADDRS; ++i)
+    close_attempt(&conn->attempts[i]);
 
   if (conn->retry_current_message)
   {
@@ -526,6 +831,160 @@ void cleanup_connection_resources(RCConnection* conn)
   }
 }
 
+// Start the next parallel connection attempt, moving on past any address that fails right away.
+// Once every attempt has failed, resets the connection and reports the most recent failure.
+void start_next_attempt(RCConnection* conn, RCConnEvent* event)
+{
+  if (!RDMNET_ASSERT_VERIFY(conn) || !RDMNET_ASSERT_VERIFY(event))
+    return;
+
+  while (conn->next_attempt < conn->num_attempts)
+  {
+    RCConnAttempt* attempt = &conn->attempts[conn->next_attempt++];
+
+    etcpal_error_t res = start_attempt(conn, attempt);
+    if (res == kEtcPalErrOk)
+    {
+      // Fast connect condition
+      finish_attempts(conn, attempt);
+      return;
+    }
+    if (res == kEtcPalErrInProgress)
+    {
+      etcpal_timer_start(&conn->attempt_timer, RDMNET_CONN_PARALLEL_CONNECT_DELAY_MS);
+      return;
+    }
+  }
+
+  if (!attempts_pending(conn))
+  {
+    event->which = kRCConnEventConnectFailed;
+    event->arg.connect_failed = conn->attempt_failure;
+    reset_connection(conn);
+  }
+}
+
+// Open a non-blocking TCP connection for an attempt. Returns kEtcPalErrOk if it connected
+// immediately or kEtcPalErrInProgress if it is pending. On failure, the attempt is closed and
+// conn->attempt_failure is updated.
+etcpal_error_t start_attempt(RCConnection* conn, RCConnAttempt* attempt)
+{
+  if (!RDMNET_ASSERT_VERIFY(conn) || !RDMNET_ASSERT_VERIFY(attempt))
+    return kEtcPalErrSys;
+
+  rdmnet_connect_fail_event_t fail_event = kRdmnetConnectFailSocketFailure;
+
+  etcpal_error_t res = etcpal_socket(ETCPAL_IP_IS_V6(&attempt->addr.ip) ? ETCPAL_AF_INET6 : ETCPAL_AF_INET,
+                                     ETCPAL_SOCK_STREAM, &attempt->sock);
+  if (res == kEtcPalErrOk)
+    res = etcpal_setblocking(attempt->sock, false);
+
+  if (res == kEtcPalErrOk)
+  {
+    res = etcpal_connect(attempt->sock, &attempt->addr);
+    if (res == kEtcPalErrOk)
+      return kEtcPalErrOk;
+
+    if (res == kEtcPalErrInProgress || res == kEtcPalErrWouldBlock)
+    {
+      res = rc_add_polled_socket(attempt->sock, ETCPAL_POLL_CONNECT, &attempt->poll_info);
+      if (res == kEtcPalErrOk)
+        return kEtcPalErrInProgress;
+    }
+    else if (res == kEtcPalErrHostUnreach)
+    {
+      // EHOSTUNREACH is sometimes reported synchronously even for a non-blocking connect.
+      fail_event = kRdmnetConnectFailTcpLevel;
+    }
+  }
+
+  close_attempt(attempt);
+  conn->attempt_failure.event = fail_event;
+  conn->attempt_failure.socket_err = res;
+  return res;
+}
+
+// Make the winning attempt's socket the connection's socket, close the other attempts and start
+// the RDMnet handshake.
+void finish_attempts(RCConnection* conn, RCConnAttempt* winner)
+{
+  if (!RDMNET_ASSERT_VERIFY(conn) || !RDMNET_ASSERT_VERIFY(winner))
+    return;
+
+  conn->sock = winner->sock;
+  conn->remote_addr = winner->addr;
+  winner->sock = ETCPAL_SOCKET_INVALID;
+
+  for (size_t i = 0; i < conn->num_attempts; ++i)
+    close_attempt(&conn->attempts[i]);
+  conn->next_attempt = conn->num_attempts;
+
+  start_rdmnet_connection(conn);
+}
+
+void close_attempt(RCConnAttempt* attempt)
+{
+  if (!RDMNET_ASSERT_VERIFY(attempt))
+    return;
+
+  if (attempt->sock != ETCPAL_SOCKET_INVALID)
+  {
+    rc_remove_polled_socket(attempt->sock);
+    etcpal_close(attempt->sock);
+    attempt->sock = ETCPAL_SOCKET_INVALID;
+  }
+}
+
+bool attempts_pending(const RCConnection* conn)
+{
+  if (!RDMNET_ASSERT_VERIFY(conn))
+    return false;
+
+  for (size_t i = 0; i < conn->next_attempt; ++i)
+  {
+    if (conn->attempts[i].sock != ETCPAL_SOCKET_INVALID)
+      return true;
+  }
+  return false;
+}
+
+void attempt_socket_activity_callback(const EtcPalPollEvent* event, RCPolledSocketOpaqueData data)
+{
+  if (!RDMNET_ASSERT_VERIFY(event))
+    return;
+
+  RCConnAttempt* attempt = (RCConnAttempt*)data.ptr;
+  if (!RDMNET_ASSERT_VERIFY(attempt) || !RDMNET_ASSERT_VERIFY(attempt->conn))
+    return;
+
+  RCConnection* conn = attempt->conn;
+  if (RC_CONN_LOCK(conn))
+  {
+    RCConnEvent conn_event = RC_CONN_EVENT_INIT;
+
+    // Activity can race with the attempt being closed by another thread; ignore it if so.
+    if (conn->state == kRCConnStateTCPConnPending && attempt->sock == event->socket)
+    {
+      if (event->events & ETCPAL_POLL_ERR)
+      {
+        close_attempt(attempt);
+        conn->attempt_failure.event = kRdmnetConnectFailTcpLevel;
+        conn->attempt_failure.socket_err = event->err;
+        start_next_attempt(conn, &conn_event);
+      }
+      else if (event->events & ETCPAL_POLL_CONNECT)
+      {
+        finish_attempts(conn, attempt);
+      }
+      schedule_connection(conn);
+    }
+    RC_CONN_UNLOCK(conn);
+
+    rc_message_action_t action = kRCMessageActionProcessNext;
+    deliver_event_callback(conn, &conn_event, &action);
+  }
+}
+
 void socket_activity_callback(const EtcPalPollEvent* event, RCPolledSocketOpaqueData data)
 {
   if (!RDMNET_ASSERT_VERIFY(event))
@@ -551,6 +1010,12 @@ void receive_and_process_messages(RCConnection* conn)
   etcpal_error_t      recv_res = kEtcPalErrOk;
   rc_message_action_t message_action = kRCMessageActionProcessNext;
   bool                retry_current_message = conn->retry_current_message;
+  bool                parse_buffered_data = false;
+
+#if RC_QUEUE_CALLBACKS
+  if (!begin_receive(conn, &retry_current_message, &parse_buffered_data))
+    return;
+#endif
 
   // This loop alternates between "receive as much data as possible" and "parse and process as much of the received data
   // as possible". This is done in a loop in case the TCP queue has more data than can fit in our buffer in one receive.
@@ -559,8 +1024,10 @@ void receive_and_process_messages(RCConnection* conn)
     // No matter what, we should continue to fill our buffer if there's data to receive and there's room in the buffer.
     recv_res = rc_msg_buf_recv(&conn->recv_buf, conn->sock);
 
-    if ((recv_res == kEtcPalErrOk) || retry_current_message)
+    if ((recv_res == kEtcPalErrOk) || retry_current_message || parse_buffered_data)
     {
+      parse_buffered_data = false;
+
       // This next loop parses and processes as many messages from the buffer as possible, until all complete messages
       // have been processed or we get RetryLater.
       etcpal_error_t parse_res = kEtcPalErrOk;
@@ -582,7 +1049,13 @@ void receive_and_process_messages(RCConnection* conn)
     }
   } while ((recv_res == kEtcPalErrOk) && (message_action == kRCMessageActionProcessNext));
 
+#if RC_QUEUE_CALLBACKS
+  finish_receive(conn, message_action);
+#else
   conn->retry_current_message = (message_action == kRCMessageActionRetryLater);
+  if (conn->retry_current_message)
+    wake_connection(conn);
+#endif
 }
 
 rc_message_action_t process_message(RCConnection* conn)
@@ -596,7 +1069,12 @@ rc_message_action_t process_message(RCConnection* conn)
   if (RC_CONN_LOCK(conn))
   {
     if ((conn->state == kRCConnStateHeartbeat) || (conn->state == kRCConnStateRDMnetConnPending))
+    {
+      rc_client_conn_state_t prev_state = conn->state;
       handle_message(conn, &conn->recv_buf.msg, &event);
+      if (conn->state != prev_state)
+        schedule_connection(conn);
+    }
 
     RC_CONN_UNLOCK(conn);
   }
@@ -615,6 +1093,7 @@ void handle_tcp_connection_established(RCConnection* conn)
   {
     // connected successfully!
     start_rdmnet_connection(conn);
+    schedule_connection(conn);
     RC_CONN_UNLOCK(conn);
   }
 }
@@ -646,6 +1125,7 @@ void handle_socket_error(RCConnection* conn, etcpal_error_t socket_err)
 
       reset_connection(conn);
     }
+    schedule_connection(conn);
     RC_CONN_UNLOCK(conn);
 
     rc_message_action_t action = kRCMessageActionProcessNext;
@@ -758,6 +1238,7 @@ void handle_rdmnet_connect_result(RCConnection* conn, RdmnetMessage* msg, RCConn
 
           reset_connection(conn);
           conn->rdmnet_conn_failed = true;
+          conn->retry_after_hint = BROKER_CONNECT_REPLY_GET_RETRY_AFTER(reply);
           break;
         }
       }
@@ -769,6 +1250,7 @@ void handle_rdmnet_connect_result(RCConnection* conn, RdmnetMessage* msg, RCConn
         return;
 
       conn->remote_addr = client_redirect_msg->new_addr;
+      conn->num_attempts = 0;
       retry_connection(conn);
     }
   }
@@ -776,6 +1258,19 @@ void handle_rdmnet_connect_result(RCConnection* conn, RdmnetMessage* msg, RCConn
 }
 
 void deliver_event_callback(RCConnection* conn, RCConnEvent* event, rc_message_action_t* action)
+{
+  if (!RDMNET_ASSERT_VERIFY(conn) || !RDMNET_ASSERT_VERIFY(event) || !RDMNET_ASSERT_VERIFY(action))
+    return;
+
+#if RC_QUEUE_CALLBACKS
+  if (event->which != kRCConnEventNone)
+    *action = queue_event_callback(conn, event);
+#else
+  call_event_callback(conn, event, action);
+#endif
+}
+
+void call_event_callback(RCConnection* conn, RCConnEvent* event, rc_message_action_t* action)
 {
   if (!RDMNET_ASSERT_VERIFY(conn) || !RDMNET_ASSERT_VERIFY(event) || !RDMNET_ASSERT_VERIFY(action))
     return;
@@ -805,3 +1300,270 @@ void deliver_event_callback(RCConnection* conn, RCConnEvent* event, rc_message_a
       break;
   }
 }
+
+#if RC_QUEUE_CALLBACKS
+
+// Whether the connection has a message to retry, or a message in flight which has been delivered.
+bool receive_pending(RCConnection* conn)
+{
+  if (!RDMNET_ASSERT_VERIFY(conn))
+    return false;
+
+  bool pending = false;
+  if (RC_CONN_LOCK(conn))
+  {
+    pending = conn->retry_current_message || (conn->message_in_flight && conn->message_done);
+    RC_CONN_UNLOCK(conn);
+  }
+  return pending;
+}
+
+// Pick up the result of a message in flight, if it has been delivered. Returns false if received
+// data can't be parsed yet; otherwise, parse_buffered is set to whether data was left unparsed in
+// recv_buf while the message was in flight.
+bool begin_receive(RCConnection* conn, bool* retry_message, bool* parse_buffered)
+{
+  if (!RDMNET_ASSERT_VERIFY(conn) || !RDMNET_ASSERT_VERIFY(retry_message) || !RDMNET_ASSERT_VERIFY(parse_buffered))
+    return false;
+
+  bool receive = false;
+  if (RC_CONN_LOCK(conn))
+  {
+    receive = !conn->recv_buf_reset_pending;
+    if (conn->message_in_flight && conn->message_done)
+    {
+      conn->message_in_flight = false;
+      conn->message_done = false;
+      if (conn->recv_buf_reset_pending)
+      {
+        // The connection was reset while the message was in flight; there's nothing left to parse.
+        if (conn->message_retry)
+          rc_free_message_resources(&conn->recv_buf.msg);
+        rc_msg_buf_init(&conn->recv_buf);
+        conn->recv_buf_reset_pending = false;
+      }
+      else
+      {
+        conn->retry_current_message = conn->message_retry;
+        *parse_buffered = true;
+      }
+    }
+
+    receive = receive && !conn->message_in_flight;
+    *retry_message = conn->retry_current_message;
+    RC_CONN_UNLOCK(conn);
+  }
+  return receive;
+}
+
+void finish_receive(RCConnection* conn, rc_message_action_t message_action)
+{
+  if (!RDMNET_ASSERT_VERIFY(conn))
+    return;
+
+  bool parse_blocked = (message_action == kRCMessageActionRetryLater);
+  if (RC_CONN_LOCK(conn))
+  {
+    // A message that made it into the callback queue is retried, if need be, once it's delivered.
+    conn->retry_current_message = parse_blocked && !conn->message_in_flight;
+    if (conn->retry_current_message)
+      wake_connection(conn);
+    RC_CONN_UNLOCK(conn);
+  }
+
+  // Reading resumes when the connection is next processed with parsing unblocked: either woken by
+  // the callback thread once the message in flight is delivered, or on the tick for a retry.
+  set_receive_paused(conn, parse_blocked);
+}
+
+void set_receive_paused(RCConnection* conn, bool paused)
+{
+  if (!RDMNET_ASSERT_VERIFY(conn))
+    return;
+
+  if (conn->sock == ETCPAL_SOCKET_INVALID || conn->recv_paused == paused)
+    return;
+
+  // etcpal_poll can't watch a socket for no events, so the socket leaves the poll set entirely.
+  if (paused)
+    rc_remove_polled_socket(conn->sock);
+  else
+    rc_add_polled_socket(conn->sock, ETCPAL_POLL_IN, &conn->poll_info);
+  conn->recv_paused = paused;
+}
+
+// Add an event to the callback queue. A received message is only added if there is room, so that a
+// full queue throttles the TCP connection rather than stalling the tick thread; the message is
+// retried later as if the callback had returned kRCMessageActionRetryLater. Other events wait for
+// room in the queue.
+rc_message_action_t queue_event_callback(RCConnection* conn, RCConnEvent* event)
+{
+  if (!RDMNET_ASSERT_VERIFY(conn) || !RDMNET_ASSERT_VERIFY(event))
+    return kRCMessageActionProcessNext;
+
+  bool is_message = (event->which == kRCConnEventMsgReceived);
+  if (!RC_CONN_LOCK(conn))
+  {
+    if (is_message)
+      rc_free_message_resources(event->arg.message);
+    return kRCMessageActionProcessNext;
+  }
+
+  ++conn->num_queued_callbacks;
+  if (is_message)
+  {
+    conn->message_in_flight = true;
+    conn->message_done = false;
+    conn->message_retry = false;
+  }
+  RC_CONN_UNLOCK(conn);
+
+  bool queued = false;
+  if (is_message)
+    queued = rc_callback_queue_push(deliver_queued_event, conn, event, sizeof(RCConnEvent));
+  else
+    queued = rc_callback_queue_push_wait(deliver_queued_event, conn, event, sizeof(RCConnEvent));
+
+  if (!queued && RC_CONN_LOCK(conn))
+  {
+    --conn->num_queued_callbacks;
+    if (is_message)
+      conn->message_in_flight = false;
+    RC_CONN_UNLOCK(conn);
+  }
+
+  // Either way, stop parsing: recv_buf.msg now belongs to the callback queue, or must be retried.
+  return (is_message ? kRCMessageActionRetryLater : kRCMessageActionProcessNext);
+}
+
+void deliver_queued_event(RCQueuedCallback* callback, bool discard)
+{
+  if (!RDMNET_ASSERT_VERIFY(callback))
+    return;
+
+  RCConnection* conn = (RCConnection*)callback->obj;
+  RCConnEvent*  event = (RCConnEvent*)callback->data.bytes;
+  if (!RDMNET_ASSERT_VERIFY(conn))
+    return;
+
+  rc_message_action_t action = kRCMessageActionProcessNext;
+  if (!discard)
+    call_event_callback(conn, event, &action);
+  else if (event->which == kRCConnEventMsgReceived)
+    rc_free_message_resources(event->arg.message);
+
+  if (RC_CONN_LOCK(conn))
+  {
+    if (event->which == kRCConnEventMsgReceived)
+    {
+      conn->message_done = true;
+      conn->message_retry = (action == kRCMessageActionRetryLater);
+      // Woken before the count drops, so the connection can't be destroyed in between.
+      wake_connection(conn);
+    }
+    --conn->num_queued_callbacks;
+    RC_CONN_UNLOCK(conn);
+  }
+
+  // Parsing is blocked until the tick thread sees that the message is done.
+  if (event->which == kRCConnEventMsgReceived)
+    wake_tick_thread();
+}
+
+bool has_queued_callbacks(void* ref, const void* context)
+{
+  ETCPAL_UNUSED_ARG(context);
+
+  RCConnection* conn = (RCConnection*)ref;
+  bool          queued = false;
+  if (RC_CONN_LOCK(conn))
+  {
+    queued = (conn->num_queued_callbacks != 0);
+    RC_CONN_UNLOCK(conn);
+  }
+  return queued;
+}
+
+etcpal_error_t create_wake_socket(void)
+{
+  etcpal_error_t res = etcpal_socket(ETCPAL_AF_INET, ETCPAL_SOCK_DGRAM, &wake_sock);
+  if (res != kEtcPalErrOk)
+    return res;
+
+  ETCPAL_IP_SET_V4_ADDRESS(&wake_addr.ip, 0x7f000001u);
+  wake_addr.port = 0;
+  res = etcpal_bind(wake_sock, &wake_addr);
+  if (res == kEtcPalErrOk)
+    res = etcpal_getsockname(wake_sock, &wake_addr);
+  if (res == kEtcPalErrOk)
+    res = etcpal_setblocking(wake_sock, false);
+  if (res == kEtcPalErrOk)
+  {
+    wake_poll_info.callback = wake_socket_activity_callback;
+    wake_poll_info.data.ptr = NULL;
+    res = rc_add_polled_socket(wake_sock, ETCPAL_POLL_IN, &wake_poll_info);
+  }
+
+  if (res != kEtcPalErrOk)
+  {
+    etcpal_close(wake_sock);
+    wake_sock = ETCPAL_SOCKET_INVALID;
+  }
+  wake_sent = false;
+  return res;
+}
+
+void destroy_wake_socket(void)
+{
+  if (wake_sock != ETCPAL_SOCKET_INVALID)
+  {
+    rc_remove_polled_socket(wake_sock);
+    etcpal_close(wake_sock);
+    wake_sock = ETCPAL_SOCKET_INVALID;
+  }
+}
+
+// Have the tick thread process woken connections as soon as possible. Called from callback threads
+// after wake_connection(); only one wake is outstanding at a time.
+void wake_tick_thread(void)
+{
+  bool send_wake = false;
+  if (etcpal_mutex_lock(&conn_timers_lock))
+  {
+    send_wake = !wake_sent;
+    wake_sent = true;
+    etcpal_mutex_unlock(&conn_timers_lock);
+  }
+
+  if (send_wake)
+  {
+    static const uint8_t kWakeByte = 0;
+    etcpal_sendto(wake_sock, &kWakeByte, 1, 0, &wake_addr);
+  }
+}
+
+void wake_socket_activity_callback(const EtcPalPollEvent* event, RCPolledSocketOpaqueData data)
+{
+  ETCPAL_UNUSED_ARG(data);
+
+  if (!RDMNET_ASSERT_VERIFY(event))
+    return;
+
+  // Drain before clearing wake_sent, so that a wake sent after this point is never lost. Any
+  // connection woken before wake_sent is cleared is already due on conn_timers.
+  uint8_t        buf[16];
+  EtcPalSockAddr from_addr;
+  while (etcpal_recvfrom(wake_sock, buf, sizeof(buf), 0, &from_addr) > 0)
+  {
+  }
+
+  if (etcpal_mutex_lock(&conn_timers_lock))
+  {
+    wake_sent = false;
+    etcpal_mutex_unlock(&conn_timers_lock);
+  }
+
+  process_due_connections();
+}
+
+#endif /* RC_QUEUE_CALLBACKS */
@@ -41,9 +41,11 @@
 #include "etcpal/mutex.h"
 #include "etcpal/timer.h"
 #include "etcpal/socket.h"
+#include "rdmnet/core/callback_queue.h"
 #include "rdmnet/core/common.h"
 #include "rdmnet/core/message.h"
 #include "rdmnet/core/msg_buf.h"
+#include "rdmnet/core/timer_wheel.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -148,6 +150,16 @@ typedef enum
   kRCConnStateMarkedForDestruction
 } rc_client_conn_state_t;
 
+// One of several TCP connections started in parallel by rc_conn_connect_parallel(). The first to
+// connect becomes the connection's socket.
+typedef struct RCConnAttempt
+{
+  RCConnection*      conn;
+  etcpal_socket_t    sock;
+  EtcPalSockAddr     addr;
+  RCPolledSocketInfo poll_info;
+} RCConnAttempt;
+
 // A structure representing the state of an RDMnet connection. Register it with the connection
 // module using rc_connection_register(), after filling out the identifying information at the top
 // (the rest of the members are initialized by rc_connection_register()).
@@ -169,14 +181,41 @@ struct RCConnection
   rc_client_conn_state_t state;
   BrokerClientConnectMsg conn_data;
   EtcPalTimer            backoff_timer;
+  uint32_t               retry_after_hint;  // A busy broker's suggested backoff, or 0. Used once.
   bool                   rdmnet_conn_failed;
   bool                   sent_connected_notification;
   EtcPalTimer            send_timer;
   EtcPalTimer            hb_timer;
+  RCTimerWheelEntry      timer_entry;  // Wakes the connection when its next deadline is due.
+
+  // Parallel connect tracking. num_attempts is 0 unless connecting to more than one address; the
+  // attempts before next_attempt have been started.
+  RCConnAttempt       attempts[RDMNET_CONN_PARALLEL_CONNECT_ADDRS];
+  size_t              num_attempts;
+  size_t              next_attempt;
+  EtcPalTimer         attempt_timer;    // Staggers the start of each attempt.
+  RCConnectFailedInfo attempt_failure;  // The most recent reason an attempt failed.
 
   // Send and receive tracking
   RCMsgBuf recv_buf;
   bool     retry_current_message;  // recv_buf.msg couldn't be processed - retry processing it at a later time.
+
+#if RC_QUEUE_CALLBACKS
+  // Callbacks for this connection waiting in the callback queue. The connection isn't destroyed
+  // until they have all been delivered.
+  size_t num_queued_callbacks;
+
+  // recv_buf.msg has been queued for delivery, so received data can't be parsed until the callback
+  // is done with it. The tick thread sets and clears message_in_flight; the thread delivering the
+  // callback sets message_done and message_retry (if the callback returned kRCMessageActionRetryLater).
+  bool message_in_flight;
+  bool message_done;
+  bool message_retry;
+  bool recv_buf_reset_pending;  // The connection was reset while the message was in flight.
+  // The socket is out of the poll set while parsing is blocked, so unread data waits in the TCP
+  // receive window rather than waking the tick thread over and over. Only used by the tick thread.
+  bool recv_paused;
+#endif
 };
 
 etcpal_error_t rc_conn_module_init(void);
@@ -188,6 +227,10 @@ void           rc_conn_unregister(RCConnection* conn, const rdmnet_disconnect_re
 etcpal_error_t rc_conn_connect(RCConnection*                 conn,
                                const EtcPalSockAddr*         remote_addr,
                                const BrokerClientConnectMsg* connect_data);
+etcpal_error_t rc_conn_connect_parallel(RCConnection*                 conn,
+                                        const EtcPalSockAddr*         remote_addrs,
+                                        size_t                        num_remote_addrs,
+                                        const BrokerClientConnectMsg* connect_data);
 etcpal_error_t rc_conn_reconnect(RCConnection*                 conn,
                                  const EtcPalSockAddr*         new_remote_addr,
                                  const BrokerClientConnectMsg* new_connect_data,
@@ -26,6 +26,8 @@
 #define RDMNET_CORE_EPT_MESSAGE_H_
 
 #include <stdint.h>
+#include "etcpal/acn_rlp.h"
+#include "etcpal/uuid.h"
 #include "rdmnet/defs.h"
 #include "rdmnet/message.h"
 
@@ -33,9 +35,46 @@
 extern "C" {
 #endif
 
+/*
+ * EPT PDU Header:
+ * Flags + Length:   3
+ * Vector:           4
+ * Destination CID: 16
+ * -------------------
+ * Total:           23
+ */
+/* The header size of an EPT PDU (not including encapsulating PDUs) */
+#define EPT_PDU_HEADER_SIZE 23
+/* The header size of an EPT PDU, including encapsulating PDUs */
+#define EPT_PDU_FULL_HEADER_SIZE (EPT_PDU_HEADER_SIZE + ACN_RLP_HEADER_SIZE_EXT_LEN + ACN_TCP_PREAMBLE_SIZE)
+
+/*
+ * EPT Data PDU Header:
+ * Flags + Length:  3
+ * Manufacturer ID: 2
+ * Protocol ID:     2
+ * ------------------
+ * Total:           7
+ */
+#define EPT_DATA_PDU_HEADER_SIZE 7
+
+/*
+ * EPT Status PDU Header:
+ * Flags + Length: 3
+ * Vector:         2
+ * -----------------
+ * Total:          5
+ */
+#define EPT_STATUS_PDU_HEADER_SIZE 5
+
+/** The maximum length of the Status String portion of an EPT Status message. */
+#define EPT_STATUS_STRING_MAXLEN 1024
+
 /** An EPT message. */
 typedef struct EptMessage
 {
+  /** The CID of the EPT client to which this message is addressed. */
+  EtcPalUuid dest_cid;
   /** The vector indicates which type of message is present in the data section. Valid values are
    *  indicated by VECTOR_EPT_* in rdmnet/defs.h. */
   uint32_t vector;
@@ -46,6 +85,34 @@ typedef struct EptMessage
   } data;
 } EptMessage;
 
+/**
+ * @brief Determine whether an EptMessage contains an EPT Data message.
+ * @param eptmsgptr Pointer to EptMessage.
+ * @return (bool) Whether the message contains an EPT Data message.
+ */
+#define EPT_IS_DATA_MSG(eptmsgptr) (RDMNET_ASSERT_VERIFY(eptmsgptr) && ((eptmsgptr)->vector == VECTOR_EPT_DATA))
+
+/**
+ * @brief Get the encapsulated EPT Data message from an EptMessage.
+ * @param eptmsgptr Pointer to EptMessage.
+ * @return Pointer to encapsulated EPT Data message (RdmnetEptData*).
+ */
+#define EPT_GET_DATA_MSG(eptmsgptr) (RDMNET_ASSERT_VERIFY(eptmsgptr) ? &(eptmsgptr)->data.ept_data : NULL)
+
+/**
+ * @brief Determine whether an EptMessage contains an EPT Status message.
+ * @param eptmsgptr Pointer to EptMessage.
+ * @return (bool) Whether the message contains an EPT Status message.
+ */
+#define EPT_IS_STATUS_MSG(eptmsgptr) (RDMNET_ASSERT_VERIFY(eptmsgptr) && ((eptmsgptr)->vector == VECTOR_EPT_STATUS))
+
+/**
+ * @brief Get the encapsulated EPT Status message from an EptMessage.
+ * @param eptmsgptr Pointer to EptMessage.
+ * @return Pointer to encapsulated EPT Status message (RdmnetEptStatus*).
+ */
+#define EPT_GET_STATUS_MSG(eptmsgptr) (RDMNET_ASSERT_VERIFY(eptmsgptr) ? &(eptmsgptr)->data.ept_status : NULL)
+
 #ifdef __cplusplus
 }
 #endif
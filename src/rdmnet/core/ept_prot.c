@@ -0,0 +1,355 @@
+/******************************************************************************
+ * Copyright 2020 ETC Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ ******************************************************************************
+ * This file is a part of RDMnet. For more information, go to:
+ * https://github.com/ETCLabs/RDMnet
+ *****************************************************************************/
+
+#include "rdmnet/core/ept_prot.h"
+
+#include <string.h>
+#include "etcpal/common.h"
+#include "etcpal/pack.h"
+#include "rdmnet/core/common.h"
+#include "rdmnet/defs.h"
+
+/***************************** Private macros ********************************/
+
+/* Helper macros to pack the various EPT headers */
+#define PACK_EPT_DATA_HEADER(length, manu, protocol, buf) \
+  if (RDMNET_ASSERT_VERIFY(buf))                          \
+  {                                                       \
+    (buf)[0] = 0xf0;                                      \
+    ACN_PDU_PACK_EXT_LEN(buf, length);                    \
+    etcpal_pack_u16b(&(buf)[3], manu);                    \
+    etcpal_pack_u16b(&(buf)[5], protocol);                \
+  }
+#define PACK_EPT_STATUS_HEADER(length, vector, buf) \
+  if (RDMNET_ASSERT_VERIFY(buf))                    \
+  {                                                 \
+    (buf)[0] = 0xf0;                                \
+    ACN_PDU_PACK_EXT_LEN(buf, length);              \
+    etcpal_pack_u16b(&(buf)[3], vector);            \
+  }
+
+/*********************** Private function prototypes *************************/
+
+static void           pack_ept_header(size_t length, uint32_t vector, const EtcPalUuid* dest_cid, uint8_t* buf);
+static size_t         pack_ept_header_with_rlp(const AcnRootLayerPdu* rlp,
+                                               uint8_t*               buf,
+                                               size_t                 buflen,
+                                               uint32_t               vector,
+                                               const EtcPalUuid*      dest_cid);
+static etcpal_error_t send_ept_header(RCConnection*          conn,
+                                      const AcnRootLayerPdu* rlp,
+                                      uint32_t               vector,
+                                      const EtcPalUuid*      dest_cid,
+                                      uint8_t*               buf,
+                                      size_t                 buflen);
+static size_t         calc_status_string_len(const char* status_string);
+
+/*************************** Function definitions ****************************/
+
+void pack_ept_header(size_t length, uint32_t vector, const EtcPalUuid* dest_cid, uint8_t* buf)
+{
+  if (!RDMNET_ASSERT_VERIFY(dest_cid) || !RDMNET_ASSERT_VERIFY(buf))
+    return;
+
+  buf[0] = 0xf0;
+  ACN_PDU_PACK_EXT_LEN(buf, length);
+  etcpal_pack_u32b(&buf[3], vector);
+  memcpy(&buf[7], dest_cid->data, ETCPAL_UUID_BYTES);
+}
+
+size_t pack_ept_header_with_rlp(const AcnRootLayerPdu* rlp,
+                                uint8_t*               buf,
+                                size_t                 buflen,
+                                uint32_t               vector,
+                                const EtcPalUuid*      dest_cid)
+{
+  if (!RDMNET_ASSERT_VERIFY(rlp) || !RDMNET_ASSERT_VERIFY(buf) || !RDMNET_ASSERT_VERIFY(dest_cid))
+    return 0;
+
+  uint8_t* cur_ptr = buf;
+  size_t   data_size = acn_root_layer_buf_size(rlp, 1);
+
+  if (data_size == 0)
+    return 0;
+
+  data_size = acn_pack_tcp_preamble(cur_ptr, buflen, data_size);
+  if (data_size == 0)
+    return 0;
+  cur_ptr += data_size;
+  buflen -= data_size;
+
+  data_size = acn_pack_root_layer_header(cur_ptr, buflen, rlp);
+  if (data_size == 0)
+    return 0;
+  cur_ptr += data_size;
+  buflen -= data_size;
+
+  pack_ept_header(rlp->data_len, vector, dest_cid, cur_ptr);
+  cur_ptr += EPT_PDU_HEADER_SIZE;
+  return (size_t)(cur_ptr - buf);
+}
+
+etcpal_error_t send_ept_header(RCConnection*          conn,
+                               const AcnRootLayerPdu* rlp,
+                               uint32_t               vector,
+                               const EtcPalUuid*      dest_cid,
+                               uint8_t*               buf,
+                               size_t                 buflen)
+{
+  if (!RDMNET_ASSERT_VERIFY(conn) || !RDMNET_ASSERT_VERIFY(rlp) || !RDMNET_ASSERT_VERIFY(dest_cid) ||
+      !RDMNET_ASSERT_VERIFY(buf))
+  {
+    return kEtcPalErrSys;
+  }
+
+  // The preamble, Root Layer PDU header and EPT PDU header are small, so they go out in one send.
+  size_t header_size = pack_ept_header_with_rlp(rlp, buf, buflen, vector, dest_cid);
+  if (header_size == 0)
+    return kEtcPalErrProtocol;
+
+  int send_res = rc_send(conn->sock, buf, header_size, 0);
+  if (send_res < 0)
+    return (etcpal_error_t)send_res;
+
+  return kEtcPalErrOk;
+}
+
+size_t calc_status_string_len(const char* status_string)
+{
+  if (!status_string)
+    return 0;
+
+  size_t len = strlen(status_string);
+  return (len > EPT_STATUS_STRING_MAXLEN ? EPT_STATUS_STRING_MAXLEN : len);
+}
+
+/** @brief Get the packed buffer size for an EPT Data message.
+ *  @param[in] data_len Length of the opaque data that will occupy the EPT Data message.
+ *  @return Required buffer size.
+ */
+size_t rc_ept_get_data_buffer_size(size_t data_len)
+{
+  return EPT_PDU_FULL_HEADER_SIZE + EPT_DATA_PDU_HEADER_SIZE + data_len;
+}
+
+/** @brief Get the packed buffer size for an EPT Status message.
+ *  @param[in] status_string Optional status string that will accompany the EPT Status message.
+ *  @return Required buffer size.
+ */
+size_t rc_ept_get_status_buffer_size(const char* status_string)
+{
+  return EPT_PDU_FULL_HEADER_SIZE + EPT_STATUS_PDU_HEADER_SIZE + calc_status_string_len(status_string);
+}
+
+/** @brief Pack an EPT Data message into a buffer.
+ *  @param[out] buf Buffer into which to pack the EPT Data message.
+ *  @param[in] buflen Length in bytes of buf.
+ *  @param[in] local_cid CID of the Component sending the EPT Data message.
+ *  @param[in] dest_cid CID of the EPT Client to which the EPT Data message is addressed.
+ *  @param[in] manufacturer_id ESTA manufacturer ID of the EPT sub-protocol.
+ *  @param[in] protocol_id Protocol ID of the EPT sub-protocol.
+ *  @param[in] data Opaque data that will occupy the EPT Data message.
+ *  @param[in] data_len Length in bytes of data.
+ *  @return Number of bytes packed, or 0 on error.
+ */
+size_t rc_ept_pack_data(uint8_t*          buf,
+                        size_t            buflen,
+                        const EtcPalUuid* local_cid,
+                        const EtcPalUuid* dest_cid,
+                        uint16_t          manufacturer_id,
+                        uint16_t          protocol_id,
+                        const uint8_t*    data,
+                        size_t            data_len)
+{
+  if (!buf || !local_cid || !dest_cid || (!data && data_len != 0) || buflen < rc_ept_get_data_buffer_size(data_len))
+    return 0;
+
+  size_t data_pdu_size = EPT_DATA_PDU_HEADER_SIZE + data_len;
+
+  AcnRootLayerPdu rlp;
+  rlp.sender_cid = *local_cid;
+  rlp.vector = ACN_VECTOR_ROOT_EPT;
+  rlp.data_len = EPT_PDU_HEADER_SIZE + data_pdu_size;
+
+  uint8_t* cur_ptr = buf;
+  size_t   data_size = pack_ept_header_with_rlp(&rlp, buf, buflen, VECTOR_EPT_DATA, dest_cid);
+  if (data_size == 0)
+    return 0;
+  cur_ptr += data_size;
+
+  PACK_EPT_DATA_HEADER(data_pdu_size, manufacturer_id, protocol_id, cur_ptr);
+  cur_ptr += EPT_DATA_PDU_HEADER_SIZE;
+  if (data_len)
+  {
+    memcpy(cur_ptr, data, data_len);
+    cur_ptr += data_len;
+  }
+  return (size_t)(cur_ptr - buf);
+}
+
+/** @brief Send an EPT Data message on an RDMnet connection.
+ *
+ *  The opaque data is handed to the socket directly from the caller's buffer and is not copied.
+ *
+ *  @param[in] conn RDMnet connection on which to send the EPT Data message.
+ *  @param[in] local_cid CID of the Component sending the EPT Data message.
+ *  @param[in] dest_cid CID of the EPT Client to which the EPT Data message is addressed.
+ *  @param[in] manufacturer_id ESTA manufacturer ID of the EPT sub-protocol.
+ *  @param[in] protocol_id Protocol ID of the EPT sub-protocol.
+ *  @param[in] data Opaque data that will occupy the EPT Data message.
+ *  @param[in] data_len Length in bytes of data.
+ *  @return #kEtcPalErrOk: Send success.\n
+ *          #kEtcPalErrInvalid: Invalid argument provided.\n
+ *          #kEtcPalErrSys: An internal library or system call error occurred.\n
+ *          Note: Other error codes might be propagated from underlying socket calls.\n
+ */
+etcpal_error_t rc_ept_send_data(RCConnection*     conn,
+                                const EtcPalUuid* local_cid,
+                                const EtcPalUuid* dest_cid,
+                                uint16_t          manufacturer_id,
+                                uint16_t          protocol_id,
+                                const uint8_t*    data,
+                                size_t            data_len)
+{
+  if (!RDMNET_ASSERT_VERIFY(conn))
+    return kEtcPalErrSys;
+
+  if (!local_cid || !dest_cid || (!data && data_len != 0))
+    return kEtcPalErrInvalid;
+
+  size_t data_pdu_size = EPT_DATA_PDU_HEADER_SIZE + data_len;
+
+  AcnRootLayerPdu rlp;
+  rlp.sender_cid = *local_cid;
+  rlp.vector = ACN_VECTOR_ROOT_EPT;
+  rlp.data_len = EPT_PDU_HEADER_SIZE + data_pdu_size;
+
+  uint8_t        buf[EPT_PDU_FULL_HEADER_SIZE + EPT_DATA_PDU_HEADER_SIZE];
+  etcpal_error_t res = send_ept_header(conn, &rlp, VECTOR_EPT_DATA, dest_cid, buf, EPT_PDU_FULL_HEADER_SIZE);
+  if (res != kEtcPalErrOk)
+    return res;
+
+  PACK_EPT_DATA_HEADER(data_pdu_size, manufacturer_id, protocol_id, buf);
+  int send_res = rc_send(conn->sock, buf, EPT_DATA_PDU_HEADER_SIZE, 0);
+  if (send_res < 0)
+    return (etcpal_error_t)send_res;
+
+  if (data_len)
+  {
+    send_res = rc_send(conn->sock, data, data_len, 0);
+    if (send_res < 0)
+      return (etcpal_error_t)send_res;
+  }
+
+  return kEtcPalErrOk;
+}
+
+/** @brief Pack an EPT Status message into a buffer.
+ *  @param[out] buf Buffer into which to pack the EPT Status message.
+ *  @param[in] buflen Length in bytes of buf.
+ *  @param[in] local_cid CID of the Component sending the EPT Status message.
+ *  @param[in] dest_cid CID of the EPT Client to which the EPT Status message is addressed.
+ *  @param[in] status_code EPT status code.
+ *  @param[in] status_string Optional status string to accompany the code (NULL to omit).
+ *  @return Number of bytes packed, or 0 on error.
+ */
+size_t rc_ept_pack_status(uint8_t*          buf,
+                          size_t            buflen,
+                          const EtcPalUuid* local_cid,
+                          const EtcPalUuid* dest_cid,
+                          ept_status_code_t status_code,
+                          const char*       status_string)
+{
+  if (!buf || !local_cid || !dest_cid || buflen < rc_ept_get_status_buffer_size(status_string))
+    return 0;
+
+  size_t string_len = calc_status_string_len(status_string);
+  size_t status_pdu_size = EPT_STATUS_PDU_HEADER_SIZE + string_len;
+
+  AcnRootLayerPdu rlp;
+  rlp.sender_cid = *local_cid;
+  rlp.vector = ACN_VECTOR_ROOT_EPT;
+  rlp.data_len = EPT_PDU_HEADER_SIZE + status_pdu_size;
+
+  uint8_t* cur_ptr = buf;
+  size_t   data_size = pack_ept_header_with_rlp(&rlp, buf, buflen, VECTOR_EPT_STATUS, dest_cid);
+  if (data_size == 0)
+    return 0;
+  cur_ptr += data_size;
+
+  PACK_EPT_STATUS_HEADER(status_pdu_size, (uint16_t)status_code, cur_ptr);
+  cur_ptr += EPT_STATUS_PDU_HEADER_SIZE;
+  if (string_len)
+  {
+    memcpy(cur_ptr, status_string, string_len);
+    cur_ptr += string_len;
+  }
+  return (size_t)(cur_ptr - buf);
+}
+
+/** @brief Send an EPT Status message on an RDMnet connection.
+ *  @param[in] conn RDMnet connection on which to send the EPT Status message.
+ *  @param[in] local_cid CID of the Component sending the EPT Status message.
+ *  @param[in] dest_cid CID of the EPT Client to which the EPT Status message is addressed.
+ *  @param[in] status_code EPT status code.
+ *  @param[in] status_string Optional status string to accompany the code (NULL to omit).
+ *  @return #kEtcPalErrOk: Send success.\n
+ *          #kEtcPalErrInvalid: Invalid argument provided.\n
+ *          #kEtcPalErrSys: An internal library or system call error occurred.\n
+ *          Note: Other error codes might be propagated from underlying socket calls.\n
+ */
+etcpal_error_t rc_ept_send_status(RCConnection*     conn,
+                                  const EtcPalUuid* local_cid,
+                                  const EtcPalUuid* dest_cid,
+                                  ept_status_code_t status_code,
+                                  const char*       status_string)
+{
+  if (!RDMNET_ASSERT_VERIFY(conn))
+    return kEtcPalErrSys;
+
+  if (!local_cid || !dest_cid)
+    return kEtcPalErrInvalid;
+
+  size_t string_len = calc_status_string_len(status_string);
+  size_t status_pdu_size = EPT_STATUS_PDU_HEADER_SIZE + string_len;
+
+  AcnRootLayerPdu rlp;
+  rlp.sender_cid = *local_cid;
+  rlp.vector = ACN_VECTOR_ROOT_EPT;
+  rlp.data_len = EPT_PDU_HEADER_SIZE + status_pdu_size;
+
+  uint8_t        buf[EPT_PDU_FULL_HEADER_SIZE];
+  etcpal_error_t res = send_ept_header(conn, &rlp, VECTOR_EPT_STATUS, dest_cid, buf, EPT_PDU_FULL_HEADER_SIZE);
+  if (res != kEtcPalErrOk)
+    return res;
+
+  PACK_EPT_STATUS_HEADER(status_pdu_size, (uint16_t)status_code, buf);
+  int send_res = rc_send(conn->sock, buf, EPT_STATUS_PDU_HEADER_SIZE, 0);
+  if (send_res < 0)
+    return (etcpal_error_t)send_res;
+
+  if (string_len)
+  {
+    send_res = rc_send(conn->sock, status_string, string_len, 0);
+    if (send_res < 0)
+      return (etcpal_error_t)send_res;
+  }
+
+  return kEtcPalErrOk;
+}
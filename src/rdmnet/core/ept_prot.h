@@ -0,0 +1,78 @@
+/******************************************************************************
+ * Copyright 2020 ETC Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ ******************************************************************************
+ * This file is a part of RDMnet. For more information, go to:
+ * https://github.com/ETCLabs/RDMnet
+ *****************************************************************************/
+
+/*
+ * rdmnet/core/ept_prot.h
+ * Functions to pack and send EPT PDUs and their encapsulated messages.
+ */
+
+#ifndef RDMNET_CORE_EPT_PROT_H_
+#define RDMNET_CORE_EPT_PROT_H_
+
+#include <stddef.h>
+#include <stdint.h>
+#include "etcpal/error.h"
+#include "etcpal/uuid.h"
+#include "rdmnet/common.h"
+#include "rdmnet/core/connection.h"
+#include "rdmnet/core/ept_message.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* The maximum length of an EPT Status message, including all encapsulating PDUs. */
+#define EPT_STATUS_FULL_MSG_MAX_SIZE (EPT_PDU_FULL_HEADER_SIZE + EPT_STATUS_PDU_HEADER_SIZE + EPT_STATUS_STRING_MAXLEN)
+
+size_t rc_ept_get_data_buffer_size(size_t data_len);
+size_t rc_ept_get_status_buffer_size(const char* status_string);
+
+size_t rc_ept_pack_data(uint8_t*          buf,
+                        size_t            buflen,
+                        const EtcPalUuid* local_cid,
+                        const EtcPalUuid* dest_cid,
+                        uint16_t          manufacturer_id,
+                        uint16_t          protocol_id,
+                        const uint8_t*    data,
+                        size_t            data_len);
+size_t rc_ept_pack_status(uint8_t*          buf,
+                          size_t            buflen,
+                          const EtcPalUuid* local_cid,
+                          const EtcPalUuid* dest_cid,
+                          ept_status_code_t status_code,
+                          const char*       status_string);
+
+etcpal_error_t rc_ept_send_data(RCConnection*     conn,
+                                const EtcPalUuid* local_cid,
+                                const EtcPalUuid* dest_cid,
+                                uint16_t          manufacturer_id,
+                                uint16_t          protocol_id,
+                                const uint8_t*    data,
+                                size_t            data_len);
+etcpal_error_t rc_ept_send_status(RCConnection*     conn,
+                                  const EtcPalUuid* local_cid,
+                                  const EtcPalUuid* dest_cid,
+                                  ept_status_code_t status_code,
+                                  const char*       status_string);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* RDMNET_CORE_EPT_PROT_H_ */
@@ -19,6 +19,7 @@
 
 #include "rdmnet/core/llrp_manager.h"
 
+#include <string.h>
 #include "etcpal/common.h"
 #include "etcpal/inet.h"
 #include "rdm/uid.h"
@@ -62,6 +63,17 @@ typedef struct RCLlrpManagerEvent
     kRCLlrpManagerEventNone        \
   }
 
+#if RC_QUEUE_CALLBACKS
+// An event in the callback queue, with its own copies of the discovered target and RDM parameter
+// data, which otherwise point into the message being handled.
+typedef struct RCLlrpManagerQueuedEvent
+{
+  RCLlrpManagerEvent   event;
+  LlrpDiscoveredTarget discovered_target;
+  uint8_t              rdm_data[RDM_MAX_PDL];
+} RCLlrpManagerQueuedEvent;
+#endif
+
 typedef struct RCLlrpManagerKeys
 {
   EtcPalUuid                 cid;
@@ -79,7 +91,10 @@ typedef struct RCLlrpManagerKeys
 
 /**************************** Private variables ******************************/
 
-RC_DECLARE_REF_LISTS(managers, 1);
+// Managers are indexed by CID and network interface, as one is looked up for every LLRP message
+// received.
+static uint32_t manager_keys_hash(const void* ref);
+RC_DECLARE_INDEXED_REF_LISTS(managers, 1, manager_keys_hash);
 
 /*********************** Private function prototypes *************************/
 
@@ -96,13 +111,20 @@ static bool update_probe_range(RCLlrpManager* manager);
 // Incoming message handling
 static void handle_llrp_message(RCLlrpManager* manager, const LlrpMessage* msg, RCLlrpManagerEvent* event);
 static void deliver_event_callback(RCLlrpManager* manager, RCLlrpManagerEvent* event);
+static void call_event_callback(RCLlrpManager* manager, RCLlrpManagerEvent* event);
+#if RC_QUEUE_CALLBACKS
+static void queue_event_callback(RCLlrpManager* manager, const RCLlrpManagerEvent* event);
+static void deliver_queued_event(RCQueuedCallback* callback, bool discard);
+static bool has_queued_callbacks(void* ref, const void* context);
+#endif
 
 // Utilities
 static EtcPalRbNode*  discovered_target_node_alloc(void);
 static void           discovered_target_node_dealloc(EtcPalRbNode* node);
 static int            discovered_target_compare(const EtcPalRbTree* self, const void* value_a, const void* value_b);
 static void           discovered_target_clear_cb(const EtcPalRbTree* self, EtcPalRbNode* node);
-static RCLlrpManager* find_manager_by_message_keys(const RCRefList* list, const RCLlrpManagerKeys* keys);
+static RCLlrpManager* find_manager_by_message_keys(const RCLlrpManagerKeys* keys);
+static uint32_t       hash_keys(const EtcPalUuid* cid, const EtcPalMcastNetintId* netint);
 
 /*************************** Function definitions ****************************/
 
@@ -143,6 +165,9 @@ etcpal_error_t rc_llrp_manager_register(RCLlrpManager* manager)
   manager->num_clean_sends = 0;
   manager->disc_filter = 0;
   manager->num_known_uids = 0;
+#if RC_QUEUE_CALLBACKS
+  manager->num_queued_callbacks = 0;
+#endif
   etcpal_rbtree_init(&manager->discovered_targets, discovered_target_compare, discovered_target_node_alloc,
                      discovered_target_node_dealloc);
   return kEtcPalErrOk;
@@ -246,7 +271,11 @@ void rc_llrp_manager_module_tick(void)
   // Remove any managers marked for destruction.
   if (rdmnet_writelock())
   {
-    rc_ref_lists_remove_marked(&managers, (RCRefFunction)cleanup_manager_resources, NULL);
+#if RC_QUEUE_CALLBACKS
+    // Managers are only destroyed once every callback queued for them has been delivered.
+    if (!rc_ref_list_find_ref(&managers.to_remove, has_queued_callbacks, NULL))
+#endif
+      rc_ref_lists_remove_marked(&managers, (RCRefFunction)cleanup_manager_resources, NULL);
     rc_ref_lists_add_pending(&managers);
     rdmnet_writeunlock();
   }
@@ -267,7 +296,7 @@ void rc_llrp_manager_data_received(const uint8_t* data, size_t data_len, const E
     keys.netint = netint;
     bool manager_found = false;
 
-    RCLlrpManager* manager = find_manager_by_message_keys(&managers.active, &keys);
+    RCLlrpManager* manager = find_manager_by_message_keys(&keys);
     if (manager)
     {
       manager_found = true;
@@ -569,6 +598,19 @@ void handle_llrp_message(RCLlrpManager* manager, const LlrpMessage* msg, RCLlrpM
 }
 
 void deliver_event_callback(RCLlrpManager* manager, RCLlrpManagerEvent* event)
+{
+  if (!RDMNET_ASSERT_VERIFY(manager) || !RDMNET_ASSERT_VERIFY(event))
+    return;
+
+#if RC_QUEUE_CALLBACKS
+  if (event->which != kRCLlrpManagerEventNone)
+    queue_event_callback(manager, event);
+#else
+  call_event_callback(manager, event);
+#endif
+}
+
+void call_event_callback(RCLlrpManager* manager, RCLlrpManagerEvent* event)
 {
   if (!RDMNET_ASSERT_VERIFY(manager) || !RDMNET_ASSERT_VERIFY(event))
     return;
@@ -593,6 +635,79 @@ void deliver_event_callback(RCLlrpManager* manager, RCLlrpManagerEvent* event)
   }
 }
 
+#if RC_QUEUE_CALLBACKS
+void queue_event_callback(RCLlrpManager* manager, const RCLlrpManagerEvent* event)
+{
+  if (!RDMNET_ASSERT_VERIFY(manager) || !RDMNET_ASSERT_VERIFY(event))
+    return;
+
+  RCLlrpManagerQueuedEvent queued_event;
+  queued_event.event = *event;
+  if (event->which == kRCLlrpManagerEventTargetDiscovered)
+  {
+    if (!RDMNET_ASSERT_VERIFY(event->args.discovered_target))
+      return;
+    queued_event.discovered_target = *event->args.discovered_target;
+  }
+  else if (event->which == kRCLlrpManagerEventRdmRespReceived && event->args.rdm_response.rdm_data_len > 0)
+  {
+    memcpy(queued_event.rdm_data, event->args.rdm_response.rdm_data, event->args.rdm_response.rdm_data_len);
+  }
+
+  if (!MANAGER_LOCK(manager))
+    return;
+  ++manager->num_queued_callbacks;
+  MANAGER_UNLOCK(manager);
+
+  if (!rc_callback_queue_push_wait(deliver_queued_event, manager, &queued_event, sizeof(queued_event)) &&
+      MANAGER_LOCK(manager))
+  {
+    --manager->num_queued_callbacks;
+    MANAGER_UNLOCK(manager);
+  }
+}
+
+void deliver_queued_event(RCQueuedCallback* callback, bool discard)
+{
+  if (!RDMNET_ASSERT_VERIFY(callback))
+    return;
+
+  RCLlrpManager*            manager = (RCLlrpManager*)callback->obj;
+  RCLlrpManagerQueuedEvent* queued_event = (RCLlrpManagerQueuedEvent*)callback->data.bytes;
+  if (!RDMNET_ASSERT_VERIFY(manager))
+    return;
+
+  if (!discard)
+  {
+    if (queued_event->event.which == kRCLlrpManagerEventTargetDiscovered)
+      queued_event->event.args.discovered_target = &queued_event->discovered_target;
+    else if (queued_event->event.which == kRCLlrpManagerEventRdmRespReceived)
+      queued_event->event.args.rdm_response.rdm_data = queued_event->rdm_data;
+    call_event_callback(manager, &queued_event->event);
+  }
+
+  if (MANAGER_LOCK(manager))
+  {
+    --manager->num_queued_callbacks;
+    MANAGER_UNLOCK(manager);
+  }
+}
+
+bool has_queued_callbacks(void* ref, const void* context)
+{
+  ETCPAL_UNUSED_ARG(context);
+
+  RCLlrpManager* manager = (RCLlrpManager*)ref;
+  bool           queued = false;
+  if (MANAGER_LOCK(manager))
+  {
+    queued = (manager->num_queued_callbacks != 0);
+    MANAGER_UNLOCK(manager);
+  }
+  return queued;
+}
+#endif
+
 EtcPalRbNode* discovered_target_node_alloc(void)
 {
 #if RDMNET_DYNAMIC_MEM
@@ -658,10 +773,27 @@ static bool cid_and_netint_equal_predicate(void* ref, const void* context)
           (ETCPAL_UUID_CMP(&manager->cid, &keys->cid) == 0));
 }
 
-RCLlrpManager* find_manager_by_message_keys(const RCRefList* list, const RCLlrpManagerKeys* keys)
+RCLlrpManager* find_manager_by_message_keys(const RCLlrpManagerKeys* keys)
 {
-  if (!RDMNET_ASSERT_VERIFY(list) || !RDMNET_ASSERT_VERIFY(keys))
+  if (!RDMNET_ASSERT_VERIFY(keys) || !RDMNET_ASSERT_VERIFY(keys->netint))
     return NULL;
 
-  return (RCLlrpManager*)rc_ref_list_find_ref(list, cid_and_netint_equal_predicate, keys);
+  return (RCLlrpManager*)rc_ref_lists_find_active(&managers, hash_keys(&keys->cid, keys->netint),
+                                                  cid_and_netint_equal_predicate, keys);
+}
+
+uint32_t manager_keys_hash(const void* ref)
+{
+  if (!RDMNET_ASSERT_VERIFY(ref))
+    return 0;
+
+  const RCLlrpManager* manager = (const RCLlrpManager*)ref;
+  return hash_keys(&manager->cid, &manager->netint);
+}
+
+uint32_t hash_keys(const EtcPalUuid* cid, const EtcPalMcastNetintId* netint)
+{
+  uint32_t hash = rc_hash_bytes(cid->data, ETCPAL_UUID_BYTES, RC_HASH_INIT);
+  hash = rc_hash_bytes(&netint->index, sizeof(netint->index), hash);
+  return rc_hash_bytes(&netint->ip_type, sizeof(netint->ip_type), hash);
 }
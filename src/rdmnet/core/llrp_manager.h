@@ -28,6 +28,7 @@
 #include "rdm/uid.h"
 #include "rdmnet/llrp.h"
 #include "rdmnet/message.h"
+#include "rdmnet/core/callback_queue.h"
 #include "rdmnet/core/llrp_prot.h"
 
 #ifdef __cplusplus
@@ -85,6 +86,12 @@ struct RCLlrpManager
   RdmUid       cur_range_high;
   RdmUid       known_uids[LLRP_KNOWN_UID_SIZE];
   size_t       num_known_uids;
+
+#if RC_QUEUE_CALLBACKS
+  // Callbacks for this manager waiting in the callback queue. The manager isn't destroyed until
+  // they have all been delivered.
+  size_t num_queued_callbacks;
+#endif
 };
 
 etcpal_error_t rc_llrp_manager_module_init(void);
@@ -19,6 +19,7 @@
 
 #include "rdmnet/core/llrp_target.h"
 
+#include <string.h>
 #include "etcpal/inet.h"
 #include "rdm/responder.h"
 #include "rdmnet/core/common.h"
@@ -44,6 +45,16 @@ typedef struct RCLlrpTargetEvent
     kRCLlrpTargetEventNone        \
   }
 
+#if RC_QUEUE_CALLBACKS
+// An event in the callback queue, with its own copy of the RDM parameter data, which is otherwise
+// parsed in place from a receive buffer.
+typedef struct RCLlrpTargetQueuedEvent
+{
+  RCLlrpTargetEvent event;
+  uint8_t           rdm_data[RDM_MAX_PDL];
+} RCLlrpTargetQueuedEvent;
+#endif
+
 typedef struct LlrpTargetIncomingMessage
 {
   const uint8_t*             data;
@@ -62,7 +73,9 @@ typedef struct LlrpTargetIncomingMessage
 
 /**************************** Private variables ******************************/
 
-RC_DECLARE_REF_LISTS(targets, RC_MAX_LLRP_TARGETS);
+// Targets are indexed by CID, as one is looked up for every LLRP message received.
+static uint32_t target_cid_hash(const void* ref);
+RC_DECLARE_INDEXED_REF_LISTS(targets, RC_MAX_LLRP_TARGETS, target_cid_hash);
 
 /*********************** Private function prototypes *************************/
 
@@ -79,6 +92,12 @@ static void process_target_state(RCLlrpTarget* target, const void* context);
 // Incoming message handling
 static void           target_handle_llrp_message(RCLlrpTarget* target, const LlrpTargetIncomingMessage* message);
 static void           deliver_event_callback(RCLlrpTarget* target, RCLlrpTargetEvent* event);
+static void           call_event_callback(RCLlrpTarget* target, RCLlrpTargetEvent* event);
+#if RC_QUEUE_CALLBACKS
+static void queue_event_callback(RCLlrpTarget* target, const RCLlrpTargetEvent* event);
+static void deliver_queued_event(RCQueuedCallback* callback, bool discard);
+static bool has_queued_callbacks(void* ref, const void* context);
+#endif
 static void           send_response_if_requested(RCLlrpTarget*                target,
                                                  const RCLlrpTargetEvent*     event,
                                                  RCLlrpTargetSyncRdmResponse* response);
@@ -97,7 +116,8 @@ static etcpal_error_t target_send_nack_internal(RCLlrpTarget*              targe
                                                 rdm_nack_reason_t          nack_reason);
 
 // Utilities
-static RCLlrpTarget* find_target_by_cid(const RCRefList* list, const EtcPalUuid* cid);
+static RCLlrpTarget* find_target_by_cid(const EtcPalUuid* cid);
+static uint32_t      hash_cid(const EtcPalUuid* cid);
 static int           netint_id_index_in_llrp_array(const EtcPalMcastNetintId*    id,
                                                    const RCLlrpTargetNetintInfo* array,
                                                    size_t                        array_size);
@@ -154,6 +174,9 @@ etcpal_error_t rc_llrp_target_register(RCLlrpTarget* target)
     target->uid.id = (uint32_t)rand();
   }
   target->connected_to_broker = false;
+#if RC_QUEUE_CALLBACKS
+  target->num_queued_callbacks = 0;
+#endif
   return kEtcPalErrOk;
 }
 
@@ -207,7 +230,11 @@ void rc_llrp_target_module_tick(void)
 {
   if (rdmnet_writelock())
   {
-    rc_ref_lists_remove_marked(&targets, (RCRefFunction)cleanup_target_resources, NULL);
+#if RC_QUEUE_CALLBACKS
+    // Targets are only destroyed once every callback queued for them has been delivered.
+    if (!rc_ref_list_find_ref(&targets.to_remove, has_queued_callbacks, NULL))
+#endif
+      rc_ref_lists_remove_marked(&targets, (RCRefFunction)cleanup_target_resources, NULL);
     rc_ref_lists_add_pending(&targets);
     rdmnet_writeunlock();
   }
@@ -237,7 +264,7 @@ void rc_llrp_target_data_received(const uint8_t* data, size_t data_len, const Et
     }
     else
     {
-      RCLlrpTarget* target = find_target_by_cid(&targets.active, &dest_cid);
+      RCLlrpTarget* target = find_target_by_cid(&dest_cid);
       if (target)
       {
         target_found = true;
@@ -482,6 +509,19 @@ void target_handle_llrp_message(RCLlrpTarget* target, const LlrpTargetIncomingMe
 }
 
 void deliver_event_callback(RCLlrpTarget* target, RCLlrpTargetEvent* event)
+{
+  if (!RDMNET_ASSERT_VERIFY(target) || !RDMNET_ASSERT_VERIFY(event))
+    return;
+
+#if RC_QUEUE_CALLBACKS
+  if (event->which != kRCLlrpTargetEventNone)
+    queue_event_callback(target, event);
+#else
+  call_event_callback(target, event);
+#endif
+}
+
+void call_event_callback(RCLlrpTarget* target, RCLlrpTargetEvent* event)
 {
   if (!RDMNET_ASSERT_VERIFY(target) || !RDMNET_ASSERT_VERIFY(event))
     return;
@@ -492,8 +532,23 @@ void deliver_event_callback(RCLlrpTarget* target, RCLlrpTargetEvent* event)
       if (target->callbacks.rdm_command_received)
       {
         RCLlrpTargetSyncRdmResponse response = RC_LLRP_TARGET_SYNC_RDM_RESPONSE_INIT;
+#if RC_QUEUE_CALLBACKS
+        if (target->resp_lock)
+          etcpal_mutex_lock(target->resp_lock);
+#endif
         target->callbacks.rdm_command_received(target, &event->rdm_cmd, &response);
+#if RC_QUEUE_CALLBACKS
+        // Off the tick thread, the send buffers are shared with process_target_state().
+        if (TARGET_LOCK(target))
+        {
+          send_response_if_requested(target, event, &response);
+          TARGET_UNLOCK(target);
+        }
+        if (target->resp_lock)
+          etcpal_mutex_unlock(target->resp_lock);
+#else
         send_response_if_requested(target, event, &response);
+#endif
       }
       break;
     case kRCLlrpTargetEventNone:
@@ -502,6 +557,68 @@ void deliver_event_callback(RCLlrpTarget* target, RCLlrpTargetEvent* event)
   }
 }
 
+#if RC_QUEUE_CALLBACKS
+void queue_event_callback(RCLlrpTarget* target, const RCLlrpTargetEvent* event)
+{
+  if (!RDMNET_ASSERT_VERIFY(target) || !RDMNET_ASSERT_VERIFY(event))
+    return;
+
+  RCLlrpTargetQueuedEvent queued_event;
+  queued_event.event = *event;
+  if (event->which == kRCLlrpTargetEventRdmCmdReceived && event->rdm_cmd.data_len > 0)
+    memcpy(queued_event.rdm_data, event->rdm_cmd.data, event->rdm_cmd.data_len);
+
+  if (!TARGET_LOCK(target))
+    return;
+  ++target->num_queued_callbacks;
+  TARGET_UNLOCK(target);
+
+  if (!rc_callback_queue_push_wait(deliver_queued_event, target, &queued_event, sizeof(queued_event)) &&
+      TARGET_LOCK(target))
+  {
+    --target->num_queued_callbacks;
+    TARGET_UNLOCK(target);
+  }
+}
+
+void deliver_queued_event(RCQueuedCallback* callback, bool discard)
+{
+  if (!RDMNET_ASSERT_VERIFY(callback))
+    return;
+
+  RCLlrpTarget*            target = (RCLlrpTarget*)callback->obj;
+  RCLlrpTargetQueuedEvent* queued_event = (RCLlrpTargetQueuedEvent*)callback->data.bytes;
+  if (!RDMNET_ASSERT_VERIFY(target))
+    return;
+
+  if (!discard)
+  {
+    queued_event->event.rdm_cmd.data = queued_event->rdm_data;
+    call_event_callback(target, &queued_event->event);
+  }
+
+  if (TARGET_LOCK(target))
+  {
+    --target->num_queued_callbacks;
+    TARGET_UNLOCK(target);
+  }
+}
+
+bool has_queued_callbacks(void* ref, const void* context)
+{
+  ETCPAL_UNUSED_ARG(context);
+
+  RCLlrpTarget* target = (RCLlrpTarget*)ref;
+  bool          queued = false;
+  if (TARGET_LOCK(target))
+  {
+    queued = (target->num_queued_callbacks != 0);
+    TARGET_UNLOCK(target);
+  }
+  return queued;
+}
+#endif
+
 void send_response_if_requested(RCLlrpTarget*                target,
                                 const RCLlrpTargetEvent*     event,
                                 RCLlrpTargetSyncRdmResponse* response)
@@ -658,12 +775,25 @@ static bool cid_is_equal_predicate(void* ref, const void* context)
   return (ETCPAL_UUID_CMP(&target->cid, cid) == 0);
 }
 
-RCLlrpTarget* find_target_by_cid(const RCRefList* list, const EtcPalUuid* cid)
+RCLlrpTarget* find_target_by_cid(const EtcPalUuid* cid)
 {
-  if (!RDMNET_ASSERT_VERIFY(list) || !RDMNET_ASSERT_VERIFY(cid))
+  if (!RDMNET_ASSERT_VERIFY(cid))
     return NULL;
 
-  return (RCLlrpTarget*)rc_ref_list_find_ref(list, cid_is_equal_predicate, cid);
+  return (RCLlrpTarget*)rc_ref_lists_find_active(&targets, hash_cid(cid), cid_is_equal_predicate, cid);
+}
+
+uint32_t target_cid_hash(const void* ref)
+{
+  if (!RDMNET_ASSERT_VERIFY(ref))
+    return 0;
+
+  return hash_cid(&((const RCLlrpTarget*)ref)->cid);
+}
+
+uint32_t hash_cid(const EtcPalUuid* cid)
+{
+  return rc_hash_bytes(cid->data, ETCPAL_UUID_BYTES, RC_HASH_INIT);
 }
 
 int netint_id_index_in_llrp_array(const EtcPalMcastNetintId* id, const RCLlrpTargetNetintInfo* array, size_t array_size)
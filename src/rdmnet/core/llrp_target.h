@@ -24,6 +24,7 @@
 #include "etcpal/mutex.h"
 #include "etcpal/timer.h"
 #include "rdmnet/llrp_target.h"
+#include "rdmnet/core/callback_queue.h"
 #include "rdmnet/core/common.h"
 #include "rdmnet/core/llrp_prot.h"
 #include "rdmnet/core/util.h"
@@ -84,6 +85,11 @@ typedef struct RCLlrpTarget
   llrp_component_t      component_type;
   RCLlrpTargetCallbacks callbacks;
   etcpal_mutex_t*       lock;
+#if RC_QUEUE_CALLBACKS
+  // If not NULL, held from the rdm_command_received callback until its response has been sent, for
+  // a target whose response buffer is shared with objects whose callbacks run on other threads.
+  etcpal_mutex_t* resp_lock;
+#endif
 
   /////////////////////////////////////////////////////////////////////////////
 
@@ -91,6 +97,12 @@ typedef struct RCLlrpTarget
 
   // Global target state info
   bool connected_to_broker;
+
+#if RC_QUEUE_CALLBACKS
+  // Callbacks for this target waiting in the callback queue. The target isn't destroyed until they
+  // have all been delivered.
+  size_t num_queued_callbacks;
+#endif
 } RCLlrpTarget;
 
 etcpal_error_t rc_llrp_target_module_init(void);
@@ -17,6 +17,20 @@
  * https://github.com/ETCLabs/RDMnet
  *****************************************************************************/
 
+// These are defined before the includes to enable ETCPAL_MAX_CONTROL_SIZE_PKTINFO, recvmmsg() and sendmmsg() support
+// on Mac & Linux.
+#if defined(__linux__) || defined(__APPLE__)
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif  // _GNU_SOURCE
+#endif  // defined(__linux__) || defined(__APPLE__)
+
+#if defined(__APPLE__)
+#ifndef __APPLE_USE_RFC_3542
+#define __APPLE_USE_RFC_3542
+#endif  // __APPLE_USE_RFC_3542
+#endif  // defined(__APPLE__)
+
 #include "rdmnet/core/mcast.h"
 
 #include <assert.h>
@@ -31,11 +45,32 @@
 #include <stdlib.h>
 #endif
 
+#if defined(__linux__)
+#include <errno.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#endif
+
+#if defined(__linux__) && (RDMNET_MCAST_RECV_BATCH_SIZE > 1)
+#define RC_MCAST_USE_RECVMMSG 1
+#else
+#define RC_MCAST_USE_RECVMMSG 0
+#endif
+
+#if defined(__linux__)
+#define RC_MCAST_USE_SENDMMSG 1
+#else
+#define RC_MCAST_USE_SENDMMSG 0
+#endif
+
 /**************************** Private constants ******************************/
 
 #define MULTICAST_TTL_VAL 20
 #define MAX_SEND_NETINT_SOURCE_PORTS 2
 
+// The number of interfaces sent to with each sendmmsg() call.
+#define SEND_BATCH_SIZE 16
+
 /****************************** Private types ********************************/
 
 typedef struct McastSendSocket
@@ -47,6 +82,7 @@ typedef struct McastSendSocket
 
 typedef struct McastNetintInfo
 {
+  EtcPalIpAddr    addr;  // The first address found for this interface and IP type.
   McastSendSocket send_sockets[MAX_SEND_NETINT_SOURCE_PORTS];
 } McastNetintInfo;
 
@@ -65,13 +101,36 @@ static EtcPalMacAddr lowest_mac;
 /*********************** Private function prototypes *************************/
 
 static bool validate_netint_config(const RdmnetNetintConfig* config);
-static void test_mcast_netint(const EtcPalMcastNetintId* netint_id, const char* addr_str);
-static void add_mcast_netint(const EtcPalMcastNetintId* netint_id, const char* addr_str);
+static void test_mcast_netint(const EtcPalMcastNetintId* netint_id, const EtcPalIpAddr* addr, const char* addr_str);
+static void add_mcast_netint(const EtcPalMcastNetintId* netint_id, const EtcPalIpAddr* addr, const char* addr_str);
 
 static etcpal_error_t create_send_socket(const EtcPalMcastNetintId* netint_id,
                                          uint16_t                   source_port,
                                          etcpal_socket_t*           socket);
 
+static bool get_pktinfo_netint(EtcPalMsgHdr* msg, EtcPalMcastNetintId* netint_id);
+static void fill_recv_msg(RCMcastRecvMsg* recv_msg, EtcPalMsgHdr* msg, size_t data_len);
+#if RC_MCAST_USE_RECVMMSG
+static int recv_batch_recvmmsg(etcpal_socket_t socket,
+                               uint8_t*        storage,
+                               size_t          msg_buf_size,
+                               RCMcastRecvMsg* msgs,
+                               size_t          max_msgs);
+#endif
+static int recv_batch_loop(etcpal_socket_t socket,
+                           uint8_t*        storage,
+                           size_t          msg_buf_size,
+                           RCMcastRecvMsg* msgs,
+                           size_t          max_msgs);
+#if RC_MCAST_USE_SENDMMSG
+static etcpal_error_t send_to_netints_sendmmsg(const RCMcastSendNetint* netints,
+                                               size_t                   num_netints,
+                                               etcpal_iptype_t          ip_type,
+                                               const uint8_t*           data,
+                                               size_t                   data_len,
+                                               const EtcPalSockAddr*    dest);
+#endif
+
 static McastNetintInfo* get_mcast_netint_info(const EtcPalMcastNetintId* id);
 static McastSendSocket* get_send_socket(McastNetintInfo* netint_info, uint16_t source_port);
 static McastSendSocket* get_unused_send_socket(McastNetintInfo* netint_info);
@@ -180,7 +239,7 @@ etcpal_error_t rc_mcast_module_init(const RdmnetNetintConfig* netint_config)
         continue;
       }
 
-      test_mcast_netint(&netint_id, addr_str);
+      test_mcast_netint(&netint_id, &netint->addr, addr_str);
     }
 
     if ((num_mcast_netints == 0) && (!netint_config || !netint_config->no_netints))
@@ -244,6 +303,23 @@ const EtcPalMacAddr* rc_mcast_get_lowest_mac_addr(void)
   return &lowest_mac;
 }
 
+/*
+ * Get an IP address of a multicast network interface, of the interface's IP type. Returns false if
+ * the interface is not in use for multicast.
+ */
+bool rc_mcast_get_netint_addr(const EtcPalMcastNetintId* id, EtcPalIpAddr* addr)
+{
+  if (!RDMNET_ASSERT_VERIFY(id) || !RDMNET_ASSERT_VERIFY(addr))
+    return false;
+
+  const McastNetintInfo* netint_info = get_mcast_netint_info(id);
+  if (!netint_info)
+    return false;
+
+  *addr = netint_info->addr;
+  return true;
+}
+
 etcpal_error_t rc_mcast_get_send_socket(const EtcPalMcastNetintId* id, uint16_t source_port, etcpal_socket_t* socket)
 {
   if (!RDMNET_ASSERT_VERIFY(id) || !RDMNET_ASSERT_VERIFY(socket))
@@ -347,6 +423,13 @@ etcpal_error_t rc_mcast_create_recv_socket(const EtcPalIpAddr* group, uint16_t p
     res = etcpal_setsockopt(sock, ETCPAL_SOL_SOCKET, ETCPAL_SO_REUSEADDR, &value, sizeof value);
   }
 
+  if (res == kEtcPalErrOk)
+  {
+    // Receive sockets are drained in batches by rc_mcast_recv_batch(), which relies on the socket
+    // being non-blocking to know when the queue is empty.
+    res = etcpal_setblocking(sock, false);
+  }
+
   if (res == kEtcPalErrOk)
   {
     // We also set SO_REUSEPORT but don't check the return, because it is not applicable on all platforms
@@ -409,6 +492,90 @@ etcpal_error_t rc_mcast_unsubscribe_recv_socket(etcpal_socket_t            socke
                            ETCPAL_MCAST_LEAVE_GROUP, (const void*)&group_req, sizeof(group_req));
 }
 
+/*
+ * Read as many queued datagrams as possible (up to max_msgs) from a multicast receive socket
+ * created with rc_mcast_create_recv_socket().
+ *
+ * storage must point to max_msgs contiguous receive buffers, each msg_buf_size bytes long. On
+ * return, each filled entry in msgs points into its corresponding buffer.
+ *
+ * Returns the number of datagrams received (0 if none were queued), or a negative etcpal_error_t
+ * value if an error occurred before any datagrams could be received.
+ */
+int rc_mcast_recv_batch(etcpal_socket_t socket,
+                        uint8_t*        storage,
+                        size_t          msg_buf_size,
+                        RCMcastRecvMsg* msgs,
+                        size_t          max_msgs)
+{
+  if (!RDMNET_ASSERT_VERIFY(storage) || !RDMNET_ASSERT_VERIFY(msgs) || !RDMNET_ASSERT_VERIFY(max_msgs > 0))
+    return (int)kEtcPalErrSys;
+
+  if (max_msgs > RDMNET_MCAST_RECV_BATCH_SIZE)
+    max_msgs = RDMNET_MCAST_RECV_BATCH_SIZE;
+
+#if RC_MCAST_USE_RECVMMSG
+  // recvmmsg() can still be unavailable at runtime (e.g. filtered out by a seccomp policy), in which
+  // case the datagrams are read one at a time instead.
+  int res = recv_batch_recvmmsg(socket, storage, msg_buf_size, msgs, max_msgs);
+  if (res != (int)kEtcPalErrNotImpl)
+    return res;
+#endif
+  return recv_batch_loop(socket, storage, msg_buf_size, msgs, max_msgs);
+}
+
+/*
+ * Send one packed datagram to a multicast destination on each of a set of interfaces, using send
+ * sockets obtained with rc_mcast_get_send_socket(). IPv4 interfaces are sent to at v4_dest and
+ * IPv6 interfaces at v6_dest; if either destination is NULL, interfaces of that IP type are
+ * skipped.
+ *
+ * Where sendmmsg() is available, all the interfaces of each IP type are sent to with a single
+ * system call, selecting each interface with IP_PKTINFO/IPV6_PKTINFO ancillary data. Otherwise,
+ * the datagram is sent on each interface's socket in turn.
+ *
+ * The datagram is sent on every interface even if some sends fail; the last error encountered is
+ * returned.
+ */
+etcpal_error_t rc_mcast_send_to_netints(const RCMcastSendNetint* netints,
+                                        size_t                   num_netints,
+                                        const uint8_t*           data,
+                                        size_t                   data_len,
+                                        const EtcPalSockAddr*    v4_dest,
+                                        const EtcPalSockAddr*    v6_dest)
+{
+  if (!RDMNET_ASSERT_VERIFY(netints || num_netints == 0) || !RDMNET_ASSERT_VERIFY(data))
+    return kEtcPalErrSys;
+
+  etcpal_error_t res = kEtcPalErrOk;
+#if RC_MCAST_USE_SENDMMSG
+  if (v4_dest)
+  {
+    etcpal_error_t send_res = send_to_netints_sendmmsg(netints, num_netints, kEtcPalIpTypeV4, data, data_len, v4_dest);
+    if (send_res != kEtcPalErrOk)
+      res = send_res;
+  }
+  if (v6_dest)
+  {
+    etcpal_error_t send_res = send_to_netints_sendmmsg(netints, num_netints, kEtcPalIpTypeV6, data, data_len, v6_dest);
+    if (send_res != kEtcPalErrOk)
+      res = send_res;
+  }
+#else
+  for (const RCMcastSendNetint* netint = netints; netint < netints + num_netints; ++netint)
+  {
+    const EtcPalSockAddr* dest = (netint->id.ip_type == kEtcPalIpTypeV6 ? v6_dest : v4_dest);
+    if (!dest)
+      continue;
+
+    int send_res = etcpal_sendto(netint->socket, data, data_len, 0, dest);
+    if (send_res < 0)
+      res = (etcpal_error_t)send_res;
+  }
+#endif
+  return res;
+}
+
 bool validate_netint_config(const RdmnetNetintConfig* config)
 {
   if (!RDMNET_ASSERT_VERIFY(config))
@@ -430,9 +597,9 @@ bool validate_netint_config(const RdmnetNetintConfig* config)
   return true;
 }
 
-void test_mcast_netint(const EtcPalMcastNetintId* netint_id, const char* addr_str)
+void test_mcast_netint(const EtcPalMcastNetintId* netint_id, const EtcPalIpAddr* addr, const char* addr_str)
 {
-  if (!RDMNET_ASSERT_VERIFY(netint_id) || !RDMNET_ASSERT_VERIFY(addr_str))
+  if (!RDMNET_ASSERT_VERIFY(netint_id) || !RDMNET_ASSERT_VERIFY(addr) || !RDMNET_ASSERT_VERIFY(addr_str))
     return;
 
   // create_send_socket() also tests setting the relevant send socket options and the
@@ -466,7 +633,7 @@ void test_mcast_netint(const EtcPalMcastNetintId* netint_id, const char* addr_st
 
   if (test_res == kEtcPalErrOk)
   {
-    add_mcast_netint(netint_id, addr_str);
+    add_mcast_netint(netint_id, addr, addr_str);
   }
   else
   {
@@ -477,9 +644,9 @@ void test_mcast_netint(const EtcPalMcastNetintId* netint_id, const char* addr_st
   }
 }
 
-void add_mcast_netint(const EtcPalMcastNetintId* netint_id, const char* addr_str)
+void add_mcast_netint(const EtcPalMcastNetintId* netint_id, const EtcPalIpAddr* addr, const char* addr_str)
 {
-  if (!RDMNET_ASSERT_VERIFY(netint_id) || !RDMNET_ASSERT_VERIFY(addr_str))
+  if (!RDMNET_ASSERT_VERIFY(netint_id) || !RDMNET_ASSERT_VERIFY(addr) || !RDMNET_ASSERT_VERIFY(addr_str))
     return;
 
 #if RDMNET_DYNAMIC_MEM
@@ -510,6 +677,8 @@ void add_mcast_netint(const EtcPalMcastNetintId* netint_id, const char* addr_str
     if (!RDMNET_ASSERT_VERIFY(netint_info->send_sockets))
       return;
 
+    netint_info->addr = *addr;
+
     for (McastSendSocket* send_socket = netint_info->send_sockets;
          send_socket < netint_info->send_sockets + MAX_SEND_NETINT_SOURCE_PORTS; ++send_socket)
     {
@@ -574,6 +743,242 @@ etcpal_error_t create_send_socket(const EtcPalMcastNetintId* netint, uint16_t so
   return res;
 }
 
+bool get_pktinfo_netint(EtcPalMsgHdr* msg, EtcPalMcastNetintId* netint_id)
+{
+  if (!RDMNET_ASSERT_VERIFY(msg) || !RDMNET_ASSERT_VERIFY(netint_id))
+    return false;
+
+  EtcPalCMsgHdr cmsg = {0};
+  EtcPalPktInfo pktinfo = {{0}};
+  bool          pktinfo_found = false;
+  if (etcpal_cmsg_firsthdr(msg, &cmsg))
+  {
+    do
+    {
+      pktinfo_found = etcpal_cmsg_to_pktinfo(&cmsg, &pktinfo);
+    } while (!pktinfo_found && etcpal_cmsg_nxthdr(msg, &cmsg, &cmsg));
+  }
+
+  if (pktinfo_found)
+  {
+    netint_id->index = pktinfo.ifindex;
+    netint_id->ip_type = pktinfo.addr.type;
+  }
+
+  return pktinfo_found;
+}
+
+void fill_recv_msg(RCMcastRecvMsg* recv_msg, EtcPalMsgHdr* msg, size_t data_len)
+{
+  if (!RDMNET_ASSERT_VERIFY(recv_msg) || !RDMNET_ASSERT_VERIFY(msg))
+    return;
+
+  recv_msg->data = (const uint8_t*)msg->buf;
+  recv_msg->data_len = data_len;
+  recv_msg->from = msg->name;
+  recv_msg->truncated = ((msg->flags & ETCPAL_MSG_TRUNC) != 0);
+  recv_msg->netint_valid = (!(msg->flags & ETCPAL_MSG_CTRUNC) && get_pktinfo_netint(msg, &recv_msg->netint));
+}
+
+#if RC_MCAST_USE_RECVMMSG
+
+int recv_batch_recvmmsg(etcpal_socket_t socket,
+                        uint8_t*        storage,
+                        size_t          msg_buf_size,
+                        RCMcastRecvMsg* msgs,
+                        size_t          max_msgs)
+{
+  struct mmsghdr          mmsgs[RDMNET_MCAST_RECV_BATCH_SIZE];
+  struct iovec            iovecs[RDMNET_MCAST_RECV_BATCH_SIZE];
+  struct sockaddr_storage names[RDMNET_MCAST_RECV_BATCH_SIZE];
+  uint8_t                 control_bufs[RDMNET_MCAST_RECV_BATCH_SIZE][ETCPAL_MAX_CONTROL_SIZE_PKTINFO];
+
+  memset(mmsgs, 0, sizeof(struct mmsghdr) * max_msgs);
+  for (size_t i = 0; i < max_msgs; ++i)
+  {
+    iovecs[i].iov_base = &storage[i * msg_buf_size];
+    iovecs[i].iov_len = msg_buf_size;
+    mmsgs[i].msg_hdr.msg_name = &names[i];
+    mmsgs[i].msg_hdr.msg_namelen = sizeof(names[i]);
+    mmsgs[i].msg_hdr.msg_iov = &iovecs[i];
+    mmsgs[i].msg_hdr.msg_iovlen = 1;
+    mmsgs[i].msg_hdr.msg_control = control_bufs[i];
+    mmsgs[i].msg_hdr.msg_controllen = ETCPAL_MAX_CONTROL_SIZE_PKTINFO;
+  }
+
+  int num_received = recvmmsg(socket, mmsgs, (unsigned int)max_msgs, MSG_DONTWAIT, NULL);
+  if (num_received < 0)
+  {
+    if (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR)
+      return 0;
+    if (errno == ENOSYS)
+      return (int)kEtcPalErrNotImpl;
+    return (errno == ENOMEM || errno == ENOBUFS) ? (int)kEtcPalErrNoMem : (int)kEtcPalErrSys;
+  }
+
+  for (int i = 0; i < num_received; ++i)
+  {
+    // Present the OS message header the same way etcpal_recvmsg() would, so that the EtcPal
+    // ancillary data helpers can be used to find the receiving interface.
+    EtcPalMsgHdr msg;
+    msg.buf = iovecs[i].iov_base;
+    msg.buflen = msg_buf_size;
+    msg.control = control_bufs[i];
+    msg.controllen = mmsgs[i].msg_hdr.msg_controllen;
+    msg.flags = 0;
+    if (mmsgs[i].msg_hdr.msg_flags & MSG_TRUNC)
+      msg.flags |= ETCPAL_MSG_TRUNC;
+    if (mmsgs[i].msg_hdr.msg_flags & MSG_CTRUNC)
+      msg.flags |= ETCPAL_MSG_CTRUNC;
+    if (!sockaddr_os_to_etcpal((const etcpal_os_sockaddr_t*)&names[i], &msg.name))
+      ETCPAL_IP_SET_INVALID(&msg.name.ip);
+
+    size_t data_len = mmsgs[i].msg_len;
+    if (data_len > msg_buf_size)
+      data_len = msg_buf_size;
+    fill_recv_msg(&msgs[i], &msg, data_len);
+  }
+
+  return num_received;
+}
+
+#endif  // RC_MCAST_USE_RECVMMSG
+
+int recv_batch_loop(etcpal_socket_t socket,
+                    uint8_t*        storage,
+                    size_t          msg_buf_size,
+                    RCMcastRecvMsg* msgs,
+                    size_t          max_msgs)
+{
+  size_t num_received = 0;
+  for (size_t attempt = 0; attempt < max_msgs; ++attempt)
+  {
+    uint8_t control_buf[ETCPAL_MAX_CONTROL_SIZE_PKTINFO];  // Ancillary data
+
+    EtcPalMsgHdr msg;
+    msg.buf = &storage[num_received * msg_buf_size];
+    msg.buflen = msg_buf_size;
+    msg.control = control_buf;
+    msg.controllen = ETCPAL_MAX_CONTROL_SIZE_PKTINFO;
+    msg.flags = 0;
+
+    int recv_res = etcpal_recvmsg(socket, &msg, 0);
+    if (recv_res == kEtcPalErrMsgSize)
+    {
+      // Some platforms report an oversized datagram as an error rather than with ETCPAL_MSG_TRUNC.
+      // It has been consumed from the queue, so just skip it.
+      continue;
+    }
+    else if (recv_res < 0)
+    {
+      // Datagrams received before an error are still delivered; a persistent error will be
+      // reported on the next wakeup.
+      if (num_received == 0 && recv_res != kEtcPalErrWouldBlock)
+        return recv_res;
+      break;
+    }
+
+    fill_recv_msg(&msgs[num_received], &msg, (size_t)recv_res);
+    ++num_received;
+  }
+
+  return (int)num_received;
+}
+
+#if RC_MCAST_USE_SENDMMSG
+
+etcpal_error_t send_to_netints_sendmmsg(const RCMcastSendNetint* netints,
+                                        size_t                   num_netints,
+                                        etcpal_iptype_t          ip_type,
+                                        const uint8_t*           data,
+                                        size_t                   data_len,
+                                        const EtcPalSockAddr*    dest)
+{
+  etcpal_os_sockaddr_t os_dest;
+  socklen_t            os_dest_len = (socklen_t)sockaddr_etcpal_to_os(dest, &os_dest);
+  if (os_dest_len == 0)
+    return kEtcPalErrInvalid;
+
+  // The ancillary data must be aligned for struct cmsghdr.
+  typedef union PktInfoControlBuf
+  {
+    struct cmsghdr align;
+    uint8_t        buf[CMSG_SPACE(sizeof(struct in6_pktinfo))];
+  } PktInfoControlBuf;
+
+  struct mmsghdr           mmsgs[SEND_BATCH_SIZE];
+  PktInfoControlBuf        control_bufs[SEND_BATCH_SIZE];
+  const RCMcastSendNetint* batch_netints[SEND_BATCH_SIZE];
+
+  struct iovec iov;
+  iov.iov_base = (void*)data;
+  iov.iov_len = data_len;
+
+  etcpal_error_t           res = kEtcPalErrOk;
+  const RCMcastSendNetint* netint = netints;
+  while (netint < netints + num_netints)
+  {
+    size_t batch_size = 0;
+    for (; netint < netints + num_netints && batch_size < SEND_BATCH_SIZE; ++netint)
+    {
+      if (netint->id.ip_type != ip_type)
+        continue;
+
+      struct msghdr* hdr = &mmsgs[batch_size].msg_hdr;
+      memset(&mmsgs[batch_size], 0, sizeof(struct mmsghdr));
+      memset(&control_bufs[batch_size], 0, sizeof(PktInfoControlBuf));
+      hdr->msg_name = &os_dest;
+      hdr->msg_namelen = os_dest_len;
+      hdr->msg_iov = &iov;
+      hdr->msg_iovlen = 1;
+      hdr->msg_control = control_bufs[batch_size].buf;
+
+      // The pktinfo interface overrides the socket's MULTICAST_IF for this datagram only.
+      if (ip_type == kEtcPalIpTypeV6)
+      {
+        hdr->msg_controllen = CMSG_SPACE(sizeof(struct in6_pktinfo));
+        struct cmsghdr* cmsg = CMSG_FIRSTHDR(hdr);
+        cmsg->cmsg_level = IPPROTO_IPV6;
+        cmsg->cmsg_type = IPV6_PKTINFO;
+        cmsg->cmsg_len = CMSG_LEN(sizeof(struct in6_pktinfo));
+        ((struct in6_pktinfo*)CMSG_DATA(cmsg))->ipi6_ifindex = netint->id.index;
+      }
+      else
+      {
+        hdr->msg_controllen = CMSG_SPACE(sizeof(struct in_pktinfo));
+        struct cmsghdr* cmsg = CMSG_FIRSTHDR(hdr);
+        cmsg->cmsg_level = IPPROTO_IP;
+        cmsg->cmsg_type = IP_PKTINFO;
+        cmsg->cmsg_len = CMSG_LEN(sizeof(struct in_pktinfo));
+        ((struct in_pktinfo*)CMSG_DATA(cmsg))->ipi_ifindex = (int)netint->id.index;
+      }
+
+      batch_netints[batch_size++] = netint;
+    }
+
+    if (batch_size == 0)
+      break;
+
+    // The whole batch goes out on the first interface's socket. Any datagrams that sendmmsg()
+    // didn't get to are sent individually on their own interface's socket, which also isolates
+    // the error from an interface that has gone down.
+    int num_sent = sendmmsg(batch_netints[0]->socket, mmsgs, (unsigned int)batch_size, 0);
+    if (num_sent < 0)
+      num_sent = 0;
+
+    for (size_t i = (size_t)num_sent; i < batch_size; ++i)
+    {
+      int send_res = etcpal_sendto(batch_netints[i]->socket, data, data_len, 0, dest);
+      if (send_res < 0)
+        res = (etcpal_error_t)send_res;
+    }
+  }
+
+  return res;
+}
+
+#endif  // RC_MCAST_USE_SENDMMSG
+
 McastNetintInfo* get_mcast_netint_info(const EtcPalMcastNetintId* id)
 {
   if (!RDMNET_ASSERT_VERIFY(id))
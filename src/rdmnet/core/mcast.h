@@ -29,12 +29,31 @@
 extern "C" {
 #endif
 
+/* A single datagram received by rc_mcast_recv_batch(). */
+typedef struct RCMcastRecvMsg
+{
+  const uint8_t*      data;          /* Points into the receive storage provided by the caller. */
+  size_t              data_len;      /* Number of valid bytes at data. */
+  EtcPalSockAddr      from;          /* The source address of the datagram. */
+  EtcPalMcastNetintId netint;        /* The interface on which the datagram arrived, if netint_valid. */
+  bool                netint_valid;  /* Whether the interface could be determined from ancillary data. */
+  bool                truncated;     /* The datagram was larger than the per-message buffer size. */
+} RCMcastRecvMsg;
+
+/* A multicast send socket obtained with rc_mcast_get_send_socket() and the interface it is for. */
+typedef struct RCMcastSendNetint
+{
+  EtcPalMcastNetintId id;
+  etcpal_socket_t     socket;
+} RCMcastSendNetint;
+
 etcpal_error_t rc_mcast_module_init(const RdmnetNetintConfig* netint_config);
 void           rc_mcast_module_deinit(void);
 
 size_t               rc_mcast_get_netint_array(const EtcPalMcastNetintId** array);
 bool                 rc_mcast_netint_is_valid(const EtcPalMcastNetintId* id);
 const EtcPalMacAddr* rc_mcast_get_lowest_mac_addr(void);
+bool                 rc_mcast_get_netint_addr(const EtcPalMcastNetintId* id, EtcPalIpAddr* addr);
 
 etcpal_error_t rc_mcast_get_send_socket(const EtcPalMcastNetintId* id, uint16_t source_port, etcpal_socket_t* socket);
 void           rc_mcast_release_send_socket(const EtcPalMcastNetintId* id, uint16_t source_port);
@@ -45,6 +64,17 @@ etcpal_error_t rc_mcast_subscribe_recv_socket(etcpal_socket_t            socket,
 etcpal_error_t rc_mcast_unsubscribe_recv_socket(etcpal_socket_t            socket,
                                                 const EtcPalMcastNetintId* netint,
                                                 const EtcPalIpAddr*        group);
+int            rc_mcast_recv_batch(etcpal_socket_t socket,
+                                   uint8_t*        storage,
+                                   size_t          msg_buf_size,
+                                   RCMcastRecvMsg* msgs,
+                                   size_t          max_msgs);
+etcpal_error_t rc_mcast_send_to_netints(const RCMcastSendNetint* netints,
+                                        size_t                   num_netints,
+                                        const uint8_t*           data,
+                                        size_t                   data_len,
+                                        const EtcPalSockAddr*    v4_dest,
+                                        const EtcPalSockAddr*    v6_dest);
 
 #ifdef __cplusplus
 }
@@ -25,6 +25,8 @@
 #if !RDMNET_DYNAMIC_MEM
 StaticMessageBuffer rdmnet_static_msg_buf;
 char                rpt_status_string_buffer[RPT_STATUS_STRING_MAXLEN + 1];
+RdmnetEptSubProtocol
+    rdmnet_static_ept_subprots[EPT_CLIENT_ENTRIES_MAX_SIZE][EPT_SUBPROT_LIST_ALLOC_UNITS(EPT_SUBPROTS_MAX_SIZE)];
 #endif
 
 /*********************** Private function prototypes *************************/
@@ -32,6 +34,7 @@ char                rpt_status_string_buffer[RPT_STATUS_STRING_MAXLEN + 1];
 static void free_broker_message(BrokerMessage* bmsg);
 #if RDMNET_DYNAMIC_MEM
 static void free_rpt_message(RptMessage* rmsg);
+static void free_ept_message(EptMessage* emsg);
 #endif
 
 /*************************** Function definitions ****************************/
@@ -63,6 +66,14 @@ void rc_free_message_resources(RdmnetMessage* msg)
         free_rpt_message(rpt_msg);
       }
       break;
+      case ACN_VECTOR_ROOT_EPT: {
+        EptMessage* ept_msg = RDMNET_GET_EPT_MSG(msg);
+        if (!RDMNET_ASSERT_VERIFY(ept_msg))
+          return;
+
+        free_ept_message(ept_msg);
+      }
+      break;
 #endif
       default:
         break;
@@ -93,7 +104,7 @@ void free_broker_message(BrokerMessage* bmsg)
 
         RdmnetEptClientEntry* ept_entry_list = ept_client_list->client_entries;
         size_t                ept_entry_list_size = ept_client_list->num_client_entries;
-        if (!RDMNET_ASSERT_VERIFY(ept_entry_list))
+        if (!ept_entry_list)
           return;
 
         for (RdmnetEptClientEntry* ept_entry = ept_entry_list; ept_entry < ept_entry_list + ept_entry_list_size;
@@ -119,6 +130,17 @@ void free_broker_message(BrokerMessage* bmsg)
       break;
     }
 #if RDMNET_DYNAMIC_MEM
+    case VECTOR_BROKER_CONNECT:
+    case VECTOR_BROKER_CLIENT_ENTRY_UPDATE: {
+      ClientEntry* entry = (bmsg->vector == VECTOR_BROKER_CONNECT)
+                               ? &(BROKER_GET_CLIENT_CONNECT_MSG(bmsg)->client_entry)
+                               : &(BROKER_GET_CLIENT_ENTRY_UPDATE_MSG(bmsg)->client_entry);
+      if (IS_EPT_CLIENT_ENTRY(entry))
+      {
+        FREE_EPT_SUBPROT_LIST(entry->data.ept.protocols);
+      }
+      break;
+    }
     case VECTOR_BROKER_REQUEST_DYNAMIC_UIDS: {
       BrokerDynamicUidRequestList* req_list = BROKER_GET_DYNAMIC_UID_REQUEST_LIST(bmsg);
       if (!RDMNET_ASSERT_VERIFY(req_list))
@@ -186,4 +208,24 @@ void free_rpt_message(RptMessage* rmsg)
       break;
   }
 }
+
+void free_ept_message(EptMessage* emsg)
+{
+  if (!RDMNET_ASSERT_VERIFY(emsg))
+    return;
+
+  // EPT Data is delivered in place from the receive buffer; only the status string is allocated.
+  if (emsg->vector == VECTOR_EPT_STATUS)
+  {
+    RdmnetEptStatus* status = EPT_GET_STATUS_MSG(emsg);
+    if (!RDMNET_ASSERT_VERIFY(status))
+      return;
+
+    if (status->status_string)
+    {
+      free((char*)status->status_string);
+      status->status_string = NULL;
+    }
+  }
+}
 #endif
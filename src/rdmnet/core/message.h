@@ -101,6 +101,14 @@ typedef struct RdmnetMessage
 #define DYNAMIC_UID_MAPPINGS_MAX_SIZE RDMNET_PARSER_MAX_DYNAMIC_UID_ENTRIES
 #define FETCH_UID_ASSIGNMENTS_MAX_SIZE RDMNET_PARSER_MAX_DYNAMIC_UID_ENTRIES
 #define RDM_BUFFERS_MAX_SIZE RDMNET_PARSER_MAX_ACK_OVERFLOW_RESPONSES
+#define EPT_SUBPROTS_MAX_SIZE RDMNET_PARSER_MAX_EPT_SUBPROTS
+
+// A parsed EPT sub-protocol list is allocated as one block: the array of RdmnetEptSubProtocol
+// followed by storage for each protocol string. This is the size of that block in array elements.
+#define EPT_SUBPROT_LIST_ALLOC_UNITS(num)                                                     \
+  ((num) + ((((num)*EPT_PROTOCOL_STRING_PADDED_LENGTH) + sizeof(RdmnetEptSubProtocol) - 1) / \
+            sizeof(RdmnetEptSubProtocol)))
+#define EPT_SUBPROT_LIST_STRINGS(ptr, num) ((char*)((ptr) + (num)))
 
 typedef union
 {
@@ -136,9 +144,8 @@ extern char                rpt_status_string_buffer[RPT_STATUS_STRING_MAXLEN + 1
   (RDMNET_ASSERT_VERIFY(ptr), realloc((ptr), ((new_size) * sizeof(RdmUid))))
 #define REALLOC_RDM_BUFFER(ptr, new_size) (RDMNET_ASSERT_VERIFY(ptr), realloc((ptr), ((new_size) * sizeof(RdmBuffer))))
 
-#define ALLOC_EPT_SUBPROT_LIST() malloc(sizeof(RdmnetEptSubProtocol))
-#define REALLOC_EPT_SUBPROT_LIST(ptr, new_size) \
-  (RDMNET_ASSERT_VERIFY(ptr), realloc((ptr), ((new_size) * sizeof(RdmnetEptSubProtocol))))
+#define ALLOC_EPT_SUBPROT_LIST(entry_index, num) \
+  malloc(EPT_SUBPROT_LIST_ALLOC_UNITS(num) * sizeof(RdmnetEptSubProtocol))
 #define FREE_EPT_SUBPROT_LIST(ptr) \
   if (ptr)                         \
   {                                \
@@ -146,6 +153,7 @@ extern char                rpt_status_string_buffer[RPT_STATUS_STRING_MAXLEN + 1
   }
 
 #define ALLOC_RPT_STATUS_STR(size) malloc(size)
+#define ALLOC_EPT_STATUS_STR(size) malloc(size)
 
 #define FREE_MESSAGE_BUFFER(ptr) \
   if (ptr)                       \
@@ -183,10 +191,18 @@ extern char                rpt_status_string_buffer[RPT_STATUS_STRING_MAXLEN + 1
   (RDMNET_ASSERT_VERIFY(ptr), REALLOC_FROM_ARRAY(ptr, new_size, rdm_buffers, RDM_BUFFERS_MAX_SIZE))
 
 #define ALLOC_RPT_STATUS_STR(size) rpt_status_string_buffer
-
-// TODO
-#define ALLOC_EPT_SUBPROT_LIST() NULL
-#define REALLOC_EPT_SUBPROT_LIST() NULL
+// RPT and EPT status strings have the same maximum length, and only one message is parsed at a time.
+#define ALLOC_EPT_STATUS_STR(size) rpt_status_string_buffer
+
+// Each EPT client entry in a message gets its own sub-protocol list. These are in use alongside the
+// client entries in rdmnet_static_msg_buf, so they're kept outside of it.
+extern RdmnetEptSubProtocol
+    rdmnet_static_ept_subprots[EPT_CLIENT_ENTRIES_MAX_SIZE][EPT_SUBPROT_LIST_ALLOC_UNITS(EPT_SUBPROTS_MAX_SIZE)];
+
+#define ALLOC_EPT_SUBPROT_LIST(entry_index, num)                                   \
+  (((entry_index) < EPT_CLIENT_ENTRIES_MAX_SIZE && (num) <= EPT_SUBPROTS_MAX_SIZE) \
+       ? rdmnet_static_ept_subprots[entry_index]                                   \
+       : NULL)
 #define FREE_EPT_SUBPROT_LIST(ptr)
 
 #define FREE_MESSAGE_BUFFER(ptr)
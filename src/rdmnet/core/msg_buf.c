@@ -26,6 +26,7 @@
 #include "etcpal/pack.h"
 #include "rdmnet/core/common.h"
 #include "rdmnet/core/broker_prot.h"
+#include "rdmnet/core/ept_prot.h"
 #include "rdmnet/core/rpt_prot.h"
 #include "rdmnet/core/message.h"
 #include "rdmnet/core/opts.h"
@@ -58,6 +59,12 @@ static size_t parse_rpt_block(RptState*          rstate,
                               size_t             data_len,
                               RptMessage*        rmsg,
                               rc_parse_result_t* result);
+static size_t parse_ept_block(EptState*          estate,
+                              const uint8_t*     data,
+                              size_t             data_len,
+                              const EtcPalUuid*  source_cid,
+                              EptMessage*        emsg,
+                              rc_parse_result_t* result);
 
 // RPT layer
 static void   initialize_rpt_message(RptState* rstate, RptMessage* rmsg, size_t pdu_data_len);
@@ -72,6 +79,21 @@ static size_t parse_rpt_status(RptStatusState*    rsstate,
                                RptStatusMsg*      smsg,
                                rc_parse_result_t* result);
 
+// EPT layer
+static void   initialize_ept_message(EptState* estate, EptMessage* emsg, size_t pdu_data_len);
+static size_t parse_ept_data(PduBlockState*     block,
+                             const uint8_t*     data,
+                             size_t             data_len,
+                             const EtcPalUuid*  source_cid,
+                             RdmnetEptData*     edata,
+                             rc_parse_result_t* result);
+static size_t parse_ept_status(PduBlockState*     block,
+                               const uint8_t*     data,
+                               size_t             data_len,
+                               const EtcPalUuid*  source_cid,
+                               RdmnetEptStatus*   estatus,
+                               rc_parse_result_t* result);
+
 // Broker layer
 static void   initialize_broker_message(BrokerState* bstate, BrokerMessage* bmsg, size_t pdu_data_len);
 static void   parse_client_connect_header(const uint8_t* data, BrokerClientConnectMsg* ccmsg);
@@ -119,9 +141,12 @@ static size_t                parse_rpt_client_list(ClientListState*     clstate,
                                                    RdmnetRptClientList* clist,
                                                    rc_parse_result_t*   result);
 static RdmnetRptClientEntry* alloc_next_rpt_client_entry(RdmnetRptClientList* clist);
-#if 0
+static size_t                parse_ept_client_list(ClientListState*     clstate,
+                                                   const uint8_t*       data,
+                                                   size_t               data_len,
+                                                   RdmnetEptClientList* clist,
+                                                   rc_parse_result_t*   result);
 static RdmnetEptClientEntry* alloc_next_ept_client_entry(RdmnetEptClientList* clist);
-#endif
 
 /*************************** Function definitions ****************************/
 
@@ -131,6 +156,7 @@ void rc_msg_buf_init(RCMsgBuf* msg_buf)
     return;
 
   msg_buf->cur_data_size = 0;
+  msg_buf->pending_discard = 0;
   msg_buf->have_preamble = false;
 }
 
@@ -174,6 +200,22 @@ etcpal_error_t rc_msg_buf_parse_data(RCMsgBuf* msg_buf)
   if (!RDMNET_ASSERT_VERIFY(msg_buf))
     return kEtcPalErrSys;
 
+  // Discard the data belonging to the message returned by the previous call, which the caller is
+  // now done with.
+  if (msg_buf->pending_discard > 0)
+  {
+    if (!RDMNET_ASSERT_VERIFY(msg_buf->cur_data_size >= msg_buf->pending_discard))
+      return kEtcPalErrSys;
+
+    if (msg_buf->cur_data_size > msg_buf->pending_discard)
+    {
+      memmove(msg_buf->buf, &msg_buf->buf[msg_buf->pending_discard],
+              msg_buf->cur_data_size - msg_buf->pending_discard);
+    }
+    msg_buf->cur_data_size -= msg_buf->pending_discard;
+    msg_buf->pending_discard = 0;
+  }
+
   // Unless we finish parsing a message in this function, we will return kEtcPalErrNoData to indicate
   // that the parse is still in progress.
   etcpal_error_t res = kEtcPalErrNoData;
@@ -224,6 +266,14 @@ etcpal_error_t rc_msg_buf_parse_data(RCMsgBuf* msg_buf)
       if (!RDMNET_ASSERT_VERIFY(msg_buf->cur_data_size >= consumed))
         return kEtcPalErrSys;
 
+      // A parsed message may point into the buffer (e.g. EPT Data), so hold on to its bytes until the
+      // next call.
+      if (res == kEtcPalErrOk)
+      {
+        msg_buf->pending_discard = consumed;
+        break;
+      }
+
       if (msg_buf->cur_data_size > consumed)
       {
         memmove(msg_buf->buf, &msg_buf->buf[consumed], msg_buf->cur_data_size - consumed);
@@ -248,6 +298,9 @@ void initialize_rdmnet_message(RlpState* rlpstate, RdmnetMessage* msg, size_t pd
     case ACN_VECTOR_ROOT_RPT:
       INIT_RPT_STATE(&rlpstate->data.rpt, pdu_data_len);
       break;
+    case ACN_VECTOR_ROOT_EPT:
+      INIT_EPT_STATE(&rlpstate->data.ept, pdu_data_len);
+      break;
     default:
       INIT_PDU_BLOCK_STATE(&rlpstate->data.unknown, pdu_data_len);
       RDMNET_LOG_WARNING("Dropping Root Layer PDU with unknown vector %" PRIu32 ".", msg->vector);
@@ -335,6 +388,10 @@ size_t parse_rlp_block(RlpState*          rlpstate,
         next_layer_bytes_parsed = parse_rpt_block(&rlpstate->data.rpt, &data[bytes_parsed], data_len - bytes_parsed,
                                                   RDMNET_GET_RPT_MSG(msg), &res);
         break;
+      case ACN_VECTOR_ROOT_EPT:
+        next_layer_bytes_parsed = parse_ept_block(&rlpstate->data.ept, &data[bytes_parsed], data_len - bytes_parsed,
+                                                  &msg->sender_cid, RDMNET_GET_EPT_MSG(msg), &res);
+        break;
       default:
         next_layer_bytes_parsed = consume_bad_block(&rlpstate->data.unknown, data_len - bytes_parsed, &res);
         break;
@@ -863,9 +920,47 @@ size_t parse_single_client_entry(ClientEntryState*  cstate,
     }
     else if (cstate->client_protocol == kClientProtocolEPT)
     {
-      // Parse the EPT Client Entry data
-      // TODO
-      bytes_parsed += consume_bad_block(&cstate->entry_data, remaining_len, &res);
+      // Parse the EPT Client Entry data. We wait until the whole list of protocol entries is
+      // available, then allocate the sub-protocol array and its strings together.
+      size_t entry_data_size = cstate->entry_data.block_size;
+      if (entry_data_size == 0 || entry_data_size % EPT_PROTOCOL_ENTRY_SIZE != 0 ||
+          entry_data_size > RDMNET_RECV_DATA_MAX_SIZE)
+      {
+        bytes_parsed += consume_bad_block(&cstate->entry_data, remaining_len, &res);
+        RDMNET_LOG_WARNING("Dropping EPT Client Entry with invalid length %zu",
+                           entry_data_size + CLIENT_ENTRY_HEADER_SIZE);
+      }
+      else if (remaining_len >= entry_data_size)
+      {
+        size_t                num_protocols = entry_data_size / EPT_PROTOCOL_ENTRY_SIZE;
+        RdmnetEptSubProtocol* protocols = ALLOC_EPT_SUBPROT_LIST(cstate->list_index, num_protocols);
+        if (protocols)
+        {
+          char*          strings = EPT_SUBPROT_LIST_STRINGS(protocols, num_protocols);
+          const uint8_t* cur_ptr = &data[bytes_parsed];
+          for (size_t i = 0; i < num_protocols; ++i)
+          {
+            protocols[i].manufacturer_id = etcpal_unpack_u16b(cur_ptr);
+            protocols[i].protocol_id = etcpal_unpack_u16b(cur_ptr + 2);
+            memcpy(&strings[i * EPT_PROTOCOL_STRING_PADDED_LENGTH], cur_ptr + 4, EPT_PROTOCOL_STRING_PADDED_LENGTH);
+            strings[(i * EPT_PROTOCOL_STRING_PADDED_LENGTH) + EPT_PROTOCOL_STRING_PADDED_LENGTH - 1] = '\0';
+            protocols[i].protocol_string = &strings[i * EPT_PROTOCOL_STRING_PADDED_LENGTH];
+            cur_ptr += EPT_PROTOCOL_ENTRY_SIZE;
+          }
+          entry->ept.protocols = protocols;
+          entry->ept.num_protocols = num_protocols;
+          bytes_parsed += entry_data_size;
+          cstate->entry_data.size_parsed += entry_data_size;
+          res = kRCParseResFullBlockParseOk;
+        }
+        else
+        {
+          bytes_parsed += consume_bad_block(&cstate->entry_data, remaining_len, &res);
+          RDMNET_LOG_WARNING("Couldn't allocate memory for %zu EPT sub-protocols; dropping EPT Client Entry.",
+                             num_protocols);
+        }
+      }
+      // Else return no data
     }
     else if (cstate->client_protocol == kClientProtocolRPT)
     {
@@ -945,8 +1040,11 @@ size_t parse_client_list(ClientListState*   clstate,
     }
     else if (clist->client_protocol == kClientProtocolEPT)
     {
-      // TODO EPT
-      bytes_parsed += consume_bad_block(&clstate->block, data_len, &res);
+      RdmnetEptClientList* eclist = BROKER_GET_EPT_CLIENT_LIST(clist);
+      if (!RDMNET_ASSERT_VERIFY(eclist))
+        return 0;
+
+      bytes_parsed += parse_ept_client_list(clstate, data, data_len, eclist, &res);
     }
     else if (clist->client_protocol != kClientProtocolUnknown)
     {
@@ -1092,7 +1190,116 @@ RdmnetRptClientEntry* alloc_next_rpt_client_entry(RdmnetRptClientList* clist)
   }
 }
 
-#if 0
+size_t parse_ept_client_list(ClientListState*     clstate,
+                             const uint8_t*       data,
+                             size_t               data_len,
+                             RdmnetEptClientList* clist,
+                             rc_parse_result_t*   result)
+{
+  if (!RDMNET_ASSERT_VERIFY(clstate) || !RDMNET_ASSERT_VERIFY(data) || !RDMNET_ASSERT_VERIFY(clist) ||
+      !RDMNET_ASSERT_VERIFY(result))
+  {
+    return 0;
+  }
+
+  size_t            bytes_parsed = 0;
+  rc_parse_result_t res = kRCParseResNoData;
+
+  while (clstate->block.size_parsed < clstate->block.block_size)
+  {
+    size_t                remaining_len = data_len - bytes_parsed;
+    const uint8_t*        cur_data_ptr = &data[bytes_parsed];
+    RdmnetEptClientEntry* next_entry = NULL;
+
+    if (!clstate->block.parsed_header)
+    {
+      if (remaining_len >= CLIENT_ENTRY_HEADER_SIZE)
+      {
+        if (GET_CLIENT_PROTOCOL_FROM_CENTRY_HEADER(cur_data_ptr) != kClientProtocolEPT)
+        {
+          RDMNET_LOG_WARNING("Dropping invalid Client List - first entry was EPT, but also contains client protocol %d",
+                             GET_CLIENT_PROTOCOL_FROM_CENTRY_HEADER(cur_data_ptr));
+          bytes_parsed += consume_bad_block(&clstate->block, data_len, &res);
+          break;
+        }
+
+        next_entry = alloc_next_ept_client_entry(clist);
+        if (next_entry)
+        {
+          next_entry->protocols = NULL;
+          next_entry->num_protocols = 0;
+          clstate->block.parsed_header = true;
+          INIT_CLIENT_ENTRY_STATE(&clstate->entry, clstate->block.block_size);
+          clstate->entry.list_index = clist->num_client_entries - 1;
+        }
+        else
+        {
+          // We've run out of space for EPT Client Entries - send back up what we have now
+          clist->more_coming = true;
+          res = kRCParseResPartialBlockParseOk;
+          break;
+        }
+      }
+      else
+      {
+        break;
+      }
+    }
+    else
+    {
+      if (!RDMNET_ASSERT_VERIFY(clist->client_entries))
+        return 0;
+
+      next_entry = &clist->client_entries[clist->num_client_entries - 1];
+    }
+
+    if (clstate->block.parsed_header)
+    {
+      // We know the client protocol is correct because it's been validated above.
+      client_protocol_t cp = kClientProtocolUnknown;
+      size_t next_layer_bytes_parsed = parse_single_client_entry(&clstate->entry, cur_data_ptr, remaining_len, &cp,
+                                                                 (ClientEntryUnion*)next_entry, &res);
+
+      // Check and advance the buffer pointers
+      if (!RDMNET_ASSERT_VERIFY(next_layer_bytes_parsed <= remaining_len) ||
+          !RDMNET_ASSERT_VERIFY(clstate->block.size_parsed + next_layer_bytes_parsed <= clstate->block.block_size))
+      {
+        return 0;
+      }
+
+      bytes_parsed += next_layer_bytes_parsed;
+      clstate->block.size_parsed += next_layer_bytes_parsed;
+
+      // Determine what to do next in the list loop
+      if (res == kRCParseResFullBlockParseOk)
+      {
+        clstate->block.parsed_header = false;
+        if (clstate->block.size_parsed != clstate->block.block_size)
+        {
+          // This isn't the last entry in the list
+          res = kRCParseResNoData;
+        }
+        // Iterate again
+      }
+      else if (res == kRCParseResFullBlockProtErr)
+      {
+        // Bail on the list
+        clstate->block.parsed_header = false;
+        bytes_parsed += consume_bad_block(&clstate->block, remaining_len - next_layer_bytes_parsed, &res);
+        break;
+      }
+      else
+      {
+        // Couldn't parse a complete entry, wait for next time
+        break;
+      }
+    }
+  }
+
+  *result = res;
+  return bytes_parsed;
+}
+
 RdmnetEptClientEntry* alloc_next_ept_client_entry(RdmnetEptClientList* clist)
 {
   if (!RDMNET_ASSERT_VERIFY(clist))
@@ -1119,7 +1326,6 @@ RdmnetEptClientEntry* alloc_next_ept_client_entry(RdmnetEptClientList* clist)
     return clist->client_entries;
   }
 }
-#endif
 
 size_t parse_request_dynamic_uid_assignment(GenericListState*            lstate,
                                             const uint8_t*               data,
@@ -1714,6 +1920,242 @@ size_t parse_rpt_status(RptStatusState*    rsstate,
   return bytes_parsed;
 }
 
+void initialize_ept_message(EptState* estate, EptMessage* emsg, size_t pdu_data_len)
+{
+  if (!RDMNET_ASSERT_VERIFY(estate) || !RDMNET_ASSERT_VERIFY(emsg))
+    return;
+
+  INIT_PDU_BLOCK_STATE(&estate->data, pdu_data_len);
+
+  switch (emsg->vector)
+  {
+    case VECTOR_EPT_DATA:
+      // The data is delivered in place, so the whole EPT Data PDU must fit in the receive buffer.
+      if (pdu_data_len < EPT_DATA_PDU_HEADER_SIZE || pdu_data_len > EPT_DATA_PDU_HEADER_SIZE + RDMNET_EPT_DATA_MAX_SIZE)
+      {
+        // An artificial "unknown" vector value to flag the data parsing logic to consume the data
+        // section.
+        emsg->vector = 0xffffffff;
+        RDMNET_LOG_WARNING("Dropping EPT PDU with invalid or unsupported length %zu",
+                           pdu_data_len + EPT_PDU_HEADER_SIZE);
+      }
+      break;
+    case VECTOR_EPT_STATUS:
+      if (pdu_data_len < EPT_STATUS_PDU_HEADER_SIZE ||
+          pdu_data_len > EPT_STATUS_PDU_HEADER_SIZE + EPT_STATUS_STRING_MAXLEN)
+      {
+        emsg->vector = 0xffffffff;
+        RDMNET_LOG_WARNING("Dropping EPT PDU with invalid length %zu", pdu_data_len + EPT_PDU_HEADER_SIZE);
+      }
+      break;
+    default:
+      RDMNET_LOG_WARNING("Dropping EPT PDU with invalid vector %" PRIu32, emsg->vector);
+      break;
+  }
+}
+
+size_t parse_ept_block(EptState*          estate,
+                       const uint8_t*     data,
+                       size_t             data_len,
+                       const EtcPalUuid*  source_cid,
+                       EptMessage*        emsg,
+                       rc_parse_result_t* result)
+{
+  if (!RDMNET_ASSERT_VERIFY(estate) || !RDMNET_ASSERT_VERIFY(source_cid) || !RDMNET_ASSERT_VERIFY(emsg) ||
+      !RDMNET_ASSERT_VERIFY(result))
+  {
+    return 0;
+  }
+
+  size_t            bytes_parsed = 0;
+  rc_parse_result_t res = kRCParseResNoData;
+
+  if (estate->block.consuming_bad_block)
+  {
+    bytes_parsed += consume_bad_block(&estate->block, data_len, &res);
+  }
+  else if (!estate->block.parsed_header)
+  {
+    bool parse_err = false;
+
+    // If the size remaining in the EPT PDU block is not enough for another EPT PDU header, indicate
+    // a bad block condition.
+    if ((estate->block.block_size - estate->block.size_parsed) < EPT_PDU_HEADER_SIZE)
+    {
+      parse_err = true;
+    }
+    else if ((data_len >= EPT_PDU_HEADER_SIZE) && RDMNET_ASSERT_VERIFY(data))
+    {
+      // We can parse an EPT PDU header.
+      const uint8_t* cur_ptr = data;
+      size_t         pdu_len = ACN_PDU_LENGTH(cur_ptr);
+      if (pdu_len >= EPT_PDU_HEADER_SIZE && estate->block.size_parsed + pdu_len <= estate->block.block_size)
+      {
+        size_t pdu_data_len = pdu_len - EPT_PDU_HEADER_SIZE;
+        cur_ptr += 3;
+        emsg->vector = etcpal_unpack_u32b(cur_ptr);
+        cur_ptr += 4;
+        memcpy(emsg->dest_cid.data, cur_ptr, ETCPAL_UUID_BYTES);
+        cur_ptr += ETCPAL_UUID_BYTES;
+
+        bytes_parsed += EPT_PDU_HEADER_SIZE;
+        estate->block.size_parsed += EPT_PDU_HEADER_SIZE;
+        initialize_ept_message(estate, emsg, pdu_data_len);
+        estate->block.parsed_header = true;
+      }
+      else
+      {
+        parse_err = true;
+      }
+    }
+    // Else we don't have enough data - return kRCParseResNoData by default.
+
+    if (parse_err)
+    {
+      bytes_parsed += consume_bad_block(&estate->block, data_len, &res);
+      RDMNET_LOG_WARNING("Protocol error encountered while parsing EPT PDU header.");
+    }
+  }
+  if (estate->block.parsed_header)
+  {
+    size_t next_layer_bytes_parsed;
+    size_t remaining_len = data_len - bytes_parsed;
+    switch (emsg->vector)
+    {
+      case VECTOR_EPT_DATA:
+        next_layer_bytes_parsed = parse_ept_data(&estate->data, &data[bytes_parsed], remaining_len, source_cid,
+                                                 EPT_GET_DATA_MSG(emsg), &res);
+        break;
+      case VECTOR_EPT_STATUS:
+        next_layer_bytes_parsed = parse_ept_status(&estate->data, &data[bytes_parsed], remaining_len, source_cid,
+                                                   EPT_GET_STATUS_MSG(emsg), &res);
+        break;
+      default:
+        // Unknown EPT vector - discard this EPT PDU.
+        next_layer_bytes_parsed = consume_bad_block(&estate->data, remaining_len, &res);
+        break;
+    }
+
+    if (!RDMNET_ASSERT_VERIFY(next_layer_bytes_parsed <= remaining_len) ||
+        !RDMNET_ASSERT_VERIFY(estate->block.size_parsed + next_layer_bytes_parsed <= estate->block.block_size))
+    {
+      return 0;
+    }
+
+    estate->block.size_parsed += next_layer_bytes_parsed;
+    bytes_parsed += next_layer_bytes_parsed;
+    res = check_for_full_parse(res, &estate->block);
+  }
+  *result = res;
+  return bytes_parsed;
+}
+
+size_t parse_ept_data(PduBlockState*     block,
+                      const uint8_t*     data,
+                      size_t             data_len,
+                      const EtcPalUuid*  source_cid,
+                      RdmnetEptData*     edata,
+                      rc_parse_result_t* result)
+{
+  if (!RDMNET_ASSERT_VERIFY(block) || !RDMNET_ASSERT_VERIFY(source_cid) || !RDMNET_ASSERT_VERIFY(edata) ||
+      !RDMNET_ASSERT_VERIFY(result))
+  {
+    return 0;
+  }
+
+  rc_parse_result_t res = kRCParseResNoData;
+  size_t            bytes_parsed = 0;
+
+  if (block->consuming_bad_block)
+  {
+    bytes_parsed += consume_bad_block(block, data_len, &res);
+  }
+  else if ((data_len >= block->block_size) && RDMNET_ASSERT_VERIFY(data))
+  {
+    // The whole EPT Data PDU is in the buffer, so the opaque data can be referenced in place.
+    size_t pdu_len = ACN_PDU_LENGTH(data);
+    if (pdu_len == block->block_size)
+    {
+      edata->source_cid = *source_cid;
+      edata->manufacturer_id = etcpal_unpack_u16b(&data[3]);
+      edata->protocol_id = etcpal_unpack_u16b(&data[5]);
+      edata->data = &data[EPT_DATA_PDU_HEADER_SIZE];
+      edata->data_len = pdu_len - EPT_DATA_PDU_HEADER_SIZE;
+      bytes_parsed += pdu_len;
+      block->size_parsed += pdu_len;
+      res = kRCParseResFullBlockParseOk;
+    }
+    else
+    {
+      bytes_parsed += consume_bad_block(block, data_len, &res);
+      RDMNET_LOG_WARNING("Protocol error encountered while parsing EPT Data PDU.");
+    }
+  }
+  // Else we don't have enough data - return kRCParseResNoData by default.
+
+  *result = res;
+  return bytes_parsed;
+}
+
+size_t parse_ept_status(PduBlockState*     block,
+                        const uint8_t*     data,
+                        size_t             data_len,
+                        const EtcPalUuid*  source_cid,
+                        RdmnetEptStatus*   estatus,
+                        rc_parse_result_t* result)
+{
+  if (!RDMNET_ASSERT_VERIFY(block) || !RDMNET_ASSERT_VERIFY(source_cid) || !RDMNET_ASSERT_VERIFY(estatus) ||
+      !RDMNET_ASSERT_VERIFY(result))
+  {
+    return 0;
+  }
+
+  rc_parse_result_t res = kRCParseResNoData;
+  size_t            bytes_parsed = 0;
+
+  if (block->consuming_bad_block)
+  {
+    bytes_parsed += consume_bad_block(block, data_len, &res);
+  }
+  else if ((data_len >= block->block_size) && RDMNET_ASSERT_VERIFY(data))
+  {
+    size_t   pdu_len = ACN_PDU_LENGTH(data);
+    uint16_t status_code = etcpal_unpack_u16b(&data[3]);
+    if (pdu_len == block->block_size &&
+        (status_code == VECTOR_EPT_STATUS_UNKNOWN_CID || status_code == VECTOR_EPT_STATUS_UNKNOWN_VECTOR))
+    {
+      estatus->source_cid = *source_cid;
+      estatus->status_code = (ept_status_code_t)status_code;
+      estatus->status_string = NULL;
+
+      // The status string is optional
+      size_t str_len = pdu_len - EPT_STATUS_PDU_HEADER_SIZE;
+      if (str_len > 0)
+      {
+        char* str_buf = ALLOC_EPT_STATUS_STR(str_len + 1);
+        if (str_buf)
+        {
+          memcpy(str_buf, &data[EPT_STATUS_PDU_HEADER_SIZE], str_len);
+          str_buf[str_len] = '\0';
+          estatus->status_string = str_buf;
+        }
+      }
+      bytes_parsed += pdu_len;
+      block->size_parsed += pdu_len;
+      res = kRCParseResFullBlockParseOk;
+    }
+    else
+    {
+      bytes_parsed += consume_bad_block(block, data_len, &res);
+      RDMNET_LOG_WARNING("Protocol error encountered while parsing EPT Status PDU.");
+    }
+  }
+  // Else we don't have enough data - return kRCParseResNoData by default.
+
+  *result = res;
+  return bytes_parsed;
+}
+
 size_t locate_tcp_preamble(RCMsgBuf* msg_buf)
 {
   if (!RDMNET_ASSERT_VERIFY(msg_buf))
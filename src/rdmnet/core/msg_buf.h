@@ -132,6 +132,8 @@ typedef struct ClientEntryState
   bool              parsed_entry_header;
   client_protocol_t client_protocol;
   PduBlockState     entry_data;  // This is only for use with consume_bad_block()
+  // The entry's position in a Client List, which selects its sub-protocol storage without dynamic memory.
+  size_t list_index;
 } ClientEntryState;
 
 #define INIT_CLIENT_ENTRY_STATE(cstateptr, blocksize)      \
@@ -140,6 +142,7 @@ typedef struct ClientEntryState
     (cstateptr)->enclosing_block_size = (blocksize);       \
     (cstateptr)->parsed_entry_header = false;              \
     (cstateptr)->client_protocol = kClientProtocolUnknown; \
+    (cstateptr)->list_index = 0;                           \
   }
 
 typedef struct ClientListState
@@ -217,6 +220,20 @@ typedef struct BrokerState
     INIT_PDU_BLOCK_STATE(&(bstateptr)->block, blocksize); \
   }
 
+typedef struct EptState
+{
+  PduBlockState block;
+  // EPT Data and EPT Status PDUs are each a single PDU with no further nesting, so they (and
+  // unknown vectors) share one block state.
+  PduBlockState data;
+} EptState;
+
+#define INIT_EPT_STATE(estateptr, blocksize)              \
+  if (RDMNET_ASSERT_VERIFY(estateptr))                    \
+  {                                                       \
+    INIT_PDU_BLOCK_STATE(&(estateptr)->block, blocksize); \
+  }
+
 typedef struct RlpState
 {
   PduBlockState block;
@@ -224,6 +241,7 @@ typedef struct RlpState
   {
     BrokerState   broker;
     RptState      rpt;
+    EptState      ept;
     PduBlockState unknown;
   } data;
 } RlpState;
@@ -234,7 +252,13 @@ typedef struct RlpState
     INIT_PDU_BLOCK_STATE(&(rlpstateptr)->block, blocksize); \
   }
 
+// EPT Data messages are parsed in place, so the buffer must be able to hold a full EPT Data PDU
+// plus one more receive.
+#if (RDMNET_EPT_DATA_MAX_SIZE + EPT_DATA_PDU_HEADER_SIZE) > RDMNET_RECV_DATA_MAX_SIZE
+#define RC_MSG_BUF_SIZE (RDMNET_RECV_DATA_MAX_SIZE + EPT_DATA_PDU_HEADER_SIZE + RDMNET_EPT_DATA_MAX_SIZE)
+#else
 #define RC_MSG_BUF_SIZE (RDMNET_RECV_DATA_MAX_SIZE * 2)
+#endif
 
 typedef struct RCMsgBuf
 {
@@ -242,6 +266,10 @@ typedef struct RCMsgBuf
   size_t        cur_data_size;
   RdmnetMessage msg;
 
+  // Bytes at the front of buf that belong to the last message returned. They are kept until the
+  // next call to rc_msg_buf_parse_data() so that data referenced in place by msg stays valid.
+  size_t pending_discard;
+
   bool     have_preamble;
   RlpState rlp_state;
 
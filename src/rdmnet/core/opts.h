@@ -337,6 +337,19 @@ bool rdmnet_assert_verify_fail(const char* exp, const char* file, const char* fu
 #define RDMNET_PARSER_MAX_ACK_OVERFLOW_RESPONSES 1
 #endif
 
+/**
+ * @brief Whether to recombine the data of received ACK_OVERFLOW responses into one contiguous buffer.
+ *
+ * If defined to 0, the RdmnetRdmResponse::rdm_data member is NULL for received responses whose
+ * data spans more than one RDM PDU; the data must be read in place using
+ * rdmnet_rdm_response_next_fragment() or rdmnet::RdmResponse::fragments(). This saves a heap
+ * allocation and a copy per large response. Responses with a single fragment are always delivered
+ * in place with rdm_data set.
+ */
+#ifndef RDMNET_RECOMBINE_RDM_RESPONSE_DATA
+#define RDMNET_RECOMBINE_RDM_RESPONSE_DATA 1
+#endif
+
 /**
  * @brief The maximum number of network interfaces usable for RDMnet's multicast protocols.
  *
@@ -366,6 +379,70 @@ bool rdmnet_assert_verify_fail(const char* exp, const char* file, const char* fu
 #define RDMNET_BIND_MCAST_SOCKETS_TO_MCAST_ADDRESS !RDMNET_WINDOWS_HINT
 #endif
 
+/**
+ * @brief The maximum number of datagrams read from a multicast (LLRP or mDNS) socket each time it
+ *        becomes readable.
+ *
+ * Reading several datagrams per wakeup keeps bursts of multicast traffic (e.g. many LLRP targets
+ * replying to the same probe request) from costing a full tick per packet. On Linux, the datagrams
+ * are read with a single recvmmsg() call. Each unit reserves one maximum-size receive buffer per
+ * multicast protocol.
+ */
+#ifndef RDMNET_MCAST_RECV_BATCH_SIZE
+#define RDMNET_MCAST_RECV_BATCH_SIZE (RDMNET_FULL_OS_AVAILABLE_HINT ? 16 : 1)
+#endif
+
+#if RDMNET_MCAST_RECV_BATCH_SIZE < 1
+#undef RDMNET_MCAST_RECV_BATCH_SIZE
+#define RDMNET_MCAST_RECV_BATCH_SIZE 1
+#endif
+
+/**
+ * @brief The maximum size of the opaque data in a single EPT Data message that can be received.
+ *
+ * EPT Data messages are delivered in place from the TCP receive buffer, so this option sizes that
+ * buffer and applies regardless of the value of #RDMNET_DYNAMIC_MEM. EPT Data messages carrying
+ * more data than this are discarded as protocol errors.
+ */
+#ifndef RDMNET_EPT_DATA_MAX_SIZE
+#if RDMNET_DYNAMIC_MEM
+#define RDMNET_EPT_DATA_MAX_SIZE 8192
+#elif RDMNET_MAX_EPT_CLIENTS > 0
+#define RDMNET_EPT_DATA_MAX_SIZE 1024
+#else
+#define RDMNET_EPT_DATA_MAX_SIZE 0
+#endif
+#endif
+
+/**
+ * @brief The maximum number of a discovered broker's listen addresses to which a client connects
+ *        in parallel.
+ *
+ * If greater than 1, a client starts a non-blocking TCP connection to each of up to this many of
+ * a broker's listen addresses, staggered by #RDMNET_CONN_PARALLEL_CONNECT_DELAY_MS. The first one
+ * to connect is used for the RDMnet handshake and the rest are closed, so an unreachable address
+ * no longer costs a full TCP timeout before the next one is tried. The default of 1 tries each
+ * address in turn.
+ */
+#ifndef RDMNET_CONN_PARALLEL_CONNECT_ADDRS
+#define RDMNET_CONN_PARALLEL_CONNECT_ADDRS 1
+#endif
+
+#if RDMNET_CONN_PARALLEL_CONNECT_ADDRS < 1
+#undef RDMNET_CONN_PARALLEL_CONNECT_ADDRS
+#define RDMNET_CONN_PARALLEL_CONNECT_ADDRS 1
+#endif
+
+/**
+ * @brief How long to wait after starting a parallel connection attempt before starting the next.
+ *
+ * Meaningful only if #RDMNET_CONN_PARALLEL_CONNECT_ADDRS is greater than 1. When an attempt fails,
+ * the next one is started right away.
+ */
+#ifndef RDMNET_CONN_PARALLEL_CONNECT_DELAY_MS
+#define RDMNET_CONN_PARALLEL_CONNECT_DELAY_MS 250
+#endif
+
 /**
  * @brief The priority of the tick thread.
  *
@@ -384,6 +461,36 @@ bool rdmnet_assert_verify_fail(const char* exp, const char* file, const char* fu
 #define RDMNET_TICK_THREAD_STACK (ETCPAL_THREAD_DEFAULT_STACK * 2)
 #endif
 
+/**
+ * @brief The number of events each callback queue can hold, or 0 to call callbacks from the tick thread.
+ *
+ * By default, the callbacks for broker connections, LLRP targets and LLRP managers are called from the tick thread as
+ * each event is handled, so a slow callback delays network I/O for every connection in the process. If this is
+ * nonzero, events are instead added to a queue and delivered by other threads (see #RDMNET_CALLBACK_THREADS).
+ * Callbacks for any one connection, LLRP target or LLRP manager are still delivered in order, one at a time.
+ *
+ * Messages received from a broker are delivered from the connection's receive buffer, so each connection has at most
+ * one message in a queue at a time. The connection's socket isn't read from until that message's callback has
+ * returned, or while a full queue leaves the next message waiting for room, which throttles the TCP connection. Other
+ * events wait for room.
+ *
+ * Must be a power of 2.
+ */
+#ifndef RDMNET_CALLBACK_QUEUE_SIZE
+#define RDMNET_CALLBACK_QUEUE_SIZE 0
+#endif
+
+/**
+ * @brief The number of threads the library starts to deliver queued callbacks.
+ *
+ * Only meaningful if #RDMNET_CALLBACK_QUEUE_SIZE is nonzero. Each thread delivers the callbacks from a queue of its
+ * own. If 0, no threads are started, and the application must call rdmnet_dispatch_callbacks() from threads of its own
+ * to deliver callbacks. The threads are created with #RDMNET_TICK_THREAD_PRIORITY and #RDMNET_TICK_THREAD_STACK.
+ */
+#ifndef RDMNET_CALLBACK_THREADS
+#define RDMNET_CALLBACK_THREADS 1
+#endif
+
 /**
  * @}
  */
@@ -444,6 +551,18 @@ bool rdmnet_assert_verify_fail(const char* exp, const char* file, const char* fu
 #define RDMNET_MAX_ADDITIONAL_TXT_ITEMS_PER_DISCOVERED_BROKER 1
 #endif
 
+/**
+ * @brief How many mDNS resource records the lightweight DNS-SD implementation can cache.
+ *
+ * Meaningful only if #RDMNET_DYNAMIC_MEM is defined to 0, and only when the lightweight DNS-SD
+ * implementation is in use. Each discovered broker takes about five records (PTR, subtype PTR, SRV,
+ * TXT and one per address). When the cache is full, records are still used as they arrive but are
+ * not kept for requerying or for answering new scope monitors.
+ */
+#ifndef RDMNET_LWMDNS_MAX_CACHED_RECORDS
+#define RDMNET_LWMDNS_MAX_CACHED_RECORDS (RDMNET_MAX_DISCOVERED_BROKERS_PER_SCOPE * RDMNET_MAX_MONITORED_SCOPES * 5)
+#endif
+
 /**
  * @}
  */
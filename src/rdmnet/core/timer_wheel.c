@@ -0,0 +1,235 @@
+/******************************************************************************
+ * Copyright 2020 ETC Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ ******************************************************************************
+ * This file is a part of RDMnet. For more information, go to:
+ * https://github.com/ETCLabs/RDMnet
+ *****************************************************************************/
+
+#include "rdmnet/core/timer_wheel.h"
+
+#include <stddef.h>
+#include <string.h>
+#include "etcpal/timer.h"
+#include "rdmnet/core/opts.h"
+
+/*************************** Private constants *******************************/
+
+#define SLOT_MASK (RC_TIMER_WHEEL_SLOTS - 1)
+
+// The largest number of ticks in the future an entry can be placed. Longer timeouts are clamped
+// to this, and the owner of the entry is expected to reschedule it when it fires early.
+#define MAX_TICKS_AHEAD ((1u << (RC_TIMER_WHEEL_SLOT_BITS * RC_TIMER_WHEEL_LEVELS)) - 1)
+
+/***************************** Private macros ********************************/
+
+// The slot index of tick in the given level of the wheel.
+#define SLOT_INDEX(tick, level) (((tick) >> (RC_TIMER_WHEEL_SLOT_BITS * (level))) & SLOT_MASK)
+
+/*********************** Private function prototypes *************************/
+
+static void     list_push(RCTimerWheelEntry** list, RCTimerWheelEntry* entry);
+static void     list_remove(RCTimerWheelEntry* entry);
+static void     place_entry(RCTimerWheel* wheel, RCTimerWheelEntry* entry);
+static uint32_t cascade(RCTimerWheel* wheel, unsigned int level);
+static void     process_tick(RCTimerWheel* wheel);
+
+/*************************** Function definitions ****************************/
+
+/*
+ * Initialize a timer wheel with no entries. Deadlines are rounded up to a multiple of
+ * resolution_ms, which should generally be the interval at which rc_timer_wheel_advance() is
+ * called.
+ */
+void rc_timer_wheel_init(RCTimerWheel* wheel, uint32_t resolution_ms)
+{
+  if (!RDMNET_ASSERT_VERIFY(wheel) || !RDMNET_ASSERT_VERIFY(resolution_ms != 0))
+    return;
+
+  memset(wheel, 0, sizeof(RCTimerWheel));
+  wheel->resolution_ms = resolution_ms;
+  wheel->base_ms = etcpal_getms() + resolution_ms;
+}
+
+/*
+ * Schedule an entry to expire timeout_ms from now, replacing any deadline it already had. An
+ * entry scheduled with a timeout of 0 expires on the next call to rc_timer_wheel_advance().
+ */
+void rc_timer_wheel_schedule(RCTimerWheel* wheel, RCTimerWheelEntry* entry, uint32_t timeout_ms)
+{
+  if (!RDMNET_ASSERT_VERIFY(wheel) || !RDMNET_ASSERT_VERIFY(entry))
+    return;
+
+  list_remove(entry);
+
+  if (timeout_ms == 0)
+  {
+    list_push(&wheel->due, entry);
+    return;
+  }
+
+  // Find the first tick at or after the deadline.
+  uint32_t deadline = etcpal_getms() + timeout_ms;
+  uint32_t ticks_ahead = 0;
+  if ((int32_t)(deadline - wheel->base_ms) > 0)
+  {
+    uint32_t ms_after_base = deadline - wheel->base_ms;
+    ticks_ahead = (ms_after_base / wheel->resolution_ms) + (ms_after_base % wheel->resolution_ms != 0);
+    if (ticks_ahead > MAX_TICKS_AHEAD)
+      ticks_ahead = MAX_TICKS_AHEAD;
+  }
+
+  entry->expires = wheel->base + ticks_ahead;
+  place_entry(wheel, entry);
+}
+
+/*
+ * Remove an entry from the wheel. Does nothing if the entry is not scheduled.
+ */
+void rc_timer_wheel_cancel(RCTimerWheel* wheel, RCTimerWheelEntry* entry)
+{
+  if (!RDMNET_ASSERT_VERIFY(wheel) || !RDMNET_ASSERT_VERIFY(entry))
+    return;
+
+  list_remove(entry);
+}
+
+/*
+ * Whether an entry is scheduled on a wheel, including if it has expired but has not yet been
+ * popped.
+ */
+bool rc_timer_wheel_is_scheduled(const RCTimerWheelEntry* entry)
+{
+  if (!RDMNET_ASSERT_VERIFY(entry))
+    return false;
+
+  return (entry->list != NULL);
+}
+
+/*
+ * Process all ticks that have come due since the last advance, moving entries whose deadlines
+ * have passed to the expired list. Retrieve them with rc_timer_wheel_pop_expired().
+ */
+void rc_timer_wheel_advance(RCTimerWheel* wheel)
+{
+  if (!RDMNET_ASSERT_VERIFY(wheel))
+    return;
+
+  while (wheel->due)
+  {
+    RCTimerWheelEntry* entry = wheel->due;
+    list_remove(entry);
+    list_push(&wheel->expired, entry);
+  }
+
+  uint32_t now = etcpal_getms();
+  while ((int32_t)(now - wheel->base_ms) >= 0)
+  {
+    process_tick(wheel);
+    wheel->base_ms += wheel->resolution_ms;
+  }
+}
+
+/*
+ * Remove and return the next expired entry, or NULL if there are none. Entries which are
+ * rescheduled while popping are not returned again until the next advance.
+ */
+RCTimerWheelEntry* rc_timer_wheel_pop_expired(RCTimerWheel* wheel)
+{
+  if (!RDMNET_ASSERT_VERIFY(wheel))
+    return NULL;
+
+  RCTimerWheelEntry* entry = wheel->expired;
+  if (entry)
+    list_remove(entry);
+  return entry;
+}
+
+void list_push(RCTimerWheelEntry** list, RCTimerWheelEntry* entry)
+{
+  entry->prev = NULL;
+  entry->next = *list;
+  if (*list)
+    (*list)->prev = entry;
+  *list = entry;
+  entry->list = list;
+}
+
+void list_remove(RCTimerWheelEntry* entry)
+{
+  if (!entry->list)
+    return;
+
+  if (entry->prev)
+    entry->prev->next = entry->next;
+  else
+    *entry->list = entry->next;
+  if (entry->next)
+    entry->next->prev = entry->prev;
+
+  entry->next = NULL;
+  entry->prev = NULL;
+  entry->list = NULL;
+}
+
+// Put an entry in the slot matching its expiry tick, on the lowest level that spans it.
+void place_entry(RCTimerWheel* wheel, RCTimerWheelEntry* entry)
+{
+  uint32_t ticks_ahead = entry->expires - wheel->base;
+
+  unsigned int level = 0;
+  while (level < RC_TIMER_WHEEL_LEVELS - 1 && ticks_ahead >= (1u << (RC_TIMER_WHEEL_SLOT_BITS * (level + 1))))
+    ++level;
+
+  list_push(&wheel->slots[level][SLOT_INDEX(entry->expires, level)], entry);
+}
+
+// Redistribute the entries in the current slot of a level into the levels below it. Returns the
+// slot index, which is 0 when the level has wrapped and the next level up should cascade too.
+uint32_t cascade(RCTimerWheel* wheel, unsigned int level)
+{
+  uint32_t index = SLOT_INDEX(wheel->base, level);
+
+  RCTimerWheelEntry* entry = wheel->slots[level][index];
+  while (entry)
+  {
+    RCTimerWheelEntry* next = entry->next;
+    list_remove(entry);
+    place_entry(wheel, entry);
+    entry = next;
+  }
+  return index;
+}
+
+void process_tick(RCTimerWheel* wheel)
+{
+  uint32_t index = SLOT_INDEX(wheel->base, 0);
+  if (index == 0)
+  {
+    for (unsigned int level = 1; level < RC_TIMER_WHEEL_LEVELS; ++level)
+    {
+      if (cascade(wheel, level) != 0)
+        break;
+    }
+  }
+
+  RCTimerWheelEntry** slot = &wheel->slots[0][index];
+  while (*slot)
+  {
+    RCTimerWheelEntry* entry = *slot;
+    list_remove(entry);
+    list_push(&wheel->expired, entry);
+  }
+  ++wheel->base;
+}
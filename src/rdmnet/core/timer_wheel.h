@@ -0,0 +1,81 @@
+/******************************************************************************
+ * Copyright 2020 ETC Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ ******************************************************************************
+ * This file is a part of RDMnet. For more information, go to:
+ * https://github.com/ETCLabs/RDMnet
+ *****************************************************************************/
+
+/**
+ * @file rdmnet/core/timer_wheel.h
+ * @brief A hierarchical timer wheel for scheduling many coarse-grained deadlines.
+ *
+ * Entries are embedded in the structures they schedule. Scheduling and cancelling an entry is
+ * O(1), and advancing the wheel only touches entries whose deadlines are due (plus an occasional
+ * cascade of a higher level into a lower one), so a periodic tick costs nothing for idle entries.
+ *
+ * The wheel does no locking of its own; callers that share a wheel between threads must
+ * serialize access to it.
+ */
+
+#ifndef RDMNET_CORE_TIMER_WHEEL_H_
+#define RDMNET_CORE_TIMER_WHEEL_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define RC_TIMER_WHEEL_LEVELS 4
+#define RC_TIMER_WHEEL_SLOT_BITS 6
+#define RC_TIMER_WHEEL_SLOTS (1u << RC_TIMER_WHEEL_SLOT_BITS)
+
+typedef struct RCTimerWheelEntry RCTimerWheelEntry;
+
+// A deadline which can be scheduled on an RCTimerWheel. Zero-initialize before first use; the
+// members are managed by the wheel.
+struct RCTimerWheelEntry
+{
+  RCTimerWheelEntry*  next;
+  RCTimerWheelEntry*  prev;
+  RCTimerWheelEntry** list;  // The list this entry is currently in, or NULL if not scheduled.
+  uint32_t            expires;
+};
+
+typedef struct RCTimerWheel
+{
+  uint32_t resolution_ms;
+  uint32_t base;     // The next tick to be processed.
+  uint32_t base_ms;  // The time at which tick base is due.
+
+  RCTimerWheelEntry* slots[RC_TIMER_WHEEL_LEVELS][RC_TIMER_WHEEL_SLOTS];
+  RCTimerWheelEntry* due;      // Entries scheduled with no timeout, expired on the next advance.
+  RCTimerWheelEntry* expired;  // Entries which have expired and have not yet been popped.
+} RCTimerWheel;
+
+void rc_timer_wheel_init(RCTimerWheel* wheel, uint32_t resolution_ms);
+void rc_timer_wheel_schedule(RCTimerWheel* wheel, RCTimerWheelEntry* entry, uint32_t timeout_ms);
+void rc_timer_wheel_cancel(RCTimerWheel* wheel, RCTimerWheelEntry* entry);
+bool rc_timer_wheel_is_scheduled(const RCTimerWheelEntry* entry);
+
+void               rc_timer_wheel_advance(RCTimerWheel* wheel);
+RCTimerWheelEntry* rc_timer_wheel_pop_expired(RCTimerWheel* wheel);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* RDMNET_CORE_TIMER_WHEEL_H_ */
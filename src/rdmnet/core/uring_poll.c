@@ -0,0 +1,509 @@
+/******************************************************************************
+ * Copyright 2020 ETC Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ ******************************************************************************
+ * This file is a part of RDMnet. For more information, go to:
+ * https://github.com/ETCLabs/RDMnet
+ *****************************************************************************/
+
+#include "rdmnet/core/uring_poll.h"
+
+#include <errno.h>
+#include <poll.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include "etcpal/timer.h"
+#include "rdmnet/core/common.h"
+#include "rdmnet/core/opts.h"
+
+/*************************** Private constants *******************************/
+
+// Requests are sent to the kernel in batches no larger than this.
+#define URING_POLL_RING_ENTRIES 64
+
+// The user data of each request identifies its operation in the top byte. Poll requests carry the
+// socket and the generation of its registration.
+#define URING_POLL_OP_POLL 1u
+#define URING_POLL_OP_WAKE 2u
+#define URING_POLL_OP_REMOVE 3u
+
+#define URING_POLL_GENERATION_MASK 0xffffffu
+
+/***************************** Private macros ********************************/
+
+#define MAKE_USER_DATA(op, socket, generation)                                            \
+  (((uint64_t)(op) << 56) | ((uint64_t)((generation)&URING_POLL_GENERATION_MASK) << 32) | \
+   (uint64_t)(uint32_t)(socket))
+#define USER_DATA_OP(user_data) ((uint32_t)((user_data) >> 56))
+#define USER_DATA_SOCKET(user_data) ((etcpal_socket_t)(uint32_t)(user_data))
+#define USER_DATA_GENERATION(user_data) ((uint32_t)((user_data) >> 32) & URING_POLL_GENERATION_MASK)
+
+/*********************** Private function prototypes *************************/
+
+static RCUringPolledSocket* find_socket(RCUringPollContext* context, etcpal_socket_t socket);
+static bool                 add_stale_request(RCUringPollContext* context, const RCUringPolledSocket* sock);
+static struct io_uring_sqe* get_sqe(RCUringPollContext* context);
+static void                 arm_requests(RCUringPollContext* context);
+static void                 collect_events(RCUringPollContext* context);
+static bool                 next_pending_event(RCUringPollContext* context, EtcPalPollEvent* event);
+static unsigned int         poll_mask(etcpal_poll_events_t events);
+static etcpal_error_t       socket_error(etcpal_socket_t socket);
+static void                 wake(RCUringPollContext* context);
+
+/*************************** Function definitions ****************************/
+
+/*
+ * Initialize an io_uring poll context. Fails if dynamic memory is disabled or the kernel doesn't
+ * support io_uring, in which case the caller should use etcpal_poll instead.
+ */
+etcpal_error_t rc_uring_poll_context_init(RCUringPollContext* context)
+{
+  if (!RDMNET_ASSERT_VERIFY(context))
+    return kEtcPalErrSys;
+
+#if RDMNET_DYNAMIC_MEM
+  memset(context, 0, sizeof(RCUringPollContext));
+
+  context->wake_fd = eventfd(0, EFD_CLOEXEC);
+  if (context->wake_fd < 0)
+    return kEtcPalErrSys;
+
+  if (io_uring_queue_init(URING_POLL_RING_ENTRIES, &context->ring, 0) < 0)
+  {
+    close(context->wake_fd);
+    return kEtcPalErrNotImpl;
+  }
+
+  if (!etcpal_mutex_create(&context->lock))
+  {
+    io_uring_queue_exit(&context->ring);
+    close(context->wake_fd);
+    return kEtcPalErrSys;
+  }
+
+  return kEtcPalErrOk;
+#else
+  return kEtcPalErrNotImpl;
+#endif
+}
+
+void rc_uring_poll_context_deinit(RCUringPollContext* context)
+{
+  if (!RDMNET_ASSERT_VERIFY(context))
+    return;
+
+  // Exiting the ring cancels any requests still with the kernel.
+  io_uring_queue_exit(&context->ring);
+  close(context->wake_fd);
+  etcpal_mutex_destroy(&context->lock);
+
+  free(context->sockets);
+  free(context->stale_requests);
+  context->sockets = NULL;
+  context->stale_requests = NULL;
+  context->num_sockets = 0;
+  context->num_stale_requests = 0;
+}
+
+etcpal_error_t rc_uring_poll_add_socket(RCUringPollContext*  context,
+                                        etcpal_socket_t      socket,
+                                        etcpal_poll_events_t events,
+                                        void*                user_data)
+{
+  if (!RDMNET_ASSERT_VERIFY(context))
+    return kEtcPalErrSys;
+  if (socket == ETCPAL_SOCKET_INVALID || !events)
+    return kEtcPalErrInvalid;
+
+  etcpal_error_t res = kEtcPalErrOk;
+  if (etcpal_mutex_lock(&context->lock))
+  {
+    if (find_socket(context, socket))
+    {
+      res = kEtcPalErrExists;
+    }
+    else
+    {
+      if (context->num_sockets == context->sockets_capacity)
+      {
+        size_t               new_capacity = (context->sockets_capacity ? context->sockets_capacity * 2 : 8);
+        RCUringPolledSocket* new_sockets =
+            (RCUringPolledSocket*)realloc(context->sockets, new_capacity * sizeof(RCUringPolledSocket));
+        if (new_sockets)
+        {
+          context->sockets = new_sockets;
+          context->sockets_capacity = new_capacity;
+        }
+        else
+        {
+          res = kEtcPalErrNoMem;
+        }
+      }
+
+      if (res == kEtcPalErrOk)
+      {
+        RCUringPolledSocket* new_sock = &context->sockets[context->num_sockets++];
+        new_sock->socket = socket;
+        new_sock->events = events;
+        new_sock->user_data = user_data;
+        new_sock->generation = (++context->next_generation & URING_POLL_GENERATION_MASK);
+        new_sock->armed = false;
+      }
+    }
+    etcpal_mutex_unlock(&context->lock);
+  }
+  else
+  {
+    res = kEtcPalErrSys;
+  }
+
+  if (res == kEtcPalErrOk)
+    wake(context);
+  return res;
+}
+
+etcpal_error_t rc_uring_poll_modify_socket(RCUringPollContext*  context,
+                                           etcpal_socket_t      socket,
+                                           etcpal_poll_events_t new_events,
+                                           void*                new_user_data)
+{
+  if (!RDMNET_ASSERT_VERIFY(context))
+    return kEtcPalErrSys;
+  if (socket == ETCPAL_SOCKET_INVALID || !new_events)
+    return kEtcPalErrInvalid;
+
+  etcpal_error_t res = kEtcPalErrOk;
+  if (etcpal_mutex_lock(&context->lock))
+  {
+    RCUringPolledSocket* sock = find_socket(context, socket);
+    if (!sock)
+    {
+      res = kEtcPalErrNotFound;
+    }
+    else if (sock->armed && !add_stale_request(context, sock))
+    {
+      res = kEtcPalErrNoMem;
+    }
+    else
+    {
+      // The request for the old events is removed, and its events, if any are pending, dropped.
+      sock->events = new_events;
+      sock->user_data = new_user_data;
+      sock->generation = (++context->next_generation & URING_POLL_GENERATION_MASK);
+      sock->armed = false;
+    }
+    etcpal_mutex_unlock(&context->lock);
+  }
+  else
+  {
+    res = kEtcPalErrSys;
+  }
+
+  if (res == kEtcPalErrOk)
+    wake(context);
+  return res;
+}
+
+/*
+ * Stop polling a socket. The poll request is removed from the kernel on the waiting thread's next
+ * pass, which the wait is interrupted for; until then, the request keeps the socket open in the
+ * kernel after it is closed.
+ */
+void rc_uring_poll_remove_socket(RCUringPollContext* context, etcpal_socket_t socket)
+{
+  if (!RDMNET_ASSERT_VERIFY(context))
+    return;
+
+  bool removed = false;
+  if (etcpal_mutex_lock(&context->lock))
+  {
+    RCUringPolledSocket* sock = find_socket(context, socket);
+    if (sock)
+    {
+      if (sock->armed)
+        removed = add_stale_request(context, sock);
+      *sock = context->sockets[--context->num_sockets];
+    }
+    etcpal_mutex_unlock(&context->lock);
+  }
+
+  if (removed)
+    wake(context);
+}
+
+/*
+ * Wait for an event on one of the registered sockets. Returns the events collected from the kernel
+ * on an earlier call first, as long as their sockets are still registered.
+ */
+etcpal_error_t rc_uring_poll_wait(RCUringPollContext* context, EtcPalPollEvent* event, int timeout_ms)
+{
+  if (!RDMNET_ASSERT_VERIFY(context) || !RDMNET_ASSERT_VERIFY(event))
+    return kEtcPalErrSys;
+
+  if (next_pending_event(context, event))
+    return kEtcPalErrOk;
+
+  EtcPalTimer timer;
+  etcpal_timer_start(&timer, (timeout_ms < 0 ? 0 : (uint32_t)timeout_ms));
+
+  // A wake, or completions for stale requests, end a wait without any events; the requests are
+  // re-armed and the wait resumed for whatever time is left.
+  do
+  {
+    if (!etcpal_mutex_lock(&context->lock))
+      return kEtcPalErrSys;
+    bool have_sockets = (context->num_sockets > 0);
+    if (have_sockets)
+      arm_requests(context);
+    etcpal_mutex_unlock(&context->lock);
+
+    if (!have_sockets)
+      return kEtcPalErrNoSockets;
+
+    // Submits the requests armed above and waits for completions in one call.
+    struct io_uring_cqe*     cqe = NULL;
+    uint32_t                 remaining_ms = etcpal_timer_remaining(&timer);
+    struct __kernel_timespec ts;
+    ts.tv_sec = remaining_ms / 1000;
+    ts.tv_nsec = (long long)(remaining_ms % 1000) * 1000000;
+    int wait_res = io_uring_submit_and_wait_timeout(&context->ring, &cqe, 1, (timeout_ms < 0 ? NULL : &ts), NULL);
+    if (wait_res < 0 && wait_res != -ETIME && wait_res != -EINTR && wait_res != -EBUSY)
+      return kEtcPalErrSys;
+
+    collect_events(context);
+    if (next_pending_event(context, event))
+      return kEtcPalErrOk;
+  } while (timeout_ms < 0 || !etcpal_timer_is_expired(&timer));
+
+  return kEtcPalErrTimedOut;
+}
+
+// Must be called with the context's lock held.
+RCUringPolledSocket* find_socket(RCUringPollContext* context, etcpal_socket_t socket)
+{
+  for (size_t i = 0; i < context->num_sockets; ++i)
+  {
+    if (context->sockets[i].socket == socket)
+      return &context->sockets[i];
+  }
+  return NULL;
+}
+
+// Must be called with the context's lock held.
+bool add_stale_request(RCUringPollContext* context, const RCUringPolledSocket* sock)
+{
+  if (context->num_stale_requests == context->stale_requests_capacity)
+  {
+    size_t    new_capacity = (context->stale_requests_capacity ? context->stale_requests_capacity * 2 : 8);
+    uint64_t* new_requests = (uint64_t*)realloc(context->stale_requests, new_capacity * sizeof(uint64_t));
+    if (!new_requests)
+      return false;
+    context->stale_requests = new_requests;
+    context->stale_requests_capacity = new_capacity;
+  }
+
+  context->stale_requests[context->num_stale_requests++] =
+      MAKE_USER_DATA(URING_POLL_OP_POLL, sock->socket, sock->generation);
+  return true;
+}
+
+// Get a free submission queue entry, submitting the queue to make room if it is full. Only called
+// from the waiting thread.
+struct io_uring_sqe* get_sqe(RCUringPollContext* context)
+{
+  struct io_uring_sqe* sqe = io_uring_get_sqe(&context->ring);
+  if (!sqe)
+  {
+    io_uring_submit(&context->ring);
+    sqe = io_uring_get_sqe(&context->ring);
+  }
+  return sqe;
+}
+
+// Queue the removals of stale poll requests, and poll requests for the sockets without one. Must be
+// called with the context's lock held, from the waiting thread.
+void arm_requests(RCUringPollContext* context)
+{
+  struct io_uring_sqe* sqe = NULL;
+
+  if (!context->wake_armed && (sqe = get_sqe(context)) != NULL)
+  {
+    io_uring_prep_read(sqe, context->wake_fd, &context->wake_value, sizeof(context->wake_value), 0);
+    io_uring_sqe_set_data64(sqe, MAKE_USER_DATA(URING_POLL_OP_WAKE, 0, 0));
+    context->wake_armed = true;
+  }
+
+  size_t num_removed = 0;
+  for (; num_removed < context->num_stale_requests && (sqe = get_sqe(context)) != NULL; ++num_removed)
+  {
+    io_uring_prep_poll_remove(sqe, context->stale_requests[num_removed]);
+    io_uring_sqe_set_data64(sqe, MAKE_USER_DATA(URING_POLL_OP_REMOVE, 0, 0));
+  }
+  if (num_removed > 0)
+  {
+    memmove(context->stale_requests, &context->stale_requests[num_removed],
+            (context->num_stale_requests - num_removed) * sizeof(uint64_t));
+    context->num_stale_requests -= num_removed;
+  }
+
+  for (size_t i = 0; i < context->num_sockets; ++i)
+  {
+    RCUringPolledSocket* sock = &context->sockets[i];
+    if (sock->armed || (sqe = get_sqe(context)) == NULL)
+      continue;
+
+    io_uring_prep_poll_add(sqe, sock->socket, poll_mask(sock->events));
+    io_uring_sqe_set_data64(sqe, MAKE_USER_DATA(URING_POLL_OP_POLL, sock->socket, sock->generation));
+    sock->armed = true;
+  }
+}
+
+// Translate the completions from the kernel into pending events. Only called from the waiting
+// thread.
+void collect_events(RCUringPollContext* context)
+{
+  struct io_uring_cqe* cqes[RC_URING_POLL_MAX_EVENTS];
+  unsigned int         num_cqes = io_uring_peek_batch_cqe(&context->ring, cqes, RC_URING_POLL_MAX_EVENTS);
+
+  context->num_pending = 0;
+  context->next_pending = 0;
+
+  if (!etcpal_mutex_lock(&context->lock))
+    return;
+
+  for (unsigned int i = 0; i < num_cqes; ++i)
+  {
+    uint64_t user_data = io_uring_cqe_get_data64(cqes[i]);
+    int      res = cqes[i]->res;
+
+    if (USER_DATA_OP(user_data) == URING_POLL_OP_WAKE)
+    {
+      context->wake_armed = false;
+      continue;
+    }
+    if (USER_DATA_OP(user_data) != URING_POLL_OP_POLL)
+      continue;
+
+    // The socket may have been removed or modified since the request was armed.
+    RCUringPolledSocket* sock = find_socket(context, USER_DATA_SOCKET(user_data));
+    if (!sock || sock->generation != USER_DATA_GENERATION(user_data))
+      continue;
+
+    // Re-armed on the next wait, once this event has been delivered
+    sock->armed = false;
+    if (res < 0)
+      continue;
+
+    EtcPalPollEvent* event = &context->pending[context->num_pending];
+    event->socket = sock->socket;
+    event->events = 0;
+    event->err = kEtcPalErrOk;
+    event->user_data = sock->user_data;
+
+    if (res & POLLERR)
+    {
+      event->events |= ETCPAL_POLL_ERR;
+      event->err = socket_error(sock->socket);
+    }
+    else if ((res & POLLHUP) && !(sock->events & ETCPAL_POLL_IN))
+    {
+      event->events |= ETCPAL_POLL_ERR;
+      event->err = kEtcPalErrConnClosed;
+    }
+
+    // A hangup on a socket being read from is found by the read.
+    if ((res & (POLLIN | POLLHUP)) && (sock->events & ETCPAL_POLL_IN))
+      event->events |= ETCPAL_POLL_IN;
+    if ((res & POLLOUT) && (sock->events & ETCPAL_POLL_OUT))
+      event->events |= ETCPAL_POLL_OUT;
+    if ((res & POLLOUT) && (sock->events & ETCPAL_POLL_CONNECT) && !(event->events & ETCPAL_POLL_ERR))
+      event->events |= ETCPAL_POLL_CONNECT;
+    if ((res & POLLPRI) && (sock->events & ETCPAL_POLL_OOB))
+      event->events |= ETCPAL_POLL_OOB;
+
+    if (event->events)
+      context->pending_generations[context->num_pending++] = sock->generation;
+  }
+
+  etcpal_mutex_unlock(&context->lock);
+  io_uring_cq_advance(&context->ring, num_cqes);
+}
+
+// Pop the next pending event whose socket is still registered as it was when the event arrived.
+// Only called from the waiting thread.
+bool next_pending_event(RCUringPollContext* context, EtcPalPollEvent* event)
+{
+  bool found = false;
+  if (context->next_pending < context->num_pending && etcpal_mutex_lock(&context->lock))
+  {
+    while (!found && context->next_pending < context->num_pending)
+    {
+      size_t               index = context->next_pending++;
+      RCUringPolledSocket* sock = find_socket(context, context->pending[index].socket);
+      if (sock && sock->generation == context->pending_generations[index])
+      {
+        *event = context->pending[index];
+        found = true;
+      }
+    }
+    etcpal_mutex_unlock(&context->lock);
+  }
+  return found;
+}
+
+unsigned int poll_mask(etcpal_poll_events_t events)
+{
+  unsigned int mask = 0;
+  if (events & ETCPAL_POLL_IN)
+    mask |= POLLIN;
+  if (events & (ETCPAL_POLL_OUT | ETCPAL_POLL_CONNECT))
+    mask |= POLLOUT;
+  if (events & ETCPAL_POLL_OOB)
+    mask |= POLLPRI;
+  return mask;
+}
+
+etcpal_error_t socket_error(etcpal_socket_t socket)
+{
+  int       error = 0;
+  socklen_t error_len = sizeof(error);
+  if (getsockopt(socket, SOL_SOCKET, SO_ERROR, &error, &error_len) != 0)
+    return kEtcPalErrSys;
+
+  switch (error)
+  {
+    case ECONNREFUSED:
+      return kEtcPalErrConnRefused;
+    case ETIMEDOUT:
+      return kEtcPalErrTimedOut;
+    case EHOSTUNREACH:
+    case ENETUNREACH:
+      return kEtcPalErrHostUnreach;
+    case ECONNRESET:
+      return kEtcPalErrConnReset;
+    default:
+      return kEtcPalErrSys;
+  }
+}
+
+// Interrupt the waiting thread, so that it picks up changes to the registered sockets.
+void wake(RCUringPollContext* context)
+{
+  uint64_t value = 1;
+  ssize_t  res = write(context->wake_fd, &value, sizeof(value));
+  ETCPAL_UNUSED_ARG(res);
+}
@@ -0,0 +1,110 @@
+/******************************************************************************
+ * Copyright 2020 ETC Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ ******************************************************************************
+ * This file is a part of RDMnet. For more information, go to:
+ * https://github.com/ETCLabs/RDMnet
+ *****************************************************************************/
+
+/**
+ * @file rdmnet/core/uring_poll.h
+ * @brief Socket polling for the core using io_uring, in place of etcpal_poll.
+ *
+ * Only compiled in on Linux when RDMnet is built with RDMNET_ENABLE_IO_URING. Mirrors the
+ * etcpal_poll API: each socket has a one-shot poll request, which is re-armed on the following
+ * wait after its event has been delivered. That keeps etcpal_poll's level-triggered behavior, while
+ * the re-arms for every socket that had an event go to the kernel in the same system call as the
+ * wait. Events are collected in batches, and handed out one per wait call.
+ *
+ * Sockets can be added, modified and removed from any thread, but only one thread may wait on a
+ * context.
+ */
+
+#ifndef RDMNET_CORE_URING_POLL_H_
+#define RDMNET_CORE_URING_POLL_H_
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <liburing.h>
+#include "etcpal/error.h"
+#include "etcpal/mutex.h"
+#include "etcpal/socket.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// The most events collected from the kernel per system call.
+#define RC_URING_POLL_MAX_EVENTS 64
+
+typedef struct RCUringPolledSocket
+{
+  etcpal_socket_t      socket;
+  etcpal_poll_events_t events;
+  void*                user_data;
+  // Tells completions for this registration apart from those for an earlier one on the same socket.
+  uint32_t generation;
+  // Whether a poll request is with the kernel.
+  bool armed;
+} RCUringPolledSocket;
+
+typedef struct RCUringPollContext
+{
+  struct io_uring ring;
+  etcpal_mutex_t  lock;
+
+  // Registered sockets. Protected by lock.
+  RCUringPolledSocket* sockets;
+  size_t               num_sockets;
+  size_t               sockets_capacity;
+  uint32_t             next_generation;
+  // Poll requests to remove from the kernel on the next wait, for sockets no longer registered.
+  // Protected by lock.
+  uint64_t* stale_requests;
+  size_t    num_stale_requests;
+  size_t    stale_requests_capacity;
+
+  // An eventfd read by the ring, which interrupts a wait when sockets are registered from other
+  // threads.
+  int      wake_fd;
+  uint64_t wake_value;
+  bool     wake_armed;
+
+  // Events collected from the kernel and not yet returned. Only used by the waiting thread.
+  EtcPalPollEvent pending[RC_URING_POLL_MAX_EVENTS];
+  uint32_t        pending_generations[RC_URING_POLL_MAX_EVENTS];
+  size_t          num_pending;
+  size_t          next_pending;
+} RCUringPollContext;
+
+etcpal_error_t rc_uring_poll_context_init(RCUringPollContext* context);
+void           rc_uring_poll_context_deinit(RCUringPollContext* context);
+
+etcpal_error_t rc_uring_poll_add_socket(RCUringPollContext*  context,
+                                        etcpal_socket_t      socket,
+                                        etcpal_poll_events_t events,
+                                        void*                user_data);
+etcpal_error_t rc_uring_poll_modify_socket(RCUringPollContext*  context,
+                                           etcpal_socket_t      socket,
+                                           etcpal_poll_events_t new_events,
+                                           void*                new_user_data);
+void           rc_uring_poll_remove_socket(RCUringPollContext* context, etcpal_socket_t socket);
+etcpal_error_t rc_uring_poll_wait(RCUringPollContext* context, EtcPalPollEvent* event, int timeout_ms);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* RDMNET_CORE_URING_POLL_H_ */
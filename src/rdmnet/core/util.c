@@ -30,6 +30,18 @@
 /*************************** Private constants *******************************/
 
 #define INITIAL_REF_CAPACITY 8
+#define INITIAL_INDEX_SLOTS 16
+
+#define FNV_PRIME 16777619u
+
+/*********************** Private function prototypes *************************/
+
+static bool ref_index_init(RCRefIndex* index);
+static void ref_index_cleanup(RCRefIndex* index);
+static void ref_index_add(RCRefIndex* index, void* ref);
+static void ref_index_remove(RCRefIndex* index, const void* ref);
+static void ref_index_clear(RCRefIndex* index);
+static void ref_index_insert(void** slots, size_t num_slots, RCRefHashFunction hash, void* ref);
 
 /*************************** Function definitions ****************************/
 
@@ -145,7 +157,8 @@ bool rc_ref_lists_init(RCRefLists* lists)
   if (!RDMNET_ASSERT_VERIFY(lists))
     return false;
 
-  if (!rc_ref_list_init(&lists->active) || !rc_ref_list_init(&lists->pending) || !rc_ref_list_init(&lists->to_remove))
+  if (!rc_ref_list_init(&lists->active) || !rc_ref_list_init(&lists->pending) ||
+      !rc_ref_list_init(&lists->to_remove) || (lists->index && !ref_index_init(lists->index)))
   {
     rc_ref_list_cleanup(&lists->active);
     rc_ref_list_cleanup(&lists->pending);
@@ -163,6 +176,8 @@ void rc_ref_lists_cleanup(RCRefLists* lists)
   rc_ref_list_cleanup(&lists->active);
   rc_ref_list_cleanup(&lists->pending);
   rc_ref_list_cleanup(&lists->to_remove);
+  if (lists->index)
+    ref_index_cleanup(lists->index);
 }
 
 bool rc_ref_list_add_ref(RCRefList* list, void* to_add)
@@ -287,7 +302,8 @@ void rc_ref_lists_add_pending(RCRefLists* lists)
 
   for (void** ref_ptr = pending->refs; ref_ptr < pending->refs + pending->num_refs; ++ref_ptr)
   {
-    rc_ref_list_add_ref(active, *ref_ptr);
+    if (rc_ref_list_add_ref(active, *ref_ptr) && lists->index)
+      ref_index_add(lists->index, *ref_ptr);
   }
   pending->num_refs = 0;
 }
@@ -309,11 +325,15 @@ void rc_ref_lists_remove_marked(RCRefLists* lists, RCRefFunction on_remove, cons
     // Only call the on_remove callback if the ref was present in either active or pending.
     if ((rc_ref_list_find_ref_index(active, *ref_ptr) != -1) || (rc_ref_list_find_ref_index(pending, *ref_ptr) != -1))
     {
-      if (on_remove)
-        on_remove(*ref_ptr, context);
+      // Take the ref out of the index and lists first; on_remove may free it, and the index hashes
+      // the ref's contents to find it.
+      if (lists->index)
+        ref_index_remove(lists->index, *ref_ptr);
       rc_ref_list_remove_ref(active, *ref_ptr);
       // In case it never made it to active
       rc_ref_list_remove_ref(pending, *ref_ptr);
+      if (on_remove)
+        on_remove(*ref_ptr, context);
     }
   }
   to_remove->num_refs = 0;
@@ -328,10 +348,162 @@ void rc_ref_lists_remove_all(RCRefLists* lists, RCRefFunction on_remove, const v
   RCRefList* active = &lists->active;
 
   rc_ref_lists_remove_marked(lists, on_remove, context);
+  if (lists->index)
+    ref_index_clear(lists->index);
   rc_ref_list_remove_all(pending, on_remove, context);
   rc_ref_list_remove_all(active, on_remove, context);
 }
 
+/*
+ * Find a ref in the active list which satisfies the predicate. hash is the hash of the key being
+ * searched for, computed the same way as the lists' hash function; it is ignored (and the active
+ * list is searched linearly) if the lists are not indexed.
+ */
+void* rc_ref_lists_find_active(const RCRefLists* lists, uint32_t hash, RCRefPredicate predicate, const void* context)
+{
+  if (!RDMNET_ASSERT_VERIFY(lists) || !RDMNET_ASSERT_VERIFY(predicate))
+    return NULL;
+
+  const RCRefIndex* index = lists->index;
+  if (!index)
+    return rc_ref_list_find_ref(&lists->active, predicate, context);
+
+  if (!RDMNET_ASSERT_VERIFY(index->slots) || !RDMNET_ASSERT_VERIFY(index->num_slots))
+    return NULL;
+
+  for (size_t i = hash % index->num_slots; index->slots[i]; i = (i + 1) % index->num_slots)
+  {
+    if (predicate(index->slots[i], context))
+      return index->slots[i];
+  }
+  return NULL;
+}
+
+uint32_t rc_hash_bytes(const void* data, size_t size, uint32_t hash)
+{
+  if (!RDMNET_ASSERT_VERIFY(data))
+    return hash;
+
+  const uint8_t* bytes = (const uint8_t*)data;
+  for (size_t i = 0; i < size; ++i)
+  {
+    hash ^= bytes[i];
+    hash *= FNV_PRIME;
+  }
+  return hash;
+}
+
+bool ref_index_init(RCRefIndex* index)
+{
+  if (!RDMNET_ASSERT_VERIFY(index) || !RDMNET_ASSERT_VERIFY(index->hash))
+    return false;
+
+#if RDMNET_DYNAMIC_MEM
+  index->slots = (void**)calloc(INITIAL_INDEX_SLOTS, sizeof(void*));
+  if (!index->slots)
+    return false;
+  index->num_slots = INITIAL_INDEX_SLOTS;
+#else
+  memset(index->slots, 0, index->num_slots * sizeof(void*));
+#endif
+  index->num_refs = 0;
+  return true;
+}
+
+void ref_index_cleanup(RCRefIndex* index)
+{
+  if (!RDMNET_ASSERT_VERIFY(index))
+    return;
+
+#if RDMNET_DYNAMIC_MEM
+  if (index->slots)
+    free(index->slots);
+  index->slots = NULL;
+  index->num_slots = 0;
+#endif
+  index->num_refs = 0;
+}
+
+void ref_index_add(RCRefIndex* index, void* ref)
+{
+  if (!RDMNET_ASSERT_VERIFY(index) || !RDMNET_ASSERT_VERIFY(index->slots) || !RDMNET_ASSERT_VERIFY(ref))
+    return;
+
+#if RDMNET_DYNAMIC_MEM
+  // Keep the index no more than half full so that probe sequences stay short.
+  if ((index->num_refs + 1) * 2 > index->num_slots)
+  {
+    size_t new_num_slots = index->num_slots * 2;
+    void** new_slots = (void**)calloc(new_num_slots, sizeof(void*));
+    if (new_slots)
+    {
+      for (size_t i = 0; i < index->num_slots; ++i)
+      {
+        if (index->slots[i])
+          ref_index_insert(new_slots, new_num_slots, index->hash, index->slots[i]);
+      }
+      free(index->slots);
+      index->slots = new_slots;
+      index->num_slots = new_num_slots;
+    }
+  }
+#endif
+
+  // There must always be at least one empty slot to terminate a lookup.
+  if (index->num_refs + 1 < index->num_slots)
+  {
+    ref_index_insert(index->slots, index->num_slots, index->hash, ref);
+    ++index->num_refs;
+  }
+}
+
+void ref_index_remove(RCRefIndex* index, const void* ref)
+{
+  if (!RDMNET_ASSERT_VERIFY(index) || !RDMNET_ASSERT_VERIFY(index->slots) || !RDMNET_ASSERT_VERIFY(ref))
+    return;
+
+  size_t n = index->num_slots;
+  size_t hole = index->hash(ref) % n;
+  while (index->slots[hole] != ref)
+  {
+    if (!index->slots[hole])
+      return;
+    hole = (hole + 1) % n;
+  }
+  index->slots[hole] = NULL;
+  --index->num_refs;
+
+  // Shift back any following refs that can no longer be reached past the hole.
+  for (size_t i = (hole + 1) % n; index->slots[i]; i = (i + 1) % n)
+  {
+    size_t home = index->hash(index->slots[i]) % n;
+    bool   reachable = (hole < i) ? (home > hole && home <= i) : (home > hole || home <= i);
+    if (!reachable)
+    {
+      index->slots[hole] = index->slots[i];
+      index->slots[i] = NULL;
+      hole = i;
+    }
+  }
+}
+
+void ref_index_clear(RCRefIndex* index)
+{
+  if (!RDMNET_ASSERT_VERIFY(index) || !RDMNET_ASSERT_VERIFY(index->slots))
+    return;
+
+  memset(index->slots, 0, index->num_slots * sizeof(void*));
+  index->num_refs = 0;
+}
+
+void ref_index_insert(void** slots, size_t num_slots, RCRefHashFunction hash, void* ref)
+{
+  size_t i = hash(ref) % num_slots;
+  while (slots[i])
+    i = (i + 1) % num_slots;
+  slots[i] = ref;
+}
+
 /*
  * A wrapper for the C library function strncpy() which truncates safely.
  *
@@ -27,6 +27,7 @@
 
 #include <stddef.h>
 #include <stdbool.h>
+#include <stdint.h>
 #include "rdmnet/core/opts.h"
 #include "etcpal/netint.h"
 
@@ -141,16 +142,47 @@ typedef struct RCRefList
   size_t num_refs;
 } RCRefList;
 
+/*
+ * An RCRefIndex is an optional hash index over the active list of an RCRefLists, for modules that
+ * look up refs by a key (e.g. a CID) for every received message. It is kept in sync by
+ * rc_ref_lists_add_pending(), rc_ref_lists_remove_marked() and rc_ref_lists_remove_all(), and is
+ * searched by rc_ref_lists_find_active().
+ *
+ * Declare indexed lists with RC_DECLARE_INDEXED_REF_LISTS(), giving a function that hashes the key
+ * of a ref. Lookups must hash their key the same way; rc_hash_bytes() can be used for both. The
+ * index uses linear probing and is kept no more than half full, so with static memory it has
+ * twice as many slots as the max_static passed to the macro.
+ */
+
+typedef uint32_t (*RCRefHashFunction)(const void* ref);
+
+typedef struct RCRefIndex
+{
+  RCRefHashFunction hash;
+#if RDMNET_DYNAMIC_MEM
+  void** slots;
+  size_t num_slots;
+#else
+  void** const slots;
+  const size_t num_slots;
+#endif
+  size_t num_refs;
+} RCRefIndex;
+
 typedef struct RCRefLists
 {
-  RCRefList active;
-  RCRefList pending;
-  RCRefList to_remove;
+  RCRefList   active;
+  RCRefList   pending;
+  RCRefList   to_remove;
+  RCRefIndex* index;  // Indexes the active list. NULL if the lists are not indexed.
 } RCRefLists;
 
 #if RDMNET_DYNAMIC_MEM
 #define RC_DECLARE_REF_LIST(name, max_static) static RCRefList name
 #define RC_DECLARE_REF_LISTS(name, max_static) static RCRefLists name
+#define RC_DECLARE_INDEXED_REF_LISTS(name, max_static, hash_fn) \
+  static RCRefIndex name##_index = {hash_fn, NULL, 0, 0};      \
+  static RCRefLists name = {{NULL, 0, 0}, {NULL, 0, 0}, {NULL, 0, 0}, &name##_index}
 #else
 #define RC_DECLARE_REF_LIST(name, max_static)  \
   static void*     name##_ref_buf[max_static]; \
@@ -161,6 +193,14 @@ typedef struct RCRefLists
   static void*      name##_to_remove_buf[max_static]; \
   static RCRefLists name = {                          \
       {name##_active_buf, max_static, 0}, {name##_pending_buf, max_static, 0}, {name##_to_remove_buf, max_static, 0}}
+#define RC_DECLARE_INDEXED_REF_LISTS(name, max_static, hash_fn)                                      \
+  static void*      name##_index_buf[(max_static)*2];                                                \
+  static RCRefIndex name##_index = {hash_fn, name##_index_buf, (max_static)*2, 0};                   \
+  static void*      name##_active_buf[max_static];                                                   \
+  static void*      name##_pending_buf[max_static];                                                  \
+  static void*      name##_to_remove_buf[max_static];                                                \
+  static RCRefLists name = {{name##_active_buf, max_static, 0}, {name##_pending_buf, max_static, 0}, \
+                            {name##_to_remove_buf, max_static, 0}, &name##_index}
 #endif
 
 typedef void (*RCRefFunction)(void* ref, const void* context);
@@ -177,11 +217,17 @@ void* rc_ref_list_find_ref(const RCRefList* list, RCRefPredicate predicate, cons
 void  rc_ref_list_for_each(RCRefList* list, RCRefFunction fn, const void* context);
 
 // Combined lists functions
-bool rc_ref_lists_init(RCRefLists* lists);
-void rc_ref_lists_cleanup(RCRefLists* lists);
-void rc_ref_lists_add_pending(RCRefLists* lists);
-void rc_ref_lists_remove_marked(RCRefLists* lists, RCRefFunction on_remove, const void* context);
-void rc_ref_lists_remove_all(RCRefLists* lists, RCRefFunction on_remove, const void* context);
+bool  rc_ref_lists_init(RCRefLists* lists);
+void  rc_ref_lists_cleanup(RCRefLists* lists);
+void  rc_ref_lists_add_pending(RCRefLists* lists);
+void  rc_ref_lists_remove_marked(RCRefLists* lists, RCRefFunction on_remove, const void* context);
+void  rc_ref_lists_remove_all(RCRefLists* lists, RCRefFunction on_remove, const void* context);
+void* rc_ref_lists_find_active(const RCRefLists* lists, uint32_t hash, RCRefPredicate predicate, const void* context);
+
+// Start a hash with RC_HASH_INIT, then feed each part of a key to rc_hash_bytes() in turn (FNV-1a).
+#define RC_HASH_INIT 2166136261u
+
+uint32_t rc_hash_bytes(const void* data, size_t size, uint32_t hash);
 
 char* rdmnet_safe_strncpy(char* destination, const char* source, size_t num);
 
@@ -1868,7 +1868,7 @@ void handle_endpoint_list(RdmnetDevice* device, const RdmCommandHeader* rdm_head
   }
 
   size_t   pd_len = (device->num_endpoints * 3) + 4;
-  uint8_t* buf = rc_client_get_internal_response_buf(pd_len);
+  uint8_t* buf = rc_client_get_internal_response_buf(&device->client, pd_len);
   if (!buf)
   {
     RDMNET_SYNC_SEND_RDM_NACK(response, kRdmNRHardwareFault);
@@ -1907,7 +1907,7 @@ void handle_endpoint_list_change(RdmnetDevice*           device,
   }
 
   size_t   pd_len = 4;
-  uint8_t* buf = rc_client_get_internal_response_buf(pd_len);
+  uint8_t* buf = rc_client_get_internal_response_buf(&device->client, pd_len);
   if (!buf)
   {
     RDMNET_SYNC_SEND_RDM_NACK(response, kRdmNRHardwareFault);
@@ -1949,7 +1949,7 @@ void handle_endpoint_responders(RdmnetDevice*           device,
   }
 
   size_t   pd_len = (etcpal_rbtree_size(&endpoint->responders) * 6) + 6;
-  uint8_t* buf = rc_client_get_internal_response_buf(pd_len);
+  uint8_t* buf = rc_client_get_internal_response_buf(&device->client, pd_len);
   if (!buf)
   {
     RDMNET_SYNC_SEND_RDM_NACK(response, kRdmNRHardwareFault);
@@ -2014,7 +2014,7 @@ void handle_endpoint_responder_list_change(RdmnetDevice*           device,
   }
 
   size_t   pd_len = 6;
-  uint8_t* buf = rc_client_get_internal_response_buf(pd_len);
+  uint8_t* buf = rc_client_get_internal_response_buf(&device->client, pd_len);
   if (!buf)
   {
     RDMNET_SYNC_SEND_RDM_NACK(response, kRdmNRHardwareFault);
@@ -2071,7 +2071,7 @@ void handle_binding_control_fields(RdmnetDevice*           device,
   }
 
   size_t   pd_len = 16;
-  uint8_t* buf = rc_client_get_internal_response_buf(pd_len);
+  uint8_t* buf = rc_client_get_internal_response_buf(&device->client, pd_len);
   if (!buf)
   {
     RDMNET_SYNC_SEND_RDM_NACK(response, kRdmNRHardwareFault);
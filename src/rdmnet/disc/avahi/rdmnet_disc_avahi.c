@@ -202,13 +202,13 @@ static void browse_callback(AvahiServiceBrowser*                    b,
     if (event == AVAHI_BROWSER_NEW)
     {
       // Track this resolve operation
-      DiscoveredBroker* db = discovered_broker_find_by_name(ref->broker_list, full_name);
+      DiscoveredBroker* db = discovered_broker_table_find_by_name(&ref->brokers, name, full_name);
       if (!db)
       {
         // Allocate a new DiscoveredBroker to track info as it comes in.
         db = discovered_broker_new(ref, name, full_name);
         if (db)
-          discovered_broker_insert(&ref->broker_list, db);
+          discovered_broker_table_insert(&ref->brokers, db);
       }
       if (db)
       {
@@ -241,11 +241,11 @@ static void browse_callback(AvahiServiceBrowser*                    b,
     else
     {
       // Service removal
-      DiscoveredBroker* db = discovered_broker_find_by_name(ref->broker_list, full_name);
+      DiscoveredBroker* db = discovered_broker_table_find_by_name(&ref->brokers, name, full_name);
       if (db)
       {
         notify_broker_lost(ref, name, &db->cid);
-        discovered_broker_remove(&ref->broker_list, db);
+        discovered_broker_table_remove(&ref->brokers, db);
         discovered_broker_delete(db);
       }
     }
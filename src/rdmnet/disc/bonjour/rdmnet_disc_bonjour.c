@@ -65,7 +65,7 @@ static size_t           num_disc_netints = 0;
 
 /*********************** Private function prototypes *************************/
 
-static DiscoveredBroker* discovered_broker_lookup_by_ref(DiscoveredBroker* list_head, DNSServiceRef dnssd_ref);
+static DiscoveredBroker* discovered_broker_lookup_by_ref(DiscoveredBrokerTable* table, DNSServiceRef dnssd_ref);
 static void              get_registration_string(const char* srv_type, const char* scope, char* reg_str);
 static void              broker_info_to_txt_record(const RdmnetBrokerRegisterRef* ref, TXTRecordRef* txt);
 static bool              txt_record_to_broker_info(const unsigned char* txt, uint16_t txt_len, DiscoveredBroker* db);
@@ -149,14 +149,14 @@ void DNSSD_API HandleDNSServiceGetAddrInfoReply(DNSServiceRef          sdRef,
   if (!scope_monitor_ref_is_valid(ref))
     return;
 
-  DiscoveredBroker* db = discovered_broker_lookup_by_ref(ref->broker_list, sdRef);
+  DiscoveredBroker* db = discovered_broker_lookup_by_ref(&ref->brokers, sdRef);
   if (!db || db->platform_data.state != kResolveStateGetAddrInfo)
     return;
 
   if (errorCode != kDNSServiceErr_NoError)
   {
     // Remove the DiscoveredBroker from the list
-    discovered_broker_remove(&ref->broker_list, db);
+    discovered_broker_table_remove(&ref->brokers, db);
     discovered_broker_delete(db);
     return;
   }
@@ -192,7 +192,7 @@ void DNSSD_API HandleDNSServiceGetAddrInfoReply(DNSServiceRef          sdRef,
 
     if (db->num_listen_addrs == 0)  // Perhaps all of the addrs were filtered
     {
-      discovered_broker_remove(&ref->broker_list, db);
+      discovered_broker_table_remove(&ref->brokers, db);
       discovered_broker_delete(db);
     }
     else
@@ -226,14 +226,14 @@ void DNSSD_API HandleDNSServiceResolveReply(DNSServiceRef        sdRef,
   if (!scope_monitor_ref_is_valid(ref))
     return;
 
-  DiscoveredBroker* db = discovered_broker_lookup_by_ref(ref->broker_list, sdRef);
+  DiscoveredBroker* db = discovered_broker_lookup_by_ref(&ref->brokers, sdRef);
   if (!db || db->platform_data.state != kResolveStateServiceResolve)
     return;
 
   if (errorCode != kDNSServiceErr_NoError || !txt_record_to_broker_info(txtRecord, txtLen, db))
   {
     // Remove the DiscoveredBroker from the list
-    discovered_broker_remove(&ref->broker_list, db);
+    discovered_broker_table_remove(&ref->brokers, db);
     discovered_broker_delete(db);
     return;
   }
@@ -306,13 +306,13 @@ void DNSSD_API HandleDNSServiceBrowseReply(DNSServiceRef       sdRef,
     if (resolve_err == kDNSServiceErr_NoError)
     {
       // Track this resolve operation
-      DiscoveredBroker* db = discovered_broker_find_by_name(ref->broker_list, full_name);
+      DiscoveredBroker* db = discovered_broker_table_find_by_name(&ref->brokers, serviceName, full_name);
       if (!db)
       {
         // Allocate a new DiscoveredBroker to track info as it comes in.
         db = discovered_broker_new(ref, serviceName, full_name);
         if (db)
-          discovered_broker_insert(&ref->broker_list, db);
+          discovered_broker_table_insert(&ref->brokers, db);
       }
       if (db)
       {
@@ -326,11 +326,11 @@ void DNSSD_API HandleDNSServiceBrowseReply(DNSServiceRef       sdRef,
   else
   {
     // Service removal
-    DiscoveredBroker* db = discovered_broker_find_by_name(ref->broker_list, full_name);
+    DiscoveredBroker* db = discovered_broker_table_find_by_name(&ref->brokers, serviceName, full_name);
     if (db)
     {
       notify_broker_lost(ref, serviceName, &db->cid);
-      discovered_broker_remove(&ref->broker_list, db);
+      discovered_broker_table_remove(&ref->brokers, db);
       discovered_broker_delete(db);
     }
   }
@@ -641,13 +641,13 @@ void discovered_broker_free_platform_resources(DiscoveredBroker* db)
  *****************************************************************************/
 
 /*
- * Searches for a DiscoveredBroker instance by associated DNSServiceRef in a list.
+ * Searches for a DiscoveredBroker instance by associated DNSServiceRef in a table.
  * Returns the found instance or NULL if no match was found.
  * Assumes a lock is already taken.
  */
-DiscoveredBroker* discovered_broker_lookup_by_ref(DiscoveredBroker* list_head, DNSServiceRef dnssd_ref)
+DiscoveredBroker* discovered_broker_lookup_by_ref(DiscoveredBrokerTable* table, DNSServiceRef dnssd_ref)
 {
-  for (DiscoveredBroker* current = list_head; current; current = current->next)
+  for (DiscoveredBroker* current = table->head; current; current = current->next)
   {
     if (current->platform_data.dnssd_ref == dnssd_ref)
     {
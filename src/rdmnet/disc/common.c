@@ -490,7 +490,7 @@ bool conflicting_broker_found(RdmnetBrokerRegisterRef* broker_ref, bool* should_
   }
 
   *should_deregister = false;
-  for (const DiscoveredBroker* db = broker_ref->scope_monitor_handle->broker_list; db; db = db->next)
+  for (const DiscoveredBroker* db = broker_ref->scope_monitor_handle->brokers.head; db; db = db->next)
   {
     if (ETCPAL_UUID_CMP(&broker_ref->cid, &db->cid) != 0)
     {
@@ -53,6 +53,8 @@
 #define FREE_DISCOVERED_BROKER(ptr)
 #endif
 
+#define BUCKET_FOR_HASH(hash) ((hash) & (DISCOVERED_BROKER_TABLE_NUM_BUCKETS - 1))
+
 /**************************** Private variables ******************************/
 
 #if !RDMNET_DYNAMIC_MEM && RDMNET_MAX_DISCOVERED_BROKERS_PER_SCOPE
@@ -83,6 +85,7 @@ static bool get_next_unused_txt_item(DiscoveredBroker*          db,
 #if RDMNET_DYNAMIC_MEM
 static bool expand_txt_record_arrays(DiscoveredBroker* db);
 #endif
+static uint32_t hash_service_name(const char* service_name);
 
 /*************************** Function definitions ****************************/
 
@@ -114,24 +117,6 @@ DiscoveredBroker* discovered_broker_new(rdmnet_scope_monitor_t monitor_ref,
   return new_db;
 }
 
-void discovered_broker_insert(DiscoveredBroker** list_head_ptr, DiscoveredBroker* new_db)
-{
-  if (!RDMNET_ASSERT_VERIFY(list_head_ptr) || !RDMNET_ASSERT_VERIFY(new_db))
-    return;
-
-  if (*list_head_ptr)
-  {
-    DiscoveredBroker* cur = *list_head_ptr;
-    for (; cur->next; cur = cur->next)
-      ;
-    cur->next = new_db;
-  }
-  else
-  {
-    *list_head_ptr = new_db;
-  }
-}
-
 bool discovered_broker_add_listen_addr(DiscoveredBroker* db, const EtcPalIpAddr* addr, unsigned int netint)
 {
   if (!RDMNET_ASSERT_VERIFY(db) || !RDMNET_ASSERT_VERIFY(addr))
@@ -319,14 +304,64 @@ void discovered_broker_fill_disc_info(const DiscoveredBroker* db, RdmnetBrokerDi
   }
 }
 
-DiscoveredBroker* discovered_broker_find(DiscoveredBroker*                 list_head,
-                                         DiscoveredBrokerPredicateFunction predicate,
-                                         const void*                       context)
+void discovered_broker_delete(DiscoveredBroker* db)
+{
+  if (!RDMNET_ASSERT_VERIFY(db))
+    return;
+
+#if RDMNET_DYNAMIC_MEM
+  if (db->additional_txt_items_data)
+    free(db->additional_txt_items_data);
+  if (db->additional_txt_items_array)
+    free(db->additional_txt_items_array);
+  if (db->listen_addr_array)
+    free(db->listen_addr_array);
+  if (db->listen_addr_netint_array)
+    free(db->listen_addr_netint_array);
+#endif
+  discovered_broker_free_platform_resources(db);
+  FREE_DISCOVERED_BROKER(db);
+}
+
+void discovered_broker_table_init(DiscoveredBrokerTable* table)
+{
+  if (!RDMNET_ASSERT_VERIFY(table))
+    return;
+
+  memset(table, 0, sizeof(DiscoveredBrokerTable));
+}
+
+/*
+ * Add a broker to the end of a table. Its service instance name must already be set, and must not
+ * change while it is in the table.
+ */
+void discovered_broker_table_insert(DiscoveredBrokerTable* table, DiscoveredBroker* db)
 {
-  if (!RDMNET_ASSERT_VERIFY(predicate))
+  if (!RDMNET_ASSERT_VERIFY(table) || !RDMNET_ASSERT_VERIFY(db))
+    return;
+
+  db->next = NULL;
+  db->prev = table->tail;
+  if (table->tail)
+    table->tail->next = db;
+  else
+    table->head = db;
+  table->tail = db;
+  ++table->num_brokers;
+
+  DiscoveredBroker** bucket = &table->name_buckets[BUCKET_FOR_HASH(hash_service_name(db->service_instance_name))];
+  db->next_by_name = *bucket;
+  *bucket = db;
+}
+
+DiscoveredBroker* discovered_broker_table_find(const DiscoveredBrokerTable*     table,
+                                               DiscoveredBrokerPredicateFunction predicate,
+                                               const void*                       context)
+{
+  if (!RDMNET_ASSERT_VERIFY(table) || !RDMNET_ASSERT_VERIFY(predicate))
     return NULL;
 
-  for (DiscoveredBroker* current = list_head; current; current = current->next)
+  for (DiscoveredBroker* current = table->head; current; current = current->next)
   {
     if (predicate(current, context))
       return current;
@@ -334,63 +369,105 @@ DiscoveredBroker* discovered_broker_find(DiscoveredBroker*                 list_
   return NULL;
 }
 
-DiscoveredBroker* discovered_broker_find_by_name(DiscoveredBroker* list_head, const char* full_name)
+/*
+ * Find a broker by its service instance name. Brokers can also be matched on their full service
+ * name, for platforms that can discover the same service instance in more than one domain; pass
+ * NULL for full_service_name to match on the service instance name alone.
+ */
+DiscoveredBroker* discovered_broker_table_find_by_name(const DiscoveredBrokerTable* table,
+                                                       const char*                  service_name,
+                                                       const char*                  full_service_name)
 {
-  if (!RDMNET_ASSERT_VERIFY(full_name))
+  if (!RDMNET_ASSERT_VERIFY(table) || !RDMNET_ASSERT_VERIFY(service_name))
     return NULL;
 
-  for (DiscoveredBroker* current = list_head; current; current = current->next)
+  DiscoveredBroker* current = table->name_buckets[BUCKET_FOR_HASH(hash_service_name(service_name))];
+  for (; current; current = current->next_by_name)
   {
-    if (strcmp(current->full_service_name, full_name) == 0)
+    if (strcmp(current->service_instance_name, service_name) == 0 &&
+        (!full_service_name || strcmp(current->full_service_name, full_service_name) == 0))
+    {
       return current;
+    }
   }
   return NULL;
 }
 
-void discovered_broker_remove(DiscoveredBroker** list_head_ptr, const DiscoveredBroker* db)
+/* Remove a broker from a table. The broker is not deallocated. */
+void discovered_broker_table_remove(DiscoveredBrokerTable* table, DiscoveredBroker* db)
 {
-  if (!RDMNET_ASSERT_VERIFY(list_head_ptr) || !RDMNET_ASSERT_VERIFY(db))
+  if (!RDMNET_ASSERT_VERIFY(table) || !RDMNET_ASSERT_VERIFY(db))
     return;
 
-  if (!(*list_head_ptr))
-    return;
+  if (db->prev)
+    db->prev->next = db->next;
+  else if (table->head == db)
+    table->head = db->next;
+  else
+    return;  // Not in this table
 
-  if (*list_head_ptr == db)
+  if (db->next)
+    db->next->prev = db->prev;
+  else
+    table->tail = db->prev;
+  db->next = NULL;
+  db->prev = NULL;
+  if (RDMNET_ASSERT_VERIFY(table->num_brokers > 0))
+    --table->num_brokers;
+
+  DiscoveredBroker** link = &table->name_buckets[BUCKET_FOR_HASH(hash_service_name(db->service_instance_name))];
+  for (; *link; link = &(*link)->next_by_name)
   {
-    // Remove from the head of the list
-    *list_head_ptr = (*list_head_ptr)->next;
+    if (*link == db)
+    {
+      *link = db->next_by_name;
+      break;
+    }
   }
-  else
+  db->next_by_name = NULL;
+}
+
+/*
+ * Remove every broker in a table that matches a predicate in a single pass. on_remove is called
+ * with each broker after it has been removed, and is responsible for deallocating it. Returns the
+ * number of brokers removed.
+ */
+size_t discovered_broker_table_remove_if(DiscoveredBrokerTable*            table,
+                                         DiscoveredBrokerPredicateFunction predicate,
+                                         DiscoveredBrokerFunction          on_remove,
+                                         const void*                       context)
+{
+  if (!RDMNET_ASSERT_VERIFY(table) || !RDMNET_ASSERT_VERIFY(predicate) || !RDMNET_ASSERT_VERIFY(on_remove))
+    return 0;
+
+  size_t            num_removed = 0;
+  DiscoveredBroker* next_db = NULL;
+  for (DiscoveredBroker* db = table->head; db; db = next_db)
   {
-    // Find in the list and remove.
-    for (DiscoveredBroker* prev_db = *list_head_ptr; prev_db->next; prev_db = prev_db->next)
+    next_db = db->next;
+    if (predicate(db, context))
     {
-      if (prev_db->next == db)
-      {
-        prev_db->next = prev_db->next->next;
-        break;
-      }
+      discovered_broker_table_remove(table, db);
+      on_remove(db, context);
+      ++num_removed;
     }
   }
+  return num_removed;
 }
 
-void discovered_broker_delete(DiscoveredBroker* db)
+/* Deallocate all brokers in a table, leaving it empty. */
+void discovered_broker_table_delete_all(DiscoveredBrokerTable* table)
 {
-  if (!RDMNET_ASSERT_VERIFY(db))
+  if (!RDMNET_ASSERT_VERIFY(table))
     return;
 
-#if RDMNET_DYNAMIC_MEM
-  if (db->additional_txt_items_data)
-    free(db->additional_txt_items_data);
-  if (db->additional_txt_items_array)
-    free(db->additional_txt_items_array);
-  if (db->listen_addr_array)
-    free(db->listen_addr_array);
-  if (db->listen_addr_netint_array)
-    free(db->listen_addr_netint_array);
-#endif
-  discovered_broker_free_platform_resources(db);
-  FREE_DISCOVERED_BROKER(db);
+  DiscoveredBroker* next_db = NULL;
+  for (DiscoveredBroker* db = table->head; db; db = next_db)
+  {
+    next_db = db->next;
+    discovered_broker_delete(db);
+  }
+  discovered_broker_table_init(table);
 }
 
 bool find_txt_item(DiscoveredBroker*          db,
@@ -503,3 +580,8 @@ bool expand_txt_record_arrays(DiscoveredBroker* db)
   return false;
 }
 #endif
+
+uint32_t hash_service_name(const char* service_name)
+{
+  return rc_hash_bytes(service_name, strlen(service_name), RC_HASH_INIT);
+}
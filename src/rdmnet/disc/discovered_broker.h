@@ -71,10 +71,31 @@ struct DiscoveredBroker
 
   rdmnet_scope_monitor_t             monitor_ref;
   RdmnetDiscoveredBrokerPlatformData platform_data;
-  DiscoveredBroker*                  next;
+
+  // Links in the DiscoveredBrokerTable that holds this broker
+  DiscoveredBroker* next;
+  DiscoveredBroker* prev;
+  DiscoveredBroker* next_by_name;
 };
 
+// The number of hash buckets in a DiscoveredBrokerTable's name index. Must be a power of 2.
+#define DISCOVERED_BROKER_TABLE_NUM_BUCKETS 16
+
+/*
+ * The brokers discovered on a scope, in the order they were discovered, indexed by service name.
+ * Brokers are linked into the table through their own table links, so the table needs no memory of
+ * its own; with static memory, the number of brokers is limited only by the discovered broker pool.
+ */
+typedef struct DiscoveredBrokerTable
+{
+  DiscoveredBroker* head;
+  DiscoveredBroker* tail;
+  size_t            num_brokers;
+  DiscoveredBroker* name_buckets[DISCOVERED_BROKER_TABLE_NUM_BUCKETS];
+} DiscoveredBrokerTable;
+
 typedef bool (*DiscoveredBrokerPredicateFunction)(const DiscoveredBroker* db, const void* context);
+typedef void (*DiscoveredBrokerFunction)(DiscoveredBroker* db, const void* context);
 
 // None of these functions are thread-safe and as such they should always be called within
 // appropriate locks.
@@ -83,7 +104,6 @@ etcpal_error_t    discovered_broker_module_init(void);
 DiscoveredBroker* discovered_broker_new(rdmnet_scope_monitor_t monitor_ref,
                                         const char*            service_name,
                                         const char*            full_service_name);
-void              discovered_broker_insert(DiscoveredBroker** list_head_ptr, DiscoveredBroker* new_db);
 bool discovered_broker_add_listen_addr(DiscoveredBroker* db, const EtcPalIpAddr* addr, unsigned int netint);
 bool discovered_broker_add_txt_record_item(DiscoveredBroker* db,
                                            const char*       key,
@@ -95,13 +115,23 @@ bool discovered_broker_add_binary_txt_record_item(DiscoveredBroker* db,
                                                   const uint8_t*    value,
                                                   uint8_t           value_len);
 
-void              discovered_broker_fill_disc_info(const DiscoveredBroker* db, RdmnetBrokerDiscInfo* broker_info);
-DiscoveredBroker* discovered_broker_find(DiscoveredBroker*                 list_head,
-                                         DiscoveredBrokerPredicateFunction predicate,
-                                         const void*                       context);
-DiscoveredBroker* discovered_broker_find_by_name(DiscoveredBroker* list_head, const char* full_name);
-void              discovered_broker_remove(DiscoveredBroker** list_head_ptr, const DiscoveredBroker* db);
-void              discovered_broker_delete(DiscoveredBroker* db);
+void discovered_broker_fill_disc_info(const DiscoveredBroker* db, RdmnetBrokerDiscInfo* broker_info);
+void discovered_broker_delete(DiscoveredBroker* db);
+
+void              discovered_broker_table_init(DiscoveredBrokerTable* table);
+void              discovered_broker_table_insert(DiscoveredBrokerTable* table, DiscoveredBroker* db);
+DiscoveredBroker* discovered_broker_table_find(const DiscoveredBrokerTable*     table,
+                                               DiscoveredBrokerPredicateFunction predicate,
+                                               const void*                       context);
+DiscoveredBroker* discovered_broker_table_find_by_name(const DiscoveredBrokerTable* table,
+                                                       const char*                  service_name,
+                                                       const char*                  full_service_name);
+void              discovered_broker_table_remove(DiscoveredBrokerTable* table, DiscoveredBroker* db);
+size_t            discovered_broker_table_remove_if(DiscoveredBrokerTable*            table,
+                                                    DiscoveredBrokerPredicateFunction predicate,
+                                                    DiscoveredBrokerFunction          on_remove,
+                                                    const void*                       context);
+void              discovered_broker_table_delete_all(DiscoveredBrokerTable* table);
 
 #ifdef __cplusplus
 }
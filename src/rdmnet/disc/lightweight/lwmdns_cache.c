@@ -0,0 +1,364 @@
+/******************************************************************************
+ * Copyright 2020 ETC Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ ******************************************************************************
+ * This file is a part of RDMnet. For more information, go to:
+ * https://github.com/ETCLabs/RDMnet
+ *****************************************************************************/
+
+#include "lwmdns_cache.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include "rdmnet/core/opts.h"
+
+#if !RDMNET_DYNAMIC_MEM
+#include "etcpal/mempool.h"
+#endif
+
+/******************************************************************************
+ * Private Macros
+ *****************************************************************************/
+
+#if RDMNET_DYNAMIC_MEM
+#define ALLOC_CACHE_ENTRY() (LwMdnsCacheEntry*)malloc(sizeof(LwMdnsCacheEntry))
+#define FREE_CACHE_ENTRY(ptr) free(ptr)
+#elif RDMNET_LWMDNS_MAX_CACHED_RECORDS
+#define ALLOC_CACHE_ENTRY() (LwMdnsCacheEntry*)etcpal_mempool_alloc(lwmdns_cache_entries)
+#define FREE_CACHE_ENTRY(ptr) etcpal_mempool_free(lwmdns_cache_entries, ptr)
+#else
+#define ALLOC_CACHE_ENTRY() NULL
+#define FREE_CACHE_ENTRY(ptr)
+#endif
+
+// RFC 6762 section 10.1: a record received with a TTL of 0 is removed one second later.
+#define GOODBYE_TTL 1
+// RFC 6762 section 10.2: a cache-flush record replaces others of the same name and type that were
+// received more than a second before it.
+#define CACHE_FLUSH_GRACE_PERIOD 1000
+// Keeps TTLs within the range of an EtcPalTimer.
+#define MAX_TTL 604800
+
+/******************************************************************************
+ * Private Variables
+ *****************************************************************************/
+
+#if !RDMNET_DYNAMIC_MEM && RDMNET_LWMDNS_MAX_CACHED_RECORDS
+ETCPAL_MEMPOOL_DEFINE(lwmdns_cache_entries, LwMdnsCacheEntry, RDMNET_LWMDNS_MAX_CACHED_RECORDS);
+#endif
+
+static const uint8_t kRequeryPercentages[LWMDNS_CACHE_NUM_REQUERIES] = {80, 85, 90, 95};
+
+static LwMdnsCacheEntry* cache_head;
+static size_t            cache_size;
+
+// Scratch space for the uncompressed data of a record being added.
+static uint8_t new_record_data[LWMDNS_CACHE_MAX_DATA_LEN];
+
+/******************************************************************************
+ * Private function prototypes
+ *****************************************************************************/
+
+static bool              record_is_cacheable(const uint8_t* buf_begin, const DnsResourceRecord* rr);
+static bool              host_is_srv_target(const uint8_t* buf_begin, const uint8_t* name);
+static bool              copy_record_data(const uint8_t* buf_begin, const DnsResourceRecord* rr, uint16_t* data_len);
+static LwMdnsCacheEntry* find_entry(const uint8_t* name, uint8_t name_len, dns_record_type_t type, uint16_t data_len);
+static void              refresh_entry(LwMdnsCacheEntry* entry, uint32_t ttl);
+static void              flush_other_entries(const LwMdnsCacheEntry* new_entry, uint8_t name_len);
+static void              remove_entry(LwMdnsCacheEntry* entry, LwMdnsCacheEntry* prev);
+
+/******************************************************************************
+ * Function Definitions
+ *****************************************************************************/
+
+etcpal_error_t lwmdns_cache_module_init(void)
+{
+  cache_head = NULL;
+  cache_size = 0;
+#if !RDMNET_DYNAMIC_MEM && RDMNET_LWMDNS_MAX_CACHED_RECORDS
+  return etcpal_mempool_init(lwmdns_cache_entries);
+#else
+  return kEtcPalErrOk;
+#endif
+}
+
+void lwmdns_cache_module_deinit(void)
+{
+  while (cache_head)
+    remove_entry(cache_head, NULL);
+}
+
+/*
+ * Add a record received in an mDNS response to the cache, or refresh the cached copy. Records that
+ * aren't relevant to RDMnet discovery are ignored.
+ */
+void lwmdns_cache_add(const uint8_t* buf_begin, const DnsResourceRecord* rr)
+{
+  if (!RDMNET_ASSERT_VERIFY(buf_begin) || !RDMNET_ASSERT_VERIFY(rr))
+    return;
+
+  if (!record_is_cacheable(buf_begin, rr))
+    return;
+
+  uint8_t  name[DNS_FQDN_MAX_LENGTH];
+  uint8_t  name_len = lwmdns_copy_domain_name(buf_begin, rr->name, name);
+  uint16_t data_len = 0;
+  if (name_len == 0 || !copy_record_data(buf_begin, rr, &data_len))
+    return;
+
+  LwMdnsCacheEntry* entry = find_entry(name, name_len, rr->record_type, data_len);
+  if (entry)
+  {
+    if (rr->ttl == 0)
+    {
+      // The record is going away; don't requery it.
+      refresh_entry(entry, GOODBYE_TTL);
+      entry->num_requeries_sent = LWMDNS_CACHE_NUM_REQUERIES;
+      return;
+    }
+    refresh_entry(entry, rr->ttl);
+  }
+  else
+  {
+    if (rr->ttl == 0)
+      return;
+
+    entry = ALLOC_CACHE_ENTRY();
+    if (!entry)
+      return;
+
+    memcpy(entry->name, name, name_len);
+    entry->record_type = rr->record_type;
+    entry->data_len = data_len;
+    memcpy(entry->data, new_record_data, data_len);
+    refresh_entry(entry, rr->ttl);
+
+    entry->next = cache_head;
+    cache_head = entry;
+    ++cache_size;
+  }
+
+  if (rr->cache_flush)
+    flush_other_entries(entry, name_len);
+}
+
+/* Iterate over the cache: pass NULL to get the first entry. Returns NULL after the last entry. */
+const LwMdnsCacheEntry* lwmdns_cache_next(const LwMdnsCacheEntry* entry)
+{
+  return (entry ? entry->next : cache_head);
+}
+
+size_t lwmdns_cache_size(void)
+{
+  return cache_size;
+}
+
+/*
+ * Send requeries for records nearing expiry through requery_func, which may be NULL if there is no
+ * current interest in the cached records, and remove expired records, passing each to expire_func
+ * first.
+ */
+void lwmdns_cache_process(LwMdnsCacheEntryFunction requery_func, LwMdnsCacheEntryFunction expire_func)
+{
+  LwMdnsCacheEntry* prev = NULL;
+  LwMdnsCacheEntry* entry = cache_head;
+  while (entry)
+  {
+    LwMdnsCacheEntry* next = entry->next;
+    if (etcpal_timer_is_expired(&entry->ttl_timer))
+    {
+      if (expire_func)
+        expire_func(entry);
+      remove_entry(entry, prev);
+    }
+    else
+    {
+      if (requery_func && entry->num_requeries_sent < LWMDNS_CACHE_NUM_REQUERIES)
+      {
+        // TTL in seconds * 1000 ms * percentage / 100
+        uint64_t requery_point =
+            (uint64_t)entry->ttl * 10u * (kRequeryPercentages[entry->num_requeries_sent] + entry->requery_jitter);
+        if (etcpal_timer_elapsed(&entry->ttl_timer) >= requery_point)
+        {
+          requery_func(entry);
+          ++entry->num_requeries_sent;
+        }
+      }
+      prev = entry;
+    }
+    entry = next;
+  }
+}
+
+/* The remaining TTL of a cached record, in seconds. */
+uint32_t lwmdns_cache_entry_remaining_ttl(const LwMdnsCacheEntry* entry)
+{
+  if (!RDMNET_ASSERT_VERIFY(entry))
+    return 0;
+
+  return etcpal_timer_remaining(&entry->ttl_timer) / 1000;
+}
+
+/* Present a cached record as a received one, with its remaining TTL. */
+void lwmdns_cache_entry_to_rr(const LwMdnsCacheEntry* entry, DnsResourceRecord* rr)
+{
+  if (!RDMNET_ASSERT_VERIFY(entry) || !RDMNET_ASSERT_VERIFY(rr))
+    return;
+
+  rr->name = entry->name;
+  rr->record_type = entry->record_type;
+  rr->cache_flush = false;
+  rr->ttl = lwmdns_cache_entry_remaining_ttl(entry);
+  rr->data_len = entry->data_len;
+  rr->data_ptr = (entry->data_len > 0 ? entry->data : NULL);
+}
+
+bool record_is_cacheable(const uint8_t* buf_begin, const DnsResourceRecord* rr)
+{
+  if (!RDMNET_ASSERT_VERIFY(rr))
+    return false;
+
+  switch (rr->record_type)
+  {
+    case kDnsRecordTypePTR:
+      return lwmdns_domain_name_matches_service_type(buf_begin, rr->name) ||
+             lwmdns_domain_name_is_service_subtype(buf_begin, rr->name);
+    case kDnsRecordTypeSRV:
+    case kDnsRecordTypeTXT:
+      return lwmdns_domain_name_is_service_instance(buf_begin, rr->name);
+    case kDnsRecordTypeA:
+      return rr->data_len == 4 && host_is_srv_target(buf_begin, rr->name);
+    case kDnsRecordTypeAAAA:
+      return rr->data_len == ETCPAL_IPV6_BYTES && host_is_srv_target(buf_begin, rr->name);
+    default:
+      return false;
+  }
+}
+
+/* Address records are cached only for the hosts of cached RDMnet service instances. */
+bool host_is_srv_target(const uint8_t* buf_begin, const uint8_t* name)
+{
+  for (const LwMdnsCacheEntry* entry = cache_head; entry; entry = entry->next)
+  {
+    if (entry->record_type == kDnsRecordTypeSRV &&
+        lwmdns_domain_names_equal(buf_begin, name, entry->data, &entry->data[6]))
+    {
+      return true;
+    }
+  }
+  return false;
+}
+
+/* Copy a record's data into new_record_data, uncompressing any names within it. */
+bool copy_record_data(const uint8_t* buf_begin, const DnsResourceRecord* rr, uint16_t* data_len)
+{
+  if (!RDMNET_ASSERT_VERIFY(rr) || !RDMNET_ASSERT_VERIFY(data_len))
+    return false;
+
+  uint8_t name_len = 0;
+  switch (rr->record_type)
+  {
+    case kDnsRecordTypePTR:
+      if (!rr->data_ptr || lwmdns_parse_domain_name(buf_begin, rr->data_ptr, rr->data_len) == NULL)
+        return false;
+      name_len = lwmdns_copy_domain_name(buf_begin, rr->data_ptr, new_record_data);
+      *data_len = name_len;
+      return name_len > 0;
+    case kDnsRecordTypeSRV:
+      // Priority, weight and port, followed by the target host name
+      if (rr->data_len <= 7 || !rr->data_ptr ||
+          lwmdns_parse_domain_name(buf_begin, &rr->data_ptr[6], rr->data_len - 6) == NULL)
+      {
+        return false;
+      }
+      memcpy(new_record_data, rr->data_ptr, 6);
+      name_len = lwmdns_copy_domain_name(buf_begin, &rr->data_ptr[6], &new_record_data[6]);
+      *data_len = (uint16_t)(6 + name_len);
+      return name_len > 0;
+    default:
+      if (rr->data_len > LWMDNS_CACHE_MAX_DATA_LEN || (rr->data_len > 0 && !rr->data_ptr))
+        return false;
+      if (rr->data_len > 0)
+        memcpy(new_record_data, rr->data_ptr, rr->data_len);
+      *data_len = rr->data_len;
+      return true;
+  }
+}
+
+/* Find the cached copy of a record, comparing against new_record_data. */
+LwMdnsCacheEntry* find_entry(const uint8_t* name, uint8_t name_len, dns_record_type_t type, uint16_t data_len)
+{
+  for (LwMdnsCacheEntry* entry = cache_head; entry; entry = entry->next)
+  {
+    // Names are uncompressed, so a match of name_len bytes (which include the terminating root
+    // label) is a match of the whole name.
+    if (entry->record_type == type && entry->data_len == data_len && memcmp(entry->name, name, name_len) == 0 &&
+        memcmp(entry->data, new_record_data, data_len) == 0)
+    {
+      return entry;
+    }
+  }
+  return NULL;
+}
+
+void refresh_entry(LwMdnsCacheEntry* entry, uint32_t ttl)
+{
+  if (!RDMNET_ASSERT_VERIFY(entry))
+    return;
+
+  if (ttl > MAX_TTL)
+    ttl = MAX_TTL;
+  entry->ttl = ttl;
+  etcpal_timer_start(&entry->ttl_timer, ttl * 1000);
+  entry->num_requeries_sent = 0;
+  entry->requery_jitter = (uint8_t)(rand() % 3);
+}
+
+/* Remove records with the same name and type as new_entry that were received over a second ago. */
+void flush_other_entries(const LwMdnsCacheEntry* new_entry, uint8_t name_len)
+{
+  if (!RDMNET_ASSERT_VERIFY(new_entry))
+    return;
+
+  LwMdnsCacheEntry* prev = NULL;
+  LwMdnsCacheEntry* entry = cache_head;
+  while (entry)
+  {
+    LwMdnsCacheEntry* next = entry->next;
+    if (entry != new_entry && entry->record_type == new_entry->record_type &&
+        memcmp(entry->name, new_entry->name, name_len) == 0 &&
+        etcpal_timer_elapsed(&entry->ttl_timer) > CACHE_FLUSH_GRACE_PERIOD)
+    {
+      remove_entry(entry, prev);
+    }
+    else
+    {
+      prev = entry;
+    }
+    entry = next;
+  }
+}
+
+void remove_entry(LwMdnsCacheEntry* entry, LwMdnsCacheEntry* prev)
+{
+  if (!RDMNET_ASSERT_VERIFY(entry))
+    return;
+
+  if (prev)
+    prev->next = entry->next;
+  else
+    cache_head = entry->next;
+  FREE_CACHE_ENTRY(entry);
+  --cache_size;
+}
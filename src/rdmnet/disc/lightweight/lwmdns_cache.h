@@ -0,0 +1,85 @@
+/******************************************************************************
+ * Copyright 2020 ETC Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ ******************************************************************************
+ * This file is a part of RDMnet. For more information, go to:
+ * https://github.com/ETCLabs/RDMnet
+ *****************************************************************************/
+
+/*
+ * A process-wide cache of the mDNS resource records relevant to RDMnet discovery: PTR records for
+ * the RDMnet service type and its subtypes, SRV and TXT records for RDMnet service instances and
+ * address records for the hosts those instances point to. Cached records are requeried as they
+ * near expiry (RFC 6762 section 5.2), offered as known answers in outgoing queries, and used to
+ * answer new scope monitors without waiting for the network.
+ *
+ * Names in cached records, including those within SRV and PTR data, are stored uncompressed.
+ */
+
+#ifndef LWMDNS_CACHE_H_
+#define LWMDNS_CACHE_H_
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "etcpal/error.h"
+#include "etcpal/timer.h"
+#include "lwmdns_common.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Large enough for any SRV or PTR record and all but the most unusual TXT records; records with
+// more data than this are not cached.
+#define LWMDNS_CACHE_MAX_DATA_LEN 512
+
+// The number of requeries sent as a record nears expiry, at 80%, 85%, 90% and 95% of its TTL.
+#define LWMDNS_CACHE_NUM_REQUERIES 4
+
+typedef struct LwMdnsCacheEntry LwMdnsCacheEntry;
+struct LwMdnsCacheEntry
+{
+  uint8_t           name[DNS_FQDN_MAX_LENGTH];
+  dns_record_type_t record_type;
+  uint16_t          data_len;
+  uint8_t           data[LWMDNS_CACHE_MAX_DATA_LEN];
+
+  uint32_t    ttl;
+  EtcPalTimer ttl_timer;
+  uint8_t     num_requeries_sent;
+  // Added to each requery point, as a percentage of the TTL, to keep hosts from requerying in step
+  uint8_t requery_jitter;
+
+  LwMdnsCacheEntry* next;
+};
+
+typedef void (*LwMdnsCacheEntryFunction)(const LwMdnsCacheEntry* entry);
+
+etcpal_error_t lwmdns_cache_module_init(void);
+void           lwmdns_cache_module_deinit(void);
+
+void                    lwmdns_cache_add(const uint8_t* buf_begin, const DnsResourceRecord* rr);
+const LwMdnsCacheEntry* lwmdns_cache_next(const LwMdnsCacheEntry* entry);
+size_t                  lwmdns_cache_size(void);
+void lwmdns_cache_process(LwMdnsCacheEntryFunction requery_func, LwMdnsCacheEntryFunction expire_func);
+
+uint32_t lwmdns_cache_entry_remaining_ttl(const LwMdnsCacheEntry* entry);
+void     lwmdns_cache_entry_to_rr(const LwMdnsCacheEntry* entry, DnsResourceRecord* rr);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* LWMDNS_CACHE_H_ */
@@ -58,6 +58,9 @@ typedef struct DomainNameLabel
 #define DNS_SD_SERVICE_TYPE_MAX_LEN 20
 #define DNS_LABEL_MAX_LEN 63
 
+// Host names of locally-registered brokers start with this, followed by the CID in hex.
+#define BROKER_HOST_LABEL_PREFIX "rdmnet-"
+
 typedef uint32_t txt_keys_found_mask_t;
 
 #define TXT_KEY_E133SCOPE_FOUND_MASK 0x00000001u
@@ -136,7 +139,7 @@ const uint8_t* lwmdns_parse_dns_header(const uint8_t* buf, int buf_len, DnsHeade
     return NULL;
 
   uint16_t flags = etcpal_unpack_u16b(&buf[DNS_HEADER_OFFSET_FLAGS]);
-  header->query = (flags & DNS_FLAGS_REQUEST_RESPONSE_MASK);
+  header->query = !(flags & DNS_FLAGS_REQUEST_RESPONSE_MASK);
   header->truncated = (flags & DNS_FLAGS_TRUNCATED_MASK);
 
   header->query_count = etcpal_unpack_u16b(&buf[DNS_HEADER_OFFSET_QUESTION_COUNT]);
@@ -355,6 +358,83 @@ bool lwmdns_domain_name_matches_service_subtype(const uint8_t* buf_begin, const
   return is_rdmnet_service_type_and_domain(buf_begin, &label);
 }
 
+bool lwmdns_domain_name_matches_service_type(const uint8_t* buf_begin, const uint8_t* name_ptr)
+{
+  if (!buf_begin || !name_ptr)
+    return false;
+
+  // An empty label ending where the name begins, so that the service type is the next label.
+  DomainNameLabel label = DOMAIN_NAME_LABEL_INIT;
+  label.label = name_ptr;
+  return is_rdmnet_service_type_and_domain(buf_begin, &label);
+}
+
+/* Whether a domain name is an instance of the RDMnet service, i.e. <instance>._rdmnet._tcp.local */
+bool lwmdns_domain_name_is_service_instance(const uint8_t* buf_begin, const uint8_t* name_ptr)
+{
+  if (!buf_begin || !name_ptr)
+    return false;
+
+  DomainNameLabel label = DOMAIN_NAME_LABEL_INIT;
+  if (!get_domain_name_label(buf_begin, name_ptr, &label))
+    return false;
+  return is_rdmnet_service_type_and_domain(buf_begin, &label);
+}
+
+/* Whether a domain name is an RDMnet service subtype for any scope, i.e. _<scope>._sub._rdmnet._tcp.local */
+bool lwmdns_domain_name_is_service_subtype(const uint8_t* buf_begin, const uint8_t* name_ptr)
+{
+  if (!buf_begin || !name_ptr)
+    return false;
+
+  DomainNameLabel label = DOMAIN_NAME_LABEL_INIT;
+  if (!get_domain_name_label(buf_begin, name_ptr, &label) || label.length < 2 || !RDMNET_ASSERT_VERIFY(label.label) ||
+      label.label[0] != (uint8_t)'_')
+  {
+    return false;
+  }
+
+  if (!get_domain_name_label(buf_begin, NULL, &label) || (label.length != (sizeof("_sub") - 1)) ||
+      memcmp(label.label, "_sub", sizeof("_sub") - 1) != 0)
+  {
+    return false;
+  }
+
+  return is_rdmnet_service_type_and_domain(buf_begin, &label);
+}
+
+/*
+ * Whether a domain name could be of interest to RDMnet discovery: the RDMnet service type or any
+ * name under it (i.e. subtypes and service instances), or the host name of a broker registered by
+ * this library. Used to filter received messages cheaply; a match is not necessarily a name we
+ * know about.
+ */
+bool lwmdns_domain_name_is_rdmnet(const uint8_t* buf_begin, const uint8_t* name_ptr)
+{
+  if (!buf_begin || !name_ptr)
+    return false;
+
+  if (lwmdns_domain_name_matches_service_type(buf_begin, name_ptr))
+    return true;
+
+  DomainNameLabel label = DOMAIN_NAME_LABEL_INIT;
+  if (!get_domain_name_label(buf_begin, name_ptr, &label))
+    return false;
+
+  if (label.length > sizeof(BROKER_HOST_LABEL_PREFIX) - 1 &&
+      memcmp(label.label, BROKER_HOST_LABEL_PREFIX, sizeof(BROKER_HOST_LABEL_PREFIX) - 1) == 0)
+  {
+    return true;
+  }
+
+  do
+  {
+    if (is_rdmnet_service_type_and_domain(buf_begin, &label))
+      return true;
+  } while (get_domain_name_label(buf_begin, NULL, &label));
+  return false;
+}
+
 bool lwmdns_domain_label_to_string(const uint8_t* buf_begin, const uint8_t* label, char* str_buf)
 {
   if (!buf_begin || !label || !str_buf)
@@ -370,6 +450,36 @@ bool lwmdns_domain_label_to_string(const uint8_t* buf_begin, const uint8_t* labe
   return false;
 }
 
+/*
+ * Pack the host name under which a locally-registered broker publishes its addresses, in wire
+ * format, into buf (which must be at least DNS_FQDN_MAX_LENGTH bytes). The name is derived from
+ * the broker's CID, i.e. rdmnet-<cid hex>.local, so it is unique without needing to be probed.
+ * Returns the length of the packed name.
+ */
+uint8_t lwmdns_broker_host_name(const EtcPalUuid* cid, uint8_t* buf)
+{
+  if (!RDMNET_ASSERT_VERIFY(cid) || !RDMNET_ASSERT_VERIFY(buf))
+    return 0;
+
+  static const char kHexDigits[] = "0123456789abcdef";
+
+  uint8_t* cur_ptr = buf;
+  *cur_ptr++ = (uint8_t)(sizeof(BROKER_HOST_LABEL_PREFIX) - 1 + ETCPAL_UUID_BYTES * 2);
+  memcpy(cur_ptr, BROKER_HOST_LABEL_PREFIX, sizeof(BROKER_HOST_LABEL_PREFIX) - 1);
+  cur_ptr += sizeof(BROKER_HOST_LABEL_PREFIX) - 1;
+  for (size_t i = 0; i < ETCPAL_UUID_BYTES; ++i)
+  {
+    *cur_ptr++ = (uint8_t)kHexDigits[cid->data[i] >> 4];
+    *cur_ptr++ = (uint8_t)kHexDigits[cid->data[i] & 0x0f];
+  }
+
+  *cur_ptr++ = 5;
+  memcpy(cur_ptr, "local", 5);
+  cur_ptr += 5;
+  *cur_ptr++ = 0;
+  return (uint8_t)(cur_ptr - buf);
+}
+
 txt_record_parse_result_t lwmdns_txt_record_to_broker_info(const uint8_t*    txt_data,
                                                            uint16_t          txt_data_len,
                                                            DiscoveredBroker* db)
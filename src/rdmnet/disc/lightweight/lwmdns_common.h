@@ -39,6 +39,7 @@ extern "C" {
 #define DNS_HEADER_OFFSET_ADDITIONAL_COUNT 10
 
 #define DNS_FLAGS_REQUEST_RESPONSE_MASK 0x8000u
+#define DNS_FLAGS_AUTHORITATIVE_MASK 0x0400u
 #define DNS_FLAGS_TRUNCATED_MASK 0x0200u
 
 typedef enum
@@ -58,6 +59,7 @@ typedef enum
 #define DNS_CLASS_IN 0x0001u
 #define DNS_CLASS_CLASS_MASK 0x7fffu
 #define DNS_CLASS_CACHE_FLUSH_MASK 0x8000u
+#define DNS_CLASS_UNICAST_RESPONSE_MASK 0x8000u
 
 #define DNS_NAME_POINTER_MASK 0xc0u
 
@@ -71,6 +73,12 @@ typedef struct DnsHeader
   uint16_t additional_count;
 } DnsHeader;
 
+typedef struct DnsQuestion
+{
+  const uint8_t*    name;
+  dns_record_type_t record_type;
+} DnsQuestion;
+
 typedef struct DnsResourceRecord
 {
   const uint8_t*    name;
@@ -111,8 +119,14 @@ bool           lwmdns_domain_name_matches_service_instance(const uint8_t* buf_be
                                                            const uint8_t* name_ptr,
                                                            const char*    service_instance_name);
 bool lwmdns_domain_name_matches_service_subtype(const uint8_t* buf_begin, const uint8_t* name_ptr, const char* subtype);
+bool lwmdns_domain_name_matches_service_type(const uint8_t* buf_begin, const uint8_t* name_ptr);
+bool lwmdns_domain_name_is_service_instance(const uint8_t* buf_begin, const uint8_t* name_ptr);
+bool lwmdns_domain_name_is_service_subtype(const uint8_t* buf_begin, const uint8_t* name_ptr);
+bool lwmdns_domain_name_is_rdmnet(const uint8_t* buf_begin, const uint8_t* name_ptr);
 bool lwmdns_domain_label_to_string(const uint8_t* buf_begin, const uint8_t* label, char* str_buf);
 
+uint8_t lwmdns_broker_host_name(const EtcPalUuid* cid, uint8_t* buf);
+
 txt_record_parse_result_t lwmdns_txt_record_to_broker_info(const uint8_t*    txt_data,
                                                            uint16_t          txt_data_len,
                                                            DiscoveredBroker* db);
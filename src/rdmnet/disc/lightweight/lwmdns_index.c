@@ -0,0 +1,164 @@
+/******************************************************************************
+ * Copyright 2020 ETC Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ ******************************************************************************
+ * This file is a part of RDMnet. For more information, go to:
+ * https://github.com/ETCLabs/RDMnet
+ *****************************************************************************/
+
+#include "lwmdns_index.h"
+
+#include <string.h>
+#include "rdmnet/core/opts.h"
+#include "rdmnet/core/util.h"
+#include "lwmdns_common.h"
+
+/******************************************************************************
+ * Private Macros
+ *****************************************************************************/
+
+#define BUCKET_FOR_HASH(hash) ((hash) & (LWMDNS_INDEX_NUM_BUCKETS - 1))
+
+/******************************************************************************
+ * Private Variables
+ *****************************************************************************/
+
+static DiscoveredBroker* host_buckets[LWMDNS_INDEX_NUM_BUCKETS];
+
+/******************************************************************************
+ * Private function prototypes
+ *****************************************************************************/
+
+static uint32_t hash_host_name(const uint8_t* host_name, uint8_t host_name_len);
+static void     unlink_broker(DiscoveredBroker** bucket, DiscoveredBroker* db);
+
+/******************************************************************************
+ * Function Definitions
+ *****************************************************************************/
+
+etcpal_error_t lwmdns_index_module_init(void)
+{
+  memset(host_buckets, 0, sizeof(host_buckets));
+  return kEtcPalErrOk;
+}
+
+void lwmdns_index_module_deinit(void)
+{
+  memset(host_buckets, 0, sizeof(host_buckets));
+}
+
+/* Index a broker by its host name, or re-index it after its host name has changed. */
+void lwmdns_index_update_host_name(DiscoveredBroker* db)
+{
+  if (!RDMNET_ASSERT_VERIFY(db))
+    return;
+
+  if (db->platform_data.host_name_indexed)
+  {
+    unlink_broker(&host_buckets[BUCKET_FOR_HASH(db->platform_data.host_name_hash)], db);
+    db->platform_data.host_name_indexed = false;
+  }
+
+  uint8_t host_name_len = lwmdns_domain_name_length(db->platform_data.wire_host_name, db->platform_data.wire_host_name);
+  if (host_name_len == 0)
+    return;
+
+  db->platform_data.host_name_hash = hash_host_name(db->platform_data.wire_host_name, host_name_len);
+  DiscoveredBroker** bucket = &host_buckets[BUCKET_FOR_HASH(db->platform_data.host_name_hash)];
+  db->platform_data.next_by_host = *bucket;
+  *bucket = db;
+  db->platform_data.host_name_indexed = true;
+}
+
+/* Remove a broker from the index. Brokers that were never indexed are ignored. */
+void lwmdns_index_remove_broker(DiscoveredBroker* db)
+{
+  if (!RDMNET_ASSERT_VERIFY(db))
+    return;
+
+  if (db->platform_data.host_name_indexed)
+  {
+    unlink_broker(&host_buckets[BUCKET_FOR_HASH(db->platform_data.host_name_hash)], db);
+    db->platform_data.host_name_indexed = false;
+  }
+}
+
+/*
+ * Find the broker whose service instance is named by name_ptr, which may be compressed within
+ * buf_begin. If monitor_ref is not NULL, only that monitor's brokers are considered. Brokers are
+ * looked up by name in their scope monitors' tables; the most recently discovered broker is returned
+ * if a monitor has more than one with the name.
+ */
+DiscoveredBroker* lwmdns_index_find_by_service_instance(const uint8_t*         buf_begin,
+                                                        const uint8_t*         name_ptr,
+                                                        RdmnetScopeMonitorRef* monitor_ref)
+{
+  if (!RDMNET_ASSERT_VERIFY(buf_begin) || !RDMNET_ASSERT_VERIFY(name_ptr))
+    return NULL;
+
+  char service_instance_name[E133_SERVICE_NAME_STRING_PADDED_LENGTH];
+  if (!lwmdns_domain_name_is_service_instance(buf_begin, name_ptr) ||
+      !lwmdns_domain_label_to_string(buf_begin, name_ptr, service_instance_name))
+  {
+    return NULL;
+  }
+
+  if (monitor_ref)
+    return discovered_broker_table_find_by_name(&monitor_ref->brokers, service_instance_name, NULL);
+  return scope_monitor_find_broker_by_name(service_instance_name);
+}
+
+/* Find the broker whose SRV record points to the host named by name_ptr. */
+DiscoveredBroker* lwmdns_index_find_by_host_name(const uint8_t* buf_begin, const uint8_t* name_ptr)
+{
+  if (!RDMNET_ASSERT_VERIFY(buf_begin) || !RDMNET_ASSERT_VERIFY(name_ptr))
+    return NULL;
+
+  uint8_t host_name[DNS_FQDN_MAX_LENGTH];
+  uint8_t host_name_len = lwmdns_copy_domain_name(buf_begin, name_ptr, host_name);
+  if (host_name_len == 0)
+    return NULL;
+
+  uint32_t hash = hash_host_name(host_name, host_name_len);
+  for (DiscoveredBroker* db = host_buckets[BUCKET_FOR_HASH(hash)]; db; db = db->platform_data.next_by_host)
+  {
+    if (db->platform_data.host_name_hash == hash &&
+        memcmp(db->platform_data.wire_host_name, host_name, host_name_len) == 0)
+    {
+      return db;
+    }
+  }
+  return NULL;
+}
+
+uint32_t hash_host_name(const uint8_t* host_name, uint8_t host_name_len)
+{
+  return rc_hash_bytes(host_name, host_name_len, RC_HASH_INIT);
+}
+
+void unlink_broker(DiscoveredBroker** bucket, DiscoveredBroker* db)
+{
+  if (!RDMNET_ASSERT_VERIFY(bucket) || !RDMNET_ASSERT_VERIFY(db))
+    return;
+
+  for (DiscoveredBroker** link = bucket; *link; link = &(*link)->platform_data.next_by_host)
+  {
+    if (*link == db)
+    {
+      *link = db->platform_data.next_by_host;
+      db->platform_data.next_by_host = NULL;
+      return;
+    }
+  }
+}
@@ -0,0 +1,58 @@
+/******************************************************************************
+ * Copyright 2020 ETC Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ ******************************************************************************
+ * This file is a part of RDMnet. For more information, go to:
+ * https://github.com/ETCLabs/RDMnet
+ *****************************************************************************/
+
+/*
+ * Lookups of the brokers discovered by all scope monitors, so that a received record can find its
+ * broker without comparing its name against every broker of every monitor. Service instance names
+ * are looked up in each monitor's DiscoveredBrokerTable, which is indexed by name. Host names have
+ * a hash index of their own here, spanning every monitor; brokers are linked into it through their
+ * platform data, so it needs no memory of its own.
+ */
+
+#ifndef LWMDNS_INDEX_H_
+#define LWMDNS_INDEX_H_
+
+#include <stdint.h>
+#include "etcpal/error.h"
+#include "rdmnet/disc/discovered_broker.h"
+#include "rdmnet/disc/monitored_scope.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// The number of hash buckets in the host name index. Must be a power of 2.
+#define LWMDNS_INDEX_NUM_BUCKETS 64
+
+etcpal_error_t lwmdns_index_module_init(void);
+void           lwmdns_index_module_deinit(void);
+
+void lwmdns_index_update_host_name(DiscoveredBroker* db);
+void lwmdns_index_remove_broker(DiscoveredBroker* db);
+
+DiscoveredBroker* lwmdns_index_find_by_service_instance(const uint8_t*         buf_begin,
+                                                        const uint8_t*         name_ptr,
+                                                        RdmnetScopeMonitorRef* monitor_ref);
+DiscoveredBroker* lwmdns_index_find_by_host_name(const uint8_t* buf_begin, const uint8_t* name_ptr);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* LWMDNS_INDEX_H_ */
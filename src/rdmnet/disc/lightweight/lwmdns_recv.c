@@ -19,6 +19,7 @@
 
 #include "lwmdns_recv.h"
 
+#include <string.h>
 #include "etcpal/common.h"
 #include "etcpal/inet.h"
 #include "etcpal/pack.h"
@@ -30,7 +31,11 @@
 #include "rdmnet/disc/common.h"
 #include "rdmnet/disc/monitored_scope.h"
 #include "rdmnet/disc/discovered_broker.h"
+#include "rdmnet/disc/registered_broker.h"
+#include "lwmdns_cache.h"
 #include "lwmdns_common.h"
+#include "lwmdns_index.h"
+#include "lwmdns_send.h"
 
 /******************************************************************************
  * Private Macros
@@ -39,6 +44,11 @@
 #define MDNS_IP_FOR_TYPE(ip_type) (type == kEtcPalIpTypeV6 ? kMdnsIpv6Address.ip : kMdnsIpv4Address.ip)
 #define DNS_TTL_TO_MS(ttl) (ttl * 1000)
 
+// RFC 6762 section 6: a record is multicast at most once per second, except in defense of a probe,
+// which is answered within 250 ms.
+#define MIN_RESPONSE_INTERVAL 1000
+#define PROBE_DEFENSE_INTERVAL 250
+
 /******************************************************************************
  * Private Types
  *****************************************************************************/
@@ -63,7 +73,15 @@ static MdnsRecvSocket recv_sock_ipv4;
 static MdnsRecvSocket recv_sock_ipv6;
 
 #define MDNS_RECV_BUF_SIZE 1400
-static uint8_t mdns_recv_buf[MDNS_RECV_BUF_SIZE];
+static uint8_t        mdns_recv_storage[RDMNET_MCAST_RECV_BATCH_SIZE * MDNS_RECV_BUF_SIZE];
+static RCMcastRecvMsg mdns_recv_msgs[RDMNET_MCAST_RECV_BATCH_SIZE];
+
+// The message currently being handled, which name compression pointers are relative to.
+static const uint8_t* mdns_recv_buf;
+
+// The question or resource record currently being matched against our registered brokers.
+static const DnsQuestion*       mdns_cur_question;
+static const DnsResourceRecord* mdns_cur_record;
 
 /******************************************************************************
  * Private function prototypes
@@ -83,23 +101,29 @@ static void           cleanup_recv_netints(MdnsRecvSocket* sock_struct, const Et
 
 // Incoming message handling
 static void           mdns_socket_activity(const EtcPalPollEvent* event, RCPolledSocketOpaqueData data);
-static void           handle_mdns_message(int message_size);
-static const uint8_t* bypass_mdns_query(const uint8_t* offset, int remaining_length);
-static const uint8_t* handle_resource_record(const uint8_t* offset, int remaining_length);
+static void           handle_mdns_messages(const RCMcastRecvMsg* msgs, size_t num_msgs);
+static bool           message_is_relevant(const uint8_t* message, int message_size);
+static void           handle_mdns_message(const uint8_t* message, int message_size);
+static const uint8_t* handle_question(const uint8_t* offset, int remaining_length, bool is_query);
+static const uint8_t* handle_resource_record(const uint8_t* offset,
+                                             int            remaining_length,
+                                             bool           is_query,
+                                             bool           in_authority_section);
 static void           handle_ptr_record(const DnsResourceRecord* rr);
 static void           handle_srv_record(const DnsResourceRecord* rr);
 static void           handle_address_record(const DnsResourceRecord* rr);
 static void           handle_txt_record(const DnsResourceRecord* rr);
 
+// Responder handling for our registered brokers
+static void answer_question(RdmnetBrokerRegisterRef* ref);
+static void check_probe_record(RdmnetBrokerRegisterRef* ref);
+static void check_for_name_conflict(RdmnetBrokerRegisterRef* ref);
+static void send_pending_response(RdmnetBrokerRegisterRef* ref);
+static bool question_matches_broker(const DnsQuestion* question, const RdmnetBrokerRegisterRef* ref);
+static int  compare_srv_record_to_broker(const DnsResourceRecord* rr, const RdmnetBrokerRegisterRef* ref);
+
 // Predicates for use with find functions
 static bool scope_monitor_matches_subtype(const RdmnetScopeMonitorRef* ref, const void* context);
-static bool db_matches_service_instance(const DiscoveredBroker* db, const void* context);
-static bool scope_and_db_matches_service_instance(const RdmnetScopeMonitorRef* ref,
-                                                  const DiscoveredBroker*      db,
-                                                  const void*                  context);
-static bool scope_and_db_matches_hostname(const RdmnetScopeMonitorRef* ref,
-                                          const DiscoveredBroker*      db,
-                                          const void*                  context);
 
 /******************************************************************************
  * Function Definitions
@@ -277,21 +301,109 @@ void mdns_socket_activity(const EtcPalPollEvent* event, RCPolledSocketOpaqueData
   }
   else if (event->events & ETCPAL_POLL_IN)
   {
-    EtcPalSockAddr from_addr;
-    int            recv_res = etcpal_recvfrom(event->socket, mdns_recv_buf, MDNS_RECV_BUF_SIZE, 0, &from_addr);
+    int recv_res = rc_mcast_recv_batch(event->socket, mdns_recv_storage, MDNS_RECV_BUF_SIZE, mdns_recv_msgs,
+                                       RDMNET_MCAST_RECV_BATCH_SIZE);
     if (recv_res > 0)
     {
-      handle_mdns_message(recv_res);
+      handle_mdns_messages(mdns_recv_msgs, (size_t)recv_res);
     }
     else if (recv_res < 0)
     {
-      RDMNET_LOG_ERR("Error occurred when receiving on mDNS receive socket: '%s'", etcpal_strerror(recv_res));
+      RDMNET_LOG_ERR("Error occurred when receiving on mDNS receive socket: '%s'",
+                     etcpal_strerror((etcpal_error_t)recv_res));
+    }
+  }
+}
+
+void handle_mdns_messages(const RCMcastRecvMsg* msgs, size_t num_msgs)
+{
+  if (!RDMNET_ASSERT_VERIFY(msgs))
+    return;
+
+  if (!RDMNET_ASSERT_VERIFY(num_msgs <= RDMNET_MCAST_RECV_BATCH_SIZE))
+    return;
+
+  // Most mDNS traffic on a busy network has nothing to do with RDMnet. It is filtered out here,
+  // before taking the lock.
+  bool   relevant[RDMNET_MCAST_RECV_BATCH_SIZE];
+  size_t num_relevant = 0;
+  for (size_t i = 0; i < num_msgs; ++i)
+  {
+    relevant[i] = (msgs[i].data_len > 0 && message_is_relevant(msgs[i].data, (int)msgs[i].data_len));
+    if (relevant[i])
+      ++num_relevant;
+  }
+  if (num_relevant == 0)
+    return;
+
+  // Take the discovery lock once for the whole batch.
+  if (RDMNET_DISC_LOCK())
+  {
+    for (size_t i = 0; i < num_msgs; ++i)
+    {
+      if (relevant[i])
+        handle_mdns_message(msgs[i].data, (int)msgs[i].data_len);
+    }
+    RDMNET_DISC_UNLOCK();
+  }
+}
+
+/*
+ * Whether a message might contain anything of interest, judged from the message alone: a question
+ * or record with an RDMnet name, or, in a response, an address record (whose host name could be
+ * anything). Parsing stops at the first malformed part, as it does when handling the message.
+ */
+bool message_is_relevant(const uint8_t* message, int message_size)
+{
+  if (!RDMNET_ASSERT_VERIFY(message))
+    return false;
+
+  DnsHeader      header;
+  const uint8_t* cur_ptr = lwmdns_parse_dns_header(message, message_size, &header);
+  if (!cur_ptr)
+    return false;
+
+  int remaining_message_size = message_size - (int)(cur_ptr - message);
+  for (uint16_t i = 0; i < header.query_count; ++i)
+  {
+    const uint8_t* next_ptr = lwmdns_parse_domain_name(message, cur_ptr, remaining_message_size);
+    if (!next_ptr || remaining_message_size - (int)(next_ptr - cur_ptr) < 4)
+      return false;
+    if (lwmdns_domain_name_is_rdmnet(message, cur_ptr))
+      return true;
+
+    remaining_message_size -= (int)(next_ptr - cur_ptr) + 4;
+    cur_ptr = next_ptr + 4;
+  }
+
+  for (uint16_t i = 0; i < (header.answer_count + header.authority_count + header.additional_count); ++i)
+  {
+    if (remaining_message_size <= 0)
+      break;
+
+    DnsResourceRecord rr;
+    const uint8_t*    next_ptr = lwmdns_parse_resource_record(message, cur_ptr, remaining_message_size, &rr);
+    if (!next_ptr)
+      break;
+    if (lwmdns_domain_name_is_rdmnet(message, rr.name) ||
+        (!header.query && (rr.record_type == kDnsRecordTypeA || rr.record_type == kDnsRecordTypeAAAA)))
+    {
+      return true;
     }
+
+    remaining_message_size -= (int)(next_ptr - cur_ptr);
+    cur_ptr = next_ptr;
   }
+  return false;
 }
 
-void handle_mdns_message(int message_size)
+void handle_mdns_message(const uint8_t* message, int message_size)
 {
+  if (!RDMNET_ASSERT_VERIFY(message))
+    return;
+
+  mdns_recv_buf = message;
+
   DnsHeader      header;
   const uint8_t* cur_ptr = lwmdns_parse_dns_header(mdns_recv_buf, message_size, &header);
   if (!cur_ptr)
@@ -303,7 +415,7 @@ void handle_mdns_message(int message_size)
     if (remaining_message_size <= 0)
       break;
 
-    const uint8_t* next_ptr = bypass_mdns_query(cur_ptr, remaining_message_size);
+    const uint8_t* next_ptr = handle_question(cur_ptr, remaining_message_size, header.query);
     if (next_ptr)
     {
       remaining_message_size -= (int)(next_ptr - cur_ptr);
@@ -315,29 +427,31 @@ void handle_mdns_message(int message_size)
     }
   }
 
-  if (RDMNET_DISC_LOCK())
+  for (uint16_t i = 0; i < (header.answer_count + header.authority_count + header.additional_count); ++i)
   {
-    for (uint16_t i = 0; i < (header.answer_count + header.authority_count + header.additional_count); ++i)
-    {
-      if (remaining_message_size <= 0)
-        break;
+    if (remaining_message_size <= 0)
+      break;
 
-      const uint8_t* next_ptr = handle_resource_record(cur_ptr, remaining_message_size);
-      if (next_ptr)
-      {
-        remaining_message_size -= (int)(next_ptr - cur_ptr);
-        cur_ptr = next_ptr;
-      }
-      else
-      {
-        break;
-      }
+    bool in_authority_section = (i >= header.answer_count && i < header.answer_count + header.authority_count);
+    const uint8_t* next_ptr =
+        handle_resource_record(cur_ptr, remaining_message_size, header.query, in_authority_section);
+    if (next_ptr)
+    {
+      remaining_message_size -= (int)(next_ptr - cur_ptr);
+      cur_ptr = next_ptr;
+    }
+    else
+    {
+      break;
     }
-    RDMNET_DISC_UNLOCK();
   }
+
+  // Answer any questions about our registered brokers once the whole query has been seen.
+  if (header.query)
+    registered_broker_for_each(send_pending_response);
 }
 
-const uint8_t* bypass_mdns_query(const uint8_t* offset, int remaining_length)
+const uint8_t* handle_question(const uint8_t* offset, int remaining_length, bool is_query)
 {
   if (!RDMNET_ASSERT_VERIFY(offset))
     return NULL;
@@ -347,14 +461,31 @@ const uint8_t* bypass_mdns_query(const uint8_t* offset, int remaining_length)
   {
     remaining_length -= (int)(cur_ptr - offset);
     if (remaining_length >= 4)
+    {
+      if (is_query)
+      {
+        DnsQuestion question;
+        question.name = offset;
+        question.record_type = (dns_record_type_t)etcpal_unpack_u16b(cur_ptr);
+
+        mdns_cur_question = &question;
+        registered_broker_for_each(answer_question);
+        mdns_cur_question = NULL;
+      }
       cur_ptr += 4;
+    }
     else
+    {
       cur_ptr = NULL;
+    }
   }
   return cur_ptr;
 }
 
-const uint8_t* handle_resource_record(const uint8_t* offset, int remaining_length)
+const uint8_t* handle_resource_record(const uint8_t* offset,
+                                      int            remaining_length,
+                                      bool           is_query,
+                                      bool           in_authority_section)
 {
   if (!RDMNET_ASSERT_VERIFY(offset))
     return NULL;
@@ -363,6 +494,9 @@ const uint8_t* handle_resource_record(const uint8_t* offset, int remaining_lengt
   const uint8_t*    next_ptr = lwmdns_parse_resource_record(mdns_recv_buf, offset, remaining_length, &rr);
   if (next_ptr)
   {
+    if (!is_query)
+      lwmdns_cache_add(mdns_recv_buf, &rr);
+
     switch (rr.record_type)
     {
       case kDnsRecordTypePTR:
@@ -381,10 +515,57 @@ const uint8_t* handle_resource_record(const uint8_t* offset, int remaining_lengt
       default:
         break;
     }
+
+    // The authority section of a query holds the records proposed by a host probing for a name.
+    // Records in a response may claim a name we are using.
+    mdns_cur_record = &rr;
+    if (!is_query)
+      registered_broker_for_each(check_for_name_conflict);
+    else if (in_authority_section)
+      registered_broker_for_each(check_probe_record);
+    mdns_cur_record = NULL;
   }
   return next_ptr;
 }
 
+/*
+ * Process a record from the cache as if it had just been received. This is used to answer new scope
+ * monitors from the cache, and to remove discovered brokers when their cached PTR records expire.
+ */
+void lwmdns_recv_handle_cached_record(const LwMdnsCacheEntry* entry)
+{
+  if (!RDMNET_ASSERT_VERIFY(entry))
+    return;
+
+  DnsResourceRecord rr;
+  lwmdns_cache_entry_to_rr(entry, &rr);
+
+  // Names in the cache are uncompressed, so the entry itself can stand in for the message buffer.
+  mdns_recv_buf = entry->name;
+  switch (rr.record_type)
+  {
+    case kDnsRecordTypePTR:
+      // A PTR record with a TTL of 0 removes the broker it points to.
+      handle_ptr_record(&rr);
+      break;
+    case kDnsRecordTypeSRV:
+      if (rr.ttl != 0)
+        handle_srv_record(&rr);
+      break;
+    case kDnsRecordTypeA:
+    case kDnsRecordTypeAAAA:
+      if (rr.ttl != 0)
+        handle_address_record(&rr);
+      break;
+    case kDnsRecordTypeTXT:
+      if (rr.ttl != 0)
+        handle_txt_record(&rr);
+      break;
+    default:
+      break;
+  }
+}
+
 void handle_ptr_record(const DnsResourceRecord* rr)
 {
   if (!RDMNET_ASSERT_VERIFY(rr))
@@ -395,7 +576,7 @@ void handle_ptr_record(const DnsResourceRecord* rr)
     RdmnetScopeMonitorRef* ref = scope_monitor_find(scope_monitor_matches_subtype, rr->name);
     if (ref)
     {
-      DiscoveredBroker* db = discovered_broker_find(ref->broker_list, db_matches_service_instance, rr->data_ptr);
+      DiscoveredBroker* db = lwmdns_index_find_by_service_instance(mdns_recv_buf, rr->data_ptr, ref);
       if (db && !db->platform_data.destruction_pending)
       {
         // Another PTR record received for a broker we already knew about.
@@ -415,9 +596,13 @@ void handle_ptr_record(const DnsResourceRecord* rr)
         db = discovered_broker_new(ref, "", "");
         if (db && lwmdns_domain_label_to_string(mdns_recv_buf, rr->data_ptr, db->service_instance_name))
         {
-          discovered_broker_insert(&ref->broker_list, db);
+          discovered_broker_table_insert(&ref->brokers, db);
           etcpal_timer_start(&db->platform_data.ttl_timer, DNS_TTL_TO_MS(rr->ttl));
         }
+        else if (db)
+        {
+          discovered_broker_delete(db);
+        }
       }
     }
   }
@@ -430,10 +615,8 @@ void handle_srv_record(const DnsResourceRecord* rr)
 
   if (rr->data_len > 7 && (lwmdns_parse_domain_name(mdns_recv_buf, &rr->data_ptr[6], rr->data_len - 6) != NULL))
   {
-    RdmnetScopeMonitorRef* ref = NULL;
-    DiscoveredBroker*      db = NULL;
-    if (scope_monitor_and_discovered_broker_find(scope_and_db_matches_service_instance, rr->name, &ref, &db) &&
-        RDMNET_ASSERT_VERIFY(db) && !db->platform_data.destruction_pending)
+    DiscoveredBroker* db = lwmdns_index_find_by_service_instance(mdns_recv_buf, rr->name, NULL);
+    if (db && !db->platform_data.destruction_pending)
     {
       // uint16_t priority = etcpal_unpack_u16b(rr->data_ptr);
       // uint16_t weight = etcpal_unpack_u16b(&rr->data_ptr[2]);
@@ -452,6 +635,7 @@ void handle_srv_record(const DnsResourceRecord* rr)
           }
           db->port = port;
           db->platform_data.srv_record_received = true;
+          lwmdns_index_update_host_name(db);
         }
       }
     }
@@ -466,10 +650,8 @@ void handle_address_record(const DnsResourceRecord* rr)
   if ((rr->record_type == kDnsRecordTypeA && rr->data_len == 4) ||
       (rr->record_type == kDnsRecordTypeAAAA && rr->data_len == 16))
   {
-    RdmnetScopeMonitorRef* ref = NULL;
-    DiscoveredBroker*      db = NULL;
-    if (scope_monitor_and_discovered_broker_find(scope_and_db_matches_hostname, rr->name, &ref, &db) &&
-        RDMNET_ASSERT_VERIFY(db) && !db->platform_data.destruction_pending)
+    DiscoveredBroker* db = lwmdns_index_find_by_host_name(mdns_recv_buf, rr->name);
+    if (db && !db->platform_data.destruction_pending)
     {
       if (rr->record_type == kDnsRecordTypeA)
       {
@@ -525,12 +707,11 @@ void handle_txt_record(const DnsResourceRecord* rr)
   if (!RDMNET_ASSERT_VERIFY(rr) || !RDMNET_ASSERT_VERIFY(rr->data_ptr))
     return;
 
-  RdmnetScopeMonitorRef* ref = NULL;
-  DiscoveredBroker*      db = NULL;
-  if (scope_monitor_and_discovered_broker_find(scope_and_db_matches_service_instance, rr->name, &ref, &db) &&
-      RDMNET_ASSERT_VERIFY(ref) && RDMNET_ASSERT_VERIFY(db) && !db->platform_data.destruction_pending)
+  DiscoveredBroker* db = lwmdns_index_find_by_service_instance(mdns_recv_buf, rr->name, NULL);
+  if (db && RDMNET_ASSERT_VERIFY(db->monitor_ref) && !db->platform_data.destruction_pending)
   {
-    txt_record_parse_result_t parse_result = lwmdns_txt_record_to_broker_info(rr->data_ptr, rr->data_len, db);
+    const RdmnetScopeMonitorRef* ref = db->monitor_ref;
+    txt_record_parse_result_t    parse_result = lwmdns_txt_record_to_broker_info(rr->data_ptr, rr->data_len, db);
     if (parse_result != kTxtRecordParseError)
     {
       if (strcmp(db->scope, ref->scope) != 0)
@@ -556,36 +737,140 @@ bool scope_monitor_matches_subtype(const RdmnetScopeMonitorRef* ref, const void*
   return lwmdns_domain_name_matches_service_subtype(mdns_recv_buf, name, ref->scope);
 }
 
-bool db_matches_service_instance(const DiscoveredBroker* db, const void* context)
+void answer_question(RdmnetBrokerRegisterRef* ref)
 {
-  if (!RDMNET_ASSERT_VERIFY(db) || !RDMNET_ASSERT_VERIFY(context))
-    return false;
+  if (!RDMNET_ASSERT_VERIFY(ref) || !RDMNET_ASSERT_VERIFY(mdns_cur_question))
+    return;
 
-  const uint8_t* name = (const uint8_t*)context;
-  return lwmdns_domain_name_matches_service_instance(mdns_recv_buf, name, db->service_instance_name);
+  // Our records aren't given out until the name has been successfully probed.
+  mdns_responder_state_t state = ref->platform_data.responder_state;
+  if (state != kMdnsResponderAnnouncing && state != kMdnsResponderRegistered)
+    return;
+
+  if (question_matches_broker(mdns_cur_question, ref))
+    ref->platform_data.response_pending = true;
 }
 
-bool scope_and_db_matches_service_instance(const RdmnetScopeMonitorRef* ref,
-                                           const DiscoveredBroker*      db,
-                                           const void*                  context)
+void check_probe_record(RdmnetBrokerRegisterRef* ref)
 {
-  ETCPAL_UNUSED_ARG(ref);
+  if (!RDMNET_ASSERT_VERIFY(ref) || !RDMNET_ASSERT_VERIFY(mdns_cur_record))
+    return;
 
-  if (!RDMNET_ASSERT_VERIFY(db) || !RDMNET_ASSERT_VERIFY(context))
-    return false;
+  const DnsResourceRecord* rr = mdns_cur_record;
+  if (rr->record_type != kDnsRecordTypeSRV ||
+      !lwmdns_domain_name_matches_service_instance(mdns_recv_buf, rr->name, ref->service_instance_name))
+  {
+    return;
+  }
 
-  const uint8_t* name = (const uint8_t*)context;
-  return lwmdns_domain_name_matches_service_instance(mdns_recv_buf, name, db->service_instance_name);
+  RdmnetBrokerRegisterPlatformData* platform_data = &ref->platform_data;
+  if (platform_data->responder_state == kMdnsResponderProbing)
+  {
+    // Simultaneous probe tie-breaking (RFC 6762 section 8.2): the host with the lexicographically
+    // later data wins. Identical data is our own probe, looped back.
+    if (compare_srv_record_to_broker(rr, ref) > 0)
+      platform_data->probe_deferred = true;
+  }
+  else if (platform_data->responder_state != kMdnsResponderIdle)
+  {
+    platform_data->answering_probe = true;
+  }
+}
+
+void check_for_name_conflict(RdmnetBrokerRegisterRef* ref)
+{
+  if (!RDMNET_ASSERT_VERIFY(ref) || !RDMNET_ASSERT_VERIFY(mdns_cur_record))
+    return;
+
+  const DnsResourceRecord* rr = mdns_cur_record;
+  if (ref->platform_data.responder_state == kMdnsResponderIdle || rr->record_type != kDnsRecordTypeSRV ||
+      rr->ttl == 0)
+  {
+    return;
+  }
+
+  if (lwmdns_domain_name_matches_service_instance(mdns_recv_buf, rr->name, ref->service_instance_name) &&
+      compare_srv_record_to_broker(rr, ref) != 0)
+  {
+    ref->platform_data.name_conflict = true;
+  }
 }
 
-bool scope_and_db_matches_hostname(const RdmnetScopeMonitorRef* ref, const DiscoveredBroker* db, const void* context)
+void send_pending_response(RdmnetBrokerRegisterRef* ref)
 {
-  ETCPAL_UNUSED_ARG(ref);
+  if (!RDMNET_ASSERT_VERIFY(ref))
+    return;
 
-  if (!RDMNET_ASSERT_VERIFY(db) || !RDMNET_ASSERT_VERIFY(context))
+  RdmnetBrokerRegisterPlatformData* platform_data = &ref->platform_data;
+  if (!platform_data->response_pending)
+    return;
+
+  uint32_t min_interval = (platform_data->answering_probe ? PROBE_DEFENSE_INTERVAL : MIN_RESPONSE_INTERVAL);
+  platform_data->response_pending = false;
+  platform_data->answering_probe = false;
+  if (etcpal_timer_elapsed(&platform_data->response_timer) >= min_interval)
+  {
+    lwmdns_send_broker_records(ref, false);
+    etcpal_timer_start(&platform_data->response_timer, 0);
+  }
+}
+
+bool question_matches_broker(const DnsQuestion* question, const RdmnetBrokerRegisterRef* ref)
+{
+  if (!RDMNET_ASSERT_VERIFY(question) || !RDMNET_ASSERT_VERIFY(ref))
     return false;
 
-  const uint8_t* name = (const uint8_t*)context;
-  return lwmdns_domain_names_equal(mdns_recv_buf, name, db->platform_data.wire_host_name,
-                                   db->platform_data.wire_host_name);
+  bool matches_instance =
+      lwmdns_domain_name_matches_service_instance(mdns_recv_buf, question->name, ref->service_instance_name);
+  bool matches_host = lwmdns_domain_names_equal(mdns_recv_buf, question->name, ref->platform_data.wire_host_name,
+                                                ref->platform_data.wire_host_name);
+
+  switch (question->record_type)
+  {
+    case kDnsRecordTypePTR:
+      return lwmdns_domain_name_matches_service_type(mdns_recv_buf, question->name) ||
+             lwmdns_domain_name_matches_service_subtype(mdns_recv_buf, question->name, ref->scope);
+    case kDnsRecordTypeSRV:
+    case kDnsRecordTypeTXT:
+      return matches_instance;
+    case kDnsRecordTypeA:
+    case kDnsRecordTypeAAAA:
+      return matches_host;
+    case kDnsRecordTypeANY:
+      return matches_instance || matches_host;
+    default:
+      return false;
+  }
+}
+
+/*
+ * Compare the data of a received SRV record to that of our own for a registered broker, in the
+ * manner of RFC 6762 section 8.2. Returns less than, equal to or greater than 0 if theirs is less
+ * than, equal to or greater than ours. Malformed records compare less than ours.
+ */
+int compare_srv_record_to_broker(const DnsResourceRecord* rr, const RdmnetBrokerRegisterRef* ref)
+{
+  if (!RDMNET_ASSERT_VERIFY(rr) || !RDMNET_ASSERT_VERIFY(ref))
+    return -1;
+
+  if (rr->data_len <= 7 || !rr->data_ptr ||
+      lwmdns_parse_domain_name(mdns_recv_buf, &rr->data_ptr[6], rr->data_len - 6) == NULL)
+  {
+    return -1;
+  }
+
+  // Priority and weight are always 0 in our record.
+  uint8_t our_fixed_data[6] = {0};
+  etcpal_pack_u16b(&our_fixed_data[4], ref->port);
+  int res = memcmp(rr->data_ptr, our_fixed_data, sizeof(our_fixed_data));
+  if (res != 0)
+    return res;
+
+  uint8_t their_host_name[DNS_FQDN_MAX_LENGTH];
+  uint8_t their_len = lwmdns_copy_domain_name(mdns_recv_buf, &rr->data_ptr[6], their_host_name);
+  uint8_t our_len = lwmdns_domain_name_length(ref->platform_data.wire_host_name, ref->platform_data.wire_host_name);
+  res = memcmp(their_host_name, ref->platform_data.wire_host_name, (their_len < our_len ? their_len : our_len));
+  if (res != 0)
+    return res;
+  return (int)their_len - (int)our_len;
 }
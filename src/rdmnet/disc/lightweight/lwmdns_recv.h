@@ -22,6 +22,7 @@
 
 #include "etcpal/error.h"
 #include "rdmnet/common.h"
+#include "lwmdns_cache.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -30,6 +31,8 @@ extern "C" {
 etcpal_error_t lwmdns_recv_module_init(const RdmnetNetintConfig* netint_config);
 void           lwmdns_recv_module_deinit(void);
 
+void lwmdns_recv_handle_cached_record(const LwMdnsCacheEntry* entry);
+
 #ifdef __cplusplus
 }
 #endif
@@ -19,12 +19,17 @@
 
 #include "lwmdns_send.h"
 
+#include <stdio.h>
 #include <string.h>
 #include "etcpal/inet.h"
 #include "etcpal/pack.h"
+#include "rdm/uid.h"
 #include "rdmnet/defs.h"
+#include "rdmnet/core/common.h"
 #include "rdmnet/core/mcast.h"
 #include "rdmnet/core/opts.h"
+#include "rdmnet/disc/common.h"
+#include "lwmdns_cache.h"
 #include "lwmdns_common.h"
 
 #if RDMNET_DYNAMIC_MEM
@@ -41,15 +46,12 @@
     etcpal_pack_u16b((ptr_offset), (uint16_t)(0xc000 | (offset - mdns_send_buf))); \
   }
 
-/******************************************************************************
- * Private Types
- *****************************************************************************/
+// TTLs recommended by RFC 6762 section 10 for records which contain a host name and for all others
+#define HOST_RECORD_TTL 120
+#define OTHER_RECORD_TTL 4500
 
-typedef struct SendSocket
-{
-  etcpal_socket_t     socket;
-  EtcPalMcastNetintId netint_id;
-} SendSocket;
+// Room left at the end of a response for the A or AAAA record of the interface it is sent on
+#define ADDRESS_RECORD_MAX_BYTES (2 + 10 + ETCPAL_IPV6_BYTES)
 
 /******************************************************************************
  * Private Variables
@@ -71,9 +73,9 @@ static const uint8_t kRdmnetServiceSuffixBytes[] = {
 // clang-format on
 
 #if RDMNET_DYNAMIC_MEM
-static SendSocket* send_sockets;
+static RCMcastSendNetint* send_sockets;
 #else
-static SendSocket send_sockets[RDMNET_MAX_MCAST_NETINTS];
+static RCMcastSendNetint send_sockets[RDMNET_MAX_MCAST_NETINTS];
 #endif
 static size_t num_send_sockets;
 
@@ -83,6 +85,23 @@ static size_t num_send_sockets;
 
 static void init_send_sockets_array(size_t array_size);
 static void send_buf(size_t data_size);
+static void send_buf_on_sockets(const RCMcastSendNetint* sockets, size_t num_sockets, size_t data_size);
+
+// Known-answer suppression for queries
+static void           send_query_with_known_answers(uint8_t* cur_ptr, uint8_t* question_offset);
+static bool           known_answer_matches_question(const LwMdnsCacheEntry* entry, const uint8_t* question_offset);
+static const uint8_t* find_service_suffix(const uint8_t* name, size_t name_len);
+
+// Resource record packing for the responder
+static uint8_t* pack_service_instance_name(uint8_t* cur_ptr, const RdmnetBrokerRegisterRef* ref);
+static uint8_t* pack_record_info(uint8_t* cur_ptr, dns_record_type_t record_type, uint16_t class_val, uint32_t ttl);
+static uint8_t* pack_srv_data(uint8_t* cur_ptr, const RdmnetBrokerRegisterRef* ref);
+static uint8_t* pack_txt_data(uint8_t* cur_ptr, const uint8_t* buf_end, const RdmnetBrokerRegisterRef* ref);
+static uint8_t* pack_txt_item(uint8_t*       cur_ptr,
+                              const uint8_t* buf_end,
+                              const char*    key,
+                              const uint8_t* value,
+                              size_t         value_len);
 
 /******************************************************************************
  * Function Definitions
@@ -93,7 +112,7 @@ etcpal_error_t lwmdns_send_module_init(const RdmnetNetintConfig* netint_config)
   if (netint_config && netint_config->netints && netint_config->num_netints > 0)
   {
 #if RDMNET_DYNAMIC_MEM
-    send_sockets = (SendSocket*)calloc(netint_config->num_netints, sizeof(SendSocket));
+    send_sockets = (RCMcastSendNetint*)calloc(netint_config->num_netints, sizeof(RCMcastSendNetint));
     if (!send_sockets)
       return kEtcPalErrNoMem;
     init_send_sockets_array(netint_config->num_netints);
@@ -105,9 +124,8 @@ etcpal_error_t lwmdns_send_module_init(const RdmnetNetintConfig* netint_config)
 
     for (size_t i = 0; i < netint_config->num_netints; ++i)
     {
-      send_sockets[i].netint_id = netint_config->netints[i];
-      etcpal_error_t res =
-          rc_mcast_get_send_socket(&send_sockets[i].netint_id, E133_MDNS_PORT, &send_sockets[i].socket);
+      send_sockets[i].id = netint_config->netints[i];
+      etcpal_error_t res = rc_mcast_get_send_socket(&send_sockets[i].id, E133_MDNS_PORT, &send_sockets[i].socket);
       if (res != kEtcPalErrOk)
       {
         lwmdns_send_module_deinit();
@@ -125,7 +143,7 @@ etcpal_error_t lwmdns_send_module_init(const RdmnetNetintConfig* netint_config)
       return kEtcPalErrSys;
 
 #if RDMNET_DYNAMIC_MEM
-    send_sockets = (SendSocket*)calloc(mcast_netint_arr_size, sizeof(SendSocket));
+    send_sockets = (RCMcastSendNetint*)calloc(mcast_netint_arr_size, sizeof(RCMcastSendNetint));
     if (!send_sockets)
       return kEtcPalErrNoMem;
     init_send_sockets_array(mcast_netint_arr_size);
@@ -135,9 +153,8 @@ etcpal_error_t lwmdns_send_module_init(const RdmnetNetintConfig* netint_config)
 
     for (size_t i = 0; i < mcast_netint_arr_size; ++i)
     {
-      send_sockets[i].netint_id = mcast_netint_arr[i];
-      etcpal_error_t res =
-          rc_mcast_get_send_socket(&send_sockets[i].netint_id, E133_MDNS_PORT, &send_sockets[i].socket);
+      send_sockets[i].id = mcast_netint_arr[i];
+      etcpal_error_t res = rc_mcast_get_send_socket(&send_sockets[i].id, E133_MDNS_PORT, &send_sockets[i].socket);
       if (res != kEtcPalErrOk)
       {
         lwmdns_send_module_deinit();
@@ -160,7 +177,7 @@ void lwmdns_send_module_deinit(void)
     {
       if (send_sockets[i].socket != ETCPAL_SOCKET_INVALID)
       {
-        rc_mcast_release_send_socket(&send_sockets[i].netint_id, E133_MDNS_PORT);
+        rc_mcast_release_send_socket(&send_sockets[i].id, E133_MDNS_PORT);
         send_sockets[i].socket = ETCPAL_SOCKET_INVALID;
       }
     }
@@ -193,7 +210,6 @@ void lwmdns_send_ptr_query(const RdmnetScopeMonitorRef* ref)
   memcpy(cur_ptr, kSubLabelBytes, sizeof(kSubLabelBytes));
   cur_ptr += sizeof(kSubLabelBytes);
 
-  uint8_t* service_offset = cur_ptr;
   memcpy(cur_ptr, kRdmnetServiceSuffixBytes, sizeof(kRdmnetServiceSuffixBytes));
   cur_ptr += sizeof(kRdmnetServiceSuffixBytes);
 
@@ -207,42 +223,7 @@ void lwmdns_send_ptr_query(const RdmnetScopeMonitorRef* ref)
   // Update the question count
   etcpal_pack_u16b(&mdns_send_buf[DNS_HEADER_OFFSET_QUESTION_COUNT], 1u);
 
-  uint8_t* answers_offset = cur_ptr;
-
-  uint16_t num_answers = 0;
-  for (DiscoveredBroker* db = ref->broker_list; db; db = db->next)
-  {
-    uint8_t name_size = (uint8_t)strlen(db->service_instance_name);
-    if (cur_ptr + name_size + 3 >= mdns_send_buf + MDNS_SEND_BUF_SIZE)
-    {
-      etcpal_pack_u16b(&mdns_send_buf[DNS_HEADER_OFFSET_ANSWER_COUNT], num_answers);
-      etcpal_pack_u16b(&mdns_send_buf[DNS_HEADER_OFFSET_FLAGS], DNS_FLAGS_TRUNCATED_MASK);
-      send_buf(cur_ptr - mdns_send_buf);
-      cur_ptr = answers_offset;
-      num_answers = 0;
-      etcpal_pack_u16b(&mdns_send_buf[DNS_HEADER_OFFSET_FLAGS], 0u);
-    }
-
-    PACK_POINTER_TO(service_sub_offset, cur_ptr);
-    cur_ptr += 2;
-    etcpal_pack_u16b(cur_ptr, kDnsRecordTypePTR);
-    cur_ptr += 2;
-    etcpal_pack_u16b(cur_ptr, DNS_CLASS_IN);
-    cur_ptr += 2;
-    etcpal_pack_u32b(cur_ptr, etcpal_timer_remaining(&db->platform_data.ttl_timer) / 1000);
-    cur_ptr += 4;
-    etcpal_pack_u16b(cur_ptr, name_size + 3);
-    cur_ptr += 2;
-    *cur_ptr++ = name_size;
-    memcpy(cur_ptr, db->service_instance_name, name_size);
-    cur_ptr += name_size;
-    PACK_POINTER_TO(service_offset, cur_ptr);
-    cur_ptr += 2;
-    ++num_answers;
-  }
-
-  etcpal_pack_u16b(&mdns_send_buf[DNS_HEADER_OFFSET_ANSWER_COUNT], num_answers);
-  send_buf(cur_ptr - mdns_send_buf);
+  send_query_with_known_answers(cur_ptr, service_sub_offset);
 }
 
 void lwmdns_send_any_query_on_service(const DiscoveredBroker* db)
@@ -256,7 +237,8 @@ void lwmdns_send_any_query_on_service(const DiscoveredBroker* db)
   cur_ptr += DNS_HEADER_BYTES;
 
   // Pack the ANY query
-  uint8_t service_instance_len = (uint8_t)strlen(db->service_instance_name);
+  uint8_t* question_offset = cur_ptr;
+  uint8_t  service_instance_len = (uint8_t)strlen(db->service_instance_name);
   *cur_ptr++ = service_instance_len;
   memcpy(cur_ptr, db->service_instance_name, service_instance_len);
   cur_ptr += service_instance_len;
@@ -274,9 +256,7 @@ void lwmdns_send_any_query_on_service(const DiscoveredBroker* db)
   // Update the question count
   etcpal_pack_u16b(&mdns_send_buf[DNS_HEADER_OFFSET_QUESTION_COUNT], 1u);
 
-  // TODO known answer suppression
-
-  send_buf(cur_ptr - mdns_send_buf);
+  send_query_with_known_answers(cur_ptr, question_offset);
 }
 
 void lwmdns_send_any_query_on_hostname(const DiscoveredBroker* db)
@@ -290,6 +270,7 @@ void lwmdns_send_any_query_on_hostname(const DiscoveredBroker* db)
   cur_ptr += DNS_HEADER_BYTES;
 
   // Pack the ANY query
+  uint8_t* question_offset = cur_ptr;
   lwmdns_copy_domain_name(db->platform_data.wire_host_name, db->platform_data.wire_host_name, cur_ptr);
   cur_ptr += lwmdns_domain_name_length(db->platform_data.wire_host_name, db->platform_data.wire_host_name);
 
@@ -303,14 +284,197 @@ void lwmdns_send_any_query_on_hostname(const DiscoveredBroker* db)
   // Update the question count
   etcpal_pack_u16b(&mdns_send_buf[DNS_HEADER_OFFSET_QUESTION_COUNT], 1u);
 
-  // TODO known answer suppression
+  send_query_with_known_answers(cur_ptr, question_offset);
+}
+
+/*
+ * Requery a cached record that is nearing expiry (RFC 6762 section 5.2). Any cached answers that
+ * are still fresh are included, so that only the hosts holding the record being requeried respond.
+ */
+void lwmdns_send_requery(const LwMdnsCacheEntry* entry)
+{
+  if (!RDMNET_ASSERT_VERIFY(entry))
+    return;
+
+  // Start with a zeroed header
+  uint8_t* cur_ptr = mdns_send_buf;
+  memset(cur_ptr, 0, DNS_HEADER_BYTES);
+  cur_ptr += DNS_HEADER_BYTES;
+
+  uint8_t* question_offset = cur_ptr;
+  uint8_t  name_len = lwmdns_domain_name_length(entry->name, entry->name);
+  if (name_len == 0)
+    return;
+  memcpy(cur_ptr, entry->name, name_len);
+  cur_ptr += name_len;
+
+  etcpal_pack_u16b(cur_ptr, (uint16_t)entry->record_type);
+  cur_ptr += 2;
+  etcpal_pack_u16b(cur_ptr, DNS_CLASS_IN);
+  cur_ptr += 2;
+  // Update the question count
+  etcpal_pack_u16b(&mdns_send_buf[DNS_HEADER_OFFSET_QUESTION_COUNT], 1u);
+
+  send_query_with_known_answers(cur_ptr, question_offset);
+}
+
+/*
+ * Send a probe for a locally-registered broker's service instance name (RFC 6762 section 8.1): an
+ * ANY question for the name, with the records we intend to use in the authority section so that
+ * simultaneous probes for the same name can be tie-broken.
+ */
+void lwmdns_send_probe(const RdmnetBrokerRegisterRef* ref)
+{
+  if (!RDMNET_ASSERT_VERIFY(ref))
+    return;
+
+  // Start with a zeroed header
+  uint8_t* cur_ptr = mdns_send_buf;
+  memset(cur_ptr, 0, DNS_HEADER_BYTES);
+  cur_ptr += DNS_HEADER_BYTES;
+
+  // Pack the ANY query, asking for unicast responses
+  uint8_t* instance_offset = cur_ptr;
+  cur_ptr = pack_service_instance_name(cur_ptr, ref);
+  etcpal_pack_u16b(cur_ptr, (uint16_t)kDnsRecordTypeANY);
+  cur_ptr += 2;
+  etcpal_pack_u16b(cur_ptr, DNS_CLASS_IN | DNS_CLASS_UNICAST_RESPONSE_MASK);
+  cur_ptr += 2;
+  etcpal_pack_u16b(&mdns_send_buf[DNS_HEADER_OFFSET_QUESTION_COUNT], 1u);
+
+  // Pack the proposed SRV and TXT records
+  PACK_POINTER_TO(instance_offset, cur_ptr);
+  cur_ptr += 2;
+  cur_ptr = pack_record_info(cur_ptr, kDnsRecordTypeSRV, DNS_CLASS_IN, HOST_RECORD_TTL);
+  cur_ptr = pack_srv_data(cur_ptr, ref);
+
+  PACK_POINTER_TO(instance_offset, cur_ptr);
+  cur_ptr += 2;
+  cur_ptr = pack_record_info(cur_ptr, kDnsRecordTypeTXT, DNS_CLASS_IN, OTHER_RECORD_TTL);
+  cur_ptr = pack_txt_data(cur_ptr, mdns_send_buf + MDNS_SEND_BUF_SIZE, ref);
+  if (!cur_ptr)
+  {
+    RDMNET_LOG_WARNING("TXT record for broker '%s' is too large to send.", ref->service_instance_name);
+    return;
+  }
+  etcpal_pack_u16b(&mdns_send_buf[DNS_HEADER_OFFSET_AUTHORITY_COUNT], 2u);
 
   send_buf(cur_ptr - mdns_send_buf);
 }
 
+/*
+ * Send all of a locally-registered broker's records in an unsolicited response. This is used both
+ * for announcements and to answer queries. Each interface's copy carries that interface's address
+ * in the additional section. If goodbye is true, the records are sent with a TTL of 0, which tells
+ * other hosts to remove them from their caches.
+ */
+void lwmdns_send_broker_records(const RdmnetBrokerRegisterRef* ref, bool goodbye)
+{
+  if (!RDMNET_ASSERT_VERIFY(ref))
+    return;
+
+  uint32_t host_ttl = (goodbye ? 0 : HOST_RECORD_TTL);
+  uint32_t other_ttl = (goodbye ? 0 : OTHER_RECORD_TTL);
+
+  uint8_t* cur_ptr = mdns_send_buf;
+  memset(cur_ptr, 0, DNS_HEADER_BYTES);
+  etcpal_pack_u16b(&mdns_send_buf[DNS_HEADER_OFFSET_FLAGS],
+                   DNS_FLAGS_REQUEST_RESPONSE_MASK | DNS_FLAGS_AUTHORITATIVE_MASK);
+  cur_ptr += DNS_HEADER_BYTES;
+
+  // _rdmnet._tcp.local PTR <instance>._rdmnet._tcp.local
+  uint8_t* service_offset = cur_ptr;
+  memcpy(cur_ptr, kRdmnetServiceSuffixBytes, sizeof(kRdmnetServiceSuffixBytes));
+  cur_ptr += sizeof(kRdmnetServiceSuffixBytes);
+  cur_ptr = pack_record_info(cur_ptr, kDnsRecordTypePTR, DNS_CLASS_IN, other_ttl);
+
+  uint8_t instance_len = (uint8_t)strlen(ref->service_instance_name);
+  etcpal_pack_u16b(cur_ptr, (uint16_t)(instance_len + 3));
+  cur_ptr += 2;
+  uint8_t* instance_offset = cur_ptr;
+  *cur_ptr++ = instance_len;
+  memcpy(cur_ptr, ref->service_instance_name, instance_len);
+  cur_ptr += instance_len;
+  PACK_POINTER_TO(service_offset, cur_ptr);
+  cur_ptr += 2;
+
+  // _<scope>._sub._rdmnet._tcp.local PTR <instance>._rdmnet._tcp.local
+  uint8_t scope_len = (uint8_t)strlen(ref->scope);
+  *cur_ptr++ = scope_len + 1;
+  *cur_ptr++ = (uint8_t)'_';
+  memcpy(cur_ptr, ref->scope, scope_len);
+  cur_ptr += scope_len;
+  memcpy(cur_ptr, kSubLabelBytes, sizeof(kSubLabelBytes));
+  cur_ptr += sizeof(kSubLabelBytes);
+  PACK_POINTER_TO(service_offset, cur_ptr);
+  cur_ptr += 2;
+  cur_ptr = pack_record_info(cur_ptr, kDnsRecordTypePTR, DNS_CLASS_IN, other_ttl);
+  etcpal_pack_u16b(cur_ptr, 2u);
+  cur_ptr += 2;
+  PACK_POINTER_TO(instance_offset, cur_ptr);
+  cur_ptr += 2;
+
+  // <instance>._rdmnet._tcp.local SRV, with the target host name following the length and the
+  // priority, weight and port fields
+  PACK_POINTER_TO(instance_offset, cur_ptr);
+  cur_ptr += 2;
+  cur_ptr = pack_record_info(cur_ptr, kDnsRecordTypeSRV, DNS_CLASS_IN | DNS_CLASS_CACHE_FLUSH_MASK, host_ttl);
+  uint8_t* host_offset = cur_ptr + 8;
+  cur_ptr = pack_srv_data(cur_ptr, ref);
+
+  // <instance>._rdmnet._tcp.local TXT
+  PACK_POINTER_TO(instance_offset, cur_ptr);
+  cur_ptr += 2;
+  cur_ptr = pack_record_info(cur_ptr, kDnsRecordTypeTXT, DNS_CLASS_IN | DNS_CLASS_CACHE_FLUSH_MASK, other_ttl);
+  cur_ptr = pack_txt_data(cur_ptr, mdns_send_buf + MDNS_SEND_BUF_SIZE - ADDRESS_RECORD_MAX_BYTES, ref);
+  if (!cur_ptr)
+  {
+    RDMNET_LOG_WARNING("TXT record for broker '%s' is too large to send.", ref->service_instance_name);
+    return;
+  }
+  etcpal_pack_u16b(&mdns_send_buf[DNS_HEADER_OFFSET_ANSWER_COUNT], 4u);
+
+  // The host's address record differs per interface, so it is re-packed for each one.
+  uint8_t* address_offset = cur_ptr;
+  for (RCMcastSendNetint* send_socket = send_sockets; send_socket < send_sockets + num_send_sockets; ++send_socket)
+  {
+    if (!RDMNET_ASSERT_VERIFY(send_socket))
+      return;
+
+    cur_ptr = address_offset;
+    uint16_t     num_additional = 0;
+    EtcPalIpAddr netint_addr;
+    if (rc_mcast_get_netint_addr(&send_socket->id, &netint_addr) && !ETCPAL_IP_IS_INVALID(&netint_addr))
+    {
+      PACK_POINTER_TO(host_offset, cur_ptr);
+      cur_ptr += 2;
+      if (ETCPAL_IP_IS_V4(&netint_addr))
+      {
+        cur_ptr = pack_record_info(cur_ptr, kDnsRecordTypeA, DNS_CLASS_IN | DNS_CLASS_CACHE_FLUSH_MASK, host_ttl);
+        etcpal_pack_u16b(cur_ptr, 4u);
+        cur_ptr += 2;
+        etcpal_pack_u32b(cur_ptr, ETCPAL_IP_V4_ADDRESS(&netint_addr));
+        cur_ptr += 4;
+      }
+      else
+      {
+        cur_ptr = pack_record_info(cur_ptr, kDnsRecordTypeAAAA, DNS_CLASS_IN | DNS_CLASS_CACHE_FLUSH_MASK, host_ttl);
+        etcpal_pack_u16b(cur_ptr, ETCPAL_IPV6_BYTES);
+        cur_ptr += 2;
+        memcpy(cur_ptr, ETCPAL_IP_V6_ADDRESS(&netint_addr), ETCPAL_IPV6_BYTES);
+        cur_ptr += ETCPAL_IPV6_BYTES;
+      }
+      num_additional = 1;
+    }
+    etcpal_pack_u16b(&mdns_send_buf[DNS_HEADER_OFFSET_ADDITIONAL_COUNT], num_additional);
+
+    send_buf_on_sockets(send_socket, 1, cur_ptr - mdns_send_buf);
+  }
+}
+
 static void init_send_sockets_array(size_t array_size)
 {
-  for (SendSocket* send_socket = send_sockets; send_socket < send_sockets + array_size; ++send_socket)
+  for (RCMcastSendNetint* send_socket = send_sockets; send_socket < send_sockets + array_size; ++send_socket)
   {
     if (!RDMNET_ASSERT_VERIFY(send_socket))
       return;
@@ -319,27 +483,259 @@ static void init_send_sockets_array(size_t array_size)
   }
 }
 
+// Queries and announcements are the same on every interface, so they are packed once and fanned
+// out to all of them together.
 static void send_buf(size_t data_size)
 {
-  if (!RDMNET_ASSERT_VERIFY(kMdnsIpv4Address) || !RDMNET_ASSERT_VERIFY(kMdnsIpv6Address))
+  send_buf_on_sockets(send_sockets, num_send_sockets, data_size);
+}
+
+static void send_buf_on_sockets(const RCMcastSendNetint* sockets, size_t num_sockets, size_t data_size)
+{
+  if (!RDMNET_ASSERT_VERIFY(sockets || num_sockets == 0) || !RDMNET_ASSERT_VERIFY(kMdnsIpv4Address) ||
+      !RDMNET_ASSERT_VERIFY(kMdnsIpv6Address))
+  {
+    return;
+  }
+
+  EtcPalSockAddr v4_addr;
+  v4_addr.ip = *kMdnsIpv4Address;
+  v4_addr.port = E133_MDNS_PORT;
+
+  EtcPalSockAddr v6_addr;
+  v6_addr.ip = *kMdnsIpv6Address;
+  v6_addr.port = E133_MDNS_PORT;
+
+  rc_mcast_send_to_netints(sockets, num_sockets, mdns_send_buf, data_size, &v4_addr, &v6_addr);
+}
+
+/*
+ * Add the cached records that answer the question at question_offset to the answer section (RFC
+ * 6762 section 7.1) and send the query, which ends at cur_ptr. Records are only offered while more
+ * than half of their TTL remains. If the known answers don't fit in one packet, the query is sent
+ * with the TC bit set and the remaining answers follow in another.
+ */
+static void send_query_with_known_answers(uint8_t* cur_ptr, uint8_t* question_offset)
+{
+  if (!RDMNET_ASSERT_VERIFY(cur_ptr) || !RDMNET_ASSERT_VERIFY(question_offset))
     return;
 
-  for (SendSocket* send_socket = send_sockets; send_socket < send_sockets + num_send_sockets; ++send_socket)
+  uint8_t*       answers_offset = cur_ptr;
+  size_t         question_name_len = lwmdns_domain_name_length(mdns_send_buf, question_offset);
+  const uint8_t* question_suffix = find_service_suffix(question_offset, question_name_len);
+
+  uint16_t num_answers = 0;
+  for (const LwMdnsCacheEntry* entry = lwmdns_cache_next(NULL); entry; entry = lwmdns_cache_next(entry))
   {
-    if (!RDMNET_ASSERT_VERIFY(send_socket))
-      return;
+    uint32_t remaining_ttl = lwmdns_cache_entry_remaining_ttl(entry);
+    if (!known_answer_matches_question(entry, question_offset) || remaining_ttl <= entry->ttl / 2)
+      continue;
+
+    // A PTR record's target shares the RDMnet service suffix with the question, if it has one.
+    uint16_t       data_len = entry->data_len;
+    const uint8_t* data_suffix = NULL;
+    if (entry->record_type == kDnsRecordTypePTR && question_suffix)
+    {
+      data_suffix = find_service_suffix(entry->data, entry->data_len);
+      if (data_suffix)
+        data_len = (uint16_t)(data_suffix - entry->data + 2);
+    }
 
-    EtcPalSockAddr send_addr;
-    send_addr.port = E133_MDNS_PORT;
-    if (send_socket->netint_id.ip_type == kEtcPalIpTypeV4)
+    if (cur_ptr + 12 + data_len >= mdns_send_buf + MDNS_SEND_BUF_SIZE)
     {
-      send_addr.ip = *kMdnsIpv4Address;
-      etcpal_sendto(send_socket->socket, mdns_send_buf, data_size, 0, &send_addr);
+      if (num_answers == 0)
+        continue;
+
+      etcpal_pack_u16b(&mdns_send_buf[DNS_HEADER_OFFSET_ANSWER_COUNT], num_answers);
+      etcpal_pack_u16b(&mdns_send_buf[DNS_HEADER_OFFSET_FLAGS], DNS_FLAGS_TRUNCATED_MASK);
+      send_buf(cur_ptr - mdns_send_buf);
+      cur_ptr = answers_offset;
+      num_answers = 0;
+      etcpal_pack_u16b(&mdns_send_buf[DNS_HEADER_OFFSET_FLAGS], 0u);
+    }
+
+    PACK_POINTER_TO(question_offset, cur_ptr);
+    cur_ptr += 2;
+    cur_ptr = pack_record_info(cur_ptr, entry->record_type, DNS_CLASS_IN, remaining_ttl);
+    etcpal_pack_u16b(cur_ptr, data_len);
+    cur_ptr += 2;
+    if (data_suffix)
+    {
+      memcpy(cur_ptr, entry->data, (size_t)(data_suffix - entry->data));
+      cur_ptr += data_suffix - entry->data;
+      PACK_POINTER_TO(question_suffix, cur_ptr);
+      cur_ptr += 2;
     }
     else
     {
-      send_addr.ip = *kMdnsIpv6Address;
-      etcpal_sendto(send_socket->socket, mdns_send_buf, data_size, 0, &send_addr);
+      memcpy(cur_ptr, entry->data, data_len);
+      cur_ptr += data_len;
     }
+    ++num_answers;
+  }
+
+  etcpal_pack_u16b(&mdns_send_buf[DNS_HEADER_OFFSET_ANSWER_COUNT], num_answers);
+  send_buf(cur_ptr - mdns_send_buf);
+}
+
+// An ANY question is answered by records of every type with its name.
+static bool known_answer_matches_question(const LwMdnsCacheEntry* entry, const uint8_t* question_offset)
+{
+  if (!RDMNET_ASSERT_VERIFY(entry) || !RDMNET_ASSERT_VERIFY(question_offset))
+    return false;
+
+  const uint8_t*    question_type_offset = question_offset + lwmdns_domain_name_length(mdns_send_buf, question_offset);
+  dns_record_type_t question_type = (dns_record_type_t)etcpal_unpack_u16b(question_type_offset);
+  if (question_type != kDnsRecordTypeANY && question_type != entry->record_type)
+    return false;
+
+  return lwmdns_domain_names_equal(mdns_send_buf, question_offset, entry->name, entry->name);
+}
+
+/*
+ * Find the _rdmnet._tcp.local labels at the end of an uncompressed name, for compression. Returns
+ * NULL if the name doesn't end with them.
+ */
+static const uint8_t* find_service_suffix(const uint8_t* name, size_t name_len)
+{
+  if (!RDMNET_ASSERT_VERIFY(name))
+    return NULL;
+
+  const uint8_t* label = name;
+  while (*label != 0 && (size_t)(name + name_len - label) > sizeof(kRdmnetServiceSuffixBytes))
+    label += *label + 1;
+
+  if ((size_t)(name + name_len - label) == sizeof(kRdmnetServiceSuffixBytes) &&
+      memcmp(label, kRdmnetServiceSuffixBytes, sizeof(kRdmnetServiceSuffixBytes)) == 0)
+  {
+    return label;
+  }
+  return NULL;
+}
+
+static uint8_t* pack_service_instance_name(uint8_t* cur_ptr, const RdmnetBrokerRegisterRef* ref)
+{
+  if (!RDMNET_ASSERT_VERIFY(cur_ptr) || !RDMNET_ASSERT_VERIFY(ref))
+    return cur_ptr;
+
+  uint8_t instance_len = (uint8_t)strlen(ref->service_instance_name);
+  *cur_ptr++ = instance_len;
+  memcpy(cur_ptr, ref->service_instance_name, instance_len);
+  cur_ptr += instance_len;
+  memcpy(cur_ptr, kRdmnetServiceSuffixBytes, sizeof(kRdmnetServiceSuffixBytes));
+  return cur_ptr + sizeof(kRdmnetServiceSuffixBytes);
+}
+
+// Pack the type, class and TTL of a resource record, which follow its name.
+static uint8_t* pack_record_info(uint8_t* cur_ptr, dns_record_type_t record_type, uint16_t class_val, uint32_t ttl)
+{
+  if (!RDMNET_ASSERT_VERIFY(cur_ptr))
+    return cur_ptr;
+
+  etcpal_pack_u16b(cur_ptr, (uint16_t)record_type);
+  cur_ptr += 2;
+  etcpal_pack_u16b(cur_ptr, class_val);
+  cur_ptr += 2;
+  etcpal_pack_u32b(cur_ptr, ttl);
+  return cur_ptr + 4;
+}
+
+// Pack the data length and data of a broker's SRV record.
+static uint8_t* pack_srv_data(uint8_t* cur_ptr, const RdmnetBrokerRegisterRef* ref)
+{
+  if (!RDMNET_ASSERT_VERIFY(cur_ptr) || !RDMNET_ASSERT_VERIFY(ref))
+    return cur_ptr;
+
+  uint8_t host_name_len =
+      lwmdns_domain_name_length(ref->platform_data.wire_host_name, ref->platform_data.wire_host_name);
+  etcpal_pack_u16b(cur_ptr, (uint16_t)(6 + host_name_len));
+  cur_ptr += 2;
+  etcpal_pack_u16b(cur_ptr, 0u);  // Priority
+  cur_ptr += 2;
+  etcpal_pack_u16b(cur_ptr, 0u);  // Weight
+  cur_ptr += 2;
+  etcpal_pack_u16b(cur_ptr, ref->port);
+  cur_ptr += 2;
+  memcpy(cur_ptr, ref->platform_data.wire_host_name, host_name_len);
+  return cur_ptr + host_name_len;
+}
+
+/*
+ * Pack the data length and data of a broker's TXT record, with the same items as the other
+ * discovery backends register. Returns NULL if the record would extend past buf_end.
+ */
+static uint8_t* pack_txt_data(uint8_t* cur_ptr, const uint8_t* buf_end, const RdmnetBrokerRegisterRef* ref)
+{
+  if (!RDMNET_ASSERT_VERIFY(cur_ptr) || !RDMNET_ASSERT_VERIFY(buf_end) || !RDMNET_ASSERT_VERIFY(ref))
+    return NULL;
+
+  uint8_t* len_offset = cur_ptr;
+  cur_ptr += 2;
+
+  char int_conversion[16];
+  snprintf(int_conversion, 16, "%d", E133_DNSSD_TXTVERS);
+  cur_ptr = pack_txt_item(cur_ptr, buf_end, E133_TXT_VERS_KEY, (const uint8_t*)int_conversion, strlen(int_conversion));
+  cur_ptr = pack_txt_item(cur_ptr, buf_end, E133_TXT_SCOPE_KEY, (const uint8_t*)ref->scope, strlen(ref->scope));
+  snprintf(int_conversion, 16, "%d", E133_DNSSD_E133VERS);
+  cur_ptr =
+      pack_txt_item(cur_ptr, buf_end, E133_TXT_E133VERS_KEY, (const uint8_t*)int_conversion, strlen(int_conversion));
+
+  // Strip hyphens from the CID string and colons from the UID string to conform to E1.33 TXT
+  // record rules
+  char cid_str[ETCPAL_UUID_STRING_BYTES];
+  etcpal_uuid_to_string(&ref->cid, cid_str);
+  size_t stripped_len = 0;
+  for (size_t i = 0; cid_str[i] != '\0'; ++i)
+  {
+    if (cid_str[i] != '-')
+      cid_str[stripped_len++] = cid_str[i];
+  }
+  cur_ptr = pack_txt_item(cur_ptr, buf_end, E133_TXT_CID_KEY, (const uint8_t*)cid_str, stripped_len);
+
+  char uid_str[RDM_UID_STRING_BYTES];
+  rdm_uid_to_string(&ref->uid, uid_str);
+  stripped_len = 0;
+  for (size_t i = 0; uid_str[i] != '\0'; ++i)
+  {
+    if (uid_str[i] != ':')
+      uid_str[stripped_len++] = uid_str[i];
+  }
+  cur_ptr = pack_txt_item(cur_ptr, buf_end, E133_TXT_UID_KEY, (const uint8_t*)uid_str, stripped_len);
+
+  cur_ptr = pack_txt_item(cur_ptr, buf_end, E133_TXT_MODEL_KEY, (const uint8_t*)ref->model, strlen(ref->model));
+  cur_ptr = pack_txt_item(cur_ptr, buf_end, E133_TXT_MANUFACTURER_KEY, (const uint8_t*)ref->manufacturer,
+                          strlen(ref->manufacturer));
+
+  for (const DnsTxtRecordItemInternal* item = ref->additional_txt_items;
+       item < ref->additional_txt_items + ref->num_additional_txt_items; ++item)
+  {
+    cur_ptr = pack_txt_item(cur_ptr, buf_end, item->key, item->value, item->value_len);
   }
+
+  if (cur_ptr)
+    etcpal_pack_u16b(len_offset, (uint16_t)(cur_ptr - len_offset - 2));
+  return cur_ptr;
+}
+
+// Pack a key=value TXT record item. Returns NULL if cur_ptr is NULL or the item doesn't fit.
+static uint8_t* pack_txt_item(uint8_t*       cur_ptr,
+                              const uint8_t* buf_end,
+                              const char*    key,
+                              const uint8_t* value,
+                              size_t         value_len)
+{
+  if (!cur_ptr || !RDMNET_ASSERT_VERIFY(key) || !RDMNET_ASSERT_VERIFY(value))
+    return NULL;
+
+  size_t key_len = strlen(key);
+  size_t item_len = key_len + 1 + value_len;
+  if (item_len > 255 || cur_ptr + 1 + item_len > buf_end)
+    return NULL;
+
+  *cur_ptr++ = (uint8_t)item_len;
+  memcpy(cur_ptr, key, key_len);
+  cur_ptr += key_len;
+  *cur_ptr++ = (uint8_t)'=';
+  memcpy(cur_ptr, value, value_len);
+  return cur_ptr + value_len;
 }
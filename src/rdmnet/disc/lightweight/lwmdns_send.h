@@ -23,6 +23,8 @@
 #include "etcpal/error.h"
 #include "rdmnet/common.h"
 #include "rdmnet/disc/monitored_scope.h"
+#include "rdmnet/disc/registered_broker.h"
+#include "lwmdns_cache.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -34,6 +36,10 @@ void           lwmdns_send_module_deinit(void);
 void lwmdns_send_ptr_query(const RdmnetScopeMonitorRef* ref);
 void lwmdns_send_any_query_on_service(const DiscoveredBroker* db);
 void lwmdns_send_any_query_on_hostname(const DiscoveredBroker* db);
+void lwmdns_send_requery(const LwMdnsCacheEntry* entry);
+
+void lwmdns_send_probe(const RdmnetBrokerRegisterRef* ref);
+void lwmdns_send_broker_records(const RdmnetBrokerRegisterRef* ref, bool goodbye);
 
 #ifdef __cplusplus
 }
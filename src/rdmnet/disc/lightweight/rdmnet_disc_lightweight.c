@@ -17,13 +17,19 @@
  * https://github.com/ETCLabs/RDMnet
  *****************************************************************************/
 
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
 #include "etcpal/common.h"
+#include "rdmnet/core/common.h"
 #include "rdmnet/disc/common.h"
 #include "rdmnet/disc/platform_api.h"
 #include "rdmnet/disc/discovered_broker.h"
 #include "rdmnet/disc/registered_broker.h"
 #include "rdmnet/disc/monitored_scope.h"
+#include "lwmdns_cache.h"
 #include "lwmdns_common.h"
+#include "lwmdns_index.h"
 #include "lwmdns_send.h"
 #include "lwmdns_recv.h"
 
@@ -34,11 +40,33 @@
 #define INITIAL_QUERY_INTERVAL 1000
 #define QUERY_BACKOFF_FACTOR 3
 
+// Responder timing, from RFC 6762 section 8
+#define NUM_PROBES 3
+#define PROBE_INTERVAL 250
+#define PROBE_DEFER_INTERVAL 1000
+#define NUM_ANNOUNCEMENTS 2
+#define ANNOUNCE_INTERVAL 1000
+
+/******************************************************************************
+ * Private Variables
+ *****************************************************************************/
+
+// Set while ticking if any scope is being monitored, in which case cached records are requeried.
+static bool scope_monitors_active;
+
 /******************************************************************************
  * Private function prototypes
  *****************************************************************************/
 
 static void update_query_interval(EtcPalTimer* query_timer);
+static void replay_cached_records(bool ptr_records);
+static void note_scope_monitor(RdmnetScopeMonitorRef* monitor_ref);
+static bool broker_destruction_pending(const DiscoveredBroker* db, const void* context);
+static void remove_lost_broker(DiscoveredBroker* db, const void* context);
+static void process_registered_broker(RdmnetBrokerRegisterRef* broker_ref);
+static void start_probing(RdmnetBrokerRegisterRef* broker_ref, uint32_t delay);
+static void announce(RdmnetBrokerRegisterRef* broker_ref);
+static void rename_service_instance(RdmnetBrokerRegisterRef* broker_ref);
 
 /******************************************************************************
  * Function Definitions
@@ -50,9 +78,26 @@ etcpal_error_t rdmnet_disc_platform_init(const RdmnetNetintConfig* netint_config
   if (res != kEtcPalErrOk)
     return res;
 
+  res = lwmdns_cache_module_init();
+  if (res != kEtcPalErrOk)
+  {
+    lwmdns_common_module_deinit();
+    return res;
+  }
+
+  res = lwmdns_index_module_init();
+  if (res != kEtcPalErrOk)
+  {
+    lwmdns_cache_module_deinit();
+    lwmdns_common_module_deinit();
+    return res;
+  }
+
   res = lwmdns_recv_module_init(netint_config);
   if (res != kEtcPalErrOk)
   {
+    lwmdns_index_module_deinit();
+    lwmdns_cache_module_deinit();
     lwmdns_common_module_deinit();
     return res;
   }
@@ -61,6 +106,8 @@ etcpal_error_t rdmnet_disc_platform_init(const RdmnetNetintConfig* netint_config
   if (res != kEtcPalErrOk)
   {
     lwmdns_recv_module_deinit();
+    lwmdns_index_module_deinit();
+    lwmdns_cache_module_deinit();
     lwmdns_common_module_deinit();
   }
   return res;
@@ -70,6 +117,8 @@ void rdmnet_disc_platform_deinit(void)
 {
   lwmdns_send_module_deinit();
   lwmdns_recv_module_deinit();
+  lwmdns_index_module_deinit();
+  lwmdns_cache_module_deinit();
   lwmdns_common_module_deinit();
 }
 
@@ -93,19 +142,39 @@ void rdmnet_disc_platform_stop_monitoring(RdmnetScopeMonitorRef* handle)
 
 void rdmnet_disc_platform_unregister_broker(rdmnet_registered_broker_t handle)
 {
-  ETCPAL_UNUSED_ARG(handle);
+  if (!RDMNET_ASSERT_VERIFY(handle))
+    return;
+
+  // Records that other hosts may have cached are withdrawn with a goodbye.
+  RdmnetBrokerRegisterPlatformData* platform_data = &handle->platform_data;
+  if (platform_data->responder_state == kMdnsResponderAnnouncing ||
+      platform_data->responder_state == kMdnsResponderRegistered)
+  {
+    lwmdns_send_broker_records(handle, true);
+  }
+  platform_data->responder_state = kMdnsResponderIdle;
 }
 
 void discovered_broker_free_platform_resources(DiscoveredBroker* db)
 {
-  ETCPAL_UNUSED_ARG(db);
+  lwmdns_index_remove_broker(db);
 }
 
+/*
+ * The common discovery code has already waited out its conflicting broker query and random backoff,
+ * so the first probe goes out immediately. The broker_registered() callback is called once probing
+ * has completed without conflict.
+ */
 etcpal_error_t rdmnet_disc_platform_register_broker(RdmnetBrokerRegisterRef* broker_ref, int* platform_specific_error)
 {
-  ETCPAL_UNUSED_ARG(broker_ref);
   ETCPAL_UNUSED_ARG(platform_specific_error);
-  return kEtcPalErrNotImpl;
+
+  if (!RDMNET_ASSERT_VERIFY(broker_ref))
+    return kEtcPalErrSys;
+
+  lwmdns_broker_host_name(&broker_ref->cid, broker_ref->platform_data.wire_host_name);
+  start_probing(broker_ref, 0);
+  return kEtcPalErrOk;
 }
 
 void process_monitored_scope(RdmnetScopeMonitorRef* monitor_ref)
@@ -113,23 +182,26 @@ void process_monitored_scope(RdmnetScopeMonitorRef* monitor_ref)
   if (!RDMNET_ASSERT_VERIFY(monitor_ref))
     return;
 
+  // Brokers already in the cache are found without waiting on the network. This waits for the first
+  // tick, as the monitor isn't in the list the cached records are matched against until it has
+  // started. The PTR records create the discovered brokers that the other records fill in.
+  if (!monitor_ref->platform_data.cache_replayed)
+  {
+    replay_cached_records(true);
+    replay_cached_records(false);
+    monitor_ref->platform_data.cache_replayed = true;
+  }
+
   if (etcpal_timer_is_expired(&monitor_ref->platform_data.query_timer))
   {
     lwmdns_send_ptr_query(monitor_ref);
     update_query_interval(&monitor_ref->platform_data.query_timer);
   }
 
-  for (DiscoveredBroker* db = monitor_ref->broker_list; db; db = db->next)
+  discovered_broker_table_remove_if(&monitor_ref->brokers, broker_destruction_pending, remove_lost_broker, NULL);
+
+  for (DiscoveredBroker* db = monitor_ref->brokers.head; db; db = db->next)
   {
-    if (db->platform_data.destruction_pending)
-    {
-      // TODO more elegant deletion
-      if (db->platform_data.initial_notification_sent)
-        notify_broker_lost(monitor_ref, db->service_instance_name, &db->cid);
-      discovered_broker_remove(&monitor_ref->broker_list, db);
-      discovered_broker_delete(db);
-      break;
-    }
     if (!db->platform_data.initial_notification_sent)
     {
       if ((!db->platform_data.srv_record_received || !db->platform_data.txt_record_received))
@@ -183,8 +255,6 @@ void process_monitored_scope(RdmnetScopeMonitorRef* monitor_ref)
       notify_broker_updated(monitor_ref, &info);
       db->platform_data.update_pending = false;
     }
-
-    // TODO requery TTL
   }
 }
 
@@ -192,11 +262,56 @@ void rdmnet_disc_platform_tick(void)
 {
   if (RDMNET_DISC_LOCK())
   {
+    scope_monitors_active = false;
+    scope_monitor_for_each(note_scope_monitor);
+
+    // Records are requeried before they expire only while there is someone to tell about them.
+    // Expired PTR records mark their discovered brokers for removal.
+    lwmdns_cache_process(scope_monitors_active ? lwmdns_send_requery : NULL, lwmdns_recv_handle_cached_record);
+
     scope_monitor_for_each(process_monitored_scope);
+    registered_broker_for_each(process_registered_broker);
     RDMNET_DISC_UNLOCK();
   }
 }
 
+void replay_cached_records(bool ptr_records)
+{
+  for (const LwMdnsCacheEntry* entry = lwmdns_cache_next(NULL); entry; entry = lwmdns_cache_next(entry))
+  {
+    if ((entry->record_type == kDnsRecordTypePTR) == ptr_records)
+      lwmdns_recv_handle_cached_record(entry);
+  }
+}
+
+void note_scope_monitor(RdmnetScopeMonitorRef* monitor_ref)
+{
+  ETCPAL_UNUSED_ARG(monitor_ref);
+  scope_monitors_active = true;
+}
+
+bool broker_destruction_pending(const DiscoveredBroker* db, const void* context)
+{
+  ETCPAL_UNUSED_ARG(context);
+
+  if (!RDMNET_ASSERT_VERIFY(db))
+    return false;
+
+  return db->platform_data.destruction_pending;
+}
+
+void remove_lost_broker(DiscoveredBroker* db, const void* context)
+{
+  ETCPAL_UNUSED_ARG(context);
+
+  if (!RDMNET_ASSERT_VERIFY(db))
+    return;
+
+  if (db->platform_data.initial_notification_sent)
+    notify_broker_lost(db->monitor_ref, db->service_instance_name, &db->cid);
+  discovered_broker_delete(db);
+}
+
 void update_query_interval(EtcPalTimer* query_timer)
 {
   if (!RDMNET_ASSERT_VERIFY(query_timer))
@@ -207,3 +322,119 @@ void update_query_interval(EtcPalTimer* query_timer)
     new_interval = 360000;
   etcpal_timer_start(query_timer, new_interval);
 }
+
+void process_registered_broker(RdmnetBrokerRegisterRef* broker_ref)
+{
+  if (!RDMNET_ASSERT_VERIFY(broker_ref))
+    return;
+
+  RdmnetBrokerRegisterPlatformData* platform_data = &broker_ref->platform_data;
+  if (platform_data->responder_state == kMdnsResponderIdle)
+    return;
+
+  if (platform_data->name_conflict)
+  {
+    RDMNET_LOG_INFO("Service instance name '%s' is in use by another host; choosing a new one.",
+                    broker_ref->service_instance_name);
+    rename_service_instance(broker_ref);
+    start_probing(broker_ref, 0);
+  }
+  else if (platform_data->probe_deferred)
+  {
+    start_probing(broker_ref, PROBE_DEFER_INTERVAL);
+  }
+
+  if (!etcpal_timer_is_expired(&platform_data->send_timer))
+    return;
+
+  switch (platform_data->responder_state)
+  {
+    case kMdnsResponderProbing:
+      if (platform_data->num_sent < NUM_PROBES)
+      {
+        lwmdns_send_probe(broker_ref);
+        ++platform_data->num_sent;
+        etcpal_timer_start(&platform_data->send_timer, PROBE_INTERVAL);
+      }
+      else
+      {
+        // No other host has claimed the name.
+        platform_data->responder_state = kMdnsResponderAnnouncing;
+        platform_data->num_sent = 0;
+        announce(broker_ref);
+        if (broker_ref->callbacks.broker_registered)
+        {
+          broker_ref->callbacks.broker_registered(broker_ref, broker_ref->service_instance_name,
+                                                  broker_ref->callbacks.context);
+        }
+      }
+      break;
+    case kMdnsResponderAnnouncing:
+      announce(broker_ref);
+      break;
+    default:
+      break;
+  }
+}
+
+void start_probing(RdmnetBrokerRegisterRef* broker_ref, uint32_t delay)
+{
+  if (!RDMNET_ASSERT_VERIFY(broker_ref))
+    return;
+
+  RdmnetBrokerRegisterPlatformData* platform_data = &broker_ref->platform_data;
+  platform_data->responder_state = kMdnsResponderProbing;
+  platform_data->num_sent = 0;
+  platform_data->name_conflict = false;
+  platform_data->probe_deferred = false;
+  platform_data->response_pending = false;
+  platform_data->answering_probe = false;
+  etcpal_timer_start(&platform_data->send_timer, delay);
+}
+
+void announce(RdmnetBrokerRegisterRef* broker_ref)
+{
+  if (!RDMNET_ASSERT_VERIFY(broker_ref))
+    return;
+
+  RdmnetBrokerRegisterPlatformData* platform_data = &broker_ref->platform_data;
+  lwmdns_send_broker_records(broker_ref, false);
+  etcpal_timer_start(&platform_data->response_timer, 0);
+  if (++platform_data->num_sent < NUM_ANNOUNCEMENTS)
+    etcpal_timer_start(&platform_data->send_timer, ANNOUNCE_INTERVAL);
+  else
+    platform_data->responder_state = kMdnsResponderRegistered;
+}
+
+/*
+ * Choose a new service instance name after a conflict: "Name" becomes "Name (2)", "Name (2)"
+ * becomes "Name (3)" and so on, truncating the name if needed to fit in a DNS label.
+ */
+void rename_service_instance(RdmnetBrokerRegisterRef* broker_ref)
+{
+  if (!RDMNET_ASSERT_VERIFY(broker_ref))
+    return;
+
+  char*        name = broker_ref->service_instance_name;
+  size_t       base_len = strlen(name);
+  unsigned int suffix_num = 2;
+
+  // Look for an existing " (n)" suffix
+  if (base_len >= 4 && name[base_len - 1] == ')')
+  {
+    size_t open_paren = base_len - 2;
+    while (open_paren > 0 && name[open_paren] >= '0' && name[open_paren] <= '9')
+      --open_paren;
+    if (open_paren >= 1 && open_paren < base_len - 2 && name[open_paren] == '(' && name[open_paren - 1] == ' ')
+    {
+      suffix_num = (unsigned int)strtoul(&name[open_paren + 1], NULL, 10) + 1;
+      base_len = open_paren - 1;
+    }
+  }
+
+  char   suffix[16];
+  size_t suffix_len = (size_t)snprintf(suffix, sizeof(suffix), " (%u)", suffix_num);
+  if (base_len > E133_SERVICE_NAME_STRING_PADDED_LENGTH - 1 - suffix_len)
+    base_len = E133_SERVICE_NAME_STRING_PADDED_LENGTH - 1 - suffix_len;
+  memcpy(&name[base_len], suffix, suffix_len + 1);
+}
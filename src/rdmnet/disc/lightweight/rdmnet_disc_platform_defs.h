@@ -17,7 +17,7 @@
  * https://github.com/ETCLabs/RDMnet
  *****************************************************************************/
 
-/* The disc_platform_defs.h specialization for the lightweight mDNS querier. */
+/* The disc_platform_defs.h specialization for the lightweight mDNS querier and responder. */
 
 #ifndef DISC_PLATFORM_DEFS_H_
 #define DISC_PLATFORM_DEFS_H_
@@ -41,17 +41,46 @@ typedef struct RdmnetDiscoveredBrokerPlatformData
   bool        sent_host_query;
   EtcPalTimer query_timer;
   EtcPalTimer ttl_timer;
+
+  // Link in the host name index of the lwmdns_index module
+  struct DiscoveredBroker* next_by_host;
+  bool                     host_name_indexed;
+  uint32_t                 host_name_hash;
 } RdmnetDiscoveredBrokerPlatformData;
 
 typedef struct RdmnetScopeMonitorPlatformData
 {
   bool        sent_first_query;
   EtcPalTimer query_timer;
+  // Brokers already in the mDNS cache have been found for this scope.
+  bool cache_replayed;
 } RdmnetScopeMonitorPlatformData;
 
+typedef enum
+{
+  kMdnsResponderIdle,
+  kMdnsResponderProbing,
+  kMdnsResponderAnnouncing,
+  kMdnsResponderRegistered
+} mdns_responder_state_t;
+
 typedef struct RdmnetBrokerRegisterPlatformData
 {
-  int placeholder;
+  mdns_responder_state_t responder_state;
+  // The number of probes or announcements sent in the current state
+  uint8_t     num_sent;
+  EtcPalTimer send_timer;
+  // Another host is using our service instance name; pick a new one and probe again.
+  bool name_conflict;
+  // Another host probing for our name at the same time won the tie-break; probe again later.
+  bool probe_deferred;
+
+  // Answers to queries for our records are rate-limited per RFC 6762 section 6.
+  bool        response_pending;
+  bool        answering_probe;
+  EtcPalTimer response_timer;
+
+  uint8_t wire_host_name[DNS_FQDN_MAX_LENGTH];
 } RdmnetBrokerRegisterPlatformData;
 
 #endif /* DISC_PLATFORM_DEFS_H_ */
@@ -95,7 +95,7 @@ RdmnetScopeMonitorRef* scope_monitor_new(const RdmnetScopeMonitorConfig* config)
     new_monitor->callbacks = config->callbacks;
 
     new_monitor->broker_handle = NULL;
-    new_monitor->broker_list = NULL;
+    discovered_broker_table_init(&new_monitor->brokers);
     memset(&new_monitor->platform_data, 0, sizeof(RdmnetScopeMonitorPlatformData));
   }
   return new_monitor;
@@ -165,7 +165,7 @@ bool scope_monitor_and_discovered_broker_find(ScopeMonitorAndDBPredicateFunction
     if (!RDMNET_ASSERT_VERIFY(ref))
       return false;
 
-    for (DiscoveredBroker* db = ref->broker_list; db; db = db->next)
+    for (DiscoveredBroker* db = ref->brokers.head; db; db = db->next)
     {
       if (predicate(ref, db, context))
       {
@@ -178,6 +178,29 @@ bool scope_monitor_and_discovered_broker_find(ScopeMonitorAndDBPredicateFunction
   return false;
 }
 
+/*
+ * Find a broker discovered by any scope monitor by its service instance name, through each
+ * monitor's name index. Assumes a lock is already taken.
+ */
+DiscoveredBroker* scope_monitor_find_broker_by_name(const char* service_name)
+{
+  if (!RDMNET_ASSERT_VERIFY(service_name))
+    return NULL;
+
+  for (void** ref_ptr = scope_monitor_refs.refs; ref_ptr < scope_monitor_refs.refs + scope_monitor_refs.num_refs;
+       ++ref_ptr)
+  {
+    RdmnetScopeMonitorRef* ref = *(RdmnetScopeMonitorRef**)ref_ptr;
+    if (!RDMNET_ASSERT_VERIFY(ref))
+      return NULL;
+
+    DiscoveredBroker* db = discovered_broker_table_find_by_name(&ref->brokers, service_name, NULL);
+    if (db)
+      return db;
+  }
+  return NULL;
+}
+
 /* Removes an entry from scope_ref_list. Assumes a lock is already taken. */
 void scope_monitor_remove(const RdmnetScopeMonitorRef* ref)
 {
@@ -196,14 +219,7 @@ void scope_monitor_delete(RdmnetScopeMonitorRef* ref)
   if (!RDMNET_ASSERT_VERIFY(ref))
     return;
 
-  DiscoveredBroker* db = ref->broker_list;
-  DiscoveredBroker* next_db = NULL;
-  while (db)
-  {
-    next_db = db->next;
-    discovered_broker_delete(db);
-    db = next_db;
-  }
+  discovered_broker_table_delete_all(&ref->brokers);
   FREE_SCOPE_MONITOR_REF(ref);
 }
 
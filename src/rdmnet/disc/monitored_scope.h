@@ -43,8 +43,8 @@ struct RdmnetScopeMonitorRef
   // If this ScopeMonitorRef is associated with a registered Broker, that is tracked here. Otherwise
   // NULL.
   rdmnet_registered_broker_t broker_handle;
-  // The list of Brokers discovered or being discovered on this scope.
-  DiscoveredBroker* broker_list;
+  // The Brokers discovered or being discovered on this scope.
+  DiscoveredBrokerTable brokers;
   // Platform-specific data stored with this monitor ref
   RdmnetScopeMonitorPlatformData platform_data;
 };
@@ -66,6 +66,7 @@ bool                   scope_monitor_and_discovered_broker_find(ScopeMonitorAndD
                                                                 const void*                        context,
                                                                 RdmnetScopeMonitorRef**            found_ref,
                                                                 DiscoveredBroker**                 found_db);
+DiscoveredBroker*      scope_monitor_find_broker_by_name(const char* service_name);
 void                   scope_monitor_remove(const RdmnetScopeMonitorRef* ref);
 void                   scope_monitor_delete(RdmnetScopeMonitorRef* ref);
 void                   scope_monitor_delete_all(void);
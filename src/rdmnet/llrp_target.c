@@ -244,6 +244,10 @@ etcpal_error_t create_new_target(const LlrpTargetConfig* config, llrp_target_t*
   rc_target->component_type = kLlrpCompNonRdmnet;
   rc_target->callbacks = kTargetCallbacks;
   rc_target->lock = &new_target->lock;
+#if RC_QUEUE_CALLBACKS
+  // Each target has its own response buffer.
+  rc_target->resp_lock = NULL;
+#endif
   res = rc_llrp_target_register(rc_target);
   if (res != kEtcPalErrOk)
   {
@@ -105,7 +105,7 @@ etcpal_error_t rdmnet_save_rdm_response(const RdmnetRdmResponse* response, Rdmne
   if (!response || !saved_response)
     return kEtcPalErrInvalid;
 
-  if (response->rdm_data && response->rdm_data_len)
+  if (response->rdm_data_len)
   {
     saved_response->rdm_data = (uint8_t*)malloc(response->rdm_data_len);
     if (!saved_response->rdm_data)
@@ -125,8 +125,8 @@ etcpal_error_t rdmnet_save_rdm_response(const RdmnetRdmResponse* response, Rdmne
     memcpy(saved_response->original_cmd_data, response->original_cmd_data, response->original_cmd_data_len);
   saved_response->original_cmd_data_len = response->original_cmd_data_len;
   saved_response->rdm_header = response->rdm_header;
-  if (response->rdm_data && response->rdm_data_len)
-    memcpy(saved_response->rdm_data, response->rdm_data, response->rdm_data_len);
+  if (saved_response->rdm_data)
+    rdmnet_rdm_response_copy_data(response, saved_response->rdm_data, response->rdm_data_len);
   saved_response->rdm_data_len = response->rdm_data_len;
   return kEtcPalErrOk;
 #else
@@ -152,9 +152,117 @@ etcpal_error_t rdmnet_save_rdm_response(const RdmnetRdmResponse* response, Rdmne
 etcpal_error_t rdmnet_append_to_saved_rdm_response(const RdmnetRdmResponse* new_response,
                                                    RdmnetSavedRdmResponse*  previously_saved_response)
 {
+#if RDMNET_DYNAMIC_MEM
+  if (!new_response || !previously_saved_response)
+    return kEtcPalErrInvalid;
+
+  if (new_response->rdm_data_len == 0)
+    return kEtcPalErrOk;
+
+  size_t   old_len = previously_saved_response->rdm_data_len;
+  uint8_t* new_data = (uint8_t*)realloc(previously_saved_response->rdm_data, old_len + new_response->rdm_data_len);
+  if (!new_data)
+    return kEtcPalErrNoMem;
+
+  rdmnet_rdm_response_copy_data(new_response, &new_data[old_len], new_response->rdm_data_len);
+  previously_saved_response->rdm_data = new_data;
+  previously_saved_response->rdm_data_len = old_len + new_response->rdm_data_len;
+  return kEtcPalErrOk;
+#else
   ETCPAL_UNUSED_ARG(new_response);
   ETCPAL_UNUSED_ARG(previously_saved_response);
   return kEtcPalErrNotImpl;
+#endif
+}
+
+/**
+ * @brief Start iterating over the parameter data fragments of an RDM response.
+ *
+ * @param[in] response Response whose data to iterate over. Must remain valid while iterating.
+ * @param[out] iter Iterator to initialize.
+ */
+void rdmnet_rdm_response_fragments_begin(const RdmnetRdmResponse* response, RdmnetRdmFragmentIter* iter)
+{
+  if (!iter)
+    return;
+
+  iter->response = response;
+  iter->next_index = 0;
+}
+
+/**
+ * @brief Get the next parameter data fragment of an RDM response.
+ *
+ * Fragments are returned in order and point into the received data; concatenated, they are equal
+ * to the response's full parameter data. Empty fragments are skipped.
+ *
+ * @param[in,out] iter Iterator initialized with rdmnet_rdm_response_fragments_begin().
+ * @param[out] data Filled in with a pointer to the fragment's data.
+ * @param[out] data_len Filled in with the length of the fragment's data.
+ * @return true: A fragment was returned.
+ * @return false: There are no more fragments, or an argument was invalid.
+ */
+bool rdmnet_rdm_response_next_fragment(RdmnetRdmFragmentIter* iter, const uint8_t** data, size_t* data_len)
+{
+  if (!iter || !iter->response || !data || !data_len)
+    return false;
+
+  const RdmnetRdmResponse* response = iter->response;
+  if (!response->rdm_fragments)
+  {
+    // The contiguous data buffer is the only fragment.
+    if (iter->next_index++ == 0 && response->rdm_data && response->rdm_data_len)
+    {
+      *data = response->rdm_data;
+      *data_len = response->rdm_data_len;
+      return true;
+    }
+    return false;
+  }
+
+  while (iter->next_index < response->num_rdm_fragments)
+  {
+    const RdmBuffer* buf = &response->rdm_fragments[iter->next_index++];
+    uint8_t          pdl = buf->data[RDM_OFFSET_PARAM_DATA_LEN];
+    if (pdl != 0)
+    {
+      *data = &buf->data[RDM_OFFSET_PARAM_DATA];
+      *data_len = pdl;
+      return true;
+    }
+  }
+  return false;
+}
+
+/**
+ * @brief Copy the parameter data of an RDM response into a contiguous buffer.
+ *
+ * The data is gathered from each fragment, so this works whether or not the response's rdm_data
+ * member holds a contiguous copy.
+ *
+ * @param[in] response Response whose data to copy.
+ * @param[out] buf Buffer to copy the data into.
+ * @param[in] buf_len Size of buf. At most this many bytes are copied.
+ * @return The number of bytes copied.
+ */
+size_t rdmnet_rdm_response_copy_data(const RdmnetRdmResponse* response, uint8_t* buf, size_t buf_len)
+{
+  if (!response || !buf)
+    return 0;
+
+  RdmnetRdmFragmentIter iter;
+  rdmnet_rdm_response_fragments_begin(response, &iter);
+
+  size_t         copied = 0;
+  const uint8_t* fragment;
+  size_t         fragment_len;
+  while (copied < buf_len && rdmnet_rdm_response_next_fragment(&iter, &fragment, &fragment_len))
+  {
+    size_t to_copy = (fragment_len < buf_len - copied ? fragment_len : buf_len - copied);
+    memcpy(&buf[copied], fragment, to_copy);
+    copied += to_copy;
+  }
+  return copied;
 }
 
 /**
@@ -56,11 +56,13 @@ set(RDMNET_API_SOURCES
 set(RDMNET_CORE_HEADERS
   ${RDMNET_SRC}/rdmnet/core/broker_message.h
   ${RDMNET_SRC}/rdmnet/core/broker_prot.h
+  ${RDMNET_SRC}/rdmnet/core/callback_queue.h
   ${RDMNET_SRC}/rdmnet/core/client.h
   ${RDMNET_SRC}/rdmnet/core/client_entry.h
   ${RDMNET_SRC}/rdmnet/core/common.h
   ${RDMNET_SRC}/rdmnet/core/connection.h
   ${RDMNET_SRC}/rdmnet/core/ept_message.h
+  ${RDMNET_SRC}/rdmnet/core/ept_prot.h
   ${RDMNET_SRC}/rdmnet/core/llrp.h
   ${RDMNET_SRC}/rdmnet/core/llrp_prot.h
   ${RDMNET_SRC}/rdmnet/core/mcast.h
@@ -69,14 +71,17 @@ set(RDMNET_CORE_HEADERS
   ${RDMNET_SRC}/rdmnet/core/opts.h
   ${RDMNET_SRC}/rdmnet/core/rpt_message.h
   ${RDMNET_SRC}/rdmnet/core/rpt_prot.h
+  ${RDMNET_SRC}/rdmnet/core/timer_wheel.h
   ${RDMNET_SRC}/rdmnet/core/util.h
 )
 set(RDMNET_CORE_SOURCES
   ${RDMNET_SRC}/rdmnet/core/broker_prot.c
+  ${RDMNET_SRC}/rdmnet/core/callback_queue.c
   ${RDMNET_SRC}/rdmnet/core/client.c
   ${RDMNET_SRC}/rdmnet/core/client_entry.c
   ${RDMNET_SRC}/rdmnet/core/common.c
   ${RDMNET_SRC}/rdmnet/core/connection.c
+  ${RDMNET_SRC}/rdmnet/core/ept_prot.c
   ${RDMNET_SRC}/rdmnet/core/llrp.c
   ${RDMNET_SRC}/rdmnet/core/llrp_manager.c
   ${RDMNET_SRC}/rdmnet/core/llrp_prot.c
@@ -85,9 +90,20 @@ set(RDMNET_CORE_SOURCES
   ${RDMNET_SRC}/rdmnet/core/message.c
   ${RDMNET_SRC}/rdmnet/core/msg_buf.c
   ${RDMNET_SRC}/rdmnet/core/rpt_prot.c
+  ${RDMNET_SRC}/rdmnet/core/timer_wheel.c
   ${RDMNET_SRC}/rdmnet/core/util.c
 )
 
+# Optional io_uring-based socket polling for the core, see cmake/ResolveIoUring.cmake.
+if(RDMNET_IO_URING_FOUND)
+  set(RDMNET_CORE_HEADERS ${RDMNET_CORE_HEADERS}
+    ${RDMNET_SRC}/rdmnet/core/uring_poll.h
+  )
+  set(RDMNET_CORE_SOURCES ${RDMNET_CORE_SOURCES}
+    ${RDMNET_SRC}/rdmnet/core/uring_poll.c
+  )
+endif()
+
 # Combination variables for convenience
 
 set(RDMNET_LIB_PUBLIC_HEADERS 
@@ -147,4 +163,12 @@ elseif(UNIX)
   set(RDMNET_BROKER_SOURCES ${RDMNET_BROKER_SOURCES}
     ${RDMNET_SRC}/rdmnet/broker/linux/linux_socket_manager.cpp
   )
+  if(RDMNET_IO_URING_FOUND)
+    set(RDMNET_BROKER_PRIVATE_HEADERS ${RDMNET_BROKER_PRIVATE_HEADERS}
+      ${RDMNET_SRC}/rdmnet/broker/linux/linux_uring_socket_manager.h
+    )
+    set(RDMNET_BROKER_SOURCES ${RDMNET_BROKER_SOURCES}
+      ${RDMNET_SRC}/rdmnet/broker/linux/linux_uring_socket_manager.cpp
+    )
+  endif()
 endif()
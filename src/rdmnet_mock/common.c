@@ -21,9 +21,11 @@
 
 DEFINE_FAKE_VALUE_FUNC(etcpal_error_t, rdmnet_init, const EtcPalLogParams*, const RdmnetNetintConfig*);
 DEFINE_FAKE_VOID_FUNC(rdmnet_deinit);
+DEFINE_FAKE_VALUE_FUNC(size_t, rdmnet_dispatch_callbacks, int);
 
 void rdmnet_mock_common_reset(void)
 {
   RESET_FAKE(rdmnet_init);
   RESET_FAKE(rdmnet_deinit);
+  RESET_FAKE(rdmnet_dispatch_callbacks);
 }
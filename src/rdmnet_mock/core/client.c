@@ -133,7 +133,7 @@ DEFINE_FAKE_VALUE_FUNC(etcpal_error_t,
                        ept_status_code_t,
                        const char*);
 
-DEFINE_FAKE_VALUE_FUNC(uint8_t*, rc_client_get_internal_response_buf, size_t);
+DEFINE_FAKE_VALUE_FUNC(uint8_t*, rc_client_get_internal_response_buf, RCClient*, size_t);
 
 void rc_client_reset_all_fakes(void)
 {
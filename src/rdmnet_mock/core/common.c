@@ -22,6 +22,7 @@
 #include "rdmnet_mock/core/broker_prot.h"
 #include "rdmnet_mock/core/client.h"
 #include "rdmnet_mock/core/connection.h"
+#include "rdmnet_mock/core/ept_prot.h"
 #include "rdmnet_mock/core/llrp_target.h"
 #include "rdmnet_mock/core/mcast.h"
 #include "rdmnet_mock/core/message.h"
@@ -78,6 +79,7 @@ void rdmnet_mock_core_reset(void)
   rc_broker_prot_reset_all_fakes();
   rc_client_reset_all_fakes();
   rc_connection_reset_all_fakes();
+  rc_ept_prot_reset_all_fakes();
   rc_llrp_target_reset_all_fakes();
   rc_mcast_reset_all_fakes();
   rc_message_reset_all_fakes();
@@ -29,6 +29,12 @@ DEFINE_FAKE_VALUE_FUNC(etcpal_error_t,
                        RCConnection*,
                        const EtcPalSockAddr*,
                        const BrokerClientConnectMsg*);
+DEFINE_FAKE_VALUE_FUNC(etcpal_error_t,
+                       rc_conn_connect_parallel,
+                       RCConnection*,
+                       const EtcPalSockAddr*,
+                       size_t,
+                       const BrokerClientConnectMsg*);
 DEFINE_FAKE_VALUE_FUNC(etcpal_error_t,
                        rc_conn_reconnect,
                        RCConnection*,
@@ -45,6 +51,7 @@ void rc_connection_reset_all_fakes(void)
   RESET_FAKE(rc_conn_register);
   RESET_FAKE(rc_conn_unregister);
   RESET_FAKE(rc_conn_connect);
+  RESET_FAKE(rc_conn_connect_parallel);
   RESET_FAKE(rc_conn_reconnect);
   RESET_FAKE(rc_conn_disconnect);
 }
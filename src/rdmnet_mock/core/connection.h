@@ -42,6 +42,12 @@ DECLARE_FAKE_VALUE_FUNC(etcpal_error_t,
                         RCConnection*,
                         const EtcPalSockAddr*,
                         const BrokerClientConnectMsg*);
+DECLARE_FAKE_VALUE_FUNC(etcpal_error_t,
+                        rc_conn_connect_parallel,
+                        RCConnection*,
+                        const EtcPalSockAddr*,
+                        size_t,
+                        const BrokerClientConnectMsg*);
 DECLARE_FAKE_VALUE_FUNC(etcpal_error_t,
                         rc_conn_reconnect,
                         RCConnection*,
@@ -0,0 +1,78 @@
+/******************************************************************************
+ * Copyright 2020 ETC Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ ******************************************************************************
+ * This file is a part of RDMnet. For more information, go to:
+ * https://github.com/ETCLabs/RDMnet
+ *****************************************************************************/
+
+/*
+ * rdmnet_mock/core/ept_prot.h
+ * Mocking the functions of rdmnet/core/ept_prot.h
+ */
+
+#ifndef RDMNET_MOCK_CORE_EPT_PROT_H_
+#define RDMNET_MOCK_CORE_EPT_PROT_H_
+
+#include "rdmnet/core/ept_prot.h"
+#include "fff.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+DECLARE_FAKE_VALUE_FUNC(size_t, rc_ept_get_data_buffer_size, size_t);
+DECLARE_FAKE_VALUE_FUNC(size_t, rc_ept_get_status_buffer_size, const char*);
+DECLARE_FAKE_VALUE_FUNC(size_t,
+                        rc_ept_pack_data,
+                        uint8_t*,
+                        size_t,
+                        const EtcPalUuid*,
+                        const EtcPalUuid*,
+                        uint16_t,
+                        uint16_t,
+                        const uint8_t*,
+                        size_t);
+DECLARE_FAKE_VALUE_FUNC(size_t,
+                        rc_ept_pack_status,
+                        uint8_t*,
+                        size_t,
+                        const EtcPalUuid*,
+                        const EtcPalUuid*,
+                        ept_status_code_t,
+                        const char*);
+DECLARE_FAKE_VALUE_FUNC(etcpal_error_t,
+                        rc_ept_send_data,
+                        RCConnection*,
+                        const EtcPalUuid*,
+                        const EtcPalUuid*,
+                        uint16_t,
+                        uint16_t,
+                        const uint8_t*,
+                        size_t);
+DECLARE_FAKE_VALUE_FUNC(etcpal_error_t,
+                        rc_ept_send_status,
+                        RCConnection*,
+                        const EtcPalUuid*,
+                        const EtcPalUuid*,
+                        ept_status_code_t,
+                        const char*);
+
+void rc_ept_prot_reset_all_fakes(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* RDMNET_MOCK_CORE_EPT_PROT_H_ */
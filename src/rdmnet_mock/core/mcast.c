@@ -25,6 +25,7 @@ DEFINE_FAKE_VOID_FUNC(rc_mcast_module_deinit);
 DEFINE_FAKE_VALUE_FUNC(size_t, rc_mcast_get_netint_array, const EtcPalMcastNetintId**);
 DEFINE_FAKE_VALUE_FUNC(bool, rc_mcast_netint_is_valid, const EtcPalMcastNetintId*);
 DEFINE_FAKE_VALUE_FUNC(const EtcPalMacAddr*, rc_mcast_get_lowest_mac_addr);
+DEFINE_FAKE_VALUE_FUNC(bool, rc_mcast_get_netint_addr, const EtcPalMcastNetintId*, EtcPalIpAddr*);
 
 DEFINE_FAKE_VALUE_FUNC(etcpal_error_t,
                        rc_mcast_get_send_socket,
@@ -43,6 +44,15 @@ DEFINE_FAKE_VALUE_FUNC(etcpal_error_t,
                        etcpal_socket_t,
                        const EtcPalMcastNetintId*,
                        const EtcPalIpAddr*);
+DEFINE_FAKE_VALUE_FUNC(int, rc_mcast_recv_batch, etcpal_socket_t, uint8_t*, size_t, RCMcastRecvMsg*, size_t);
+DEFINE_FAKE_VALUE_FUNC(etcpal_error_t,
+                       rc_mcast_send_to_netints,
+                       const RCMcastSendNetint*,
+                       size_t,
+                       const uint8_t*,
+                       size_t,
+                       const EtcPalSockAddr*,
+                       const EtcPalSockAddr*);
 
 void rc_mcast_reset_all_fakes(void)
 {
@@ -51,9 +61,12 @@ void rc_mcast_reset_all_fakes(void)
   RESET_FAKE(rc_mcast_get_netint_array);
   RESET_FAKE(rc_mcast_netint_is_valid);
   RESET_FAKE(rc_mcast_get_lowest_mac_addr);
+  RESET_FAKE(rc_mcast_get_netint_addr);
   RESET_FAKE(rc_mcast_get_send_socket);
   RESET_FAKE(rc_mcast_release_send_socket);
   RESET_FAKE(rc_mcast_create_recv_socket);
   RESET_FAKE(rc_mcast_subscribe_recv_socket);
   RESET_FAKE(rc_mcast_unsubscribe_recv_socket);
+  RESET_FAKE(rc_mcast_recv_batch);
+  RESET_FAKE(rc_mcast_send_to_netints);
 }
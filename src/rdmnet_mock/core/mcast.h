@@ -38,6 +38,7 @@ DECLARE_FAKE_VOID_FUNC(rc_mcast_module_deinit);
 DECLARE_FAKE_VALUE_FUNC(size_t, rc_mcast_get_netint_array, const EtcPalMcastNetintId**);
 DECLARE_FAKE_VALUE_FUNC(bool, rc_mcast_netint_is_valid, const EtcPalMcastNetintId*);
 DECLARE_FAKE_VALUE_FUNC(const EtcPalMacAddr*, rc_mcast_get_lowest_mac_addr);
+DECLARE_FAKE_VALUE_FUNC(bool, rc_mcast_get_netint_addr, const EtcPalMcastNetintId*, EtcPalIpAddr*);
 
 DECLARE_FAKE_VALUE_FUNC(etcpal_error_t,
                         rc_mcast_get_send_socket,
@@ -56,6 +57,15 @@ DECLARE_FAKE_VALUE_FUNC(etcpal_error_t,
                         etcpal_socket_t,
                         const EtcPalMcastNetintId*,
                         const EtcPalIpAddr*);
+DECLARE_FAKE_VALUE_FUNC(int, rc_mcast_recv_batch, etcpal_socket_t, uint8_t*, size_t, RCMcastRecvMsg*, size_t);
+DECLARE_FAKE_VALUE_FUNC(etcpal_error_t,
+                        rc_mcast_send_to_netints,
+                        const RCMcastSendNetint*,
+                        size_t,
+                        const uint8_t*,
+                        size_t,
+                        const EtcPalSockAddr*,
+                        const EtcPalSockAddr*);
 
 void rc_mcast_reset_all_fakes(void);
 
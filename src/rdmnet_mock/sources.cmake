@@ -13,6 +13,7 @@ set(RDMNET_MOCK_CORE_HEADERS
   ${RDMNET_SRC}/rdmnet_mock/core/client.h
   ${RDMNET_SRC}/rdmnet_mock/core/common.h
   ${RDMNET_SRC}/rdmnet_mock/core/connection.h
+  ${RDMNET_SRC}/rdmnet_mock/core/ept_prot.h
   ${RDMNET_SRC}/rdmnet_mock/core/mcast.h
   ${RDMNET_SRC}/rdmnet_mock/core/llrp.h
   ${RDMNET_SRC}/rdmnet_mock/core/llrp_manager.h
@@ -26,6 +27,7 @@ set(RDMNET_MOCK_CORE_SOURCES
   ${RDMNET_SRC}/rdmnet_mock/core/client.c
   ${RDMNET_SRC}/rdmnet_mock/core/common.c
   ${RDMNET_SRC}/rdmnet_mock/core/connection.c
+  ${RDMNET_SRC}/rdmnet_mock/core/ept_prot.c
   ${RDMNET_SRC}/rdmnet_mock/core/mcast.c
   ${RDMNET_SRC}/rdmnet_mock/core/llrp.c
   ${RDMNET_SRC}/rdmnet_mock/core/llrp_manager.c
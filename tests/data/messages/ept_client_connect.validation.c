@@ -0,0 +1,42 @@
+#include "rdmnet/core/message.h"
+
+// clang-format off
+
+static RdmnetEptSubProtocol ept_protocols[] = {
+  {
+    .manufacturer_id = 0x1234,
+    .protocol_id = 0x5678,
+    .protocol_string = "Example Protocol"
+  },
+  {
+    .manufacturer_id = 0x1234,
+    .protocol_id = 0x0001,
+    .protocol_string = "Another Protocol"
+  }
+};
+
+const RdmnetMessage ept_client_connect = {
+  .vector = ACN_VECTOR_ROOT_BROKER,
+  .sender_cid = {
+    .data = { 0x5a, 0x7c, 0x2f, 0x1e, 0x8d, 0x3b, 0x4c, 0x6a, 0x9e, 0x0f, 0x1d, 0x2c, 0x3b, 0x4a, 0x59, 0x68 }
+  },
+  .data.broker = {
+    .vector = VECTOR_BROKER_CONNECT,
+    .data.client_connect = {
+      .scope = "default",
+      .e133_version = 1,
+      .search_domain = "local.",
+      .connect_flags = 0x00,
+      .client_entry = {
+        .client_protocol = kClientProtocolEPT,
+        .data.ept = {
+          .cid = {
+            .data = { 0x5a, 0x7c, 0x2f, 0x1e, 0x8d, 0x3b, 0x4c, 0x6a, 0x9e, 0x0f, 0x1d, 0x2c, 0x3b, 0x4a, 0x59, 0x68 }
+          },
+          .protocols = ept_protocols,
+          .num_protocols = 2
+        }
+      }
+    }
+  }
+};
@@ -0,0 +1,59 @@
+#include "rdmnet/core/message.h"
+
+// clang-format off
+
+static RdmnetEptSubProtocol first_client_protocols[] = {
+  {
+    .manufacturer_id = 0x1234,
+    .protocol_id = 0x5678,
+    .protocol_string = "Example Protocol"
+  },
+  {
+    .manufacturer_id = 0x1234,
+    .protocol_id = 0x0001,
+    .protocol_string = "Another Protocol"
+  }
+};
+
+static RdmnetEptSubProtocol second_client_protocols[] = {
+  {
+    .manufacturer_id = 0x6c70,
+    .protocol_id = 0x0002,
+    .protocol_string = "Third Protocol"
+  }
+};
+
+static RdmnetEptClientEntry client_entries[] = {
+  {
+    .cid = {
+      .data = { 0x5a, 0x7c, 0x2f, 0x1e, 0x8d, 0x3b, 0x4c, 0x6a, 0x9e, 0x0f, 0x1d, 0x2c, 0x3b, 0x4a, 0x59, 0x68 }
+    },
+    .protocols = first_client_protocols,
+    .num_protocols = 2
+  },
+  {
+    .cid = {
+      .data = { 0x84, 0x74, 0x64, 0xec, 0xd7, 0xbc, 0x4b, 0x8a, 0xb5, 0x01, 0x57, 0x4b, 0xd4, 0xf8, 0xd9, 0x85 }
+    },
+    .protocols = second_client_protocols,
+    .num_protocols = 1
+  }
+};
+
+const RdmnetMessage ept_connected_client_list = {
+  .vector = ACN_VECTOR_ROOT_BROKER,
+  .sender_cid = {
+    .data = { 0xc9, 0x57, 0xa9, 0xe5, 0x72, 0xb3, 0x45, 0x5b, 0xba, 0x4f, 0x5b, 0x00, 0xcd, 0xc6, 0xfb, 0x57 }
+  },
+  .data.broker = {
+    .vector = VECTOR_BROKER_CONNECTED_CLIENT_LIST,
+    .data.client_list = {
+      .client_protocol = kClientProtocolEPT,
+      .data.ept = {
+        .more_coming = false,
+        .num_client_entries = 2,
+        .client_entries = client_entries
+      }
+    }
+  }
+};
@@ -0,0 +1,27 @@
+#include "rdmnet/core/message.h"
+
+// clang-format off
+
+static const uint8_t ept_data_payload[] = { 0xde, 0xad, 0xbe, 0xef, 0x01, 0x02, 0x03, 0x04 };
+
+const RdmnetMessage ept_data = {
+  .vector = ACN_VECTOR_ROOT_EPT,
+  .sender_cid = {
+    .data = { 0x5a, 0x7c, 0x2f, 0x1e, 0x8d, 0x3b, 0x4c, 0x6a, 0x9e, 0x0f, 0x1d, 0x2c, 0x3b, 0x4a, 0x59, 0x68 }
+  },
+  .data.ept = {
+    .dest_cid = {
+      .data = { 0xc4, 0x1b, 0x9a, 0x7e, 0x2d, 0x5f, 0x4e, 0x8c, 0x8a, 0x1b, 0x3c, 0x5d, 0x7e, 0x9f, 0x0a, 0x2b }
+    },
+    .vector = VECTOR_EPT_DATA,
+    .data.ept_data = {
+      .source_cid = {
+        .data = { 0x5a, 0x7c, 0x2f, 0x1e, 0x8d, 0x3b, 0x4c, 0x6a, 0x9e, 0x0f, 0x1d, 0x2c, 0x3b, 0x4a, 0x59, 0x68 }
+      },
+      .manufacturer_id = 0x1234,
+      .protocol_id = 0x5678,
+      .data = ept_data_payload,
+      .data_len = sizeof(ept_data_payload)
+    }
+  }
+};
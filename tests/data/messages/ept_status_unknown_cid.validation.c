@@ -0,0 +1,23 @@
+#include "rdmnet/core/message.h"
+
+// clang-format off
+
+const RdmnetMessage ept_status_unknown_cid = {
+  .vector = ACN_VECTOR_ROOT_EPT,
+  .sender_cid = {
+    .data = { 0xc4, 0x1b, 0x9a, 0x7e, 0x2d, 0x5f, 0x4e, 0x8c, 0x8a, 0x1b, 0x3c, 0x5d, 0x7e, 0x9f, 0x0a, 0x2b }
+  },
+  .data.ept = {
+    .dest_cid = {
+      .data = { 0x5a, 0x7c, 0x2f, 0x1e, 0x8d, 0x3b, 0x4c, 0x6a, 0x9e, 0x0f, 0x1d, 0x2c, 0x3b, 0x4a, 0x59, 0x68 }
+    },
+    .vector = VECTOR_EPT_STATUS,
+    .data.ept_status = {
+      .source_cid = {
+        .data = { 0xc4, 0x1b, 0x9a, 0x7e, 0x2d, 0x5f, 0x4e, 0x8c, 0x8a, 0x1b, 0x3c, 0x5d, 0x7e, 0x9f, 0x0a, 0x2b }
+      },
+      .status_code = kEptStatusUnknownCid,
+      .status_string = "Destination not found"
+    }
+  }
+};
@@ -380,9 +380,57 @@ inline void ExpectMessagesEqual(const RptMessage& a, const RptMessage& b)
   }
 }
 
-inline void ExpectMessagesEqual(const EptMessage& /* a */, const EptMessage& /* b */)
+inline void ExpectMessagesEqual(const RdmnetEptData& a, const RdmnetEptData& b)
 {
-  // TODO
+  EXPECT_EQ(a.source_cid, b.source_cid);
+  EXPECT_EQ(a.manufacturer_id, b.manufacturer_id);
+  EXPECT_EQ(a.protocol_id, b.protocol_id);
+  EXPECT_EQ(a.data_len, b.data_len);
+  if (a.data_len == b.data_len && a.data && b.data)
+  {
+    EXPECT_EQ(0, std::memcmp(a.data, b.data, a.data_len));
+  }
+}
+
+inline void ExpectMessagesEqual(const RdmnetEptStatus& a, const RdmnetEptStatus& b)
+{
+  EXPECT_EQ(a.source_cid, b.source_cid);
+  EXPECT_EQ(a.status_code, b.status_code);
+  if (a.status_string && b.status_string)
+  {
+    EXPECT_STREQ(a.status_string, b.status_string);
+  }
+  else if (!a.status_string && !b.status_string)
+  {
+    // No comparison to make
+  }
+  else
+  {
+    ADD_FAILURE() << "Null/not-null mismatch between status strings; a was "
+                  << reinterpret_cast<const void*>(a.status_string) << ", b was "
+                  << reinterpret_cast<const void*>(b.status_string);
+  }
+}
+
+inline void ExpectMessagesEqual(const EptMessage& a, const EptMessage& b)
+{
+  EXPECT_EQ(a.vector, b.vector);
+  EXPECT_EQ(a.dest_cid, b.dest_cid);
+
+  if (a.vector == b.vector)
+  {
+    switch (a.vector)
+    {
+      case VECTOR_EPT_DATA:
+        ExpectMessagesEqual(a.data.ept_data, b.data.ept_data);
+        break;
+      case VECTOR_EPT_STATUS:
+        ExpectMessagesEqual(a.data.ept_status, b.data.ept_status);
+        break;
+      default:
+        ADD_FAILURE() << "EPT messages contained unknown vector " << a.vector;
+    }
+  }
 }
 
 inline void ExpectMessagesEqual(const RdmnetMessage& a, const RdmnetMessage& b)
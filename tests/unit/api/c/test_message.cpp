@@ -84,7 +84,9 @@ TEST(TestMessageApi, SaveRdmResponseWorks)
       {{0x4321, 0xcba98765}, {0x1234, 0x56789abc}, 0x78, kRdmResponseTypeAck, 3, 511, kRdmCCGetCommandResponse, 0x8001},
       kTestRespData.data(),
       kTestRespData.size(),
-      false};
+      false,
+      nullptr,
+      0};
 
   RdmnetSavedRdmResponse saved_resp{};
 #if RDMNET_DYNAMIC_MEM
@@ -107,9 +109,118 @@ TEST(TestMessageApi, SaveRdmResponseWorks)
 #endif
 }
 
+// Fill in only the parts of an RDM response PDU that the fragment functions read
+static RdmBuffer MakeFragment(const uint8_t* data, uint8_t data_len)
+{
+  RdmBuffer buf{};
+  buf.data[RDM_OFFSET_PARAM_DATA_LEN] = data_len;
+  if (data_len)
+    std::memcpy(&buf.data[RDM_OFFSET_PARAM_DATA], data, data_len);
+  buf.data_len = RDM_OFFSET_PARAM_DATA + data_len + 2;
+  return buf;
+}
+
 TEST(TestMessageApi, AppendToSavedRdmResponseWorks)
 {
-  // TODO
+  const std::array<uint8_t, 4> kFirstData{0x00, 0x01, 0x02, 0x03};
+  const std::array<uint8_t, 3> kSecondData{0x04, 0x05, 0x06};
+
+  RdmnetRdmResponse resp{};
+  resp.rdm_header.resp_type = kRdmResponseTypeAck;
+  resp.rdm_data = kFirstData.data();
+  resp.rdm_data_len = kFirstData.size();
+
+  RdmnetSavedRdmResponse saved_resp{};
+#if RDMNET_DYNAMIC_MEM
+  ASSERT_EQ(rdmnet_save_rdm_response(&resp, &saved_resp), kEtcPalErrOk);
+
+  resp.rdm_data = kSecondData.data();
+  resp.rdm_data_len = kSecondData.size();
+  ASSERT_EQ(rdmnet_append_to_saved_rdm_response(&resp, &saved_resp), kEtcPalErrOk);
+
+  const std::array<uint8_t, 7> kAllData{0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06};
+  ASSERT_EQ(saved_resp.rdm_data_len, kAllData.size());
+  EXPECT_EQ(0, std::memcmp(saved_resp.rdm_data, kAllData.data(), kAllData.size()));
+
+  EXPECT_EQ(rdmnet_free_saved_rdm_response(&saved_resp), kEtcPalErrOk);
+#else
+  EXPECT_EQ(rdmnet_append_to_saved_rdm_response(&resp, &saved_resp), kEtcPalErrNotImpl);
+#endif
+}
+
+TEST(TestMessageApi, FragmentIterationWithContiguousData)
+{
+  const std::array<uint8_t, 4> kTestData{0x00, 0x01, 0x02, 0x03};
+
+  RdmnetRdmResponse resp{};
+  resp.rdm_data = kTestData.data();
+  resp.rdm_data_len = kTestData.size();
+
+  RdmnetRdmFragmentIter iter;
+  rdmnet_rdm_response_fragments_begin(&resp, &iter);
+
+  const uint8_t* fragment = nullptr;
+  size_t         fragment_len = 0;
+  ASSERT_TRUE(rdmnet_rdm_response_next_fragment(&iter, &fragment, &fragment_len));
+  EXPECT_EQ(fragment, kTestData.data());
+  EXPECT_EQ(fragment_len, kTestData.size());
+  EXPECT_FALSE(rdmnet_rdm_response_next_fragment(&iter, &fragment, &fragment_len));
+
+  // No data means no fragments
+  resp.rdm_data = nullptr;
+  resp.rdm_data_len = 0;
+  rdmnet_rdm_response_fragments_begin(&resp, &iter);
+  EXPECT_FALSE(rdmnet_rdm_response_next_fragment(&iter, &fragment, &fragment_len));
+}
+
+TEST(TestMessageApi, FragmentIterationWithReceivedFragments)
+{
+  const std::array<uint8_t, 3> kFirstData{0x00, 0x01, 0x02};
+  const std::array<uint8_t, 2> kSecondData{0x03, 0x04};
+
+  const std::array<RdmBuffer, 3> fragments{MakeFragment(kFirstData.data(), static_cast<uint8_t>(kFirstData.size())),
+                                           MakeFragment(nullptr, 0),
+                                           MakeFragment(kSecondData.data(), static_cast<uint8_t>(kSecondData.size()))};
+
+  RdmnetRdmResponse resp{};
+  resp.rdm_data = nullptr;
+  resp.rdm_data_len = kFirstData.size() + kSecondData.size();
+  resp.rdm_fragments = fragments.data();
+  resp.num_rdm_fragments = fragments.size();
+
+  // Empty fragments are skipped and the rest point into the received buffers
+  RdmnetRdmFragmentIter iter;
+  rdmnet_rdm_response_fragments_begin(&resp, &iter);
+
+  const uint8_t* fragment = nullptr;
+  size_t         fragment_len = 0;
+  ASSERT_TRUE(rdmnet_rdm_response_next_fragment(&iter, &fragment, &fragment_len));
+  EXPECT_EQ(fragment, &fragments[0].data[RDM_OFFSET_PARAM_DATA]);
+  EXPECT_EQ(fragment_len, kFirstData.size());
+  ASSERT_TRUE(rdmnet_rdm_response_next_fragment(&iter, &fragment, &fragment_len));
+  EXPECT_EQ(fragment, &fragments[2].data[RDM_OFFSET_PARAM_DATA]);
+  EXPECT_EQ(fragment_len, kSecondData.size());
+  EXPECT_FALSE(rdmnet_rdm_response_next_fragment(&iter, &fragment, &fragment_len));
+
+  const std::array<uint8_t, 5> kAllData{0x00, 0x01, 0x02, 0x03, 0x04};
+  std::array<uint8_t, 5>       copied{};
+  ASSERT_EQ(rdmnet_rdm_response_copy_data(&resp, copied.data(), copied.size()), kAllData.size());
+  EXPECT_EQ(copied, kAllData);
+
+  // A short buffer gets a truncated copy
+  copied.fill(0);
+  ASSERT_EQ(rdmnet_rdm_response_copy_data(&resp, copied.data(), 4), 4u);
+  EXPECT_EQ(0, std::memcmp(copied.data(), kAllData.data(), 4));
+  EXPECT_EQ(copied[4], 0u);
+
+#if RDMNET_DYNAMIC_MEM
+  // Saving gathers the fragments
+  RdmnetSavedRdmResponse saved_resp{};
+  ASSERT_EQ(rdmnet_save_rdm_response(&resp, &saved_resp), kEtcPalErrOk);
+  ASSERT_EQ(saved_resp.rdm_data_len, kAllData.size());
+  EXPECT_EQ(0, std::memcmp(saved_resp.rdm_data, kAllData.data(), kAllData.size()));
+  EXPECT_EQ(rdmnet_free_saved_rdm_response(&saved_resp), kEtcPalErrOk);
+#endif
 }
 
 TEST(TestMessageApi, SaveRptStatusWorks)
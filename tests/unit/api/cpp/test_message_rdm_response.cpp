@@ -17,9 +17,13 @@
  * https://github.com/ETCLabs/RDMnet
  *****************************************************************************/
 
-#include "gtest/gtest.h"
 #include "rdmnet/cpp/message_types/rdm_response.h"
 
+#include <array>
+#include <cstring>
+#include <vector>
+#include "gtest/gtest.h"
+
 TEST(TestRdmResponse, RefConstructorWorks)
 {
   RdmnetRdmResponse   c_resp{};
@@ -31,3 +35,38 @@ TEST(TestSavedRdmResponse, DefaultConstructorWorks)
   rdmnet::SavedRdmResponse resp;
   EXPECT_FALSE(resp.IsValid());
 }
+
+TEST(TestRdmResponse, FragmentsWork)
+{
+  const std::array<uint8_t, 3> kFirstData{0x00, 0x01, 0x02};
+  const std::array<uint8_t, 2> kSecondData{0x03, 0x04};
+  const std::vector<uint8_t>   kAllData{0x00, 0x01, 0x02, 0x03, 0x04};
+
+  std::array<RdmBuffer, 2> fragments{};
+  fragments[0].data[RDM_OFFSET_PARAM_DATA_LEN] = static_cast<uint8_t>(kFirstData.size());
+  std::memcpy(&fragments[0].data[RDM_OFFSET_PARAM_DATA], kFirstData.data(), kFirstData.size());
+  fragments[1].data[RDM_OFFSET_PARAM_DATA_LEN] = static_cast<uint8_t>(kSecondData.size());
+  std::memcpy(&fragments[1].data[RDM_OFFSET_PARAM_DATA], kSecondData.data(), kSecondData.size());
+
+  RdmnetRdmResponse c_resp{};
+  c_resp.rdm_header.resp_type = kRdmResponseTypeAck;
+  c_resp.rdm_data_len = kAllData.size();
+  c_resp.rdm_fragments = fragments.data();
+  c_resp.num_rdm_fragments = fragments.size();
+  rdmnet::RdmResponse resp(c_resp);
+
+  std::vector<uint8_t> iterated;
+  size_t               num_fragments = 0;
+  for (const auto& fragment : resp.fragments())
+  {
+    iterated.insert(iterated.end(), fragment.data, fragment.data + fragment.size);
+    ++num_fragments;
+  }
+  EXPECT_EQ(num_fragments, 2u);
+  EXPECT_EQ(iterated, kAllData);
+  EXPECT_EQ(resp.GetData(), kAllData);
+
+  rdmnet::SavedRdmResponse saved;
+  saved.AppendData(resp);
+  EXPECT_EQ(saved.GetData(), kAllData);
+}
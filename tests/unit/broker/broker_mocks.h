@@ -37,6 +37,7 @@ public:
   MOCK_METHOD(void, SetNotify, (BrokerSocketNotify * notify), (override));
   MOCK_METHOD(bool, AddSocket, (BrokerClient::Handle conn_handle, etcpal_socket_t sock), (override));
   MOCK_METHOD(void, RemoveSocket, (BrokerClient::Handle conn_handle), (override));
+  MOCK_METHOD(bool, AddListenSocket, (etcpal_socket_t listen_sock), (override));
 };
 
 class MockBrokerThreadManager : public BrokerThreadInterface
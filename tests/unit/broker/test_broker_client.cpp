@@ -29,6 +29,9 @@
 #include "etcpal_mock/socket.h"
 #include "rdmnet_mock/core/common.h"
 #include "rdm/cpp/uid.h"
+#include "rdm/defs.h"
+#include "rdm/message.h"
+#include "broker_mocks.h"
 
 // A generic broker message to be used for filling up queues of clients.
 // We use the CLIENT_ADD vector.
@@ -82,6 +85,32 @@ TEST_F(TestBaseBrokerClient, SendsBrokerMessage)
   EXPECT_EQ(rc_send_fake.call_count, 1u);
 }
 
+class MockSendingSocketManager : public MockBrokerSocketManager
+{
+public:
+  MOCK_METHOD(int,
+              SendOnSocket,
+              (BrokerClient::Handle handle, etcpal_socket_t sock, const uint8_t* data, size_t size),
+              (override));
+};
+
+// A client with a socket manager sends through it, so that the sends can be batched.
+TEST_F(TestBaseBrokerClient, SendsThroughSocketManager)
+{
+  MockSendingSocketManager socket_mgr;
+  client_->socket_mgr_ = &socket_mgr;
+
+  BrokerMessage msg{};
+  msg.vector = VECTOR_BROKER_CONNECT_REPLY;
+
+  // Takes all of the data
+  EXPECT_CALL(socket_mgr, SendOnSocket(kClientHandle, kClientSocket, testing::_, testing::_))
+      .WillOnce(testing::ReturnArg<3>());
+  EXPECT_EQ(client_->Push(broker_cid_, msg), ClientPushResult::Ok);
+  EXPECT_TRUE(client_->Send(broker_cid_));
+  EXPECT_EQ(rc_send_fake.call_count, 0u);
+}
+
 // Generic/unknown clients should send periodic heartbeat messages.
 TEST_F(TestBaseBrokerClient, SendsHeartbeat)
 {
@@ -263,6 +292,34 @@ protected:
     BrokerClient bc(kClientHandle, kClientSocket);
     controller_ = std::make_unique<RPTController>(kMaxQSize, client_entry_, bc);
   }
+
+  RdmBuffer  notification_buf_{};
+  RptMessage notification_{};
+
+  // Make notification_ carry a GET_COMMAND_RESPONSE for param_id. A seqnum of 0 makes it unsolicited.
+  void SetNotification(uint16_t param_id, uint32_t seqnum)
+  {
+    RdmCommandHeader cmd_header{};
+    cmd_header.source_uid = rdm::Uid(0x6574, 0x12345678).get();
+    cmd_header.dest_uid = rdm::Uid(0x6574, 0x87654321).get();
+    cmd_header.transaction_num = 1;
+    cmd_header.port_id = 1;
+    cmd_header.command_class = kRdmCCGetCommand;
+    cmd_header.param_id = param_id;
+    ASSERT_EQ(rdm_pack_response(&cmd_header, 0, nullptr, 0, &notification_buf_), kEtcPalErrOk);
+
+    notification_.vector = VECTOR_RPT_NOTIFICATION;
+    notification_.header.seqnum = seqnum;
+    RPT_GET_RDM_BUF_LIST(&notification_)->rdm_buffers = &notification_buf_;
+    RPT_GET_RDM_BUF_LIST(&notification_)->num_rdm_buffers = 1;
+  }
+
+  rdmnet::Broker::ClientQueueStats GetStats()
+  {
+    rdmnet::Broker::ClientQueueStats stats;
+    controller_->GetQueueStats(stats);
+    return stats;
+  }
 };
 
 // Controllers should send periodic heartbeat messages.
@@ -338,6 +395,129 @@ TEST_F(TestBrokerClientRptController, InfiniteMaxQSize)
   }
 }
 
+TEST_F(TestBrokerClientRptController, HonorsMaxQBytes)
+{
+  controller_->max_q_size_ = BrokerClient::kLimitlessQueueSize;
+
+  ASSERT_EQ(controller_->Push(sending_controller_handle_, broker_cid_, request_), ClientPushResult::Ok);
+  const size_t request_size = GetStats().queued_bytes;
+  ASSERT_GT(request_size, 0u);
+
+  // Room is checked before each push, so the queue takes messages until it reaches the limit.
+  controller_->max_q_bytes_ = (2 * request_size) + 1;
+  EXPECT_EQ(controller_->Push(sending_controller_handle_, broker_cid_, request_), ClientPushResult::Ok);
+  EXPECT_EQ(controller_->Push(sending_controller_handle_, broker_cid_, request_), ClientPushResult::Ok);
+  EXPECT_EQ(controller_->Push(sending_controller_handle_, broker_cid_, request_), ClientPushResult::QueueFull);
+
+  auto stats = GetStats();
+  EXPECT_EQ(stats.queued_messages, 3u);
+  EXPECT_EQ(stats.queued_bytes, 3 * request_size);
+  EXPECT_EQ(stats.queue_full, 1u);
+
+  // Sending a message frees its bytes.
+  rc_send_fake.custom_fake = [](etcpal_socket_t, const void*, size_t size, int) { return static_cast<int>(size); };
+  EXPECT_TRUE(controller_->Send(broker_cid_));
+  EXPECT_EQ(GetStats().queued_bytes, 2 * request_size);
+  EXPECT_EQ(controller_->Push(sending_controller_handle_, broker_cid_, request_), ClientPushResult::Ok);
+}
+
+TEST_F(TestBrokerClientRptController, HonorsTotalQueueBytes)
+{
+  auto budget = std::make_shared<QueueByteBudget>(1);
+  controller_->q_budget_ = budget;
+
+  BrokerClient bc(kClientHandle + 1, kClientSocket);
+  bc.q_budget_ = budget;
+  RPTController other_controller(kMaxQSize, client_entry_, bc);
+
+  EXPECT_EQ(controller_->Push(sending_controller_handle_, broker_cid_, request_), ClientPushResult::Ok);
+  EXPECT_EQ(budget->used(), GetStats().queued_bytes);
+  EXPECT_EQ(other_controller.Push(sending_controller_handle_, broker_cid_, request_), ClientPushResult::QueueFull);
+
+  // Destroying a client returns its queued bytes to the budget.
+  controller_.reset();
+  EXPECT_EQ(budget->used(), 0u);
+  EXPECT_EQ(other_controller.Push(sending_controller_handle_, broker_cid_, request_), ClientPushResult::Ok);
+}
+
+TEST_F(TestBrokerClientRptController, DropOldestNotificationPolicy)
+{
+  controller_->overflow_policy_ = rdmnet::Broker::OverflowPolicy::kDropOldestNotification;
+  SetNotification(E120_DEVICE_LABEL, 1);
+
+  ASSERT_EQ(controller_->Push(sending_controller_handle_, broker_cid_, request_), ClientPushResult::Ok);
+  for (size_t i = 1; i < kMaxQSize; ++i)
+  {
+    ASSERT_EQ(controller_->Push(sending_controller_handle_, broker_cid_, notification_), ClientPushResult::Ok)
+        << "Failed on iteration " << i;
+  }
+
+  // A full queue still takes notifications, in place of the oldest queued one, but nothing else.
+  EXPECT_TRUE(controller_->HasRoomForRptMessage(notification_));
+  EXPECT_EQ(controller_->Push(sending_controller_handle_, broker_cid_, notification_), ClientPushResult::Ok);
+  EXPECT_FALSE(controller_->HasRoomForRptMessage(request_));
+  EXPECT_EQ(controller_->Push(sending_controller_handle_, broker_cid_, request_), ClientPushResult::QueueFull);
+
+  auto stats = GetStats();
+  EXPECT_EQ(stats.queued_messages, kMaxQSize);
+  EXPECT_EQ(stats.notifications_dropped, 1u);
+  EXPECT_EQ(stats.queue_full, 1u);
+}
+
+TEST_F(TestBrokerClientRptController, CoalesceNotificationsPolicy)
+{
+  controller_->overflow_policy_ = rdmnet::Broker::OverflowPolicy::kCoalesceNotifications;
+
+  for (size_t i = 0; i < kMaxQSize; ++i)
+  {
+    SetNotification(static_cast<uint16_t>(0x8000 + i), 0);
+    ASSERT_EQ(controller_->Push(sending_controller_handle_, broker_cid_, notification_), ClientPushResult::Ok)
+        << "Failed on iteration " << i;
+  }
+
+  // A newer unsolicited notification for a queued parameter replaces the queued one.
+  SetNotification(0x8003, 0);
+  EXPECT_EQ(controller_->Push(sending_controller_handle_, broker_cid_, notification_), ClientPushResult::Ok);
+
+  // Notifications for other parameters, and solicited ones, are refused.
+  SetNotification(0x9000, 0);
+  EXPECT_EQ(controller_->Push(sending_controller_handle_, broker_cid_, notification_), ClientPushResult::QueueFull);
+  SetNotification(0x8003, 1);
+  EXPECT_EQ(controller_->Push(sending_controller_handle_, broker_cid_, notification_), ClientPushResult::QueueFull);
+
+  auto stats = GetStats();
+  EXPECT_EQ(stats.queued_messages, kMaxQSize);
+  EXPECT_EQ(stats.notifications_coalesced, 1u);
+  EXPECT_EQ(stats.queue_full, 2u);
+}
+
+TEST_F(TestBrokerClientRptController, CoalescesNotificationsWhenEnabled)
+{
+  controller_->coalesce_notifications_ = true;
+
+  SetNotification(E120_DMX_START_ADDRESS, 0);
+  ASSERT_EQ(controller_->Push(sending_controller_handle_, broker_cid_, notification_), ClientPushResult::Ok);
+  ASSERT_EQ(controller_->Push(sending_controller_handle_, broker_cid_, request_), ClientPushResult::Ok);
+
+  // Replaced in place, even though the queue has room
+  EXPECT_EQ(controller_->Push(sending_controller_handle_, broker_cid_, notification_), ClientPushResult::Ok);
+  EXPECT_EQ(GetStats().queued_messages, 2u);
+  EXPECT_EQ(GetStats().notifications_coalesced, 1u);
+
+  // The same parameter from another endpoint is a different value
+  notification_.header.source_endpoint_id = 1;
+  EXPECT_EQ(controller_->Push(sending_controller_handle_, broker_cid_, notification_), ClientPushResult::Ok);
+  EXPECT_EQ(GetStats().queued_messages, 3u);
+
+  // Once a notification has started sending, it is no longer replaced.
+  rc_send_fake.return_val = 1;
+  EXPECT_TRUE(controller_->Send(broker_cid_));
+  notification_.header.source_endpoint_id = 0;
+  EXPECT_EQ(controller_->Push(sending_controller_handle_, broker_cid_, notification_), ClientPushResult::Ok);
+  EXPECT_EQ(GetStats().queued_messages, 4u);
+  EXPECT_EQ(GetStats().notifications_coalesced, 1u);
+}
+
 class TestBrokerClientRptDevice : public testing::Test
 {
 public:
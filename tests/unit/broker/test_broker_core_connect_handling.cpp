@@ -52,9 +52,11 @@ protected:
   {
     etcpal_reset_all_fakes();
     rdmnet_mock_core_reset_and_init();
-    ASSERT_TRUE(StartBroker(broker_, DefaultBrokerSettings(), mocks_));
+    ASSERT_TRUE(StartBroker(broker_, BrokerSettings(), mocks_));
   }
 
+  virtual rdmnet::Broker::Settings BrokerSettings() const { return DefaultBrokerSettings(); }
+
   BrokerClient::Handle AddTcpConn();
 };
 
@@ -133,3 +135,78 @@ TEST_F(TestBrokerCoreConnectHandling, HandlesRemoveUidOnDisconnect)
   mocks_.broker_callbacks->HandleSocketMessageReceived(conn_handle, disconnect_msg);
   EXPECT_FALSE(broker_.IsValidControllerDestinationUID(rdm::Uid(0xe574, 0x00000002).get()));
 }
+
+class TestBrokerCoreConnectPacing : public TestBrokerCoreConnectHandling
+{
+protected:
+  rdmnet::Broker::Settings BrokerSettings() const override
+  {
+    auto settings = DefaultBrokerSettings();
+    settings.limits.connect_rate = 10;
+    settings.limits.connect_burst = 1;
+    return settings;
+  }
+};
+
+TEST_F(TestBrokerCoreConnectPacing, DefersConnectsOverRate)
+{
+  auto                 first_cid = etcpal::Uuid::FromString("7e6b3b4a-1f8e-4f1e-9d3c-2a5b6c7d8e01");
+  auto                 second_cid = etcpal::Uuid::FromString("7e6b3b4a-1f8e-4f1e-9d3c-2a5b6c7d8e02");
+  BrokerClient::Handle first_handle = AddTcpConn();
+  BrokerClient::Handle second_handle = AddTcpConn();
+  RdmnetMessage        first_connect = testmsgs::ClientConnect(first_cid);
+  RdmnetMessage        second_connect = testmsgs::ClientConnect(second_cid);
+
+  EXPECT_EQ(mocks_.broker_callbacks->HandleSocketMessageReceived(first_handle, first_connect),
+            HandleMessageResult::kGetNextMessage);
+  EXPECT_TRUE(broker_.IsValidControllerDestinationUID(rdm::Uid(0xe574, 0x00000002).get()));
+
+  // The second connect exceeds the burst and should be held until the rate allows it.
+  EXPECT_EQ(mocks_.broker_callbacks->HandleSocketMessageReceived(second_handle, second_connect),
+            HandleMessageResult::kRetryLater);
+  EXPECT_FALSE(broker_.IsValidControllerDestinationUID(rdm::Uid(0xe574, 0x00000003).get()));
+
+  etcpal_getms_fake.return_val += 100;
+  EXPECT_EQ(mocks_.broker_callbacks->HandleSocketMessageReceived(second_handle, second_connect),
+            HandleMessageResult::kGetNextMessage);
+  EXPECT_TRUE(broker_.IsValidControllerDestinationUID(rdm::Uid(0xe574, 0x00000003).get()));
+}
+
+TEST_F(TestBrokerCoreConnectPacing, TurnsAwayConnectsWithRetryHint)
+{
+  // Each connect after the first is given a slot 100 ms after the last. Those that would wait
+  // longer than the broker holds a connect are turned away with a hint of when their slot is.
+  for (uint8_t i = 0; i < 6; ++i)
+  {
+    EtcPalUuid cid{};
+    cid.data[15] = i;
+    RdmnetMessage connect_msg = testmsgs::ClientConnect(cid);
+
+    auto result = mocks_.broker_callbacks->HandleSocketMessageReceived(AddTcpConn(), connect_msg);
+    EXPECT_EQ(result, i == 0 ? HandleMessageResult::kGetNextMessage : HandleMessageResult::kRetryLater);
+  }
+  mocks_.broker_callbacks->ServiceClients();
+  RESET_FAKE(rc_send);
+
+  rc_send_fake.custom_fake = [](etcpal_socket_t, const void* data, size_t data_size, int) -> int {
+    EXPECT_EQ(data_size, static_cast<size_t>(BROKER_CONNECT_REPLY_FULL_MSG_SIZE));
+
+    const uint8_t* byte_data = reinterpret_cast<const uint8_t*>(data);
+    EXPECT_EQ(etcpal_unpack_u16b(&byte_data[kBrokerVectorOffset]), VECTOR_BROKER_CONNECT_REPLY);
+    EXPECT_EQ(etcpal_unpack_u16b(&byte_data[kConnectReplyCodeOffset]), E133_CONNECT_CAPACITY_EXCEEDED);
+    // The hint is in the Client UID field
+    EXPECT_EQ(etcpal_unpack_u16b(&byte_data[kConnectReplyCodeOffset + 10]), 0u);
+    EXPECT_EQ(etcpal_unpack_u32b(&byte_data[kConnectReplyCodeOffset + 12]), 600u);
+    return static_cast<int>(data_size);
+  };
+
+  EtcPalUuid cid{};
+  cid.data[15] = 6;
+  RdmnetMessage connect_msg = testmsgs::ClientConnect(cid);
+  EXPECT_EQ(mocks_.broker_callbacks->HandleSocketMessageReceived(AddTcpConn(), connect_msg),
+            HandleMessageResult::kGetNextMessage);
+  EXPECT_TRUE(mocks_.broker_callbacks->ServiceClients());
+  EXPECT_EQ(rc_send_fake.call_count, 1u);
+
+  RESET_FAKE(rc_send);
+}
@@ -0,0 +1,258 @@
+/******************************************************************************
+ * Copyright 2022 ETC Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ ******************************************************************************
+ * This file is a part of RDMnet. For more information, go to:
+ * https://github.com/ETCLabs/RDMnet
+ *****************************************************************************/
+
+// Test the broker's routing of EPT messages between EPT clients.
+
+#include "broker_core.h"
+
+#include <algorithm>
+#include <map>
+#include <vector>
+#include "gmock/gmock.h"
+#include "etcpal/pack.h"
+#include "etcpal_mock/common.h"
+#include "etcpal_mock/socket.h"
+#include "etcpal_mock/timer.h"
+#include "rdmnet/defs.h"
+#include "rdmnet_mock/core/common.h"
+#include "broker_mocks.h"
+#include "test_broker_messages.h"
+
+using testing::_;
+using testing::DoAll;
+using testing::Return;
+using testing::SaveArg;
+
+constexpr size_t kEptVectorOffset = 42;
+constexpr size_t kEptStatusCodeOffset = 65;
+
+class TestBrokerCoreEptHandling : public testing::Test
+{
+protected:
+  BrokerMocks mocks_{BrokerMocks::Nice()};
+  BrokerCore  broker_;
+
+  const etcpal::SockAddr        kDefaultClientAddr{etcpal::IpAddr::FromString("192.168.20.30"), 49000};
+  static constexpr uint16_t     kTestManu{0x6574};
+  static constexpr uint16_t     kTestProtocol{0x0001};
+  static constexpr unsigned int kMaxEptClientMessages{10u};
+
+  // The messages sent on each socket, in order.
+  static std::map<etcpal_socket_t, std::vector<std::vector<uint8_t>>> sent_msgs;
+
+  const std::vector<RdmnetEptSubProtocol> kTestProtocols{{kTestManu, kTestProtocol, "Test Protocol"}};
+  const std::vector<uint8_t>              kTestData{0x01, 0x02, 0x03, 0x04, 0x05};
+
+  void SetUp() override
+  {
+    etcpal_reset_all_fakes();
+    rdmnet_mock_core_reset_and_init();
+    sent_msgs.clear();
+
+    rc_send_fake.custom_fake = [](etcpal_socket_t socket, const void* data, size_t data_size, int) -> int {
+      const uint8_t* bytes = reinterpret_cast<const uint8_t*>(data);
+      sent_msgs[socket].emplace_back(bytes, bytes + data_size);
+      return (int)data_size;
+    };
+
+    auto settings = DefaultBrokerSettings();
+    settings.limits.ept_client_messages = kMaxEptClientMessages;
+    ASSERT_TRUE(StartBroker(broker_, settings, mocks_));
+  }
+
+  BrokerClient::Handle AddEptClient(const etcpal::Uuid& cid, etcpal_socket_t socket);
+  void                 SendAllQueuedMessages();
+
+  static uint32_t RootVector(const std::vector<uint8_t>& msg) { return etcpal_unpack_u32b(&msg[kRootVectorOffset]); }
+  static uint32_t EptVector(const std::vector<uint8_t>& msg) { return etcpal_unpack_u32b(&msg[kEptVectorOffset]); }
+};
+
+std::map<etcpal_socket_t, std::vector<std::vector<uint8_t>>> TestBrokerCoreEptHandling::sent_msgs;
+
+BrokerClient::Handle TestBrokerCoreEptHandling::AddEptClient(const etcpal::Uuid& cid, etcpal_socket_t socket)
+{
+  BrokerClient::Handle new_conn_handle;
+  EXPECT_CALL(*mocks_.socket_mgr, AddSocket(_, socket)).WillOnce(DoAll(SaveArg<0>(&new_conn_handle), Return(true)));
+
+  EXPECT_TRUE(mocks_.broker_callbacks->HandleNewConnection(socket, kDefaultClientAddr));
+
+  RdmnetMessage connect_msg = testmsgs::EptClientConnect(cid, kTestProtocols);
+  mocks_.broker_callbacks->HandleSocketMessageReceived(new_conn_handle, connect_msg);
+  SendAllQueuedMessages();
+  sent_msgs.clear();
+
+  return new_conn_handle;
+}
+
+void TestBrokerCoreEptHandling::SendAllQueuedMessages()
+{
+  static constexpr int kMaxServiceIterations = 100;
+  for (int i = 0; i < kMaxServiceIterations && mocks_.broker_callbacks->ServiceClients(); ++i)
+    ;
+}
+
+TEST_F(TestBrokerCoreEptHandling, ConnectReplySentToEptClient)
+{
+  static constexpr etcpal_socket_t kSocket = (etcpal_socket_t)1;
+
+  BrokerClient::Handle new_conn_handle;
+  EXPECT_CALL(*mocks_.socket_mgr, AddSocket(_, kSocket)).WillOnce(DoAll(SaveArg<0>(&new_conn_handle), Return(true)));
+  EXPECT_TRUE(mocks_.broker_callbacks->HandleNewConnection(kSocket, kDefaultClientAddr));
+
+  RdmnetMessage connect_msg = testmsgs::EptClientConnect(etcpal::Uuid::OsPreferred(), kTestProtocols);
+  mocks_.broker_callbacks->HandleSocketMessageReceived(new_conn_handle, connect_msg);
+  SendAllQueuedMessages();
+
+  ASSERT_EQ(sent_msgs[kSocket].size(), 1u);
+  const auto& reply = sent_msgs[kSocket].front();
+  ASSERT_GT(reply.size(), kConnectReplyCodeOffset + 1);
+  EXPECT_EQ(RootVector(reply), static_cast<uint32_t>(ACN_VECTOR_ROOT_BROKER));
+  EXPECT_EQ(etcpal_unpack_u16b(&reply[kBrokerVectorOffset]), VECTOR_BROKER_CONNECT_REPLY);
+  EXPECT_EQ(etcpal_unpack_u16b(&reply[kConnectReplyCodeOffset]), E133_CONNECT_OK);
+  EXPECT_EQ(broker_.GetNumClients(), 1u);
+}
+
+TEST_F(TestBrokerCoreEptHandling, DataIsRoutedToDestinationCid)
+{
+  static constexpr etcpal_socket_t kSenderSocket = (etcpal_socket_t)1;
+  static constexpr etcpal_socket_t kDestSocket = (etcpal_socket_t)2;
+
+  auto sender_cid = etcpal::Uuid::OsPreferred();
+  auto dest_cid = etcpal::Uuid::OsPreferred();
+  auto sender_handle = AddEptClient(sender_cid, kSenderSocket);
+  AddEptClient(dest_cid, kDestSocket);
+
+  auto data_msg = testmsgs::EptData(sender_cid, dest_cid, kTestManu, kTestProtocol, kTestData);
+  EXPECT_EQ(mocks_.broker_callbacks->HandleSocketMessageReceived(sender_handle, data_msg),
+            HandleMessageResult::kGetNextMessage);
+  SendAllQueuedMessages();
+
+  EXPECT_TRUE(sent_msgs[kSenderSocket].empty());
+  ASSERT_EQ(sent_msgs[kDestSocket].size(), 1u);
+
+  const auto& forwarded = sent_msgs[kDestSocket].front();
+  ASSERT_EQ(forwarded.size(), rc_ept_get_data_buffer_size(kTestData.size()));
+  EXPECT_EQ(RootVector(forwarded), static_cast<uint32_t>(ACN_VECTOR_ROOT_EPT));
+  EXPECT_EQ(EptVector(forwarded), static_cast<uint32_t>(VECTOR_EPT_DATA));
+  // The RLP sender CID is the original sender, not the broker
+  const EtcPalUuid raw_sender_cid = sender_cid.get();
+  EXPECT_TRUE(std::equal(raw_sender_cid.data, raw_sender_cid.data + ETCPAL_UUID_BYTES, &forwarded[23]));
+  EXPECT_TRUE(std::equal(kTestData.begin(), kTestData.end(), forwarded.end() - kTestData.size()));
+}
+
+TEST_F(TestBrokerCoreEptHandling, DataToUnknownCidReturnsUnknownCidStatus)
+{
+  static constexpr etcpal_socket_t kSenderSocket = (etcpal_socket_t)1;
+
+  auto sender_cid = etcpal::Uuid::OsPreferred();
+  auto sender_handle = AddEptClient(sender_cid, kSenderSocket);
+
+  auto data_msg = testmsgs::EptData(sender_cid, etcpal::Uuid::OsPreferred(), kTestManu, kTestProtocol, kTestData);
+  EXPECT_EQ(mocks_.broker_callbacks->HandleSocketMessageReceived(sender_handle, data_msg),
+            HandleMessageResult::kGetNextMessage);
+  SendAllQueuedMessages();
+
+  ASSERT_EQ(sent_msgs[kSenderSocket].size(), 1u);
+  const auto& status = sent_msgs[kSenderSocket].front();
+  ASSERT_GT(status.size(), kEptStatusCodeOffset + 1);
+  EXPECT_EQ(EptVector(status), static_cast<uint32_t>(VECTOR_EPT_STATUS));
+  EXPECT_EQ(etcpal_unpack_u16b(&status[kEptStatusCodeOffset]), VECTOR_EPT_STATUS_UNKNOWN_CID);
+}
+
+TEST_F(TestBrokerCoreEptHandling, DataToClosedClientReturnsUnknownCidStatus)
+{
+  static constexpr etcpal_socket_t kSenderSocket = (etcpal_socket_t)1;
+  static constexpr etcpal_socket_t kDestSocket = (etcpal_socket_t)2;
+
+  auto sender_cid = etcpal::Uuid::OsPreferred();
+  auto dest_cid = etcpal::Uuid::OsPreferred();
+  auto sender_handle = AddEptClient(sender_cid, kSenderSocket);
+  auto dest_handle = AddEptClient(dest_cid, kDestSocket);
+
+  // The closed client is unlinked from routing right away, not when it is destroyed.
+  mocks_.broker_callbacks->HandleSocketClosed(dest_handle, false);
+
+  auto data_msg = testmsgs::EptData(sender_cid, dest_cid, kTestManu, kTestProtocol, kTestData);
+  EXPECT_EQ(mocks_.broker_callbacks->HandleSocketMessageReceived(sender_handle, data_msg),
+            HandleMessageResult::kGetNextMessage);
+  SendAllQueuedMessages();
+
+  // The sender is also told that the client was removed; find the EPT status among its messages.
+  const auto& sender_msgs = sent_msgs[kSenderSocket];
+  auto status = std::find_if(sender_msgs.begin(), sender_msgs.end(), [](const std::vector<uint8_t>& msg) {
+    return RootVector(msg) == static_cast<uint32_t>(ACN_VECTOR_ROOT_EPT);
+  });
+  ASSERT_NE(status, sender_msgs.end());
+  ASSERT_GT(status->size(), kEptStatusCodeOffset + 1);
+  EXPECT_EQ(EptVector(*status), static_cast<uint32_t>(VECTOR_EPT_STATUS));
+  EXPECT_EQ(etcpal_unpack_u16b(&(*status)[kEptStatusCodeOffset]), VECTOR_EPT_STATUS_UNKNOWN_CID);
+  EXPECT_TRUE(sent_msgs[kDestSocket].empty());
+}
+
+TEST_F(TestBrokerCoreEptHandling, DataForUnsupportedProtocolReturnsUnknownVectorStatus)
+{
+  static constexpr etcpal_socket_t kSenderSocket = (etcpal_socket_t)1;
+  static constexpr etcpal_socket_t kDestSocket = (etcpal_socket_t)2;
+
+  auto sender_cid = etcpal::Uuid::OsPreferred();
+  auto dest_cid = etcpal::Uuid::OsPreferred();
+  auto sender_handle = AddEptClient(sender_cid, kSenderSocket);
+  AddEptClient(dest_cid, kDestSocket);
+
+  auto data_msg = testmsgs::EptData(sender_cid, dest_cid, kTestManu, kTestProtocol + 1, kTestData);
+  EXPECT_EQ(mocks_.broker_callbacks->HandleSocketMessageReceived(sender_handle, data_msg),
+            HandleMessageResult::kGetNextMessage);
+  SendAllQueuedMessages();
+
+  EXPECT_TRUE(sent_msgs[kDestSocket].empty());
+  ASSERT_EQ(sent_msgs[kSenderSocket].size(), 1u);
+  const auto& status = sent_msgs[kSenderSocket].front();
+  ASSERT_GT(status.size(), kEptStatusCodeOffset + 1);
+  EXPECT_EQ(EptVector(status), static_cast<uint32_t>(VECTOR_EPT_STATUS));
+  EXPECT_EQ(etcpal_unpack_u16b(&status[kEptStatusCodeOffset]), VECTOR_EPT_STATUS_UNKNOWN_VECTOR);
+}
+
+TEST_F(TestBrokerCoreEptHandling, DataThrottlesAtMaxLimit)
+{
+  static constexpr etcpal_socket_t kSenderSocket = (etcpal_socket_t)1;
+  static constexpr etcpal_socket_t kDestSocket = (etcpal_socket_t)2;
+  static constexpr int             kNumRetriesToTest = 3;
+
+  auto sender_cid = etcpal::Uuid::OsPreferred();
+  auto dest_cid = etcpal::Uuid::OsPreferred();
+  auto sender_handle = AddEptClient(sender_cid, kSenderSocket);
+  AddEptClient(dest_cid, kDestSocket);
+
+  auto data_msg = testmsgs::EptData(sender_cid, dest_cid, kTestManu, kTestProtocol, kTestData);
+  for (unsigned int i = 0u; i < kMaxEptClientMessages; ++i)
+  {
+    EXPECT_EQ(mocks_.broker_callbacks->HandleSocketMessageReceived(sender_handle, data_msg),
+              HandleMessageResult::kGetNextMessage);
+  }
+  for (int i = 0; i < kNumRetriesToTest; ++i)
+  {
+    EXPECT_EQ(mocks_.broker_callbacks->HandleSocketMessageReceived(sender_handle, data_msg),
+              HandleMessageResult::kRetryLater);
+  }
+
+  // Harvesting a message from the destination's queue makes room for one more.
+  EXPECT_TRUE(mocks_.broker_callbacks->ServiceClients());
+  EXPECT_EQ(mocks_.broker_callbacks->HandleSocketMessageReceived(sender_handle, data_msg),
+            HandleMessageResult::kGetNextMessage);
+}
@@ -21,6 +21,7 @@
 
 #include "broker_core.h"
 
+#include <algorithm>
 #include "gmock/gmock.h"
 #include "etcpal_mock/common.h"
 #include "etcpal_mock/socket.h"
@@ -180,3 +181,89 @@ TEST_F(TestBrokerCoreRptHandling, DeviceManuBroadcastThrottlesAtMaxLimit)
 
   testing::Mock::VerifyAndClearExpectations(mocks_.socket_mgr);
 }
+
+TEST_F(TestBrokerCoreRptHandling, DeviceBroadcastReachesDevicesInEveryShard)
+{
+  // Enough devices that every shard of the client registry holds more than one
+  static constexpr int kNumDestinations = 40u;
+
+  for (int i = 0u; i < kNumDestinations; ++i)
+    AddClient(etcpal::Uuid::OsPreferred(), kRPTClientTypeDevice, kTestManu1);
+
+  auto sender_handle = AddClient(etcpal::Uuid::OsPreferred(), kRPTClientTypeController, kTestManu1);
+  EXPECT_EQ(broker_.GetNumClients(), kNumDestinations + 1u);
+
+  auto test_cmd = TestRdmCommand::GetBroadcast(E120_DEVICE_INFO);
+  TestMessageLimitWithHarvest(sender_handle, test_cmd.msg, kMaxDeviceMessages);
+
+  testing::Mock::VerifyAndClearExpectations(mocks_.socket_mgr);
+}
+
+TEST_F(TestBrokerCoreRptHandling, DestroyedDeviceLeavesBroadcastSet)
+{
+  static constexpr int kNumDestinations = 3u;
+
+  BrokerClient::Handle closed_handle = BrokerClient::kInvalidHandle;
+  for (int i = 0u; i < kNumDestinations; ++i)
+    closed_handle = AddClient(etcpal::Uuid::OsPreferred(), kRPTClientTypeDevice, kTestManu1);
+
+  auto sender_handle = AddClient(etcpal::Uuid::OsPreferred(), kRPTClientTypeController, kTestManu1);
+
+  // Let the broker destroy the closed device
+  mocks_.broker_callbacks->HandleSocketClosed(closed_handle, false);
+  etcpal_getms_fake.return_val += 1000;
+  mocks_.broker_callbacks->ServiceClients();
+  EXPECT_EQ(broker_.GetNumClients(), static_cast<size_t>(kNumDestinations));
+
+  auto test_cmd = TestRdmCommand::GetBroadcast(E120_DEVICE_INFO);
+  TestMessageLimitWithHarvest(sender_handle, test_cmd.msg, kMaxDeviceMessages);
+
+  testing::Mock::VerifyAndClearExpectations(mocks_.socket_mgr);
+}
+
+TEST_F(TestBrokerCoreRptHandling, DeviceManuBroadcastTracksDestroyedDevices)
+{
+  AddClient(etcpal::Uuid::OsPreferred(), kRPTClientTypeDevice, kTestManu1);
+  auto manu2_handle = AddClient(etcpal::Uuid::OsPreferred(), kRPTClientTypeDevice, kTestManu2);
+  auto sender_handle = AddClient(etcpal::Uuid::OsPreferred(), kRPTClientTypeController, kTestManu1);
+
+  auto test_manu2_cmd = TestRdmCommand::GetManuBroadcast(kTestManu2, E120_DEVICE_INFO);
+  TestMessageLimit(sender_handle, test_manu2_cmd.msg, kMaxDeviceMessages);
+
+  // Once the only manu2 device is destroyed, manu2 broadcasts have no destinations to wait on
+  mocks_.broker_callbacks->HandleSocketClosed(manu2_handle, false);
+  etcpal_getms_fake.return_val += 1000;
+  mocks_.broker_callbacks->ServiceClients();
+
+  EXPECT_EQ(mocks_.broker_callbacks->HandleSocketMessageReceived(sender_handle, test_manu2_cmd.msg),
+            HandleMessageResult::kGetNextMessage);
+
+  // The manu1 device is unaffected
+  auto test_manu1_cmd = TestRdmCommand::GetManuBroadcast(kTestManu1, E120_DEVICE_INFO);
+  TestMessageLimit(sender_handle, test_manu1_cmd.msg, kMaxDeviceMessages);
+
+  testing::Mock::VerifyAndClearExpectations(mocks_.socket_mgr);
+}
+
+TEST_F(TestBrokerCoreRptHandling, PublishesControllerQueueStats)
+{
+  const auto controller_cid = etcpal::Uuid::OsPreferred();
+  AddClient(controller_cid, kRPTClientTypeController, kTestManu1);
+  auto sender_handle = AddClient(etcpal::Uuid::OsPreferred(), kRPTClientTypeDevice, kTestManu1);
+
+  auto test_response = TestRdmResponse::GetResponseBroadcast(kTestControllerUid, E120_DEVICE_INFO);
+  TestMessageLimit(sender_handle, test_response.msg, kMaxControllerMessages);
+
+  auto stats = broker_.GetClientQueueStats();
+  ASSERT_EQ(stats.size(), 2u);
+
+  auto controller_stats = std::find_if(stats.begin(), stats.end(), [&](const rdmnet::Broker::ClientQueueStats& entry) {
+    return entry.cid == controller_cid;
+  });
+  ASSERT_NE(controller_stats, stats.end());
+  EXPECT_EQ(controller_stats->queued_messages, kMaxControllerMessages);
+  EXPECT_GT(controller_stats->queued_bytes, 0u);
+  EXPECT_GT(controller_stats->queue_full, 0u);
+
+  testing::Mock::VerifyAndClearExpectations(mocks_.socket_mgr);
+}
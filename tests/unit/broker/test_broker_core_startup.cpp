@@ -89,6 +89,14 @@ TEST_F(TestBrokerCoreStartup, DoesNotStartWhenAllListenThreadsFail)
   EXPECT_FALSE(StartBroker(explicit_interfaces));
 }
 
+// When the socket manager can accept connections itself, no listen threads should be started.
+TEST_F(TestBrokerCoreStartup, AcceptsFromSocketManagerWhenSupported)
+{
+  EXPECT_CALL(*mocks_.socket_mgr, AddListenSocket(_)).WillRepeatedly(Return(true));
+  EXPECT_CALL(*mocks_.threads, AddListenThread(_)).Times(0);
+  EXPECT_TRUE(StartBroker(DefaultBrokerSettings()));
+}
+
 // The broker should not start if it cannot start a client service thread.
 TEST_F(TestBrokerCoreStartup, DoesNotStartWhenClientServiceThreadFails)
 {
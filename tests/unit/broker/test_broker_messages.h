@@ -21,6 +21,7 @@
 #define TEST_BROKER_MESSAGES_H_
 
 #include <string>
+#include <vector>
 #include "etcpal/cpp/uuid.h"
 #include "rdm/cpp/uid.h"
 #include "rdmnet/core/message.h"
@@ -105,6 +106,58 @@ inline RdmnetMessage FetchClientList(const etcpal::Uuid& cid)
   return fcl_msg;
 }
 
+// The EPT sub-protocol list referenced by the returned message must outlive it.
+inline RdmnetMessage EptClientConnect(const etcpal::Uuid&                      cid,
+                                      const std::vector<RdmnetEptSubProtocol>& protocols,
+                                      std::string                              scope = E133_DEFAULT_SCOPE)
+{
+  RdmnetMessage connect_msg;
+  connect_msg.vector = ACN_VECTOR_ROOT_BROKER;
+  connect_msg.sender_cid = cid.get();
+
+  BrokerMessage* broker_msg = RDMNET_GET_BROKER_MSG(&connect_msg);
+  broker_msg->vector = VECTOR_BROKER_CONNECT;
+
+  BrokerClientConnectMsg* client_connect = BROKER_GET_CLIENT_CONNECT_MSG(broker_msg);
+  strcpy(client_connect->scope, scope.c_str());
+  client_connect->e133_version = E133_VERSION;
+  strcpy(client_connect->search_domain, E133_DEFAULT_DOMAIN);
+  client_connect->connect_flags = 0;
+
+  client_connect->client_entry.client_protocol = kClientProtocolEPT;
+  RdmnetEptClientEntry* ept_entry = GET_EPT_CLIENT_ENTRY(&client_connect->client_entry);
+  ept_entry->cid = cid.get();
+  ept_entry->protocols = const_cast<RdmnetEptSubProtocol*>(protocols.data());
+  ept_entry->num_protocols = protocols.size();
+
+  return connect_msg;
+}
+
+// The data referenced by the returned message must outlive it.
+inline RdmnetMessage EptData(const etcpal::Uuid&         sender_cid,
+                             const etcpal::Uuid&         dest_cid,
+                             uint16_t                    manufacturer_id,
+                             uint16_t                    protocol_id,
+                             const std::vector<uint8_t>& data)
+{
+  RdmnetMessage ept_msg;
+  ept_msg.vector = ACN_VECTOR_ROOT_EPT;
+  ept_msg.sender_cid = sender_cid.get();
+
+  EptMessage* ept = RDMNET_GET_EPT_MSG(&ept_msg);
+  ept->dest_cid = dest_cid.get();
+  ept->vector = VECTOR_EPT_DATA;
+
+  RdmnetEptData* ept_data = EPT_GET_DATA_MSG(ept);
+  ept_data->source_cid = sender_cid.get();
+  ept_data->manufacturer_id = manufacturer_id;
+  ept_data->protocol_id = protocol_id;
+  ept_data->data = data.data();
+  ept_data->data_len = data.size();
+
+  return ept_msg;
+}
+
 };  // namespace testmsgs
 
 #ifdef _MSC_VER
@@ -20,6 +20,7 @@
 #include "broker_util.h"
 
 #include <limits>
+#include <memory>
 #include "gmock/gmock.h"
 
 // MATCHER_P generates unreferenced formal parameter warnings for the hidden result_listener
@@ -66,6 +67,140 @@ TEST(TestClientHandleGenerator, SkipsHandlesInUse)
   EXPECT_EQ(generator.GetClientHandle(), 1);
 }
 
+TEST(TestTokenBucket, ZeroRateIsUnlimited)
+{
+  TokenBucket bucket;
+  for (int i = 0; i < 1000; ++i)
+    EXPECT_EQ(bucket.Borrow(0), 0u);
+}
+
+TEST(TestTokenBucket, AllowsBurstThenSchedulesAtRate)
+{
+  TokenBucket bucket;
+  bucket.SetRate(100, 5, 0);
+
+  // The bucket starts full
+  for (int i = 0; i < 5; ++i)
+    EXPECT_EQ(bucket.Borrow(0), 0u);
+
+  // One token accrues every 10 ms
+  EXPECT_EQ(bucket.Borrow(0), 10u);
+  EXPECT_EQ(bucket.Borrow(0), 20u);
+  EXPECT_EQ(bucket.Borrow(15), 15u);
+
+  // Tokens don't accrue past the bucket's depth
+  for (int i = 0; i < 5; ++i)
+    EXPECT_EQ(bucket.Borrow(10000), 0u);
+  EXPECT_EQ(bucket.Borrow(10000), 10u);
+}
+
+TEST(TestTokenBucket, HandlesClockWraparound)
+{
+  const uint32_t kStart = std::numeric_limits<uint32_t>::max() - 5;
+
+  TokenBucket bucket;
+  bucket.SetRate(1000, 1, kStart);
+  EXPECT_EQ(bucket.Borrow(kStart), 0u);
+  EXPECT_EQ(bucket.Borrow(kStart + 10), 0u);
+}
+
+class TestConnectAdmission : public testing::Test
+{
+protected:
+  ConnectAdmission admission_;
+
+  void SetUp() override { admission_.SetRate(10, 1, 0); }
+
+  static etcpal::Uuid Cid(uint8_t n)
+  {
+    EtcPalUuid cid{};
+    cid.data[15] = n;
+    return cid;
+  }
+};
+
+TEST_F(TestConnectAdmission, HoldsShortWaitsAndHintsLongOnes)
+{
+  EXPECT_EQ(admission_.Admit(Cid(0), 0).decision, ConnectAdmission::Decision::kAdmit);
+
+  // Slots are given out every 100 ms
+  for (uint8_t i = 1; i <= 5; ++i)
+    EXPECT_EQ(admission_.Admit(Cid(i), 0).decision, ConnectAdmission::Decision::kHold);
+
+  auto result = admission_.Admit(Cid(6), 0);
+  EXPECT_EQ(result.decision, ConnectAdmission::Decision::kRetryAfter);
+  EXPECT_EQ(result.retry_after_ms, 600u);
+}
+
+TEST_F(TestConnectAdmission, ReturningClientKeepsItsSlot)
+{
+  EXPECT_EQ(admission_.Admit(Cid(0), 0).decision, ConnectAdmission::Decision::kAdmit);
+  for (uint8_t i = 1; i <= 9; ++i)
+    admission_.Admit(Cid(i), 0);
+
+  // The last client was given a slot at 900 ms; coming back early doesn't move it back.
+  auto result = admission_.Admit(Cid(9), 200);
+  EXPECT_EQ(result.decision, ConnectAdmission::Decision::kRetryAfter);
+  EXPECT_EQ(result.retry_after_ms, 700u);
+  EXPECT_EQ(admission_.Admit(Cid(9), 450).decision, ConnectAdmission::Decision::kHold);
+
+  // At its slot, it's admitted without taking a newcomer's token.
+  EXPECT_EQ(admission_.Admit(Cid(9), 900).decision, ConnectAdmission::Decision::kAdmit);
+  EXPECT_EQ(admission_.Admit(Cid(10), 900).retry_after_ms, 100u);
+}
+
+TEST_F(TestConnectAdmission, ForgetsAbandonedReservations)
+{
+  admission_.Admit(Cid(0), 0);
+  admission_.Admit(Cid(1), 0);
+  EXPECT_EQ(admission_.num_reservations(), 1u);
+
+  admission_.Admit(Cid(2), 100 + ConnectAdmission::kReservationGraceMs + 1);
+  EXPECT_EQ(admission_.num_reservations(), 0u);
+}
+
+TEST(TestClientPool, ReusesBlocksOfDestroyedClients)
+{
+  auto pool = std::make_shared<ClientPool>();
+
+  auto  client = MakePooledClient<BrokerClient>(pool, 1, ETCPAL_SOCKET_INVALID);
+  void* first_block = client.get();
+  client.reset();
+  EXPECT_EQ(pool->num_free_blocks(), 1u);
+
+  client = MakePooledClient<BrokerClient>(pool, 2, ETCPAL_SOCKET_INVALID);
+  EXPECT_EQ(client.get(), first_block);
+  EXPECT_EQ(client->handle_, 2);
+  EXPECT_EQ(pool->num_free_blocks(), 0u);
+}
+
+TEST(TestClientPool, KeepsBlocksOfEachClientTypeSeparate)
+{
+  auto pool = std::make_shared<ClientPool>();
+
+  MakePooledClient<BrokerClient>(pool, 1, ETCPAL_SOCKET_INVALID).reset();
+  EXPECT_EQ(pool->num_free_blocks(), 1u);
+
+  // A pending client's block is too small for a device.
+  RdmnetRptClientEntry entry{};
+  entry.type = kRPTClientTypeDevice;
+  auto device = MakePooledClient<RPTDevice>(pool, 0, entry, BrokerClient(1, ETCPAL_SOCKET_INVALID));
+  EXPECT_EQ(pool->num_free_blocks(), 1u);
+}
+
+TEST(TestClientPool, OutlivedByItsClients)
+{
+  auto                      pool = std::make_shared<ClientPool>();
+  std::weak_ptr<ClientPool> weak_pool = pool;
+
+  auto client = MakePooledClient<BrokerClient>(pool, 1, ETCPAL_SOCKET_INVALID);
+  pool.reset();
+  EXPECT_FALSE(weak_pool.expired());
+
+  client.reset();
+  EXPECT_TRUE(weak_pool.expired());
+}
+
 // class MockBrokerClient : public BrokerClient
 // {
 // public:
@@ -0,0 +1,485 @@
+/******************************************************************************
+ * Copyright 2020 ETC Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ ******************************************************************************
+ * This file is a part of RDMnet. For more information, go to:
+ * https://github.com/ETCLabs/RDMnet
+ *****************************************************************************/
+
+// Tests for the io_uring socket manager. These use real sockets and a real io_uring, and are
+// skipped when the running kernel doesn't support the features the socket manager needs.
+
+#include "linux/linux_uring_socket_manager.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <condition_variable>
+#include <cstring>
+#include <map>
+#include <mutex>
+#include <random>
+#include <set>
+#include <thread>
+#include <utility>
+#include <vector>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include "gmock/gmock.h"
+#include "etcpal_mock/timer.h"
+#include "rdmnet_mock/core/common.h"
+#include "rdmnet/core/broker_prot.h"
+#include "linux/linux_socket_manager.h"
+
+// io_uring_queue_init_params() is wrapped at link time (see CMakeLists.txt), so that the tests can
+// make ring setup fail the way it does on kernels without io_uring.
+static bool fail_ring_setup;
+
+extern "C" int __real_io_uring_queue_init_params(unsigned entries, struct io_uring* ring, struct io_uring_params* p);
+
+extern "C" int __wrap_io_uring_queue_init_params(unsigned entries, struct io_uring* ring, struct io_uring_params* p)
+{
+  if (fail_ring_setup)
+    return -ENOSYS;
+  return __real_io_uring_queue_init_params(entries, ring, p);
+}
+
+namespace
+{
+constexpr auto kWaitTime = std::chrono::seconds(5);
+
+// The sender CID of each test message identifies the connection it was sent on and its place in
+// that connection's sequence.
+EtcPalUuid MakeTestCid(uint8_t connection, uint32_t sequence)
+{
+  EtcPalUuid cid{};
+  cid.data[0] = connection;
+  memcpy(&cid.data[1], &sequence, sizeof sequence);
+  return cid;
+}
+
+std::vector<uint8_t> PackNullMessages(uint8_t connection, uint32_t first_sequence, uint32_t num_messages)
+{
+  std::vector<uint8_t> data(BROKER_NULL_FULL_MSG_SIZE * num_messages);
+  for (uint32_t i = 0; i < num_messages; ++i)
+  {
+    EtcPalUuid cid = MakeTestCid(connection, first_sequence + i);
+    rc_broker_pack_null(&data[i * BROKER_NULL_FULL_MSG_SIZE], BROKER_NULL_FULL_MSG_SIZE, &cid);
+  }
+  return data;
+}
+
+// Read what is available on a socket into data, waiting briefly for it. Returns false once the
+// remote end has closed the connection.
+bool ReadAvailable(int sock, std::vector<uint8_t>& data)
+{
+  struct pollfd pfd;
+  pfd.fd = sock;
+  pfd.events = POLLIN;
+  pfd.revents = 0;
+  if (poll(&pfd, 1, 10) <= 0)
+    return true;
+
+  uint8_t buf[4096];
+  while (true)
+  {
+    ssize_t res = recv(sock, buf, sizeof buf, MSG_DONTWAIT);
+    if (res > 0)
+      data.insert(data.end(), buf, buf + res);
+    else if (res == 0)
+      return false;
+    else
+      return true;
+  }
+}
+
+struct ReceivedMessage
+{
+  BrokerClient::Handle handle;
+  uint8_t              connection;
+  uint32_t             sequence;
+
+  bool operator==(const ReceivedMessage& other) const
+  {
+    return handle == other.handle && connection == other.connection && sequence == other.sequence;
+  }
+};
+
+class TestSocketNotify : public BrokerSocketNotify
+{
+public:
+  // Called on the socket manager's worker thread
+  HandleMessageResult HandleSocketMessageReceived(BrokerClient::Handle handle, const RdmnetMessage& message) override
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    ReceivedMessage received{handle, message.sender_cid.data[0], 0};
+    memcpy(&received.sequence, &message.sender_cid.data[1], sizeof received.sequence);
+
+    ++num_attempts_[received.sequence];
+    if (held_.count(handle) != 0)
+      return HandleMessageResult::kRetryLater;
+
+    messages_.push_back(received);
+    cond_.notify_all();
+    return HandleMessageResult::kGetNextMessage;
+  }
+
+  void HandleSocketClosed(BrokerClient::Handle handle, bool graceful) override
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    closed_.push_back(std::make_pair(handle, graceful));
+    cond_.notify_all();
+  }
+
+  bool HandleNewConnection(etcpal_socket_t /*new_sock*/, const etcpal::SockAddr& /*remote_addr*/) override
+  {
+    return false;
+  }
+
+  void Hold(BrokerClient::Handle handle)
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    held_.insert(handle);
+  }
+
+  void Release(BrokerClient::Handle handle)
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    held_.erase(handle);
+  }
+
+  bool WaitForMessages(size_t num_messages)
+  {
+    std::unique_lock<std::mutex> lock(mutex_);
+    return cond_.wait_for(lock, kWaitTime, [&] { return messages_.size() >= num_messages; });
+  }
+
+  bool WaitForClosed(size_t num_closed)
+  {
+    std::unique_lock<std::mutex> lock(mutex_);
+    return cond_.wait_for(lock, kWaitTime, [&] { return closed_.size() >= num_closed; });
+  }
+
+  std::vector<ReceivedMessage> Messages()
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return messages_;
+  }
+
+  unsigned int NumAttempts(uint32_t sequence)
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return num_attempts_[sequence];
+  }
+
+  std::vector<std::pair<BrokerClient::Handle, bool>> Closed()
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return closed_;
+  }
+
+private:
+  std::mutex              mutex_;
+  std::condition_variable cond_;
+
+  std::set<BrokerClient::Handle>                     held_;
+  std::map<uint32_t, unsigned int>                   num_attempts_;
+  std::vector<ReceivedMessage>                       messages_;
+  std::vector<std::pair<BrokerClient::Handle, bool>> closed_;
+};
+}  // namespace
+
+class TestLinuxUringSocketManager : public testing::Test
+{
+protected:
+  static constexpr BrokerClient::Handle kHandle1 = 1;
+  static constexpr BrokerClient::Handle kHandle2 = 2;
+
+  TestSocketNotify              notify_;
+  LinuxUringBrokerSocketManager socket_mgr_;
+  std::vector<int>              peers_;
+
+  void SetUp() override
+  {
+    fail_ring_setup = false;
+    etcpal_timer_reset_all_fakes();
+    rdmnet_mock_core_reset();
+
+    if (!LinuxUringBrokerSocketManager::KernelSupported())
+      GTEST_SKIP() << "The running kernel doesn't support the io_uring features used by the Broker.";
+
+    socket_mgr_.SetNotify(&notify_);
+    ASSERT_TRUE(socket_mgr_.Startup());
+  }
+
+  void TearDown() override
+  {
+    socket_mgr_.Shutdown();
+    for (int peer : peers_)
+      close(peer);
+  }
+
+  // Add one end of a new connection to the socket manager, returning it; the other end is kept in
+  // peers_.
+  int AddConnection(BrokerClient::Handle handle)
+  {
+    int sv[2];
+    EXPECT_EQ(socketpair(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0, sv), 0);
+    EXPECT_TRUE(socket_mgr_.AddSocket(handle, sv[0]));
+    peers_.push_back(sv[1]);
+    return sv[0];
+  }
+
+  // Queue data with SendOnSocket(), flushing while the socket's queue is full.
+  void QueueSend(BrokerClient::Handle handle, int sock, int peer, const uint8_t* data, size_t size,
+                 std::vector<uint8_t>& received)
+  {
+    size_t offset = 0;
+    while (offset < size)
+    {
+      int res = socket_mgr_.SendOnSocket(handle, sock, &data[offset], size - offset);
+      if (res == kEtcPalErrWouldBlock)
+      {
+        socket_mgr_.FlushSends();
+        ReadAvailable(peer, received);
+        continue;
+      }
+      ASSERT_GT(res, 0);
+      offset += static_cast<size_t>(res);
+    }
+  }
+};
+
+TEST_F(TestLinuxUringSocketManager, ReceivesMessagesInOrder)
+{
+  AddConnection(kHandle1);
+  AddConnection(kHandle2);
+
+  // Enough messages to span several receive buffers, written in pieces that split messages
+  auto data1 = PackNullMessages(1, 0, 500);
+  auto data2 = PackNullMessages(2, 0, 500);
+  for (size_t offset = 0; offset < data1.size(); offset += 1000)
+  {
+    size_t size = std::min<size_t>(1000, data1.size() - offset);
+    ASSERT_EQ(write(peers_[0], &data1[offset], size), static_cast<ssize_t>(size));
+    ASSERT_EQ(write(peers_[1], &data2[offset], size), static_cast<ssize_t>(size));
+  }
+
+  ASSERT_TRUE(notify_.WaitForMessages(1000));
+
+  std::vector<ReceivedMessage> expected1;
+  std::vector<ReceivedMessage> expected2;
+  for (uint32_t i = 0; i < 500; ++i)
+  {
+    expected1.push_back(ReceivedMessage{kHandle1, 1, i});
+    expected2.push_back(ReceivedMessage{kHandle2, 2, i});
+  }
+
+  std::vector<ReceivedMessage> received1;
+  std::vector<ReceivedMessage> received2;
+  for (const auto& message : notify_.Messages())
+    (message.handle == kHandle1 ? received1 : received2).push_back(message);
+  EXPECT_EQ(received1, expected1);
+  EXPECT_EQ(received2, expected2);
+}
+
+TEST_F(TestLinuxUringSocketManager, ReportsRemoteClose)
+{
+  AddConnection(kHandle1);
+
+  close(peers_[0]);
+  peers_.clear();
+
+  ASSERT_TRUE(notify_.WaitForClosed(1));
+  ASSERT_EQ(notify_.Closed().size(), 1u);
+  EXPECT_EQ(notify_.Closed()[0].first, kHandle1);
+  EXPECT_TRUE(notify_.Closed()[0].second);
+}
+
+TEST_F(TestLinuxUringSocketManager, DeferredMessageIsRetriedWithoutHoldingUpOtherSockets)
+{
+  AddConnection(kHandle1);
+  AddConnection(kHandle2);
+
+  // The messages on the first connection are handed back until it's released.
+  notify_.Hold(kHandle1);
+  auto data1 = PackNullMessages(1, 0, 10);
+  ASSERT_EQ(write(peers_[0], data1.data(), data1.size()), static_cast<ssize_t>(data1.size()));
+
+  // The second connection carries on meanwhile.
+  auto data2 = PackNullMessages(2, 100, 10);
+  ASSERT_EQ(write(peers_[1], data2.data(), data2.size()), static_cast<ssize_t>(data2.size()));
+  ASSERT_TRUE(notify_.WaitForMessages(10));
+
+  // Wait for the first message to be retried a few times.
+  auto deadline = std::chrono::steady_clock::now() + kWaitTime;
+  while (notify_.NumAttempts(0) < 3 && std::chrono::steady_clock::now() < deadline)
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  EXPECT_GE(notify_.NumAttempts(0), 3u);
+
+  // Only the first message is tried while it's deferred.
+  EXPECT_EQ(notify_.NumAttempts(1), 0u);
+  for (const auto& message : notify_.Messages())
+    EXPECT_EQ(message.handle, kHandle2);
+
+  // More data arriving for the held connection is queued behind the deferred message.
+  auto more_data1 = PackNullMessages(1, 10, 10);
+  ASSERT_EQ(write(peers_[0], more_data1.data(), more_data1.size()), static_cast<ssize_t>(more_data1.size()));
+
+  notify_.Release(kHandle1);
+  ASSERT_TRUE(notify_.WaitForMessages(30));
+
+  std::vector<ReceivedMessage> expected1;
+  for (uint32_t i = 0; i < 20; ++i)
+    expected1.push_back(ReceivedMessage{kHandle1, 1, i});
+
+  std::vector<ReceivedMessage> received1;
+  for (const auto& message : notify_.Messages())
+  {
+    if (message.handle == kHandle1)
+      received1.push_back(message);
+  }
+  EXPECT_EQ(received1, expected1);
+}
+
+TEST_F(TestLinuxUringSocketManager, SendsInOrderAcrossFlushes)
+{
+  int sock = AddConnection(kHandle1);
+  int peer = peers_[0];
+
+  std::minstd_rand     rand(1234);
+  std::vector<uint8_t> sent;
+  std::vector<uint8_t> received;
+
+  // Pieces of varying sizes, so that they share and straddle the send slots, flushed every few
+  // pieces while the peer reads.
+  for (int i = 0; i < 200; ++i)
+  {
+    std::vector<uint8_t> piece(1 + (rand() % 3000));
+    for (auto& byte : piece)
+      byte = static_cast<uint8_t>(rand());
+    sent.insert(sent.end(), piece.begin(), piece.end());
+
+    QueueSend(kHandle1, sock, peer, piece.data(), piece.size(), received);
+    if (i % 3 == 0)
+    {
+      socket_mgr_.FlushSends();
+      ReadAvailable(peer, received);
+    }
+  }
+
+  auto deadline = std::chrono::steady_clock::now() + kWaitTime;
+  while (received.size() < sent.size() && std::chrono::steady_clock::now() < deadline)
+  {
+    socket_mgr_.FlushSends();
+    ReadAvailable(peer, received);
+  }
+  EXPECT_EQ(received, sent);
+}
+
+TEST_F(TestLinuxUringSocketManager, RemovedSocketIsClosedAfterQueuedSendsDrain)
+{
+  // The time doesn't move, so the removed socket's send deadline can't pass.
+  etcpal_getms_fake.return_val = 0;
+
+  int sock = AddConnection(kHandle1);
+  int peer = peers_[0];
+
+  std::vector<uint8_t> sent(32 * 1024);
+  for (size_t i = 0; i < sent.size(); ++i)
+    sent[i] = static_cast<uint8_t>(i * 7);
+
+  std::vector<uint8_t> received;
+  QueueSend(kHandle1, sock, peer, sent.data(), sent.size(), received);
+
+  // Nothing has been flushed, so the socket has to be left open for the queued data.
+  socket_mgr_.RemoveSocket(kHandle1);
+  EXPECT_TRUE(ReadAvailable(peer, received));
+  EXPECT_TRUE(received.empty());
+
+  // Nothing more can be queued for the removed socket.
+  EXPECT_EQ(socket_mgr_.SendOnSocket(kHandle1, sock, sent.data(), 10), kEtcPalErrConnClosed);
+
+  // The peer gets all of the data, then the end of the connection.
+  bool open = true;
+  auto deadline = std::chrono::steady_clock::now() + kWaitTime;
+  while (open && std::chrono::steady_clock::now() < deadline)
+  {
+    socket_mgr_.FlushSends();
+    open = ReadAvailable(peer, received);
+  }
+  EXPECT_FALSE(open);
+  EXPECT_EQ(received, sent);
+
+  // A removed socket isn't reported as closed.
+  EXPECT_TRUE(notify_.Closed().empty());
+}
+
+TEST_F(TestLinuxUringSocketManager, ShutdownSendsQueuedData)
+{
+  int sock = AddConnection(kHandle1);
+  int peer = peers_[0];
+
+  std::vector<uint8_t> sent(8 * 1024, 0x5a);
+  std::vector<uint8_t> received;
+  QueueSend(kHandle1, sock, peer, sent.data(), sent.size(), received);
+
+  EXPECT_TRUE(socket_mgr_.Shutdown());
+
+  bool open = true;
+  auto deadline = std::chrono::steady_clock::now() + kWaitTime;
+  while (open && std::chrono::steady_clock::now() < deadline)
+    open = ReadAvailable(peer, received);
+  EXPECT_FALSE(open);
+  EXPECT_EQ(received, sent);
+}
+
+// Without a kernel that supports io_uring, the Broker uses the epoll socket manager.
+class TestLinuxUringFallback : public testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    fail_ring_setup = true;
+    rdmnet_mock_core_reset();
+  }
+
+  void TearDown() override { fail_ring_setup = false; }
+};
+
+TEST_F(TestLinuxUringFallback, CreatesEpollSocketManager)
+{
+  EXPECT_FALSE(LinuxUringBrokerSocketManager::KernelSupported());
+
+  auto socket_mgr = CreateBrokerSocketManager();
+  ASSERT_NE(socket_mgr, nullptr);
+  EXPECT_NE(dynamic_cast<LinuxBrokerSocketManager*>(socket_mgr.get()), nullptr);
+  EXPECT_EQ(dynamic_cast<LinuxUringBrokerSocketManager*>(socket_mgr.get()), nullptr);
+}
+
+TEST_F(TestLinuxUringFallback, SendsDirectlyWhenStartupFails)
+{
+  static constexpr BrokerClient::Handle kHandle = 1;
+
+  LinuxUringBrokerSocketManager socket_mgr;
+  EXPECT_FALSE(socket_mgr.Startup());
+
+  const uint8_t data[] = {1, 2, 3, 4, 5};
+  rc_send_fake.return_val = sizeof data;
+  EXPECT_EQ(socket_mgr.SendOnSocket(kHandle, 0, data, sizeof data), static_cast<int>(sizeof data));
+  EXPECT_EQ(rc_send_fake.call_count, 1u);
+  EXPECT_FALSE(socket_mgr.FlushSends());
+}
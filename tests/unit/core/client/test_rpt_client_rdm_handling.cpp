@@ -387,6 +387,50 @@ TEST_F(TestRptClientRdmHandling, AppendsSplitIntoSecondResponse)
     EXPECT_NE(params_found.find(param), params_found.end()) << "Parameter value: " << param;
 }
 
+TEST_F(TestRptClientRdmHandling, SupportedParamsTrackAppChanges)
+{
+  auto get_params_sent = []() {
+    std::vector<uint16_t> params;
+    for (auto buf_iter = last_sent_buf_list.begin() + 1; buf_iter != last_sent_buf_list.end(); ++buf_iter)
+    {
+      const RdmBuffer& response = *buf_iter;
+      uint8_t          pdl = response.data[RDM_OFFSET_PARAM_DATA_LEN];
+      for (const uint8_t* cur_ptr = &response.data[RDM_OFFSET_PARAM_DATA];
+           cur_ptr < &response.data[RDM_OFFSET_PARAM_DATA] + pdl; cur_ptr += 2)
+      {
+        params.push_back(etcpal_unpack_u16b(cur_ptr));
+      }
+    }
+    return params;
+  };
+
+  uint8_t data_buf[4];
+  etcpal_pack_u16b(&data_buf[0], E120_DEVICE_INFO);
+  etcpal_pack_u16b(&data_buf[2], 0x8001);
+
+  ASSERT_EQ(rc_client_send_rdm_ack(&client_, scope_handle_, &kGetSupportedParamsSavedCmd, data_buf, 2), kEtcPalErrOk);
+  auto first_params = get_params_sent();
+  EXPECT_EQ(first_params.size(), kSupportedParamsAll.size() + 1);
+
+  // The same application PID list should produce the same response.
+  ASSERT_EQ(rc_client_send_rdm_ack(&client_, scope_handle_, &kGetSupportedParamsSavedCmd, data_buf, 2), kEtcPalErrOk);
+  EXPECT_EQ(get_params_sent(), first_params);
+
+  // A changed application PID list should be picked up on the next response.
+  ASSERT_EQ(rc_client_send_rdm_ack(&client_, scope_handle_, &kGetSupportedParamsSavedCmd, data_buf, 4), kEtcPalErrOk);
+  auto second_params = get_params_sent();
+
+  std::set<uint16_t> params_found(second_params.begin(), second_params.end());
+  EXPECT_EQ(params_found.size(), second_params.size());
+  EXPECT_EQ(params_found.size(), kSupportedParamsAll.size() + 2);
+  EXPECT_NE(params_found.find(E120_DEVICE_INFO), params_found.end());
+  EXPECT_NE(params_found.find(0x8001), params_found.end());
+  for (const auto& param : kSupportedParamsAll)
+    EXPECT_NE(params_found.find(param), params_found.end()) << "Parameter value: " << param;
+
+  EXPECT_EQ(rc_rpt_send_notification_fake.call_count, 3u);
+}
+
 TEST_F(TestRptClientRdmHandling, ParsesNotificationWithCommand)
 {
   static constexpr char kDeviceLabel[] = "Test Device";
@@ -419,6 +463,10 @@ TEST_F(TestRptClientRdmHandling, ParsesNotificationWithCommand)
     EXPECT_EQ(resp->rdm_header.param_id, E120_DEVICE_LABEL);
     EXPECT_EQ(resp->rdm_data_len, sizeof(kDeviceLabel) - 1);
     EXPECT_EQ(std::memcmp(resp->rdm_data, kDeviceLabel, sizeof(kDeviceLabel) - 1), 0);
+
+    // A single-fragment response is delivered in place
+    ASSERT_EQ(resp->num_rdm_fragments, 1u);
+    EXPECT_EQ(resp->rdm_data, &resp->rdm_fragments[0].data[RDM_OFFSET_PARAM_DATA]);
   };
   last_conn->callbacks.message_received(last_conn, &test_resp.msg);
   EXPECT_EQ(rc_client_rpt_msg_received_fake.call_count, 1u);
@@ -503,6 +551,22 @@ TEST_F(TestRptClientRdmHandling, ParsesOverflowNotificationWithCommand)
     EXPECT_EQ(resp->rdm_header.param_id, E137_7_ENDPOINT_RESPONDERS);
     EXPECT_EQ(resp->rdm_data_len, kEndpointRespondersResponse.size());
     EXPECT_EQ(std::memcmp(resp->rdm_data, kEndpointRespondersResponse.data(), kEndpointRespondersResponse.size()), 0);
+
+    // The fragments reference the received responses in place, without the command
+    ASSERT_NE(resp->rdm_fragments, nullptr);
+    EXPECT_EQ(resp->num_rdm_fragments, 2u);
+    RdmnetRdmFragmentIter iter;
+    rdmnet_rdm_response_fragments_begin(resp, &iter);
+    const uint8_t* fragment;
+    size_t         fragment_len;
+    size_t         offset = 0;
+    while (rdmnet_rdm_response_next_fragment(&iter, &fragment, &fragment_len))
+    {
+      ASSERT_LE(offset + fragment_len, kEndpointRespondersResponse.size());
+      EXPECT_EQ(std::memcmp(fragment, &kEndpointRespondersResponse[offset], fragment_len), 0);
+      offset += fragment_len;
+    }
+    EXPECT_EQ(offset, kEndpointRespondersResponse.size());
   };
   last_conn->callbacks.message_received(last_conn, &test_resp.msg);
   EXPECT_EQ(rc_client_rpt_msg_received_fake.call_count, 1u);
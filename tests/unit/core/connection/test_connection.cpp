@@ -19,6 +19,7 @@
 
 #include <array>
 #include <cstring>
+#include <vector>
 #include "etcpal/common.h"
 #include "etcpal/cpp/uuid.h"
 #include "etcpal/cpp/inet.h"
@@ -273,6 +274,38 @@ TEST_F(TestConnection, ReportsConnectionCorrectly)
   EXPECT_EQ(conncb_connected_fake.call_count, 1u);
 }
 
+TEST_F(TestConnection, HonorsBrokerRetryHint)
+{
+  ASSERT_EQ(kEtcPalErrOk, rc_conn_connect(&conn_, &kTestRemoteAddrV4.get(), &connect_msg_));
+  PassTimeAndTick();
+
+  ASSERT_NE(conn_poll_info.callback, nullptr);
+
+  EtcPalPollEvent event;
+  event.events = ETCPAL_POLL_CONNECT;
+  event.socket = kFakeSocket;
+  conn_poll_info.callback(&event, conn_poll_info.data);
+
+  // The broker is busy and asks us to reconnect later than any random backoff would.
+  SetValidConnectReply(conn_.recv_buf.msg);
+  BrokerConnectReplyMsg* conn_reply = BROKER_GET_CONNECT_REPLY_MSG(RDMNET_GET_BROKER_MSG(&conn_.recv_buf.msg));
+  conn_reply->connect_status = kRdmnetConnectCapacityExceeded;
+  BROKER_CONNECT_REPLY_SET_RETRY_AFTER(conn_reply, 12500);
+
+  QueueUpReceives(1u, 1u);
+  event.events = ETCPAL_POLL_IN;
+  conn_poll_info.callback(&event, conn_poll_info.data);
+  ASSERT_EQ(conncb_connect_failed_fake.call_count, 1u);
+
+  ASSERT_EQ(kEtcPalErrOk, rc_conn_connect(&conn_, &kTestRemoteAddrV4.get(), &connect_msg_));
+  PassTimeAndTick(0);
+  PassTimeAndTick(12000);
+  EXPECT_EQ(etcpal_connect_fake.call_count, 1u);
+
+  PassTimeAndTick(1000);
+  EXPECT_EQ(etcpal_connect_fake.call_count, 2u);
+}
+
 TEST_F(TestConnection, DestroyedCalledOnUnregister)
 {
   rc_conn_unregister(&conn_, nullptr);
@@ -308,6 +341,128 @@ TEST_F(TestConnection, HandlesTimeoutAfterTcpEstablished)
   EXPECT_EQ(conncb_connect_failed_fake.call_count, 1u);
 }
 
+class TestParallelConnection : public TestConnection
+{
+protected:
+  // Each attempt gets its own socket; these track the sockets and poll info in the order created.
+  static std::vector<etcpal_socket_t>    attempt_sockets;
+  static std::vector<RCPolledSocketInfo> attempt_poll_infos;
+
+  std::array<EtcPalSockAddr, 3> remote_addrs_{{kTestRemoteAddrV4.get(), kTestRemoteAddrV6.get(),
+                                               etcpal::SockAddr(etcpal::IpAddr::FromString("10.101.1.2"), 8888).get()}};
+
+  void SetUp() override
+  {
+    TestConnection::SetUp();
+
+    attempt_sockets.clear();
+    attempt_poll_infos.clear();
+    etcpal_socket_fake.custom_fake = [](unsigned int, unsigned int, etcpal_socket_t* socket) {
+      *socket = static_cast<etcpal_socket_t>(attempt_sockets.size() + 1);
+      attempt_sockets.push_back(*socket);
+      return kEtcPalErrOk;
+    };
+    rc_add_polled_socket_fake.custom_fake = [](etcpal_socket_t, etcpal_poll_events_t, RCPolledSocketInfo* info) {
+      attempt_poll_infos.push_back(*info);
+      return kEtcPalErrOk;
+    };
+
+    ASSERT_EQ(kEtcPalErrOk,
+              rc_conn_connect_parallel(&conn_, remote_addrs_.data(), remote_addrs_.size(), &connect_msg_));
+  }
+
+  void SendAttemptEvent(size_t index, etcpal_poll_events_t events, etcpal_error_t err = kEtcPalErrOk)
+  {
+    EtcPalPollEvent event;
+    event.events = events;
+    event.err = err;
+    event.socket = attempt_sockets.at(index);
+    attempt_poll_infos.at(index).callback(&event, attempt_poll_infos.at(index).data);
+  }
+};
+
+std::vector<etcpal_socket_t>    TestParallelConnection::attempt_sockets;
+std::vector<RCPolledSocketInfo> TestParallelConnection::attempt_poll_infos;
+
+TEST_F(TestParallelConnection, StaggersAttempts)
+{
+  PassTimeAndTick();
+  EXPECT_EQ(etcpal_connect_fake.call_count, 1u);
+  EXPECT_EQ(etcpal_socket_fake.arg0_history[0], ETCPAL_AF_INET);
+
+  PassTimeAndTick(RDMNET_CONN_PARALLEL_CONNECT_DELAY_MS / 2);
+  EXPECT_EQ(etcpal_connect_fake.call_count, 1u);
+
+  PassTimeAndTick(RDMNET_CONN_PARALLEL_CONNECT_DELAY_MS);
+  EXPECT_EQ(etcpal_connect_fake.call_count, 2u);
+  EXPECT_EQ(etcpal_socket_fake.arg0_history[1], ETCPAL_AF_INET6);
+
+  PassTimeAndTick(RDMNET_CONN_PARALLEL_CONNECT_DELAY_MS + 100);
+  EXPECT_EQ(etcpal_connect_fake.call_count, 3u);
+
+  // Nothing more to start
+  PassTimeAndTick(RDMNET_CONN_PARALLEL_CONNECT_DELAY_MS + 100);
+  EXPECT_EQ(etcpal_connect_fake.call_count, 3u);
+}
+
+TEST_F(TestParallelConnection, KeepsFirstToConnect)
+{
+  PassTimeAndTick();
+  PassTimeAndTick(RDMNET_CONN_PARALLEL_CONNECT_DELAY_MS + 100);
+  ASSERT_EQ(attempt_poll_infos.size(), 2u);
+
+  SendAttemptEvent(1, ETCPAL_POLL_CONNECT);
+
+  // The other attempt is closed and the RDMnet handshake goes out on the winner.
+  EXPECT_EQ(etcpal_close_fake.call_count, 1u);
+  EXPECT_EQ(etcpal_close_fake.arg0_val, attempt_sockets[0]);
+  EXPECT_EQ(rc_broker_send_client_connect_fake.call_count, 1u);
+  EXPECT_EQ(rc_modify_polled_socket_fake.arg0_val, attempt_sockets[1]);
+  EXPECT_EQ(rc_modify_polled_socket_fake.arg2_val, &conn_.poll_info);
+  EXPECT_EQ(conn_.remote_addr, kTestRemoteAddrV6);
+
+  // No further attempts are started
+  PassTimeAndTick(RDMNET_CONN_PARALLEL_CONNECT_DELAY_MS + 100);
+  EXPECT_EQ(etcpal_connect_fake.call_count, 2u);
+
+  SetValidConnectReply(conn_.recv_buf.msg);
+  QueueUpReceives(1u, 1u);
+  conncb_connected_fake.custom_fake = [](RCConnection*, const RCConnectedInfo* conn_info) {
+    EXPECT_EQ(conn_info->connected_addr, kTestRemoteAddrV6);
+  };
+
+  EtcPalPollEvent event;
+  event.events = ETCPAL_POLL_IN;
+  event.socket = attempt_sockets[1];
+  conn_.poll_info.callback(&event, conn_.poll_info.data);
+  EXPECT_EQ(conncb_connected_fake.call_count, 1u);
+}
+
+TEST_F(TestParallelConnection, FailsOnlyWhenAllAttemptsFail)
+{
+  PassTimeAndTick();
+  ASSERT_EQ(attempt_poll_infos.size(), 1u);
+
+  // A failed attempt starts the next one without waiting.
+  SendAttemptEvent(0, ETCPAL_POLL_ERR, kEtcPalErrConnRefused);
+  EXPECT_EQ(etcpal_connect_fake.call_count, 2u);
+  EXPECT_EQ(conncb_connect_failed_fake.call_count, 0u);
+
+  PassTimeAndTick(RDMNET_CONN_PARALLEL_CONNECT_DELAY_MS + 100);
+  EXPECT_EQ(etcpal_connect_fake.call_count, 3u);
+
+  SendAttemptEvent(2, ETCPAL_POLL_ERR, kEtcPalErrTimedOut);
+  EXPECT_EQ(conncb_connect_failed_fake.call_count, 0u);
+
+  conncb_connect_failed_fake.custom_fake = [](RCConnection*, const RCConnectFailedInfo* failed_info) {
+    EXPECT_EQ(failed_info->event, kRdmnetConnectFailTcpLevel);
+    EXPECT_EQ(failed_info->socket_err, kEtcPalErrHostUnreach);
+  };
+  SendAttemptEvent(1, ETCPAL_POLL_ERR, kEtcPalErrHostUnreach);
+  EXPECT_EQ(conncb_connect_failed_fake.call_count, 1u);
+  EXPECT_EQ(etcpal_close_fake.call_count, 3u);
+}
+
 class TestConnectionAlreadyConnected : public TestConnection
 {
 protected:
@@ -413,6 +568,24 @@ TEST_F(TestConnectionAlreadyConnected, ProcessesMultipleMessagesInMultipleReceiv
   EXPECT_EQ(conncb_msg_received_fake.call_count, kNumSuccessfulReceives * kNumMessagesPerReceive);
 }
 
+TEST_F(TestConnectionAlreadyConnected, DoesNotReceiveOnTickWhenIdle)
+{
+  PassTimeAndTick();
+  PassTimeAndTick();
+
+  EXPECT_EQ(rc_msg_buf_recv_fake.call_count, 0u);
+}
+
+TEST_F(TestConnectionAlreadyConnected, SendsHeartbeatWhenDue)
+{
+  PassTimeAndTick((E133_TCP_HEARTBEAT_INTERVAL_SEC * 1000) - 1000);
+  EXPECT_EQ(rc_broker_send_null_fake.call_count, 0u);
+
+  PassTimeAndTick(3000);
+  EXPECT_EQ(rc_broker_send_null_fake.call_count, 1u);
+  EXPECT_EQ(rc_msg_buf_recv_fake.call_count, 0u);
+}
+
 TEST_F(TestConnectionAlreadyConnected, RetriesSingleMessage)
 {
   SetGenericRptMessage(conn_.recv_buf.msg);
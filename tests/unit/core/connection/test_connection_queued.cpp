@@ -0,0 +1,360 @@
+/******************************************************************************
+ * Copyright 2020 ETC Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ ******************************************************************************
+ * This file is a part of RDMnet. For more information, go to:
+ * https://github.com/ETCLabs/RDMnet
+ *****************************************************************************/
+
+// Tests for the connection module with its callbacks delivered through the callback queue. No
+// callback threads are configured, so the tests deliver them with rc_callback_queue_dispatch().
+
+#include <cstring>
+#include <vector>
+#include "etcpal/common.h"
+#include "etcpal/cpp/uuid.h"
+#include "etcpal/cpp/inet.h"
+#include "etcpal/cpp/mutex.h"
+#include "etcpal_mock/common.h"
+#include "etcpal_mock/socket.h"
+#include "etcpal_mock/timer.h"
+#include "rdm/cpp/uid.h"
+#include "rdmnet/core/callback_queue.h"
+#include "rdmnet/core/connection.h"
+#include "rdmnet_mock/core/broker_prot.h"
+#include "rdmnet_mock/core/message.h"
+#include "rdmnet_mock/core/msg_buf.h"
+#include "rdmnet_mock/core/common.h"
+#include "test_rdm_commands.h"
+#include "gtest/gtest.h"
+
+#ifdef _MSC_VER
+#pragma warning(disable : 4996)
+#endif
+
+static_assert(RC_QUEUE_CALLBACKS, "This test must be built with RDMNET_CALLBACK_QUEUE_SIZE set");
+static_assert(RDMNET_CALLBACK_THREADS == 0, "This test delivers the queued callbacks itself");
+
+extern "C" {
+FAKE_VOID_FUNC(conncb_connected, RCConnection*, const RCConnectedInfo*);
+FAKE_VOID_FUNC(conncb_connect_failed, RCConnection*, const RCConnectFailedInfo*);
+FAKE_VOID_FUNC(conncb_disconnected, RCConnection*, const RCDisconnectedInfo*);
+FAKE_VALUE_FUNC(rc_message_action_t, conncb_msg_received, RCConnection*, const RdmnetMessage*);
+FAKE_VOID_FUNC(conncb_destroyed, RCConnection*);
+}
+
+static RCPolledSocketInfo conn_poll_info;
+static RCPolledSocketInfo wake_poll_info;
+
+// The sequence numbers of the messages seen by the message_received callback, in order.
+static std::vector<uint32_t> received_seqnums;
+
+// How many more messages the fake parser has to hand out, and the sequence number of the next one.
+static unsigned int messages_to_parse;
+static uint32_t     next_seqnum;
+
+static unsigned int num_dummy_callbacks;
+
+static constexpr etcpal_socket_t kWakeSocket = 1;
+static constexpr etcpal_socket_t kConnSocket = 2;
+
+static const etcpal::Uuid     kTestLocalCid = etcpal::Uuid::FromString("5103d586-44bf-46df-8c5a-e690f3dd6e22");
+static const rdm::Uid         kTestLocalUid = rdm::Uid::FromString("6574:82048492");
+static const etcpal::Uuid     kTestBrokerCid = etcpal::Uuid::FromString("3569236f-6a14-4db3-815d-e3961d386b72");
+static const rdm::Uid         kTestBrokerUid = rdm::Uid::FromString("6574:a0e34807");
+static const etcpal::SockAddr kTestRemoteAddrV4(etcpal::IpAddr::FromString("10.101.1.1"), 8888);
+
+extern "C" void DummyCallback(RCQueuedCallback*, bool)
+{
+  ++num_dummy_callbacks;
+}
+
+class TestConnectionQueued : public testing::Test
+{
+protected:
+  RCConnection  conn_{};
+  etcpal::Mutex conn_lock_;
+  int           dummy_obj_{};
+
+  BrokerClientConnectMsg connect_msg_{};
+
+  void SetUp() override
+  {
+    ResetFakes();
+
+    conn_.local_cid = etcpal::Uuid::FromString("51077344-7164-487e-88c1-b3146de32d4c").get();
+    conn_.lock = &conn_lock_.get();
+    conn_.callbacks.connected = conncb_connected;
+    conn_.callbacks.connect_failed = conncb_connect_failed;
+    conn_.callbacks.disconnected = conncb_disconnected;
+    conn_.callbacks.message_received = conncb_msg_received;
+    conn_.callbacks.destroyed = conncb_destroyed;
+
+    std::strcpy(connect_msg_.scope, "Test Scope");
+    connect_msg_.e133_version = E133_VERSION;
+    std::strcpy(connect_msg_.search_domain, "local.");
+    connect_msg_.client_entry.client_protocol = kClientProtocolRPT;
+    GET_RPT_CLIENT_ENTRY(&connect_msg_.client_entry)->cid = kTestLocalCid.get();
+    GET_RPT_CLIENT_ENTRY(&connect_msg_.client_entry)->uid = kTestLocalUid.get();
+    GET_RPT_CLIENT_ENTRY(&connect_msg_.client_entry)->type = kRPTClientTypeController;
+
+    std::memset(&conn_poll_info, 0, sizeof(RCPolledSocketInfo));
+    std::memset(&wake_poll_info, 0, sizeof(RCPolledSocketInfo));
+
+    ASSERT_EQ(kEtcPalErrOk, rc_callback_queue_module_init());
+    ASSERT_EQ(kEtcPalErrOk, rc_conn_module_init());
+    ASSERT_NE(wake_poll_info.callback, nullptr);
+    ASSERT_EQ(kEtcPalErrOk, rc_conn_register(&conn_));
+
+    ConnectToBroker();
+  }
+
+  void TearDown() override
+  {
+    rc_conn_unregister(&conn_, nullptr);
+    rc_callback_queue_module_deinit();
+    rc_conn_module_deinit();
+  }
+
+  void ConnectToBroker()
+  {
+    ASSERT_EQ(kEtcPalErrOk, rc_conn_connect(&conn_, &kTestRemoteAddrV4.get(), &connect_msg_));
+    PassTimeAndTick();
+    ASSERT_NE(conn_poll_info.callback, nullptr);
+    SendConnEvent(ETCPAL_POLL_CONNECT);
+
+    SetValidConnectReply(conn_.recv_buf.msg);
+    QueueUpMessages(1u);
+    SendConnEvent(ETCPAL_POLL_IN);
+
+    // The connected callback is queued rather than called from the poll thread.
+    EXPECT_EQ(conncb_connected_fake.call_count, 0u);
+    EXPECT_EQ(Dispatch(), 1u);
+    ASSERT_EQ(conncb_connected_fake.call_count, 1u);
+
+    // Start a fresh slate for the tests.
+    ResetFakes();
+    SetGenericRptMessage(conn_.recv_buf.msg);
+  }
+
+  void PassTimeAndTick(uint32_t time_to_pass = 1000)
+  {
+    etcpal_getms_fake.return_val += time_to_pass;
+    rc_conn_module_tick();
+  }
+
+  void SendConnEvent(etcpal_poll_events_t events)
+  {
+    EtcPalPollEvent event{};
+    event.events = events;
+    event.socket = kConnSocket;
+    conn_poll_info.callback(&event, conn_poll_info.data);
+  }
+
+  // Simulate the wake sent by a callback thread arriving at the poll thread.
+  void SendWake()
+  {
+    EtcPalPollEvent event{};
+    event.events = ETCPAL_POLL_IN;
+    event.socket = kWakeSocket;
+    wake_poll_info.callback(&event, wake_poll_info.data);
+  }
+
+  size_t Dispatch() { return rc_callback_queue_dispatch(0, 0); }
+
+  // One receive holding num_messages complete messages, after which the socket has no more data.
+  void QueueUpMessages(unsigned int num_messages)
+  {
+    static etcpal_error_t recv_return_vals[] = {kEtcPalErrOk, kEtcPalErrWouldBlock};
+    SET_RETURN_SEQ(rc_msg_buf_recv, recv_return_vals, 2);
+    messages_to_parse = num_messages;
+  }
+
+  void FillCallbackQueue()
+  {
+    for (int i = 0; i < RDMNET_CALLBACK_QUEUE_SIZE; ++i)
+      ASSERT_TRUE(rc_callback_queue_push(DummyCallback, &dummy_obj_, nullptr, 0));
+  }
+
+  void ResetFakes()
+  {
+    RESET_FAKE(conncb_connected);
+    RESET_FAKE(conncb_connect_failed);
+    RESET_FAKE(conncb_disconnected);
+    RESET_FAKE(conncb_msg_received);
+    RESET_FAKE(conncb_destroyed);
+
+    rdmnet_mock_core_reset_and_init();
+    rc_broker_prot_reset_all_fakes();
+    rc_message_reset_all_fakes();
+    rc_msg_buf_reset_all_fakes();
+    etcpal_reset_all_fakes();
+
+    received_seqnums.clear();
+    messages_to_parse = 0;
+    next_seqnum = 0;
+    num_dummy_callbacks = 0;
+
+    etcpal_socket_fake.custom_fake = [](unsigned int, unsigned int type, etcpal_socket_t* socket) {
+      *socket = (type == ETCPAL_SOCK_DGRAM ? kWakeSocket : kConnSocket);
+      return kEtcPalErrOk;
+    };
+    etcpal_setblocking_fake.return_val = kEtcPalErrOk;
+    etcpal_connect_fake.return_val = kEtcPalErrInProgress;
+
+    // The wake socket's poll info is the only one without a connection attached.
+    rc_add_polled_socket_fake.custom_fake = [](etcpal_socket_t, etcpal_poll_events_t, RCPolledSocketInfo* info) {
+      if (info->data.ptr)
+        conn_poll_info = *info;
+      else
+        wake_poll_info = *info;
+      return kEtcPalErrOk;
+    };
+
+    rc_msg_buf_recv_fake.return_val = kEtcPalErrWouldBlock;
+    rc_msg_buf_parse_data_fake.custom_fake = [](RCMsgBuf* msg_buf) {
+      if (messages_to_parse == 0)
+        return kEtcPalErrNoData;
+      --messages_to_parse;
+      if (msg_buf->msg.vector == ACN_VECTOR_ROOT_RPT)
+        RDMNET_GET_RPT_MSG(&msg_buf->msg)->header.seqnum = next_seqnum++;
+      return kEtcPalErrOk;
+    };
+
+    conncb_msg_received_fake.custom_fake = [](RCConnection*, const RdmnetMessage* msg) {
+      received_seqnums.push_back(RDMNET_GET_RPT_MSG(msg)->header.seqnum);
+      return kRCMessageActionProcessNext;
+    };
+  }
+
+  static void SetValidConnectReply(RdmnetMessage& msg)
+  {
+    msg.vector = ACN_VECTOR_ROOT_BROKER;
+    msg.sender_cid = kTestBrokerCid.get();
+    RDMNET_GET_BROKER_MSG(&msg)->vector = VECTOR_BROKER_CONNECT_REPLY;
+    BrokerConnectReplyMsg* conn_reply = BROKER_GET_CONNECT_REPLY_MSG(RDMNET_GET_BROKER_MSG(&msg));
+    conn_reply->broker_uid = kTestBrokerUid.get();
+    conn_reply->client_uid = kTestLocalUid.get();
+    conn_reply->connect_status = kRdmnetConnectOk;
+    conn_reply->e133_version = E133_VERSION;
+  }
+
+  static void SetGenericRptMessage(RdmnetMessage& msg)
+  {
+    msg = TestRdmCommand::Get(kTestLocalUid.get(), E120_DEVICE_INFO).msg;
+  }
+};
+
+TEST_F(TestConnectionQueued, DeliversMessagesOneAtATimeInOrder)
+{
+  QueueUpMessages(3u);
+  SendConnEvent(ETCPAL_POLL_IN);
+
+  // The first message is queued, and the socket stops being read until it has been delivered.
+  EXPECT_EQ(rc_msg_buf_parse_data_fake.call_count, 1u);
+  EXPECT_EQ(conncb_msg_received_fake.call_count, 0u);
+  ASSERT_EQ(rc_remove_polled_socket_fake.call_count, 1u);
+  EXPECT_EQ(rc_remove_polled_socket_fake.arg0_val, kConnSocket);
+
+  // Nothing more is parsed on the tick while the message is in flight.
+  PassTimeAndTick(0);
+  EXPECT_EQ(rc_msg_buf_parse_data_fake.call_count, 1u);
+
+  for (unsigned int i = 1; i <= 3; ++i)
+  {
+    // Delivering a message wakes the poll thread, which parses the next one right away.
+    EXPECT_EQ(Dispatch(), 1u);
+    EXPECT_EQ(etcpal_sendto_fake.call_count, i);
+    EXPECT_EQ(etcpal_sendto_fake.arg0_val, kWakeSocket);
+    SendWake();
+    EXPECT_EQ(rc_msg_buf_parse_data_fake.call_count, i + 1);
+  }
+
+  EXPECT_EQ(received_seqnums, std::vector<uint32_t>({0, 1, 2}));
+
+  // Once the buffer is drained, the socket is polled for reads again.
+  ASSERT_EQ(rc_add_polled_socket_fake.call_count, 1u);
+  EXPECT_EQ(rc_add_polled_socket_fake.arg0_val, kConnSocket);
+  EXPECT_EQ(rc_add_polled_socket_fake.arg1_val, ETCPAL_POLL_IN);
+  EXPECT_EQ(rc_remove_polled_socket_fake.call_count, 1u);
+}
+
+TEST_F(TestConnectionQueued, RetriesMessageOnTickWhileQueueIsFull)
+{
+  FillCallbackQueue();
+
+  QueueUpMessages(1u);
+  SendConnEvent(ETCPAL_POLL_IN);
+  EXPECT_EQ(rc_msg_buf_parse_data_fake.call_count, 1u);
+  EXPECT_EQ(rc_remove_polled_socket_fake.call_count, 1u);
+
+  // Still no room; the same message is retried without being parsed again.
+  PassTimeAndTick();
+  EXPECT_EQ(rc_msg_buf_parse_data_fake.call_count, 1u);
+
+  EXPECT_EQ(Dispatch(), static_cast<size_t>(RDMNET_CALLBACK_QUEUE_SIZE));
+  EXPECT_EQ(num_dummy_callbacks, static_cast<unsigned int>(RDMNET_CALLBACK_QUEUE_SIZE));
+
+  // Now the message makes it into the queue.
+  PassTimeAndTick();
+  EXPECT_EQ(rc_msg_buf_parse_data_fake.call_count, 1u);
+  EXPECT_EQ(Dispatch(), 1u);
+  EXPECT_EQ(received_seqnums, std::vector<uint32_t>({0}));
+
+  SendWake();
+  EXPECT_EQ(rc_msg_buf_parse_data_fake.call_count, 2u);
+  EXPECT_EQ(rc_add_polled_socket_fake.call_count, 1u);
+}
+
+TEST_F(TestConnectionQueued, RequeuesMessageWhenCallbackRetriesLater)
+{
+  conncb_msg_received_fake.custom_fake = [](RCConnection*, const RdmnetMessage* msg) {
+    received_seqnums.push_back(RDMNET_GET_RPT_MSG(msg)->header.seqnum);
+    return (received_seqnums.size() == 1 ? kRCMessageActionRetryLater : kRCMessageActionProcessNext);
+  };
+
+  QueueUpMessages(2u);
+  SendConnEvent(ETCPAL_POLL_IN);
+
+  // The retry goes back through the queue without parsing over the message.
+  EXPECT_EQ(Dispatch(), 1u);
+  SendWake();
+  EXPECT_EQ(rc_msg_buf_parse_data_fake.call_count, 1u);
+
+  EXPECT_EQ(Dispatch(), 1u);
+  SendWake();
+  EXPECT_EQ(rc_msg_buf_parse_data_fake.call_count, 2u);
+
+  EXPECT_EQ(Dispatch(), 1u);
+  EXPECT_EQ(received_seqnums, std::vector<uint32_t>({0, 0, 1}));
+}
+
+TEST_F(TestConnectionQueued, DestroyIsDeferredUntilQueuedCallbacksAreDelivered)
+{
+  QueueUpMessages(1u);
+  SendConnEvent(ETCPAL_POLL_IN);
+
+  rc_conn_unregister(&conn_, nullptr);
+  PassTimeAndTick();
+  EXPECT_EQ(conncb_destroyed_fake.call_count, 0u);
+
+  // The queued message still refers to the connection, and is delivered before it goes away.
+  EXPECT_EQ(Dispatch(), 1u);
+  EXPECT_EQ(received_seqnums, std::vector<uint32_t>({0}));
+  EXPECT_EQ(conncb_destroyed_fake.call_count, 0u);
+
+  PassTimeAndTick();
+  EXPECT_EQ(conncb_destroyed_fake.call_count, 1u);
+  EXPECT_EQ(conncb_destroyed_fake.arg0_val, &conn_);
+}
@@ -51,6 +51,9 @@ protected:
     target_.cid = etcpal::Uuid::FromString("28e04e4a-9eda-44d1-b4f8-56af772ca4c9").get();
     target_.uid = rdm::Uid::FromString("6574:60313950").get();
     target_.lock = &target_lock_.get();
+#if RC_QUEUE_CALLBACKS
+    target_.resp_lock = nullptr;
+#endif
     target_.component_type = kLlrpCompRptDevice;
     target_.callbacks.rdm_command_received = targetcb_rdm_cmd_received;
     target_.callbacks.destroyed = targetcb_destroyed;
@@ -0,0 +1,210 @@
+/******************************************************************************
+ * Copyright 2020 ETC Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ ******************************************************************************
+ * This file is a part of RDMnet. For more information, go to:
+ * https://github.com/ETCLabs/RDMnet
+ *****************************************************************************/
+
+#include "rdmnet/core/callback_queue.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <thread>
+#include <vector>
+#include "etcpal_mock/common.h"
+#include "gtest/gtest.h"
+
+static_assert(RC_QUEUE_CALLBACKS, "This test must be built with RDMNET_CALLBACK_QUEUE_SIZE set");
+
+struct Delivery
+{
+  void* obj;
+  int   value;
+  bool  discarded;
+};
+
+static std::vector<Delivery> deliveries;
+
+extern "C" void RecordDelivery(RCQueuedCallback* callback, bool discard)
+{
+  int value;
+  std::memcpy(&value, callback->data.bytes, sizeof(int));
+  deliveries.push_back(Delivery{callback->obj, value, discard});
+}
+
+// Each object belongs to one queue and only the thread draining that queue delivers to it, so its
+// values need no lock of their own.
+struct StressObj
+{
+  std::vector<int> values;
+};
+
+static std::atomic<size_t> num_stress_deliveries;
+
+extern "C" void RecordStressDelivery(RCQueuedCallback* callback, bool discard)
+{
+  int value;
+  std::memcpy(&value, callback->data.bytes, sizeof(int));
+  if (!discard)
+    static_cast<StressObj*>(callback->obj)->values.push_back(value);
+  ++num_stress_deliveries;
+}
+
+class TestCallbackQueue : public testing::Test
+{
+protected:
+  int objs_[4]{};
+
+  void SetUp() override
+  {
+    etcpal_reset_all_fakes();
+    deliveries.clear();
+    ASSERT_EQ(rc_callback_queue_module_init(), kEtcPalErrOk);
+  }
+
+  void TearDown() override { rc_callback_queue_module_deinit(); }
+
+  bool Push(void* obj, int value) { return rc_callback_queue_push(RecordDelivery, obj, &value, sizeof(value)); }
+
+  size_t DispatchAll()
+  {
+    size_t num_dispatched = 0;
+    for (size_t shard = 0; shard < RC_CALLBACK_QUEUE_SHARDS; ++shard)
+      num_dispatched += rc_callback_queue_dispatch(shard, 0);
+    return num_dispatched;
+  }
+
+  std::vector<int> ValuesDeliveredFor(void* obj)
+  {
+    std::vector<int> values;
+    for (const auto& delivery : deliveries)
+    {
+      if (delivery.obj == obj)
+        values.push_back(delivery.value);
+    }
+    return values;
+  }
+};
+
+TEST_F(TestCallbackQueue, DispatchReturnsZeroWhenEmpty)
+{
+  EXPECT_EQ(DispatchAll(), 0u);
+  EXPECT_TRUE(deliveries.empty());
+}
+
+TEST_F(TestCallbackQueue, CallbacksForEachObjectAreDeliveredInOrder)
+{
+  // Two each, so that they fit even if every object's callbacks go to the same queue.
+  for (int i = 0; i < 2; ++i)
+  {
+    for (int& obj : objs_)
+      ASSERT_TRUE(Push(&obj, i));
+  }
+
+  EXPECT_EQ(DispatchAll(), 8u);
+  for (int& obj : objs_)
+    EXPECT_EQ(ValuesDeliveredFor(&obj), std::vector<int>({0, 1}));
+  EXPECT_TRUE(std::none_of(deliveries.begin(), deliveries.end(), [](const Delivery& d) { return d.discarded; }));
+}
+
+TEST_F(TestCallbackQueue, PushFailsWhenFullUntilDispatched)
+{
+  for (int i = 0; i < RDMNET_CALLBACK_QUEUE_SIZE; ++i)
+    ASSERT_TRUE(Push(&objs_[0], i));
+  EXPECT_FALSE(Push(&objs_[0], RDMNET_CALLBACK_QUEUE_SIZE));
+
+  EXPECT_EQ(DispatchAll(), static_cast<size_t>(RDMNET_CALLBACK_QUEUE_SIZE));
+  EXPECT_TRUE(Push(&objs_[0], RDMNET_CALLBACK_QUEUE_SIZE));
+  EXPECT_EQ(DispatchAll(), 1u);
+  EXPECT_EQ(ValuesDeliveredFor(&objs_[0]).back(), RDMNET_CALLBACK_QUEUE_SIZE);
+}
+
+TEST_F(TestCallbackQueue, PushWaitGivesUpOnceClosed)
+{
+  for (int i = 0; i < RDMNET_CALLBACK_QUEUE_SIZE; ++i)
+    ASSERT_TRUE(Push(&objs_[0], i));
+
+  rc_callback_queue_close();
+  int value = RDMNET_CALLBACK_QUEUE_SIZE;
+  EXPECT_FALSE(rc_callback_queue_push_wait(RecordDelivery, &objs_[0], &value, sizeof(value)));
+}
+
+TEST_F(TestCallbackQueue, DeinitDiscardsQueuedCallbacks)
+{
+  ASSERT_TRUE(Push(&objs_[0], 0));
+  ASSERT_TRUE(Push(&objs_[1], 1));
+
+  rc_callback_queue_module_deinit();
+  ASSERT_EQ(deliveries.size(), 2u);
+  EXPECT_TRUE(std::all_of(deliveries.begin(), deliveries.end(), [](const Delivery& d) { return d.discarded; }));
+
+  // Re-initialize for TearDown().
+  ASSERT_EQ(rc_callback_queue_module_init(), kEtcPalErrOk);
+}
+
+// Several producers push to every queue at once while several consumers contend to drain them; each
+// object's callbacks must still arrive exactly once and in the order they were pushed.
+TEST_F(TestCallbackQueue, ConcurrentProducersKeepEachObjectsCallbacksInOrder)
+{
+  static_assert(RC_CALLBACK_QUEUE_SHARDS > 1, "This test must be built with RDMNET_CALLBACK_THREADS > 1");
+
+  constexpr size_t kNumProducers = 4;
+  constexpr size_t kObjsPerProducer = 4;
+  constexpr int    kCallbacksPerObj = 2000;
+  constexpr size_t kNumConsumers = 3;
+  constexpr size_t kTotalCallbacks = kNumProducers * kObjsPerProducer * kCallbacksPerObj;
+
+  std::vector<StressObj> objs(kNumProducers * kObjsPerProducer);
+  num_stress_deliveries = 0;
+
+  std::vector<std::thread> threads;
+  for (size_t producer = 0; producer < kNumProducers; ++producer)
+  {
+    threads.emplace_back([&objs, producer]() {
+      for (int value = 0; value < kCallbacksPerObj; ++value)
+      {
+        for (size_t i = 0; i < kObjsPerProducer; ++i)
+        {
+          StressObj* obj = &objs[producer * kObjsPerProducer + i];
+          while (!rc_callback_queue_push(RecordStressDelivery, obj, &value, sizeof(value)))
+            std::this_thread::yield();
+        }
+      }
+    });
+  }
+  for (size_t consumer = 0; consumer < kNumConsumers; ++consumer)
+  {
+    threads.emplace_back([consumer]() {
+      // Consumers start on different queues, then take turns with each other on all of them.
+      for (size_t shard = consumer; num_stress_deliveries < kTotalCallbacks; ++shard)
+      {
+        if (rc_callback_queue_dispatch(shard % RC_CALLBACK_QUEUE_SHARDS, 0) == 0)
+          std::this_thread::yield();
+      }
+    });
+  }
+  for (auto& thread : threads)
+    thread.join();
+
+  EXPECT_EQ(num_stress_deliveries, kTotalCallbacks);
+  EXPECT_EQ(DispatchAll(), 0u);
+
+  std::vector<int> expected_values(kCallbacksPerObj);
+  for (int i = 0; i < kCallbacksPerObj; ++i)
+    expected_values[i] = i;
+  for (const auto& obj : objs)
+    EXPECT_EQ(obj.values, expected_values);
+}
@@ -0,0 +1,127 @@
+/******************************************************************************
+ * Copyright 2020 ETC Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ ******************************************************************************
+ * This file is a part of RDMnet. For more information, go to:
+ * https://github.com/ETCLabs/RDMnet
+ *****************************************************************************/
+
+#include "rdmnet/core/ept_prot.h"
+
+#include <algorithm>
+#include <memory>
+#include "etcpal_mock/socket.h"
+#include "rdmnet_mock/core/common.h"
+#include "gtest/gtest.h"
+#include "test_data_util.h"
+#include "load_test_data.h"
+
+class TestEptProt : public testing::Test
+{
+protected:
+  static std::vector<uint8_t> sent_bytes;
+
+  void SetUp() override
+  {
+    sent_bytes.clear();
+    RESET_FAKE(rc_send);
+    rc_send_fake.custom_fake = [](etcpal_socket_t, const void* msg, size_t length, int) {
+      const uint8_t* msg_bytes = reinterpret_cast<const uint8_t*>(msg);
+      sent_bytes.insert(sent_bytes.end(), msg_bytes, msg_bytes + length);
+      return (int)length;
+    };
+  }
+};
+
+std::vector<uint8_t> TestEptProt::sent_bytes;
+
+TEST_F(TestEptProt, PackEptData)
+{
+  RdmnetMessage        msg;
+  std::vector<uint8_t> msg_bytes;
+  ASSERT_TRUE(GetTestFileByBasename("ept_data", msg_bytes, msg));
+
+  EptMessage*    ept_msg = RDMNET_GET_EPT_MSG(&msg);
+  RdmnetEptData* data = EPT_GET_DATA_MSG(ept_msg);
+  EXPECT_EQ(rc_ept_get_data_buffer_size(data->data_len), msg_bytes.size());
+
+  auto buf = std::make_unique<uint8_t[]>(msg_bytes.size());
+  EXPECT_EQ(rc_ept_pack_data(buf.get(), msg_bytes.size(), &msg.sender_cid, &ept_msg->dest_cid, data->manufacturer_id,
+                             data->protocol_id, data->data, data->data_len),
+            msg_bytes.size());
+  EXPECT_TRUE(std::equal(msg_bytes.begin(), msg_bytes.end(), buf.get()));
+}
+
+TEST_F(TestEptProt, PackEptDataFailsWithSmallBuffer)
+{
+  RdmnetMessage        msg;
+  std::vector<uint8_t> msg_bytes;
+  ASSERT_TRUE(GetTestFileByBasename("ept_data", msg_bytes, msg));
+
+  EptMessage*    ept_msg = RDMNET_GET_EPT_MSG(&msg);
+  RdmnetEptData* data = EPT_GET_DATA_MSG(ept_msg);
+
+  auto buf = std::make_unique<uint8_t[]>(msg_bytes.size());
+  EXPECT_EQ(rc_ept_pack_data(buf.get(), msg_bytes.size() - 1, &msg.sender_cid, &ept_msg->dest_cid,
+                             data->manufacturer_id, data->protocol_id, data->data, data->data_len),
+            0u);
+}
+
+TEST_F(TestEptProt, PackEptStatus)
+{
+  RdmnetMessage        msg;
+  std::vector<uint8_t> msg_bytes;
+  ASSERT_TRUE(GetTestFileByBasename("ept_status_unknown_cid", msg_bytes, msg));
+
+  EptMessage*      ept_msg = RDMNET_GET_EPT_MSG(&msg);
+  RdmnetEptStatus* status = EPT_GET_STATUS_MSG(ept_msg);
+  EXPECT_EQ(rc_ept_get_status_buffer_size(status->status_string), msg_bytes.size());
+
+  auto buf = std::make_unique<uint8_t[]>(msg_bytes.size());
+  EXPECT_EQ(rc_ept_pack_status(buf.get(), msg_bytes.size(), &msg.sender_cid, &ept_msg->dest_cid, status->status_code,
+                               status->status_string),
+            msg_bytes.size());
+  EXPECT_TRUE(std::equal(msg_bytes.begin(), msg_bytes.end(), buf.get()));
+}
+
+TEST_F(TestEptProt, SendEptData)
+{
+  RdmnetMessage        msg;
+  std::vector<uint8_t> msg_bytes;
+  ASSERT_TRUE(GetTestFileByBasename("ept_data", msg_bytes, msg));
+
+  EptMessage*    ept_msg = RDMNET_GET_EPT_MSG(&msg);
+  RdmnetEptData* data = EPT_GET_DATA_MSG(ept_msg);
+
+  RCConnection conn{};
+  EXPECT_EQ(rc_ept_send_data(&conn, &msg.sender_cid, &ept_msg->dest_cid, data->manufacturer_id, data->protocol_id,
+                             data->data, data->data_len),
+            kEtcPalErrOk);
+  EXPECT_EQ(msg_bytes, sent_bytes);
+}
+
+TEST_F(TestEptProt, SendEptStatus)
+{
+  RdmnetMessage        msg;
+  std::vector<uint8_t> msg_bytes;
+  ASSERT_TRUE(GetTestFileByBasename("ept_status_unknown_cid", msg_bytes, msg));
+
+  EptMessage*      ept_msg = RDMNET_GET_EPT_MSG(&msg);
+  RdmnetEptStatus* status = EPT_GET_STATUS_MSG(ept_msg);
+
+  RCConnection conn{};
+  EXPECT_EQ(rc_ept_send_status(&conn, &msg.sender_cid, &ept_msg->dest_cid, status->status_code, status->status_string),
+            kEtcPalErrOk);
+  EXPECT_EQ(msg_bytes, sent_bytes);
+}
@@ -21,17 +21,73 @@
 
 #include <algorithm>
 #include <cstring>
+#include <utility>
 #include <vector>
 #include "etcpal/cpp/inet.h"
 #include "etcpal_mock/common.h"
 #include "etcpal_mock/netint.h"
 #include "etcpal_mock/socket.h"
 #include "gtest/gtest.h"
+#include "fff.h"
 
 #ifdef _MSC_VER
 #pragma warning(disable : 4996)
 #endif
 
+#if defined(__linux__)
+#include <arpa/inet.h>
+#include <cerrno>
+#include <netinet/in.h>
+#include <sys/socket.h>
+
+// The test executable is linked with --wrap=sendmmsg, so the library's sendmmsg() calls land here.
+FAKE_VALUE_FUNC(int, fake_sendmmsg, int, struct mmsghdr*, unsigned int, int);
+
+extern "C" int __wrap_sendmmsg(int sockfd, struct mmsghdr* msgvec, unsigned int vlen, int flags)
+{
+  return fake_sendmmsg(sockfd, msgvec, vlen, flags);
+}
+
+// Likewise for recvmmsg().
+FAKE_VALUE_FUNC(int, fake_recvmmsg, int, struct mmsghdr*, unsigned int, int, struct timespec*);
+
+extern "C" int __wrap_recvmmsg(int sockfd, struct mmsghdr* msgvec, unsigned int vlen, int flags, struct timespec* timeout)
+{
+  return fake_recvmmsg(sockfd, msgvec, vlen, flags, timeout);
+}
+
+// Fill in a datagram received by recvmmsg() from 10.101.1.5:5569, with no ancillary data.
+static void FillRecvmmsgDatagram(struct mmsghdr* mmsg, uint8_t first_byte, unsigned int len, int flags)
+{
+  const struct iovec* iov = mmsg->msg_hdr.msg_iov;
+  std::memset(iov->iov_base, first_byte, std::min<size_t>(len, iov->iov_len));
+
+  struct sockaddr_in from = {};
+  from.sin_family = AF_INET;
+  from.sin_port = htons(5569);
+  from.sin_addr.s_addr = inet_addr("10.101.1.5");
+  std::memcpy(mmsg->msg_hdr.msg_name, &from, sizeof from);
+  mmsg->msg_hdr.msg_namelen = sizeof from;
+
+  mmsg->msg_hdr.msg_controllen = 0;
+  mmsg->msg_hdr.msg_flags = flags;
+  mmsg->msg_len = len;
+}
+
+// The interface index selected by the pktinfo ancillary data of a datagram passed to sendmmsg().
+static unsigned int GetPktInfoIndex(struct msghdr* hdr)
+{
+  struct cmsghdr* cmsg = CMSG_FIRSTHDR(hdr);
+  if (!cmsg)
+    return 0;
+  if (cmsg->cmsg_level == IPPROTO_IPV6 && cmsg->cmsg_type == IPV6_PKTINFO)
+    return reinterpret_cast<struct in6_pktinfo*>(CMSG_DATA(cmsg))->ipi6_ifindex;
+  if (cmsg->cmsg_level == IPPROTO_IP && cmsg->cmsg_type == IP_PKTINFO)
+    return static_cast<unsigned int>(reinterpret_cast<struct in_pktinfo*>(CMSG_DATA(cmsg))->ipi_ifindex);
+  return 0;
+}
+#endif
+
 class TestMcast : public testing::Test
 {
 public:
@@ -43,6 +99,18 @@ protected:
   TestMcast()
   {
     etcpal_reset_all_fakes();
+#if defined(__linux__)
+    // sendmmsg() fails unless a test says otherwise, so datagrams fall back to etcpal_sendto().
+    RESET_FAKE(fake_sendmmsg);
+    fake_sendmmsg_fake.return_val = -1;
+    // recvmmsg() is unavailable unless a test says otherwise, so datagrams are read one at a time
+    // with etcpal_recvmsg().
+    RESET_FAKE(fake_recvmmsg);
+    fake_recvmmsg_fake.custom_fake = [](int, struct mmsghdr*, unsigned int, int, struct timespec*) {
+      errno = ENOSYS;
+      return -1;
+    };
+#endif
 
     EtcPalNetintInfo iface;
 
@@ -146,6 +214,22 @@ TEST_F(TestMcast, LowestHardwareAddrIsCorrect)
   EXPECT_EQ(*(rc_mcast_get_lowest_mac_addr()), lowest_mac);
 }
 
+TEST_F(TestMcast, ReportsInterfaceAddresses)
+{
+  ASSERT_EQ(kEtcPalErrOk, rc_mcast_module_init(nullptr));
+
+  EtcPalIpAddr addr;
+  for (const auto& sys_netint : sys_netints)
+  {
+    EtcPalMcastNetintId id{sys_netint.addr.type, sys_netint.index};
+    ASSERT_TRUE(rc_mcast_get_netint_addr(&id, &addr));
+    EXPECT_EQ(etcpal::IpAddr(addr), etcpal::IpAddr(sys_netint.addr));
+  }
+
+  EtcPalMcastNetintId unknown_id{kEtcPalIpTypeV4, 4};
+  EXPECT_FALSE(rc_mcast_get_netint_addr(&unknown_id, &addr));
+}
+
 // Test that we report the correct number of interfaces when not providing a config.
 TEST_F(TestMcast, ReportsCorrectNumberOfInterfacesWithNoConfig)
 {
@@ -311,3 +395,351 @@ TEST_F(TestMcast, SetsReuseAddrWhenSourcePortSpecified)
 
   EXPECT_TRUE(reuseaddr_set);
 }
+
+TEST_F(TestMcast, SendToNetintsSkipsIpTypesWithoutDestination)
+{
+  initted_in_test_ = false;
+
+  // Where sendmmsg() is used it fails, so every datagram is retried with etcpal_sendto() on its own
+  // interface's socket.
+  const RCMcastSendNetint netints[] = {
+      {{kEtcPalIpTypeV4, 1}, (etcpal_socket_t)1000},
+      {{kEtcPalIpTypeV6, 2}, (etcpal_socket_t)1001},
+      {{kEtcPalIpTypeV4, 3}, (etcpal_socket_t)1002},
+  };
+  EtcPalSockAddr v4_dest;
+  v4_dest.ip = etcpal::IpAddr::FromString("239.255.250.133").get();
+  v4_dest.port = 5569;
+  const uint8_t data[] = {0x01, 0x02, 0x03, 0x04};
+
+  EXPECT_EQ(kEtcPalErrOk, rc_mcast_send_to_netints(netints, 3, data, sizeof data, &v4_dest, nullptr));
+  ASSERT_EQ(etcpal_sendto_fake.call_count, 2u);
+  EXPECT_EQ(etcpal_sendto_fake.arg0_history[0], (etcpal_socket_t)1000);
+  EXPECT_EQ(etcpal_sendto_fake.arg0_history[1], (etcpal_socket_t)1002);
+  EXPECT_EQ(etcpal_sendto_fake.arg2_history[0], sizeof data);
+  EXPECT_EQ(etcpal_sendto_fake.arg4_history[1], &v4_dest);
+#if defined(__linux__)
+  ASSERT_EQ(fake_sendmmsg_fake.call_count, 1u);
+  EXPECT_EQ(fake_sendmmsg_fake.arg2_val, 2u);
+#endif
+}
+
+TEST_F(TestMcast, SendToNetintsTriesEveryNetintAfterAnError)
+{
+  initted_in_test_ = false;
+
+  const RCMcastSendNetint netints[] = {
+      {{kEtcPalIpTypeV6, 1}, (etcpal_socket_t)1000},
+      {{kEtcPalIpTypeV6, 2}, (etcpal_socket_t)1001},
+  };
+  EtcPalSockAddr v6_dest;
+  v6_dest.ip = etcpal::IpAddr::FromString("ff18::85:0:0:85").get();
+  v6_dest.port = 5569;
+  const uint8_t data[] = {0x01, 0x02, 0x03, 0x04};
+
+  etcpal_sendto_fake.custom_fake = [](etcpal_socket_t socket, const void*, size_t size, int, const EtcPalSockAddr*) {
+    return (socket == (etcpal_socket_t)1000) ? (int)kEtcPalErrSys : (int)size;
+  };
+  EXPECT_EQ(kEtcPalErrSys, rc_mcast_send_to_netints(netints, 2, data, sizeof data, nullptr, &v6_dest));
+  EXPECT_EQ(etcpal_sendto_fake.call_count, 2u);
+}
+
+// etcpal_recvmsg() behavior for the tests of the per-datagram receive loop: each call is handled by
+// the next entry, where a non-negative entry is the length of a datagram received from
+// 10.101.1.5:5569 and a negative entry is returned as an error.
+static std::vector<int> recvmsg_results;
+static int              recvmsg_flags;
+
+static int FakeRecvmsg(etcpal_socket_t, EtcPalMsgHdr* msg, int)
+{
+  const size_t index = etcpal_recvmsg_fake.call_count - 1;
+  if (index >= recvmsg_results.size())
+    return kEtcPalErrWouldBlock;
+
+  const int res = recvmsg_results[index];
+  if (res >= 0)
+  {
+    std::memset(msg->buf, static_cast<int>(index + 1), std::min<size_t>(static_cast<size_t>(res), msg->buflen));
+    msg->name.ip = etcpal::IpAddr::FromString("10.101.1.5").get();
+    msg->name.port = 5569;
+    msg->controllen = 0;
+    msg->flags = recvmsg_flags;
+  }
+  return res;
+}
+
+TEST_F(TestMcast, RecvBatchReadsDatagramsOneAtATime)
+{
+  initted_in_test_ = false;
+
+  constexpr size_t     kBufSize = 32;
+  std::vector<uint8_t> storage(kBufSize * 4);
+  RCMcastRecvMsg       msgs[4];
+
+  // Two datagrams are queued, a partial batch of the four requested.
+  recvmsg_results = {10, 20};
+  recvmsg_flags = 0;
+  etcpal_recvmsg_fake.custom_fake = FakeRecvmsg;
+
+  ASSERT_EQ(rc_mcast_recv_batch((etcpal_socket_t)1000, storage.data(), kBufSize, msgs, 4), 2);
+  EXPECT_EQ(etcpal_recvmsg_fake.call_count, 3u);
+  EXPECT_EQ(etcpal_recvmsg_fake.arg0_val, (etcpal_socket_t)1000);
+
+  for (size_t i = 0; i < 2; ++i)
+  {
+    EXPECT_EQ(msgs[i].data, &storage[i * kBufSize]);
+    EXPECT_EQ(msgs[i].data_len, (i + 1) * 10);
+    EXPECT_EQ(msgs[i].data[0], i + 1);
+    EXPECT_EQ(etcpal::IpAddr(msgs[i].from.ip), etcpal::IpAddr::FromString("10.101.1.5"));
+    EXPECT_EQ(msgs[i].from.port, 5569);
+    EXPECT_FALSE(msgs[i].truncated);
+    EXPECT_FALSE(msgs[i].netint_valid);
+  }
+#if defined(__linux__)
+  EXPECT_EQ(fake_recvmmsg_fake.call_count, 1u);
+#endif
+}
+
+TEST_F(TestMcast, RecvBatchLoopFlagsTruncatedDatagrams)
+{
+  initted_in_test_ = false;
+
+  constexpr size_t     kBufSize = 32;
+  std::vector<uint8_t> storage(kBufSize * 4);
+  RCMcastRecvMsg       msgs[4];
+
+  // The first datagram is reported as an error and dropped, the second is cut down to the buffer.
+  recvmsg_results = {kEtcPalErrMsgSize, static_cast<int>(kBufSize)};
+  recvmsg_flags = ETCPAL_MSG_TRUNC;
+  etcpal_recvmsg_fake.custom_fake = FakeRecvmsg;
+
+  ASSERT_EQ(rc_mcast_recv_batch((etcpal_socket_t)1000, storage.data(), kBufSize, msgs, 4), 1);
+  EXPECT_EQ(msgs[0].data, storage.data());
+  EXPECT_EQ(msgs[0].data_len, kBufSize);
+  EXPECT_EQ(msgs[0].data[0], 2u);
+  EXPECT_TRUE(msgs[0].truncated);
+}
+
+TEST_F(TestMcast, RecvBatchLoopReportsErrorsBeforeTheFirstDatagram)
+{
+  initted_in_test_ = false;
+
+  constexpr size_t     kBufSize = 32;
+  std::vector<uint8_t> storage(kBufSize * 4);
+  RCMcastRecvMsg       msgs[4];
+  recvmsg_flags = 0;
+  etcpal_recvmsg_fake.custom_fake = FakeRecvmsg;
+
+  recvmsg_results = {kEtcPalErrWouldBlock};
+  EXPECT_EQ(rc_mcast_recv_batch((etcpal_socket_t)1000, storage.data(), kBufSize, msgs, 4), 0);
+
+  RESET_FAKE(etcpal_recvmsg);
+  etcpal_recvmsg_fake.custom_fake = FakeRecvmsg;
+  recvmsg_results = {kEtcPalErrConnReset};
+  EXPECT_EQ(rc_mcast_recv_batch((etcpal_socket_t)1000, storage.data(), kBufSize, msgs, 4), kEtcPalErrConnReset);
+
+  // Datagrams received before an error are still delivered.
+  RESET_FAKE(etcpal_recvmsg);
+  etcpal_recvmsg_fake.custom_fake = FakeRecvmsg;
+  recvmsg_results = {10, kEtcPalErrConnReset, 10};
+  EXPECT_EQ(rc_mcast_recv_batch((etcpal_socket_t)1000, storage.data(), kBufSize, msgs, 4), 1);
+  EXPECT_EQ(etcpal_recvmsg_fake.call_count, 2u);
+}
+
+#if defined(__linux__)
+
+TEST_F(TestMcast, RecvBatchUsesRecvmmsg)
+{
+  initted_in_test_ = false;
+
+  constexpr size_t     kBufSize = 32;
+  std::vector<uint8_t> storage(kBufSize * 4);
+  RCMcastRecvMsg       msgs[4];
+
+  // Two datagrams are queued, a partial batch of the four requested.
+  fake_recvmmsg_fake.custom_fake = [](int, struct mmsghdr* msgvec, unsigned int vlen, int, struct timespec*) {
+    EXPECT_GE(vlen, 2u);
+    FillRecvmmsgDatagram(&msgvec[0], 1, 10, 0);
+    FillRecvmmsgDatagram(&msgvec[1], 2, 20, 0);
+    return 2;
+  };
+
+  ASSERT_EQ(rc_mcast_recv_batch((etcpal_socket_t)1000, storage.data(), kBufSize, msgs, 4), 2);
+  ASSERT_EQ(fake_recvmmsg_fake.call_count, 1u);
+  EXPECT_EQ(fake_recvmmsg_fake.arg0_val, 1000);
+  EXPECT_EQ(fake_recvmmsg_fake.arg2_val, 4u);
+  EXPECT_NE(fake_recvmmsg_fake.arg3_val & MSG_DONTWAIT, 0);
+  EXPECT_EQ(etcpal_recvmsg_fake.call_count, 0u);
+
+  for (size_t i = 0; i < 2; ++i)
+  {
+    EXPECT_EQ(msgs[i].data, &storage[i * kBufSize]);
+    EXPECT_EQ(msgs[i].data_len, (i + 1) * 10);
+    EXPECT_EQ(msgs[i].data[0], i + 1);
+    EXPECT_EQ(etcpal::IpAddr(msgs[i].from.ip), etcpal::IpAddr::FromString("10.101.1.5"));
+    EXPECT_EQ(msgs[i].from.port, 5569);
+    EXPECT_FALSE(msgs[i].truncated);
+    EXPECT_FALSE(msgs[i].netint_valid);
+  }
+}
+
+TEST_F(TestMcast, RecvBatchFlagsTruncatedDatagramsFromRecvmmsg)
+{
+  initted_in_test_ = false;
+
+  constexpr size_t     kBufSize = 32;
+  std::vector<uint8_t> storage(kBufSize * 4);
+  RCMcastRecvMsg       msgs[4];
+
+  // The first datagram was longer than its buffer; the second lost its ancillary data.
+  fake_recvmmsg_fake.custom_fake = [](int, struct mmsghdr* msgvec, unsigned int, int, struct timespec*) {
+    FillRecvmmsgDatagram(&msgvec[0], 1, kBufSize + 10, MSG_TRUNC);
+    FillRecvmmsgDatagram(&msgvec[1], 2, 10, MSG_CTRUNC);
+    return 2;
+  };
+
+  ASSERT_EQ(rc_mcast_recv_batch((etcpal_socket_t)1000, storage.data(), kBufSize, msgs, 4), 2);
+  EXPECT_EQ(msgs[0].data_len, kBufSize);
+  EXPECT_TRUE(msgs[0].truncated);
+  EXPECT_EQ(msgs[1].data_len, 10u);
+  EXPECT_FALSE(msgs[1].truncated);
+  EXPECT_FALSE(msgs[1].netint_valid);
+}
+
+TEST_F(TestMcast, RecvBatchCapsRecvmmsgBatchSize)
+{
+  initted_in_test_ = false;
+
+  constexpr size_t            kBufSize = 32;
+  constexpr size_t            kMaxMsgs = RDMNET_MCAST_RECV_BATCH_SIZE + 4;
+  std::vector<uint8_t>        storage(kBufSize * kMaxMsgs);
+  std::vector<RCMcastRecvMsg> msgs(kMaxMsgs);
+
+  fake_recvmmsg_fake.custom_fake = [](int, struct mmsghdr*, unsigned int, int, struct timespec*) {
+    errno = EAGAIN;
+    return -1;
+  };
+
+  EXPECT_EQ(rc_mcast_recv_batch((etcpal_socket_t)1000, storage.data(), kBufSize, msgs.data(), kMaxMsgs), 0);
+  EXPECT_EQ(fake_recvmmsg_fake.arg2_val, static_cast<unsigned int>(RDMNET_MCAST_RECV_BATCH_SIZE));
+}
+
+TEST_F(TestMcast, RecvBatchMapsRecvmmsgErrors)
+{
+  initted_in_test_ = false;
+
+  constexpr size_t     kBufSize = 32;
+  std::vector<uint8_t> storage(kBufSize * 4);
+  RCMcastRecvMsg       msgs[4];
+
+  static int recvmmsg_errno;
+  fake_recvmmsg_fake.custom_fake = [](int, struct mmsghdr*, unsigned int, int, struct timespec*) {
+    errno = recvmmsg_errno;
+    return -1;
+  };
+
+  recvmmsg_errno = EAGAIN;
+  EXPECT_EQ(rc_mcast_recv_batch((etcpal_socket_t)1000, storage.data(), kBufSize, msgs, 4), 0);
+  recvmmsg_errno = EINTR;
+  EXPECT_EQ(rc_mcast_recv_batch((etcpal_socket_t)1000, storage.data(), kBufSize, msgs, 4), 0);
+  recvmmsg_errno = ENOBUFS;
+  EXPECT_EQ(rc_mcast_recv_batch((etcpal_socket_t)1000, storage.data(), kBufSize, msgs, 4), kEtcPalErrNoMem);
+  recvmmsg_errno = EBADF;
+  EXPECT_EQ(rc_mcast_recv_batch((etcpal_socket_t)1000, storage.data(), kBufSize, msgs, 4), kEtcPalErrSys);
+
+  // Only an unavailable recvmmsg() falls back to reading one datagram at a time.
+  EXPECT_EQ(etcpal_recvmsg_fake.call_count, 0u);
+}
+
+TEST_F(TestMcast, SendToNetintsBatchesEachIpTypeWithSendmmsg)
+{
+  initted_in_test_ = false;
+
+  const RCMcastSendNetint netints[] = {
+      {{kEtcPalIpTypeV4, 1}, (etcpal_socket_t)1000},
+      {{kEtcPalIpTypeV6, 2}, (etcpal_socket_t)1001},
+      {{kEtcPalIpTypeV4, 3}, (etcpal_socket_t)1002},
+  };
+  EtcPalSockAddr v4_dest;
+  v4_dest.ip = etcpal::IpAddr::FromString("239.255.250.133").get();
+  v4_dest.port = 5569;
+  EtcPalSockAddr v6_dest;
+  v6_dest.ip = etcpal::IpAddr::FromString("ff18::85:0:0:85").get();
+  v6_dest.port = 5569;
+  const uint8_t data[] = {0x01, 0x02, 0x03, 0x04};
+
+  // The messages only live for the duration of the call, so record what each one was sent on.
+  static std::vector<std::pair<int, unsigned int>> sent;
+  sent.clear();
+  fake_sendmmsg_fake.custom_fake = [](int sockfd, struct mmsghdr* msgvec, unsigned int vlen, int) {
+    for (unsigned int i = 0; i < vlen; ++i)
+    {
+      EXPECT_EQ(msgvec[i].msg_hdr.msg_iovlen, 1u);
+      EXPECT_EQ(msgvec[i].msg_hdr.msg_iov[0].iov_len, 4u);
+      sent.push_back({sockfd, GetPktInfoIndex(&msgvec[i].msg_hdr)});
+    }
+    return static_cast<int>(vlen);
+  };
+
+  EXPECT_EQ(kEtcPalErrOk, rc_mcast_send_to_netints(netints, 3, data, sizeof data, &v4_dest, &v6_dest));
+
+  // One call per IP type, each on the first socket of that type, selecting every interface.
+  EXPECT_EQ(fake_sendmmsg_fake.call_count, 2u);
+  const std::vector<std::pair<int, unsigned int>> expected = {{1000, 1}, {1000, 3}, {1001, 2}};
+  EXPECT_EQ(sent, expected);
+  EXPECT_EQ(etcpal_sendto_fake.call_count, 0u);
+}
+
+TEST_F(TestMcast, SendToNetintsRetriesDatagramsSendmmsgDidNotSend)
+{
+  initted_in_test_ = false;
+
+  const RCMcastSendNetint netints[] = {
+      {{kEtcPalIpTypeV4, 1}, (etcpal_socket_t)1000},
+      {{kEtcPalIpTypeV4, 2}, (etcpal_socket_t)1001},
+      {{kEtcPalIpTypeV4, 3}, (etcpal_socket_t)1002},
+  };
+  EtcPalSockAddr v4_dest;
+  v4_dest.ip = etcpal::IpAddr::FromString("239.255.250.133").get();
+  v4_dest.port = 5569;
+  const uint8_t data[] = {0x01, 0x02, 0x03, 0x04};
+
+  // sendmmsg() only gets the first datagram out.
+  fake_sendmmsg_fake.return_val = 1;
+  etcpal_sendto_fake.custom_fake = [](etcpal_socket_t, const void*, size_t size, int, const EtcPalSockAddr*) {
+    return (int)size;
+  };
+
+  EXPECT_EQ(kEtcPalErrOk, rc_mcast_send_to_netints(netints, 3, data, sizeof data, &v4_dest, nullptr));
+  EXPECT_EQ(fake_sendmmsg_fake.call_count, 1u);
+  ASSERT_EQ(etcpal_sendto_fake.call_count, 2u);
+  EXPECT_EQ(etcpal_sendto_fake.arg0_history[0], (etcpal_socket_t)1001);
+  EXPECT_EQ(etcpal_sendto_fake.arg0_history[1], (etcpal_socket_t)1002);
+  EXPECT_EQ(etcpal_sendto_fake.arg4_history[0], &v4_dest);
+}
+
+TEST_F(TestMcast, SendToNetintsSplitsLargeSetsIntoBatches)
+{
+  initted_in_test_ = false;
+
+  std::vector<RCMcastSendNetint> netints;
+  for (unsigned int i = 0; i < 20; ++i)
+    netints.push_back({{kEtcPalIpTypeV4, i + 1}, (etcpal_socket_t)(1000 + i)});
+  EtcPalSockAddr v4_dest;
+  v4_dest.ip = etcpal::IpAddr::FromString("239.255.250.133").get();
+  v4_dest.port = 5569;
+  const uint8_t data[] = {0x01, 0x02, 0x03, 0x04};
+
+  fake_sendmmsg_fake.custom_fake = [](int, struct mmsghdr*, unsigned int vlen, int) { return static_cast<int>(vlen); };
+
+  EXPECT_EQ(kEtcPalErrOk,
+            rc_mcast_send_to_netints(netints.data(), netints.size(), data, sizeof data, &v4_dest, nullptr));
+  ASSERT_EQ(fake_sendmmsg_fake.call_count, 2u);
+  EXPECT_EQ(fake_sendmmsg_fake.arg0_history[0], 1000);
+  EXPECT_EQ(fake_sendmmsg_fake.arg2_history[0], 16u);
+  EXPECT_EQ(fake_sendmmsg_fake.arg0_history[1], 1016);
+  EXPECT_EQ(fake_sendmmsg_fake.arg2_history[1], 4u);
+  EXPECT_EQ(etcpal_sendto_fake.call_count, 0u);
+}
+
+#endif  // defined(__linux__)
@@ -0,0 +1,186 @@
+/******************************************************************************
+ * Copyright 2020 ETC Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ ******************************************************************************
+ * This file is a part of RDMnet. For more information, go to:
+ * https://github.com/ETCLabs/RDMnet
+ *****************************************************************************/
+
+#include "rdmnet/core/util.h"
+
+#include <array>
+#include "gtest/gtest.h"
+
+struct TestRef
+{
+  uint32_t key;
+};
+
+extern "C" {
+static bool key_matches(void* ref, const void* context)
+{
+  return static_cast<TestRef*>(ref)->key == *static_cast<const uint32_t*>(context);
+}
+
+static uint32_t hash_key(uint32_t key)
+{
+  return rc_hash_bytes(&key, sizeof(key), RC_HASH_INIT);
+}
+
+static uint32_t ref_hash(const void* ref)
+{
+  return hash_key(static_cast<const TestRef*>(ref)->key);
+}
+
+// Puts every ref in one of two buckets, to exercise probing and removal around collisions.
+static uint32_t colliding_ref_hash(const void* ref)
+{
+  return static_cast<const TestRef*>(ref)->key % 2;
+}
+
+static unsigned int num_refs_still_indexed_on_remove;
+
+// Like the LLRP modules' cleanup functions, frees the ref from inside the on_remove callback.
+static void check_and_free_ref(void* ref, const void* context)
+{
+  TestRef* test_ref = static_cast<TestRef*>(ref);
+  if (rc_ref_lists_find_active(static_cast<const RCRefLists*>(context), hash_key(test_ref->key), key_matches,
+                               &test_ref->key))
+  {
+    ++num_refs_still_indexed_on_remove;
+  }
+  // Scribble over the key so that a hash of the freed ref doesn't happen to find the right slot.
+  test_ref->key = 0xffffffffu;
+  delete test_ref;
+}
+}
+
+static constexpr size_t kNumTestRefs = 20;
+
+RC_DECLARE_INDEXED_REF_LISTS(indexed_refs, kNumTestRefs, ref_hash);
+RC_DECLARE_INDEXED_REF_LISTS(colliding_refs, kNumTestRefs, colliding_ref_hash);
+RC_DECLARE_REF_LISTS(unindexed_refs, kNumTestRefs);
+
+class TestRefIndex : public testing::Test
+{
+protected:
+  std::array<TestRef, kNumTestRefs> refs_;
+
+  void SetUp() override
+  {
+    for (size_t i = 0; i < refs_.size(); ++i)
+      refs_[i].key = static_cast<uint32_t>(i * 7);
+
+    ASSERT_TRUE(rc_ref_lists_init(&indexed_refs));
+    ASSERT_TRUE(rc_ref_lists_init(&colliding_refs));
+    ASSERT_TRUE(rc_ref_lists_init(&unindexed_refs));
+  }
+
+  void TearDown() override
+  {
+    rc_ref_lists_cleanup(&indexed_refs);
+    rc_ref_lists_cleanup(&colliding_refs);
+    rc_ref_lists_cleanup(&unindexed_refs);
+  }
+
+  void AddAllRefs(RCRefLists* lists)
+  {
+    for (auto& ref : refs_)
+      ASSERT_TRUE(rc_ref_list_add_ref(&lists->pending, &ref));
+    rc_ref_lists_add_pending(lists);
+  }
+
+  void* Find(const RCRefLists* lists, uint32_t key, uint32_t hash)
+  {
+    return rc_ref_lists_find_active(lists, hash, key_matches, &key);
+  }
+};
+
+TEST_F(TestRefIndex, FindsActiveRefs)
+{
+  AddAllRefs(&indexed_refs);
+
+  for (auto& ref : refs_)
+    EXPECT_EQ(Find(&indexed_refs, ref.key, hash_key(ref.key)), &ref) << "Failed on key " << ref.key;
+  EXPECT_EQ(Find(&indexed_refs, 1, hash_key(1)), nullptr);
+}
+
+TEST_F(TestRefIndex, PendingRefsNotFound)
+{
+  ASSERT_TRUE(rc_ref_list_add_ref(&indexed_refs.pending, &refs_[0]));
+  EXPECT_EQ(Find(&indexed_refs, refs_[0].key, hash_key(refs_[0].key)), nullptr);
+
+  rc_ref_lists_add_pending(&indexed_refs);
+  EXPECT_EQ(Find(&indexed_refs, refs_[0].key, hash_key(refs_[0].key)), &refs_[0]);
+}
+
+TEST_F(TestRefIndex, RemovedRefsNotFound)
+{
+  AddAllRefs(&colliding_refs);
+
+  // Remove every third ref, leaving holes in the middle of the probe sequences
+  for (size_t i = 0; i < refs_.size(); i += 3)
+    ASSERT_TRUE(rc_ref_list_add_ref(&colliding_refs.to_remove, &refs_[i]));
+  rc_ref_lists_remove_marked(&colliding_refs, nullptr, nullptr);
+
+  for (size_t i = 0; i < refs_.size(); ++i)
+  {
+    const TestRef& ref = refs_[i];
+    void*          expected = (i % 3 == 0) ? nullptr : &refs_[i];
+    EXPECT_EQ(Find(&colliding_refs, ref.key, ref.key % 2), expected) << "Failed on key " << ref.key;
+  }
+}
+
+TEST_F(TestRefIndex, RemoveAllClearsIndex)
+{
+  AddAllRefs(&indexed_refs);
+  rc_ref_lists_remove_all(&indexed_refs, nullptr, nullptr);
+
+  for (auto& ref : refs_)
+    EXPECT_EQ(Find(&indexed_refs, ref.key, hash_key(ref.key)), nullptr);
+}
+
+TEST_F(TestRefIndex, RefsCanBeFreedFromOnRemove)
+{
+  num_refs_still_indexed_on_remove = 0;
+
+  std::array<TestRef*, kNumTestRefs> heap_refs;
+  for (size_t i = 0; i < heap_refs.size(); ++i)
+  {
+    heap_refs[i] = new TestRef{static_cast<uint32_t>(i * 7)};
+    ASSERT_TRUE(rc_ref_list_add_ref(&indexed_refs.pending, heap_refs[i]));
+  }
+  rc_ref_lists_add_pending(&indexed_refs);
+
+  // Remove half of the refs, then the rest, freeing each one as it is removed.
+  for (size_t i = 0; i < heap_refs.size(); i += 2)
+    ASSERT_TRUE(rc_ref_list_add_ref(&indexed_refs.to_remove, heap_refs[i]));
+  rc_ref_lists_remove_marked(&indexed_refs, check_and_free_ref, &indexed_refs);
+  EXPECT_EQ(num_refs_still_indexed_on_remove, 0u);
+
+  for (size_t i = 1; i < heap_refs.size(); i += 2)
+    EXPECT_EQ(Find(&indexed_refs, static_cast<uint32_t>(i * 7), hash_key(static_cast<uint32_t>(i * 7))), heap_refs[i]);
+
+  rc_ref_lists_remove_all(&indexed_refs, check_and_free_ref, &indexed_refs);
+  EXPECT_EQ(num_refs_still_indexed_on_remove, 0u);
+  EXPECT_EQ(indexed_refs.active.num_refs, 0u);
+}
+
+TEST_F(TestRefIndex, UnindexedListsSearchedLinearly)
+{
+  AddAllRefs(&unindexed_refs);
+
+  EXPECT_EQ(Find(&unindexed_refs, refs_[5].key, 0), &refs_[5]);
+  EXPECT_EQ(Find(&unindexed_refs, 1, 0), nullptr);
+}
@@ -0,0 +1,145 @@
+/******************************************************************************
+ * Copyright 2020 ETC Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ ******************************************************************************
+ * This file is a part of RDMnet. For more information, go to:
+ * https://github.com/ETCLabs/RDMnet
+ *****************************************************************************/
+
+#include "rdmnet/core/timer_wheel.h"
+
+#include <array>
+#include <vector>
+#include "etcpal_mock/common.h"
+#include "etcpal_mock/timer.h"
+#include "gtest/gtest.h"
+
+class TestTimerWheel : public testing::Test
+{
+protected:
+  static constexpr uint32_t kResolution = 100;
+
+  RCTimerWheel wheel_;
+
+  void SetUp() override
+  {
+    etcpal_reset_all_fakes();
+    rc_timer_wheel_init(&wheel_, kResolution);
+  }
+
+  // Advance the clock and the wheel, returning the entries that expired.
+  std::vector<RCTimerWheelEntry*> PassTimeAndAdvance(uint32_t time_to_pass)
+  {
+    etcpal_getms_fake.return_val += time_to_pass;
+    rc_timer_wheel_advance(&wheel_);
+
+    std::vector<RCTimerWheelEntry*> expired;
+    for (RCTimerWheelEntry* entry = rc_timer_wheel_pop_expired(&wheel_); entry;
+         entry = rc_timer_wheel_pop_expired(&wheel_))
+    {
+      expired.push_back(entry);
+    }
+    return expired;
+  }
+};
+
+TEST_F(TestTimerWheel, ZeroTimeoutExpiresOnNextAdvance)
+{
+  RCTimerWheelEntry entry{};
+  rc_timer_wheel_schedule(&wheel_, &entry, 0);
+  EXPECT_TRUE(rc_timer_wheel_is_scheduled(&entry));
+
+  auto expired = PassTimeAndAdvance(0);
+  ASSERT_EQ(expired.size(), 1u);
+  EXPECT_EQ(expired[0], &entry);
+  EXPECT_FALSE(rc_timer_wheel_is_scheduled(&entry));
+
+  EXPECT_TRUE(PassTimeAndAdvance(kResolution).empty());
+}
+
+TEST_F(TestTimerWheel, ExpiresAtOrAfterDeadline)
+{
+  RCTimerWheelEntry entry{};
+  rc_timer_wheel_schedule(&wheel_, &entry, 1050);
+
+  EXPECT_TRUE(PassTimeAndAdvance(1000).empty());
+  EXPECT_TRUE(PassTimeAndAdvance(49).empty());
+
+  auto expired = PassTimeAndAdvance(100);
+  ASSERT_EQ(expired.size(), 1u);
+  EXPECT_EQ(expired[0], &entry);
+}
+
+TEST_F(TestTimerWheel, CascadesLongTimeouts)
+{
+  // Timeouts spanning the first, second and third levels of the wheel
+  const std::array<uint32_t, 4> kTimeouts{{500, 15000, 30000, 1000000}};
+
+  std::array<RCTimerWheelEntry, 4> entries{};
+  for (size_t i = 0; i < entries.size(); ++i)
+    rc_timer_wheel_schedule(&wheel_, &entries[i], kTimeouts[i]);
+
+  uint32_t elapsed = 0;
+  size_t   num_expired = 0;
+  while (num_expired < entries.size() && elapsed <= kTimeouts.back() + kResolution)
+  {
+    elapsed += kResolution;
+    for (RCTimerWheelEntry* entry : PassTimeAndAdvance(kResolution))
+    {
+      ASSERT_EQ(entry, &entries[num_expired]);
+      EXPECT_GE(elapsed, kTimeouts[num_expired]);
+      EXPECT_LT(elapsed, kTimeouts[num_expired] + kResolution);
+      ++num_expired;
+    }
+  }
+  EXPECT_EQ(num_expired, entries.size());
+}
+
+TEST_F(TestTimerWheel, CatchesUpAfterLongGap)
+{
+  RCTimerWheelEntry entry{};
+  rc_timer_wheel_schedule(&wheel_, &entry, 20000);
+
+  auto expired = PassTimeAndAdvance(60000);
+  ASSERT_EQ(expired.size(), 1u);
+  EXPECT_EQ(expired[0], &entry);
+}
+
+TEST_F(TestTimerWheel, CancelAndRescheduleWork)
+{
+  RCTimerWheelEntry entry{};
+  rc_timer_wheel_schedule(&wheel_, &entry, 500);
+  rc_timer_wheel_cancel(&wheel_, &entry);
+  EXPECT_FALSE(rc_timer_wheel_is_scheduled(&entry));
+  EXPECT_TRUE(PassTimeAndAdvance(1000).empty());
+
+  // Rescheduling replaces the previous deadline
+  rc_timer_wheel_schedule(&wheel_, &entry, 500);
+  rc_timer_wheel_schedule(&wheel_, &entry, 2000);
+  EXPECT_TRUE(PassTimeAndAdvance(1000).empty());
+  EXPECT_EQ(PassTimeAndAdvance(1000).size(), 1u);
+}
+
+TEST_F(TestTimerWheel, RescheduledWhilePoppingNotReturnedAgain)
+{
+  RCTimerWheelEntry entry{};
+  rc_timer_wheel_schedule(&wheel_, &entry, 0);
+  rc_timer_wheel_advance(&wheel_);
+
+  ASSERT_EQ(rc_timer_wheel_pop_expired(&wheel_), &entry);
+  rc_timer_wheel_schedule(&wheel_, &entry, 0);
+  EXPECT_EQ(rc_timer_wheel_pop_expired(&wheel_), nullptr);
+
+  EXPECT_EQ(PassTimeAndAdvance(0).size(), 1u);
+}
@@ -57,6 +57,12 @@ protected:
         discovered_broker_new(monitor_ref_, service_instance_name_.c_str(), full_service_name_.c_str()));
   }
 
+  DiscoveredBrokerUniquePtr MakeDiscoveredBroker(const std::string& service_instance_name)
+  {
+    return DiscoveredBrokerUniquePtr(
+        discovered_broker_new(monitor_ref_, service_instance_name.c_str(), full_service_name_.c_str()));
+  }
+
   const std::string      service_instance_name_ = "Test service name";
   const std::string      full_service_name_ = "Test full service name";
   rdmnet_scope_monitor_t monitor_ref_ = reinterpret_cast<rdmnet_scope_monitor_t>(0xcc);
@@ -80,52 +86,75 @@ TEST_F(TestDiscoveredBroker, NewInitializesFieldsProperly)
   EXPECT_EQ(db->next, nullptr);
 }
 
-TEST_F(TestDiscoveredBroker, InsertWorksAtHeadOfList)
+TEST_F(TestDiscoveredBroker, InsertWorksOnEmptyTable)
 {
-  DiscoveredBroker to_insert{};
+  DiscoveredBrokerTable table;
+  discovered_broker_table_init(&table);
 
-  DiscoveredBroker* list = nullptr;
-  discovered_broker_insert(&list, &to_insert);
-  EXPECT_EQ(list, &to_insert);
-}
-
-TEST_F(TestDiscoveredBroker, InsertWorksAtEndOfList)
-{
-  // Create a list head -> dummy_1 -> dummy_2 -> end
-  DiscoveredBroker dummy_1{};
-  DiscoveredBroker dummy_2{};
-  dummy_1.next = &dummy_2;
-  DiscoveredBroker* list = &dummy_1;
-
-  // Insert to_insert, should be at the end of the list
-  DiscoveredBroker to_insert{};
-  discovered_broker_insert(&list, &to_insert);
-  EXPECT_EQ(list, &dummy_1);
-  EXPECT_EQ(dummy_1.next, &dummy_2);
-  EXPECT_EQ(dummy_2.next, &to_insert);
+  auto db = MakeDefaultDiscoveredBroker();
+  discovered_broker_table_insert(&table, db.get());
+  EXPECT_EQ(table.head, db.get());
+  EXPECT_EQ(table.tail, db.get());
+  EXPECT_EQ(table.num_brokers, 1u);
+  EXPECT_EQ(db->next, nullptr);
+  EXPECT_EQ(db->prev, nullptr);
 }
 
-TEST_F(TestDiscoveredBroker, RemoveWorksAtHeadOfList)
+TEST_F(TestDiscoveredBroker, InsertWorksAtEndOfTable)
 {
-  DiscoveredBroker to_remove{};
-
-  DiscoveredBroker* list = &to_remove;
-  discovered_broker_remove(&list, &to_remove);
-  EXPECT_EQ(list, nullptr);
+  DiscoveredBrokerTable table;
+  discovered_broker_table_init(&table);
+
+  auto dummy_1 = MakeDiscoveredBroker("Dummy 1");
+  auto dummy_2 = MakeDiscoveredBroker("Dummy 2");
+  discovered_broker_table_insert(&table, dummy_1.get());
+  discovered_broker_table_insert(&table, dummy_2.get());
+
+  // Insert to_insert, should be at the end of the table
+  auto to_insert = MakeDiscoveredBroker("To Insert");
+  discovered_broker_table_insert(&table, to_insert.get());
+  EXPECT_EQ(table.head, dummy_1.get());
+  EXPECT_EQ(dummy_1->next, dummy_2.get());
+  EXPECT_EQ(dummy_2->next, to_insert.get());
+  EXPECT_EQ(to_insert->prev, dummy_2.get());
+  EXPECT_EQ(table.tail, to_insert.get());
+  EXPECT_EQ(table.num_brokers, 3u);
 }
 
-TEST_F(TestDiscoveredBroker, RemoveWorksAtEndOfList)
+TEST_F(TestDiscoveredBroker, RemoveWorksAnywhereInTable)
 {
-  // Create a list head -> dummy_1 -> dummy_2 -> end
-  DiscoveredBroker dummy_1{};
-  DiscoveredBroker dummy_2{};
-  dummy_1.next = &dummy_2;
-  DiscoveredBroker* list = &dummy_1;
-
-  // Remove dummy_2 from the list
-  discovered_broker_remove(&list, &dummy_2);
-  EXPECT_EQ(list, &dummy_1);
-  EXPECT_EQ(dummy_1.next, nullptr);
+  DiscoveredBrokerTable table;
+  discovered_broker_table_init(&table);
+
+  auto dummy_1 = MakeDiscoveredBroker("Dummy 1");
+  auto dummy_2 = MakeDiscoveredBroker("Dummy 2");
+  auto dummy_3 = MakeDiscoveredBroker("Dummy 3");
+  discovered_broker_table_insert(&table, dummy_1.get());
+  discovered_broker_table_insert(&table, dummy_2.get());
+  discovered_broker_table_insert(&table, dummy_3.get());
+
+  // Middle
+  discovered_broker_table_remove(&table, dummy_2.get());
+  EXPECT_EQ(table.head, dummy_1.get());
+  EXPECT_EQ(dummy_1->next, dummy_3.get());
+  EXPECT_EQ(dummy_3->prev, dummy_1.get());
+  EXPECT_EQ(discovered_broker_table_find_by_name(&table, "Dummy 2", nullptr), nullptr);
+
+  // End
+  discovered_broker_table_remove(&table, dummy_3.get());
+  EXPECT_EQ(table.tail, dummy_1.get());
+  EXPECT_EQ(dummy_1->next, nullptr);
+
+  // Head
+  discovered_broker_table_remove(&table, dummy_1.get());
+  EXPECT_EQ(table.head, nullptr);
+  EXPECT_EQ(table.tail, nullptr);
+  EXPECT_EQ(table.num_brokers, 0u);
+  EXPECT_EQ(discovered_broker_table_find_by_name(&table, "Dummy 1", nullptr), nullptr);
+
+  // Removing a broker that isn't in the table does nothing
+  discovered_broker_table_remove(&table, dummy_1.get());
+  EXPECT_EQ(table.num_brokers, 0u);
 }
 
 TEST_F(TestDiscoveredBroker, AddListenAddrWorks)
@@ -228,27 +257,38 @@ TEST_F(TestDiscoveredBroker, FindByNameWorks)
   // An array of DiscoveredBroker pointers that will automatically call discovered_broker_delete()
   // on each one on destruction.
 #if RDMNET_DYNAMIC_MEM
-  constexpr size_t kNumBrokers = 10;
+  constexpr size_t kNumBrokers = 100;
 #else
   constexpr size_t kNumBrokers = RDMNET_MAX_DISCOVERED_BROKERS_PER_SCOPE;
 #endif
   std::array<DiscoveredBrokerUniquePtr, kNumBrokers> brokers;
-  DiscoveredBroker*                                  list = nullptr;
+  DiscoveredBrokerTable                              table;
+  discovered_broker_table_init(&table);
 
-  // Fill the array and linked list of DiscoveredBrokers
-  for (int i = 0; i < kNumBrokers; ++i)
+  // Fill the array and table of DiscoveredBrokers
+  for (size_t i = 0; i < kNumBrokers; ++i)
   {
+    const auto this_service_name = service_instance_name_ + " " + std::to_string(i);
     const auto this_full_service_name = full_service_name_ + " " + std::to_string(i);
-    brokers[i].reset(
-        discovered_broker_new(monitor_ref_, service_instance_name_.c_str(), this_full_service_name.c_str()));
-    discovered_broker_insert(&list, brokers[i].get());
+    brokers[i].reset(discovered_broker_new(monitor_ref_, this_service_name.c_str(), this_full_service_name.c_str()));
+    ASSERT_NE(brokers[i], nullptr);
+    discovered_broker_table_insert(&table, brokers[i].get());
+  }
+
+  for (size_t i = 0; i < kNumBrokers; ++i)
+  {
+    const auto this_service_name = service_instance_name_ + " " + std::to_string(i);
+    EXPECT_EQ(discovered_broker_table_find_by_name(&table, this_service_name.c_str(), nullptr), brokers[i].get());
   }
 
-  // Find the kNumBrokers / 2 broker instance by name.
-  auto found_db = discovered_broker_find_by_name(
-      list, std::string(full_service_name_ + " " + std::to_string(kNumBrokers / 2)).c_str());
+  // Find the kNumBrokers / 2 broker instance by both of its names.
+  const auto service_name = service_instance_name_ + " " + std::to_string(kNumBrokers / 2);
+  const auto full_service_name = full_service_name_ + " " + std::to_string(kNumBrokers / 2);
+  auto found_db = discovered_broker_table_find_by_name(&table, service_name.c_str(), full_service_name.c_str());
   ASSERT_NE(found_db, nullptr);
-  ASSERT_EQ(found_db->full_service_name, full_service_name_ + " " + std::to_string(kNumBrokers / 2));
+  EXPECT_EQ(found_db->full_service_name, full_service_name);
+  EXPECT_EQ(discovered_broker_table_find_by_name(&table, service_name.c_str(), full_service_name_.c_str()), nullptr);
+  EXPECT_EQ(discovered_broker_table_find_by_name(&table, service_instance_name_.c_str(), nullptr), nullptr);
 }
 
 TEST_F(TestDiscoveredBroker, FindByPredicateWorks)
@@ -261,25 +301,26 @@ TEST_F(TestDiscoveredBroker, FindByPredicateWorks)
   constexpr size_t kNumBrokers = RDMNET_MAX_DISCOVERED_BROKERS_PER_SCOPE;
 #endif
   std::array<DiscoveredBrokerUniquePtr, kNumBrokers> brokers;
-  DiscoveredBroker*                                  list = nullptr;
+  DiscoveredBrokerTable                              table;
+  discovered_broker_table_init(&table);
 
   static const etcpal::Uuid kCidToFind = etcpal::Uuid::FromString("6ac29c1d-515a-437f-a7bf-e8624b4ee7ec");
   static const void*        kContext = reinterpret_cast<const void*>(0x12345678);
 
-  // Fill the array and linked list of DiscoveredBrokers
-  for (int i = 0; i < kNumBrokers; ++i)
+  // Fill the array and table of DiscoveredBrokers
+  for (size_t i = 0; i < kNumBrokers; ++i)
   {
-    brokers[i] = MakeDefaultDiscoveredBroker();
+    brokers[i] = MakeDiscoveredBroker(service_instance_name_ + " " + std::to_string(i));
     if (i == kNumBrokers / 2)
       brokers[i]->cid = kCidToFind.get();
     else
       brokers[i]->cid = etcpal::Uuid::V4().get();
-    discovered_broker_insert(&list, brokers[i].get());
+    discovered_broker_table_insert(&table, brokers[i].get());
   }
 
   // Find the kNumBrokers / 2 broker instance by CID using a predicate function.
-  auto found_db = discovered_broker_find(
-      list,
+  auto found_db = discovered_broker_table_find(
+      &table,
       [](const DiscoveredBroker* db, const void* context) {
         EXPECT_EQ(context, kContext);
         return (db->cid == kCidToFind);
@@ -289,6 +330,48 @@ TEST_F(TestDiscoveredBroker, FindByPredicateWorks)
   ASSERT_EQ(found_db->cid, kCidToFind);
 }
 
+TEST_F(TestDiscoveredBroker, RemoveIfRemovesAllMatchesInOnePass)
+{
+#if RDMNET_DYNAMIC_MEM
+  constexpr size_t kNumBrokers = 10;
+#else
+  constexpr size_t kNumBrokers = RDMNET_MAX_DISCOVERED_BROKERS_PER_SCOPE;
+#endif
+  std::array<DiscoveredBrokerUniquePtr, kNumBrokers> brokers;
+  DiscoveredBrokerTable                              table;
+  discovered_broker_table_init(&table);
+
+  for (size_t i = 0; i < kNumBrokers; ++i)
+  {
+    brokers[i] = MakeDiscoveredBroker(service_instance_name_ + " " + std::to_string(i));
+    brokers[i]->port = static_cast<uint16_t>(i);
+    discovered_broker_table_insert(&table, brokers[i].get());
+  }
+
+  // Remove the brokers with even ports. The array still owns them, so they are only recorded here.
+  static std::vector<DiscoveredBroker*> removed;
+  removed.clear();
+  size_t num_removed = discovered_broker_table_remove_if(
+      &table, [](const DiscoveredBroker* db, const void*) { return db->port % 2 == 0; },
+      [](DiscoveredBroker* db, const void*) { removed.push_back(db); }, nullptr);
+
+  EXPECT_EQ(num_removed, (kNumBrokers + 1) / 2);
+  EXPECT_EQ(removed.size(), num_removed);
+  EXPECT_EQ(table.num_brokers, kNumBrokers - num_removed);
+
+  // The remaining brokers keep their order.
+  size_t i = 1;
+  for (const DiscoveredBroker* db = table.head; db && i < kNumBrokers; db = db->next, i += 2)
+    EXPECT_EQ(db, brokers[i].get());
+
+  for (i = 0; i < kNumBrokers; ++i)
+  {
+    const auto service_name = service_instance_name_ + " " + std::to_string(i);
+    auto       found_db = discovered_broker_table_find_by_name(&table, service_name.c_str(), nullptr);
+    EXPECT_EQ(found_db, (i % 2 == 0 ? nullptr : brokers[i].get()));
+  }
+}
+
 TEST_F(TestDiscoveredBroker, ConvertToDiscInfoWorks)
 {
   auto         listen_addr = etcpal::IpAddr::FromString("192.168.30.40").get();
@@ -161,7 +161,7 @@ TEST_F(TestDiscoveryCommon, BrokerNotRegisteredWhenConflictingBrokersPresent)
   // Add a conflicting broker
   DiscoveredBroker* db = discovered_broker_new(broker_handle->scope_monitor_handle, "Other Test Broker",
                                                "Other Test Broker._rdmnet._tcp.local.");
-  discovered_broker_insert(&broker_handle->scope_monitor_handle->broker_list, db);
+  discovered_broker_table_insert(&broker_handle->scope_monitor_handle->brokers, db);
 
   rdmnet_disc_module_tick();
 
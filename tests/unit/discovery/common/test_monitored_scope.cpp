@@ -23,6 +23,7 @@
 #include <cstring>
 #include <memory>
 #include <string>
+#include <vector>
 #include "rdmnet/core/util.h"
 #include "rdmnet/disc/discovered_broker.h"
 #include "gtest/gtest.h"
@@ -80,7 +81,7 @@ TEST_F(TestMonitoredScope, NewInitializesFieldsProperly)
   EXPECT_STREQ(ref->scope, default_config_.scope);
   EXPECT_STREQ(ref->domain, default_config_.domain);
   EXPECT_EQ(ref->broker_handle, nullptr);
-  EXPECT_EQ(ref->broker_list, nullptr);
+  EXPECT_EQ(ref->brokers.head, nullptr);
 }
 
 TEST_F(TestMonitoredScope, InsertWorks)
@@ -193,7 +194,7 @@ TEST_F(TestMonitoredScope, FindScopeAndBrokerWorks)
       auto db = discovered_broker_new(
           scope.get(), std::string("Test Service Instance " + std::to_string(i * kNumBrokersPerScope + j)).c_str(), "");
       ASSERT_NE(db, nullptr);
-      discovered_broker_insert(&scope->broker_list, db);
+      discovered_broker_table_insert(&scope->brokers, db);
     }
     scope_monitor_insert(scope.get());
     scopes.push_back(std::move(scope));
@@ -216,6 +217,40 @@ TEST_F(TestMonitoredScope, FindScopeAndBrokerWorks)
   EXPECT_STREQ(found_db->service_instance_name, "Test Service Instance 8");
 }
 
+TEST_F(TestMonitoredScope, FindBrokerByNameWorks)
+{
+  std::vector<ScopeMonitorUniquePtr> scopes;
+  constexpr int                      kNumScopes = 2;
+  constexpr int                      kNumBrokersPerScope = 3;
+
+  for (int i = 0; i < kNumScopes; ++i)
+  {
+    auto scope = MakeDefaultMonitoredScope();
+    std::strcpy(scope->scope, std::string("Test Scope " + std::to_string(i)).c_str());
+    for (int j = 0; j < kNumBrokersPerScope; ++j)
+    {
+      auto db = discovered_broker_new(
+          scope.get(), std::string("Test Service Instance " + std::to_string(i * kNumBrokersPerScope + j)).c_str(), "");
+      ASSERT_NE(db, nullptr);
+      discovered_broker_table_insert(&scope->brokers, db);
+    }
+    scope_monitor_insert(scope.get());
+    scopes.push_back(std::move(scope));
+  }
+
+  DiscoveredBroker* found_db = scope_monitor_find_broker_by_name("Test Service Instance 4");
+  ASSERT_NE(found_db, nullptr);
+  EXPECT_EQ(found_db->monitor_ref, scopes[1].get());
+  EXPECT_STREQ(found_db->service_instance_name, "Test Service Instance 4");
+
+  EXPECT_EQ(scope_monitor_find_broker_by_name("Test Service Instance 6"), nullptr);
+
+  // Brokers of monitors that have been removed aren't found.
+  scope_monitor_remove(scopes[1].get());
+  EXPECT_EQ(scope_monitor_find_broker_by_name("Test Service Instance 4"), nullptr);
+  EXPECT_NE(scope_monitor_find_broker_by_name("Test Service Instance 1"), nullptr);
+}
+
 // Needs to be at file scope because of C function pointers/stateless lambdas
 static int remove_test_call_count = 0;
 
@@ -0,0 +1,231 @@
+/******************************************************************************
+ * Copyright 2020 ETC Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ ******************************************************************************
+ * This file is a part of RDMnet. For more information, go to:
+ * https://github.com/ETCLabs/RDMnet
+ *****************************************************************************/
+
+#include "lwmdns_cache.h"
+
+#include <cstring>
+#include <string>
+#include <vector>
+#include "gtest/gtest.h"
+#include "fff.h"
+#include "etcpal_mock/common.h"
+#include "etcpal_mock/timer.h"
+#include "lwmdns_common.h"
+
+FAKE_VOID_FUNC(requery_record, const LwMdnsCacheEntry*);
+FAKE_VOID_FUNC(expire_record, const LwMdnsCacheEntry*);
+
+class TestLwMdnsCache : public testing::Test
+{
+protected:
+  // _default._sub._rdmnet._tcp.local
+  const std::vector<uint8_t> kDefaultSubtype = {
+      8, 95,  100, 101, 102, 97,  117, 108, 116,  // _default
+      4, 95,  115, 117, 98,                       // _sub
+      7, 95,  114, 100, 109, 110, 101, 116,       // _rdmnet
+      4, 95,  116, 99,  112,                      // _tcp
+      5, 108, 111, 99,  97,  108, 0               // local
+  };
+  // test-host.local
+  const std::vector<uint8_t> kHostName = {
+      9, 116, 101, 115, 116, 45, 104, 111, 115, 116,  // test-host
+      5, 108, 111, 99,  97,  108, 0                   // local
+  };
+
+  void SetUp() override
+  {
+    etcpal_reset_all_fakes();
+    RESET_FAKE(requery_record);
+    RESET_FAKE(expire_record);
+    ASSERT_EQ(lwmdns_cache_module_init(), kEtcPalErrOk);
+  }
+
+  void TearDown() override { lwmdns_cache_module_deinit(); }
+
+  // Cache a record as if it had been received in a response. Names must be uncompressed.
+  void CacheRecord(const std::vector<uint8_t>& name,
+                   dns_record_type_t           type,
+                   const std::vector<uint8_t>& data,
+                   uint32_t                    ttl,
+                   bool                        cache_flush = false)
+  {
+    DnsResourceRecord rr{};
+    rr.name = name.data();
+    rr.record_type = type;
+    rr.cache_flush = cache_flush;
+    rr.ttl = ttl;
+    rr.data_len = static_cast<uint16_t>(data.size());
+    rr.data_ptr = data.data();
+    lwmdns_cache_add(name.data(), &rr);
+  }
+
+  // <label>._rdmnet._tcp.local
+  std::vector<uint8_t> ServiceName(const std::string& label) const
+  {
+    std::vector<uint8_t> name = {static_cast<uint8_t>(label.size())};
+    name.insert(name.end(), label.begin(), label.end());
+    name.insert(name.end(), {7, 95, 114, 100, 109, 110, 101, 116, 4, 95, 116, 99, 112, 5, 108, 111, 99, 97, 108, 0});
+    return name;
+  }
+
+  // SRV data pointing to port 8888 on test-host.local
+  std::vector<uint8_t> SrvData() const
+  {
+    std::vector<uint8_t> data = {0, 0, 0, 0, 0x22, 0xb8};
+    data.insert(data.end(), kHostName.begin(), kHostName.end());
+    return data;
+  }
+
+  void ProcessAt(uint32_t time_ms)
+  {
+    etcpal_getms_fake.return_val = time_ms;
+    lwmdns_cache_process(requery_record, expire_record);
+  }
+};
+
+TEST_F(TestLwMdnsCache, CachesRdmnetRecords)
+{
+  CacheRecord(kDefaultSubtype, kDnsRecordTypePTR, ServiceName("Test"), 4500);
+  CacheRecord(ServiceName("Test"), kDnsRecordTypeSRV, SrvData(), 120);
+  CacheRecord(ServiceName("Test"), kDnsRecordTypeTXT, {3, 97, 61, 98}, 4500);
+  CacheRecord(kHostName, kDnsRecordTypeA, {10, 101, 20, 30}, 120);
+  EXPECT_EQ(lwmdns_cache_size(), 4u);
+
+  // The most recent record is first.
+  const LwMdnsCacheEntry* entry = lwmdns_cache_next(nullptr);
+  ASSERT_NE(entry, nullptr);
+  EXPECT_EQ(entry->record_type, kDnsRecordTypeA);
+  EXPECT_EQ(entry->ttl, 120u);
+  ASSERT_EQ(entry->data_len, 4u);
+  EXPECT_EQ(std::memcmp(entry->data, "\x0a\x65\x14\x1e", 4), 0);
+  EXPECT_EQ(std::memcmp(entry->name, kHostName.data(), kHostName.size()), 0);
+}
+
+TEST_F(TestLwMdnsCache, IgnoresUnrelatedRecords)
+{
+  // Another service type
+  const std::vector<uint8_t> kHttpService = {
+      5, 95,  104, 116, 116, 112,  // _http
+      4, 95,  116, 99,  112,       // _tcp
+      5, 108, 111, 99,  97,  108, 0  // local
+  };
+  CacheRecord(kHttpService, kDnsRecordTypePTR, ServiceName("Test"), 4500);
+
+  // An address record for a host that no cached service instance points to
+  CacheRecord(kHostName, kDnsRecordTypeA, {10, 101, 20, 30}, 120);
+
+  // A record with a TTL of 0 that isn't already cached
+  CacheRecord(kDefaultSubtype, kDnsRecordTypePTR, ServiceName("Test"), 0);
+
+  EXPECT_EQ(lwmdns_cache_size(), 0u);
+}
+
+TEST_F(TestLwMdnsCache, RefreshesExistingRecords)
+{
+  CacheRecord(kDefaultSubtype, kDnsRecordTypePTR, ServiceName("Test"), 4500);
+  etcpal_getms_fake.return_val = 10000;
+  CacheRecord(kDefaultSubtype, kDnsRecordTypePTR, ServiceName("Test"), 120);
+
+  ASSERT_EQ(lwmdns_cache_size(), 1u);
+  const LwMdnsCacheEntry* entry = lwmdns_cache_next(nullptr);
+  EXPECT_EQ(entry->ttl, 120u);
+  EXPECT_EQ(lwmdns_cache_entry_remaining_ttl(entry), 120u);
+
+  // A record with different data is a different record.
+  CacheRecord(kDefaultSubtype, kDnsRecordTypePTR, ServiceName("Test 2"), 120);
+  EXPECT_EQ(lwmdns_cache_size(), 2u);
+}
+
+TEST_F(TestLwMdnsCache, RequeriesAsRecordsNearExpiry)
+{
+  CacheRecord(kDefaultSubtype, kDnsRecordTypePTR, ServiceName("Test"), 100);
+
+  // Requeries are sent at 80%, 85%, 90% and 95% of the TTL, plus up to 2% of random variation.
+  ProcessAt(79000);
+  EXPECT_EQ(requery_record_fake.call_count, 0u);
+  ProcessAt(83000);
+  EXPECT_EQ(requery_record_fake.call_count, 1u);
+  ProcessAt(84000);
+  EXPECT_EQ(requery_record_fake.call_count, 1u);
+  ProcessAt(88000);
+  EXPECT_EQ(requery_record_fake.call_count, 2u);
+  ProcessAt(93000);
+  EXPECT_EQ(requery_record_fake.call_count, 3u);
+  ProcessAt(98000);
+  EXPECT_EQ(requery_record_fake.call_count, 4u);
+  ProcessAt(99000);
+  EXPECT_EQ(requery_record_fake.call_count, 4u);
+  EXPECT_EQ(expire_record_fake.call_count, 0u);
+
+  // An answer to the requery resets the schedule.
+  CacheRecord(kDefaultSubtype, kDnsRecordTypePTR, ServiceName("Test"), 100);
+  ProcessAt(178000);
+  EXPECT_EQ(requery_record_fake.call_count, 4u);
+  ProcessAt(182000);
+  EXPECT_EQ(requery_record_fake.call_count, 5u);
+}
+
+TEST_F(TestLwMdnsCache, DoesNotRequeryWithoutRequeryFunction)
+{
+  CacheRecord(kDefaultSubtype, kDnsRecordTypePTR, ServiceName("Test"), 100);
+  etcpal_getms_fake.return_val = 90000;
+  lwmdns_cache_process(nullptr, expire_record);
+  EXPECT_EQ(lwmdns_cache_size(), 1u);
+}
+
+TEST_F(TestLwMdnsCache, RemovesExpiredRecords)
+{
+  CacheRecord(kDefaultSubtype, kDnsRecordTypePTR, ServiceName("Test"), 100);
+  CacheRecord(kDefaultSubtype, kDnsRecordTypePTR, ServiceName("Test 2"), 200);
+
+  ProcessAt(100001);
+  EXPECT_EQ(expire_record_fake.call_count, 1u);
+  ASSERT_EQ(lwmdns_cache_size(), 1u);
+  EXPECT_EQ(lwmdns_cache_next(nullptr)->ttl, 200u);
+}
+
+TEST_F(TestLwMdnsCache, RemovesGoodbyeRecordsAfterOneSecond)
+{
+  CacheRecord(kDefaultSubtype, kDnsRecordTypePTR, ServiceName("Test"), 4500);
+  etcpal_getms_fake.return_val = 10000;
+  CacheRecord(kDefaultSubtype, kDnsRecordTypePTR, ServiceName("Test"), 0);
+
+  ProcessAt(10500);
+  EXPECT_EQ(lwmdns_cache_size(), 1u);
+  ProcessAt(11001);
+  EXPECT_EQ(lwmdns_cache_size(), 0u);
+  EXPECT_EQ(expire_record_fake.call_count, 1u);
+
+  // A record that is going away isn't requeried.
+  EXPECT_EQ(requery_record_fake.call_count, 0u);
+}
+
+TEST_F(TestLwMdnsCache, CacheFlushReplacesOlderRecords)
+{
+  CacheRecord(ServiceName("Test"), kDnsRecordTypeTXT, {3, 97, 61, 98}, 4500);
+  etcpal_getms_fake.return_val = 10000;
+  CacheRecord(ServiceName("Test"), kDnsRecordTypeTXT, {3, 97, 61, 99}, 4500, true);
+
+  ASSERT_EQ(lwmdns_cache_size(), 1u);
+  EXPECT_EQ(lwmdns_cache_next(nullptr)->data[3], 99u);
+
+  // Records received within the last second are kept, as they may be part of the same answer.
+  CacheRecord(ServiceName("Test"), kDnsRecordTypeTXT, {3, 97, 61, 100}, 4500, true);
+  EXPECT_EQ(lwmdns_cache_size(), 2u);
+}
@@ -463,6 +463,44 @@ TEST_F(TestLwMdnsDomainParsing, DomainNameMatchesServiceSubtypeHandlesInvalid)
   EXPECT_FALSE(lwmdns_domain_name_matches_service_subtype(msg, msg, NULL));
 }
 
+TEST_F(TestLwMdnsDomainParsing, DomainNameIsRdmnetWorks)
+{
+  const uint8_t service_type[] = {
+      7, 95,  114, 100, 109, 110, 101, 116,  // _rdmnet
+      4, 95,  116, 99,  112,                 // _tcp
+      5, 108, 111, 99,  97,  108, 0          // local
+  };
+  EXPECT_TRUE(lwmdns_domain_name_is_rdmnet(service_type, service_type));
+
+  const uint8_t subtype[] = {
+      8, 95,  100, 101, 102, 97,  117, 108, 116,  // _default
+      4, 95,  115, 117, 98,                       // _sub
+      7, 95,  114, 100, 109, 110, 101, 116,       // _rdmnet
+      4, 95,  116, 99,  112,                      // _tcp
+      5, 108, 111, 99,  97,  108, 0               // local
+  };
+  EXPECT_TRUE(lwmdns_domain_name_is_rdmnet(subtype, subtype));
+
+  const uint8_t broker_host[] = {
+      10, 114, 100, 109, 110, 101, 116, 45, 49, 50, 51,  // rdmnet-123
+      5,  108, 111, 99,  97,  108, 0                     // local
+  };
+  EXPECT_TRUE(lwmdns_domain_name_is_rdmnet(broker_host, broker_host));
+
+  const uint8_t http_service[] = {
+      5, 95,  104, 116, 116, 112,    // _http
+      4, 95,  116, 99,  112,         // _tcp
+      5, 108, 111, 99,  97,  108, 0  // local
+  };
+  EXPECT_FALSE(lwmdns_domain_name_is_rdmnet(http_service, http_service));
+
+  const uint8_t other_host[] = {
+      9, 116, 101, 115, 116, 45, 104, 111, 115, 116,  // test-host
+      5, 108, 111, 99,  97,  108, 0                   // local
+  };
+  EXPECT_FALSE(lwmdns_domain_name_is_rdmnet(other_host, other_host));
+}
+
 TEST_F(TestLwMdnsDomainParsing, DomainNameLabelToStringWorks)
 {
   const uint8_t msg[] = {
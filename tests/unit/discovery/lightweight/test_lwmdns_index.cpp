@@ -0,0 +1,186 @@
+/******************************************************************************
+ * Copyright 2020 ETC Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ ******************************************************************************
+ * This file is a part of RDMnet. For more information, go to:
+ * https://github.com/ETCLabs/RDMnet
+ *****************************************************************************/
+
+#include "lwmdns_index.h"
+
+#include <cstring>
+#include <string>
+#include <vector>
+#include "gtest/gtest.h"
+#include "etcpal_mock/common.h"
+#include "rdmnet/core/util.h"
+
+class TestLwMdnsIndex : public testing::Test
+{
+protected:
+  RdmnetScopeMonitorRef monitor_a_{};
+  RdmnetScopeMonitorRef monitor_b_{};
+
+  // test-host.local
+  const std::vector<uint8_t> kHostName = {
+      9, 116, 101, 115, 116, 45, 104, 111, 115, 116,  // test-host
+      5, 108, 111, 99,  97,  108, 0                   // local
+  };
+  // other-host.local
+  const std::vector<uint8_t> kOtherHostName = {
+      10, 111, 116, 104, 101, 114, 45, 104, 111, 115, 116,  // other-host
+      5,  108, 111, 99,  97,  108, 0                        // local
+  };
+
+  void SetUp() override
+  {
+    etcpal_reset_all_fakes();
+    ASSERT_EQ(monitored_scope_module_init(), kEtcPalErrOk);
+    ASSERT_EQ(lwmdns_index_module_init(), kEtcPalErrOk);
+
+    // Service instance names are looked up in the monitors' broker tables.
+    discovered_broker_table_init(&monitor_a_.brokers);
+    discovered_broker_table_init(&monitor_b_.brokers);
+    scope_monitor_insert(&monitor_a_);
+    scope_monitor_insert(&monitor_b_);
+  }
+
+  void TearDown() override
+  {
+    scope_monitor_remove(&monitor_a_);
+    scope_monitor_remove(&monitor_b_);
+    lwmdns_index_module_deinit();
+    monitored_scope_module_deinit();
+  }
+
+  // Add a broker to a monitor's table
+  static void InitBroker(DiscoveredBroker& db, RdmnetScopeMonitorRef& monitor_ref, const char* service_instance_name)
+  {
+    std::memset(&db, 0, sizeof(DiscoveredBroker));
+    db.monitor_ref = &monitor_ref;
+    rdmnet_safe_strncpy(db.service_instance_name, service_instance_name, E133_SERVICE_NAME_STRING_PADDED_LENGTH);
+    discovered_broker_table_insert(&monitor_ref.brokers, &db);
+  }
+
+  // <label>.local
+  static std::vector<uint8_t> HostName(const std::string& label)
+  {
+    std::vector<uint8_t> name = {static_cast<uint8_t>(label.size())};
+    name.insert(name.end(), label.begin(), label.end());
+    name.insert(name.end(), {5, 108, 111, 99, 97, 108, 0});  // local
+    return name;
+  }
+
+  // <label>._rdmnet._tcp.local
+  static std::vector<uint8_t> ServiceName(const std::string& label)
+  {
+    std::vector<uint8_t> name = {static_cast<uint8_t>(label.size())};
+    name.insert(name.end(), label.begin(), label.end());
+    name.insert(name.end(), {
+                                7, 95,  114, 100, 109, 110, 101, 116,  // _rdmnet
+                                4, 95,  116, 99,  112,                 // _tcp
+                                5, 108, 111, 99,  97,  108, 0          // local
+                            });
+    return name;
+  }
+
+  DiscoveredBroker* FindByInstance(const std::string& label, RdmnetScopeMonitorRef* monitor_ref)
+  {
+    auto name = ServiceName(label);
+    return lwmdns_index_find_by_service_instance(name.data(), name.data(), monitor_ref);
+  }
+};
+
+TEST_F(TestLwMdnsIndex, FindsBrokersByServiceInstance)
+{
+  DiscoveredBroker db_a;
+  DiscoveredBroker db_b;
+  InitBroker(db_a, monitor_a_, "Broker A");
+  InitBroker(db_b, monitor_a_, "Broker B");
+
+  EXPECT_EQ(FindByInstance("Broker A", nullptr), &db_a);
+  EXPECT_EQ(FindByInstance("Broker B", nullptr), &db_b);
+  EXPECT_EQ(FindByInstance("Broker C", nullptr), nullptr);
+
+  // Names that aren't RDMnet service instances don't match.
+  const std::vector<uint8_t> http_name = {
+      8, 66,  114, 111, 107, 101, 114, 32, 65,  // Broker A
+      5, 95,  104, 116, 116, 112,               // _http
+      4, 95,  116, 99,  112,                    // _tcp
+      5, 108, 111, 99,  97,  108, 0             // local
+  };
+  EXPECT_EQ(lwmdns_index_find_by_service_instance(http_name.data(), http_name.data(), nullptr), nullptr);
+}
+
+TEST_F(TestLwMdnsIndex, FiltersServiceInstancesByMonitor)
+{
+  DiscoveredBroker db_a;
+  DiscoveredBroker db_b;
+  InitBroker(db_a, monitor_a_, "Broker");
+  InitBroker(db_b, monitor_b_, "Broker");
+
+  EXPECT_EQ(FindByInstance("Broker", &monitor_a_), &db_a);
+  EXPECT_EQ(FindByInstance("Broker", &monitor_b_), &db_b);
+
+  discovered_broker_table_remove(&monitor_b_.brokers, &db_b);
+  EXPECT_EQ(FindByInstance("Broker", &monitor_b_), nullptr);
+  EXPECT_EQ(FindByInstance("Broker", nullptr), &db_a);
+}
+
+TEST_F(TestLwMdnsIndex, ReindexesChangedHostNames)
+{
+  DiscoveredBroker db;
+  InitBroker(db, monitor_a_, "Broker");
+
+  // Brokers aren't found by host name until they have one.
+  lwmdns_index_update_host_name(&db);
+  EXPECT_EQ(lwmdns_index_find_by_host_name(kHostName.data(), kHostName.data()), nullptr);
+
+  std::memcpy(db.platform_data.wire_host_name, kHostName.data(), kHostName.size());
+  lwmdns_index_update_host_name(&db);
+  EXPECT_EQ(lwmdns_index_find_by_host_name(kHostName.data(), kHostName.data()), &db);
+  EXPECT_EQ(lwmdns_index_find_by_host_name(kOtherHostName.data(), kOtherHostName.data()), nullptr);
+
+  std::memcpy(db.platform_data.wire_host_name, kOtherHostName.data(), kOtherHostName.size());
+  lwmdns_index_update_host_name(&db);
+  EXPECT_EQ(lwmdns_index_find_by_host_name(kHostName.data(), kHostName.data()), nullptr);
+  EXPECT_EQ(lwmdns_index_find_by_host_name(kOtherHostName.data(), kOtherHostName.data()), &db);
+
+  lwmdns_index_remove_broker(&db);
+  EXPECT_EQ(lwmdns_index_find_by_host_name(kOtherHostName.data(), kOtherHostName.data()), nullptr);
+}
+
+// Brokers whose host names share a bucket are each found and removed independently.
+TEST_F(TestLwMdnsIndex, HandlesManyBrokers)
+{
+  constexpr size_t              kNumBrokers = LWMDNS_INDEX_NUM_BUCKETS * 3;
+  std::vector<DiscoveredBroker> brokers(kNumBrokers);
+  for (size_t i = 0; i < kNumBrokers; ++i)
+  {
+    InitBroker(brokers[i], monitor_a_, ("Broker " + std::to_string(i)).c_str());
+    auto host_name = HostName("host-" + std::to_string(i));
+    std::memcpy(brokers[i].platform_data.wire_host_name, host_name.data(), host_name.size());
+    lwmdns_index_update_host_name(&brokers[i]);
+  }
+
+  for (size_t i = 0; i < kNumBrokers; i += 2)
+    lwmdns_index_remove_broker(&brokers[i]);
+
+  for (size_t i = 0; i < kNumBrokers; ++i)
+  {
+    DiscoveredBroker* expected = (i % 2 == 0 ? nullptr : &brokers[i]);
+    auto              host_name = HostName("host-" + std::to_string(i));
+    EXPECT_EQ(lwmdns_index_find_by_host_name(host_name.data(), host_name.data()), expected) << "Broker " << i;
+  }
+}
@@ -19,11 +19,15 @@
 
 #include "lwmdns_recv.h"
 
+#include <algorithm>
 #include <cstring>
+#include <string>
 #include "gtest/gtest.h"
 #include "fff.h"
 #include "etcpal_mock/common.h"
 #include "etcpal_mock/socket.h"
+#include "etcpal_mock/timer.h"
+#include "etcpal/pack.h"
 #include "etcpal/cpp/inet.h"
 #include "etcpal/cpp/uuid.h"
 #include "rdm/cpp/uid.h"
@@ -32,7 +36,10 @@
 #include "rdmnet/disc/common.h"
 #include "rdmnet/disc/monitored_scope.h"
 #include "rdmnet/disc/discovered_broker.h"
+#include "rdmnet/disc/registered_broker.h"
+#include "lwmdns_cache.h"
 #include "lwmdns_common.h"
+#include "lwmdns_index.h"
 #include "fake_mcast.h"
 
 RCPolledSocketInfo            recv_socket_info;
@@ -43,6 +50,8 @@ class TestLwMdnsRecv : public testing::Test
 protected:
   RdmnetScopeMonitorRef*      monitor_ref_;
   static std::vector<uint8_t> data_to_recv_;
+  // Datagrams delivered in the same batch, after data_to_recv_.
+  static std::vector<std::vector<uint8_t>> additional_data_to_recv_;
 
   void SetUp() override
   {
@@ -53,17 +62,32 @@ protected:
     recv_socket_info = RCPolledSocketInfo{};
 
     data_to_recv_.clear();
+    additional_data_to_recv_.clear();
     rc_add_polled_socket_fake.custom_fake = [](etcpal_socket_t, etcpal_poll_events_t events,
                                                RCPolledSocketInfo* socket_info) {
       EXPECT_TRUE(events & ETCPAL_POLL_IN);
       recv_socket_info = *socket_info;
       return kEtcPalErrOk;
     };
-    etcpal_recvfrom_fake.custom_fake = [](etcpal_socket_t, void* buffer, size_t length, int, EtcPalSockAddr* address) {
-      EXPECT_LE(data_to_recv_.size(), length);
-      std::memcpy(buffer, data_to_recv_.data(), data_to_recv_.size());
-      *address = recvfrom_addr.get();
-      return static_cast<int>(data_to_recv_.size());
+    rc_mcast_recv_batch_fake.custom_fake = [](etcpal_socket_t, uint8_t* storage, size_t msg_buf_size,
+                                              RCMcastRecvMsg* msgs, size_t max_msgs) {
+      EXPECT_GT(max_msgs, additional_data_to_recv_.size());
+
+      std::vector<const std::vector<uint8_t>*> datagrams = {&data_to_recv_};
+      for (const auto& datagram : additional_data_to_recv_)
+        datagrams.push_back(&datagram);
+
+      for (size_t i = 0; i < datagrams.size(); ++i)
+      {
+        EXPECT_LE(datagrams[i]->size(), msg_buf_size);
+        uint8_t* msg_buf = &storage[i * msg_buf_size];
+        std::memcpy(msg_buf, datagrams[i]->data(), datagrams[i]->size());
+        msgs[i] = RCMcastRecvMsg{};
+        msgs[i].data = msg_buf;
+        msgs[i].data_len = datagrams[i]->size();
+        msgs[i].from = recvfrom_addr.get();
+      }
+      return static_cast<int>(datagrams.size());
     };
 
     ASSERT_EQ(rdmnet_disc_module_init(nullptr), kEtcPalErrOk);
@@ -84,11 +108,12 @@ protected:
   }
 };
 
-std::vector<uint8_t> TestLwMdnsRecv::data_to_recv_;
+std::vector<uint8_t>              TestLwMdnsRecv::data_to_recv_;
+std::vector<std::vector<uint8_t>> TestLwMdnsRecv::additional_data_to_recv_;
 
 TEST_F(TestLwMdnsRecv, HandlesPtrRecordProperly)
 {
-  EXPECT_EQ(monitor_ref_->broker_list, nullptr);
+  EXPECT_EQ(monitor_ref_->brokers.head, nullptr);
 
   data_to_recv_ = {
       0, 0,        // Transaction ID
@@ -120,8 +145,8 @@ TEST_F(TestLwMdnsRecv, HandlesPtrRecordProperly)
   recv_socket_info.callback(&event, recv_socket_info.data);
 
   // We should add a discovered broker to the list
-  ASSERT_NE(monitor_ref_->broker_list, nullptr);
-  DiscoveredBroker* db = monitor_ref_->broker_list;
+  ASSERT_NE(monitor_ref_->brokers.head, nullptr);
+  DiscoveredBroker* db = monitor_ref_->brokers.head;
   EXPECT_STREQ(db->service_instance_name, "Test Service Instance");
   EXPECT_EQ(db->platform_data.ttl_timer.interval, 120u * 1000u);
 }
@@ -159,11 +184,11 @@ TEST_F(TestLwMdnsRecv, HandlesPtrRecordZeroTTL)
   recv_socket_info.callback(&event, recv_socket_info.data);
 
   // Receiving a message with zero TTL, when there are no brokers, should not add one.
-  ASSERT_EQ(monitor_ref_->broker_list, nullptr);
+  ASSERT_EQ(monitor_ref_->brokers.head, nullptr);
 
   DiscoveredBroker* db = discovered_broker_new(monitor_ref_, "Test Service Instance", "");
   ASSERT_NE(db, nullptr);
-  discovered_broker_insert(&monitor_ref_->broker_list, db);
+  discovered_broker_table_insert(&monitor_ref_->brokers, db);
   EXPECT_EQ(db->platform_data.destruction_pending, false);
 
   recv_socket_info.callback(&event, recv_socket_info.data);
@@ -172,11 +197,64 @@ TEST_F(TestLwMdnsRecv, HandlesPtrRecordZeroTTL)
   EXPECT_EQ(db->platform_data.destruction_pending, true);
 }
 
+// Brokers in the cache are found by scope monitors started after they were received, and removed
+// when their PTR records expire.
+TEST_F(TestLwMdnsRecv, HandlesCachedPtrRecord)
+{
+  data_to_recv_ = {
+      0, 0,        // Transaction ID
+      0x84, 0x00,  // Flags: Standard query response, no error
+      0, 0,        // Question count: 0
+      0, 1,        // Answer count: 1
+      0, 0,        // Authority count: 0
+      0, 0,        // Additional count: 0
+
+      // Start PTR record
+      // Name
+      8, 95, 100, 101, 102, 97, 117, 108, 116,  // _default
+      4, 95, 115, 117, 98,                      // _sub
+      7, 95, 114, 100, 109, 110, 101, 116,      // _rdmnet
+      4, 95, 116, 99, 112,                      // _tcp
+      5, 108, 111, 99, 97, 108, 0,              // local
+
+      0, 12,                                              // Type: PTR
+      0, 1,                                               // class IN, cache flush false
+      0, 0, 0, 120,                                       // TTL 120 seconds
+      0, 24,                                              // Data length
+      21, 84, 101, 115, 116, 32, 83, 101, 114, 118, 105,  //
+      99, 101, 32, 73, 110, 115, 116, 97, 110, 99, 101,   // Test Service Instance
+      0xc0, 0x1a                                          // Pointer to _rdmnet._tcp.local
+  };
+
+  // Receive the record while the scope isn't being monitored.
+  scope_monitor_remove(monitor_ref_);
+  EtcPalPollEvent event{};
+  event.events = ETCPAL_POLL_IN;
+  recv_socket_info.callback(&event, recv_socket_info.data);
+  EXPECT_EQ(monitor_ref_->brokers.head, nullptr);
+  ASSERT_EQ(lwmdns_cache_size(), 1u);
+
+  scope_monitor_insert(monitor_ref_);
+  etcpal_getms_fake.return_val = 20000;
+  lwmdns_recv_handle_cached_record(lwmdns_cache_next(nullptr));
+
+  ASSERT_NE(monitor_ref_->brokers.head, nullptr);
+  DiscoveredBroker* db = monitor_ref_->brokers.head;
+  EXPECT_STREQ(db->service_instance_name, "Test Service Instance");
+  EXPECT_EQ(db->platform_data.ttl_timer.interval, 100u * 1000u);
+  EXPECT_FALSE(db->platform_data.destruction_pending);
+
+  etcpal_getms_fake.return_val = 120001;
+  lwmdns_cache_process(nullptr, lwmdns_recv_handle_cached_record);
+  EXPECT_TRUE(db->platform_data.destruction_pending);
+  EXPECT_EQ(lwmdns_cache_size(), 0u);
+}
+
 TEST_F(TestLwMdnsRecv, HandlesMultipleServiceRecordsProperly)
 {
   DiscoveredBroker* db = discovered_broker_new(monitor_ref_, "Test Service Instance", "");
   ASSERT_NE(db, nullptr);
-  discovered_broker_insert(&monitor_ref_->broker_list, db);
+  discovered_broker_table_insert(&monitor_ref_->brokers, db);
 
   // A response with a SRV and TXT record in it.
   data_to_recv_ = {
@@ -238,9 +316,93 @@ TEST_F(TestLwMdnsRecv, HandlesMultipleServiceRecordsProperly)
                                         data_to_recv_.data(), &data_to_recv_.data()[70]));
 }
 
+// Address records are matched to brokers by the host name from their SRV records.
+TEST_F(TestLwMdnsRecv, HandlesAddressRecordForKnownHost)
+{
+  DiscoveredBroker* db = discovered_broker_new(monitor_ref_, "Test Service Instance", "");
+  ASSERT_NE(db, nullptr);
+  discovered_broker_table_insert(&monitor_ref_->brokers, db);
+
+  // test-hostname.local
+  const uint8_t host_name[] = {
+      13, 116, 101, 115, 116, 45, 104, 111, 115, 116, 110, 97, 109, 101,  // test-hostname
+      5,  108, 111, 99,  97,  108, 0                                      // local
+  };
+  std::memcpy(db->platform_data.wire_host_name, host_name, sizeof(host_name));
+  db->platform_data.srv_record_received = true;
+  lwmdns_index_update_host_name(db);
+
+  data_to_recv_ = {
+      0, 0,        // Transaction ID
+      0x84, 0x00,  // Flags: Standard query response, no error
+      0, 0,        // Question count: 0
+      0, 2,        // Answer count: 2
+      0, 0,        // Authority count: 0
+      0, 0,        // Additional count: 0
+
+      // Start A record
+      13, 116, 101, 115, 116, 45, 104, 111, 115, 116, 110, 97, 109, 101,  // test-hostname
+      5, 108, 111, 99, 97, 108, 0,                                        // local
+      0, 1,                                                               // Type: A
+      0x80, 0x01,                                                         // class IN, cache flush true
+      0, 0, 0, 120,                                                       // TTL 120 seconds
+      0, 4,                                                               // Data length
+      192, 168, 1, 1,                                                     // 192.168.1.1
+
+      // Start A record for a different host
+      10, 111, 116, 104, 101, 114, 45, 104, 111, 115, 116,  // other-host
+      0xc0, 0x1a,                                           // Pointer to local
+      0, 1,                                                 // Type: A
+      0x80, 0x01,                                           // class IN, cache flush true
+      0, 0, 0, 120,                                         // TTL 120 seconds
+      0, 4,                                                 // Data length
+      192, 168, 1, 2,                                       // 192.168.1.2
+  };
+
+  EtcPalPollEvent event{};
+  event.events = ETCPAL_POLL_IN;
+  recv_socket_info.callback(&event, recv_socket_info.data);
+
+  ASSERT_EQ(db->num_listen_addrs, 1u);
+  EXPECT_EQ(etcpal::IpAddr(db->listen_addr_array[0]), etcpal::IpAddr::FromString("192.168.1.1"));
+}
+
+// Messages with no RDMnet names and no address records are dropped before they are handled.
+TEST_F(TestLwMdnsRecv, IgnoresUnrelatedMessages)
+{
+  data_to_recv_ = {
+      0, 0,        // Transaction ID
+      0x84, 0x00,  // Flags: Standard query response, no error
+      0, 0,        // Question count: 0
+      0, 1,        // Answer count: 1
+      0, 0,        // Authority count: 0
+      0, 0,        // Additional count: 0
+
+      // Start PTR record
+      5, 95, 104, 116, 116, 112,    // _http
+      4, 95, 116, 99, 112,          // _tcp
+      5, 108, 111, 99, 97, 108, 0,  // local
+
+      0, 12,                                              // Type: PTR
+      0, 1,                                               // class IN, cache flush false
+      0, 0, 0, 120,                                       // TTL 120 seconds
+      0, 24,                                              // Data length
+      21, 84, 101, 115, 116, 32, 83, 101, 114, 118, 105,  //
+      99, 101, 32, 73, 110, 115, 116, 97, 110, 99, 101,   // Test Service Instance
+      0xc0, 0x0c                                          // Pointer to _http._tcp.local
+  };
+
+  EtcPalPollEvent event{};
+  event.events = ETCPAL_POLL_IN;
+  recv_socket_info.callback(&event, recv_socket_info.data);
+
+  EXPECT_EQ(monitor_ref_->brokers.head, nullptr);
+  EXPECT_EQ(lwmdns_cache_size(), 0u);
+}
+
 TEST_F(TestLwMdnsRecv, HandlesPtrQueryWithAnswer)
 {
-  EXPECT_EQ(monitor_ref_->broker_list, nullptr);
+  EXPECT_EQ(monitor_ref_->brokers.head, nullptr);
 
   data_to_recv_ = {
       0, 0,        // Transaction ID
@@ -276,8 +438,224 @@ TEST_F(TestLwMdnsRecv, HandlesPtrQueryWithAnswer)
   recv_socket_info.callback(&event, recv_socket_info.data);
 
   // We should add a discovered broker to the list
-  ASSERT_NE(monitor_ref_->broker_list, nullptr);
-  DiscoveredBroker* db = monitor_ref_->broker_list;
+  ASSERT_NE(monitor_ref_->brokers.head, nullptr);
+  DiscoveredBroker* db = monitor_ref_->brokers.head;
   EXPECT_STREQ(db->service_instance_name, "Test Service Instance");
   EXPECT_EQ(db->platform_data.ttl_timer.interval, 120u * 1000u);
 }
+
+// Several datagrams read on the same wakeup should all be handled.
+TEST_F(TestLwMdnsRecv, HandlesBatchOfMessages)
+{
+  EXPECT_EQ(monitor_ref_->brokers.head, nullptr);
+
+  const std::vector<uint8_t> ptr_record_header = {
+      0, 0,        // Transaction ID
+      0x84, 0x00,  // Flags: Standard query response, no error
+      0, 0,        // Question count: 0
+      0, 1,        // Answer count: 1
+      0, 0,        // Authority count: 0
+      0, 0,        // Additional count: 0
+
+      // Start PTR record
+      // Name
+      8, 95, 100, 101, 102, 97, 117, 108, 116,  // _default
+      4, 95, 115, 117, 98,                      // _sub
+      7, 95, 114, 100, 109, 110, 101, 116,      // _rdmnet
+      4, 95, 116, 99, 112,                      // _tcp
+      5, 108, 111, 99, 97, 108, 0,              // local
+
+      0, 12,         // Type: PTR
+      0, 1,          // class IN, cache flush false
+      0, 0, 0, 120,  // TTL 120 seconds
+      0, 13,         // Data length
+  };
+
+  data_to_recv_ = ptr_record_header;
+  data_to_recv_.insert(data_to_recv_.end(), {
+                                                10, 66, 114, 111, 107, 101, 114, 32, 79, 110, 101,  // Broker One
+                                                0xc0, 0x1a  // Pointer to _rdmnet._tcp.local
+                                            });
+  additional_data_to_recv_.push_back(ptr_record_header);
+  additional_data_to_recv_[0].insert(additional_data_to_recv_[0].end(),
+                                     {
+                                         10, 66, 114, 111, 107, 101, 114, 32, 84, 119, 111,  // Broker Two
+                                         0xc0, 0x1a  // Pointer to _rdmnet._tcp.local
+                                     });
+
+  EtcPalPollEvent event{};
+  event.events = ETCPAL_POLL_IN;
+  recv_socket_info.callback(&event, recv_socket_info.data);
+
+  EXPECT_EQ(rc_mcast_recv_batch_fake.call_count, 1u);
+
+  // Both brokers should have been added from the single socket wakeup.
+  std::vector<std::string> names;
+  for (DiscoveredBroker* db = monitor_ref_->brokers.head; db; db = db->next)
+    names.push_back(db->service_instance_name);
+  ASSERT_EQ(names.size(), 2u);
+  EXPECT_NE(std::find(names.begin(), names.end(), "Broker One"), names.end());
+  EXPECT_NE(std::find(names.begin(), names.end(), "Broker Two"), names.end());
+}
+
+class TestLwMdnsRecvResponder : public TestLwMdnsRecv
+{
+protected:
+  RdmnetBrokerRegisterRef* broker_ref_{nullptr};
+
+  // Test._rdmnet._tcp.local
+  const std::vector<uint8_t> kInstanceName = {
+      4, 84,  101, 115, 116,                 // Test
+      7, 95,  114, 100, 109, 110, 101, 116,  // _rdmnet
+      4, 95,  116, 99,  112,                 // _tcp
+      5, 108, 111, 99,  97,  108, 0          // local
+  };
+
+  void SetUp() override
+  {
+    TestLwMdnsRecv::SetUp();
+
+    RdmnetBrokerRegisterConfig config{};
+    config.cid = etcpal::Uuid::FromString("50b14416-8bc9-4e86-a65f-094934b8fd1b").get();
+    config.uid = rdm::Uid::FromString("6574:12345678").get();
+    config.service_instance_name = "Test";
+    config.port = 8888;
+    config.scope = "default";
+    config.model = "Test Model";
+    config.manufacturer = "Test Manufacturer";
+    broker_ref_ = registered_broker_new(&config);
+    ASSERT_NE(broker_ref_, nullptr);
+    registered_broker_insert(broker_ref_);
+    lwmdns_broker_host_name(&broker_ref_->cid, broker_ref_->platform_data.wire_host_name);
+
+    etcpal_getms_fake.return_val = 10000;
+  }
+
+  void TearDown() override
+  {
+    registered_broker_remove(broker_ref_);
+    registered_broker_delete(broker_ref_);
+    TestLwMdnsRecv::TearDown();
+  }
+
+  void ReceiveData(const std::vector<uint8_t>& data)
+  {
+    data_to_recv_ = data;
+    EtcPalPollEvent event{};
+    event.events = ETCPAL_POLL_IN;
+    recv_socket_info.callback(&event, recv_socket_info.data);
+  }
+
+  std::vector<uint8_t> SubtypePtrQuery() const
+  {
+    return {
+        0, 0,  // Transaction ID
+        0, 0,  // Flags: Standard query
+        0, 1,  // Question count: 1
+        0, 0,  // Answer count: 0
+        0, 0,  // Authority count: 0
+        0, 0,  // Additional count: 0
+
+        8, 95, 100, 101, 102, 97, 117, 108, 116,  // _default
+        4, 95, 115, 117, 98,                      // _sub
+        7, 95, 114, 100, 109, 110, 101, 116,      // _rdmnet
+        4, 95, 116, 99, 112,                      // _tcp
+        5, 108, 111, 99, 97, 108, 0,              // local
+        0, 12,                                    // Type: PTR
+        0, 1,                                     // class IN, QM question
+    };
+  }
+
+  // A message containing an SRV record for Test._rdmnet._tcp.local pointing to port on other.local.
+  // As a query, it is a probe with the record in the authority section; otherwise it is a response.
+  std::vector<uint8_t> SrvMessage(bool probe, uint16_t port) const
+  {
+    const uint8_t kSectionCount = 1;
+    std::vector<uint8_t> msg(12, 0);
+    if (probe)
+    {
+      msg[5] = kSectionCount;  // Question count
+      msg[9] = kSectionCount;  // Authority count
+    }
+    else
+    {
+      msg[2] = 0x84;           // Flags: Standard query response
+      msg[7] = kSectionCount;  // Answer count
+    }
+
+    msg.insert(msg.end(), kInstanceName.begin(), kInstanceName.end());
+    if (probe)
+    {
+      msg.insert(msg.end(), {
+                                0, 255,     // Type: ANY
+                                0x80, 1,    // class IN, QU question
+                                0xc0, 0x0c  // Pointer to Test._rdmnet._tcp.local
+                            });
+    }
+    msg.insert(msg.end(), {
+                              0, 33,         // Type: SRV
+                              0x80, 1,       // class IN, cache flush true
+                              0, 0, 0, 120,  // TTL 120 seconds
+                              0, 19,         // Data length
+                              0, 0, 0, 0,    // Priority, weight
+                          });
+    msg.push_back(static_cast<uint8_t>(port >> 8));
+    msg.push_back(static_cast<uint8_t>(port & 0xff));
+    msg.insert(msg.end(), {5, 111, 116, 104, 101, 114, 5, 108, 111, 99, 97, 108, 0});  // other.local
+    return msg;
+  }
+};
+
+TEST_F(TestLwMdnsRecvResponder, AnswersQueriesWhenRegistered)
+{
+  broker_ref_->platform_data.responder_state = kMdnsResponderRegistered;
+  ReceiveData(SubtypePtrQuery());
+
+  ASSERT_EQ(etcpal_sendto_fake.call_count, kFakeNetints.size());
+  const uint8_t* sent_data = static_cast<const uint8_t*>(etcpal_sendto_fake.arg1_val);
+  EXPECT_EQ(etcpal_unpack_u16b(&sent_data[2]), 0x8400u);  // Flags: Authoritative response
+  EXPECT_EQ(etcpal_unpack_u16b(&sent_data[6]), 4u);       // Answer count: 4
+}
+
+TEST_F(TestLwMdnsRecvResponder, DoesNotAnswerQueriesWhileProbing)
+{
+  broker_ref_->platform_data.responder_state = kMdnsResponderProbing;
+  ReceiveData(SubtypePtrQuery());
+  EXPECT_EQ(etcpal_sendto_fake.call_count, 0u);
+}
+
+TEST_F(TestLwMdnsRecvResponder, RateLimitsAnswers)
+{
+  broker_ref_->platform_data.responder_state = kMdnsResponderRegistered;
+  ReceiveData(SubtypePtrQuery());
+  ASSERT_EQ(etcpal_sendto_fake.call_count, kFakeNetints.size());
+
+  // A second query within a second shouldn't be answered again
+  etcpal_getms_fake.return_val += 500;
+  ReceiveData(SubtypePtrQuery());
+  EXPECT_EQ(etcpal_sendto_fake.call_count, kFakeNetints.size());
+
+  etcpal_getms_fake.return_val += 600;
+  ReceiveData(SubtypePtrQuery());
+  EXPECT_EQ(etcpal_sendto_fake.call_count, kFakeNetints.size() * 2);
+}
+
+TEST_F(TestLwMdnsRecvResponder, DetectsNameConflict)
+{
+  broker_ref_->platform_data.responder_state = kMdnsResponderRegistered;
+  ReceiveData(SrvMessage(false, 9999));
+  EXPECT_TRUE(broker_ref_->platform_data.name_conflict);
+}
+
+TEST_F(TestLwMdnsRecvResponder, DefersProbeWhenTieBreakIsLost)
+{
+  broker_ref_->platform_data.responder_state = kMdnsResponderProbing;
+
+  // Port 1 sorts before our port 8888, so we win.
+  ReceiveData(SrvMessage(true, 1));
+  EXPECT_FALSE(broker_ref_->platform_data.probe_deferred);
+
+  ReceiveData(SrvMessage(true, 9999));
+  EXPECT_TRUE(broker_ref_->platform_data.probe_deferred);
+  EXPECT_FALSE(broker_ref_->platform_data.name_conflict);
+}
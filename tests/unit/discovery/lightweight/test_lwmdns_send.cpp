@@ -23,12 +23,16 @@
 #include "fff.h"
 #include "etcpal/inet.h"
 #include "etcpal/pack.h"
+#include "etcpal/cpp/uuid.h"
 #include "etcpal_mock/timer.h"
 #include "etcpal_mock/common.h"
 #include "etcpal_mock/socket.h"
 #include "rdmnet_mock/core/mcast.h"
+#include "rdmnet/core/util.h"
 #include "rdmnet/disc/discovered_broker.h"
 #include "rdmnet/disc/monitored_scope.h"
+#include "rdmnet/disc/registered_broker.h"
+#include "lwmdns_cache.h"
 #include "lwmdns_common.h"
 #include "fake_mcast.h"
 
@@ -90,6 +94,7 @@ protected:
     ASSERT_EQ(discovered_broker_module_init(), kEtcPalErrOk);
     ASSERT_EQ(monitored_scope_module_init(), kEtcPalErrOk);
     ASSERT_EQ(lwmdns_common_module_init(), kEtcPalErrOk);
+    ASSERT_EQ(lwmdns_cache_module_init(), kEtcPalErrOk);
     ASSERT_EQ(lwmdns_send_module_init(nullptr), kEtcPalErrOk);
 
     RdmnetScopeMonitorConfig config = RDMNET_SCOPE_MONITOR_CONFIG_DEFAULT_INIT;
@@ -109,13 +114,56 @@ protected:
     scope_monitor_remove(monitor_ref_);
     scope_monitor_delete(monitor_ref_);
     lwmdns_send_module_deinit();
+    lwmdns_cache_module_deinit();
     lwmdns_common_module_deinit();
     monitored_scope_module_deinit();
   }
+
+  // Cache a record as if it had been received in a response. Names must be uncompressed.
+  static void CacheRecord(const std::vector<uint8_t>& name,
+                          dns_record_type_t           type,
+                          const std::vector<uint8_t>& data,
+                          uint32_t                    ttl)
+  {
+    DnsResourceRecord rr{};
+    rr.name = name.data();
+    rr.record_type = type;
+    rr.ttl = ttl;
+    rr.data_len = static_cast<uint16_t>(data.size());
+    rr.data_ptr = data.data();
+    lwmdns_cache_add(name.data(), &rr);
+  }
+
+  // <label>._rdmnet._tcp.local
+  static std::vector<uint8_t> ServiceName(const std::string& label)
+  {
+    std::vector<uint8_t> name;
+    name.push_back(static_cast<uint8_t>(label.size()));
+    name.insert(name.end(), label.begin(), label.end());
+    name.insert(name.end(), kServiceSuffix.begin(), kServiceSuffix.end());
+    return name;
+  }
+
+  static const std::vector<uint8_t> kServiceSuffix;
+  static const std::vector<uint8_t> kDefaultSubtype;
 };
 
 std::vector<uint8_t> TestLwMdnsSend::sent_data_;
 
+const std::vector<uint8_t> TestLwMdnsSend::kServiceSuffix = {
+    7, 95,  114, 100, 109, 110, 101, 116,  // _rdmnet
+    4, 95,  116, 99,  112,                 // _tcp
+    5, 108, 111, 99,  97,  108, 0          // local
+};
+
+const std::vector<uint8_t> TestLwMdnsSend::kDefaultSubtype = {
+    8, 95,  100, 101, 102, 97,  117, 108, 116,  // _default
+    4, 95,  115, 117, 98,                       // _sub
+    7, 95,  114, 100, 109, 110, 101, 116,       // _rdmnet
+    4, 95,  116, 99,  112,                      // _tcp
+    5, 108, 111, 99,  97,  108, 0               // local
+};
+
 TEST_F(TestLwMdnsSend, SendPtrQueryWorks)
 {
   lwmdns_send_ptr_query(monitor_ref_);
@@ -142,6 +190,33 @@ TEST_F(TestLwMdnsSend, SendPtrQueryWorks)
   EXPECT_EQ(etcpal_unpack_u16b(&sent_data_[48]), 0x8001u);  // QU question (first query), class IN
 }
 
+TEST_F(TestLwMdnsSend, QueryIsPackedOnceForAllInterfaces)
+{
+  // The destinations only live for the duration of the call.
+  static EtcPalSockAddr v4_dest;
+  static EtcPalSockAddr v6_dest;
+  rc_mcast_send_to_netints_fake.custom_fake = [](const RCMcastSendNetint*, size_t, const uint8_t*, size_t,
+                                                 const EtcPalSockAddr* v4, const EtcPalSockAddr* v6) {
+    EXPECT_NE(v4, nullptr);
+    EXPECT_NE(v6, nullptr);
+    if (v4)
+      v4_dest = *v4;
+    if (v6)
+      v6_dest = *v6;
+    return kEtcPalErrOk;
+  };
+
+  lwmdns_send_ptr_query(monitor_ref_);
+
+  ASSERT_EQ(rc_mcast_send_to_netints_fake.call_count, 1u);
+  EXPECT_EQ(rc_mcast_send_to_netints_fake.arg1_val, kFakeNetints.size());
+  EXPECT_EQ(rc_mcast_send_to_netints_fake.arg3_val, 50u);
+  EXPECT_EQ(etcpal_ip_cmp(&v4_dest.ip, kMdnsIpv4Address), 0);
+  EXPECT_EQ(v4_dest.port, E133_MDNS_PORT);
+  EXPECT_EQ(etcpal_ip_cmp(&v6_dest.ip, kMdnsIpv6Address), 0);
+  EXPECT_EQ(v6_dest.port, E133_MDNS_PORT);
+}
+
 TEST_F(TestLwMdnsSend, SendsQMQuestionOnRetransmission)
 {
   monitor_ref_->platform_data.sent_first_query = true;
@@ -153,18 +228,11 @@ TEST_F(TestLwMdnsSend, SendsQMQuestionOnRetransmission)
 
 TEST_F(TestLwMdnsSend, SendPtrQueryWorksWithKnownAnswers)
 {
+  // The cache is most-recent first
+  CacheRecord(kDefaultSubtype, kDnsRecordTypePTR, ServiceName("Test Service Instance 2"), 1000);
+  CacheRecord(kDefaultSubtype, kDnsRecordTypePTR, ServiceName("Test Service Instance"), 120);
   etcpal_getms_fake.return_val = 20000;
 
-  auto db = discovered_broker_new(monitor_ref_, "Test Service Instance", "");
-  db->platform_data.ttl_timer.interval = 120 * 1000;
-  db->platform_data.ttl_timer.reset_time = 0;
-  discovered_broker_insert(&monitor_ref_->broker_list, db);
-
-  auto db2 = discovered_broker_new(monitor_ref_, "Test Service Instance 2", "");
-  db2->platform_data.ttl_timer.interval = 1000 * 1000;
-  db2->platform_data.ttl_timer.reset_time = 0;
-  discovered_broker_insert(&monitor_ref_->broker_list, db2);
-
   lwmdns_send_ptr_query(monitor_ref_);
   EXPECT_EQ(etcpal_sendto_fake.call_count, kFakeNetints.size());
 
@@ -202,6 +270,67 @@ TEST_F(TestLwMdnsSend, SendPtrQueryWorksWithKnownAnswers)
   EXPECT_EQ(std::memcmp(&sent_data_[86], kKnownAnswer2, sizeof kKnownAnswer2), 0);
 }
 
+TEST_F(TestLwMdnsSend, SendPtrQueryOmitsKnownAnswersPastHalfTtl)
+{
+  CacheRecord(kDefaultSubtype, kDnsRecordTypePTR, ServiceName("Test Service Instance"), 120);
+  etcpal_getms_fake.return_val = 60000;
+
+  lwmdns_send_ptr_query(monitor_ref_);
+  ASSERT_EQ(sent_data_.size(), 50u);
+  EXPECT_EQ(etcpal_unpack_u16b(&sent_data_[6]), 0u);  // Answer count: 0
+}
+
+TEST_F(TestLwMdnsSend, SendAnyQueryOnServiceIncludesKnownAnswers)
+{
+  // A TXT record with a single item "a=b"
+  const std::vector<uint8_t> kTxtData = {3, 97, 61, 98};
+  CacheRecord(ServiceName("Test Service Instance"), kDnsRecordTypeTXT, kTxtData, 4500);
+  // A record for another service instance, which shouldn't be included
+  CacheRecord(ServiceName("Other Instance"), kDnsRecordTypeTXT, kTxtData, 4500);
+
+  auto db = discovered_broker_new(monitor_ref_, "Test Service Instance", "");
+  lwmdns_send_any_query_on_service(db);
+
+  // Base size 58, plus the known answer 16
+  ASSERT_EQ(sent_data_.size(), 74u);
+  EXPECT_EQ(etcpal_unpack_u16b(&sent_data_[6]), 1u);  // Answer count: 1
+
+  const uint8_t kKnownAnswer[] = {
+      0xc0, 0x0c,              // Pointer to Test Service Instance._rdmnet._tcp.local
+      0,    16,                // Type TXT
+      0,    1,                 // Type IN, cache flush false
+      0,    0,    0x11, 0x94,  // TTL 4500 seconds
+      0,    4,                 // Data length
+      3,    97,   61,   98,    // a=b
+  };
+  EXPECT_EQ(std::memcmp(&sent_data_[58], kKnownAnswer, sizeof kKnownAnswer), 0);
+
+  discovered_broker_delete(db);
+}
+
+TEST_F(TestLwMdnsSend, SendRequeryWorks)
+{
+  CacheRecord(kDefaultSubtype, kDnsRecordTypePTR, ServiceName("Test Service Instance"), 120);
+  lwmdns_send_requery(lwmdns_cache_next(nullptr));
+
+  EXPECT_EQ(etcpal_sendto_fake.call_count, kFakeNetints.size());
+
+  // The record being requeried is fresh, so it is its own known answer here.
+  ASSERT_EQ(sent_data_.size(), 86u);
+  EXPECT_EQ(etcpal_unpack_u16b(&sent_data_[4]), 1u);  // Question count: 1
+  EXPECT_EQ(etcpal_unpack_u16b(&sent_data_[6]), 1u);  // Answer count: 1
+  EXPECT_EQ(std::memcmp(&sent_data_[12], kDefaultSubtype.data(), kDefaultSubtype.size()), 0);
+  EXPECT_EQ(etcpal_unpack_u16b(&sent_data_[46]), 12u);      // Query Type PTR
+  EXPECT_EQ(etcpal_unpack_u16b(&sent_data_[48]), 0x0001u);  // QM question, class IN
+
+  // Once the record is past its first requery point, it is no longer offered as a known answer.
+  sent_data_.clear();
+  etcpal_getms_fake.return_val = 96000;
+  lwmdns_send_requery(lwmdns_cache_next(nullptr));
+  ASSERT_EQ(sent_data_.size(), 50u);
+  EXPECT_EQ(etcpal_unpack_u16b(&sent_data_[6]), 0u);  // Answer count: 0
+}
+
 TEST_F(TestLwMdnsSend, SendAnyQueryOnServiceWorks)
 {
   auto db = discovered_broker_new(monitor_ref_, "Test Service Instance", "");
@@ -261,3 +390,140 @@ TEST_F(TestLwMdnsSend, SendAnyQueryOnHostnameWorks)
 
   discovered_broker_delete(db);
 }
+
+class TestLwMdnsSendBrokerRecords : public TestLwMdnsSend
+{
+protected:
+  RdmnetBrokerRegisterRef broker_ref_{};
+
+  // rdmnet-<CID>.local
+  const std::string kHostLabel = "rdmnet-50b144168bc94e86a65f094934b8fd1b";
+
+  void SetUp() override
+  {
+    TestLwMdnsSend::SetUp();
+
+    broker_ref_.cid = etcpal::Uuid::FromString("50b14416-8bc9-4e86-a65f-094934b8fd1b").get();
+    rdmnet_safe_strncpy(broker_ref_.service_instance_name, "Test", E133_SERVICE_NAME_STRING_PADDED_LENGTH);
+    rdmnet_safe_strncpy(broker_ref_.scope, "default", E133_SCOPE_STRING_PADDED_LENGTH);
+    broker_ref_.port = 8888;
+    lwmdns_broker_host_name(&broker_ref_.cid, broker_ref_.platform_data.wire_host_name);
+
+    rc_mcast_get_netint_addr_fake.custom_fake = [](const EtcPalMcastNetintId* id, EtcPalIpAddr* addr) {
+      if (id->ip_type != kEtcPalIpTypeV4)
+        return false;
+      ETCPAL_IP_SET_V4_ADDRESS(addr, 0x0a65141e);  // 10.101.20.30
+      return true;
+    };
+  }
+
+  void ExpectHostNameAt(size_t offset)
+  {
+    ASSERT_GE(sent_data_.size(), offset + kHostLabel.size() + 8);
+    EXPECT_EQ(sent_data_[offset], kHostLabel.size());
+    EXPECT_EQ(std::memcmp(&sent_data_[offset + 1], kHostLabel.data(), kHostLabel.size()), 0);
+    const uint8_t kLocal[] = {5, 108, 111, 99, 97, 108, 0};  // local
+    EXPECT_EQ(std::memcmp(&sent_data_[offset + 1 + kHostLabel.size()], kLocal, sizeof kLocal), 0);
+  }
+};
+
+TEST_F(TestLwMdnsSendBrokerRecords, SendProbeWorks)
+{
+  lwmdns_send_probe(&broker_ref_);
+  EXPECT_EQ(etcpal_sendto_fake.call_count, kFakeNetints.size());
+
+  ASSERT_GT(sent_data_.size(), 106u);
+  EXPECT_EQ(etcpal_unpack_u16b(&sent_data_[2]), 0u);   // DNS header flags should be all 0
+  EXPECT_EQ(etcpal_unpack_u16b(&sent_data_[4]), 1u);   // Question count: 1
+  EXPECT_EQ(etcpal_unpack_u16b(&sent_data_[6]), 0u);   // Answer count: 0
+  EXPECT_EQ(etcpal_unpack_u16b(&sent_data_[8]), 2u);   // Authority count: 2
+  EXPECT_EQ(etcpal_unpack_u16b(&sent_data_[10]), 0u);  // Additional count: 0
+
+  const uint8_t kQueryName[] = {
+      4, 84,  101, 115, 116,                 // Test
+      7, 95,  114, 100, 109, 110, 101, 116,  // _rdmnet
+      4, 95,  116, 99,  112,                 // _tcp
+      5, 108, 111, 99,  97,  108, 0          // local
+  };
+  EXPECT_EQ(std::memcmp(&sent_data_[12], kQueryName, sizeof kQueryName), 0);
+  EXPECT_EQ(etcpal_unpack_u16b(&sent_data_[37]), 255u);     // Query Type ANY
+  EXPECT_EQ(etcpal_unpack_u16b(&sent_data_[39]), 0x8001u);  // QU question, class IN
+
+  // Proposed SRV record
+  EXPECT_EQ(etcpal_unpack_u16b(&sent_data_[41]), 0xc00cu);  // Pointer to Test._rdmnet._tcp.local
+  EXPECT_EQ(etcpal_unpack_u16b(&sent_data_[43]), 33u);      // Type SRV
+  EXPECT_EQ(etcpal_unpack_u16b(&sent_data_[45]), 1u);       // Class IN
+  EXPECT_EQ(etcpal_unpack_u32b(&sent_data_[47]), 120u);     // TTL 120 seconds
+  EXPECT_EQ(etcpal_unpack_u16b(&sent_data_[51]), 53u);      // Data length
+  EXPECT_EQ(etcpal_unpack_u16b(&sent_data_[57]), 8888u);    // Port
+  ExpectHostNameAt(59);
+
+  // Proposed TXT record
+  EXPECT_EQ(etcpal_unpack_u16b(&sent_data_[106]), 0xc00cu);  // Pointer to Test._rdmnet._tcp.local
+  EXPECT_EQ(etcpal_unpack_u16b(&sent_data_[108]), 16u);      // Type TXT
+}
+
+TEST_F(TestLwMdnsSendBrokerRecords, SendBrokerRecordsWorks)
+{
+  lwmdns_send_broker_records(&broker_ref_, false);
+  EXPECT_EQ(etcpal_sendto_fake.call_count, kFakeNetints.size());
+
+  ASSERT_GT(sent_data_.size(), 154u);
+  EXPECT_EQ(etcpal_unpack_u16b(&sent_data_[2]), 0x8400u);  // Flags: Authoritative response
+  EXPECT_EQ(etcpal_unpack_u16b(&sent_data_[4]), 0u);       // Question count: 0
+  EXPECT_EQ(etcpal_unpack_u16b(&sent_data_[6]), 4u);       // Answer count: 4
+  EXPECT_EQ(etcpal_unpack_u16b(&sent_data_[8]), 0u);       // Authority count: 0
+  EXPECT_EQ(etcpal_unpack_u16b(&sent_data_[10]), 1u);      // Additional count: 1
+
+  // _rdmnet._tcp.local PTR Test._rdmnet._tcp.local
+  EXPECT_EQ(etcpal_unpack_u16b(&sent_data_[32]), 12u);    // Type PTR
+  EXPECT_EQ(etcpal_unpack_u16b(&sent_data_[34]), 1u);     // Class IN, cache flush false
+  EXPECT_EQ(etcpal_unpack_u32b(&sent_data_[36]), 4500u);  // TTL 4500 seconds
+  EXPECT_EQ(etcpal_unpack_u16b(&sent_data_[40]), 7u);     // Data length
+  EXPECT_EQ(etcpal_unpack_u16b(&sent_data_[47]), 0xc00cu);
+
+  // _default._sub._rdmnet._tcp.local PTR Test._rdmnet._tcp.local
+  const uint8_t kSubtypeLabels[] = {
+      8, 95, 100, 101, 102, 97, 117, 108, 116,  // _default
+      4, 95, 115, 117, 98,                      // _sub
+      0xc0, 0x0c                                // Pointer to _rdmnet._tcp.local
+  };
+  EXPECT_EQ(std::memcmp(&sent_data_[49], kSubtypeLabels, sizeof kSubtypeLabels), 0);
+  EXPECT_EQ(etcpal_unpack_u16b(&sent_data_[65]), 12u);      // Type PTR
+  EXPECT_EQ(etcpal_unpack_u16b(&sent_data_[75]), 0xc02au);  // Pointer to Test._rdmnet._tcp.local
+
+  // Test._rdmnet._tcp.local SRV
+  EXPECT_EQ(etcpal_unpack_u16b(&sent_data_[77]), 0xc02au);
+  EXPECT_EQ(etcpal_unpack_u16b(&sent_data_[79]), 33u);      // Type SRV
+  EXPECT_EQ(etcpal_unpack_u16b(&sent_data_[81]), 0x8001u);  // Class IN, cache flush true
+  EXPECT_EQ(etcpal_unpack_u16b(&sent_data_[93]), 8888u);    // Port
+  ExpectHostNameAt(95);
+
+  // Test._rdmnet._tcp.local TXT
+  EXPECT_EQ(etcpal_unpack_u16b(&sent_data_[142]), 0xc02au);
+  EXPECT_EQ(etcpal_unpack_u16b(&sent_data_[144]), 16u);  // Type TXT
+  const std::string kFirstTxtItem = "TxtVers=1";
+  EXPECT_EQ(sent_data_[154], kFirstTxtItem.size());
+  EXPECT_EQ(std::memcmp(&sent_data_[155], kFirstTxtItem.data(), kFirstTxtItem.size()), 0);
+  EXPECT_EQ(etcpal_unpack_u16b(&sent_data_[152]) + 154u, sent_data_.size() - 16u);
+
+  // Host A record for the interface it was sent on
+  const uint8_t* addr_record = &sent_data_[sent_data_.size() - 16];
+  EXPECT_EQ(etcpal_unpack_u16b(&addr_record[0]), 0xc05fu);       // Pointer to the host name
+  EXPECT_EQ(etcpal_unpack_u16b(&addr_record[2]), 1u);            // Type A
+  EXPECT_EQ(etcpal_unpack_u16b(&addr_record[4]), 0x8001u);       // Class IN, cache flush true
+  EXPECT_EQ(etcpal_unpack_u32b(&addr_record[6]), 120u);          // TTL 120 seconds
+  EXPECT_EQ(etcpal_unpack_u16b(&addr_record[10]), 4u);           // Data length
+  EXPECT_EQ(etcpal_unpack_u32b(&addr_record[12]), 0x0a65141eu);  // 10.101.20.30
+}
+
+TEST_F(TestLwMdnsSendBrokerRecords, SendGoodbyeUsesZeroTtl)
+{
+  lwmdns_send_broker_records(&broker_ref_, true);
+
+  ASSERT_GT(sent_data_.size(), 154u);
+  EXPECT_EQ(etcpal_unpack_u32b(&sent_data_[36]), 0u);   // PTR TTL
+  EXPECT_EQ(etcpal_unpack_u32b(&sent_data_[69]), 0u);   // Subtype PTR TTL
+  EXPECT_EQ(etcpal_unpack_u32b(&sent_data_[83]), 0u);   // SRV TTL
+  EXPECT_EQ(etcpal_unpack_u32b(&sent_data_[148]), 0u);  // TXT TTL
+}
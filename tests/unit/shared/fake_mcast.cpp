@@ -19,6 +19,7 @@
 
 #include "fake_mcast.h"
 
+#include "etcpal_mock/socket.h"
 #include "rdmnet_mock/core/mcast.h"
 #include "gtest/gtest.h"
 
@@ -44,5 +45,22 @@ void SetUpFakeMcastEnvironment()
     return (std::find(kFakeNetints.begin(), kFakeNetints.end(), *id) != kFakeNetints.end());
   };
   rc_mcast_get_lowest_mac_addr_fake.return_val = &kLowestMacAddr.get();
+  // Fan-out sends behave like the portable implementation, so tests can inspect each datagram sent.
+  rc_mcast_send_to_netints_fake.custom_fake = [](const RCMcastSendNetint* netints, size_t num_netints,
+                                                 const uint8_t* data, size_t data_len, const EtcPalSockAddr* v4_dest,
+                                                 const EtcPalSockAddr* v6_dest) {
+    etcpal_error_t res = kEtcPalErrOk;
+    for (const RCMcastSendNetint* netint = netints; netint < netints + num_netints; ++netint)
+    {
+      const EtcPalSockAddr* dest = (netint->id.ip_type == kEtcPalIpTypeV6 ? v6_dest : v4_dest);
+      if (dest)
+      {
+        int send_res = etcpal_sendto(netint->socket, data, data_len, 0, dest);
+        if (send_res < 0)
+          res = static_cast<etcpal_error_t>(send_res);
+      }
+    }
+    return res;
+  };
   // Add other fakes as needed
 }
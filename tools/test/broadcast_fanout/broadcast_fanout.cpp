@@ -0,0 +1,344 @@
+// broadcast_fanout, a benchmark of the broker's RPT broadcast fan-out.
+//
+// Builds a population of RPT devices, split evenly across four manufacturers, and times pushing an
+// RDM GET to all of them (a device broadcast) and to the devices of one manufacturer (a
+// manufacturer-specific device broadcast) at 10, 100 and 1,000 devices. Each case is run two ways:
+//
+//   snapshot: PushToRptClients() over a contiguous array of destinations, as the broker does now
+//   map:      a filtered walk of an unordered_map of all devices, as the broker did previously
+//
+// The queued messages are discarded between batches of broadcasts, outside of the timed region.
+//
+// Usage: broadcast_fanout [--min-time SECONDS] [--json]
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "rdm/defs.h"
+#include "rdm/message.h"
+#include "rdm/uid.h"
+#include "rdmnet/core/message.h"
+#include "rdmnet/defs.h"
+#include "broker_client.h"
+#include "broker_util.h"
+
+namespace
+{
+constexpr size_t   kDestinationCounts[] = {10, 100, 1000};
+constexpr uint16_t kManufacturers[] = {0x6574, 0x7465, 0x1234, 0x4321};
+constexpr size_t   kNumManufacturers = sizeof(kManufacturers) / sizeof(kManufacturers[0]);
+constexpr RdmUid   kControllerUid = {0x6574, 0x00000001};
+
+// Broadcasts per timed batch. The device queues are emptied after each batch.
+constexpr int kBatchSize = 64;
+
+// A device whose queues can be emptied without a socket to send them on.
+class BenchDevice : public RPTDevice
+{
+public:
+  BenchDevice(const RdmnetRptClientEntry& entry, const BrokerClient& prev_client)
+      : RPTDevice(kLimitlessQueueSize, entry, prev_client)
+  {
+  }
+
+  void Drain() { ClearAllQueues(); }
+};
+
+// The broadcast destinations in both of the forms being compared.
+struct Population
+{
+  std::vector<std::shared_ptr<BenchDevice>>              devices;
+  std::vector<std::shared_ptr<BenchDevice>>              manu_devices;
+  std::unordered_map<BrokerClient::Handle, BenchDevice*> device_map;
+
+  explicit Population(size_t num_devices)
+  {
+    for (size_t i = 0; i < num_devices; ++i)
+    {
+      auto handle = static_cast<BrokerClient::Handle>(i);
+
+      RdmnetRptClientEntry entry{};
+      entry.cid.data[0] = static_cast<uint8_t>(i >> 8);
+      entry.cid.data[1] = static_cast<uint8_t>(i);
+      entry.uid = RdmUid{kManufacturers[i % kNumManufacturers], static_cast<uint32_t>(0x1000 + i)};
+      entry.type = kRPTClientTypeDevice;
+
+      auto device = std::make_shared<BenchDevice>(entry, BrokerClient(handle, ETCPAL_SOCKET_INVALID));
+      devices.push_back(device);
+      if ((device->uid_.manu & 0x7fffu) == kManufacturers[0])
+        manu_devices.push_back(device);
+      device_map.insert(std::make_pair(handle, device.get()));
+    }
+  }
+
+  void Drain()
+  {
+    for (auto& device : devices)
+      device->Drain();
+  }
+};
+
+// The broker's previous broadcast path, retained here for comparison: four passes over the map of
+// all devices, applying the destination filter on each.
+template <class ClientMap, class FilterFunction>
+ClientPushResult PushToRptClientMap(BrokerClient::Handle sender_handle,
+                                    const RdmnetMessage* msg,
+                                    ClientMap&           dest_clients,
+                                    FilterFunction       dest_filter)
+{
+  ClientPushResult  result = ClientPushResult::Ok;
+  const RptMessage* rptmsg = RDMNET_GET_RPT_MSG(msg);
+
+  int num_successful_locks = 0;
+  for (auto dest = dest_clients.begin(); dest != dest_clients.end(); ++dest)
+  {
+    if (dest_filter(dest))
+    {
+      if (dest->second->lock_.WriteLock())
+      {
+        ++num_successful_locks;
+      }
+      else
+      {
+        result = ClientPushResult::Error;
+        break;
+      }
+    }
+  }
+
+  if (result == ClientPushResult::Ok)
+  {
+    for (auto dest = dest_clients.begin(); dest != dest_clients.end(); ++dest)
+    {
+      if (dest_filter(dest) && !dest->second->HasRoomToPush())
+        result = ClientPushResult::QueueFull;
+    }
+  }
+
+  if (result == ClientPushResult::Ok)
+  {
+    for (auto dest = dest_clients.begin(); dest != dest_clients.end(); ++dest)
+    {
+      if (dest_filter(dest))
+      {
+        auto push_res = dest->second->Push(sender_handle, msg->sender_cid, *rptmsg);
+        if (result == ClientPushResult::Ok)
+          result = push_res;
+      }
+    }
+  }
+
+  for (auto dest = dest_clients.begin(); dest != dest_clients.end(); ++dest)
+  {
+    if (num_successful_locks == 0)
+      break;
+
+    if (dest_filter(dest))
+    {
+      dest->second->lock_.WriteUnlock();
+      --num_successful_locks;
+    }
+  }
+
+  return result;
+}
+
+// An RDM GET command from a controller, addressed to dest_uid.
+struct BroadcastMessage
+{
+  RdmnetMessage msg{};
+  RdmBuffer     buf{};
+
+  explicit BroadcastMessage(const RdmUid& dest_uid)
+  {
+    msg.vector = ACN_VECTOR_ROOT_RPT;
+    msg.sender_cid.data[0] = 0x42;
+
+    RptMessage* rpt_msg = RDMNET_GET_RPT_MSG(&msg);
+    rpt_msg->vector = VECTOR_RPT_REQUEST;
+    rpt_msg->header.source_uid = kControllerUid;
+    rpt_msg->header.source_endpoint_id = E133_NULL_ENDPOINT;
+    rpt_msg->header.dest_uid = dest_uid;
+    rpt_msg->header.dest_endpoint_id = E133_NULL_ENDPOINT;
+    rpt_msg->header.seqnum = 1;
+
+    RdmCommandHeader rdm_header;
+    rdm_header.source_uid = kControllerUid;
+    rdm_header.dest_uid = dest_uid;
+    rdm_header.transaction_num = 1;
+    rdm_header.port_id = 1;
+    rdm_header.subdevice = 0;
+    rdm_header.command_class = kRdmCCGetCommand;
+    rdm_header.param_id = E120_DEVICE_INFO;
+    rdm_pack_command(&rdm_header, nullptr, 0, &buf);
+
+    RptRdmBufList* buf_list = RPT_GET_RDM_BUF_LIST(rpt_msg);
+    buf_list->rdm_buffers = &buf;
+    buf_list->num_rdm_buffers = 1;
+    buf_list->more_coming = false;
+  }
+
+  // Copying would leave the buffer list pointing at the original.
+  BroadcastMessage(const BroadcastMessage&) = delete;
+  BroadcastMessage& operator=(const BroadcastMessage&) = delete;
+};
+
+struct BenchmarkResult
+{
+  std::string name;
+  bool        ok;
+  size_t      destinations;
+  uint64_t    broadcasts;
+  double      ns_per_broadcast;
+  double      ns_per_destination;
+};
+
+// Runs batches of broadcasts until at least min_time_s of broadcasting has been timed.
+template <class BroadcastFunction>
+BenchmarkResult RunBenchmark(const std::string& name,
+                             size_t             destinations,
+                             Population&        population,
+                             BroadcastFunction  broadcast,
+                             double             min_time_s)
+{
+  BenchmarkResult result{name, false, destinations, 0, 0.0, 0.0};
+
+  // One untimed batch to validate the benchmark and warm the caches.
+  for (int i = 0; i < kBatchSize; ++i)
+  {
+    if (broadcast() != ClientPushResult::Ok)
+      return result;
+  }
+  population.Drain();
+
+  std::chrono::steady_clock::duration elapsed{};
+  while (std::chrono::duration<double>(elapsed).count() < min_time_s)
+  {
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < kBatchSize; ++i)
+      broadcast();
+    elapsed += std::chrono::steady_clock::now() - start;
+    result.broadcasts += kBatchSize;
+
+    population.Drain();
+  }
+
+  double elapsed_ns = std::chrono::duration<double, std::nano>(elapsed).count();
+  result.ok = true;
+  result.ns_per_broadcast = elapsed_ns / static_cast<double>(result.broadcasts);
+  result.ns_per_destination = result.ns_per_broadcast / static_cast<double>(destinations);
+  return result;
+}
+
+void PrintTable(const std::vector<BenchmarkResult>& results)
+{
+  std::cout << std::left << std::setw(32) << "Benchmark" << std::right << std::setw(14) << "Destinations"
+            << std::setw(14) << "Broadcasts" << std::setw(16) << "ns/broadcast" << std::setw(18) << "ns/destination"
+            << "\n";
+  for (const auto& result : results)
+  {
+    std::cout << std::left << std::setw(32) << result.name << std::right << std::setw(14) << result.destinations;
+    if (!result.ok)
+    {
+      std::cout << std::setw(14) << "ERROR\n";
+      continue;
+    }
+    std::cout << std::setw(14) << result.broadcasts << std::fixed << std::setprecision(1) << std::setw(16)
+              << result.ns_per_broadcast << std::setw(18) << result.ns_per_destination << "\n";
+  }
+  std::cout << std::flush;
+}
+
+void PrintJson(const std::vector<BenchmarkResult>& results)
+{
+  std::cout << "{\n  \"benchmarks\": [\n";
+  for (size_t i = 0; i < results.size(); ++i)
+  {
+    const auto& result = results[i];
+    std::cout << "    {\"name\": \"" << result.name << "\", \"error\": " << (result.ok ? "false" : "true")
+              << ", \"destinations\": " << result.destinations << ", \"iterations\": " << result.broadcasts
+              << ", \"real_time\": " << result.ns_per_broadcast
+              << ", \"time_unit\": \"ns\", \"ns_per_destination\": " << result.ns_per_destination << "}"
+              << (i + 1 < results.size() ? "," : "") << "\n";
+  }
+  std::cout << "  ]\n}" << std::endl;
+}
+}  // namespace
+
+int main(int argc, char* argv[])
+{
+  double min_time_s = 0.5;
+  bool   json = false;
+  for (int i = 1; i < argc; ++i)
+  {
+    std::string arg = argv[i];
+    if (arg == "--json")
+    {
+      json = true;
+    }
+    else if (arg == "--min-time" && i + 1 < argc)
+    {
+      min_time_s = std::strtod(argv[++i], nullptr);
+    }
+    else
+    {
+      std::cerr << "Usage: " << argv[0] << " [--min-time SECONDS] [--json]" << std::endl;
+      return 1;
+    }
+  }
+
+  RdmUid device_manu_broadcast_uid;
+  RDMNET_INIT_DEVICE_MANU_BROADCAST(&device_manu_broadcast_uid, kManufacturers[0]);
+
+  BroadcastMessage all_devices_msg(kRdmnetDeviceBroadcastUid);
+  BroadcastMessage manu_devices_msg(device_manu_broadcast_uid);
+  const uint16_t   manu = kManufacturers[0];
+
+  std::vector<BenchmarkResult> results;
+  bool                         all_ok = true;
+  for (size_t num_devices : kDestinationCounts)
+  {
+    Population  population(num_devices);
+    std::string suffix = "/" + std::to_string(num_devices);
+
+    results.push_back(RunBenchmark(
+        "all_devices/snapshot" + suffix, population.devices.size(), population,
+        [&]() { return PushToRptClients(0, &all_devices_msg.msg, population.devices); }, min_time_s));
+    results.push_back(RunBenchmark(
+        "all_devices/map" + suffix, population.devices.size(), population,
+        [&]() {
+          return PushToRptClientMap(0, &all_devices_msg.msg, population.device_map,
+                                    [](const decltype(population.device_map)::iterator&) { return true; });
+        },
+        min_time_s));
+    results.push_back(RunBenchmark(
+        "manu_devices/snapshot" + suffix, population.manu_devices.size(), population,
+        [&]() { return PushToRptClients(0, &manu_devices_msg.msg, population.manu_devices); }, min_time_s));
+    results.push_back(RunBenchmark(
+        "manu_devices/map" + suffix, population.manu_devices.size(), population,
+        [&]() {
+          return PushToRptClientMap(0, &manu_devices_msg.msg, population.device_map,
+                                    [&](const decltype(population.device_map)::iterator& dest) {
+                                      return ((dest->second->uid_.manu & 0x7fffu) == manu);
+                                    });
+        },
+        min_time_s));
+
+    for (size_t i = results.size() - 4; i < results.size(); ++i)
+      all_ok = all_ok && results[i].ok;
+  }
+
+  if (json)
+    PrintJson(results);
+  else
+    PrintTable(results);
+  return all_ok ? 0 : 1;
+}
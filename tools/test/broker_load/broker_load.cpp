@@ -0,0 +1,572 @@
+// broker_load, a loopback load generator and benchmark for the broker and client stack.
+//
+// An in-process broker is started on the loopback interface, and a configurable number of
+// controllers and devices connect to it with a static broker address. Each controller keeps a
+// window of RDM GET and/or SET commands outstanding, addressed round-robin to the devices, and the
+// devices ACK each one synchronously. Optionally, the devices also send unsolicited RDM updates
+// (notifications) at a fixed aggregate rate, which the broker fans out to every controller.
+//
+// All traffic goes through the real client and broker stacks. When the run finishes, a single JSON
+// object is written to stdout containing the message rate, the command round-trip latency
+// percentiles and the process CPU time spent per message. A message is counted for each command
+// response and each notification received by a controller.
+//
+// Usage: broker_load [--controllers N] [--devices N] [--duration SECONDS] [--warmup SECONDS]
+//                    [--window N] [--set-percent 0-100] [--pd-len BYTES] [--updates-per-sec N]
+//                    [--port PORT]
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "etcpal/cpp/inet.h"
+#include "etcpal/cpp/uuid.h"
+#include "rdm/defs.h"
+#include "rdmnet/cpp/broker.h"
+#include "rdmnet/cpp/common.h"
+#include "rdmnet/cpp/controller.h"
+#include "rdmnet/cpp/device.h"
+
+namespace
+{
+constexpr uint16_t kManufacturerId = 0x6574;
+constexpr uint32_t kFirstDeviceId = 0x1000;
+constexpr size_t   kMaxPdLen = 231;
+constexpr char     kScope[] = "broker_load";
+
+// Commands that have not been answered after this long are abandoned so they stop holding up the
+// window.
+constexpr auto kCommandTimeout = std::chrono::seconds(5);
+
+using Clock = std::chrono::steady_clock;
+
+struct Options
+{
+  size_t   controllers{4};
+  size_t   devices{16};
+  double   duration_s{10.0};
+  double   warmup_s{1.0};
+  size_t   window{8};
+  unsigned set_percent{0};
+  size_t   pd_len{32};
+  double   updates_per_sec{0.0};
+  uint16_t port{8890};
+};
+
+// Set while results are being recorded; traffic outside of this window (warmup and drain) is not
+// counted.
+std::atomic<bool> recording{false};
+std::atomic<bool> stopping{false};
+
+class SimDevice : public rdmnet::Device::NotifyHandler
+{
+public:
+  explicit SimDevice(size_t pd_len) : pd_len_(pd_len), response_buf_(kMaxPdLen)
+  {
+    for (size_t i = 0; i < response_buf_.size(); ++i)
+      response_buf_[i] = static_cast<uint8_t>('a' + (i % 26));
+  }
+
+  std::atomic<bool> connected{false};
+  rdmnet::Device    device;
+
+  etcpal::Error Startup(uint32_t device_id, uint16_t port)
+  {
+    rdmnet::Device::Settings settings(etcpal::Uuid::OsPreferred(), rdm::Uid(kManufacturerId, device_id));
+    settings.response_buf = response_buf_.data();
+    return device.Startup(*this, settings, kScope, etcpal::SockAddr(etcpal::IpAddr::FromString("127.0.0.1"), port));
+  }
+
+  bool SendUpdate() { return device.SendRdmUpdate(E120_DEVICE_LABEL, response_buf_.data(), pd_len_).IsOk(); }
+
+  void HandleConnectedToBroker(rdmnet::Device::Handle, const rdmnet::ClientConnectedInfo&) override
+  {
+    connected = true;
+  }
+  void HandleBrokerConnectFailed(rdmnet::Device::Handle, const rdmnet::ClientConnectFailedInfo&) override {}
+  void HandleDisconnectedFromBroker(rdmnet::Device::Handle, const rdmnet::ClientDisconnectedInfo&) override
+  {
+    connected = false;
+  }
+  rdmnet::RdmResponseAction HandleRdmCommand(rdmnet::Device::Handle, const rdmnet::RdmCommand& cmd) override
+  {
+    // The response data is already in the response buffer.
+    return rdmnet::RdmResponseAction::SendAck(cmd.IsGet() ? pd_len_ : 0);
+  }
+  rdmnet::RdmResponseAction HandleLlrpRdmCommand(rdmnet::Device::Handle, const rdmnet::llrp::RdmCommand&) override
+  {
+    return rdmnet::RdmResponseAction::SendNack(kRdmNRUnknownPid);
+  }
+
+private:
+  size_t               pd_len_;
+  std::vector<uint8_t> response_buf_;
+};
+
+struct ControllerStats
+{
+  uint64_t commands_sent{0};
+  uint64_t send_errors{0};
+  uint64_t responses{0};
+  uint64_t nacks{0};
+  uint64_t rpt_statuses{0};
+  uint64_t timeouts{0};
+  uint64_t notifications{0};
+
+  std::vector<uint32_t> latencies_us;
+};
+
+class SimController : public rdmnet::Controller::NotifyHandler
+{
+public:
+  SimController(const Options& options, const std::vector<rdm::Uid>& device_uids, unsigned seed)
+      : options_(options), device_uids_(device_uids), rng_(seed), set_data_(options.pd_len, 'x')
+  {
+  }
+
+  std::atomic<bool>  connected{false};
+  rdmnet::Controller controller;
+
+  etcpal::Error Startup(uint16_t port)
+  {
+    rdmnet::Controller::Settings settings(etcpal::Uuid::OsPreferred(), kManufacturerId);
+    rdmnet::Controller::RdmData  rdm_data(1, 1, "ETC", "broker_load", "0.0.0", "broker_load controller");
+    auto                         res = controller.Startup(*this, settings, rdm_data);
+    if (!res)
+      return res;
+
+    auto scope = controller.AddScope(kScope, etcpal::SockAddr(etcpal::IpAddr::FromString("127.0.0.1"), port));
+    if (!scope)
+      return scope.error();
+    scope_ = *scope;
+    return kEtcPalErrOk;
+  }
+
+  void StartSending() { sender_ = std::thread(&SimController::SendLoop, this); }
+
+  void StopSending()
+  {
+    window_cv_.notify_all();
+    if (sender_.joinable())
+      sender_.join();
+  }
+
+  ControllerStats TakeStats()
+  {
+    std::lock_guard<std::mutex> lock(lock_);
+    return std::move(stats_);
+  }
+
+  void HandleConnectedToBroker(rdmnet::Controller::Handle,
+                               rdmnet::ScopeHandle,
+                               const rdmnet::ClientConnectedInfo&) override
+  {
+    connected = true;
+  }
+  void HandleBrokerConnectFailed(rdmnet::Controller::Handle,
+                                 rdmnet::ScopeHandle,
+                                 const rdmnet::ClientConnectFailedInfo&) override
+  {
+  }
+  void HandleDisconnectedFromBroker(rdmnet::Controller::Handle,
+                                    rdmnet::ScopeHandle,
+                                    const rdmnet::ClientDisconnectedInfo&) override
+  {
+    connected = false;
+  }
+  void HandleClientListUpdate(rdmnet::Controller::Handle,
+                              rdmnet::ScopeHandle,
+                              client_list_action_t,
+                              const rdmnet::RptClientList&) override
+  {
+  }
+
+  bool HandleRdmResponse(rdmnet::Controller::Handle, rdmnet::ScopeHandle, const rdmnet::RdmResponse& resp) override
+  {
+    auto now = Clock::now();
+
+    std::lock_guard<std::mutex> lock(lock_);
+    if (!resp.IsResponseToMe())
+    {
+      if (recording)
+        ++stats_.notifications;
+      return true;
+    }
+
+    auto outstanding = outstanding_.find(resp.seq_num());
+    if (outstanding != outstanding_.end())
+    {
+      CompleteCommand(outstanding->second, now, resp.IsAck());
+      outstanding_.erase(outstanding);
+    }
+    else
+    {
+      // The response beat the sender to recording the sequence number.
+      early_responses_[resp.seq_num()] = EarlyResponse{now, resp.IsAck()};
+    }
+    return true;
+  }
+
+  void HandleRptStatus(rdmnet::Controller::Handle, rdmnet::ScopeHandle, const rdmnet::RptStatus& status) override
+  {
+    std::lock_guard<std::mutex> lock(lock_);
+    if (outstanding_.erase(status.seq_num()) != 0)
+    {
+      if (recording)
+        ++stats_.rpt_statuses;
+      window_cv_.notify_one();
+    }
+  }
+
+private:
+  const Options&               options_;
+  const std::vector<rdm::Uid>& device_uids_;
+  std::minstd_rand             rng_;
+  std::vector<uint8_t>         set_data_;
+  size_t                       next_device_{0};
+  rdmnet::ScopeHandle          scope_;
+  std::thread                  sender_;
+
+  struct EarlyResponse
+  {
+    Clock::time_point received_at;
+    bool              is_ack;
+  };
+
+  // Protects the members below, which are shared with the library's callback thread. It is not held
+  // while sending, so a response can be received before its sequence number has been recorded.
+  std::mutex                                      lock_;
+  std::condition_variable                         window_cv_;
+  std::unordered_map<uint32_t, Clock::time_point> outstanding_;
+  std::unordered_map<uint32_t, EarlyResponse>     early_responses_;
+  ControllerStats                                 stats_;
+
+  void CompleteCommand(Clock::time_point sent_at, Clock::time_point received_at, bool is_ack)
+  {
+    if (recording)
+    {
+      ++stats_.responses;
+      if (!is_ack)
+        ++stats_.nacks;
+      stats_.latencies_us.push_back(static_cast<uint32_t>(
+          std::chrono::duration_cast<std::chrono::microseconds>(received_at - sent_at).count()));
+    }
+    window_cv_.notify_one();
+  }
+
+  void SendLoop()
+  {
+    std::unique_lock<std::mutex> lock(lock_);
+    while (!stopping)
+    {
+      if (outstanding_.size() >= options_.window)
+      {
+        if (!window_cv_.wait_for(lock, std::chrono::milliseconds(100),
+                                 [this] { return stopping || outstanding_.size() < options_.window; }))
+        {
+          ExpireOutstanding();
+        }
+        continue;
+      }
+
+      const rdm::Uid& dest = device_uids_[next_device_];
+      next_device_ = (next_device_ + 1) % device_uids_.size();
+
+      lock.unlock();
+      auto sent_at = Clock::now();
+      auto seq_num = (rng_() % 100 < options_.set_percent)
+                         ? controller.SendSetCommand(scope_, rdmnet::DestinationAddr::ToDefaultResponder(dest),
+                                                     E120_DEVICE_LABEL, set_data_.data(),
+                                                     static_cast<uint8_t>(set_data_.size()))
+                         : controller.SendGetCommand(scope_, rdmnet::DestinationAddr::ToDefaultResponder(dest),
+                                                     E120_DEVICE_LABEL);
+      if (!seq_num)
+      {
+        // Back off briefly; this is usually a full send queue or a dropped connection.
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        lock.lock();
+        if (recording)
+          ++stats_.send_errors;
+        continue;
+      }
+
+      lock.lock();
+      if (recording)
+        ++stats_.commands_sent;
+
+      auto early = early_responses_.find(*seq_num);
+      if (early != early_responses_.end())
+      {
+        CompleteCommand(sent_at, early->second.received_at, early->second.is_ack);
+        early_responses_.erase(early);
+      }
+      else
+      {
+        outstanding_[*seq_num] = sent_at;
+      }
+    }
+  }
+
+  void ExpireOutstanding()
+  {
+    auto now = Clock::now();
+    for (auto it = outstanding_.begin(); it != outstanding_.end();)
+    {
+      if (now - it->second > kCommandTimeout)
+      {
+        if (recording)
+          ++stats_.timeouts;
+        it = outstanding_.erase(it);
+      }
+      else
+      {
+        ++it;
+      }
+    }
+
+    // Responses to commands which were abandoned, or to commands from before a reconnect.
+    for (auto it = early_responses_.begin(); it != early_responses_.end();)
+    {
+      if (now - it->second.received_at > kCommandTimeout)
+        it = early_responses_.erase(it);
+      else
+        ++it;
+    }
+  }
+};
+
+void SendNotifications(std::vector<std::unique_ptr<SimDevice>>& devices,
+                       double                                   updates_per_sec,
+                       std::atomic<uint64_t>&                   notifications_sent)
+{
+  const auto interval =
+      std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(1.0 / updates_per_sec));
+
+  size_t next_device = 0;
+  auto   next_send = Clock::now();
+  while (!stopping)
+  {
+    std::this_thread::sleep_until(next_send);
+    next_send += interval;
+
+    if (devices[next_device]->SendUpdate() && recording)
+      ++notifications_sent;
+    next_device = (next_device + 1) % devices.size();
+
+    // Don't try to make up for a large backlog all at once if the sender falls behind.
+    auto now = Clock::now();
+    if (now - next_send > std::chrono::milliseconds(100))
+      next_send = now;
+  }
+}
+
+uint32_t Percentile(const std::vector<uint32_t>& sorted, double percentile)
+{
+  if (sorted.empty())
+    return 0;
+  size_t index = static_cast<size_t>(percentile / 100.0 * static_cast<double>(sorted.size() - 1) + 0.5);
+  return sorted[std::min(index, sorted.size() - 1)];
+}
+
+bool ParseOptions(int argc, char* argv[], Options& options)
+{
+  for (int i = 1; i < argc; ++i)
+  {
+    std::string arg = argv[i];
+    if (i + 1 >= argc)
+    {
+      std::cerr << "Missing value for option " << arg << std::endl;
+      return false;
+    }
+    const char* val = argv[++i];
+
+    if (arg == "--controllers")
+      options.controllers = std::strtoul(val, nullptr, 10);
+    else if (arg == "--devices")
+      options.devices = std::strtoul(val, nullptr, 10);
+    else if (arg == "--duration")
+      options.duration_s = std::strtod(val, nullptr);
+    else if (arg == "--warmup")
+      options.warmup_s = std::strtod(val, nullptr);
+    else if (arg == "--window")
+      options.window = std::strtoul(val, nullptr, 10);
+    else if (arg == "--set-percent")
+      options.set_percent = static_cast<unsigned>(std::strtoul(val, nullptr, 10));
+    else if (arg == "--pd-len")
+      options.pd_len = std::strtoul(val, nullptr, 10);
+    else if (arg == "--updates-per-sec")
+      options.updates_per_sec = std::strtod(val, nullptr);
+    else if (arg == "--port")
+      options.port = static_cast<uint16_t>(std::strtoul(val, nullptr, 10));
+    else
+    {
+      std::cerr << "Unknown option " << arg << std::endl;
+      return false;
+    }
+  }
+
+  if (options.controllers == 0 || options.devices == 0 || options.window == 0 || options.duration_s <= 0.0 ||
+      options.set_percent > 100 || options.pd_len > kMaxPdLen)
+  {
+    std::cerr << "Invalid options. Controllers, devices, window and duration must be nonzero, set-percent must be "
+                 "0-100 and pd-len must be at most "
+              << kMaxPdLen << "." << std::endl;
+    return false;
+  }
+  return true;
+}
+
+template <typename Clients>
+bool WaitForConnections(const Clients& clients)
+{
+  auto deadline = Clock::now() + std::chrono::seconds(10);
+  while (Clock::now() < deadline)
+  {
+    if (std::all_of(clients.begin(), clients.end(), [](const auto& client) { return client->connected.load(); }))
+      return true;
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+  return false;
+}
+}  // namespace
+
+int main(int argc, char* argv[])
+{
+  Options options;
+  if (!ParseOptions(argc, argv, options))
+    return 1;
+
+  auto res = rdmnet::Init();
+  if (!res)
+  {
+    std::cerr << "Error initializing RDMnet library: " << res.ToString() << std::endl;
+    return 1;
+  }
+
+  rdmnet::Broker::Settings broker_settings(etcpal::Uuid::OsPreferred(), kManufacturerId);
+  broker_settings.scope = kScope;
+  broker_settings.listen_port = options.port;
+
+  rdmnet::Broker broker;
+  res = broker.Startup(broker_settings);
+  if (!res)
+  {
+    std::cerr << "Error starting broker: " << res.ToString() << std::endl;
+    rdmnet::Deinit();
+    return 1;
+  }
+
+  std::vector<rdm::Uid>                   device_uids;
+  std::vector<std::unique_ptr<SimDevice>> devices;
+  for (size_t i = 0; i < options.devices && res; ++i)
+  {
+    devices.push_back(std::make_unique<SimDevice>(options.pd_len));
+    device_uids.push_back(rdm::Uid(kManufacturerId, kFirstDeviceId + static_cast<uint32_t>(i)));
+    res = devices.back()->Startup(kFirstDeviceId + static_cast<uint32_t>(i), options.port);
+  }
+
+  std::vector<std::unique_ptr<SimController>> controllers;
+  for (size_t i = 0; i < options.controllers && res; ++i)
+  {
+    controllers.push_back(std::make_unique<SimController>(options, device_uids, static_cast<unsigned>(i + 1)));
+    res = controllers.back()->Startup(options.port);
+  }
+
+  auto shutdown = [&]() {
+    for (auto& controller : controllers)
+      controller->controller.Shutdown();
+    for (auto& device : devices)
+      device->device.Shutdown();
+    broker.Shutdown();
+    rdmnet::Deinit();
+  };
+
+  if (!res || !WaitForConnections(devices) || !WaitForConnections(controllers))
+  {
+    std::cerr << "Clients failed to connect to the broker"
+              << (res ? std::string(".") : std::string(": ") + res.ToString()) << std::endl;
+    shutdown();
+    return 1;
+  }
+
+  std::atomic<uint64_t> notifications_sent{0};
+  std::thread           notifier;
+  if (options.updates_per_sec > 0.0)
+    notifier = std::thread(SendNotifications, std::ref(devices), options.updates_per_sec, std::ref(notifications_sent));
+  for (auto& controller : controllers)
+    controller->StartSending();
+
+  std::this_thread::sleep_for(std::chrono::duration<double>(options.warmup_s));
+
+  recording = true;
+  auto    start = Clock::now();
+  clock_t cpu_start = std::clock();
+  std::this_thread::sleep_for(std::chrono::duration<double>(options.duration_s));
+  clock_t cpu_end = std::clock();
+  auto    end = Clock::now();
+  recording = false;
+
+  stopping = true;
+  for (auto& controller : controllers)
+    controller->StopSending();
+  if (notifier.joinable())
+    notifier.join();
+
+  ControllerStats totals;
+  for (auto& controller : controllers)
+  {
+    ControllerStats stats = controller->TakeStats();
+    totals.commands_sent += stats.commands_sent;
+    totals.send_errors += stats.send_errors;
+    totals.responses += stats.responses;
+    totals.nacks += stats.nacks;
+    totals.rpt_statuses += stats.rpt_statuses;
+    totals.timeouts += stats.timeouts;
+    totals.notifications += stats.notifications;
+    totals.latencies_us.insert(totals.latencies_us.end(), stats.latencies_us.begin(), stats.latencies_us.end());
+  }
+  shutdown();
+
+  std::sort(totals.latencies_us.begin(), totals.latencies_us.end());
+
+  double   seconds = std::chrono::duration<double>(end - start).count();
+  uint64_t messages = totals.responses + totals.notifications;
+  double   cpu_us = 1e6 * static_cast<double>(cpu_end - cpu_start) / CLOCKS_PER_SEC;
+
+  std::cout << "{\n";
+  std::cout << "  \"controllers\": " << options.controllers << ",\n";
+  std::cout << "  \"devices\": " << options.devices << ",\n";
+  std::cout << "  \"window\": " << options.window << ",\n";
+  std::cout << "  \"set_percent\": " << options.set_percent << ",\n";
+  std::cout << "  \"pd_len\": " << options.pd_len << ",\n";
+  std::cout << "  \"updates_per_sec\": " << options.updates_per_sec << ",\n";
+  std::cout << "  \"duration_s\": " << seconds << ",\n";
+  std::cout << "  \"commands_sent\": " << totals.commands_sent << ",\n";
+  std::cout << "  \"send_errors\": " << totals.send_errors << ",\n";
+  std::cout << "  \"responses\": " << totals.responses << ",\n";
+  std::cout << "  \"nacks\": " << totals.nacks << ",\n";
+  std::cout << "  \"rpt_statuses\": " << totals.rpt_statuses << ",\n";
+  std::cout << "  \"timeouts\": " << totals.timeouts << ",\n";
+  std::cout << "  \"notifications_sent\": " << notifications_sent << ",\n";
+  std::cout << "  \"notifications_received\": " << totals.notifications << ",\n";
+  std::cout << "  \"msgs_per_sec\": " << (seconds > 0.0 ? messages / seconds : 0.0) << ",\n";
+  std::cout << "  \"latency_us\": {\"p50\": " << Percentile(totals.latencies_us, 50.0)
+            << ", \"p99\": " << Percentile(totals.latencies_us, 99.0)
+            << ", \"p999\": " << Percentile(totals.latencies_us, 99.9)
+            << ", \"max\": " << (totals.latencies_us.empty() ? 0 : totals.latencies_us.back()) << "},\n";
+  std::cout << "  \"cpu_us_per_msg\": " << (messages > 0 ? cpu_us / messages : 0.0) << "\n";
+  std::cout << "}" << std::endl;
+  return 0;
+}
@@ -0,0 +1,552 @@
+// codec_bench, microbenchmarks of the RDMnet message codec.
+//
+// Each benchmark is run repeatedly until a minimum time has elapsed, in the style of Google
+// Benchmark, and reports the time per iteration, the throughput in bytes per second and the number
+// of heap allocations per message.
+//
+// The parse benchmarks replay each wire-format fixture in tests/data/messages through
+// rc_msg_buf_parse_data(), plus synthetically scaled messages: 1,000-entry client lists and UID
+// assignment lists, and a long chain of max-size ACK_OVERFLOW responses. Messages larger than the
+// receive buffer are streamed through it in pieces, as a connection would. The pack benchmarks
+// time each of the rc_*_pack_*() functions.
+//
+// Usage: codec_bench [--filter SUBSTRING] [--min-time SECONDS] [--json]
+//
+// --json writes the results as a single JSON object suitable for comparison between runs in CI.
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "rdm/defs.h"
+#include "rdmnet/core/broker_prot.h"
+#include "rdmnet/core/ept_prot.h"
+#include "rdmnet/core/message.h"
+#include "rdmnet/core/msg_buf.h"
+#include "rdmnet/core/rpt_prot.h"
+#include "rdmnet/defs.h"
+#include "load_test_data.h"
+
+extern const std::vector<const char*> kCodecBenchFixtures;
+
+/*********************************** Allocation counting ***********************************/
+
+namespace
+{
+uint64_t num_allocs = 0;
+}
+
+#if CODEC_BENCH_COUNT_ALLOCS
+extern "C" {
+void* __real_malloc(size_t size);
+void* __real_realloc(void* ptr, size_t size);
+void* __real_calloc(size_t num, size_t size);
+
+void* __wrap_malloc(size_t size)
+{
+  ++num_allocs;
+  return __real_malloc(size);
+}
+
+void* __wrap_realloc(void* ptr, size_t size)
+{
+  ++num_allocs;
+  return __real_realloc(ptr, size);
+}
+
+void* __wrap_calloc(size_t num, size_t size)
+{
+  ++num_allocs;
+  return __real_calloc(num, size);
+}
+}
+constexpr bool kCountingAllocs = true;
+#else
+constexpr bool kCountingAllocs = false;
+#endif
+
+namespace
+{
+/************************************* Harness *************************************/
+
+// The work done by one iteration of a benchmark. An iteration that processes no messages is an
+// error.
+struct IterationResult
+{
+  size_t bytes;
+  size_t messages;
+};
+
+struct Benchmark
+{
+  std::string                      name;
+  std::function<IterationResult()> run;
+};
+
+struct BenchmarkResult
+{
+  std::string name;
+  bool        ok;
+  uint64_t    iterations;
+  double      ns_per_iteration;
+  double      bytes_per_second;
+  double      messages_per_second;
+  double      allocs_per_message;
+};
+
+BenchmarkResult RunBenchmark(const Benchmark& benchmark, double min_time_s)
+{
+  BenchmarkResult result{benchmark.name, false, 0, 0.0, 0.0, 0.0, 0.0};
+
+  // One untimed iteration to validate the benchmark and warm the caches.
+  IterationResult per_iteration = benchmark.run();
+  if (per_iteration.messages == 0)
+    return result;
+
+  uint64_t iterations = 1;
+  while (true)
+  {
+    uint64_t allocs_before = num_allocs;
+    auto     start = std::chrono::steady_clock::now();
+    for (uint64_t i = 0; i < iterations; ++i)
+      benchmark.run();
+    auto     end = std::chrono::steady_clock::now();
+    uint64_t allocs = num_allocs - allocs_before;
+
+    double elapsed_s = std::chrono::duration<double>(end - start).count();
+    if (elapsed_s >= min_time_s || iterations >= (uint64_t{1} << 40))
+    {
+      double total_messages = static_cast<double>(per_iteration.messages * iterations);
+      result.ok = true;
+      result.iterations = iterations;
+      result.ns_per_iteration = elapsed_s * 1e9 / static_cast<double>(iterations);
+      result.bytes_per_second = static_cast<double>(per_iteration.bytes * iterations) / elapsed_s;
+      result.messages_per_second = total_messages / elapsed_s;
+      result.allocs_per_message = static_cast<double>(allocs) / total_messages;
+      return result;
+    }
+
+    // Predict the number of iterations needed to reach the minimum time, with some headroom, and
+    // don't grow by more than 10x at a time in case the first runs were unrepresentative.
+    double multiplier = (elapsed_s > 0.0) ? (min_time_s * 1.4 / elapsed_s) : 10.0;
+    multiplier = std::min(std::max(multiplier, 2.0), 10.0);
+    iterations = static_cast<uint64_t>(static_cast<double>(iterations) * multiplier);
+  }
+}
+
+/************************************* Test data *************************************/
+
+constexpr EtcPalUuid kLocalCid = {{0xb7, 0x75, 0x39, 0x00, 0x3c, 0x75, 0x44, 0x6d, 0x93, 0x95, 0x9d, 0xbd, 0xf0, 0x15,
+                                   0x3e, 0xeb}};
+constexpr EtcPalUuid kDestCid = {{0x6e, 0x0a, 0x5a, 0x7e, 0x32, 0x3c, 0x4d, 0x67, 0x8a, 0xc4, 0x28, 0x6f, 0x81, 0x0e,
+                                  0x2c, 0x52}};
+constexpr RdmUid     kControllerUid = {0x6574, 0x00000001};
+constexpr RdmUid     kDeviceUid = {0x6574, 0x00001000};
+constexpr uint16_t   kEptManufacturerId = 0x6574;
+constexpr uint16_t   kEptProtocolId = 0x0001;
+
+constexpr size_t  kLargeListSize = 1000;
+constexpr size_t  kAckOverflowChainLength = 32;
+constexpr size_t  kEptDataSize = 1024;
+constexpr uint8_t kMaxRdmPdl = RDM_MAX_BYTES - 26;  // Header (24) and checksum (2)
+
+EtcPalUuid MakeCid(size_t index)
+{
+  EtcPalUuid cid = kLocalCid;
+  for (size_t i = 0; i < sizeof(size_t) && i < ETCPAL_UUID_BYTES; ++i)
+    cid.data[ETCPAL_UUID_BYTES - 1 - i] = static_cast<uint8_t>(index >> (8 * i));
+  return cid;
+}
+
+RdmUid MakeUid(size_t index)
+{
+  return RdmUid{kDeviceUid.manu, kDeviceUid.id + static_cast<uint32_t>(index)};
+}
+
+void PackUid(uint8_t* buf, const RdmUid& uid)
+{
+  buf[0] = static_cast<uint8_t>(uid.manu >> 8);
+  buf[1] = static_cast<uint8_t>(uid.manu);
+  for (int i = 0; i < 4; ++i)
+    buf[2 + i] = static_cast<uint8_t>(uid.id >> (8 * (3 - i)));
+}
+
+// Build a valid RDM message with the given command class and port ID/response type field.
+RdmBuffer MakeRdmMessage(const RdmUid& dest,
+                         const RdmUid& src,
+                         uint8_t       port_id_or_resp_type,
+                         uint8_t       command_class,
+                         uint8_t       pdl)
+{
+  RdmBuffer rdm{};
+  rdm.data[0] = E120_SC_RDM;
+  rdm.data[1] = E120_SC_SUB_MESSAGE;
+  rdm.data[2] = static_cast<uint8_t>(24 + pdl);
+  PackUid(&rdm.data[3], dest);
+  PackUid(&rdm.data[9], src);
+  rdm.data[15] = 0;  // Transaction number
+  rdm.data[16] = port_id_or_resp_type;
+  rdm.data[17] = 0;  // Message count
+  rdm.data[18] = 0;  // Sub-device
+  rdm.data[19] = 0;
+  rdm.data[20] = command_class;
+  rdm.data[21] = static_cast<uint8_t>(E120_DEVICE_LABEL >> 8);
+  rdm.data[22] = static_cast<uint8_t>(E120_DEVICE_LABEL & 0xff);
+  rdm.data[23] = pdl;
+  for (uint8_t i = 0; i < pdl; ++i)
+    rdm.data[24 + i] = static_cast<uint8_t>('a' + (i % 26));
+
+  uint16_t checksum = 0;
+  for (size_t i = 0; i < 24u + pdl; ++i)
+    checksum = static_cast<uint16_t>(checksum + rdm.data[i]);
+  rdm.data[24 + pdl] = static_cast<uint8_t>(checksum >> 8);
+  rdm.data[25 + pdl] = static_cast<uint8_t>(checksum & 0xff);
+  rdm.data_len = 26u + pdl;
+  return rdm;
+}
+
+// A chain of max-size GET_COMMAND_RESPONSEs, all ACK_OVERFLOW except the last.
+std::vector<RdmBuffer> MakeAckOverflowChain(size_t length)
+{
+  std::vector<RdmBuffer> chain;
+  for (size_t i = 0; i < length; ++i)
+  {
+    uint8_t resp_type = (i == length - 1) ? E120_RESPONSE_TYPE_ACK : E120_RESPONSE_TYPE_ACK_OVERFLOW;
+    chain.push_back(MakeRdmMessage(kControllerUid, kDeviceUid, resp_type, E120_GET_COMMAND_RESPONSE, kMaxRdmPdl));
+  }
+  return chain;
+}
+
+std::vector<RdmnetRptClientEntry> MakeRptClientEntries(size_t num_entries)
+{
+  std::vector<RdmnetRptClientEntry> entries(num_entries);
+  for (size_t i = 0; i < num_entries; ++i)
+  {
+    entries[i].cid = MakeCid(i);
+    entries[i].uid = MakeUid(i);
+    entries[i].type = (i % 8 == 0) ? kRPTClientTypeController : kRPTClientTypeDevice;
+    entries[i].binding_cid = kEtcPalNullUuid;
+  }
+  return entries;
+}
+
+RptHeader MakeRptHeader()
+{
+  return RptHeader{kDeviceUid, 0, kControllerUid, 0, 0x12345678};
+}
+
+/************************************* Parse benchmarks *************************************/
+
+// Stream data through a message buffer as a connection would, parsing messages as they complete.
+// Returns the number of messages parsed.
+size_t ParseStream(RCMsgBuf& msg_buf, const std::vector<uint8_t>& data)
+{
+  rc_msg_buf_init(&msg_buf);
+
+  size_t offset = 0;
+  size_t num_messages = 0;
+  while (true)
+  {
+    if (rc_msg_buf_parse_data(&msg_buf) == kEtcPalErrOk)
+    {
+      ++num_messages;
+      rc_free_message_resources(&msg_buf.msg);
+      continue;
+    }
+
+    size_t to_copy = std::min(RC_MSG_BUF_SIZE - msg_buf.cur_data_size, data.size() - offset);
+    if (to_copy == 0)
+      break;
+    std::memcpy(&msg_buf.buf[msg_buf.cur_data_size], &data[offset], to_copy);
+    msg_buf.cur_data_size += to_copy;
+    offset += to_copy;
+  }
+  return num_messages;
+}
+
+Benchmark MakeParseBenchmark(const std::string& name, std::vector<uint8_t> data)
+{
+  auto msg_buf = std::make_shared<RCMsgBuf>();
+  auto shared_data = std::make_shared<std::vector<uint8_t>>(std::move(data));
+  return Benchmark{"parse/" + name, [msg_buf, shared_data]() {
+                     return IterationResult{shared_data->size(), ParseStream(*msg_buf, *shared_data)};
+                   }};
+}
+
+// Pack a message with the given function into a buffer of the given size.
+template <typename PackFn>
+std::vector<uint8_t> PackToVector(size_t buf_size, PackFn&& pack)
+{
+  std::vector<uint8_t> buf(buf_size);
+  buf.resize(pack(buf.data(), buf.size()));
+  return buf;
+}
+
+void AddParseBenchmarks(std::vector<Benchmark>& benchmarks)
+{
+  for (const char* file_name : kCodecBenchFixtures)
+  {
+    std::string name = file_name;
+    name = name.substr(name.find_last_of("/\\") + 1);
+    name = name.substr(0, name.find(".data.txt"));
+
+    std::ifstream file(file_name);
+    if (!file.is_open())
+    {
+      std::cerr << "Could not open fixture " << file_name << std::endl;
+      continue;
+    }
+    benchmarks.push_back(MakeParseBenchmark(name, rdmnet::testing::LoadTestData(file)));
+  }
+
+  auto rpt_entries = MakeRptClientEntries(kLargeListSize);
+  benchmarks.push_back(MakeParseBenchmark(
+      "rpt_client_list_" + std::to_string(kLargeListSize),
+      PackToVector(rc_broker_get_rpt_client_list_buffer_size(rpt_entries.size()), [&](uint8_t* buf, size_t len) {
+        return rc_broker_pack_rpt_client_list(buf, len, &kLocalCid, VECTOR_BROKER_CONNECTED_CLIENT_LIST,
+                                              rpt_entries.data(), rpt_entries.size());
+      })));
+
+  std::vector<RdmnetDynamicUidMapping> mappings(kLargeListSize);
+  for (size_t i = 0; i < mappings.size(); ++i)
+    mappings[i] = RdmnetDynamicUidMapping{kRdmnetDynamicUidStatusOk, MakeUid(i), MakeCid(i)};
+  benchmarks.push_back(MakeParseBenchmark(
+      "uid_assignment_list_" + std::to_string(kLargeListSize),
+      PackToVector(rc_broker_get_uid_assignment_list_buffer_size(mappings.size()), [&](uint8_t* buf, size_t len) {
+        return rc_broker_pack_uid_assignment_list(buf, len, &kLocalCid, mappings.data(), mappings.size());
+      })));
+
+  auto      chain = MakeAckOverflowChain(kAckOverflowChainLength);
+  RptHeader header = MakeRptHeader();
+  benchmarks.push_back(MakeParseBenchmark(
+      "ack_overflow_chain_" + std::to_string(kAckOverflowChainLength),
+      PackToVector(rc_rpt_get_notification_buffer_size(chain.data(), chain.size()), [&](uint8_t* buf, size_t len) {
+        return rc_rpt_pack_notification(buf, len, &kLocalCid, &header, chain.data(), chain.size());
+      })));
+}
+
+/************************************* Pack benchmarks *************************************/
+
+// Make a benchmark which packs a message into a buffer of buf_size on each iteration.
+template <typename PackFn>
+Benchmark MakePackBenchmark(const std::string& name, size_t buf_size, PackFn pack)
+{
+  auto buf = std::make_shared<std::vector<uint8_t>>(buf_size);
+  return Benchmark{"pack/" + name, [buf, pack]() {
+                     size_t packed = pack(buf->data(), buf->size());
+                     return IterationResult{packed, packed ? 1u : 0u};
+                   }};
+}
+
+void AddPackBenchmarks(std::vector<Benchmark>& benchmarks)
+{
+  benchmarks.push_back(
+      MakePackBenchmark("connect_reply", BROKER_CONNECT_REPLY_FULL_MSG_SIZE, [](uint8_t* buf, size_t len) {
+        BrokerConnectReplyMsg reply{kRdmnetConnectOk, E133_VERSION, kControllerUid, kDeviceUid};
+        return rc_broker_pack_connect_reply(buf, len, &kLocalCid, &reply);
+      }));
+
+  for (size_t num_entries : {size_t{1}, kLargeListSize})
+  {
+    auto entries = std::make_shared<std::vector<RdmnetRptClientEntry>>(MakeRptClientEntries(num_entries));
+    benchmarks.push_back(MakePackBenchmark("rpt_client_list_" + std::to_string(num_entries),
+                                           rc_broker_get_rpt_client_list_buffer_size(num_entries),
+                                           [entries](uint8_t* buf, size_t len) {
+                                             return rc_broker_pack_rpt_client_list(
+                                                 buf, len, &kLocalCid, VECTOR_BROKER_CONNECTED_CLIENT_LIST,
+                                                 entries->data(), entries->size());
+                                           }));
+  }
+
+  {
+    // Each EPT client implements two sub-protocols.
+    static const RdmnetEptSubProtocol kProtocols[] = {{kEptManufacturerId, kEptProtocolId, "Benchmark Protocol 1"},
+                                                      {kEptManufacturerId, kEptProtocolId + 1, "Benchmark Protocol 2"}};
+    auto entries = std::make_shared<std::vector<RdmnetEptClientEntry>>(kLargeListSize);
+    for (size_t i = 0; i < entries->size(); ++i)
+    {
+      (*entries)[i] = RdmnetEptClientEntry{MakeCid(i), const_cast<RdmnetEptSubProtocol*>(kProtocols),
+                                           sizeof(kProtocols) / sizeof(kProtocols[0])};
+    }
+    benchmarks.push_back(MakePackBenchmark("ept_client_list_" + std::to_string(kLargeListSize),
+                                           rc_broker_get_ept_client_list_buffer_size(entries->data(), entries->size()),
+                                           [entries](uint8_t* buf, size_t len) {
+                                             return rc_broker_pack_ept_client_list(
+                                                 buf, len, &kLocalCid, VECTOR_BROKER_CONNECTED_CLIENT_LIST,
+                                                 entries->data(), entries->size());
+                                           }));
+  }
+
+  {
+    auto mappings = std::make_shared<std::vector<RdmnetDynamicUidMapping>>(kLargeListSize);
+    for (size_t i = 0; i < mappings->size(); ++i)
+      (*mappings)[i] = RdmnetDynamicUidMapping{kRdmnetDynamicUidStatusOk, MakeUid(i), MakeCid(i)};
+    benchmarks.push_back(MakePackBenchmark("uid_assignment_list_" + std::to_string(kLargeListSize),
+                                           rc_broker_get_uid_assignment_list_buffer_size(mappings->size()),
+                                           [mappings](uint8_t* buf, size_t len) {
+                                             return rc_broker_pack_uid_assignment_list(
+                                                 buf, len, &kLocalCid, mappings->data(), mappings->size());
+                                           }));
+  }
+
+  benchmarks.push_back(MakePackBenchmark("disconnect", BROKER_DISCONNECT_FULL_MSG_SIZE, [](uint8_t* buf, size_t len) {
+    BrokerDisconnectMsg disconnect{kRdmnetDisconnectShutdown};
+    return rc_broker_pack_disconnect(buf, len, &kLocalCid, &disconnect);
+  }));
+  benchmarks.push_back(MakePackBenchmark("null", BROKER_NULL_FULL_MSG_SIZE, [](uint8_t* buf, size_t len) {
+    return rc_broker_pack_null(buf, len, &kLocalCid);
+  }));
+
+  {
+    RdmBuffer cmd = MakeRdmMessage(kDeviceUid, kControllerUid, 1, E120_GET_COMMAND, 0);
+    benchmarks.push_back(
+        MakePackBenchmark("rpt_request", rc_rpt_get_request_buffer_size(&cmd), [cmd](uint8_t* buf, size_t len) {
+          RptHeader header = MakeRptHeader();
+          return rc_rpt_pack_request(buf, len, &kLocalCid, &header, &cmd);
+        }));
+  }
+
+  {
+    static const RptStatusMsg kStatus{kRptStatusUnknownRdmUid, "The RDM UID is not known to the broker"};
+    benchmarks.push_back(
+        MakePackBenchmark("rpt_status", rc_rpt_get_status_buffer_size(&kStatus), [](uint8_t* buf, size_t len) {
+          RptHeader header = MakeRptHeader();
+          return rc_rpt_pack_status(buf, len, &kLocalCid, &header, &kStatus);
+        }));
+  }
+
+  for (size_t chain_length : {size_t{1}, kAckOverflowChainLength})
+  {
+    auto chain = std::make_shared<std::vector<RdmBuffer>>(MakeAckOverflowChain(chain_length));
+    benchmarks.push_back(MakePackBenchmark("rpt_notification_" + std::to_string(chain_length),
+                                           rc_rpt_get_notification_buffer_size(chain->data(), chain->size()),
+                                           [chain](uint8_t* buf, size_t len) {
+                                             RptHeader header = MakeRptHeader();
+                                             return rc_rpt_pack_notification(buf, len, &kLocalCid, &header,
+                                                                             chain->data(), chain->size());
+                                           }));
+  }
+
+  {
+    auto data = std::make_shared<std::vector<uint8_t>>(kEptDataSize, static_cast<uint8_t>(0x55));
+    benchmarks.push_back(MakePackBenchmark("ept_data_" + std::to_string(kEptDataSize),
+                                           rc_ept_get_data_buffer_size(data->size()),
+                                           [data](uint8_t* buf, size_t len) {
+                                             return rc_ept_pack_data(buf, len, &kLocalCid, &kDestCid,
+                                                                     kEptManufacturerId, kEptProtocolId,
+                                                                     data->data(), data->size());
+                                           }));
+  }
+
+  {
+    static const char kStatusString[] = "The destination CID is not known to the broker";
+    benchmarks.push_back(MakePackBenchmark("ept_status", rc_ept_get_status_buffer_size(kStatusString),
+                                           [](uint8_t* buf, size_t len) {
+                                             return rc_ept_pack_status(buf, len, &kLocalCid, &kDestCid,
+                                                                       kEptStatusUnknownCid, kStatusString);
+                                           }));
+  }
+}
+
+/************************************* Reporting *************************************/
+
+void PrintTable(const std::vector<BenchmarkResult>& results)
+{
+  std::cout << std::left << std::setw(48) << "Benchmark" << std::right << std::setw(14) << "Time (ns)"
+            << std::setw(14) << "Iterations" << std::setw(14) << "MB/s" << std::setw(14) << "Allocs/msg"
+            << std::endl;
+  std::cout << std::string(104, '-') << std::endl;
+  for (const auto& result : results)
+  {
+    std::cout << std::left << std::setw(48) << result.name << std::right;
+    if (!result.ok)
+    {
+      std::cout << std::setw(14) << "ERROR" << std::endl;
+      continue;
+    }
+    std::cout << std::fixed << std::setprecision(1) << std::setw(14) << result.ns_per_iteration << std::setw(14)
+              << result.iterations << std::setw(14) << result.bytes_per_second / 1e6 << std::setw(14);
+    if (kCountingAllocs)
+      std::cout << std::setprecision(2) << result.allocs_per_message;
+    else
+      std::cout << "n/a";
+    std::cout << std::endl;
+  }
+}
+
+void PrintJson(const std::vector<BenchmarkResult>& results)
+{
+  std::cout << "{\n  \"benchmarks\": [\n";
+  for (size_t i = 0; i < results.size(); ++i)
+  {
+    const auto& result = results[i];
+    std::cout << "    {\"name\": \"" << result.name << "\", \"error\": " << (result.ok ? "false" : "true")
+              << ", \"iterations\": " << result.iterations << ", \"real_time\": " << result.ns_per_iteration
+              << ", \"time_unit\": \"ns\", \"bytes_per_second\": " << result.bytes_per_second
+              << ", \"items_per_second\": " << result.messages_per_second << ", \"allocs_per_msg\": ";
+    if (kCountingAllocs)
+      std::cout << result.allocs_per_message;
+    else
+      std::cout << "null";
+    std::cout << "}" << (i + 1 < results.size() ? "," : "") << "\n";
+  }
+  std::cout << "  ]\n}" << std::endl;
+}
+}  // namespace
+
+int main(int argc, char* argv[])
+{
+  std::string filter;
+  double      min_time_s = 0.5;
+  bool        json = false;
+  for (int i = 1; i < argc; ++i)
+  {
+    std::string arg = argv[i];
+    if (arg == "--json")
+    {
+      json = true;
+    }
+    else if (arg == "--filter" && i + 1 < argc)
+    {
+      filter = argv[++i];
+    }
+    else if (arg == "--min-time" && i + 1 < argc)
+    {
+      min_time_s = std::strtod(argv[++i], nullptr);
+    }
+    else
+    {
+      std::cerr << "Usage: " << argv[0] << " [--filter SUBSTRING] [--min-time SECONDS] [--json]" << std::endl;
+      return 1;
+    }
+  }
+
+  std::vector<Benchmark> benchmarks;
+  AddParseBenchmarks(benchmarks);
+  AddPackBenchmarks(benchmarks);
+
+  std::vector<BenchmarkResult> results;
+  bool                         all_ok = true;
+  for (const auto& benchmark : benchmarks)
+  {
+    if (!filter.empty() && benchmark.name.find(filter) == std::string::npos)
+      continue;
+    results.push_back(RunBenchmark(benchmark, min_time_s));
+    all_ok = all_ok && results.back().ok;
+  }
+
+  if (json)
+    PrintJson(results);
+  else
+    PrintTable(results);
+  return all_ok ? 0 : 1;
+}
@@ -0,0 +1,252 @@
+// connect_storm, a simulation of a client reconnect storm against a rate-limited broker.
+//
+// Models a population of clients all reconnecting to a broker at once, as after a broker restart or
+// a network outage, with the broker able to complete a fixed number of connect handshakes per
+// second. Simulated time is used throughout, so the results are deterministic for a given seed.
+// Each population size is run two ways:
+//
+//   random: the broker completes connects in arrival order, turning clients away once its
+//           handshake backlog is full. Rejected clients back off as update_backoff() in
+//           connection.c does, by a random 1-5 s more each time, up to 30 s.
+//   hinted: the broker paces connects with ConnectAdmission, holding connects due within
+//           ConnectAdmission::kMaxHoldMs and turning the rest away with a retry-after hint, which
+//           the clients honor in place of the random backoff.
+//
+// For each run, the time until every client is connected, the number of TCP connections made and
+// the most connects started in any 100 ms window are reported.
+//
+// Usage: connect_storm [--rate CONNECTS_PER_SEC] [--seed N] [--json]
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <queue>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "etcpal/cpp/uuid.h"
+#include "broker_util.h"
+
+namespace
+{
+constexpr size_t   kClientCounts[] = {100, 1000, 5000};
+constexpr uint32_t kWindowMs = 100;
+
+// How often a held connect is retried by the broker's socket manager.
+constexpr uint32_t kHoldRetryMs = 10;
+
+// Mirrors update_backoff() in connection.c.
+uint32_t UpdateBackoff(uint32_t previous_backoff, uint32_t retry_after_hint, std::mt19937& rng)
+{
+  if (retry_after_hint != 0)
+    return std::min(retry_after_hint, 30000u);
+
+  uint32_t result = std::uniform_int_distribution<uint32_t>(1000, 5000)(rng) + previous_backoff;
+  return std::min(result, 30000u);
+}
+
+struct Client
+{
+  etcpal::Uuid cid;
+  uint32_t     backoff_ms{0};
+  bool         connected{false};
+};
+
+struct StormResult
+{
+  std::string name;
+  size_t      clients;
+  uint32_t    recovery_ms;
+  uint64_t    connects;
+  uint64_t    peak_connects_per_window;
+};
+
+// A connect event for a client at a point in simulated time. Held connects are re-delivered on
+// the same TCP connection and aren't counted as new connects.
+struct Event
+{
+  uint32_t time_ms;
+  size_t   client;
+  bool     held;
+
+  bool operator>(const Event& other) const { return time_ms > other.time_ms; }
+};
+
+using EventQueue = std::priority_queue<Event, std::vector<Event>, std::greater<Event>>;
+
+// Decides the fate of a connect arriving at now_ms. Returns true if the client is connected;
+// otherwise sets retry_after_ms to a hint (or 0), or hold to true to re-deliver the connect later.
+using BrokerModel = std::function<bool(const Client& client, uint32_t now_ms, uint32_t& retry_after_ms, bool& hold)>;
+
+StormResult RunStorm(const std::string& name, size_t num_clients, uint32_t seed, BrokerModel broker)
+{
+  std::mt19937 rng(seed);
+
+  std::vector<Client> clients(num_clients);
+  EventQueue          events;
+  for (size_t i = 0; i < num_clients; ++i)
+  {
+    EtcPalUuid cid{};
+    for (size_t byte = 0; byte < sizeof(size_t); ++byte)
+      cid.data[byte] = static_cast<uint8_t>(i >> (byte * 8));
+    clients[i].cid = cid;
+
+    // Each client notices the outage and starts its first backoff
+    clients[i].backoff_ms = UpdateBackoff(0, 0, rng);
+    events.push(Event{clients[i].backoff_ms, i, false});
+  }
+
+  StormResult                  result{name, num_clients, 0, 0, 0};
+  std::map<uint32_t, uint64_t> connects_per_window;
+  size_t                       num_connected = 0;
+  while (!events.empty() && num_connected < num_clients)
+  {
+    Event event = events.top();
+    events.pop();
+
+    Client& client = clients[event.client];
+    if (!event.held)
+    {
+      ++result.connects;
+      ++connects_per_window[event.time_ms / kWindowMs];
+    }
+
+    uint32_t retry_after_ms = 0;
+    bool     hold = false;
+    if (broker(client, event.time_ms, retry_after_ms, hold))
+    {
+      client.connected = true;
+      ++num_connected;
+      result.recovery_ms = event.time_ms;
+    }
+    else if (hold)
+    {
+      events.push(Event{event.time_ms + kHoldRetryMs, event.client, true});
+    }
+    else
+    {
+      client.backoff_ms = UpdateBackoff(client.backoff_ms, retry_after_ms, rng);
+      events.push(Event{event.time_ms + client.backoff_ms, event.client, false});
+    }
+  }
+
+  for (const auto& window : connects_per_window)
+    result.peak_connects_per_window = std::max(result.peak_connects_per_window, window.second);
+  return result;
+}
+
+// A broker that completes connects in arrival order, rejecting any that find the handshake backlog
+// full.
+BrokerModel RandomBackoffBroker(unsigned int connects_per_s, unsigned int backlog)
+{
+  uint32_t service_ms = 1000 / connects_per_s;
+  uint32_t next_free_ms = 0;
+  return [=](const Client&, uint32_t now_ms, uint32_t& retry_after_ms, bool&) mutable {
+    retry_after_ms = 0;
+    uint32_t start_ms = std::max(now_ms, next_free_ms);
+    if ((start_ms - now_ms) / service_ms >= backlog)
+      return false;
+    next_free_ms = start_ms + service_ms;
+    return true;
+  };
+}
+
+// A broker that paces connects with ConnectAdmission.
+BrokerModel HintedBroker(unsigned int connects_per_s, unsigned int burst)
+{
+  auto admission = std::make_shared<ConnectAdmission>();
+  admission->SetRate(connects_per_s, burst, 0);
+  return [admission](const Client& client, uint32_t now_ms, uint32_t& retry_after_ms, bool& hold) {
+    auto admit = admission->Admit(client.cid, now_ms);
+    hold = (admit.decision == ConnectAdmission::Decision::kHold);
+    retry_after_ms = admit.retry_after_ms;
+    return (admit.decision == ConnectAdmission::Decision::kAdmit);
+  };
+}
+
+void PrintTable(const std::vector<StormResult>& results)
+{
+  std::cout << std::left << std::setw(20) << "Benchmark" << std::right << std::setw(10) << "Clients" << std::setw(16)
+            << "Recovery (ms)" << std::setw(12) << "Connects" << std::setw(22) << "Peak connects/100ms"
+            << "\n";
+  for (const auto& result : results)
+  {
+    std::cout << std::left << std::setw(20) << result.name << std::right << std::setw(10) << result.clients
+              << std::setw(16) << result.recovery_ms << std::setw(12) << result.connects << std::setw(22)
+              << result.peak_connects_per_window << "\n";
+  }
+  std::cout << std::flush;
+}
+
+void PrintJson(const std::vector<StormResult>& results)
+{
+  std::cout << "{\n  \"benchmarks\": [\n";
+  for (size_t i = 0; i < results.size(); ++i)
+  {
+    const auto& result = results[i];
+    std::cout << "    {\"name\": \"" << result.name << "\", \"clients\": " << result.clients
+              << ", \"recovery_ms\": " << result.recovery_ms << ", \"connects\": " << result.connects
+              << ", \"peak_connects_per_100ms\": " << result.peak_connects_per_window << "}"
+              << (i + 1 < results.size() ? "," : "") << "\n";
+  }
+  std::cout << "  ]\n}" << std::endl;
+}
+}  // namespace
+
+int main(int argc, char* argv[])
+{
+  unsigned int rate = 200;
+  uint32_t     seed = 1;
+  bool         json = false;
+  for (int i = 1; i < argc; ++i)
+  {
+    std::string arg = argv[i];
+    if (arg == "--json")
+    {
+      json = true;
+    }
+    else if (arg == "--rate" && i + 1 < argc)
+    {
+      rate = static_cast<unsigned int>(std::strtoul(argv[++i], nullptr, 10));
+    }
+    else if (arg == "--seed" && i + 1 < argc)
+    {
+      seed = static_cast<uint32_t>(std::strtoul(argv[++i], nullptr, 10));
+    }
+    else
+    {
+      std::cerr << "Usage: " << argv[0] << " [--rate CONNECTS_PER_SEC] [--seed N] [--json]" << std::endl;
+      return 1;
+    }
+  }
+
+  if (rate == 0 || rate > 1000)
+  {
+    std::cerr << "--rate must be between 1 and 1000." << std::endl;
+    return 1;
+  }
+
+  // Both brokers can absorb a burst of a tenth of a second's connects; the random-backoff broker's
+  // backlog holds the same.
+  unsigned int burst = std::max(rate / 10, 1u);
+
+  std::vector<StormResult> results;
+  for (size_t num_clients : kClientCounts)
+  {
+    std::string suffix = "/" + std::to_string(num_clients);
+    results.push_back(RunStorm("random" + suffix, num_clients, seed, RandomBackoffBroker(rate, burst)));
+    results.push_back(RunStorm("hinted" + suffix, num_clients, seed, HintedBroker(rate, burst)));
+  }
+
+  if (json)
+    PrintJson(results);
+  else
+    PrintTable(results);
+  return 0;
+}
@@ -0,0 +1,122 @@
+// ept_throughput, a benchmark of the broker's EPT forwarding path for large payloads.
+//
+// For each payload size, an EPT Data message is repeatedly fed through an RCMsgBuf (as if read
+// from a client socket) and pushed to a destination EPTClient's send queue. No sockets are used,
+// so the result is an upper bound on what the broker can forward per core.
+//
+// Usage: ept_throughput [iterations_per_size]
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
+#include "etcpal/cpp/uuid.h"
+#include "rdmnet/core/ept_prot.h"
+#include "rdmnet/core/msg_buf.h"
+#include "broker_client.h"
+
+namespace
+{
+constexpr uint16_t kManufacturerId = 0x6574;
+constexpr uint16_t kProtocolId = 0x0001;
+constexpr size_t   kDefaultIterations = 100000;
+
+// Exposes the protected queue reset so the benchmark can drain the queue without a socket.
+class BenchmarkEptClient : public EPTClient
+{
+public:
+  using EPTClient::EPTClient;
+  void Drain() { ClearAllQueues(); }
+};
+
+struct Result
+{
+  size_t payload_size;
+  size_t messages;
+  double seconds;
+};
+
+// Feeds the wire bytes of one message into the buffer the way rc_msg_buf_recv() would, limited by
+// the free space left in the buffer. Returns true once a full message has been parsed.
+bool FeedMessage(RCMsgBuf& buf, const std::vector<uint8_t>& wire)
+{
+  size_t offset = 0;
+  bool   parsed = false;
+  while (offset < wire.size())
+  {
+    size_t to_copy = std::min(wire.size() - offset, static_cast<size_t>(RC_MSG_BUF_SIZE) - buf.cur_data_size);
+    std::memcpy(&buf.buf[buf.cur_data_size], &wire[offset], to_copy);
+    buf.cur_data_size += to_copy;
+    offset += to_copy;
+    parsed = (rc_msg_buf_parse_data(&buf) == kEtcPalErrOk);
+  }
+  return parsed;
+}
+
+Result RunBenchmark(size_t payload_size, size_t iterations)
+{
+  const etcpal::Uuid sender_cid = etcpal::Uuid::OsPreferred();
+  const etcpal::Uuid dest_cid = etcpal::Uuid::OsPreferred();
+
+  std::vector<uint8_t> payload(payload_size);
+  for (size_t i = 0; i < payload_size; ++i)
+    payload[i] = static_cast<uint8_t>(i);
+
+  std::vector<uint8_t> wire(rc_ept_get_data_buffer_size(payload_size));
+  rc_ept_pack_data(wire.data(), wire.size(), &sender_cid.get(), &dest_cid.get(), kManufacturerId, kProtocolId,
+                   payload.data(), payload.size());
+
+  RdmnetEptSubProtocol protocol{kManufacturerId, kProtocolId, "Benchmark"};
+  RdmnetEptClientEntry entry{dest_cid.get(), &protocol, 1};
+  BrokerClient         pending_client(0, ETCPAL_SOCKET_INVALID);
+  BenchmarkEptClient   dest_client(BrokerClient::kLimitlessQueueSize, entry, pending_client);
+
+  static RCMsgBuf buf;
+  rc_msg_buf_init(&buf);
+
+  size_t forwarded = 0;
+  auto   start = std::chrono::steady_clock::now();
+  for (size_t i = 0; i < iterations; ++i)
+  {
+    if (FeedMessage(buf, wire))
+    {
+      const EptMessage* ept_msg = RDMNET_GET_EPT_MSG(&buf.msg);
+      if (dest_client.Push(etcpal::Uuid(buf.msg.sender_cid), *ept_msg) == ClientPushResult::Ok)
+        ++forwarded;
+      rc_free_message_resources(&buf.msg);
+    }
+    // Keep memory use flat; the queue would be drained by socket sends in the real broker.
+    if ((i % 64) == 63)
+      dest_client.Drain();
+  }
+  auto end = std::chrono::steady_clock::now();
+
+  return Result{payload_size, forwarded, std::chrono::duration<double>(end - start).count()};
+}
+}  // namespace
+
+int main(int argc, char* argv[])
+{
+  size_t iterations = kDefaultIterations;
+  if (argc > 1)
+    iterations = static_cast<size_t>(std::strtoul(argv[1], nullptr, 10));
+
+  std::vector<size_t> payload_sizes{64, 512, 1024, 4096};
+  if (RDMNET_EPT_DATA_MAX_SIZE > 4096)
+    payload_sizes.push_back(RDMNET_EPT_DATA_MAX_SIZE);
+
+  std::cout << "Payload (bytes)\tMessages\tMsgs/s\t\tMB/s" << std::endl;
+  for (auto size : payload_sizes)
+  {
+    Result res = RunBenchmark(size, iterations);
+    double msgs_per_sec = res.seconds > 0 ? res.messages / res.seconds : 0.0;
+    std::cout << res.payload_size << "\t\t" << res.messages << "\t\t" << std::fixed << std::setprecision(0)
+              << msgs_per_sec << "\t" << std::setprecision(1) << (msgs_per_sec * res.payload_size) / (1024 * 1024)
+              << std::endl;
+  }
+  return 0;
+}
@@ -0,0 +1,149 @@
+// rdm_response_rate, a benchmark of how many RDM responses a single device can send per second.
+//
+// An in-process broker is started on the loopback interface and a single device connects to it
+// with a static broker address. The device then sends unsolicited GET_COMMAND_RESPONSEs (RDM
+// updates) in a tight loop for a range of parameter data sizes. Each update goes through the same
+// response packing path as an ACK or ACK_OVERFLOW to a controller's GET command.
+//
+// Usage: rdm_response_rate [responses_per_size] [broker_port]
+
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+#include "etcpal/cpp/inet.h"
+#include "etcpal/cpp/uuid.h"
+#include "rdm/defs.h"
+#include "rdmnet/cpp/broker.h"
+#include "rdmnet/cpp/common.h"
+#include "rdmnet/cpp/device.h"
+
+namespace
+{
+constexpr uint16_t kManufacturerId = 0x6574;
+constexpr size_t   kDefaultResponses = 100000;
+constexpr uint16_t kDefaultBrokerPort = 8889;
+constexpr char     kScope[] = "rdm_response_rate";
+
+class DeviceNotifyHandler : public rdmnet::Device::NotifyHandler
+{
+public:
+  std::atomic<bool> connected{false};
+
+  void HandleConnectedToBroker(rdmnet::Device::Handle, const rdmnet::ClientConnectedInfo&) override
+  {
+    connected = true;
+  }
+  void HandleBrokerConnectFailed(rdmnet::Device::Handle, const rdmnet::ClientConnectFailedInfo&) override {}
+  void HandleDisconnectedFromBroker(rdmnet::Device::Handle, const rdmnet::ClientDisconnectedInfo&) override
+  {
+    connected = false;
+  }
+  rdmnet::RdmResponseAction HandleRdmCommand(rdmnet::Device::Handle, const rdmnet::RdmCommand&) override
+  {
+    return rdmnet::RdmResponseAction::SendNack(kRdmNRUnknownPid);
+  }
+  rdmnet::RdmResponseAction HandleLlrpRdmCommand(rdmnet::Device::Handle, const rdmnet::llrp::RdmCommand&) override
+  {
+    return rdmnet::RdmResponseAction::SendNack(kRdmNRUnknownPid);
+  }
+};
+
+struct Result
+{
+  size_t pd_len;
+  size_t responses;
+  size_t errors;
+  double seconds;
+};
+
+Result RunBenchmark(rdmnet::Device& device, size_t pd_len, size_t num_responses)
+{
+  std::vector<uint8_t> pd(pd_len);
+  for (size_t i = 0; i < pd_len; ++i)
+    pd[i] = static_cast<uint8_t>(i);
+
+  size_t sent = 0;
+  size_t errors = 0;
+  auto   start = std::chrono::steady_clock::now();
+  for (size_t i = 0; i < num_responses; ++i)
+  {
+    if (device.SendRdmUpdate(E120_DEVICE_LABEL, pd.data(), pd.size()))
+      ++sent;
+    else
+      ++errors;
+  }
+  auto end = std::chrono::steady_clock::now();
+
+  return Result{pd_len, sent, errors, std::chrono::duration<double>(end - start).count()};
+}
+}  // namespace
+
+int main(int argc, char* argv[])
+{
+  size_t   num_responses = kDefaultResponses;
+  uint16_t broker_port = kDefaultBrokerPort;
+  if (argc > 1)
+    num_responses = static_cast<size_t>(std::strtoul(argv[1], nullptr, 10));
+  if (argc > 2)
+    broker_port = static_cast<uint16_t>(std::strtoul(argv[2], nullptr, 10));
+
+  auto res = rdmnet::Init();
+  if (!res)
+  {
+    std::cerr << "Error initializing RDMnet library: " << res.ToString() << std::endl;
+    return 1;
+  }
+
+  rdmnet::Broker::Settings broker_settings(etcpal::Uuid::OsPreferred(), kManufacturerId);
+  broker_settings.scope = kScope;
+  broker_settings.listen_port = broker_port;
+
+  rdmnet::Broker broker;
+  res = broker.Startup(broker_settings);
+  if (!res)
+  {
+    std::cerr << "Error starting broker: " << res.ToString() << std::endl;
+    rdmnet::Deinit();
+    return 1;
+  }
+
+  DeviceNotifyHandler     notify;
+  rdmnet::Device          device;
+  rdmnet::Device::Settings device_settings(etcpal::Uuid::OsPreferred(), kManufacturerId);
+  res = device.Startup(notify, device_settings, kScope,
+                       etcpal::SockAddr(etcpal::IpAddr::FromString("127.0.0.1"), broker_port));
+  if (res)
+  {
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+    while (!notify.connected && std::chrono::steady_clock::now() < deadline)
+      std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+
+  if (!res || !notify.connected)
+  {
+    std::cerr << "Device failed to connect to the broker." << std::endl;
+    device.Shutdown();
+    broker.Shutdown();
+    rdmnet::Deinit();
+    return 1;
+  }
+
+  std::cout << "PDL (bytes)\tResponses\tErrors\t\tResponses/s" << std::endl;
+  for (size_t pd_len : {0u, 32u, 230u, 460u})
+  {
+    Result result = RunBenchmark(device, pd_len, num_responses);
+    double per_sec = result.seconds > 0 ? result.responses / result.seconds : 0.0;
+    std::cout << result.pd_len << "\t\t" << result.responses << "\t\t" << result.errors << "\t\t" << std::fixed
+              << std::setprecision(0) << per_sec << std::endl;
+  }
+
+  device.Shutdown();
+  broker.Shutdown();
+  rdmnet::Deinit();
+  return 0;
+}
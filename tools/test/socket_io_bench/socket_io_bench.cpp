@@ -0,0 +1,604 @@
+// socket_io_bench, a comparison of the epoll and io_uring socket I/O in the broker and the core on
+// Linux.
+//
+// Connects 10, 100 and 400 TCP clients to a socket manager over loopback and times two directions
+// of traffic, in batches of 64 broker NULL messages per client:
+//
+//   recv: the clients send, and the socket manager receives and parses the messages, counting them
+//         in its notify handler.
+//   send: the socket manager sends to every client, through SendOnSocket() and a FlushSends() after
+//         each pass over the clients, as the broker's client service threads do. A reader thread
+//         drains the clients.
+//
+// Each is run with LinuxBrokerSocketManager (epoll, with sends through rc_send()) and, if RDMnet was
+// built with RDMNET_ENABLE_IO_URING and the running kernel supports it,
+// LinuxUringBrokerSocketManager. Otherwise the io_uring runs are reported as unavailable.
+//
+//   poll: the clients send, and the core's polling layer waits for each readable socket and drains
+//         it with recv(), one event per wait, as rc_tick() does with its connection sockets.
+//
+// This is run with etcpal_poll and, under the same conditions as above, rc_uring_poll.
+//
+// Usage: socket_io_bench [--min-time SECONDS] [--json]
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <string>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+#include "etcpal/common.h"
+#include "etcpal/cpp/uuid.h"
+#include "etcpal/socket.h"
+#include "rdmnet/core/broker_prot.h"
+#include "broker_socket_manager.h"
+#include "linux/linux_socket_manager.h"
+#if RDMNET_HAVE_IO_URING
+#include "rdmnet/core/uring_poll.h"
+#include "linux/linux_uring_socket_manager.h"
+#endif
+
+namespace
+{
+constexpr size_t kConnectionCounts[] = {10, 100, 400};
+
+// Messages per client per timed batch.
+constexpr size_t kBatchSize = 64;
+
+using Clock = std::chrono::steady_clock;
+using ManagerFactory = std::function<std::unique_ptr<BrokerSocketManager>()>;
+
+// The core's socket polling, through one of its two backends.
+class PollBackend
+{
+public:
+  virtual ~PollBackend() = default;
+
+  virtual bool           AddSocket(int sock) = 0;
+  virtual etcpal_error_t Wait(EtcPalPollEvent& event, int timeout_ms) = 0;
+};
+
+using PollBackendFactory = std::function<std::unique_ptr<PollBackend>()>;
+
+struct BenchmarkResult
+{
+  std::string name;
+  bool        available;
+  bool        ok;
+  size_t      connections;
+  uint64_t    messages;
+  double      ns_per_message;
+  double      messages_per_s;
+};
+
+// Counts the messages received by the socket manager.
+class CountingNotify : public BrokerSocketNotify
+{
+public:
+  HandleMessageResult HandleSocketMessageReceived(BrokerClient::Handle /*handle*/,
+                                                  const RdmnetMessage& /*message*/) override
+  {
+    messages_.fetch_add(1, std::memory_order_relaxed);
+    return HandleMessageResult::kGetNextMessage;
+  }
+  void HandleSocketClosed(BrokerClient::Handle /*handle*/, bool /*graceful*/) override {}
+  bool HandleNewConnection(etcpal_socket_t /*new_sock*/, const etcpal::SockAddr& /*remote_addr*/) override
+  {
+    return false;
+  }
+
+  uint64_t messages() const { return messages_.load(std::memory_order_relaxed); }
+
+private:
+  std::atomic<uint64_t> messages_{0};
+};
+
+// Loopback TCP connections, with the server ends to hand to a socket manager.
+struct Connections
+{
+  std::vector<int> clients;
+  std::vector<int> servers;
+
+  ~Connections()
+  {
+    for (int sock : clients)
+      close(sock);
+    // The server ends belong to the socket manager once added.
+  }
+};
+
+bool Connect(size_t num_connections, Connections& connections)
+{
+  int listen_sock = socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+  if (listen_sock < 0)
+    return false;
+
+  struct sockaddr_in addr;
+  memset(&addr, 0, sizeof addr);
+  addr.sin_family = AF_INET;
+  addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  socklen_t addr_len = sizeof addr;
+  if (bind(listen_sock, reinterpret_cast<struct sockaddr*>(&addr), sizeof addr) != 0 ||
+      listen(listen_sock, SOMAXCONN) != 0 ||
+      getsockname(listen_sock, reinterpret_cast<struct sockaddr*>(&addr), &addr_len) != 0)
+  {
+    close(listen_sock);
+    return false;
+  }
+
+  bool ok = true;
+  for (size_t i = 0; i < num_connections && ok; ++i)
+  {
+    int client = socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    ok = (client >= 0);
+    if (ok)
+    {
+      connections.clients.push_back(client);
+      ok = (connect(client, reinterpret_cast<struct sockaddr*>(&addr), sizeof addr) == 0);
+    }
+    if (ok)
+    {
+      int one = 1;
+      setsockopt(client, IPPROTO_TCP, TCP_NODELAY, &one, sizeof one);
+
+      // Non-blocking, as the broker's client sockets are
+      int server = accept4(listen_sock, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+      ok = (server >= 0);
+      if (ok)
+      {
+        setsockopt(server, IPPROTO_TCP, TCP_NODELAY, &one, sizeof one);
+        connections.servers.push_back(server);
+      }
+    }
+  }
+
+  close(listen_sock);
+  return ok;
+}
+
+class EtcPalPollBackend : public PollBackend
+{
+public:
+  EtcPalPollBackend() : ok_(etcpal_poll_context_init(&context_) == kEtcPalErrOk) {}
+  ~EtcPalPollBackend() override
+  {
+    if (ok_)
+      etcpal_poll_context_deinit(&context_);
+  }
+
+  bool ok() const { return ok_; }
+
+  bool AddSocket(int sock) override
+  {
+    return etcpal_poll_add_socket(&context_, sock, ETCPAL_POLL_IN, nullptr) == kEtcPalErrOk;
+  }
+  etcpal_error_t Wait(EtcPalPollEvent& event, int timeout_ms) override
+  {
+    return etcpal_poll_wait(&context_, &event, timeout_ms);
+  }
+
+private:
+  EtcPalPollContext context_;
+  bool              ok_;
+};
+
+#if RDMNET_HAVE_IO_URING
+class UringPollBackend : public PollBackend
+{
+public:
+  UringPollBackend() : ok_(rc_uring_poll_context_init(&context_) == kEtcPalErrOk) {}
+  ~UringPollBackend() override
+  {
+    if (ok_)
+      rc_uring_poll_context_deinit(&context_);
+  }
+
+  bool ok() const { return ok_; }
+
+  bool AddSocket(int sock) override
+  {
+    return rc_uring_poll_add_socket(&context_, sock, ETCPAL_POLL_IN, nullptr) == kEtcPalErrOk;
+  }
+  etcpal_error_t Wait(EtcPalPollEvent& event, int timeout_ms) override
+  {
+    return rc_uring_poll_wait(&context_, &event, timeout_ms);
+  }
+
+private:
+  RCUringPollContext context_;
+  bool               ok_;
+};
+#endif
+
+std::unique_ptr<PollBackend> MakeEtcPalPoll()
+{
+  std::unique_ptr<EtcPalPollBackend> backend(new EtcPalPollBackend);
+  if (!backend->ok())
+    return nullptr;
+  return std::move(backend);
+}
+
+std::unique_ptr<PollBackend> MakeUringPoll()
+{
+#if RDMNET_HAVE_IO_URING
+  // rc_uring_poll_context_init() fails if the kernel doesn't support io_uring.
+  std::unique_ptr<UringPollBackend> backend(new UringPollBackend);
+  if (backend->ok())
+    return std::move(backend);
+#endif
+  return nullptr;
+}
+
+std::unique_ptr<BrokerSocketManager> MakeEpollManager()
+{
+  return std::unique_ptr<BrokerSocketManager>(new LinuxBrokerSocketManager);
+}
+
+std::unique_ptr<BrokerSocketManager> MakeUringManager()
+{
+#if RDMNET_HAVE_IO_URING
+  if (LinuxUringBrokerSocketManager::KernelSupported())
+    return std::unique_ptr<BrokerSocketManager>(new LinuxUringBrokerSocketManager);
+#endif
+  return nullptr;
+}
+
+// A batch of kBatchSize broker NULL messages, back to back.
+std::vector<uint8_t> MakeBatch()
+{
+  etcpal::Uuid         cid = etcpal::Uuid::OsPreferred();
+  std::vector<uint8_t> batch(BROKER_NULL_FULL_MSG_SIZE * kBatchSize);
+  for (size_t i = 0; i < kBatchSize; ++i)
+    rc_broker_pack_null(&batch[i * BROKER_NULL_FULL_MSG_SIZE], BROKER_NULL_FULL_MSG_SIZE, &cid.get());
+  return batch;
+}
+
+bool SendAll(int sock, const uint8_t* data, size_t size)
+{
+  while (size > 0)
+  {
+    ssize_t res = send(sock, data, size, MSG_NOSIGNAL);
+    if (res < 0 && errno != EINTR)
+      return false;
+    if (res > 0)
+    {
+      data += res;
+      size -= static_cast<size_t>(res);
+    }
+  }
+  return true;
+}
+
+// Waits up to 10 seconds for a condition, which indicates a broken benchmark if it times out.
+bool WaitFor(const std::function<bool()>& condition)
+{
+  auto deadline = Clock::now() + std::chrono::seconds(10);
+  while (!condition())
+  {
+    if (Clock::now() > deadline)
+      return false;
+    std::this_thread::yield();
+  }
+  return true;
+}
+
+// The clients send batches of messages, which the socket manager receives.
+bool RunRecvBatch(Connections& connections, const CountingNotify& notify, const std::vector<uint8_t>& batch)
+{
+  uint64_t target = notify.messages() + (kBatchSize * connections.clients.size());
+  for (int client : connections.clients)
+  {
+    if (!SendAll(client, batch.data(), batch.size()))
+      return false;
+  }
+  return WaitFor([&]() { return notify.messages() >= target; });
+}
+
+// The socket manager sends batches of messages to every client, which the reader thread counts.
+bool RunSendBatch(BrokerSocketManager&         sock_mgr,
+                  Connections&                 connections,
+                  const std::atomic<uint64_t>& bytes_read,
+                  const std::vector<uint8_t>&  batch)
+{
+  uint64_t target = bytes_read.load() + (batch.size() * connections.servers.size());
+  for (size_t i = 0; i < kBatchSize; ++i)
+  {
+    const uint8_t* msg = &batch[i * BROKER_NULL_FULL_MSG_SIZE];
+    for (size_t handle = 0; handle < connections.servers.size(); ++handle)
+    {
+      int res = sock_mgr.SendOnSocket(static_cast<BrokerClient::Handle>(handle), connections.servers[handle], msg,
+                                      BROKER_NULL_FULL_MSG_SIZE);
+      while (res == kEtcPalErrWouldBlock)
+      {
+        sock_mgr.FlushSends();
+        res = sock_mgr.SendOnSocket(static_cast<BrokerClient::Handle>(handle), connections.servers[handle], msg,
+                                    BROKER_NULL_FULL_MSG_SIZE);
+      }
+      if (res != static_cast<int>(BROKER_NULL_FULL_MSG_SIZE))
+        return false;
+    }
+    sock_mgr.FlushSends();
+  }
+  return WaitFor([&]() {
+    sock_mgr.FlushSends();
+    return bytes_read.load() >= target;
+  });
+}
+
+// The clients send batches of messages, which are read from the server ends as the poll backend
+// reports them readable.
+bool RunPollBatch(PollBackend& poll, Connections& connections, const std::vector<uint8_t>& batch)
+{
+  for (int client : connections.clients)
+  {
+    if (!SendAll(client, batch.data(), batch.size()))
+      return false;
+  }
+
+  static uint8_t buf[65536];
+  uint64_t       target = batch.size() * connections.clients.size();
+  uint64_t       bytes_read = 0;
+  auto           deadline = Clock::now() + std::chrono::seconds(10);
+  while (bytes_read < target)
+  {
+    if (Clock::now() > deadline)
+      return false;
+
+    EtcPalPollEvent event;
+    etcpal_error_t  res = poll.Wait(event, 100);
+    if (res == kEtcPalErrTimedOut)
+      continue;
+    if (res != kEtcPalErrOk || (event.events & ETCPAL_POLL_ERR))
+      return false;
+
+    ssize_t recv_res = recv(event.socket, buf, sizeof buf, MSG_DONTWAIT);
+    if (recv_res > 0)
+      bytes_read += static_cast<uint64_t>(recv_res);
+  }
+  return true;
+}
+
+// Reads and discards everything sent to the clients until stopped.
+void ReadClients(const Connections& connections, std::atomic<uint64_t>& bytes_read, const std::atomic<bool>& stop)
+{
+  int epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+  for (int client : connections.clients)
+  {
+    struct epoll_event event;
+    event.events = EPOLLIN;
+    event.data.fd = client;
+    epoll_ctl(epoll_fd, EPOLL_CTL_ADD, client, &event);
+  }
+
+  std::unique_ptr<struct epoll_event[]> events(new struct epoll_event[64]);
+  std::unique_ptr<uint8_t[]>            buf(new uint8_t[65536]);
+  while (!stop)
+  {
+    int num_events = epoll_wait(epoll_fd, events.get(), 64, 10);
+    for (int i = 0; i < num_events; ++i)
+    {
+      ssize_t res = recv(events[i].data.fd, buf.get(), 65536, MSG_DONTWAIT);
+      if (res > 0)
+        bytes_read += static_cast<uint64_t>(res);
+    }
+  }
+  close(epoll_fd);
+}
+
+// Runs batches until at least min_time_s of traffic has been timed.
+BenchmarkResult RunBenchmark(const std::string&    name,
+                             bool                  send,
+                             size_t                num_connections,
+                             const ManagerFactory& make_manager,
+                             double                min_time_s)
+{
+  BenchmarkResult result{name, false, false, num_connections, 0, 0.0, 0.0};
+
+  auto sock_mgr = make_manager();
+  if (!sock_mgr)
+    return result;
+  result.available = true;
+
+  CountingNotify notify;
+  Connections    connections;
+  sock_mgr->SetNotify(&notify);
+  if (!sock_mgr->Startup())
+    return result;
+  if (!Connect(num_connections, connections))
+  {
+    for (int server : connections.servers)
+      close(server);
+    sock_mgr->Shutdown();
+    return result;
+  }
+  for (size_t handle = 0; handle < connections.servers.size(); ++handle)
+    sock_mgr->AddSocket(static_cast<BrokerClient::Handle>(handle), connections.servers[handle]);
+
+  std::atomic<uint64_t> bytes_read{0};
+  std::atomic<bool>     stop_reading{false};
+  std::thread           reader;
+  if (send)
+    reader = std::thread(ReadClients, std::cref(connections), std::ref(bytes_read), std::cref(stop_reading));
+
+  auto batch = MakeBatch();
+  auto run_batch = [&]() {
+    return (send ? RunSendBatch(*sock_mgr, connections, bytes_read, batch)
+                 : RunRecvBatch(connections, notify, batch));
+  };
+
+  // One untimed batch to validate the benchmark and warm up the connections.
+  bool            ok = run_batch();
+  Clock::duration elapsed{};
+  while (ok && std::chrono::duration<double>(elapsed).count() < min_time_s)
+  {
+    auto start = Clock::now();
+    ok = run_batch();
+    elapsed += Clock::now() - start;
+    result.messages += kBatchSize * num_connections;
+  }
+
+  stop_reading = true;
+  if (reader.joinable())
+    reader.join();
+  sock_mgr->Shutdown();
+
+  if (ok && result.messages > 0)
+  {
+    double elapsed_ns = std::chrono::duration<double, std::nano>(elapsed).count();
+    result.ok = true;
+    result.ns_per_message = elapsed_ns / static_cast<double>(result.messages);
+    result.messages_per_s = 1e9 / result.ns_per_message;
+  }
+  return result;
+}
+
+// Runs batches through a poll backend until at least min_time_s of traffic has been timed.
+BenchmarkResult RunPollBenchmark(const std::string&        name,
+                                 size_t                    num_connections,
+                                 const PollBackendFactory& make_backend,
+                                 double                    min_time_s)
+{
+  BenchmarkResult result{name, false, false, num_connections, 0, 0.0, 0.0};
+
+  auto poll = make_backend();
+  if (!poll)
+    return result;
+  result.available = true;
+
+  Connections connections;
+  bool        ok = Connect(num_connections, connections);
+  for (size_t i = 0; ok && i < connections.servers.size(); ++i)
+    ok = poll->AddSocket(connections.servers[i]);
+
+  auto batch = MakeBatch();
+
+  // One untimed batch to validate the benchmark and warm up the connections.
+  if (ok)
+    ok = RunPollBatch(*poll, connections, batch);
+  Clock::duration elapsed{};
+  while (ok && std::chrono::duration<double>(elapsed).count() < min_time_s)
+  {
+    auto start = Clock::now();
+    ok = RunPollBatch(*poll, connections, batch);
+    elapsed += Clock::now() - start;
+    result.messages += kBatchSize * num_connections;
+  }
+
+  // Not handed to a socket manager, so the server ends are closed here.
+  poll.reset();
+  for (int server : connections.servers)
+    close(server);
+
+  if (ok && result.messages > 0)
+  {
+    double elapsed_ns = std::chrono::duration<double, std::nano>(elapsed).count();
+    result.ok = true;
+    result.ns_per_message = elapsed_ns / static_cast<double>(result.messages);
+    result.messages_per_s = 1e9 / result.ns_per_message;
+  }
+  return result;
+}
+
+void PrintTable(const std::vector<BenchmarkResult>& results)
+{
+  std::cout << std::left << std::setw(24) << "Benchmark" << std::right << std::setw(13) << "Connections"
+            << std::setw(14) << "Messages" << std::setw(14) << "ns/message" << std::setw(16) << "messages/s"
+            << "\n";
+  for (const auto& result : results)
+  {
+    std::cout << std::left << std::setw(24) << result.name << std::right << std::setw(13) << result.connections;
+    if (!result.available)
+    {
+      std::cout << std::setw(14) << "UNAVAILABLE\n";
+      continue;
+    }
+    if (!result.ok)
+    {
+      std::cout << std::setw(14) << "ERROR\n";
+      continue;
+    }
+    std::cout << std::setw(14) << result.messages << std::fixed << std::setprecision(1) << std::setw(14)
+              << result.ns_per_message << std::setprecision(0) << std::setw(16) << result.messages_per_s << "\n";
+  }
+  std::cout << std::flush;
+}
+
+void PrintJson(const std::vector<BenchmarkResult>& results)
+{
+  std::cout << "{\n  \"benchmarks\": [\n";
+  for (size_t i = 0; i < results.size(); ++i)
+  {
+    const auto& result = results[i];
+    std::cout << "    {\"name\": \"" << result.name << "\", \"available\": " << (result.available ? "true" : "false")
+              << ", \"error\": " << (result.ok || !result.available ? "false" : "true")
+              << ", \"connections\": " << result.connections << ", \"iterations\": " << result.messages
+              << ", \"real_time\": " << result.ns_per_message
+              << ", \"time_unit\": \"ns\", \"messages_per_s\": " << result.messages_per_s << "}"
+              << (i + 1 < results.size() ? "," : "") << "\n";
+  }
+  std::cout << "  ]\n}" << std::endl;
+}
+}  // namespace
+
+int main(int argc, char* argv[])
+{
+  double min_time_s = 0.5;
+  bool   json = false;
+  for (int i = 1; i < argc; ++i)
+  {
+    std::string arg = argv[i];
+    if (arg == "--json")
+    {
+      json = true;
+    }
+    else if (arg == "--min-time" && i + 1 < argc)
+    {
+      min_time_s = std::strtod(argv[++i], nullptr);
+    }
+    else
+    {
+      std::cerr << "Usage: " << argv[0] << " [--min-time SECONDS] [--json]" << std::endl;
+      return 1;
+    }
+  }
+
+  if (etcpal_init(ETCPAL_FEATURE_SOCKETS) != kEtcPalErrOk)
+  {
+    std::cerr << "Couldn't initialize EtcPal sockets" << std::endl;
+    return 1;
+  }
+
+  std::vector<BenchmarkResult> results;
+  for (size_t num_connections : kConnectionCounts)
+  {
+    std::string suffix = "/" + std::to_string(num_connections);
+    results.push_back(RunBenchmark("recv/epoll" + suffix, false, num_connections, MakeEpollManager, min_time_s));
+    results.push_back(RunBenchmark("recv/io_uring" + suffix, false, num_connections, MakeUringManager, min_time_s));
+    results.push_back(RunBenchmark("send/epoll" + suffix, true, num_connections, MakeEpollManager, min_time_s));
+    results.push_back(RunBenchmark("send/io_uring" + suffix, true, num_connections, MakeUringManager, min_time_s));
+    results.push_back(RunPollBenchmark("poll/etcpal" + suffix, num_connections, MakeEtcPalPoll, min_time_s));
+    results.push_back(RunPollBenchmark("poll/io_uring" + suffix, num_connections, MakeUringPoll, min_time_s));
+  }
+
+  if (json)
+    PrintJson(results);
+  else
+    PrintTable(results);
+
+  etcpal_deinit(ETCPAL_FEATURE_SOCKETS);
+  return 0;
+}